@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include "2d/CCNode.h"
 #include "base/CCScheduler.h"
 #include "base/ccMacros.h"
+#include "base/CCProfiling.h"
 #include "2d/ccCArray.h"
 #include "2d/uthash.h"
 
@@ -339,6 +340,8 @@ ssize_t ActionManager::getNumberOfRunningActionsInTarget(const Node *target) con
 // main loop
 void ActionManager::update(float dt)
 {
+    CC_PROFILER_SCOPE("ActionManager - update");
+
     for (tHashElement *elt = _targets; elt != nullptr; )
     {
         _currentTarget = elt;
@@ -228,8 +228,7 @@ void ClippingNode::visit(Renderer *renderer, const Mat4 &parentTransform, bool p
 
     renderer->pushGroup(_groupCommand.getRenderQueueID());
 
-    _beforeVisitCmd.init(_globalZOrder);
-    _beforeVisitCmd.func = CC_CALLBACK_0(ClippingNode::onBeforeVisit, this);
+    _beforeVisitCmd.init(_globalZOrder, renderer->getFrameArena(), CC_CALLBACK_0(ClippingNode::onBeforeVisit, this));
     renderer->addCommand(&_beforeVisitCmd);
     if (_alphaThreshold < 1)
     {
@@ -251,8 +250,7 @@ void ClippingNode::visit(Renderer *renderer, const Mat4 &parentTransform, bool p
     }
     _stencil->visit(renderer, _modelViewTransform, dirty);
 
-    _afterDrawStencilCmd.init(_globalZOrder);
-    _afterDrawStencilCmd.func = CC_CALLBACK_0(ClippingNode::onAfterDrawStencil, this);
+    _afterDrawStencilCmd.init(_globalZOrder, renderer->getFrameArena(), CC_CALLBACK_0(ClippingNode::onAfterDrawStencil, this));
     renderer->addCommand(&_afterDrawStencilCmd);
 
     int i = 0;
@@ -281,8 +279,7 @@ void ClippingNode::visit(Renderer *renderer, const Mat4 &parentTransform, bool p
         this->draw(renderer, _modelViewTransform, dirty);
     }
 
-    _afterVisitCmd.init(_globalZOrder);
-    _afterVisitCmd.func = CC_CALLBACK_0(ClippingNode::onAfterVisit, this);
+    _afterVisitCmd.init(_globalZOrder, renderer->getFrameArena(), CC_CALLBACK_0(ClippingNode::onAfterVisit, this));
     renderer->addCommand(&_afterVisitCmd);
 
     renderer->popGroup();
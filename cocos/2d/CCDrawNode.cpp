@@ -99,26 +99,42 @@ static inline Tex2F __t(const Vec2 &v)
 	return *(Tex2F*)&v;
 }
 
+// a chunk's indices are 16 bits
+static const int MAX_CHUNK_VERTICES = 65536;
+
 // implementation of DrawNode
 
 DrawNode::DrawNode()
 : _vao(0)
 , _vbo(0)
+, _ibo(0)
 , _bufferCapacity(0)
 , _bufferCount(0)
 , _buffer(nullptr)
+, _indexCapacity(0)
+, _indexCount(0)
+, _indices(nullptr)
+, _vboCapacity(0)
+, _iboCapacity(0)
+, _uploadedVertexCount(0)
+, _uploadedIndexCount(0)
 , _dirty(false)
 {
     _blendFunc = BlendFunc::ALPHA_PREMULTIPLIED;
+    _chunks.push_back({0, 0});
 }
 
 DrawNode::~DrawNode()
 {
     free(_buffer);
     _buffer = nullptr;
+    free(_indices);
+    _indices = nullptr;
     
     glDeleteBuffers(1, &_vbo);
     _vbo = 0;
+    glDeleteBuffers(1, &_ibo);
+    _ibo = 0;
     
     if (Configuration::getInstance()->supportsShareableVAO())
     {
@@ -143,15 +159,27 @@ DrawNode* DrawNode::create()
     return ret;
 }
 
-void DrawNode::ensureCapacity(int count)
+void DrawNode::ensureCapacity(int vertexCount, int indexCount)
 {
-    CCASSERT(count>=0, "capacity must be >= 0");
+    CCASSERT(vertexCount>=0 && indexCount>=0, "capacity must be >= 0");
+    CCASSERT(vertexCount <= MAX_CHUNK_VERTICES, "too many vertices for a single primitive");
     
-    if(_bufferCount + count > _bufferCapacity)
+    if(_bufferCount + vertexCount > _bufferCapacity)
     {
-		_bufferCapacity += MAX(_bufferCapacity, count);
+		_bufferCapacity += MAX(_bufferCapacity, vertexCount);
 		_buffer = (V2F_C4B_T2F*)realloc(_buffer, _bufferCapacity*sizeof(V2F_C4B_T2F));
 	}
+    
+    if(_indexCount + indexCount > _indexCapacity)
+    {
+        _indexCapacity += MAX(_indexCapacity, indexCount);
+        _indices = (GLushort*)realloc(_indices, _indexCapacity*sizeof(GLushort));
+    }
+    
+    if(_bufferCount - _chunks.back().vertexStart + vertexCount > MAX_CHUNK_VERTICES)
+    {
+        _chunks.push_back({_bufferCount, _indexCount});
+    }
 }
 
 bool DrawNode::init()
@@ -160,7 +188,7 @@ bool DrawNode::init()
 
     setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR));
     
-    ensureCapacity(512);
+    ensureCapacity(512, 768);
     
     if (Configuration::getInstance()->supportsShareableVAO())
     {
@@ -170,26 +198,29 @@ bool DrawNode::init()
     
     glGenBuffers(1, &_vbo);
     glBindBuffer(GL_ARRAY_BUFFER, _vbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)* _bufferCapacity, _buffer, GL_STREAM_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)* _bufferCapacity, _buffer, GL_DYNAMIC_DRAW);
     
-    glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_POSITION);
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, sizeof(V2F_C4B_T2F), (GLvoid *)offsetof(V2F_C4B_T2F, vertices));
+    glGenBuffers(1, &_ibo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _ibo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLushort)* _indexCapacity, _indices, GL_DYNAMIC_DRAW);
     
+    glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_POSITION);
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_COLOR);
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V2F_C4B_T2F), (GLvoid *)offsetof(V2F_C4B_T2F, colors));
-    
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_TEX_COORD);
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V2F_C4B_T2F), (GLvoid *)offsetof(V2F_C4B_T2F, texCoords));
-    
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    setVertexAttribPointers(0);
     
     if (Configuration::getInstance()->supportsShareableVAO())
     {
+        // Must unbind the VAO before changing the element buffer.
         GL::bindVAO(0);
     }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     
     CHECK_GL_ERROR_DEBUG();
     
+    _vboCapacity = _bufferCapacity;
+    _iboCapacity = _indexCapacity;
     _dirty = true;
     
 #if CC_ENABLE_CACHE_TEXTURE_DATA
@@ -205,11 +236,81 @@ bool DrawNode::init()
     return true;
 }
 
+void DrawNode::setVertexAttribPointers(GLsizei vertexStart)
+{
+    size_t offset = vertexStart * sizeof(V2F_C4B_T2F);
+
+    // vertex
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, sizeof(V2F_C4B_T2F), (GLvoid *)(offset + offsetof(V2F_C4B_T2F, vertices)));
+
+    // color
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V2F_C4B_T2F), (GLvoid *)(offset + offsetof(V2F_C4B_T2F, colors)));
+
+    // texcood
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V2F_C4B_T2F), (GLvoid *)(offset + offsetof(V2F_C4B_T2F, texCoords)));
+}
+
+void DrawNode::uploadBuffers()
+{
+    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _ibo);
+
+    if (_dirty || _vboCapacity < _bufferCapacity || _iboCapacity < _indexCapacity)
+    {
+        // the buffers grew: reallocate them
+        glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*_bufferCapacity, _buffer, GL_DYNAMIC_DRAW);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLushort)*_indexCapacity, _indices, GL_DYNAMIC_DRAW);
+        _vboCapacity = _bufferCapacity;
+        _iboCapacity = _indexCapacity;
+        _dirty = false;
+    }
+    else
+    {
+        // only upload the primitives added since the last draw
+        if (_bufferCount > _uploadedVertexCount)
+        {
+            glBufferSubData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*_uploadedVertexCount, sizeof(V2F_C4B_T2F)*(_bufferCount - _uploadedVertexCount), _buffer + _uploadedVertexCount);
+        }
+        if (_indexCount > _uploadedIndexCount)
+        {
+            glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLushort)*_uploadedIndexCount, sizeof(GLushort)*(_indexCount - _uploadedIndexCount), _indices + _uploadedIndexCount);
+        }
+    }
+
+    _uploadedVertexCount = _bufferCount;
+    _uploadedIndexCount = _indexCount;
+}
+
+bool DrawNode::isBatchable(const Mat4 &transform) const
+{
+    // the batched vertices are transformed on the CPU without z
+    const float* m = transform.m;
+    bool is2D = (m[2] == 0 && m[3] == 0 && m[6] == 0 && m[7] == 0 && m[14] == 0 && m[15] == 1);
+
+    return is2D
+        && _chunks.size() == 1
+        && _bufferCount <= MAX_BATCHED_VERTICES
+        && _indexCount <= Renderer::TRIANGLES_INDEX_VBO_SIZE
+        && _glProgramState->getVertexAttribsFlags() == 0;
+}
+
 void DrawNode::draw(Renderer *renderer, const Mat4 &transform, bool transformUpdated)
 {
-    _customCommand.init(_globalZOrder);
-    _customCommand.func = CC_CALLBACK_0(DrawNode::onDraw, this, transform, transformUpdated);
-    renderer->addCommand(&_customCommand);
+    if (_indexCount == 0)
+    {
+        return;
+    }
+
+    if (isBatchable(transform))
+    {
+        _trianglesCommand.init(_globalZOrder, getGLProgramState(), _blendFunc, _buffer, _bufferCount, _indices, _indexCount, transform);
+        renderer->addCommand(&_trianglesCommand);
+    }
+    else
+    {
+        _customCommand.init(_globalZOrder, renderer->getFrameArena(), CC_CALLBACK_0(DrawNode::onDraw, this, transform, transformUpdated));
+        renderer->addCommand(&_customCommand);
+    }
 }
 
 void DrawNode::onDraw(const Mat4 &transform, bool transformUpdated)
@@ -220,63 +321,72 @@ void DrawNode::onDraw(const Mat4 &transform, bool transformUpdated)
 
     GL::blendFunc(_blendFunc.src, _blendFunc.dst);
 
-    if (_dirty)
-    {
-        glBindBuffer(GL_ARRAY_BUFFER, _vbo);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*_bufferCapacity, _buffer, GL_STREAM_DRAW);
-        _dirty = false;
-    }
-    if (Configuration::getInstance()->supportsShareableVAO())
+    bool useVAO = Configuration::getInstance()->supportsShareableVAO();
+    if (useVAO)
     {
         GL::bindVAO(_vao);
     }
     else
     {
         GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
+    }
 
-        glBindBuffer(GL_ARRAY_BUFFER, _vbo);
-        // vertex
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, sizeof(V2F_C4B_T2F), (GLvoid *)offsetof(V2F_C4B_T2F, vertices));
+    uploadBuffers();
 
-        // color
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V2F_C4B_T2F), (GLvoid *)offsetof(V2F_C4B_T2F, colors));
+    for (size_t i = 0; i < _chunks.size(); ++i)
+    {
+        const Chunk& chunk = _chunks[i];
+        GLsizei indexEnd = (i + 1 < _chunks.size()) ? _chunks[i + 1].indexStart : _indexCount;
 
-        // texcood
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V2F_C4B_T2F), (GLvoid *)offsetof(V2F_C4B_T2F, texCoords));
+        // the VAO already points at the first chunk
+        if (!useVAO || i > 0)
+        {
+            setVertexAttribPointers(chunk.vertexStart);
+        }
+        glDrawElements(GL_TRIANGLES, indexEnd - chunk.indexStart, GL_UNSIGNED_SHORT, (GLvoid *)(chunk.indexStart * sizeof(GLushort)));
     }
 
-    glDrawArrays(GL_TRIANGLES, 0, _bufferCount);
+    if (useVAO)
+    {
+        if (_chunks.size() > 1)
+        {
+            setVertexAttribPointers(0);
+        }
+        // Must unbind the VAO before changing the element buffer.
+        GL::bindVAO(0);
+    }
     glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
-    CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1,_bufferCount);
+    CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(_chunks.size(), _indexCount);
     CHECK_GL_ERROR_DEBUG();
 }
 
 void DrawNode::drawDot(const Vec2 &pos, float radius, const Color4F &color)
 {
-    unsigned int vertex_count = 2*3;
-    ensureCapacity(vertex_count);
+    unsigned int vertex_count = 4;
+    ensureCapacity(vertex_count, 6);
 	
-	V2F_C4B_T2F a = {Vec2(pos.x - radius, pos.y - radius), Color4B(color), Tex2F(-1.0, -1.0) };
-	V2F_C4B_T2F b = {Vec2(pos.x - radius, pos.y + radius), Color4B(color), Tex2F(-1.0,  1.0) };
-	V2F_C4B_T2F c = {Vec2(pos.x + radius, pos.y + radius), Color4B(color), Tex2F( 1.0,  1.0) };
-	V2F_C4B_T2F d = {Vec2(pos.x + radius, pos.y - radius), Color4B(color), Tex2F( 1.0, -1.0) };
+	V2F_C4B_T2F *vertices = _buffer + _bufferCount;
+	vertices[0] = {Vec2(pos.x - radius, pos.y - radius), Color4B(color), Tex2F(-1.0, -1.0) };
+	vertices[1] = {Vec2(pos.x - radius, pos.y + radius), Color4B(color), Tex2F(-1.0,  1.0) };
+	vertices[2] = {Vec2(pos.x + radius, pos.y + radius), Color4B(color), Tex2F( 1.0,  1.0) };
+	vertices[3] = {Vec2(pos.x + radius, pos.y - radius), Color4B(color), Tex2F( 1.0, -1.0) };
 	
-	V2F_C4B_T2F_Triangle *triangles = (V2F_C4B_T2F_Triangle *)(_buffer + _bufferCount);
-    V2F_C4B_T2F_Triangle triangle0 = {a, b, c};
-    V2F_C4B_T2F_Triangle triangle1 = {a, c, d};
-	triangles[0] = triangle0;
-	triangles[1] = triangle1;
+    GLushort base = getIndexBase();
+    const GLushort indices[] = {0, 1, 2, 0, 2, 3};
+    for (int i = 0; i < 6; ++i)
+    {
+        _indices[_indexCount++] = base + indices[i];
+    }
 	
 	_bufferCount += vertex_count;
-	
-	_dirty = true;
 }
 
 void DrawNode::drawSegment(const Vec2 &from, const Vec2 &to, float radius, const Color4F &color)
 {
-    unsigned int vertex_count = 6*3;
-    ensureCapacity(vertex_count);
+    unsigned int vertex_count = 8;
+    ensureCapacity(vertex_count, 6*3);
 	
 	Vec2 a = __v2f(from);
 	Vec2 b = __v2f(to);
@@ -297,53 +407,32 @@ void DrawNode::drawSegment(const Vec2 &from, const Vec2 &to, float radius, const
 	Vec2 v7 = v2fadd(a, v2fadd(nw, tw));
 	
 	
-	V2F_C4B_T2F_Triangle *triangles = (V2F_C4B_T2F_Triangle *)(_buffer + _bufferCount);
+	V2F_C4B_T2F *vertices = _buffer + _bufferCount;
+	vertices[0] = {v0, Color4B(color), __t(v2fneg(v2fadd(n, t)))};
+	vertices[1] = {v1, Color4B(color), __t(v2fsub(n, t))};
+	vertices[2] = {v2, Color4B(color), __t(v2fneg(n))};
+	vertices[3] = {v3, Color4B(color), __t(n)};
+	vertices[4] = {v4, Color4B(color), __t(v2fneg(n))};
+	vertices[5] = {v5, Color4B(color), __t(n)};
+	vertices[6] = {v6, Color4B(color), __t(v2fsub(t, n))};
+	vertices[7] = {v7, Color4B(color), __t(v2fadd(n, t))};
 	
-    V2F_C4B_T2F_Triangle triangles0 = {
-        {v0, Color4B(color), __t(v2fneg(v2fadd(n, t)))},
-        {v1, Color4B(color), __t(v2fsub(n, t))},
-        {v2, Color4B(color), __t(v2fneg(n))},
-    };
-	triangles[0] = triangles0;
-	
-    V2F_C4B_T2F_Triangle triangles1 = {
-        {v3, Color4B(color), __t(n)},
-        {v1, Color4B(color), __t(v2fsub(n, t))},
-        {v2, Color4B(color), __t(v2fneg(n))},
-    };
-	triangles[1] = triangles1;
-	
-    V2F_C4B_T2F_Triangle triangles2 = {
-        {v3, Color4B(color), __t(n)},
-        {v4, Color4B(color), __t(v2fneg(n))},
-        {v2, Color4B(color), __t(v2fneg(n))},
-    };
-	triangles[2] = triangles2;
-
-    V2F_C4B_T2F_Triangle triangles3 = {
-        {v3, Color4B(color), __t(n)},
-        {v4, Color4B(color), __t(v2fneg(n))},
-        {v5, Color4B(color), __t(n) },
-    };
-    triangles[3] = triangles3;
-
-    V2F_C4B_T2F_Triangle triangles4 = {
-        {v6, Color4B(color), __t(v2fsub(t, n))},
-        {v4, Color4B(color), __t(v2fneg(n)) },
-        {v5, Color4B(color), __t(n)},
+    // the two caps and the body of the segment
+    GLushort base = getIndexBase();
+    const GLushort indices[] = {
+        0, 1, 2,
+        3, 1, 2,
+        3, 4, 2,
+        3, 4, 5,
+        6, 4, 5,
+        6, 7, 5,
     };
-	triangles[4] = triangles4;
-
-    V2F_C4B_T2F_Triangle triangles5 = {
-        {v6, Color4B(color), __t(v2fsub(t, n))},
-        {v7, Color4B(color), __t(v2fadd(n, t))},
-        {v5, Color4B(color), __t(n)},
-    };
-	triangles[5] = triangles5;
+    for (int i = 0; i < 6*3; ++i)
+    {
+        _indices[_indexCount++] = base + indices[i];
+    }
 	
 	_bufferCount += vertex_count;
-	
-	_dirty = true;
 }
 
 void DrawNode::drawPolygon(Vec2 *verts, int count, const Color4F &fillColor, float borderWidth, const Color4F &borderColor)
@@ -370,27 +459,27 @@ void DrawNode::drawPolygon(Vec2 *verts, int count, const Color4F &fillColor, flo
 	
 	bool outline = (borderColor.a > 0.0 && borderWidth > 0.0);
 	
-	auto triangle_count = 3*count - 2;
-	auto vertex_count = 3*triangle_count;
-    ensureCapacity(vertex_count);
+    // the fill is a fan over the polygon's vertices, each edge is a quad
+    int fill_index_count = 3*MAX(count-2, 0);
+	auto vertex_count = count + 4*count;
+	auto index_count = fill_index_count + 6*count;
+    ensureCapacity(vertex_count, index_count);
 	
-	V2F_C4B_T2F_Triangle *triangles = (V2F_C4B_T2F_Triangle *)(_buffer + _bufferCount);
-	V2F_C4B_T2F_Triangle *cursor = triangles;
+	V2F_C4B_T2F *cursor = _buffer + _bufferCount;
+	GLushort *indexCursor = _indices + _indexCount;
+    GLushort base = getIndexBase();
 	
 	float inset = (outline == false ? 0.5 : 0.0);
+	for (int i = 0; i < count; i++)
+    {
+		Vec2 v = v2fsub(__v2f(verts[i]), v2fmult(extrude[i].offset, inset));
+		*cursor++ = {v, Color4B(fillColor), __t(v2fzero)};
+	}
 	for (int i = 0; i < count-2; i++)
     {
-		Vec2 v0 = v2fsub(__v2f(verts[0  ]), v2fmult(extrude[0  ].offset, inset));
-		Vec2 v1 = v2fsub(__v2f(verts[i+1]), v2fmult(extrude[i+1].offset, inset));
-		Vec2 v2 = v2fsub(__v2f(verts[i+2]), v2fmult(extrude[i+2].offset, inset));
-		
-        V2F_C4B_T2F_Triangle tmp = {
-            {v0, Color4B(fillColor), __t(v2fzero)},
-            {v1, Color4B(fillColor), __t(v2fzero)},
-            {v2, Color4B(fillColor), __t(v2fzero)},
-        };
-
-		*cursor++ = tmp;
+		*indexCursor++ = base;
+		*indexCursor++ = base + i + 1;
+		*indexCursor++ = base + i + 2;
 	}
 	
 	for(int i = 0; i < count; i++)
@@ -411,19 +500,10 @@ void DrawNode::drawPolygon(Vec2 *verts, int count, const Color4F &fillColor, flo
 			Vec2 outer0 = v2fadd(v0, v2fmult(offset0, borderWidth));
 			Vec2 outer1 = v2fadd(v1, v2fmult(offset1, borderWidth));
 			
-            V2F_C4B_T2F_Triangle tmp1 = {
-                {inner0, Color4B(borderColor), __t(v2fneg(n0))},
-                {inner1, Color4B(borderColor), __t(v2fneg(n0))},
-                {outer1, Color4B(borderColor), __t(n0)}
-            };
-			*cursor++ = tmp1;
-
-            V2F_C4B_T2F_Triangle tmp2 = {
-                {inner0, Color4B(borderColor), __t(v2fneg(n0))},
-                {outer0, Color4B(borderColor), __t(n0)},
-                {outer1, Color4B(borderColor), __t(n0)}
-            };
-			*cursor++ = tmp2;
+			*cursor++ = {inner0, Color4B(borderColor), __t(v2fneg(n0))};
+			*cursor++ = {inner1, Color4B(borderColor), __t(v2fneg(n0))};
+			*cursor++ = {outer1, Color4B(borderColor), __t(n0)};
+			*cursor++ = {outer0, Color4B(borderColor), __t(n0)};
 		}
         else {
 			Vec2 inner0 = v2fsub(v0, v2fmult(offset0, 0.5));
@@ -431,113 +511,114 @@ void DrawNode::drawPolygon(Vec2 *verts, int count, const Color4F &fillColor, flo
 			Vec2 outer0 = v2fadd(v0, v2fmult(offset0, 0.5));
 			Vec2 outer1 = v2fadd(v1, v2fmult(offset1, 0.5));
 			
-            V2F_C4B_T2F_Triangle tmp1 = {
-                {inner0, Color4B(fillColor), __t(v2fzero)},
-                {inner1, Color4B(fillColor), __t(v2fzero)},
-                {outer1, Color4B(fillColor), __t(n0)}
-            };
-			*cursor++ = tmp1;
-
-            V2F_C4B_T2F_Triangle tmp2 = {
-                {inner0, Color4B(fillColor), __t(v2fzero)},
-                {outer0, Color4B(fillColor), __t(n0)},
-                {outer1, Color4B(fillColor), __t(n0)}
-            };
-			*cursor++ = tmp2;
+			*cursor++ = {inner0, Color4B(fillColor), __t(v2fzero)};
+			*cursor++ = {inner1, Color4B(fillColor), __t(v2fzero)};
+			*cursor++ = {outer1, Color4B(fillColor), __t(n0)};
+			*cursor++ = {outer0, Color4B(fillColor), __t(n0)};
 		}
+		
+        // inner0, inner1, outer1 and inner0, outer0, outer1
+		GLushort edge = base + count + 4*i;
+		*indexCursor++ = edge;
+		*indexCursor++ = edge + 1;
+		*indexCursor++ = edge + 2;
+		*indexCursor++ = edge;
+		*indexCursor++ = edge + 3;
+		*indexCursor++ = edge + 2;
 	}
 	
 	_bufferCount += vertex_count;
-	
-	_dirty = true;
+	_indexCount += index_count;
 
     free(extrude);
 }
 
 void DrawNode::drawTriangle(const Vec2 &p1, const Vec2 &p2, const Vec2 &p3, const Color4F &color)
 {
-    unsigned int vertex_count = 2*3;
-    ensureCapacity(vertex_count);
+    unsigned int vertex_count = 3;
+    ensureCapacity(vertex_count, 3);
 
     Color4B col = Color4B(color);
-    V2F_C4B_T2F a = {Vec2(p1.x, p1.y), col, Tex2F(0.0, 0.0) };
-    V2F_C4B_T2F b = {Vec2(p2.x, p2.y), col, Tex2F(0.0,  0.0) };
-    V2F_C4B_T2F c = {Vec2(p3.x, p3.y), col, Tex2F(0.0,  0.0) };
+    V2F_C4B_T2F *vertices = _buffer + _bufferCount;
+    vertices[0] = {Vec2(p1.x, p1.y), col, Tex2F(0.0, 0.0) };
+    vertices[1] = {Vec2(p2.x, p2.y), col, Tex2F(0.0,  0.0) };
+    vertices[2] = {Vec2(p3.x, p3.y), col, Tex2F(0.0,  0.0) };
 
-    V2F_C4B_T2F_Triangle *triangles = (V2F_C4B_T2F_Triangle *)(_buffer + _bufferCount);
-    V2F_C4B_T2F_Triangle triangle = {a, b, c};
-    triangles[0] = triangle;
+    GLushort base = getIndexBase();
+    _indices[_indexCount++] = base;
+    _indices[_indexCount++] = base + 1;
+    _indices[_indexCount++] = base + 2;
 
     _bufferCount += vertex_count;
-    _dirty = true;
 }
 
 void DrawNode::drawCubicBezier(const Vec2& from, const Vec2& control1, const Vec2& control2, const Vec2& to, unsigned int segments, const Color4F &color)
 {
-    unsigned int vertex_count = (segments + 1) * 3;
-    ensureCapacity(vertex_count);
+    // a fan around `from`: from, to, then the points of the curve
+    unsigned int vertex_count = segments + 3;
+    ensureCapacity(vertex_count, (segments + 1) * 3);
 
     Tex2F texCoord = Tex2F(0.0, 0.0);
     Color4B col = Color4B(color);
-    Vec2 vertex;
-    Vec2 firstVertex = Vec2(from.x, from.y);
-    Vec2 lastVertex = Vec2(to.x, to.y);
+    GLushort base = getIndexBase();
+    V2F_C4B_T2F *vertices = _buffer + _bufferCount;
+    vertices[0] = {Vec2(from.x, from.y), col, texCoord};
+    vertices[1] = {Vec2(to.x, to.y), col, texCoord};
 
     float t = 0;
-    for(unsigned int i = segments + 1; i > 0; i--)
+    for(unsigned int i = 0; i < segments + 1; i++)
     {
         float x = powf(1 - t, 3) * from.x + 3.0f * powf(1 - t, 2) * t * control1.x + 3.0f * (1 - t) * t * t * control2.x + t * t * t * to.x;
         float y = powf(1 - t, 3) * from.y + 3.0f * powf(1 - t, 2) * t * control1.y + 3.0f * (1 - t) * t * t * control2.y + t * t * t * to.y;
-        vertex = Vec2(x, y);
+        vertices[i + 2] = {Vec2(x, y), col, texCoord};
 
-        V2F_C4B_T2F a = {firstVertex, col, texCoord };
-        V2F_C4B_T2F b = {lastVertex, col, texCoord };
-        V2F_C4B_T2F c = {vertex, col, texCoord };
-        V2F_C4B_T2F_Triangle triangle = {a, b, c};
-        ((V2F_C4B_T2F_Triangle *)(_buffer + _bufferCount))[0] = triangle;
+        _indices[_indexCount++] = base;
+        _indices[_indexCount++] = base + (i == 0 ? 1 : i + 1);
+        _indices[_indexCount++] = base + i + 2;
 
-        lastVertex = vertex;
         t += 1.0f / segments;
-        _bufferCount += 3;
     }
-    _dirty = true;
+    _bufferCount += vertex_count;
 }
 
 void DrawNode::drawQuadraticBezier(const Vec2& from, const Vec2& control, const Vec2& to, unsigned int segments, const Color4F &color)
 {
-    unsigned int vertex_count = (segments + 1) * 3;
-    ensureCapacity(vertex_count);
+    // a fan around `from`: from, to, then the points of the curve
+    unsigned int vertex_count = segments + 3;
+    ensureCapacity(vertex_count, (segments + 1) * 3);
 
     Tex2F texCoord = Tex2F(0.0, 0.0);
     Color4B col = Color4B(color);
-    Vec2 vertex;
-    Vec2 firstVertex = Vec2(from.x, from.y);
-    Vec2 lastVertex = Vec2(to.x, to.y);
+    GLushort base = getIndexBase();
+    V2F_C4B_T2F *vertices = _buffer + _bufferCount;
+    vertices[0] = {Vec2(from.x, from.y), col, texCoord};
+    vertices[1] = {Vec2(to.x, to.y), col, texCoord};
 
     float t = 0;
-    for(unsigned int i = segments + 1; i > 0; i--)
+    for(unsigned int i = 0; i < segments + 1; i++)
     {
         float x = powf(1 - t, 2) * from.x + 2.0f * (1 - t) * t * control.x + t * t * to.x;
         float y = powf(1 - t, 2) * from.y + 2.0f * (1 - t) * t * control.y + t * t * to.y;
-        vertex = Vec2(x, y);
+        vertices[i + 2] = {Vec2(x, y), col, texCoord};
 
-        V2F_C4B_T2F a = {firstVertex, col, texCoord };
-        V2F_C4B_T2F b = {lastVertex, col, texCoord };
-        V2F_C4B_T2F c = {vertex, col, texCoord };
-        V2F_C4B_T2F_Triangle triangle = {a, b, c};
-        ((V2F_C4B_T2F_Triangle *)(_buffer + _bufferCount))[0] = triangle;
+        _indices[_indexCount++] = base;
+        _indices[_indexCount++] = base + (i == 0 ? 1 : i + 1);
+        _indices[_indexCount++] = base + i + 2;
 
-        lastVertex = vertex;
         t += 1.0f / segments;
-        _bufferCount += 3;
     }
-    _dirty = true;
+    _bufferCount += vertex_count;
 }
 
 void DrawNode::clear()
 {
     _bufferCount = 0;
-    _dirty = true;
+    _indexCount = 0;
+    _chunks.clear();
+    _chunks.push_back({0, 0});
+    // the next primitives overwrite the uploaded ones
+    _uploadedVertexCount = 0;
+    _uploadedIndexCount = 0;
 }
 
 const BlendFunc& DrawNode::getBlendFunc() const
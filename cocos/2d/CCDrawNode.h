@@ -34,18 +34,27 @@
 #include "2d/CCNode.h"
 #include "base/ccTypes.h"
 #include "renderer/CCCustomCommand.h"
+#include "renderer/CCTrianglesCommand.h"
+#include <vector>
 
 NS_CC_BEGIN
 
 /** DrawNode
  Node that draws dots, segments and polygons.
  Faster than the "drawing primitives" since they it draws everything in one single batch.
+
+ The geometry is indexed and kept in a GL buffer: only the primitives added since the last frame are uploaded.
+ Small DrawNodes with a 2D transform are drawn through a `TrianglesCommand`, so consecutive ones with the
+ same blending function are merged by the `Renderer` into a single draw call.
  
  @since v2.1
  */
 class CC_DLL DrawNode : public Node
 {
 public:
+    /** DrawNodes with more vertices than this are drawn with their own GL buffer instead of being batched */
+    static const int MAX_BATCHED_VERTICES = 2048;
+
     /** creates and initialize a DrawNode node */
     static DrawNode* create();
 
@@ -100,18 +109,46 @@ CC_CONSTRUCTOR_ACCESS:
     virtual bool init();
 
 protected:
-    void ensureCapacity(int count);
+    // makes room for a primitive, starting a new chunk if its indices don't fit in 16 bits
+    void ensureCapacity(int vertexCount, int indexCount);
+    // first index of the next primitive, relative to the current chunk
+    GLushort getIndexBase() const { return (GLushort)(_bufferCount - _chunks.back().vertexStart); }
+    void uploadBuffers();
+    void setVertexAttribPointers(GLsizei vertexStart);
+    bool isBatchable(const Mat4 &transform) const;
+
+    // vertices and indices drawn by one glDrawElements call, the indices are relative to vertexStart
+    struct Chunk
+    {
+        GLsizei vertexStart;
+        GLsizei indexStart;
+    };
 
     GLuint      _vao;
     GLuint      _vbo;
+    GLuint      _ibo;
 
     int         _bufferCapacity;
     GLsizei     _bufferCount;
     V2F_C4B_T2F *_buffer;
 
+    int         _indexCapacity;
+    GLsizei     _indexCount;
+    GLushort    *_indices;
+
+    std::vector<Chunk> _chunks;
+
+    // what the GL buffers can hold, and what they already have
+    int         _vboCapacity;
+    int         _iboCapacity;
+    GLsizei     _uploadedVertexCount;
+    GLsizei     _uploadedIndexCount;
+
     BlendFunc   _blendFunc;
     CustomCommand _customCommand;
+    TrianglesCommand _trianglesCommand;
 
+    // the GL buffers must be uploaded again entirely
     bool        _dirty;
 
 private:
@@ -0,0 +1,475 @@
+/****************************************************************************
+Copyright (c) 2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "2d/CCDynamicAtlas.h"
+#include "2d/CCTexture2D.h"
+#include "2d/CCTextureCache.h"
+#include "2d/platform/CCImage.h"
+#include "2d/platform/CCFileUtils.h"
+#include "base/CCDirector.h"
+#include "base/ccMacros.h"
+#include "deprecated/CCString.h"
+
+#include <algorithm>
+#include <climits>
+
+NS_CC_BEGIN
+
+static DynamicAtlas* s_sharedDynamicAtlas = nullptr;
+
+// every image is surrounded by a gutter of this width, filled with its edge pixels
+static const int GUTTER = 1;
+
+// DynamicAtlasFrame
+
+DynamicAtlasFrame::DynamicAtlasFrame()
+: _page(nullptr)
+, _lastDrawnFrame(UINT_MAX)
+{
+    _region.x = _region.y = _region.width = _region.height = 0;
+}
+
+void DynamicAtlasFrame::onDrawn(unsigned int drawnFrame)
+{
+    if (_page)
+    {
+        DynamicAtlas::getInstance()->onFrameDrawn(this, drawnFrame);
+    }
+}
+
+// DynamicAtlas
+
+DynamicAtlas* DynamicAtlas::getInstance()
+{
+    if (! s_sharedDynamicAtlas)
+    {
+        s_sharedDynamicAtlas = new DynamicAtlas();
+    }
+    return s_sharedDynamicAtlas;
+}
+
+void DynamicAtlas::destroyInstance()
+{
+    CC_SAFE_RELEASE_NULL(s_sharedDynamicAtlas);
+}
+
+DynamicAtlas::DynamicAtlas()
+: _enabled(false)
+, _pageSize(1024)
+, _maxImageSize(256)
+, _maxPages(4)
+, _statsFrame(0)
+, _framesDrawn(0)
+, _pagesDrawn(0)
+, _lastFramesDrawn(0)
+, _lastPagesDrawn(0)
+{
+}
+
+DynamicAtlas::~DynamicAtlas()
+{
+    for (auto& frame : _frames)
+    {
+        frame.second->_page = nullptr;
+        frame.second->release();
+    }
+    for (auto page : _pages)
+    {
+        releasePage(page);
+    }
+}
+
+DynamicAtlasFrame* DynamicAtlas::getFrameForFile(const std::string& filename)
+{
+    if (!_enabled)
+    {
+        return nullptr;
+    }
+
+    std::string fullpath = FileUtils::getInstance()->fullPathForFilename(filename);
+    if (fullpath.empty())
+    {
+        return nullptr;
+    }
+
+    auto it = _frames.find(fullpath);
+    if (it != _frames.end())
+    {
+        return it->second;
+    }
+
+    // already a standalone texture, don't load it twice
+    TextureCache* textureCache = Director::getInstance()->getTextureCache();
+    if (textureCache->getTextureForKey(fullpath))
+    {
+        return nullptr;
+    }
+
+    Image* image = new Image();
+    if (!image->initWithImageFile(fullpath))
+    {
+        image->release();
+        return nullptr;
+    }
+
+    DynamicAtlasFrame* frame = packImage(image);
+    if (frame)
+    {
+        _frames.insert(std::make_pair(fullpath, frame));
+    }
+    else
+    {
+        // hand the decoded image to the TextureCache, where Sprite::initWithFile() finds it
+        textureCache->addImage(image, fullpath);
+    }
+    image->release();
+
+    return frame;
+}
+
+DynamicAtlasFrame* DynamicAtlas::packImage(Image* image)
+{
+    int width = image->getWidth();
+    int height = image->getHeight();
+    if (image->isCompressed() || width > _maxImageSize || height > _maxImageSize)
+    {
+        return nullptr;
+    }
+
+    Page* page = nullptr;
+    Region region;
+    int paddedWidth = width + 2 * GUTTER;
+    int paddedHeight = height + 2 * GUTTER;
+    if (!allocate(paddedWidth, paddedHeight, &page, &region))
+    {
+        // make room with the images that aren't used anymore
+        if (removeUnusedFrames() == 0 || !allocate(paddedWidth, paddedHeight, &page, &region))
+        {
+            return nullptr;
+        }
+    }
+
+    unsigned char* rgba = nullptr;
+    ssize_t rgbaLen = 0;
+    Texture2D::PixelFormat format = Texture2D::convertDataToFormat(image->getData(), image->getDataLen(), image->getRenderFormat(),
+                                                                   Texture2D::PixelFormat::RGBA8888, &rgba, &rgbaLen);
+    if (format != Texture2D::PixelFormat::RGBA8888 || rgbaLen < (ssize_t)width * height * 4)
+    {
+        if (rgba != image->getData())
+        {
+            free(rgba);
+        }
+        // gives the region back
+        page->freeRegions.push_back(region);
+        if (page->frames == 0)
+        {
+            releasePage(page);
+            _pages.erase(std::find(_pages.begin(), _pages.end(), page));
+        }
+        return nullptr;
+    }
+
+    // the pages have premultiplied alpha
+    bool premultiply = image->hasAlpha() && !image->isPremultipliedAlpha();
+
+    std::vector<unsigned char> pixels(paddedWidth * paddedHeight * 4);
+    for (int y = 0; y < paddedHeight; y++)
+    {
+        // the gutter repeats the edges of the image
+        int srcY = std::min(std::max(y - GUTTER, 0), height - 1);
+        const unsigned char* srcRow = rgba + srcY * width * 4;
+        unsigned char* dstRow = &pixels[y * paddedWidth * 4];
+        for (int x = 0; x < paddedWidth; x++)
+        {
+            int srcX = std::min(std::max(x - GUTTER, 0), width - 1);
+            const unsigned char* src = srcRow + srcX * 4;
+            unsigned char* dst = dstRow + x * 4;
+            if (premultiply)
+            {
+                dst[0] = (unsigned char)(src[0] * src[3] / 255);
+                dst[1] = (unsigned char)(src[1] * src[3] / 255);
+                dst[2] = (unsigned char)(src[2] * src[3] / 255);
+                dst[3] = src[3];
+            }
+            else
+            {
+                memcpy(dst, src, 4);
+            }
+        }
+    }
+    if (rgba != image->getData())
+    {
+        free(rgba);
+    }
+
+    page->texture->updateWithData(pixels.data(), region.x, region.y, paddedWidth, paddedHeight);
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    for (int y = 0; y < paddedHeight; y++)
+    {
+        memcpy(page->pixels + ((region.y + y) * _pageSize + region.x) * 4, &pixels[y * paddedWidth * 4], paddedWidth * 4);
+    }
+#endif
+
+    page->usedArea += width * height;
+    page->frames++;
+
+    float scale = CC_CONTENT_SCALE_FACTOR();
+    Rect rect((region.x + GUTTER) / scale, (region.y + GUTTER) / scale, width / scale, height / scale);
+
+    DynamicAtlasFrame* frame = new DynamicAtlasFrame();
+    frame->initWithTexture(page->texture, rect);
+    frame->_page = page;
+    frame->_region = region;
+    return frame;
+}
+
+// Guillotine bin packing: the free region that fits best is split in two along its shorter leftover side.
+bool DynamicAtlas::allocate(int width, int height, Page** page, Region* region)
+{
+    Page* bestPage = nullptr;
+    size_t bestIndex = 0;
+    int bestArea = INT_MAX;
+    for (auto candidate : _pages)
+    {
+        for (size_t i = 0; i < candidate->freeRegions.size(); i++)
+        {
+            const Region& free = candidate->freeRegions[i];
+            int area = free.width * free.height;
+            if (free.width >= width && free.height >= height && area < bestArea)
+            {
+                bestPage = candidate;
+                bestIndex = i;
+                bestArea = area;
+            }
+        }
+    }
+
+    if (!bestPage)
+    {
+        if ((int)_pages.size() >= _maxPages || width > _pageSize || height > _pageSize)
+        {
+            return false;
+        }
+        bestPage = addPage();
+        if (!bestPage)
+        {
+            return false;
+        }
+        bestIndex = 0;
+    }
+
+    Region free = bestPage->freeRegions[bestIndex];
+    bestPage->freeRegions.erase(bestPage->freeRegions.begin() + bestIndex);
+
+    int leftoverWidth = free.width - width;
+    int leftoverHeight = free.height - height;
+    Region right = { free.x + width, free.y, leftoverWidth, 0 };
+    Region below = { free.x, free.y + height, 0, leftoverHeight };
+    if (leftoverWidth < leftoverHeight)
+    {
+        right.height = height;
+        below.width = free.width;
+    }
+    else
+    {
+        right.height = free.height;
+        below.width = width;
+    }
+    if (right.width > 0 && right.height > 0)
+    {
+        bestPage->freeRegions.push_back(right);
+    }
+    if (below.width > 0 && below.height > 0)
+    {
+        bestPage->freeRegions.push_back(below);
+    }
+
+    Region allocated = { free.x, free.y, width, height };
+    *page = bestPage;
+    *region = allocated;
+    return true;
+}
+
+DynamicAtlas::Page* DynamicAtlas::addPage()
+{
+    size_t dataLen = (size_t)_pageSize * _pageSize * 4;
+    unsigned char* pixels = static_cast<unsigned char*>(calloc(dataLen, 1));
+    if (!pixels)
+    {
+        return nullptr;
+    }
+
+    // premultiplied, like the images of the TextureCache
+    Image* image = new Image();
+    image->initWithRawData(pixels, dataLen, _pageSize, _pageSize, 8, true);
+    Texture2D* texture = new Texture2D();
+    bool ok = texture->initWithImage(image, Texture2D::PixelFormat::RGBA8888);
+    image->release();
+    if (!ok)
+    {
+        texture->release();
+        free(pixels);
+        return nullptr;
+    }
+
+    Page* page = new Page();
+    page->texture = texture;
+    Region all = { 0, 0, _pageSize, _pageSize };
+    page->freeRegions.push_back(all);
+    page->usedArea = 0;
+    page->frames = 0;
+    page->lastDrawnFrame = UINT_MAX;
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    page->pixels = pixels;
+    VolatileTextureMgr::addDataTexture(texture, pixels, (int)dataLen, Texture2D::PixelFormat::RGBA8888, Size(_pageSize, _pageSize));
+#else
+    free(pixels);
+#endif
+
+    _pages.push_back(page);
+    CCLOG("cocos2d: DynamicAtlas: added page %d (%d x %d)", (int)_pages.size(), _pageSize, _pageSize);
+    return page;
+}
+
+void DynamicAtlas::releasePage(Page* page)
+{
+    // the sprites that still use the texture keep it alive
+    page->texture->release();
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    free(page->pixels);
+#endif
+    delete page;
+}
+
+int DynamicAtlas::removeUnusedFrames()
+{
+    int removed = 0;
+    for (auto it = _frames.begin(); it != _frames.end(); /* nothing */)
+    {
+        DynamicAtlasFrame* frame = it->second;
+        if (frame->getReferenceCount() > 1)
+        {
+            ++it;
+            continue;
+        }
+
+        Page* page = frame->_page;
+        Region region = frame->_region;
+        page->usedArea -= (region.width - 2 * GUTTER) * (region.height - 2 * GUTTER);
+        page->frames--;
+
+        // merge the region with the free regions sharing a whole side with it
+        bool merged = true;
+        while (merged)
+        {
+            merged = false;
+            for (auto free = page->freeRegions.begin(); free != page->freeRegions.end(); ++free)
+            {
+                bool sameRow = free->y == region.y && free->height == region.height &&
+                    (free->x + free->width == region.x || region.x + region.width == free->x);
+                bool sameColumn = free->x == region.x && free->width == region.width &&
+                    (free->y + free->height == region.y || region.y + region.height == free->y);
+                if (sameRow)
+                {
+                    region.x = std::min(region.x, free->x);
+                    region.width += free->width;
+                }
+                else if (sameColumn)
+                {
+                    region.y = std::min(region.y, free->y);
+                    region.height += free->height;
+                }
+                else
+                {
+                    continue;
+                }
+                page->freeRegions.erase(free);
+                merged = true;
+                break;
+            }
+        }
+        page->freeRegions.push_back(region);
+
+        frame->_page = nullptr;
+        frame->release();
+        it = _frames.erase(it);
+        removed++;
+
+        if (page->frames == 0)
+        {
+            _pages.erase(std::find(_pages.begin(), _pages.end(), page));
+            releasePage(page);
+        }
+    }
+    return removed;
+}
+
+void DynamicAtlas::onFrameDrawn(DynamicAtlasFrame* frame, unsigned int drawnFrame)
+{
+    if (drawnFrame != _statsFrame)
+    {
+        _lastFramesDrawn = _framesDrawn;
+        _lastPagesDrawn = _pagesDrawn;
+        _framesDrawn = _pagesDrawn = 0;
+        _statsFrame = drawnFrame;
+    }
+
+    _framesDrawn++;
+    if (frame->_page->lastDrawnFrame != drawnFrame)
+    {
+        frame->_page->lastDrawnFrame = drawnFrame;
+        _pagesDrawn++;
+    }
+}
+
+DynamicAtlas::Stats DynamicAtlas::getStats() const
+{
+    Stats stats;
+    stats.pages = (int)_pages.size();
+    stats.frames = (int)_frames.size();
+
+    int usedArea = 0;
+    for (auto page : _pages)
+    {
+        usedArea += page->usedArea;
+    }
+    stats.fillRatio = _pages.empty() ? 0 : usedArea / ((float)_pages.size() * _pageSize * _pageSize);
+
+    // nothing drawn since the last frame with atlas sprites
+    bool recent = _statsFrame + 1 >= Director::getInstance()->getTotalFrames();
+    stats.framesDrawn = recent ? _lastFramesDrawn : 0;
+    stats.pagesDrawn = recent ? _lastPagesDrawn : 0;
+    stats.drawCallsSaved = stats.framesDrawn - stats.pagesDrawn;
+    return stats;
+}
+
+std::string DynamicAtlas::getInfo() const
+{
+    Stats stats = getStats();
+    return StringUtils::format("DynamicAtlas: %s, %d images in %d pages of %d x %d, %.1f%% filled\nLast frame: %d images drawn from %d pages, ~%d draw calls saved\n",
+                               _enabled ? "on" : "off", stats.frames, stats.pages, _pageSize, _pageSize, stats.fillRatio * 100,
+                               stats.framesDrawn, stats.pagesDrawn, stats.drawCallsSaved);
+}
+
+NS_CC_END
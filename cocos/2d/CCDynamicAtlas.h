@@ -0,0 +1,196 @@
+/****************************************************************************
+Copyright (c) 2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CCDYNAMIC_ATLAS_H__
+#define __CCDYNAMIC_ATLAS_H__
+
+#include "2d/CCSpriteFrame.h"
+#include "base/CCRef.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+NS_CC_BEGIN
+
+class Texture2D;
+class Image;
+class DynamicAtlasFrame;
+
+/**
+ * @addtogroup sprite_nodes
+ * @{
+ */
+
+/** @brief Packs small images into shared textures (pages) at runtime, so that the sprites created from
+ loose image files can be batched together by the Renderer.
+
+ Once enabled, Sprite::initWithFile() asks the atlas for the frame of the image. The images smaller than
+ getMaxImageSize() are copied into a page with a bin packer, with a 1 pixel gutter filled with their edges
+ to avoid bleeding. The other images, and the ones that don't fit the pages, are loaded by the TextureCache
+ as before.
+
+ The sprites of packed images use the page as their texture, so code that relies on the texture of such
+ a sprite being the image alone (texture parameters, texture rects set by hand) must not enable the atlas.
+
+ Images whose frames aren't used by any sprite anymore are removed by removeUnusedFrames(), which runs when
+ the pages are full and on Director::purgeCachedData(). Their space is reused, and empty pages are released.
+ */
+class CC_DLL DynamicAtlas : public Ref
+{
+public:
+    /** Returns the shared instance of the atlas */
+    static DynamicAtlas* getInstance();
+
+    /** Destroys the atlas and its pages. The sprites using them keep their texture */
+    static void destroyInstance();
+
+    /** Enables the atlas, it is disabled by default */
+    void setEnabled(bool enabled) { _enabled = enabled; }
+    bool isEnabled() const { return _enabled; }
+
+    /** Sets the size in pixels of the pages created from now on. Default 1024 */
+    void setPageSize(int pageSize) { _pageSize = pageSize; }
+    int getPageSize() const { return _pageSize; }
+
+    /** Sets the maximum width and height in pixels of the packed images. Default 256 */
+    void setMaxImageSize(int maxImageSize) { _maxImageSize = maxImageSize; }
+    int getMaxImageSize() const { return _maxImageSize; }
+
+    /** Sets how many pages can be created. Default 4 */
+    void setMaxPages(int maxPages) { _maxPages = maxPages; }
+    int getMaxPages() const { return _maxPages; }
+
+    /** Returns the frame of the image file, packing it if needed.
+     Returns nullptr if the atlas is disabled, or if the image is loaded as a standalone texture of the TextureCache,
+     which happens when it is too big, compressed or doesn't fit the pages.
+     */
+    DynamicAtlasFrame* getFrameForFile(const std::string& filename);
+
+    /** Removes the images not used by any sprite, and releases the pages left empty.
+     Returns the number of removed images.
+     */
+    int removeUnusedFrames();
+
+    struct Stats
+    {
+        int pages;
+        int frames;
+        /** area of the packed images over the area of the pages */
+        float fillRatio;
+        /** distinct packed images drawn in the last frame */
+        int framesDrawn;
+        /** distinct pages drawn in the last frame */
+        int pagesDrawn;
+        /** estimation of the draw calls saved in the last frame: every loose texture needs its own draw call */
+        int drawCallsSaved;
+    };
+    Stats getStats() const;
+
+    /** Returns the statistics as text, as printed by the "atlas" console command */
+    std::string getInfo() const;
+
+protected:
+    friend class DynamicAtlasFrame;
+
+    struct Region
+    {
+        int x, y, width, height;
+    };
+
+    struct Page
+    {
+        Texture2D* texture;
+        // free regions of the guillotine packer
+        std::vector<Region> freeRegions;
+        int usedArea;
+        int frames;
+        unsigned int lastDrawnFrame;
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+        // copy of the pixels, uploaded again when the GL context is recreated
+        unsigned char* pixels;
+#endif
+    };
+
+    DynamicAtlas();
+    virtual ~DynamicAtlas();
+
+    DynamicAtlasFrame* packImage(Image* image);
+    bool allocate(int width, int height, Page** page, Region* region);
+    Page* addPage();
+    void releasePage(Page* page);
+    void onFrameDrawn(DynamicAtlasFrame* frame, unsigned int drawnFrame);
+
+    bool _enabled;
+    int _pageSize;
+    int _maxImageSize;
+    int _maxPages;
+
+    std::vector<Page*> _pages;
+    // frames by full path of their image
+    std::unordered_map<std::string, DynamicAtlasFrame*> _frames;
+
+    // draw call statistics of the frame being drawn, and of the last one
+    unsigned int _statsFrame;
+    int _framesDrawn;
+    int _pagesDrawn;
+    int _lastFramesDrawn;
+    int _lastPagesDrawn;
+};
+
+/** @brief A SpriteFrame of an image packed by the DynamicAtlas.
+ A Sprite created from the image file retains its frame, so the atlas knows which images are still in use.
+ */
+class CC_DLL DynamicAtlasFrame : public SpriteFrame
+{
+public:
+    /** Counts the frame in the draw call statistics of the atlas, once per drawn frame */
+    inline void markDrawn(unsigned int drawnFrame)
+    {
+        if (_lastDrawnFrame != drawnFrame)
+        {
+            _lastDrawnFrame = drawnFrame;
+            onDrawn(drawnFrame);
+        }
+    }
+
+protected:
+    friend class DynamicAtlas;
+
+    DynamicAtlasFrame();
+    void onDrawn(unsigned int drawnFrame);
+
+    // the page is null once the frame was removed from the atlas
+    DynamicAtlas::Page* _page;
+    // region of the page used by the image, with its gutter
+    DynamicAtlas::Region _region;
+    unsigned int _lastDrawnFrame;
+};
+
+// end of sprite_nodes group
+/// @}
+
+NS_CC_END
+
+#endif // __CCDYNAMIC_ATLAS_H__
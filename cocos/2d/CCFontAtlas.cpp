@@ -30,19 +30,32 @@
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventType.h"
+#include "base/CCScheduler.h"
+
+#include <chrono>
 
 NS_CC_BEGIN
 
 const int FontAtlas::CacheTextureWidth = 512;
 const int FontAtlas::CacheTextureHeight = 512;
 const char* FontAtlas::EVENT_PURGE_TEXTURES = "__cc_FontAtlasPurgeTextures";
+const int FontAtlas::DefaultMaxPageCount = 0;
+
+static unsigned int s_lastGeneration = 0;
 
 FontAtlas::FontAtlas(Font &theFont) 
 : _font(&theFont)
 , _currentPageData(nullptr)
+, _maxPageCount(DefaultMaxPageCount)
+, _useStamp(0)
+, _purgeEventPending(false)
+, _rasterizedGlyphCount(0)
+, _rasterizationTime(0)
+, _evictedPageCount(0)
+, _generation(++s_lastGeneration)
 , _fontAscender(0)
-, _toForegroundListener(nullptr)
 , _toBackgroundListener(nullptr)
+, _toForegroundListener(nullptr)
 , _antialiasEnabled(true)
 {
     _font->retain();
@@ -54,8 +67,10 @@ FontAtlas::FontAtlas(Font &theFont)
         _fontAscender = fontTTf->getFontAscender();
         auto texture = new Texture2D;
         _currentPage = 0;
-        _currentPageOrigX = 0;
-        _currentPageOrigY = 0;
+        _pageLastUsed.push_back(0);
+        _skyline.push_back({0, 0, CacheTextureWidth});
+        _dirtyTop = CacheTextureHeight;
+        _dirtyBottom = 0;
         _letterPadding = 0;
 
         if(fontTTf->isDistanceFieldEnabled())
@@ -139,10 +154,10 @@ void FontAtlas::purgeTexturesAtlas()
         _atlasTextures[0] = temp;
 
         _fontLetterDefinitions.clear();
-        memset(_currentPageData,0,_currentPageDataSize);
         _currentPage = 0;
-        _currentPageOrigX = 0;
-        _currentPageOrigY = 0;
+        _pageLastUsed.resize(1);
+        resetCurrentPage();
+        _generation = ++s_lastGeneration;
 
         auto eventDispatcher = Director::getInstance()->getEventDispatcher();
         eventDispatcher->dispatchCustomEvent(EVENT_PURGE_TEXTURES,this);
@@ -167,10 +182,10 @@ void FontAtlas::listenToBackground(EventCustom *event)
         _atlasTextures[0] = temp;
 
         _fontLetterDefinitions.clear();
-        memset(_currentPageData,0,_currentPageDataSize);
         _currentPage = 0;
-        _currentPageOrigX = 0;
-        _currentPageOrigY = 0;
+        _pageLastUsed.resize(1);
+        resetCurrentPage();
+        _generation = ++s_lastGeneration;
     }
 #endif
 }
@@ -181,7 +196,7 @@ void FontAtlas::listenToForeground(EventCustom *event)
     FontFreeType* fontTTf = dynamic_cast<FontFreeType*>(_font);
     if (fontTTf)
     {
-        if (_currentPageOrigX == 0 && _currentPageOrigY == 0)
+        if (_skyline.size() == 1 && _skyline[0].y == 0)
         {
             auto eventDispatcher = Director::getInstance()->getEventDispatcher();
             eventDispatcher->dispatchCustomEvent(EVENT_PURGE_TEXTURES,this);
@@ -218,6 +233,191 @@ bool FontAtlas::getLetterDefinitionForChar(char16_t letteCharUTF16, FontLetterDe
     }
 }
 
+bool FontAtlas::findPosition(int width, int height, int& outX, int& outY)
+{
+    // bottom-left rule: the position whose top is the lowest, then the narrowest level
+    int bestTop = CacheTextureHeight + 1;
+    int bestWidth = CacheTextureWidth + 1;
+    bool found = false;
+
+    for (size_t i = 0; i < _skyline.size(); ++i)
+    {
+        int x = _skyline[i].x;
+        if (x + width > CacheTextureWidth)
+        {
+            break;
+        }
+
+        // the rectangle rests on the highest level it spans
+        int y = 0;
+        int widthLeft = width;
+        for (size_t j = i; widthLeft > 0; ++j)
+        {
+            y = MAX(y, _skyline[j].y);
+            widthLeft -= _skyline[j].width;
+        }
+
+        if (y + height <= CacheTextureHeight &&
+            (y + height < bestTop || (y + height == bestTop && _skyline[i].width < bestWidth)))
+        {
+            bestTop = y + height;
+            bestWidth = _skyline[i].width;
+            outX = x;
+            outY = y;
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+void FontAtlas::addSkylineLevel(int x, int y, int width, int height)
+{
+    size_t index = 0;
+    while (_skyline[index].x != x)
+    {
+        ++index;
+    }
+    _skyline.insert(_skyline.begin() + index, {x, y + height, width});
+
+    // shrink or remove the levels now covered by the new one
+    for (size_t i = index + 1; i < _skyline.size(); )
+    {
+        int covered = x + width - _skyline[i].x;
+        if (covered <= 0)
+        {
+            break;
+        }
+        if (covered < _skyline[i].width)
+        {
+            _skyline[i].x += covered;
+            _skyline[i].width -= covered;
+            break;
+        }
+        _skyline.erase(_skyline.begin() + i);
+    }
+
+    // merge the neighbours at the same height
+    for (size_t i = 0; i + 1 < _skyline.size(); )
+    {
+        if (_skyline[i].y == _skyline[i + 1].y)
+        {
+            _skyline[i].width += _skyline[i + 1].width;
+            _skyline.erase(_skyline.begin() + i + 1);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+
+void FontAtlas::resetCurrentPage()
+{
+    memset(_currentPageData, 0, _currentPageDataSize);
+    _skyline.clear();
+    _skyline.push_back({0, 0, CacheTextureWidth});
+    _dirtyTop = CacheTextureHeight;
+    _dirtyBottom = 0;
+}
+
+void FontAtlas::uploadCurrentPage()
+{
+    if (_dirtyTop < _dirtyBottom)
+    {
+        int bytesPerPixel = _currentPageDataSize / (CacheTextureWidth * CacheTextureHeight);
+        auto data = _currentPageData + CacheTextureWidth * _dirtyTop * bytesPerPixel;
+        _atlasTextures[_currentPage]->updateWithData(data, 0, _dirtyTop, CacheTextureWidth, _dirtyBottom - _dirtyTop);
+    }
+    _dirtyTop = CacheTextureHeight;
+    _dirtyBottom = 0;
+}
+
+void FontAtlas::nextPage()
+{
+    FontFreeType* fontTTf = static_cast<FontFreeType*>(_font);
+    auto  pixelFormat = fontTTf->getOutlineSize() > 0 ? Texture2D::PixelFormat::AI88 : Texture2D::PixelFormat::A8;
+
+    uploadCurrentPage();
+
+    // pick the least recently used page, but never one used by the text being prepared
+    int lruPage = -1;
+    if (_maxPageCount > 0 && (int)_pageLastUsed.size() >= _maxPageCount)
+    {
+        for (int page = 0; page < (int)_pageLastUsed.size(); ++page)
+        {
+            if (_pageLastUsed[page] != _useStamp && (lruPage < 0 || _pageLastUsed[page] < _pageLastUsed[lruPage]))
+            {
+                lruPage = page;
+            }
+        }
+    }
+
+    resetCurrentPage();
+
+    if (lruPage >= 0)
+    {
+        for (auto it = _fontLetterDefinitions.begin(); it != _fontLetterDefinitions.end(); )
+        {
+            if (it->second.textureID == lruPage && it->second.width > 0)
+            {
+                it = _fontLetterDefinitions.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        _currentPage = lruPage;
+        // clears the old glyphs so that they don't bleed into the new ones
+        _atlasTextures[_currentPage]->updateWithData(_currentPageData, 0, 0, CacheTextureWidth, CacheTextureHeight);
+        ++_evictedPageCount;
+        _generation = ++s_lastGeneration;
+        dispatchPurgeEvent();
+    }
+    else
+    {
+        if (_maxPageCount > 0 && (int)_pageLastUsed.size() >= _maxPageCount)
+        {
+            CCLOG("cocos2d: FontAtlas: all the pages are used by the same text, adding a page over the limit");
+        }
+
+        _currentPage = (int)_pageLastUsed.size();
+        _pageLastUsed.push_back(0);
+        auto tex = new Texture2D;
+        if (_antialiasEnabled)
+        {
+            tex->setAntiAliasTexParameters();
+        } 
+        else
+        {
+            tex->setAliasTexParameters();
+        }
+        tex->initWithData(_currentPageData, _currentPageDataSize, 
+            pixelFormat, CacheTextureWidth, CacheTextureHeight, Size(CacheTextureWidth,CacheTextureHeight) );
+        addTexture(tex,_currentPage);
+        tex->release();
+    }
+    _pageLastUsed[_currentPage] = _useStamp;
+}
+
+void FontAtlas::dispatchPurgeEvent()
+{
+    // the labels lay out again on the next frame, not while one of them is preparing its letters
+    if (_purgeEventPending)
+    {
+        return;
+    }
+    _purgeEventPending = true;
+    retain();
+    Director::getInstance()->getScheduler()->performFunctionInCocosThread([this](){
+        _purgeEventPending = false;
+        Director::getInstance()->getEventDispatcher()->dispatchCustomEvent(EVENT_PURGE_TEXTURES, this);
+        release();
+    });
+}
+
 bool FontAtlas::prepareLetterDefinitions(const std::u16string& utf16String)
 {
     FontFreeType* fontTTf = dynamic_cast<FontFreeType*>(_font);
@@ -233,12 +433,20 @@ bool FontAtlas::prepareLetterDefinitions(const std::u16string& utf16String)
     FontLetterDefinition tempDef;
 
     auto scaleFactor = CC_CONTENT_SCALE_FACTOR();
-    auto  pixelFormat = fontTTf->getOutlineSize() > 0 ? Texture2D::PixelFormat::AI88 : Texture2D::PixelFormat::A8; 
 
-    bool existNewLetter = false;
     int bottomHeight = _commonLineHeight - _fontAscender;
 
-    float startY = _currentPageOrigY;
+    // mark the pages used by the text, they must not be evicted while preparing it
+    ++_useStamp;
+    _pageLastUsed[_currentPage] = _useStamp;
+    for (size_t i = 0; i < length; ++i)
+    {
+        auto outIterator = _fontLetterDefinitions.find(utf16String[i]);
+        if (outIterator != _fontLetterDefinitions.end() && outIterator->second.width > 0)
+        {
+            _pageLastUsed[outIterator->second.textureID] = _useStamp;
+        }
+    }
 
     for (size_t i = 0; i < length; ++i)
     {
@@ -246,9 +454,18 @@ bool FontAtlas::prepareLetterDefinitions(const std::u16string& utf16String)
 
         if (outIterator == _fontLetterDefinitions.end())
         {  
-            existNewLetter = true;
+            auto startTime = std::chrono::steady_clock::now();
 
             auto bitmap = fontTTf->getGlyphBitmap(utf16String[i],bitmapWidth,bitmapHeight,tempRect,tempDef.xAdvance);
+            if (bitmap && (tempRect.size.width + _letterPadding >= CacheTextureWidth || tempRect.size.height + _letterPadding >= CacheTextureHeight))
+            {
+                CCLOG("cocos2d: FontAtlas: the glyph %d is bigger than a page", (int)utf16String[i]);
+                if (fontTTf->getOutlineSize() > 0)
+                {
+                    delete [] bitmap;
+                }
+                bitmap = nullptr;
+            }
             if (bitmap)
             {
                 tempDef.validDefinition = true;
@@ -259,42 +476,25 @@ bool FontAtlas::prepareLetterDefinitions(const std::u16string& utf16String)
                 tempDef.offsetY          = _fontAscender + tempRect.origin.y - offsetAdjust;
                 tempDef.clipBottom     = bottomHeight - (tempDef.height + tempRect.origin.y + offsetAdjust);
 
-                if (_currentPageOrigX + tempDef.width > CacheTextureWidth)
+                // keep one pixel between the glyphs
+                int packedWidth = (int)ceilf(tempDef.width) + 1;
+                int packedHeight = (int)ceilf(tempDef.height) + 1;
+                int x = 0;
+                int y = 0;
+                if (!findPosition(packedWidth, packedHeight, x, y))
                 {
-                    _currentPageOrigY += _commonLineHeight;
-                    _currentPageOrigX = 0;
-                    if(_currentPageOrigY + _commonLineHeight >= CacheTextureHeight)
-                    {     
-                        auto data = _currentPageData + CacheTextureWidth * (int)startY;
-                        _atlasTextures[_currentPage]->updateWithData(data, 0, startY, 
-                            CacheTextureWidth, CacheTextureHeight - startY);
-
-                        startY = 0.0f;
-
-                        _currentPageOrigY = 0;
-                        memset(_currentPageData, 0, _currentPageDataSize);
-                        _currentPage++;
-                        auto tex = new Texture2D;
-                        if (_antialiasEnabled)
-                        {
-                            tex->setAntiAliasTexParameters();
-                        } 
-                        else
-                        {
-                            tex->setAliasTexParameters();
-                        }
-                        tex->initWithData(_currentPageData, _currentPageDataSize, 
-                            pixelFormat, CacheTextureWidth, CacheTextureHeight, Size(CacheTextureWidth,CacheTextureHeight) );
-                        addTexture(tex,_currentPage);
-                        tex->release();
-                    }  
+                    nextPage();
+                    findPosition(packedWidth, packedHeight, x, y);
                 }
-                fontTTf->renderCharAt(_currentPageData,_currentPageOrigX,_currentPageOrigY,bitmap,bitmapWidth,bitmapHeight);
+                addSkylineLevel(x, y, packedWidth, packedHeight);
+                _dirtyTop = MIN(_dirtyTop, y);
+                _dirtyBottom = MAX(_dirtyBottom, MIN(y + packedHeight, CacheTextureHeight));
+
+                fontTTf->renderCharAt(_currentPageData,x,y,bitmap,bitmapWidth,bitmapHeight);
 
-                tempDef.U                = _currentPageOrigX;
-                tempDef.V                = _currentPageOrigY;
+                tempDef.U                = x;
+                tempDef.V                = y;
                 tempDef.textureID        = _currentPage;
-                _currentPageOrigX        += tempDef.width + 1;
                 // take from pixels to points
                 tempDef.width  =    tempDef.width  / scaleFactor;
                 tempDef.height =    tempDef.height / scaleFactor;      
@@ -316,20 +516,28 @@ bool FontAtlas::prepareLetterDefinitions(const std::u16string& utf16String)
                 tempDef.offsetY          = 0;
                 tempDef.textureID        = 0;
                 tempDef.clipBottom = 0;
-                _currentPageOrigX += 1;
             }
 
             _fontLetterDefinitions[tempDef.letteCharUTF16] = tempDef;
+
+            ++_rasterizedGlyphCount;
+            _rasterizationTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
         }       
     }
 
-    if(existNewLetter)
+    uploadCurrentPage();
+    return true;
+}
+
+size_t FontAtlas::getTextureMemory() const
+{
+    size_t bytes = 0;
+    for (const auto& item : _atlasTextures)
     {
-        auto data = _currentPageData + CacheTextureWidth * (int)startY;
-        _atlasTextures[_currentPage]->updateWithData(data, 0, startY, 
-            CacheTextureWidth, _currentPageOrigY - startY + _commonLineHeight);
+        auto tex = item.second;
+        bytes += tex->getPixelsWide() * tex->getPixelsHigh() * tex->getBitsPerPixelForFormat() / 8;
     }
-    return true;
+    return bytes;
 }
 
 void FontAtlas::addTexture(Texture2D *texture, int slot)
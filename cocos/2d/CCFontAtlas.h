@@ -30,6 +30,7 @@
 #include "CCStdC.h"
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 NS_CC_BEGIN
 
@@ -55,12 +56,19 @@ struct FontLetterDefinition
     int clipBottom;
 };
 
+/** Stores the glyphs of a font in textures ("pages").
+ Dynamic TTF glyphs are packed with a skyline bin packer. When a page limit is set with setMaxPageCount(),
+ the atlas already has that many pages and one is full, the least recently used page is evicted and
+ EVENT_PURGE_TEXTURES is dispatched on the next frame so that the labels using it lay out again.
+ */
 class CC_DLL FontAtlas : public Ref
 {
 public:
     static const int CacheTextureWidth;
     static const int CacheTextureHeight;
     static const char* EVENT_PURGE_TEXTURES;
+    /** default value of getMaxPageCount(): 0, the pages are never evicted */
+    static const int DefaultMaxPageCount;
     /**
      * @js ctor
      */
@@ -111,8 +119,46 @@ public:
      */
      void setAliasTexParameters();
 
+    /** Sets how many pages a dynamic TTF atlas can have before it starts evicting the least recently used one.
+     0, the default, means no limit. The labels showing evicted glyphs lay out again, which rasterizes them again.
+     */
+    void setMaxPageCount(int maxPageCount) { _maxPageCount = maxPageCount; }
+    int getMaxPageCount() const { return _maxPageCount; }
+
+    /** Returns the number of glyphs currently stored */
+    ssize_t getGlyphCount() const { return _fontLetterDefinitions.size(); }
+    /** Returns the memory used by the textures, in bytes */
+    size_t getTextureMemory() const;
+    /** Returns the number of glyphs rasterized since the atlas was created */
+    unsigned int getRasterizedGlyphCount() const { return _rasterizedGlyphCount; }
+    /** Returns the total time spent rasterizing glyphs, in seconds */
+    double getRasterizationTime() const { return _rasterizationTime; }
+    /** Returns the number of pages evicted since the atlas was created */
+    unsigned int getEvictedPageCount() const { return _evictedPageCount; }
+    /** Changes each time glyph definitions are removed (eviction or purge): letter definitions and
+     layouts computed with a previous generation must not be used anymore.
+     Generations are unique across all the atlases, so the pair (atlas, generation) never gets reused.
+     */
+    unsigned int getGeneration() const { return _generation; }
+
 private:
 
+    struct SkylineNode
+    {
+        int x;
+        int y;
+        int width;
+    };
+
+    // finds room for a width x height rectangle in the current page, returns false if it is full
+    bool findPosition(int width, int height, int& outX, int& outY);
+    void addSkylineLevel(int x, int y, int width, int height);
+    void resetCurrentPage();
+    // moves to a new page, or to the least recently used one if the atlas has its maximum number of pages
+    void nextPage();
+    void uploadCurrentPage();
+    void dispatchPurgeEvent();
+
     void relaseTextures();
     std::unordered_map<ssize_t, Texture2D*> _atlasTextures;
     std::unordered_map<unsigned short, FontLetterDefinition> _fontLetterDefinitions;
@@ -123,11 +169,25 @@ private:
     int _currentPage;
     unsigned char *_currentPageData;
     int _currentPageDataSize;
-    float _currentPageOrigX;
-    float _currentPageOrigY;
+    std::vector<SkylineNode> _skyline;
+    // rows of the current page that must be uploaded
+    int _dirtyTop;
+    int _dirtyBottom;
     float _letterPadding;
     bool  _makeDistanceMap;
 
+    // LRU eviction of the pages
+    int _maxPageCount;
+    unsigned int _useStamp;
+    std::vector<unsigned int> _pageLastUsed;
+    bool _purgeEventPending;
+
+    // stats
+    unsigned int _rasterizedGlyphCount;
+    double _rasterizationTime;
+    unsigned int _evictedPageCount;
+    unsigned int _generation;
+
     int _fontAscender;
     EventListenerCustom* _toBackgroundListener;
     EventListenerCustom* _toForegroundListener;
@@ -35,6 +35,8 @@
 NS_CC_BEGIN
 
 std::unordered_map<std::string, FontAtlas *> FontAtlasCache::_atlasMap;
+int FontAtlasCache::_maxPageCount = FontAtlas::DefaultMaxPageCount;
+bool FontAtlasCache::_distanceFieldSharingEnabled = false;
 
 void FontAtlasCache::purgeCachedData()
 {
@@ -44,6 +46,61 @@ void FontAtlasCache::purgeCachedData()
     }
 }
 
+void FontAtlasCache::setMaxPageCount(int maxPageCount)
+{
+    _maxPageCount = maxPageCount;
+    for (auto & atlas:_atlasMap)
+    {
+        atlas.second->setMaxPageCount(maxPageCount);
+    }
+}
+
+size_t FontAtlasCache::getTotalTextureMemory()
+{
+    size_t bytes = 0;
+    for (auto & atlas:_atlasMap)
+    {
+        bytes += atlas.second->getTextureMemory();
+    }
+    return bytes;
+}
+
+std::string FontAtlasCache::getCachedAtlasInfo()
+{
+    std::string buffer;
+    char buftmp[4096];
+
+    size_t totalBytes = 0;
+    unsigned int totalGlyphs = 0;
+    double totalTime = 0;
+
+    for (auto & item:_atlasMap)
+    {
+        FontAtlas* atlas = item.second;
+        size_t bytes = atlas->getTextureMemory();
+        totalBytes += bytes;
+        totalGlyphs += atlas->getRasterizedGlyphCount();
+        totalTime += atlas->getRasterizationTime();
+
+        snprintf(buftmp, sizeof(buftmp)-1, "\"%s\" rc=%u glyphs=%ld pages=%lu => %lu KB, evicted pages=%u, rasterized %u glyphs in %.2f ms\n",
+                 item.first.c_str(),
+                 atlas->getReferenceCount(),
+                 (long)atlas->getGlyphCount(),
+                 (unsigned long)atlas->getTextures().size(),
+                 (unsigned long)(bytes / 1024),
+                 atlas->getEvictedPageCount(),
+                 atlas->getRasterizedGlyphCount(),
+                 atlas->getRasterizationTime() * 1000);
+        buffer += buftmp;
+    }
+
+    snprintf(buftmp, sizeof(buftmp)-1, "FontAtlasCache dumpDebugInfo: %lu atlases, for %lu KB (%.2f MB), rasterized %u glyphs in %.2f ms\n",
+             (unsigned long)_atlasMap.size(), (unsigned long)(totalBytes / 1024), totalBytes / (1024.0f*1024.0f), totalGlyphs, totalTime * 1000);
+    buffer += buftmp;
+
+    return buffer;
+}
+
 FontAtlas * FontAtlasCache::getFontAtlasTTF(const TTFConfig & config)
 {  
     bool useDistanceField = config.distanceFieldEnabled;
@@ -76,6 +133,7 @@ FontAtlas * FontAtlasCache::getFontAtlasTTF(const TTFConfig & config)
             auto tempAtlas = font->createFontAtlas();
             if (tempAtlas)
             {
+                tempAtlas->setMaxPageCount(_maxPageCount);
                 _atlasMap[atlasName] = tempAtlas;
                 return _atlasMap[atlasName];
             }
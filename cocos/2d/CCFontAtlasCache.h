@@ -50,10 +50,31 @@ public:
      It will purge the textures atlas and if multiple texture exist in one FontAtlas.
      */
     static void purgeCachedData();
+
+    /** Sets the maximum number of pages of the dynamic TTF atlases, existing and future ones.
+     @see FontAtlas::setMaxPageCount
+     */
+    static void setMaxPageCount(int maxPageCount);
+    static int getMaxPageCount() { return _maxPageCount; }
+
+    /** When enabled, TTF labels without outline are rendered with distance fields, so every size
+     of a font face shares the glyphs and the pages of a single atlas. Disabled by default.
+     It applies to the labels created or configured after the call; their getTTFConfig() is left as it was set.
+     */
+    static void setDistanceFieldSharingEnabled(bool enabled) { _distanceFieldSharingEnabled = enabled; }
+    static bool isDistanceFieldSharingEnabled() { return _distanceFieldSharingEnabled; }
+
+    /** Returns the memory used by the textures of all the atlases, in bytes */
+    static size_t getTotalTextureMemory();
+
+    /** Returns a description of the cached atlases: glyphs, pages, texture memory, evictions and rasterization time */
+    static std::string getCachedAtlasInfo();
     
 private: 
     static std::string generateFontName(const std::string& fontFileName, int size, GlyphCollection theGlyphs, bool useDistanceField);
     static std::unordered_map<std::string, FontAtlas *> _atlasMap;
+    static int _maxPageCount;
+    static bool _distanceFieldSharingEnabled;
 };
 
 NS_CC_END
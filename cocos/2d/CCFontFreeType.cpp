@@ -46,6 +46,8 @@ typedef struct _DataRef
 }DataRef;
 
 static std::unordered_map<std::string, DataRef> s_cacheFontData;
+// the data of the fonts read ahead, until they are created
+static std::unordered_map<std::string, Data> s_preloadedFontData;
 
 FontFreeType * FontFreeType::create(const std::string &fontName, int fontSize, GlyphCollection glyphs, const char *customGlyphs,bool distanceFieldEnabled /* = false */,int outline /* = 0 */)
 {
@@ -87,6 +89,15 @@ void FontFreeType::shutdownFreeType()
     }
 }
 
+void FontFreeType::addPreloadedFontData(const std::string& fontName, Data&& data)
+{
+    // the fonts in use already have their data
+    if (s_cacheFontData.find(fontName) == s_cacheFontData.end())
+    {
+        s_preloadedFontData[fontName] = std::move(data);
+    }
+}
+
 FT_Library FontFreeType::getFTLibrary()
 {
     initFreeType();
@@ -124,7 +135,16 @@ bool FontFreeType::createFontObject(const std::string &fontName, int fontSize)
     else
     {
         s_cacheFontData[fontName].referenceCount = 1;
-        s_cacheFontData[fontName].data = FileUtils::getInstance()->getDataFromFile(fontName);    
+        auto preloaded = s_preloadedFontData.find(fontName);
+        if (preloaded != s_preloadedFontData.end())
+        {
+            s_cacheFontData[fontName].data = std::move(preloaded->second);
+            s_preloadedFontData.erase(preloaded);
+        }
+        else
+        {
+            s_cacheFontData[fontName].data = FileUtils::getInstance()->getDataFromFile(fontName);
+        }
 
         if (s_cacheFontData[fontName].data.isNull())
         {
@@ -205,7 +225,17 @@ int * FontFreeType::getHorizontalKerningForTextUTF16(const std::u16string& text,
     {
         for (int c = 1; c < outNumLetters; ++c)
         {
-            sizes[c] = getHorizontalKerningForChars(text[c-1], text[c]);
+            unsigned int pair = (static_cast<unsigned int>(text[c-1]) << 16) | text[c];
+            auto it = _kerningCache.find(pair);
+            if (it != _kerningCache.end())
+            {
+                sizes[c] = it->second;
+            }
+            else
+            {
+                sizes[c] = getHorizontalKerningForChars(text[c-1], text[c]);
+                _kerningCache[pair] = sizes[c];
+            }
         }
     }
     
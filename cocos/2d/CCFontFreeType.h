@@ -30,6 +30,7 @@
 #include "base/CCData.h"
 
 #include <string>
+#include <unordered_map>
 #include <ft2build.h>
 
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WP8) || (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
@@ -57,6 +58,11 @@ public:
 
     static void shutdownFreeType();
 
+    /** Gives the content of a font file read ahead, e.g. by ResourceLoader on a loading thread:
+     * the next font created with fontName uses it instead of reading the file.
+     */
+    static void addPreloadedFontData(const std::string& fontName, Data&& data);
+
     bool     isDistanceFieldEnabled() const { return _distanceFieldEnabled;}
     int      getOutlineSize() const { return _outlineSize; }
     void     renderCharAt(unsigned char *dest,int posX, int posY, unsigned char* bitmap,long bitmapWidth,long bitmapHeight); 
@@ -90,6 +96,8 @@ private:
     std::string       _fontName;
     bool              _distanceFieldEnabled;
     int               _outlineSize;
+    // kerning of the pairs already looked up, keyed by (firstChar << 16) | secondChar
+    mutable std::unordered_map<unsigned int, int> _kerningCache;
 };
 
 NS_CC_END
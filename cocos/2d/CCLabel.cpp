@@ -42,10 +42,18 @@
 
 #include "deprecated/CCString.h"
 
+#include <algorithm>
+
 NS_CC_BEGIN
 
 const int Label::DistanceFieldFontSize = 50;
 
+// finished layouts of short strings, shared by all the labels
+static const size_t LayoutCacheMaxEntries = 64;
+static const size_t LayoutCacheMaxLength = 128;
+std::unordered_map<std::u16string, Label::LayoutCacheEntry> Label::_layoutCache;
+unsigned int Label::_layoutCacheStamp = 0;
+
 Label* Label::create()
 {
     auto ret = new Label();
@@ -238,29 +246,34 @@ bool Label::setCharMap(const std::string& charMapFile, int itemWidth, int itemHe
 
 Label::Label(FontAtlas *atlas /* = nullptr */, TextHAlignment hAlignment /* = TextHAlignment::LEFT */, 
              TextVAlignment vAlignment /* = TextVAlignment::TOP */,bool useDistanceField /* = false */,bool useA8Shader /* = false */)
-: _reusedLetter(nullptr)
+: _isOpacityModifyRGB(false)
+, _contentDirty(false)
+, _fontAtlas(atlas)
+, _textSprite(nullptr)
+, _compatibleMode(false)
+, _reusedLetter(nullptr)
 , _commonLineHeight(0.0f)
 , _lineBreakWithoutSpaces(false)
+, _horizontalKernings(nullptr)
+, _horizontalKerningsCapacity(0)
 , _maxLineWidth(0)
+, _labelDimensions(Size::ZERO)
 , _labelWidth(0)
 , _labelHeight(0)
-, _labelDimensions(Size::ZERO)
 , _hAlignment(hAlignment)
 , _vAlignment(vAlignment)
-, _horizontalKernings(nullptr)
-, _fontAtlas(atlas)
-, _isOpacityModifyRGB(false)
+, _currNumLines(-1)
+, _incrementalStart(0)
+, _lastPenPositionX(0)
+, _layoutNumLines(0)
+, _layoutParams()
+, _fontScale(1.0f)
 , _useDistanceField(useDistanceField)
 , _useA8Shader(useA8Shader)
-, _fontScale(1.0f)
+, _effectColorF(Color4F::BLACK)
 , _uniformEffectColor(0)
-, _currNumLines(-1)
-, _textSprite(nullptr)
-, _contentDirty(false)
 , _shadowDirty(false)
-, _compatibleMode(false)
 , _insideBounds(true)
-, _effectColorF(Color4F::BLACK)
 {
     setAnchorPoint(Vec2::ANCHOR_MIDDLE);
     reset();
@@ -322,6 +335,7 @@ void Label::reset()
     Node::removeAllChildrenWithCleanup(true);
     _textSprite = nullptr;
     _shadowNode = nullptr;
+    _incrementalStart = 0;
 
     CC_SAFE_RELEASE_NULL(_reusedLetter);
 
@@ -418,8 +432,16 @@ void Label::setFontAtlas(FontAtlas* atlas,bool distanceFieldEnabled /* = false *
     }
 }
 
-bool Label::setTTFConfig(const TTFConfig& ttfConfig)
+bool Label::setTTFConfig(const TTFConfig& config)
 {
+    // with distance fields, every size of the face shares the same atlas. Only the atlas and the
+    // rendering use them, _fontConfig keeps the configuration as it was set.
+    TTFConfig ttfConfig = config;
+    if (ttfConfig.outlineSize <= 0 && FontAtlasCache::isDistanceFieldSharingEnabled())
+    {
+        ttfConfig.distanceFieldEnabled = true;
+    }
+
     FontAtlas *newAtlas = FontAtlasCache::getFontAtlasTTF(ttfConfig);
 
     if (!newAtlas)
@@ -432,7 +454,7 @@ bool Label::setTTFConfig(const TTFConfig& ttfConfig)
     _currentLabelType = LabelType::TTF;
     setFontAtlas(newAtlas,ttfConfig.distanceFieldEnabled,true);
 
-    _fontConfig = ttfConfig;
+    _fontConfig = config;
     if (_fontConfig.outlineSize > 0)
     {
         _fontConfig.distanceFieldEnabled = false;
@@ -480,7 +502,17 @@ void Label::setString(const std::string& text)
         std::u16string utf16String;
         if (StringUtils::UTF8ToUTF16(_originalUTF8String, utf16String))
         {
-            _currentUTF16String  = utf16String;
+            // the letters before the first changed one keep their layout
+            size_t commonLength = std::min(utf16String.length(), _originalUTF16String.length());
+            size_t prefix = 0;
+            while (prefix < commonLength && utf16String[prefix] == _originalUTF16String[prefix])
+            {
+                ++prefix;
+            }
+            _incrementalStart = std::min(_incrementalStart, static_cast<int>(prefix));
+
+            _originalUTF16String.swap(utf16String);
+            _currentUTF16String = _originalUTF16String;
         }
     }
 }
@@ -586,10 +618,6 @@ void Label::alignText()
         return;
     }
 
-    for (const auto& batchNode:_batchNodes)
-    {
-        batchNode->getTextureAtlas()->removeAllQuads();
-    }
     _fontAtlas->prepareLetterDefinitions(_currentUTF16String);
     auto textures = _fontAtlas->getTextures();
     if (textures.size() > _batchNodes.size())
@@ -603,14 +631,71 @@ void Label::alignText()
             _batchNodes.push_back(batchNode);
         }
     }
-    LabelTextFormatter::createStringSprites(this);    
-    if(_maxLineWidth > 0 && _contentSize.width > _maxLineWidth && LabelTextFormatter::multilineText(this) )      
-        LabelTextFormatter::createStringSprites(this);
-
-    if(_labelWidth > 0 || (_currNumLines > 1 && _hAlignment != TextHAlignment::LEFT))
-        LabelTextFormatter::alignText(this);
 
+    // the atlas generation is read after preparing the letters, which may evict a page
+    auto params = getLayoutParams();
     int strLen = static_cast<int>(_currentUTF16String.length());
+
+    // single line texts without wrapping only need the letters after the first changed one
+    int startIndex = 0;
+    if (_incrementalStart > 0 && _incrementalStart < strLen && params == _layoutParams
+        && _layoutNumLines == 1 && _currNumLines == 1
+        && params.maxLineWidth == 0 && params.labelWidth == 0 && params.labelHeight == 0 && !params.clipEnabled)
+    {
+        startIndex = _incrementalStart;
+    }
+
+    if (startIndex > 0)
+    {
+        // the quads are inserted in letters order, the ones of the kept letters are at the front of each atlas
+        std::vector<ssize_t> keptQuads(_batchNodes.size(), 0);
+        for (int ctr = 0; ctr < startIndex; ++ctr)
+        {
+            if (_lettersInfo[ctr].def.validDefinition)
+            {
+                ++keptQuads[_lettersInfo[ctr].def.textureID];
+            }
+        }
+        for (size_t index = 0; index < _batchNodes.size(); ++index)
+        {
+            auto textureAtlas = _batchNodes[index]->getTextureAtlas();
+            auto totalQuads = textureAtlas->getTotalQuads();
+            if (totalQuads > keptQuads[index])
+            {
+                textureAtlas->removeQuadsAtIndex(keptQuads[index], totalQuads - keptQuads[index]);
+            }
+        }
+
+        computeHorizontalKernings(_currentUTF16String, startIndex);
+        LabelTextFormatter::createStringSprites(this, startIndex);
+    }
+    else
+    {
+        for (const auto& batchNode:_batchNodes)
+        {
+            batchNode->getTextureAtlas()->removeAllQuads();
+        }
+
+        if (!restoreCachedLayout(params))
+        {
+            auto originalString = _currentUTF16String;
+
+            computeHorizontalKernings(_currentUTF16String);
+            LabelTextFormatter::createStringSprites(this);
+            if(_maxLineWidth > 0 && _contentSize.width > _maxLineWidth && LabelTextFormatter::multilineText(this) )
+                LabelTextFormatter::createStringSprites(this);
+
+            if(_labelWidth > 0 || (_currNumLines > 1 && _hAlignment != TextHAlignment::LEFT))
+                LabelTextFormatter::alignText(this);
+
+            if (originalString.length() <= LayoutCacheMaxLength)
+            {
+                storeCachedLayout(params, originalString);
+            }
+        }
+        strLen = static_cast<int>(_currentUTF16String.length());
+    }
+
     Rect uvRect;
     Sprite* letterSprite;
     for(const auto &child : _children) {
@@ -619,7 +704,7 @@ void Label::alignText()
         {
             SpriteBatchNode::removeChild(child, true);
         }
-        else if(tag >= 0)
+        else if(tag >= startIndex)
         {
             letterSprite = dynamic_cast<Sprite*>(child);
             if (letterSprite)
@@ -635,32 +720,138 @@ void Label::alignText()
         }
     }
 
-    updateQuads();
+    updateQuads(startIndex);
 
     updateColor();
+
+    _layoutParams = params;
+    _layoutNumLines = _currNumLines;
+    _incrementalStart = strLen;
+}
+
+bool Label::LayoutParams::operator==(const LayoutParams& other) const
+{
+    return atlas == other.atlas && atlasGeneration == other.atlasGeneration
+        && maxLineWidth == other.maxLineWidth && labelWidth == other.labelWidth && labelHeight == other.labelHeight
+        && hAlignment == other.hAlignment && vAlignment == other.vAlignment
+        && lineBreakWithoutSpaces == other.lineBreakWithoutSpaces && clipEnabled == other.clipEnabled
+        && commonLineHeight == other.commonLineHeight && scaleX == other.scaleX
+        && contentScaleFactor == other.contentScaleFactor;
+}
+
+Label::LayoutParams Label::getLayoutParams() const
+{
+    LayoutParams params;
+    params.atlas = _fontAtlas;
+    params.atlasGeneration = _fontAtlas ? _fontAtlas->getGeneration() : 0;
+    params.maxLineWidth = _maxLineWidth;
+    params.labelWidth = _labelWidth;
+    params.labelHeight = _labelHeight;
+    params.hAlignment = _hAlignment;
+    params.vAlignment = _vAlignment;
+    params.lineBreakWithoutSpaces = _lineBreakWithoutSpaces;
+    params.clipEnabled = _currentLabelType == LabelType::TTF && _clipEnabled;
+    params.commonLineHeight = _commonLineHeight;
+    params.scaleX = getScaleX();
+    params.contentScaleFactor = CC_CONTENT_SCALE_FACTOR();
+    return params;
+}
+
+bool Label::restoreCachedLayout(const LayoutParams& params)
+{
+    auto iter = _layoutCache.find(_currentUTF16String);
+    if (iter == _layoutCache.end() || !(iter->second.params == params))
+    {
+        return false;
+    }
+
+    auto& entry = iter->second;
+    entry.lastUsed = ++_layoutCacheStamp;
+    _currentUTF16String = entry.formattedString;
+    if (_lettersInfo.size() < entry.lettersInfo.size())
+    {
+        _lettersInfo.resize(entry.lettersInfo.size());
+    }
+    std::copy(entry.lettersInfo.begin(), entry.lettersInfo.end(), _lettersInfo.begin());
+    _limitShowCount = entry.limitShowCount;
+    _currNumLines = entry.numLines;
+    _lastPenPositionX = entry.lastPenPositionX;
+    setContentSize(entry.contentSize);
+
+    return true;
+}
+
+void Label::storeCachedLayout(const LayoutParams& params, const std::u16string& originalString)
+{
+    if (_layoutCache.size() >= LayoutCacheMaxEntries && _layoutCache.find(originalString) == _layoutCache.end())
+    {
+        auto leastUsed = _layoutCache.begin();
+        for (auto iter = _layoutCache.begin(); iter != _layoutCache.end(); ++iter)
+        {
+            if (iter->second.lastUsed < leastUsed->second.lastUsed)
+            {
+                leastUsed = iter;
+            }
+        }
+        _layoutCache.erase(leastUsed);
+    }
+
+    auto& entry = _layoutCache[originalString];
+    entry.params = params;
+    entry.formattedString = _currentUTF16String;
+    entry.lettersInfo.assign(_lettersInfo.begin(), _lettersInfo.begin() + _limitShowCount);
+    entry.limitShowCount = _limitShowCount;
+    entry.numLines = _currNumLines;
+    entry.lastPenPositionX = _lastPenPositionX;
+    entry.contentSize = _contentSize;
+    entry.lastUsed = ++_layoutCacheStamp;
 }
 
-bool Label::computeHorizontalKernings(const std::u16string& stringToRender)
+bool Label::computeHorizontalKernings(const std::u16string& stringToRender, int startIndex /* = 0 */)
 {
+    int letterCount = 0;
+    int stringLength = static_cast<int>(stringToRender.length());
+    if (startIndex > 0 && startIndex < stringLength && _horizontalKernings)
+    {
+        // from the letter before startIndex, the kerning of the first letter of a text is always 0
+        int* kernings = _fontAtlas->getFont()->getHorizontalKerningForTextUTF16(stringToRender.substr(startIndex - 1), letterCount);
+        if (kernings)
+        {
+            if (_horizontalKerningsCapacity < stringLength)
+            {
+                int capacity = std::max(stringLength, 2 * _horizontalKerningsCapacity);
+                int* grown = new int[capacity]();
+                memcpy(grown, _horizontalKernings, std::min(startIndex, _horizontalKerningsCapacity) * sizeof(int));
+                delete [] _horizontalKernings;
+                _horizontalKernings = grown;
+                _horizontalKerningsCapacity = capacity;
+            }
+            memcpy(_horizontalKernings + startIndex, kernings + 1, (letterCount - 1) * sizeof(int));
+            delete [] kernings;
+            return true;
+        }
+    }
+
     if (_horizontalKernings)
     {
         delete [] _horizontalKernings;
         _horizontalKernings = nullptr;
+        _horizontalKerningsCapacity = 0;
     }
 
-    int letterCount = 0;
     _horizontalKernings = _fontAtlas->getFont()->getHorizontalKerningForTextUTF16(stringToRender, letterCount);
 
     if(!_horizontalKernings)
         return false;
-    else
-        return true;
+
+    _horizontalKerningsCapacity = letterCount;
+    return true;
 }
 
-void Label::updateQuads()
+void Label::updateQuads(int startIndex /* = 0 */)
 {
     int index;
-    for (int ctr = 0; ctr < _limitShowCount; ++ctr)
+    for (int ctr = startIndex; ctr < _limitShowCount; ++ctr)
     {
         auto &letterDef = _lettersInfo[ctr].def;
 
@@ -883,8 +1074,7 @@ void Label::draw(Renderer *renderer, const Mat4 &transform, bool transformUpdate
     _insideBounds = transformUpdated ? renderer->checkVisibility(transform, _contentSize) : _insideBounds;
 
     if(_insideBounds) {
-        _customCommand.init(_globalZOrder);
-        _customCommand.func = CC_CALLBACK_0(Label::onDraw, this, transform, transformUpdated);
+        _customCommand.init(_globalZOrder, renderer->getFrameArena(), CC_CALLBACK_0(Label::onDraw, this, transform, transformUpdated));
         renderer->addCommand(&_customCommand);
     }
 }
@@ -931,17 +1121,10 @@ void Label::setFontDefinition(const FontDefinition& textDefinition)
 
 void Label::updateContent()
 {
-    std::u16string utf16String;
-    if (StringUtils::UTF8ToUTF16(_originalUTF8String, utf16String))
-    {
-        _currentUTF16String  = utf16String;
-    }
+    // multilineText() may have inserted line breaks in the previous layout
+    _currentUTF16String = _originalUTF16String;
 
     computeStringNumLines();
-    if (_fontAtlas)
-    {
-        computeHorizontalKernings(_currentUTF16String);
-    }
 
     if (_textSprite)
     {
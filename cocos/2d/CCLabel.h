@@ -32,6 +32,8 @@
 #include "renderer/CCCustomCommand.h"
 #include "2d/CCFontAtlas.h"
 
+#include <unordered_map>
+
 NS_CC_BEGIN
 
 enum class GlyphCollection {
@@ -257,7 +259,42 @@ protected:
         Vec2 position;
         Size  contentSize;
         int   atlasIndex;
+        int   penPositionX;     /// pen position before the letter, in pixels
     };
+
+    /** Everything besides the text that affects the layout of the letters */
+    struct LayoutParams
+    {
+        FontAtlas* atlas;
+        unsigned int atlasGeneration;
+        unsigned int maxLineWidth;
+        unsigned int labelWidth;
+        unsigned int labelHeight;
+        TextHAlignment hAlignment;
+        TextVAlignment vAlignment;
+        bool lineBreakWithoutSpaces;
+        bool clipEnabled;
+        float commonLineHeight;
+        float scaleX;
+        float contentScaleFactor;
+
+        bool operator==(const LayoutParams& other) const;
+    };
+
+    /** A finished layout, shared by all the labels which show the same text with the same params */
+    struct LayoutCacheEntry
+    {
+        LayoutParams params;
+        std::u16string formattedString;
+        std::vector<LetterInfo> lettersInfo;
+        int limitShowCount;
+        int numLines;
+        int lastPenPositionX;
+        Size contentSize;
+        // the least recently used entry is evicted when the cache is full
+        unsigned int lastUsed;
+    };
+
     enum class LabelType {
 
         TTF,
@@ -286,11 +323,16 @@ protected:
     
     virtual void alignText();
     
-    bool computeHorizontalKernings(const std::u16string& stringToRender);
+    /** Computes the kernings of the letters from startIndex on, the ones before it are kept */
+    bool computeHorizontalKernings(const std::u16string& stringToRender, int startIndex = 0);
 
     void computeStringNumLines();
 
-    void updateQuads();
+    void updateQuads(int startIndex = 0);
+
+    LayoutParams getLayoutParams() const;
+    bool restoreCachedLayout(const LayoutParams& params);
+    void storeCachedLayout(const LayoutParams& params, const std::u16string& originalString);
 
     virtual void updateColor() override;
 
@@ -334,6 +376,7 @@ protected:
     float _commonLineHeight;
     bool  _lineBreakWithoutSpaces;
     int * _horizontalKernings;
+    int _horizontalKerningsCapacity;
 
     unsigned int _maxLineWidth;
     Size         _labelDimensions;
@@ -345,6 +388,15 @@ protected:
     int           _currNumLines;
     std::u16string _currentUTF16String;
     std::string          _originalUTF8String;
+    std::u16string _originalUTF16String;
+
+    //! incremental layout: letters before _incrementalStart still have the layout computed with _layoutParams
+    int _incrementalStart;
+    int _lastPenPositionX;
+    int _layoutNumLines;
+    LayoutParams _layoutParams;
+    static std::unordered_map<std::u16string, LayoutCacheEntry> _layoutCache;
+    static unsigned int _layoutCacheStamp;
 
     float _fontScale;
 
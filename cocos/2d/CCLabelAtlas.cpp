@@ -253,8 +253,7 @@ void LabelAtlas::draw(Renderer *renderer, const Mat4 &transform, bool transformU
 {
     AtlasNode::draw(renderer, transform, transformUpdated);
 
-    _customDebugDrawCommand.init(_globalZOrder);
-    _customDebugDrawCommand.func = CC_CALLBACK_0(LabelAtlas::drawDebugData, this,transform,transformUpdated);
+    _customDebugDrawCommand.init(_globalZOrder, renderer->getFrameArena(), CC_CALLBACK_0(LabelAtlas::drawDebugData, this,transform,transformUpdated));
     renderer->addCommand(&_customDebugDrawCommand);
 }
 
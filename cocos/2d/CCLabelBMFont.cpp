@@ -211,8 +211,7 @@ void LabelBMFont::draw(Renderer *renderer, const Mat4 &transform, bool transform
 {
     Node::draw(renderer, transform, transformUpdated);
 
-    _customDebugDrawCommand.init(_globalZOrder);
-    _customDebugDrawCommand.func = CC_CALLBACK_0(LabelBMFont::drawDebugData, this,transform,transformUpdated);
+    _customDebugDrawCommand.init(_globalZOrder, renderer->getFrameArena(), CC_CALLBACK_0(LabelBMFont::drawDebugData, this,transform,transformUpdated));
     renderer->addCommand(&_customDebugDrawCommand);
 }
 
@@ -24,6 +24,7 @@
  ****************************************************************************/
 
 #include <vector>
+#include <algorithm>
 
 #include "ccUTF8.h"
 #include "CCLabelTextFormatter.h"
@@ -262,10 +263,11 @@ bool LabelTextFormatter::alignText(Label *theLabel)
     return true;
 }
 
-bool LabelTextFormatter::createStringSprites(Label *theLabel)
+bool LabelTextFormatter::createStringSprites(Label *theLabel, int startIndex /* = 0 */)
 {
     // check for string
     unsigned int stringLen = theLabel->getStringLength();
+    int previousShowCount = theLabel->_limitShowCount;
     theLabel->_limitShowCount = 0;
 
     // no string
@@ -322,8 +324,21 @@ bool LabelTextFormatter::createStringSprites(Label *theLabel)
     {
         clip = true;
     }
+
+    if (startIndex > 0)
+    {
+        // resume the line after the kept letters
+        auto& lettersInfo = theLabel->_lettersInfo;
+        nextFontPositionX = startIndex < previousShowCount ? lettersInfo[startIndex].penPositionX : theLabel->_lastPenPositionX;
+        for (int i = 1; i < startIndex; i++)
+        {
+            longestLine = std::max(longestLine, lettersInfo[i].penPositionX);
+        }
+        longestLine = std::max(longestLine, nextFontPositionX);
+        theLabel->_limitShowCount = startIndex;
+    }
     
-    for (unsigned int i = 0; i < stringLen; i++)
+    for (unsigned int i = startIndex; i < stringLen; i++)
     {
         char16_t c    = strWhole[i];
         if (fontAtlas->getLetterDefinitionForChar(c, tempDefinition))
@@ -341,11 +356,14 @@ bool LabelTextFormatter::createStringSprites(Label *theLabel)
 
         if (c == '\n')
         {
+            // every letter keeps its pen position, a layout may resume at any of them
+            theLabel->recordPlaceholderInfo(i);
+            theLabel->_lettersInfo[i].penPositionX = nextFontPositionX;
+
             lineIndex++;
             nextFontPositionX  = 0;
             nextFontPositionY -= theLabel->_commonLineHeight;
             
-            theLabel->recordPlaceholderInfo(i);
             if(nextFontPositionY < theLabel->_commonLineHeight)
                 break;
 
@@ -377,7 +395,9 @@ bool LabelTextFormatter::createStringSprites(Label *theLabel)
         letterPosition.x = (nextFontPositionX + charXOffset + kernings[i]) / contentScaleFactor;
         letterPosition.y = (nextFontPositionY - charYOffset) / contentScaleFactor;
                
-        if( theLabel->recordLetterInfo(letterPosition,tempDefinition,i) == false)
+        bool validLetter = theLabel->recordLetterInfo(letterPosition,tempDefinition,i);
+        theLabel->_lettersInfo[i].penPositionX = nextFontPositionX;
+        if (validLetter == false)
         {
             log("WARNING: can't find letter definition in font file for letter: %c", c);
             continue;
@@ -391,6 +411,8 @@ bool LabelTextFormatter::createStringSprites(Label *theLabel)
         }
     }
     
+    theLabel->_lastPenPositionX = nextFontPositionX;
+
     float lastCharWidth = tempDefinition.width * contentScaleFactor;
     Size tmpSize;
     // If the last character processed has an xAdvance which is less that the width of the characters image, then we need
@@ -36,7 +36,10 @@ public:
     
     static bool multilineText(Label *theLabel);
     static bool alignText(Label *theLabel);
-    static bool createStringSprites(Label *theLabel);
+    /** Lays out the letters of the label. When startIndex is not 0, the letters before it keep the layout
+     of the previous call, which must have been a single line one.
+     */
+    static bool createStringSprites(Label *theLabel, int startIndex = 0);
 
 };
 
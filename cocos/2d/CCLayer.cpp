@@ -586,8 +586,7 @@ void LayerColor::updateColor()
 
 void LayerColor::draw(Renderer *renderer, const Mat4 &transform, bool transformUpdated)
 {
-    _customCommand.init(_globalZOrder);
-    _customCommand.func = CC_CALLBACK_0(LayerColor::onDraw, this, transform, transformUpdated);
+    _customCommand.init(_globalZOrder, renderer->getFrameArena(), CC_CALLBACK_0(LayerColor::onDraw, this, transform, transformUpdated));
     renderer->addCommand(&_customCommand);
     
     for(int i = 0; i < 4; ++i)
@@ -407,8 +407,7 @@ void MotionStreak::draw(Renderer *renderer, const Mat4 &transform, bool transfor
 {
     if(_nuPoints <= 1)
         return;
-    _customCommand.init(_globalZOrder);
-    _customCommand.func = CC_CALLBACK_0(MotionStreak::onDraw, this, transform, transformUpdated);
+    _customCommand.init(_globalZOrder, renderer->getFrameArena(), CC_CALLBACK_0(MotionStreak::onDraw, this, transform, transformUpdated));
     renderer->addCommand(&_customCommand);
 }
 
@@ -45,6 +45,7 @@ THE SOFTWARE.
 #include "2d/CCComponentContainer.h"
 #include "renderer/CCGLProgram.h"
 #include "renderer/CCGLProgramState.h"
+#include "renderer/CCRenderer.h"
 #include "math/TransformUtils.h"
 
 #include "deprecated/CCString.h"
@@ -72,55 +73,103 @@ bool nodeComparisonLess(Node* n1, Node* n2)
 // XXX: Yes, nodes might have a sort problem once every 15 days if the game runs at 60 FPS and each frame sprites are reordered.
 int Node::s_globalOrderOfArrival = 1;
 
+#if CC_ENABLE_NODE_SLAB_ALLOCATOR
+SlabAllocator* Node::getAllocator()
+{
+    // never destroyed, the nodes can outlive the static objects
+    static SlabAllocator* allocator = new SlabAllocator();
+    return allocator;
+}
+
+void* Node::operator new(size_t size)
+{
+    // the core is built without exceptions, running out of memory is fatal like with the other allocations
+    void* ptr = getAllocator()->allocate(size);
+    CCASSERT(ptr != nullptr, "Node: out of memory");
+    return ptr;
+}
+
+void* Node::operator new(size_t size, const std::nothrow_t&)
+{
+    return getAllocator()->allocate(size);
+}
+
+void Node::operator delete(void* ptr, size_t size)
+{
+    // the destructor is virtual, size is the one of the most derived class
+    getAllocator()->deallocate(ptr, size);
+}
+#endif
+
+Node::ExtraData::ExtraData()
+: inverse(Mat4::IDENTITY)
+, additionalTransform(Mat4::IDENTITY)
+, userData(nullptr)
+, userObject(nullptr)
+#if CC_ENABLE_SCRIPT_BINDING
+, updateScriptHandler(0)
+#endif
+, componentContainer(nullptr)
+#if CC_USE_PHYSICS
+, physicsBody(nullptr)
+#endif
+{
+}
+
+Node::ExtraData* Node::getExtraData() const
+{
+    if (_extraData == nullptr)
+    {
+        _extraData = new ExtraData();
+    }
+    return _extraData;
+}
+
 Node::Node(void)
-: _rotationX(0.0f)
+: _transform(Mat4::IDENTITY)
+, _position(Vec2::ZERO)
+, _positionZ(0.0f)
+, _rotationX(0.0f)
 , _rotationY(0.0f)
 , _rotationZ_X(0.0f)
 , _rotationZ_Y(0.0f)
 , _scaleX(1.0f)
 , _scaleY(1.0f)
 , _scaleZ(1.0f)
-, _positionZ(0.0f)
-, _position(Vec2::ZERO)
 , _skewX(0.0f)
 , _skewY(0.0f)
 , _anchorPointInPoints(Vec2::ZERO)
 , _anchorPoint(Vec2::ZERO)
 , _contentSize(Size::ZERO)
-, _useAdditionalTransform(false)
-, _transformDirty(true)
-, _inverseDirty(true)
-, _transformUpdated(true)
-// children (lazy allocs)
-// lazy alloc
 , _localZOrder(0)
 , _globalZOrder(0)
-, _parent(nullptr)
-// "whole screen" objects. like Scenes and Layers, should set _ignoreAnchorPointForPosition to true
-, _tag(Node::INVALID_TAG)
-// userData is always inited as nil
-, _userData(nullptr)
-, _userObject(nullptr)
-, _glProgramState(nullptr)
 , _orderOfArrival(0)
-, _running(false)
+, _parent(nullptr)
+// children (lazy allocs)
+, _subtreeBoundingBox(Rect::ZERO)
+, _subtreeNodeCount(1)
+, _transformDirty(true)
+, _inverseDirty(true)
+, _useAdditionalTransform(false)
+, _transformUpdated(true)
 , _visible(true)
-, _ignoreAnchorPointForPosition(false)
+, _running(false)
 , _reorderChildDirty(false)
 , _isTransitionFinished(false)
-#if CC_ENABLE_SCRIPT_BINDING
-, _updateScriptHandler(0)
-#endif
-, _componentContainer(nullptr)
-#if CC_USE_PHYSICS
-, _physicsBody(nullptr)
-#endif
+// "whole screen" objects. like Scenes and Layers, should set _ignoreAnchorPointForPosition to true
+, _ignoreAnchorPointForPosition(false)
+, _cascadeColorEnabled(false)
+, _cascadeOpacityEnabled(false)
+, _subtreeBoundingBoxDirty(true)
+, _subtreeCullingEnabled(false)
 , _displayedOpacity(255)
 , _realOpacity(255)
 , _displayedColor(Color3B::WHITE)
 , _realColor(Color3B::WHITE)
-, _cascadeColorEnabled(false)
-, _cascadeOpacityEnabled(false)
+, _tag(Node::INVALID_TAG)
+, _glProgramState(nullptr)
+// userData, components and physics body live in the lazily allocated extra data
+, _extraData(nullptr)
 {
     // set default scheduler and actionManager
     Director *director = Director::getInstance();
@@ -135,7 +184,6 @@ Node::Node(void)
     ScriptEngineProtocol* engine = ScriptEngineManager::getInstance()->getScriptEngine();
     _scriptType = engine != nullptr ? engine->getScriptType() : kScriptTypeNone;
 #endif
-    _transform = _inverse = _additionalTransform = Mat4::IDENTITY;
 }
 
 Node::~Node()
@@ -143,15 +191,18 @@ Node::~Node()
     CCLOGINFO( "deallocing Node: %p - tag: %i", this, _tag );
     
 #if CC_ENABLE_SCRIPT_BINDING
-    if (_updateScriptHandler)
+    if (_extraData && _extraData->updateScriptHandler)
     {
-        ScriptEngineManager::getInstance()->getScriptEngine()->removeScriptHandler(_updateScriptHandler);
+        ScriptEngineManager::getInstance()->getScriptEngine()->removeScriptHandler(_extraData->updateScriptHandler);
     }
 #endif
 
     // User object has to be released before others, since userObject may have a weak reference of this node
     // It may invoke `node->stopAllAction();` while `_actionManager` is null if the next line is after `CC_SAFE_RELEASE_NULL(_actionManager)`.
-    CC_SAFE_RELEASE_NULL(_userObject);
+    if (_extraData)
+    {
+        CC_SAFE_RELEASE_NULL(_extraData->userObject);
+    }
     
     // attributes
     CC_SAFE_RELEASE_NULL(_glProgramState);
@@ -163,12 +214,17 @@ Node::~Node()
 
     removeAllComponents();
     
-    CC_SAFE_DELETE(_componentContainer);
-    
 #if CC_USE_PHYSICS
     setPhysicsBody(nullptr);
 
 #endif
+
+    if (_extraData)
+    {
+        CC_SAFE_DELETE(_extraData->componentContainer);
+        delete _extraData;
+        _extraData = nullptr;
+    }
     
     CC_SAFE_RELEASE_NULL(_actionManager);
     CC_SAFE_RELEASE_NULL(_scheduler);
@@ -200,6 +256,7 @@ void Node::setSkewX(float skewX)
     
     _skewX = skewX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setSubtreeBoundingBoxDirty();
 }
 
 float Node::getSkewY() const
@@ -214,6 +271,7 @@ void Node::setSkewY(float skewY)
     
     _skewY = skewY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setSubtreeBoundingBoxDirty();
 }
 
 
@@ -262,11 +320,13 @@ void Node::setRotation(float rotation)
     
     _rotationZ_X = _rotationZ_Y = rotation;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setSubtreeBoundingBoxDirty();
 
 #if CC_USE_PHYSICS
-    if (_physicsBody && !_physicsBody->_rotationResetTag)
+    PhysicsBody* physicsBody = getPhysicsBody();
+    if (physicsBody && !physicsBody->_rotationResetTag)
     {
-        Scene* scene = _physicsBody->getWorld() != nullptr ? &_physicsBody->getWorld()->getScene() : nullptr;
+        Scene* scene = physicsBody->getWorld() != nullptr ? &physicsBody->getWorld()->getScene() : nullptr;
         updatePhysicsBodyRotation(scene);
     }
 #endif
@@ -285,6 +345,7 @@ void Node::setRotation3D(const Vec3& rotation)
         return;
     
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setSubtreeBoundingBoxDirty();
 
     _rotationX = rotation.x;
     _rotationY = rotation.y;
@@ -293,9 +354,10 @@ void Node::setRotation3D(const Vec3& rotation)
     _rotationZ_Y = _rotationZ_X = rotation.z;
 
 #if CC_USE_PHYSICS
-    if (_physicsBody)
+    PhysicsBody* physicsBody = getPhysicsBody();
+    if (physicsBody)
     {
-        Scene* scene = _physicsBody->getWorld() != nullptr ? &_physicsBody->getWorld()->getScene() : nullptr;
+        Scene* scene = physicsBody->getWorld() != nullptr ? &physicsBody->getWorld()->getScene() : nullptr;
         updatePhysicsBodyRotation(scene);
     }
 #endif
@@ -316,6 +378,7 @@ void Node::setRotationSkewX(float rotationX)
     
     _rotationZ_X = rotationX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setSubtreeBoundingBoxDirty();
 }
 
 float Node::getRotationSkewY() const
@@ -330,6 +393,7 @@ void Node::setRotationSkewY(float rotationY)
     
     _rotationZ_Y = rotationY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setSubtreeBoundingBoxDirty();
 }
 
 /// scale getter
@@ -347,6 +411,7 @@ void Node::setScale(float scale)
 
     _scaleX = _scaleY = _scaleZ = scale;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setSubtreeBoundingBoxDirty();
 }
 
 /// scaleX getter
@@ -364,6 +429,7 @@ void Node::setScale(float scaleX,float scaleY)
     _scaleX = scaleX;
     _scaleY = scaleY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setSubtreeBoundingBoxDirty();
 }
 
 /// scaleX setter
@@ -374,6 +440,7 @@ void Node::setScaleX(float scaleX)
     
     _scaleX = scaleX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setSubtreeBoundingBoxDirty();
 }
 
 /// scaleY getter
@@ -390,6 +457,7 @@ void Node::setScaleZ(float scaleZ)
     
     _scaleZ = scaleZ;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setSubtreeBoundingBoxDirty();
 }
 
 /// scaleY getter
@@ -406,6 +474,7 @@ void Node::setScaleY(float scaleY)
     
     _scaleY = scaleY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setSubtreeBoundingBoxDirty();
 }
 
 
@@ -423,11 +492,13 @@ void Node::setPosition(const Vec2& position)
     
     _position = position;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setSubtreeBoundingBoxDirty();
 
 #if CC_USE_PHYSICS
-    if (_physicsBody != nullptr && !_physicsBody->_positionResetTag)
+    PhysicsBody* physicsBody = getPhysicsBody();
+    if (physicsBody != nullptr && !physicsBody->_positionResetTag)
     {
-        Scene* scene = _physicsBody->getWorld() != nullptr ? &_physicsBody->getWorld()->getScene() : nullptr;
+        Scene* scene = physicsBody->getWorld() != nullptr ? &physicsBody->getWorld()->getScene() : nullptr;
         updatePhysicsBodyPosition(scene);
     }
 #endif
@@ -490,6 +561,7 @@ void Node::setPositionZ(float positionZ)
         return;
     
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setSubtreeBoundingBoxDirty();
 
     _positionZ = positionZ;
 
@@ -516,6 +588,7 @@ void Node::setVisible(bool var)
     {
         _visible = var;
         if(_visible) _transformUpdated = _transformDirty = _inverseDirty = true;
+        setSubtreeBoundingBoxDirty();
     }
 }
 
@@ -533,7 +606,7 @@ const Vec2& Node::getAnchorPoint() const
 void Node::setAnchorPoint(const Vec2& point)
 {
 #if CC_USE_PHYSICS
-    if (_physicsBody != nullptr && !point.equals(Vec2::ANCHOR_MIDDLE))
+    if (getPhysicsBody() != nullptr && !point.equals(Vec2::ANCHOR_MIDDLE))
     {
         CCLOG("Node warning: This node has a physics body, the anchor must be in the middle, you cann't change this to other value.");
         return;
@@ -545,6 +618,7 @@ void Node::setAnchorPoint(const Vec2& point)
         _anchorPoint = point;
         _anchorPointInPoints = Vec2(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y );
         _transformUpdated = _transformDirty = _inverseDirty = true;
+        setSubtreeBoundingBoxDirty();
     }
 }
 
@@ -562,6 +636,7 @@ void Node::setContentSize(const Size & size)
 
         _anchorPointInPoints = Vec2(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y );
         _transformUpdated = _transformDirty = _inverseDirty = true;
+        setSubtreeBoundingBoxDirty();
     }
 }
 
@@ -589,6 +664,7 @@ void Node::ignoreAnchorPointForPosition(bool newValue)
     {
 		_ignoreAnchorPointForPosition = newValue;
         _transformUpdated = _transformDirty = _inverseDirty = true;
+        setSubtreeBoundingBoxDirty();
 	}
 }
 
@@ -607,7 +683,7 @@ void Node::setTag(int var)
 /// userData setter
 void Node::setUserData(void *var)
 {
-    _userData = var;
+    getExtraData()->userData = var;
 }
 
 int Node::getOrderOfArrival() const
@@ -623,9 +699,12 @@ void Node::setOrderOfArrival(int orderOfArrival)
 
 void Node::setUserObject(Ref *pUserObject)
 {
+    if (pUserObject == nullptr && _extraData == nullptr)
+        return;
+
     CC_SAFE_RETAIN(pUserObject);
-    CC_SAFE_RELEASE(_userObject);
-    _userObject = pUserObject;
+    CC_SAFE_RELEASE(getExtraData()->userObject);
+    _extraData->userObject = pUserObject;
 }
 
 GLProgramState* Node::getGLProgramState()
@@ -665,6 +744,39 @@ Scene* Node::getScene()
     return _parent->getScene();
 }
 
+void Node::setSubtreeBoundingBoxDirty()
+{
+    // a clean node only has clean descendants, so the walk stops at the first dirty ancestor
+    for (Node* node = this; node != nullptr && !node->_subtreeBoundingBoxDirty; node = node->_parent)
+    {
+        node->_subtreeBoundingBoxDirty = true;
+    }
+}
+
+const Rect& Node::getSubtreeBoundingBox()
+{
+    if (_subtreeBoundingBoxDirty)
+    {
+        Rect rect(0, 0, _contentSize.width, _contentSize.height);
+        int count = 1;
+        for (const auto &child : _children)
+        {
+            // the invisible children are cleaned too, their ancestors can't be clean otherwise
+            const Rect& childRect = child->getSubtreeBoundingBox();
+            if (child->_visible)
+            {
+                rect = rect.unionWithRect(childRect);
+                count += child->_subtreeNodeCount;
+            }
+        }
+
+        _subtreeBoundingBox = RectApplyTransform(rect, getNodeToParentTransform());
+        _subtreeNodeCount = count;
+        _subtreeBoundingBoxDirty = false;
+    }
+    return _subtreeBoundingBox;
+}
+
 Rect Node::getBoundingBox() const
 {
     Rect rect = Rect(0, 0, _contentSize.width, _contentSize.height);
@@ -862,9 +974,9 @@ void Node::removeAllChildrenWithCleanup(bool cleanup)
         }
 
 #if CC_USE_PHYSICS
-        if (child->_physicsBody != nullptr)
+        if (child->getPhysicsBody() != nullptr)
         {
-            child->_physicsBody->removeFromWorld();
+            child->getPhysicsBody()->removeFromWorld();
         }
 #endif
 
@@ -877,6 +989,7 @@ void Node::removeAllChildrenWithCleanup(bool cleanup)
     }
     
     _children.clear();
+    setSubtreeBoundingBoxDirty();
 }
 
 void Node::detachChild(Node *child, ssize_t childIndex, bool doCleanup)
@@ -891,9 +1004,9 @@ void Node::detachChild(Node *child, ssize_t childIndex, bool doCleanup)
     }
     
 #if CC_USE_PHYSICS
-    if (child->_physicsBody != nullptr)
+    if (child->getPhysicsBody() != nullptr)
     {
-        child->_physicsBody->removeFromWorld();
+        child->getPhysicsBody()->removeFromWorld();
     }
     
 #endif
@@ -909,6 +1022,7 @@ void Node::detachChild(Node *child, ssize_t childIndex, bool doCleanup)
     child->setParent(nullptr);
 
     _children.erase(childIndex);
+    setSubtreeBoundingBoxDirty();
 }
 
 
@@ -919,6 +1033,7 @@ void Node::insertChild(Node* child, int z)
     _reorderChildDirty = true;
     _children.pushBack(child);
     child->_setLocalZOrder(z);
+    setSubtreeBoundingBoxDirty();
 }
 
 void Node::reorderChild(Node *child, int zOrder)
@@ -987,7 +1102,10 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, bool parentTra
             auto node = _children.at(i);
 
             if ( node && node->_localZOrder < 0 )
-                node->visit(renderer, _modelViewTransform, dirty);
+            {
+                if (!isChildCulled(renderer, node, dirty))
+                    node->visit(renderer, _modelViewTransform, dirty);
+            }
             else
                 break;
         }
@@ -995,7 +1113,10 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, bool parentTra
         this->draw(renderer, _modelViewTransform, dirty);
 
         for(auto it=_children.cbegin()+i; it != _children.cend(); ++it)
-            (*it)->visit(renderer, _modelViewTransform, dirty);
+        {
+            if (!isChildCulled(renderer, *it, dirty))
+                (*it)->visit(renderer, _modelViewTransform, dirty);
+        }
     }
     else
     {
@@ -1008,6 +1129,27 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, bool parentTra
     director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
 }
 
+bool Node::isChildCulled(Renderer* renderer, Node* child, bool transformUpdated)
+{
+    if (!_subtreeCullingEnabled || !child->_visible)
+    {
+        return false;
+    }
+
+    if (renderer->checkVisibility(_modelViewTransform, child->getSubtreeBoundingBox()))
+    {
+        return false;
+    }
+
+    // the skipped subtree didn't get the new transform, it computes it when it comes back on screen
+    if (transformUpdated)
+    {
+        child->_transformUpdated = true;
+    }
+    renderer->addCulledNodes(child->_subtreeNodeCount);
+    return true;
+}
+
 Mat4 Node::transform(const Mat4& parentTransform)
 {
     Mat4 ret = this->getNodeToParentTransform();
@@ -1231,7 +1373,7 @@ void Node::scheduleUpdateWithPriorityLua(int nHandler, int priority)
     unscheduleUpdate();
     
 #if CC_ENABLE_SCRIPT_BINDING
-    _updateScriptHandler = nHandler;
+    getExtraData()->updateScriptHandler = nHandler;
 #endif
     
     _scheduler->scheduleUpdate(this, priority, !_running);
@@ -1242,10 +1384,10 @@ void Node::unscheduleUpdate()
     _scheduler->unscheduleUpdate(this);
     
 #if CC_ENABLE_SCRIPT_BINDING
-    if (_updateScriptHandler)
+    if (_extraData && _extraData->updateScriptHandler)
     {
-        ScriptEngineManager::getInstance()->getScriptEngine()->removeScriptHandler(_updateScriptHandler);
-        _updateScriptHandler = 0;
+        ScriptEngineManager::getInstance()->getScriptEngine()->removeScriptHandler(_extraData->updateScriptHandler);
+        _extraData->updateScriptHandler = 0;
     }
 #endif
 }
@@ -1315,18 +1457,18 @@ void Node::pauseSchedulerAndActions()
 void Node::update(float fDelta)
 {
 #if CC_ENABLE_SCRIPT_BINDING
-    if (0 != _updateScriptHandler)
+    if (_extraData && 0 != _extraData->updateScriptHandler)
     {
         //only lua use
-        SchedulerScriptData data(_updateScriptHandler,fDelta);
+        SchedulerScriptData data(_extraData->updateScriptHandler,fDelta);
         ScriptEvent event(kScheduleEvent,&data);
         ScriptEngineManager::getInstance()->getScriptEngine()->sendEvent(&event);
     }
 #endif
     
-    if (_componentContainer && !_componentContainer->isEmpty())
+    if (_extraData && _extraData->componentContainer && !_extraData->componentContainer->isEmpty())
     {
-        _componentContainer->visit(fDelta);
+        _extraData->componentContainer->visit(fDelta);
     }
 }
 
@@ -1427,7 +1569,7 @@ const Mat4& Node::getNodeToParentTransform() const
 
         if (_useAdditionalTransform)
         {
-            _transform = _transform * _additionalTransform;
+            _transform = _transform * _extraData->additionalTransform;
         }
 
         _transformDirty = false;
@@ -1441,6 +1583,7 @@ void Node::setNodeToParentTransform(const Mat4& transform)
     _transform = transform;
     _transformDirty = false;
     _transformUpdated = true;
+    setSubtreeBoundingBoxDirty();
 }
 
 void Node::setAdditionalTransform(const AffineTransform& additionalTransform)
@@ -1455,10 +1598,11 @@ void Node::setAdditionalTransform(Mat4* additionalTransform)
     if(additionalTransform == nullptr) {
         _useAdditionalTransform = false;
     } else {
-        _additionalTransform = *additionalTransform;
+        getExtraData()->additionalTransform = *additionalTransform;
         _useAdditionalTransform = true;
     }
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setSubtreeBoundingBoxDirty();
 }
 
 
@@ -1473,12 +1617,13 @@ AffineTransform Node::getParentToNodeAffineTransform() const
 
 const Mat4& Node::getParentToNodeTransform() const
 {
+    ExtraData* extraData = getExtraData();
     if ( _inverseDirty ) {
-        _inverse = _transform.getInversed();
+        extraData->inverse = _transform.getInversed();
         _inverseDirty = false;
     }
 
-    return _inverse;
+    return extraData->inverse;
 }
 
 
@@ -1574,53 +1719,56 @@ void Node::updateTransform()
 
 Component* Node::getComponent(const std::string& pName)
 {
-    if( _componentContainer )
-        return _componentContainer->get(pName);
+    if( _extraData && _extraData->componentContainer )
+        return _extraData->componentContainer->get(pName);
     return nullptr;
 }
 
 bool Node::addComponent(Component *pComponent)
 {
     // lazy alloc
-    if( !_componentContainer )
-        _componentContainer = new ComponentContainer(this);
-    return _componentContainer->add(pComponent);
+    ExtraData* extraData = getExtraData();
+    if( !extraData->componentContainer )
+        extraData->componentContainer = new ComponentContainer(this);
+    return extraData->componentContainer->add(pComponent);
 }
 
 bool Node::removeComponent(const std::string& pName)
 {
-    if( _componentContainer )
-        return _componentContainer->remove(pName);
+    if( _extraData && _extraData->componentContainer )
+        return _extraData->componentContainer->remove(pName);
     return false;
 }
 
 void Node::removeAllComponents()
 {
-    if( _componentContainer )
-        _componentContainer->removeAll();
+    if( _extraData && _extraData->componentContainer )
+        _extraData->componentContainer->removeAll();
 }
 
 #if CC_USE_PHYSICS
 
 void Node::updatePhysicsBodyPosition(Scene* scene)
 {
-    if (_physicsBody != nullptr)
+    PhysicsBody* physicsBody = getPhysicsBody();
+    if (physicsBody != nullptr)
     {
         if (scene != nullptr && scene->getPhysicsWorld() != nullptr)
         {
             Vec2 pos = getParent() == scene ? getPosition() : scene->convertToNodeSpace(_parent->convertToWorldSpace(getPosition()));
-            _physicsBody->setPosition(pos);
+            physicsBody->setPosition(pos);
         }
         else
         {
-            _physicsBody->setPosition(getPosition());
+            physicsBody->setPosition(getPosition());
         }
     }
 }
 
 void Node::updatePhysicsBodyRotation(Scene* scene)
 {
-    if (_physicsBody != nullptr)
+    PhysicsBody* physicsBody = getPhysicsBody();
+    if (physicsBody != nullptr)
     {
         if (scene != nullptr && scene->getPhysicsWorld() != nullptr)
         {
@@ -1629,11 +1777,11 @@ void Node::updatePhysicsBodyRotation(Scene* scene)
             {
                 rotation += parent->getRotation();
             }
-            _physicsBody->setRotation(rotation);
+            physicsBody->setRotation(rotation);
         }
         else
         {
-            _physicsBody->setRotation(_rotationZ_X);
+            physicsBody->setRotation(_rotationZ_X);
         }
     }
 }
@@ -1654,12 +1802,13 @@ void Node::setPhysicsBody(PhysicsBody* body)
         }
     }
     
-    if (_physicsBody != nullptr)
+    PhysicsBody* oldBody = getPhysicsBody();
+    if (oldBody != nullptr)
     {
-        PhysicsWorld* world = _physicsBody->getWorld();
-        _physicsBody->removeFromWorld();
-        _physicsBody->_node = nullptr;
-        _physicsBody->release();
+        PhysicsWorld* world = oldBody->getWorld();
+        oldBody->removeFromWorld();
+        oldBody->_node = nullptr;
+        oldBody->release();
         
         if (world != nullptr && body != nullptr)
         {
@@ -1667,7 +1816,10 @@ void Node::setPhysicsBody(PhysicsBody* body)
         }
     }
     
-    _physicsBody = body;
+    if (body != nullptr || _extraData != nullptr)
+    {
+        getExtraData()->physicsBody = body;
+    }
     
     if (body != nullptr)
     {
@@ -1690,7 +1842,7 @@ void Node::setPhysicsBody(PhysicsBody* body)
 
 PhysicsBody* Node::getPhysicsBody() const
 {
-    return _physicsBody;
+    return _extraData ? _extraData->physicsBody : nullptr;
 }
 #endif //CC_USE_PHYSICS
 
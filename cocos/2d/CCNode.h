@@ -32,6 +32,10 @@
 #include "base/ccMacros.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCVector.h"
+#if CC_ENABLE_NODE_SLAB_ALLOCATOR
+#include "base/CCSlabAllocator.h"
+#include <new>
+#endif
 #include "math/CCAffineTransform.h"
 #include "math/CCMath.h"
 #include "renderer/ccGLStateCache.h"
@@ -116,6 +120,24 @@ public:
      */
     static Node * create(void);
 
+#if CC_ENABLE_NODE_SLAB_ALLOCATOR
+    /**
+     * The nodes are allocated from getAllocator() when CC_ENABLE_NODE_SLAB_ALLOCATOR is enabled.
+     * @js NA
+     * @lua NA
+     */
+    static void* operator new(size_t size);
+    static void* operator new(size_t size, const std::nothrow_t&);
+    static void operator delete(void* ptr, size_t size);
+
+    /**
+     * Returns the allocator of the nodes, its statistics count the nodes allocated and destroyed.
+     * @js NA
+     * @lua NA
+     */
+    static SlabAllocator* getAllocator();
+#endif
+
     /**
      * Gets the description string. It makes debugging easier.
      * @return A string
@@ -768,12 +790,12 @@ public:
      * @js NA
      * @lua NA
      */
-    virtual void* getUserData() { return _userData; }
+    virtual void* getUserData() { return _extraData ? _extraData->userData : nullptr; }
     /**
     * @js NA
     * @lua NA
     */
-    virtual const void* getUserData() const { return _userData; }
+    virtual const void* getUserData() const { return _extraData ? _extraData->userData : nullptr; }
 
     /**
      * Sets a custom user data pointer
@@ -797,12 +819,12 @@ public:
      * @js NA
      * @lua NA
      */
-    virtual Ref* getUserObject() { return _userObject; }
+    virtual Ref* getUserObject() { return _extraData ? _extraData->userObject : nullptr; }
     /**
     * @js NA
     * @lua NA
     */
-    virtual const Ref* getUserObject() const { return _userObject; }
+    virtual const Ref* getUserObject() const { return _extraData ? _extraData->userObject : nullptr; }
 
     /**
      * Returns a user assigned Object
@@ -949,6 +971,24 @@ public:
     /** @deprecated Use getBoundingBox instead */
     CC_DEPRECATED_ATTRIBUTE inline virtual Rect boundingBox() const { return getBoundingBox(); }
 
+    /**
+     * Returns an AABB, in its parent's coordinate system, containing the node and all its visible descendants.
+     * Each node contributes the rect of its content size, so the nodes that draw outside of it (particle systems,
+     * draw nodes) must be given a content size covering what they draw to be culled correctly.
+     * The result is cached, and only recomputed when a transform, a content size or a child of the subtree changes.
+     */
+    const Rect& getSubtreeBoundingBox();
+
+    /**
+     * Enables the culling of whole subtrees: visit() skips the children whose getSubtreeBoundingBox() is outside of the screen.
+     * Use it on the containers of large worlds, like the layers of a map or the content of a ScrollView.
+     * The number of nodes skipped in the last frame is returned by Renderer::getCulledNodes().
+     * It is disabled by default.
+     */
+    void setSubtreeCullingEnabled(bool enabled) { _subtreeCullingEnabled = enabled; }
+    /** Returns whether visit() skips the children outside of the screen */
+    bool isSubtreeCullingEnabled() const { return _subtreeCullingEnabled; }
+
     virtual void setEventDispatcher(EventDispatcher* dispatcher);
     virtual EventDispatcher* getEventDispatcher() const { return _eventDispatcher; };
 
@@ -1374,6 +1414,42 @@ protected:
     virtual void updatePhysicsBodyRotation(Scene* layer);
 #endif // CC_USE_PHYSICS
 
+    /** State that most nodes never use. It lives in a separate block, allocated by getExtraData() the first time
+     one of its fields is needed, so that the nodes stay small and the fields visit() reads stay close together.
+     */
+    struct ExtraData
+    {
+        ExtraData();
+
+        Mat4 inverse;                   ///< inverse transform
+        Mat4 additionalTransform;       ///< transform
+        void *userData;                 ///< A user assingned void pointer, Can be point to any cpp object
+        Ref *userObject;                ///< A user assigned Object
+#if CC_ENABLE_SCRIPT_BINDING
+        int updateScriptHandler;        ///< script handler for update() callback per frame, which is invoked from lua & javascript.
+#endif
+        ComponentContainer *componentContainer;     ///< Dictionary of components
+#if CC_USE_PHYSICS
+        PhysicsBody* physicsBody;       ///< the physicsBody the node have
+#endif
+    };
+
+    /// Returns the extra data block, allocating it on the first call
+    ExtraData* getExtraData() const;
+
+    /// Invalidates the cached subtree bounding box of this node and of its ancestors
+    void setSubtreeBoundingBoxDirty();
+
+    /// Returns true, and counts the skipped nodes, when subtree culling is enabled and the subtree of child is off screen
+    bool isChildCulled(Renderer* renderer, Node* child, bool transformUpdated);
+
+    // transform, read and written by every visit(). "cache" variables are allowed to be mutable
+    mutable Mat4 _transform;        ///< transform
+    Mat4 _modelViewTransform;       ///< ModelView transform of the Node.
+
+    Vec2 _position;                 ///< position of the node
+    float _positionZ;               ///< OpenGL real Z position
+
     float _rotationX;               ///< rotation on the X-axis
     float _rotationY;               ///< rotation on the Y-axis
 
@@ -1385,9 +1461,6 @@ protected:
     float _scaleY;                  ///< scaling factor on y-axis
     float _scaleZ;                  ///< scaling factor on z-axis
 
-    Vec2 _position;                ///< position of the node
-    float _positionZ;               ///< OpenGL real Z position
-
     float _skewX;                   ///< skew angle on x-axis
     float _skewY;                   ///< skew angle on y-axis
 
@@ -1396,69 +1469,60 @@ protected:
 
     Size _contentSize;              ///< untransformed size of the node
 
-    Mat4 _modelViewTransform;    ///< ModelView transform of the Node.
+    // scene graph, read by visit() and sortAllChildren()
+    int _localZOrder;               ///< Local order (relative to its siblings) used to sort the node
+    float _globalZOrder;            ///< Global order used to sort the node
+    int _orderOfArrival;            ///< used to preserve sequence while sorting children with the same localZOrder
 
-    // "cache" variables are allowed to be mutable
-    mutable Mat4 _transform;      ///< transform
+    Node *_parent;                  ///< weak reference to parent node
+    Vector<Node*> _children;        ///< array of children nodes
+
+    Rect _subtreeBoundingBox;       ///< cached AABB of the node and its visible descendants, in the parent space
+    int _subtreeNodeCount;          ///< number of visible nodes in the subtree, computed with _subtreeBoundingBox
+
+    // flags, packed together
     mutable bool _transformDirty;   ///< transform dirty flag
-    mutable Mat4 _inverse;        ///< inverse transform
     mutable bool _inverseDirty;     ///< inverse transform dirty flag
-    mutable Mat4 _additionalTransform; ///< transform
     bool _useAdditionalTransform;   ///< The flag to check whether the additional transform is dirty
     bool _transformUpdated;         ///< Whether or not the Transform object was updated since the last frame
 
-    int _localZOrder;               ///< Local order (relative to its siblings) used to sort the node
-    float _globalZOrder;            ///< Global order used to sort the node
-
-    Vector<Node*> _children;        ///< array of children nodes
-    Node *_parent;                  ///< weak reference to parent node
+    bool _visible;                  ///< is this node visible
 
-    int _tag;                         ///< a tag. Can be any number you assigned just to identify this node
-    
-    std::string _name;               ///<a string label, an user defined string to identify this node
+    bool _running;                  ///< is running
 
-    void *_userData;                ///< A user assingned void pointer, Can be point to any cpp object
-    Ref *_userObject;               ///< A user assigned Object
+    bool _reorderChildDirty;          ///< children order dirty flag
+    bool _isTransitionFinished;       ///< flag to indicate whether the transition was finished
 
-    GLProgramState *_glProgramState; ///< OpenGL Program State
+    bool _ignoreAnchorPointForPosition; ///< true if the Anchor Vec2 will be (0,0) when you position the Node, false otherwise.
+                                          ///< Used by Layer and Scene.
 
-    int _orderOfArrival;            ///< used to preserve sequence while sorting children with the same localZOrder
+    bool _cascadeColorEnabled;
+    bool _cascadeOpacityEnabled;
 
-    Scheduler *_scheduler;          ///< scheduler used to schedule timers and updates
+    bool _subtreeBoundingBoxDirty;  ///< _subtreeBoundingBox needs to be recomputed
+    bool _subtreeCullingEnabled;    ///< visit() skips the children outside of the screen
 
-    ActionManager *_actionManager;  ///< a pointer to ActionManager singleton, which is used to handle all the actions
+    // opacity controls
+    GLubyte _displayedOpacity;
+    GLubyte _realOpacity;
+    Color3B _displayedColor;
+    Color3B _realColor;
 
-    EventDispatcher* _eventDispatcher;  ///< event dispatcher used to dispatch all kinds of events
+    int _tag;                         ///< a tag. Can be any number you assigned just to identify this node
 
-    bool _running;                  ///< is running
+    GLProgramState *_glProgramState; ///< OpenGL Program State
 
-    bool _visible;                  ///< is this node visible
+    Scheduler *_scheduler;          ///< scheduler used to schedule timers and updates
 
-    bool _ignoreAnchorPointForPosition; ///< true if the Anchor Vec2 will be (0,0) when you position the Node, false otherwise.
-                                          ///< Used by Layer and Scene.
+    ActionManager *_actionManager;  ///< a pointer to ActionManager singleton, which is used to handle all the actions
 
-    bool _reorderChildDirty;          ///< children order dirty flag
-    bool _isTransitionFinished;       ///< flag to indicate whether the transition was finished
+    EventDispatcher* _eventDispatcher;  ///< event dispatcher used to dispatch all kinds of events
 
 #if CC_ENABLE_SCRIPT_BINDING
-    int _scriptHandler;               ///< script handler for onEnter() & onExit(), used in Javascript binding and Lua binding.
-    int _updateScriptHandler;         ///< script handler for update() callback per frame, which is invoked from lua & javascript.
     ccScriptType _scriptType;         ///< type of script binding, lua or javascript
 #endif
-    
-    ComponentContainer *_componentContainer;        ///< Dictionary of components
 
-#if CC_USE_PHYSICS
-    PhysicsBody* _physicsBody;        ///< the physicsBody the node have
-#endif
-    
-    // opacity controls
-    GLubyte		_displayedOpacity;
-    GLubyte     _realOpacity;
-    Color3B	    _displayedColor;
-    Color3B     _realColor;
-    bool		_cascadeColorEnabled;
-    bool        _cascadeOpacityEnabled;
+    mutable ExtraData* _extraData;  ///< rarely used state, nullptr until getExtraData() is called
 
     static int s_globalOrderOfArrival;
     
@@ -115,8 +115,7 @@ void NodeGrid::visit(Renderer *renderer, const Mat4 &parentTransform, bool paren
         _nodeGrid->set2DProjection();
     }
 
-    _gridBeginCommand.init(_globalZOrder);
-    _gridBeginCommand.func = CC_CALLBACK_0(NodeGrid::onGridBeginDraw, this);
+    _gridBeginCommand.init(_globalZOrder, renderer->getFrameArena(), CC_CALLBACK_0(NodeGrid::onGridBeginDraw, this));
     renderer->addCommand(&_gridBeginCommand);
 
 
@@ -161,8 +160,7 @@ void NodeGrid::visit(Renderer *renderer, const Mat4 &parentTransform, bool paren
         director->setProjection(beforeProjectionType);
     }
 
-    _gridEndCommand.init(_globalZOrder);
-    _gridEndCommand.func = CC_CALLBACK_0(NodeGrid::onGridEndDraw, this);
+    _gridEndCommand.init(_globalZOrder, renderer->getFrameArena(), CC_CALLBACK_0(NodeGrid::onGridEndDraw, this));
     renderer->addCommand(&_gridEndCommand);
 
     renderer->popGroup();
@@ -0,0 +1,135 @@
+/****************************************************************************
+Copyright (c) 2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "2d/CCNodePool.h"
+#include "base/CCEventDispatcher.h"
+
+#include <algorithm>
+
+NS_CC_BEGIN
+
+NodePoolBase::NodePoolBase(const CreateCallback& create, const ResetCallback& reset)
+: _create(create)
+, _reset(reset)
+, _created(0)
+, _reused(0)
+, _recycled(0)
+{
+}
+
+NodePoolBase::~NodePoolBase()
+{
+    clear();
+}
+
+Node* NodePoolBase::obtainNode()
+{
+    if (_available.empty())
+    {
+        Node* node = _create();
+        CCASSERT(node != nullptr, "NodePool: the create function returned nullptr");
+        ++_created;
+        return node;
+    }
+
+    // the reference of the pool is given to the autorelease pool, like a node returned by create()
+    Node* node = _available.back();
+    _available.pop_back();
+    node->autorelease();
+    ++_reused;
+    return node;
+}
+
+void NodePoolBase::recycleNode(Node* node)
+{
+    CCASSERT(node != nullptr, "NodePool: can't recycle a null node");
+    CCASSERT(std::find(_available.begin(), _available.end(), node) == _available.end(), "NodePool: the node is already recycled");
+
+    node->retain();
+    node->removeFromParentAndCleanup(true);
+    resetNode(node);
+    if (_reset)
+    {
+        _reset(node);
+    }
+
+    _available.push_back(node);
+    ++_recycled;
+}
+
+void NodePoolBase::reserve(ssize_t count)
+{
+    _available.reserve(count);
+    while (getAvailableCount() < count)
+    {
+        Node* node = _create();
+        CCASSERT(node != nullptr, "NodePool: the create function returned nullptr");
+        node->retain();
+        _available.push_back(node);
+        ++_created;
+    }
+}
+
+void NodePoolBase::clear()
+{
+    for (auto node : _available)
+    {
+        node->release();
+    }
+    _available.clear();
+}
+
+NodePoolBase::Stats NodePoolBase::getStats() const
+{
+    Stats stats;
+    stats.created = _created;
+    stats.reused = _reused;
+    stats.recycled = _recycled;
+    stats.available = getAvailableCount();
+    return stats;
+}
+
+void NodePoolBase::resetNode(Node* node)
+{
+    // cleanup() stopped the actions and the selectors when the node was removed from its parent,
+    // but a node that had no parent still runs them
+    node->cleanup();
+    node->getEventDispatcher()->removeEventListenersForTarget(node);
+
+    node->setVisible(true);
+    node->setOpacity(255);
+    node->setColor(Color3B::WHITE);
+    node->setRotation3D(Vec3::ZERO);
+    node->setScale(1.0f);
+    node->setSkewX(0.0f);
+    node->setSkewY(0.0f);
+    node->setTag(Node::INVALID_TAG);
+    if (node->getUserData() != nullptr)
+    {
+        node->setUserData(nullptr);
+    }
+    node->setUserObject(nullptr);
+}
+
+NS_CC_END
@@ -0,0 +1,127 @@
+/****************************************************************************
+Copyright (c) 2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CCNODEPOOL_H__
+#define __CCNODEPOOL_H__
+
+#include <functional>
+#include <vector>
+#include "2d/CCNode.h"
+
+NS_CC_BEGIN
+
+/**
+ * Keeps the nodes that are not used anymore, to give them back instead of creating new ones.
+ * Short lived nodes, like bullets, are recycled when they leave the scene and obtained again when the next one
+ * is needed, so that neither the nodes nor their children vectors and program states are allocated again.
+ *
+ * obtain() returns a node marked as "autorelease", like create(): it is destroyed at the end of the frame
+ * if nobody retains it. recycle() removes a node from its parent, resets it and keeps a reference on it until
+ * the next obtain() or clear(). The nodes released by the pool are destroyed like the other nodes.
+ * Pools are not thread safe.
+ */
+class CC_DLL NodePoolBase
+{
+public:
+    struct Stats
+    {
+        ssize_t created;    // nodes created by obtain() and reserve()
+        ssize_t reused;     // obtain() calls that returned a recycled node
+        ssize_t recycled;   // recycle() calls
+        ssize_t available;  // recycled nodes waiting for obtain()
+    };
+
+    virtual ~NodePoolBase();
+
+    /** Creates nodes until 'count' nodes are available */
+    void reserve(ssize_t count);
+    /** Releases the available nodes */
+    void clear();
+
+    ssize_t getAvailableCount() const { return static_cast<ssize_t>(_available.size()); }
+    Stats getStats() const;
+
+    /**
+     * Puts back the state that a node can get while being used, except its position and its children.
+     * Its actions and scheduled selectors are stopped and its event listeners removed, it becomes visible, opaque
+     * and white, its rotation, scale and skew are reset, and its tag, user data and user object are cleared.
+     */
+    static void resetNode(Node* node);
+
+protected:
+    typedef std::function<Node*()> CreateCallback;
+    typedef std::function<void(Node*)> ResetCallback;
+
+    NodePoolBase(const CreateCallback& create, const ResetCallback& reset);
+
+    Node* obtainNode();
+    void recycleNode(Node* node);
+
+    CreateCallback _create;
+    ResetCallback _reset;
+    std::vector<Node*> _available;
+    ssize_t _created;
+    ssize_t _reused;
+    ssize_t _recycled;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(NodePoolBase);
+};
+
+/**
+ * Pool of nodes of type T, created by T::create() unless another create function is given. Like T::create(),
+ * the create function must return an autoreleased node.
+ * The reset function, if any, is called after resetNode() when a node is recycled, for the state specific to T.
+ @code
+ NodePool<Sprite> bullets([]() { return Sprite::create("bullet.png"); });
+
+ auto bullet = bullets.obtain();
+ layer->addChild(bullet);
+ ...
+ bullets.recycle(bullet);   // instead of bullet->removeFromParent()
+ @endcode
+ */
+template <class T>
+class NodePool : public NodePoolBase
+{
+public:
+    explicit NodePool(const std::function<T*()>& create = nullptr, const std::function<void(T*)>& reset = nullptr)
+    : NodePoolBase(create ? CreateCallback(create) : CreateCallback(&NodePool<T>::createDefault),
+                   reset ? ResetCallback([reset](Node* node) { reset(static_cast<T*>(node)); }) : ResetCallback(nullptr))
+    {
+    }
+
+    /** Returns a recycled node, or a new one if none is available */
+    T* obtain() { return static_cast<T*>(obtainNode()); }
+
+    /** Removes the node from its parent, with cleanup, resets it and makes it available to obtain() */
+    void recycle(T* node) { recycleNode(node); }
+
+private:
+    static Node* createDefault() { return T::create(); }
+};
+
+NS_CC_END
+
+#endif // __CCNODEPOOL_H__
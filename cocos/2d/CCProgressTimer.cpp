@@ -556,8 +556,7 @@ void ProgressTimer::draw(Renderer *renderer, const Mat4 &transform, bool transfo
     if( ! _vertexData || ! _sprite)
         return;
 
-    _customCommand.init(_globalZOrder);
-    _customCommand.func = CC_CALLBACK_0(ProgressTimer::onDraw, this, transform, transformUpdated);
+    _customCommand.init(_globalZOrder, renderer->getFrameArena(), CC_CALLBACK_0(ProgressTimer::onDraw, this, transform, transformUpdated));
     renderer->addCommand(&_customCommand);
 }
 
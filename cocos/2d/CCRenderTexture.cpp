@@ -37,6 +37,8 @@ THE SOFTWARE.
 #include "CCGL.h"
 #include "base/CCEventType.h"
 #include "2d/CCGrid.h"
+#include "base/CCScheduler.h"
+#include "base/CCThreadPool.h"
 
 #include "renderer/CCRenderer.h"
 #include "renderer/CCGroupCommand.h"
@@ -46,8 +48,31 @@ THE SOFTWARE.
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventDispatcher.h"
 
+// Pixel buffer objects let glReadPixels return before the copy is done. OpenGL ES 2.0 can't map
+// a buffer for reading, so they are only used on desktop GL.
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+#define CC_RENDERTEXTURE_USE_PBO 1
+#else
+#define CC_RENDERTEXTURE_USE_PBO 0
+#endif
+
 NS_CC_BEGIN
 
+static bool s_pixelBufferReadbackEnabled = true;
+
+namespace
+{
+    // copies the rows of `pixels` bottom to top into `out`
+    void flipRows(const unsigned char* pixels, int width, int height, unsigned char* out)
+    {
+        const int rowLen = width * 4;
+        for (int i = 0; i < height; ++i)
+        {
+            memcpy(&out[i * rowLen], &pixels[(height - i - 1) * rowLen], rowLen);
+        }
+    }
+}
+
 // implementation RenderTexture
 RenderTexture::RenderTexture()
 : _FBO(0)
@@ -344,8 +369,7 @@ void RenderTexture::beginWithClear(float r, float g, float b, float a, float dep
     this->begin();
 
     //clear screen
-    _beginWithClearCommand.init(_globalZOrder);
-    _beginWithClearCommand.func = CC_CALLBACK_0(RenderTexture::onClear, this);
+    _beginWithClearCommand.init(_globalZOrder, Director::getInstance()->getRenderer()->getFrameArena(), CC_CALLBACK_0(RenderTexture::onClear, this));
     Director::getInstance()->getRenderer()->addCommand(&_beginWithClearCommand);
 }
 
@@ -362,8 +386,7 @@ void RenderTexture::clearDepth(float depthValue)
 
     this->begin();
 
-    _clearDepthCommand.init(_globalZOrder);
-    _clearDepthCommand.func = CC_CALLBACK_0(RenderTexture::onClearDepth, this);
+    _clearDepthCommand.init(_globalZOrder, Director::getInstance()->getRenderer()->getFrameArena(), CC_CALLBACK_0(RenderTexture::onClearDepth, this));
 
     Director::getInstance()->getRenderer()->addCommand(&_clearDepthCommand);
 
@@ -418,28 +441,206 @@ bool RenderTexture::saveToFile(const std::string& filename)
 {
     return saveToFile(filename,Image::Format::JPG);
 }
-bool RenderTexture::saveToFile(const std::string& fileName, Image::Format format)
+bool RenderTexture::saveToFile(const std::string& fileName, Image::Format format, const std::function<void(RenderTexture*, const std::string&, bool)>& callback)
 {
     CCASSERT(format == Image::Format::JPG || format == Image::Format::PNG,
              "the image can only be saved as JPG or PNG format");
     
     std::string fullpath = FileUtils::getInstance()->getWritablePath() + fileName;
-    _saveToFileCommand.init(_globalZOrder);
-    _saveToFileCommand.func = CC_CALLBACK_0(RenderTexture::onSaveToFile,this,fullpath);
-    
-    Director::getInstance()->getRenderer()->addCommand(&_saveToFileCommand);
+
+    ReadbackRequest request;
+    request.flipImage = true;
+    request.process = [fullpath](Image* image) {
+        if (!image->saveToFile(fullpath, true))
+        {
+            CCLOG("cocos2d: RenderTexture: failed to save %s", fullpath.c_str());
+            return false;
+        }
+        return true;
+    };
+    if (callback)
+    {
+        request.callback = [this, callback, fullpath](Image* image, bool succeeded) {
+            callback(this, fullpath, succeeded);
+        };
+    }
+    return addReadbackRequest(request);
+}
+
+void RenderTexture::newImageAsync(const std::function<void(Image*)>& callback, bool flipImage)
+{
+    ReadbackRequest request;
+    request.flipImage = flipImage;
+    request.callback = [callback](Image* image, bool succeeded) {
+        callback(image);
+    };
+    if (!addReadbackRequest(request))
+    {
+        callback(nullptr);
+    }
+}
+
+void RenderTexture::setPixelBufferReadbackEnabled(bool enabled)
+{
+    s_pixelBufferReadbackEnabled = enabled;
+}
+
+bool RenderTexture::isPixelBufferReadbackEnabled()
+{
+    return s_pixelBufferReadbackEnabled;
+}
+
+bool RenderTexture::addReadbackRequest(const ReadbackRequest& request)
+{
+    CCASSERT(_pixelFormat == Texture2D::PixelFormat::RGBA8888, "only RGBA8888 can be saved as image");
+
+    if (nullptr == _texture || _pixelFormat != Texture2D::PixelFormat::RGBA8888)
+    {
+        return false;
+    }
+
+    // the requests of the same frame share one read back
+    if (_readbackRequests.empty())
+    {
+        _saveToFileCommand.init(_globalZOrder, Director::getInstance()->getRenderer()->getFrameArena(), CC_CALLBACK_0(RenderTexture::onReadback, this));
+        Director::getInstance()->getRenderer()->addCommand(&_saveToFileCommand);
+    }
+    _readbackRequests.push_back(request);
+
+    // released when the request's callback has been called
+    retain();
     return true;
 }
 
-void RenderTexture::onSaveToFile(const std::string& filename)
+void RenderTexture::onReadback()
 {
-    Image *image = newImage(true);
-    if (image)
+    std::vector<ReadbackRequest> requests;
+    requests.swap(_readbackRequests);
+
+    if (requests.empty())
+    {
+        return;
+    }
+
+    const Size& s = _texture->getContentSizeInPixels();
+    const int width = (int)s.width;
+    const int height = (int)s.height;
+    const size_t dataLen = width * height * 4;
+
+#if CC_RENDERTEXTURE_USE_PBO
+    if (s_pixelBufferReadbackEnabled && Configuration::getInstance()->checkForGLExtension("pixel_buffer_object"))
     {
-        image->saveToFile(filename.c_str(), true);
+        GLuint pbo = 0;
+        glGenBuffers(1, &pbo);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
+        glBufferData(GL_PIXEL_PACK_BUFFER, dataLen, nullptr, GL_STREAM_READ);
+        readPixels(nullptr);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        // map the buffer on the next frame, when the GPU is done with the copy
+        Director::getInstance()->getScheduler()->performFunctionInCocosThread([=](){
+            // left empty if the buffer can't be mapped, the requests fail
+            std::vector<unsigned char> pixels;
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
+            auto mapped = static_cast<const unsigned char*>(glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY));
+            if (mapped)
+            {
+                pixels.assign(mapped, mapped + dataLen);
+                glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            }
+            else
+            {
+                CCLOG("cocos2d: RenderTexture: failed to map the pixel buffer");
+            }
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            glDeleteBuffers(1, &pbo);
+
+            processReadback(std::move(pixels), requests, width, height);
+        });
+        return;
     }
+#endif
+
+    std::vector<unsigned char> pixels(dataLen);
+    readPixels(pixels.data());
+    processReadback(std::move(pixels), requests, width, height);
+}
+
+void RenderTexture::processReadback(std::vector<unsigned char>&& pixels, const std::vector<ReadbackRequest>& requests, int width, int height)
+{
+    auto scheduler = Director::getInstance()->getScheduler();
+    auto data = std::make_shared<std::vector<unsigned char>>(std::move(pixels));
+
+    ThreadPool::getInstance()->enqueue([=](){
+        std::vector<unsigned char> flipped;
+        std::vector<Image*> images;
+        std::vector<bool> results;
+
+        for (const auto& request : requests)
+        {
+            if (data->empty())
+            {
+                images.push_back(nullptr);
+                results.push_back(false);
+                continue;
+            }
+
+            const unsigned char* imageData = data->data();
+            if (request.flipImage)
+            {
+                if (flipped.empty())
+                {
+                    flipped.resize(data->size());
+                    flipRows(data->data(), width, height, flipped.data());
+                }
+                imageData = flipped.data();
+            }
+
+            Image* image = new Image();
+            bool succeeded = image->initWithRawData(imageData, width * height * 4, width, height, 8);
+            if (succeeded && request.process)
+            {
+                succeeded = request.process(image);
+            }
+            images.push_back(image);
+            results.push_back(succeeded);
+        }
+
+        scheduler->performFunctionInCocosThread([=](){
+            for (size_t i = 0; i < requests.size(); ++i)
+            {
+                if (requests[i].callback)
+                {
+                    requests[i].callback(images[i], results[i]);
+                }
+                CC_SAFE_RELEASE(images[i]);
+                this->release();
+            }
+        });
+    });
+}
+
+void RenderTexture::readPixels(GLvoid* pixels)
+{
+    const Size& s = _texture->getContentSizeInPixels();
+
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &_oldFBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, _FBO);
 
-    CC_SAFE_DELETE(image);
+    //TODO move this to configration, so we don't check it every time
+    /*  Certain Qualcomm Andreno gpu's will retain data in memory after a frame buffer switch which corrupts the render to the texture. The solution is to clear the frame buffer before rendering to the texture. However, calling glClear has the unintended result of clearing the current texture. Create a temporary texture to overcome this. At the end of RenderTexture::begin(), switch the attached texture to the second one, call glClear, and then switch back to the original texture. This solution is unnecessary for other devices as they don't have the same issue with switching frame buffers.
+     */
+    if (Configuration::getInstance()->checkForGLExtension("GL_QCOM"))
+    {
+        // -- bind a temporary texture so we can clear the render buffer without losing our texture
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _textureCopy->getName(), 0);
+        CHECK_GL_ERROR_DEBUG();
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _texture->getName(), 0);
+    }
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, (GLsizei)s.width, (GLsizei)s.height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    glBindFramebuffer(GL_FRAMEBUFFER, _oldFBO);
 }
 
 /* get buffer as Image */
@@ -475,34 +676,13 @@ Image* RenderTexture::newImage(bool fliimage)
             break;
         }
 
-        glGetIntegerv(GL_FRAMEBUFFER_BINDING, &_oldFBO);
-        glBindFramebuffer(GL_FRAMEBUFFER, _FBO);
-
-        //TODO move this to configration, so we don't check it every time
-        /*  Certain Qualcomm Andreno gpu's will retain data in memory after a frame buffer switch which corrupts the render to the texture. The solution is to clear the frame buffer before rendering to the texture. However, calling glClear has the unintended result of clearing the current texture. Create a temporary texture to overcome this. At the end of RenderTexture::begin(), switch the attached texture to the second one, call glClear, and then switch back to the original texture. This solution is unnecessary for other devices as they don't have the same issue with switching frame buffers.
-         */
-        if (Configuration::getInstance()->checkForGLExtension("GL_QCOM"))
-        {
-            // -- bind a temporary texture so we can clear the render buffer without losing our texture
-            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _textureCopy->getName(), 0);
-            CHECK_GL_ERROR_DEBUG();
-            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _texture->getName(), 0);
-        }
-        glPixelStorei(GL_PACK_ALIGNMENT, 1);
-        glReadPixels(0,0,savedBufferWidth, savedBufferHeight,GL_RGBA,GL_UNSIGNED_BYTE, tempData);
-        glBindFramebuffer(GL_FRAMEBUFFER, _oldFBO);
+        readPixels(tempData);
 
         if ( fliimage ) // -- flip is only required when saving image to file
         {
             // to get the actual texture data
             // #640 the image read from rendertexture is dirty
-            for (int i = 0; i < savedBufferHeight; ++i)
-            {
-                memcpy(&buffer[i * savedBufferWidth * 4],
-                       &tempData[(savedBufferHeight - i - 1) * savedBufferWidth * 4],
-                       savedBufferWidth * 4);
-            }
+            flipRows(tempData, savedBufferWidth, savedBufferHeight, buffer);
 
             image->initWithRawData(buffer, savedBufferWidth * savedBufferHeight * 4, savedBufferWidth, savedBufferHeight, 8);
         }
@@ -662,8 +842,7 @@ void RenderTexture::draw(Renderer *renderer, const Mat4 &transform, bool transfo
         begin();
 
         //clear screen
-        _clearCommand.init(_globalZOrder);
-        _clearCommand.func = CC_CALLBACK_0(RenderTexture::onClear, this);
+        _clearCommand.init(_globalZOrder, renderer->getFrameArena(), CC_CALLBACK_0(RenderTexture::onClear, this));
         renderer->addCommand(&_clearCommand);
 
         //! make sure all children are drawn
@@ -714,16 +893,14 @@ void RenderTexture::begin()
     renderer->addCommand(&_groupCommand);
     renderer->pushGroup(_groupCommand.getRenderQueueID());
 
-    _beginCommand.init(_globalZOrder);
-    _beginCommand.func = CC_CALLBACK_0(RenderTexture::onBegin, this);
+    _beginCommand.init(_globalZOrder, renderer->getFrameArena(), CC_CALLBACK_0(RenderTexture::onBegin, this));
 
     Director::getInstance()->getRenderer()->addCommand(&_beginCommand);
 }
 
 void RenderTexture::end()
 {
-    _endCommand.init(_globalZOrder);
-    _endCommand.func = CC_CALLBACK_0(RenderTexture::onEnd, this);
+    _endCommand.init(_globalZOrder, Director::getInstance()->getRenderer()->getFrameArena(), CC_CALLBACK_0(RenderTexture::onEnd, this));
 
     Director* director = Director::getInstance();
     CCASSERT(nullptr != director, "Director is null when seting matrix stack");
@@ -32,6 +32,9 @@ THE SOFTWARE.
 #include "renderer/CCGroupCommand.h"
 #include "renderer/CCCustomCommand.h"
 
+#include <functional>
+#include <vector>
+
 NS_CC_BEGIN
 
 class EventCustom;
@@ -100,15 +103,32 @@ public:
     
     CC_DEPRECATED_ATTRIBUTE Image* newCCImage(bool flipImage = true) { return newImage(flipImage); };
 
+    /** Reads the texture's data back without stalling the frame and calls `callback` with it on the cocos thread.
+     The pixels are read at the end of the current frame (through a pixel buffer object when the GL supports it),
+     the rows are flipped on a worker thread, and the image is released after `callback` returns: retain it to keep it.
+     `callback` is called with nullptr if the pixels couldn't be read.
+     @js NA
+     @lua NA
+     */
+    void newImageAsync(const std::function<void(Image*)>& callback, bool flipImage = true);
+
     /** saves the texture into a file using JPEG format. The file will be saved in the Documents folder.
         Returns true if the operation is successful.
      */
     bool saveToFile(const std::string& filename);
 
     /** saves the texture into a file. The format could be JPG or PNG. The file will be saved in the Documents folder.
-        Returns true if the operation is successful.
+        The pixels are read back asynchronously and encoded on a worker thread; `callback` is called on the cocos
+        thread with the full path once the file is written, and with false if the pixels couldn't be read or written.
+        Returns false if the texture can't be saved, in which case `callback` isn't called.
      */
-    bool saveToFile(const std::string& filename, Image::Format format);
+    bool saveToFile(const std::string& filename, Image::Format format, const std::function<void(RenderTexture*, const std::string&, bool succeeded)>& callback = nullptr);
+
+    /** Reads the pixels of newImageAsync() and saveToFile() through a pixel buffer object when the GL supports it.
+     Disabling it forces the synchronous glReadPixels fallback, e.g. to test it. By default it is enabled.
+     */
+    static void setPixelBufferReadbackEnabled(bool enabled);
+    static bool isPixelBufferReadbackEnabled();
     
     /** Listen "come to background" message, and save render texture.
      It only has effect on Android.
@@ -222,7 +242,23 @@ protected:
     void onClear();
     void onClearDepth();
 
-    void onSaveToFile(const std::string& fileName);
+    void onReadback();
+    // binds the FBO and reads the pixels into `pixels`, or into the bound GL_PIXEL_PACK_BUFFER
+    void readPixels(GLvoid* pixels);
+
+    struct ReadbackRequest
+    {
+        // runs on a worker thread once the image is ready, returns false if it failed, may be empty
+        std::function<bool(Image*)> process;
+        // runs on the cocos thread, with nullptr if the pixels couldn't be read and with the result of process
+        std::function<void(Image*, bool succeeded)> callback;
+        bool flipImage;
+    };
+    // returns false if the texture can't be read back
+    bool addReadbackRequest(const ReadbackRequest& request);
+    void processReadback(std::vector<unsigned char>&& pixels, const std::vector<ReadbackRequest>& requests, int width, int height);
+
+    std::vector<ReadbackRequest> _readbackRequests;
     
     Mat4 _oldTransMatrix, _oldProjMatrix;
     Mat4 _transformMatrix, _projectionMatrix;
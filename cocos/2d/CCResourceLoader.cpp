@@ -0,0 +1,787 @@
+/****************************************************************************
+Copyright (c) 2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "2d/CCResourceLoader.h"
+#include "2d/CCAnimationCache.h"
+#include "2d/CCFontAtlas.h"
+#include "2d/CCFontAtlasCache.h"
+#include "2d/CCFontFreeType.h"
+#include "2d/CCLabel.h"
+#include "2d/CCScene.h"
+#include "2d/CCSpriteFrameCache.h"
+#include "2d/CCTextureCache.h"
+#include "2d/ccUTF8.h"
+#include "2d/platform/CCFileUtils.h"
+#include "2d/platform/CCImage.h"
+#include "base/CCDirector.h"
+#include "base/CCScheduler.h"
+#include "base/CCThreadPool.h"
+
+#include <algorithm>
+#include <memory>
+
+NS_CC_BEGIN
+
+struct ResourceLoader::Entry
+{
+    enum class State
+    {
+        QUEUED,     // waiting for a loading thread
+        LOADING,    // being loaded
+        WAITING,    // loaded, its dependencies aren't finished yet
+        READY,      // to finish
+        FINISHING,  // finish() was called, done() wasn't yet
+        FINISHED,
+        FAILED,
+    };
+
+    Asset asset;
+    AssetHandler* handler;
+    State state;
+    int pendingDependencies;
+    bool loadSucceeded;
+    // counted in _inFlight
+    bool holdsSlot;
+    // the entries waiting for this one
+    std::vector<Entry*> dependents;
+};
+
+// --------------------- built-in handlers ---------------------
+
+static std::string directoryOf(const std::string& path)
+{
+    size_t pos = path.find_last_of("/\\");
+    return pos == std::string::npos ? "" : path.substr(0, pos + 1);
+}
+
+static std::string lowerExtension(const std::string& path)
+{
+    size_t dot = path.find_last_of('.');
+    size_t slash = path.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+    {
+        return "";
+    }
+    std::string extension = path.substr(dot);
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    return extension;
+}
+
+// the type of an asset given by its extension
+static std::string typeOfFile(const std::string& file)
+{
+    static const char* images[] = { ".png", ".jpg", ".jpeg", ".pvr", ".ccz", ".gz", ".webp", ".tga", ".tif", ".tiff", ".bmp", ".pkm" };
+
+    std::string extension = lowerExtension(file);
+    for (auto image : images)
+    {
+        if (extension == image)
+        {
+            return "texture";
+        }
+    }
+    if (extension == ".plist" || extension == ".sfb")
+    {
+        // the animation files are plists too, they need their type
+        return "spriteframes";
+    }
+    if (extension == ".fnt")
+    {
+        return "bmfont";
+    }
+    if (extension == ".ttf" || extension == ".otf")
+    {
+        return "ttf";
+    }
+    if (extension == ".exportjson" || extension == ".csab")
+    {
+        return "armature";
+    }
+    return "";
+}
+
+namespace {
+
+class TextureHandler : public ResourceLoader::AssetHandler
+{
+public:
+    virtual bool isLoaded(const ResourceLoader::Asset& asset) override
+    {
+        return Director::getInstance()->getTextureCache()->getTextureForKey(asset.fullPath) != nullptr;
+    }
+
+    virtual bool load(ResourceLoader::Asset& asset) override
+    {
+        Image* image = new Image();
+        if (!image->initWithImageFile(asset.fullPath))
+        {
+            image->release();
+            return false;
+        }
+        asset.object = image;
+        return true;
+    }
+
+    virtual void finish(ResourceLoader::Asset& asset, const std::function<void(bool)>& done) override
+    {
+        auto texture = Director::getInstance()->getTextureCache()->addDecodedImage(asset.fullPath, static_cast<Image*>(asset.object));
+        done(texture != nullptr);
+    }
+
+    virtual bool isUpload(const ResourceLoader::Asset& asset) const override { return true; }
+};
+
+class SpriteFramesHandler : public ResourceLoader::AssetHandler
+{
+public:
+    virtual bool isLoaded(const ResourceLoader::Asset& asset) override
+    {
+        return SpriteFrameCache::getInstance()->isSpriteFramesFileLoaded(asset.fullPath);
+    }
+
+    virtual bool load(ResourceLoader::Asset& asset) override
+    {
+        std::string texturePath = SpriteFrameCache::readSpriteFramesFile(asset.fullPath, asset.values);
+        if (texturePath.empty())
+        {
+            return false;
+        }
+        asset.dependencies.push_back(std::make_pair(std::string("texture"), texturePath));
+        return true;
+    }
+
+    virtual void finish(ResourceLoader::Asset& asset, const std::function<void(bool)>& done) override
+    {
+        auto texture = Director::getInstance()->getTextureCache()->getTextureForKey(asset.dependencies[0].second);
+        if (texture)
+        {
+            SpriteFrameCache::getInstance()->addSpriteFramesWithFile(asset.fullPath, asset.values, texture);
+        }
+        done(texture != nullptr);
+    }
+};
+
+class AnimationsHandler : public ResourceLoader::AssetHandler
+{
+public:
+    virtual bool load(ResourceLoader::Asset& asset) override
+    {
+        asset.values = FileUtils::getInstance()->getValueMapFromFile(asset.fullPath);
+        if (asset.values.find("animations") == asset.values.end())
+        {
+            return false;
+        }
+
+        // loaded here, addAnimationsWithDictionary() would load them on the cocos thread
+        auto properties = asset.values.find("properties");
+        if (properties != asset.values.end() && properties->second.getType() == Value::Type::MAP)
+        {
+            const ValueMap& propertiesDict = properties->second.asValueMap();
+            auto spritesheets = propertiesDict.find("spritesheets");
+            if (spritesheets != propertiesDict.end() && spritesheets->second.getType() == Value::Type::VECTOR)
+            {
+                for (const auto& sheet : spritesheets->second.asValueVector())
+                {
+                    asset.dependencies.push_back(std::make_pair(std::string("spriteframes"), directoryOf(asset.fullPath) + sheet.asString()));
+                }
+            }
+        }
+        return true;
+    }
+
+    virtual void finish(ResourceLoader::Asset& asset, const std::function<void(bool)>& done) override
+    {
+        AnimationCache::getInstance()->addAnimationsWithDictionary(asset.values, asset.fullPath);
+        done(true);
+    }
+};
+
+class BMFontHandler : public ResourceLoader::AssetHandler
+{
+public:
+    virtual bool load(ResourceLoader::Asset& asset) override
+    {
+        Data data = FileUtils::getInstance()->getDataFromFile(asset.fullPath);
+        if (data.isNull())
+        {
+            return false;
+        }
+
+        // only the page is needed here, BMFontConfiguration parses the rest
+        std::string page;
+        const char* bytes = reinterpret_cast<const char*>(data.getBytes());
+        ssize_t size = data.getSize();
+        if (size >= 4 && memcmp(bytes, "BMF", 3) == 0)
+        {
+            // binary file: blocks of a type byte and a 32 bits size, block 3 holds the page names
+            ssize_t offset = 4;
+            while (offset + 5 <= size)
+            {
+                unsigned char blockId = bytes[offset];
+                uint32_t blockSize = 0;
+                memcpy(&blockSize, bytes + offset + 1, 4);
+                offset += 5;
+                if (blockSize > (uint32_t)(size - offset))
+                {
+                    break;
+                }
+                if (blockId == 3)
+                {
+                    page.assign(bytes + offset, strnlen(bytes + offset, blockSize));
+                    break;
+                }
+                offset += blockSize;
+            }
+        }
+        else
+        {
+            // page id=0 file="bitmapFontTest.png"
+            std::string content(bytes, size);
+            size_t line = content.find("page id");
+            size_t start = line == std::string::npos ? line : content.find("file=\"", line);
+            if (start != std::string::npos)
+            {
+                start += 6;
+                size_t end = content.find('"', start);
+                if (end != std::string::npos)
+                {
+                    page = content.substr(start, end - start);
+                }
+            }
+        }
+
+        if (page.empty())
+        {
+            return false;
+        }
+        asset.dependencies.push_back(std::make_pair(std::string("texture"), directoryOf(asset.fullPath) + page));
+        return true;
+    }
+
+    virtual void finish(ResourceLoader::Asset& asset, const std::function<void(bool)>& done) override
+    {
+        // the page is in the texture cache, only the file is parsed here
+        auto atlas = FontAtlasCache::getFontAtlasFNT(asset.file);
+        if (atlas)
+        {
+            asset.unload = [atlas]() { FontAtlasCache::releaseFontAtlas(atlas); };
+        }
+        done(atlas != nullptr);
+    }
+};
+
+class TTFHandler : public ResourceLoader::AssetHandler
+{
+public:
+    virtual bool load(ResourceLoader::Asset& asset) override
+    {
+        asset.data = FileUtils::getInstance()->getDataFromFile(asset.fullPath);
+        return !asset.data.isNull();
+    }
+
+    virtual void finish(ResourceLoader::Asset& asset, const std::function<void(bool)>& done) override
+    {
+        // the labels give the file name as it was added
+        FontFreeType::addPreloadedFontData(asset.file, std::move(asset.data));
+
+        const ValueMap& options = asset.options;
+        auto option = [&options](const char* key) -> Value {
+            auto it = options.find(key);
+            return it == options.end() ? Value() : it->second;
+        };
+
+        TTFConfig config(asset.file.c_str());
+        Value size = option("size");
+        if (!size.isNull())
+        {
+            config.fontSize = size.asInt();
+        }
+        std::string glyphs = option("glyphs").asString();
+        if (glyphs == "nehe")
+        {
+            config.glyphs = GlyphCollection::NEHE;
+        }
+        else if (glyphs == "ascii")
+        {
+            config.glyphs = GlyphCollection::ASCII;
+        }
+        else if (!glyphs.empty() && glyphs != "dynamic")
+        {
+            config.glyphs = GlyphCollection::CUSTOM;
+            config.customGlyphs = glyphs.c_str();
+        }
+        config.outlineSize = option("outline").asInt();
+        config.distanceFieldEnabled = option("distanceField").asBool();
+
+        auto atlas = FontAtlasCache::getFontAtlasTTF(config);
+        if (atlas)
+        {
+            asset.unload = [atlas]() { FontAtlasCache::releaseFontAtlas(atlas); };
+
+            std::u16string text;
+            if (StringUtils::UTF8ToUTF16(option("text").asString(), text) && !text.empty())
+            {
+                atlas->prepareLetterDefinitions(text);
+            }
+        }
+        done(atlas != nullptr);
+    }
+
+    virtual bool isUpload(const ResourceLoader::Asset& asset) const override { return true; }
+};
+
+class DataHandler : public ResourceLoader::AssetHandler
+{
+public:
+    virtual bool load(ResourceLoader::Asset& asset) override
+    {
+        asset.data = FileUtils::getInstance()->getDataFromFile(asset.fullPath);
+        return !asset.data.isNull();
+    }
+
+    virtual void finish(ResourceLoader::Asset& asset, const std::function<void(bool)>& done) override
+    {
+        // kept in the asset for getData()
+        done(true);
+    }
+};
+
+}
+
+typedef std::unordered_map<std::string, std::unique_ptr<ResourceLoader::AssetHandler>> HandlerMap;
+
+static HandlerMap& getHandlers()
+{
+    static HandlerMap handlers;
+    if (handlers.empty())
+    {
+        handlers["texture"].reset(new TextureHandler());
+        handlers["spriteframes"].reset(new SpriteFramesHandler());
+        handlers["animations"].reset(new AnimationsHandler());
+        handlers["bmfont"].reset(new BMFontHandler());
+        handlers["ttf"].reset(new TTFHandler());
+        handlers["data"].reset(new DataHandler());
+    }
+    return handlers;
+}
+
+// --------------------- ResourceLoader ---------------------
+
+ResourceLoader* ResourceLoader::create()
+{
+    ResourceLoader* loader = new ResourceLoader();
+    loader->autorelease();
+    return loader;
+}
+
+void ResourceLoader::registerHandler(const std::string& type, AssetHandler* handler)
+{
+    getHandlers()[type].reset(handler);
+}
+
+ResourceLoader::ResourceLoader()
+: _inFlight(0)
+, _finishedCount(0)
+, _failedCount(0)
+, _maxUploadsPerFrame(2)
+, _scheduler(nullptr)
+, _completed(false)
+{
+    // enough to keep the loading threads busy, few enough to bound the memory of the decoded content
+    _maxInFlight = std::max(4, 2 * (ThreadPool::getInstance()->getThreadCount() + 1));
+}
+
+ResourceLoader::~ResourceLoader()
+{
+    CCASSERT(_scheduler == nullptr, "ResourceLoader: destroyed while loading");
+    for (auto entry : _entries)
+    {
+        if (entry->asset.unload)
+        {
+            entry->asset.unload();
+        }
+        CC_SAFE_RELEASE(entry->asset.object);
+        delete entry;
+    }
+}
+
+void ResourceLoader::addAsset(const std::string& file, const std::string& type, const ValueMap& options)
+{
+    CCASSERT(!_completed, "ResourceLoader: the loading is completed");
+    addEntry(file, type, options);
+}
+
+bool ResourceLoader::addAsset(const std::string& file)
+{
+    std::string type = typeOfFile(file);
+    if (type.empty())
+    {
+        CCLOG("cocos2d: ResourceLoader: unknown type of %s", file.c_str());
+        return false;
+    }
+    addAsset(file, type);
+    return true;
+}
+
+bool ResourceLoader::addManifest(const std::string& file)
+{
+    ValueMap manifest = FileUtils::getInstance()->getValueMapFromFile(file);
+    if (manifest.empty())
+    {
+        CCLOG("cocos2d: ResourceLoader: couldn't read the manifest %s", file.c_str());
+        return false;
+    }
+
+    static const std::pair<const char*, const char*> keys[] = {
+        { "textures", "texture" },
+        { "spriteFrames", "spriteframes" },
+        { "animations", "animations" },
+        { "fonts", "" },
+        { "armatures", "armature" },
+        { "data", "data" },
+        { "assets", "" },
+    };
+
+    for (const auto& key : keys)
+    {
+        auto list = manifest.find(key.first);
+        if (list == manifest.end() || list->second.getType() != Value::Type::VECTOR)
+        {
+            continue;
+        }
+
+        for (const auto& item : list->second.asValueVector())
+        {
+            ValueMap options;
+            std::string assetFile;
+            std::string type = key.second;
+            if (item.getType() == Value::Type::MAP)
+            {
+                options = item.asValueMap();
+                assetFile = options["file"].asString();
+                if (options.find("type") != options.end())
+                {
+                    type = options["type"].asString();
+                    options.erase("type");
+                }
+                options.erase("file");
+            }
+            else
+            {
+                assetFile = item.asString();
+            }
+
+            if (assetFile.empty())
+            {
+                CCLOG("cocos2d: ResourceLoader: an asset of %s has no file", file.c_str());
+                continue;
+            }
+            if (type.empty())
+            {
+                // the fonts, and the assets without a type
+                type = typeOfFile(assetFile);
+                if (type.empty())
+                {
+                    CCLOG("cocos2d: ResourceLoader: unknown type of %s", assetFile.c_str());
+                    continue;
+                }
+            }
+            addAsset(assetFile, type, options);
+        }
+    }
+    return true;
+}
+
+void ResourceLoader::replaceSceneWhenLoaded(const std::function<Scene*()>& createScene)
+{
+    _createScene = createScene;
+}
+
+void ResourceLoader::start(Scheduler* scheduler)
+{
+    CCASSERT(_scheduler == nullptr && !_completed, "ResourceLoader: already started");
+    _scheduler = scheduler ? scheduler : Director::getInstance()->getScheduler();
+    retain();
+    _scheduler->scheduleUpdate(this, 0, false);
+    startLoads();
+}
+
+float ResourceLoader::getProgress() const
+{
+    return _entries.empty() ? 1.0f : (float)_finishedCount / _entries.size();
+}
+
+const Data& ResourceLoader::getData(const std::string& file) const
+{
+    auto it = _entriesByKey.find("data\n" + FileUtils::getInstance()->fullPathForFilename(file));
+    if (it == _entriesByKey.end() || it->second->state != Entry::State::FINISHED)
+    {
+        return Data::Null;
+    }
+    return it->second->asset.data;
+}
+
+ResourceLoader::Entry* ResourceLoader::addEntry(const std::string& file, const std::string& type, const ValueMap& options)
+{
+    auto& handlers = getHandlers();
+    auto handler = handlers.find(type);
+    if (handler == handlers.end())
+    {
+        CCLOG("cocos2d: ResourceLoader: no handler for the type %s of %s", type.c_str(), file.c_str());
+        return nullptr;
+    }
+
+    // the search paths are resolved here, the loading threads only see full paths
+    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(file);
+    std::string key = type + '\n' + fullPath;
+    if (!options.empty())
+    {
+        key += '\n' + Value(options).getDescription();
+    }
+    auto it = _entriesByKey.find(key);
+    if (it != _entriesByKey.end())
+    {
+        return it->second;
+    }
+
+    Entry* entry = new Entry();
+    entry->asset.type = type;
+    entry->asset.file = file;
+    entry->asset.fullPath = fullPath;
+    entry->asset.options = options;
+    entry->asset.object = nullptr;
+    entry->handler = handler->second.get();
+    entry->pendingDependencies = 0;
+    entry->loadSucceeded = false;
+    entry->holdsSlot = false;
+    _entries.push_back(entry);
+    _entriesByKey[key] = entry;
+
+    if (entry->handler->isLoaded(entry->asset))
+    {
+        entry->state = Entry::State::FINISHED;
+        ++_finishedCount;
+    }
+    else
+    {
+        entry->state = Entry::State::QUEUED;
+        _queued.push_back(entry);
+    }
+    return entry;
+}
+
+void ResourceLoader::update(float dt)
+{
+    std::vector<Entry*> decoded;
+    {
+        std::lock_guard<std::mutex> lock(_decodedMutex);
+        decoded.swap(_decoded);
+    }
+    for (auto entry : decoded)
+    {
+        onAssetLoaded(entry);
+    }
+
+    // in order, the uploads over the limit wait for the next frames
+    int uploads = 0;
+    size_t count = _ready.size();
+    for (size_t i = 0; i < count; ++i)
+    {
+        Entry* entry = _ready.front();
+        _ready.pop_front();
+
+        bool upload = entry->handler->isUpload(entry->asset);
+        if (upload && _maxUploadsPerFrame > 0 && uploads >= _maxUploadsPerFrame)
+        {
+            _ready.push_back(entry);
+            continue;
+        }
+        if (upload)
+        {
+            ++uploads;
+        }
+        finishAsset(entry);
+    }
+
+    startLoads();
+
+    if (isDone() && !_completed)
+    {
+        complete();
+    }
+
+    // the references of the loads taken by startLoads(), released last since they may be the last ones
+    for (size_t i = 0; i < decoded.size(); ++i)
+    {
+        release();
+    }
+}
+
+void ResourceLoader::startLoads()
+{
+    while (!_queued.empty() && _inFlight < _maxInFlight)
+    {
+        Entry* entry = _queued.front();
+        _queued.pop_front();
+        entry->state = Entry::State::LOADING;
+        entry->holdsSlot = true;
+        ++_inFlight;
+
+        // released by update() once the entry is decoded, so that the loader outlives its loads
+        retain();
+        ThreadPool::getInstance()->enqueue([this, entry]() {
+            entry->loadSucceeded = entry->handler->load(entry->asset);
+            std::lock_guard<std::mutex> lock(_decodedMutex);
+            _decoded.push_back(entry);
+        });
+    }
+}
+
+void ResourceLoader::onAssetLoaded(Entry* entry)
+{
+    if (!entry->loadSucceeded)
+    {
+        CCLOG("cocos2d: ResourceLoader: couldn't load %s", entry->asset.file.c_str());
+        onAssetFinished(entry, false);
+        return;
+    }
+
+    for (const auto& dependency : entry->asset.dependencies)
+    {
+        Entry* other = addEntry(dependency.second, dependency.first, ValueMap());
+        if (other == nullptr || other->state == Entry::State::FAILED)
+        {
+            CCLOG("cocos2d: ResourceLoader: couldn't load %s, needed by %s", dependency.second.c_str(), entry->asset.file.c_str());
+            onAssetFinished(entry, false);
+            return;
+        }
+        if (other != entry && other->state != Entry::State::FINISHED)
+        {
+            other->dependents.push_back(entry);
+            ++entry->pendingDependencies;
+        }
+    }
+
+    if (entry->pendingDependencies == 0)
+    {
+        entry->state = Entry::State::READY;
+        _ready.push_back(entry);
+    }
+    else
+    {
+        // the slot goes to the dependencies, so that they can't wait for it
+        entry->state = Entry::State::WAITING;
+        entry->holdsSlot = false;
+        --_inFlight;
+    }
+}
+
+void ResourceLoader::finishAsset(Entry* entry)
+{
+    entry->state = Entry::State::FINISHING;
+    entry->handler->finish(entry->asset, [this, entry](bool succeeded) {
+        if (!succeeded)
+        {
+            CCLOG("cocos2d: ResourceLoader: couldn't add %s", entry->asset.file.c_str());
+        }
+        onAssetFinished(entry, succeeded);
+    });
+}
+
+void ResourceLoader::onAssetFinished(Entry* entry, bool succeeded)
+{
+    entry->state = succeeded ? Entry::State::FINISHED : Entry::State::FAILED;
+    ++_finishedCount;
+    if (!succeeded)
+    {
+        ++_failedCount;
+    }
+    if (entry->holdsSlot)
+    {
+        entry->holdsSlot = false;
+        --_inFlight;
+    }
+
+    // the decoded content is in the caches now
+    entry->asset.values.clear();
+    CC_SAFE_RELEASE_NULL(entry->asset.object);
+
+    std::vector<Entry*> dependents;
+    dependents.swap(entry->dependents);
+    for (auto dependent : dependents)
+    {
+        if (dependent->state != Entry::State::WAITING)
+        {
+            // failed by another dependency
+            continue;
+        }
+        if (!succeeded)
+        {
+            onAssetFinished(dependent, false);
+        }
+        else if (--dependent->pendingDependencies == 0)
+        {
+            dependent->state = Entry::State::READY;
+            _ready.push_back(dependent);
+        }
+    }
+
+    if (_progressCallback)
+    {
+        _progressCallback(_finishedCount, getTotalCount());
+    }
+}
+
+void ResourceLoader::complete()
+{
+    _completed = true;
+
+    // released last, the callbacks may release the other references
+    Scheduler* scheduler = _scheduler;
+    _scheduler = nullptr;
+    if (scheduler)
+    {
+        scheduler->unscheduleUpdate(this);
+    }
+
+    if (_completionCallback)
+    {
+        _completionCallback(_failedCount == 0);
+    }
+    if (_createScene)
+    {
+        Scene* scene = _createScene();
+        if (scene)
+        {
+            Director::getInstance()->replaceScene(scene);
+        }
+    }
+
+    if (scheduler)
+    {
+        release();
+    }
+}
+
+NS_CC_END
@@ -0,0 +1,212 @@
+/****************************************************************************
+Copyright (c) 2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CCRESOURCELOADER_H__
+#define __CCRESOURCELOADER_H__
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "base/CCRef.h"
+#include "base/CCValue.h"
+#include "base/CCData.h"
+
+NS_CC_BEGIN
+
+class Scene;
+class Scheduler;
+
+/**
+ * Loads a bundle of assets before they are used, typically the ones of the next scene, without stalling the
+ * frames of the current one.
+ *
+ * The files are read and decoded on the ThreadPool, the dependencies found there are added to the bundle
+ * (the texture of a sprite sheet or of a bitmap font, the sprite sheets of an animation file or of an armature),
+ * and the assets are added to their caches on the cocos thread once their dependencies are, with at most
+ * getMaxUploadsPerFrame() GL uploads per frame. Each file is loaded once, and the assets already in their
+ * caches are not loaded again.
+ *
+ * The built-in types are "texture", "spriteframes", "animations", "bmfont", "ttf" and "data", cocostudio adds
+ * "armature" when ArmatureDataManager is created. Other types are added with registerHandler().
+ *
+ * A manifest is a plist file whose keys list the assets by type, as file names or as dictionaries with a "file"
+ * key and the options of the asset:
+ @code
+ <key>textures</key>     <array><string>Images/background.png</string></array>
+ <key>spriteFrames</key> <array><string>animations/grossini.plist</string></array>
+ <key>animations</key>   <array><string>animations/animations-2.plist</string></array>
+ <key>fonts</key>        <array><string>fonts/bitmapFontTest.fnt</string>
+                                <dict><key>file</key><string>fonts/arial.ttf</string><key>size</key><integer>32</integer></dict></array>
+ <key>armatures</key>    <array><string>armature/Cowboy.ExportJson</string></array>
+ <key>data</key>         <array><string>configs/level1.json</string></array>
+ <key>assets</key>       <array><dict><key>type</key><string>mytype</string><key>file</key><string>a.bin</string></dict></array>
+ @endcode
+ * The fonts are "bmfont" or "ttf" assets depending on their extension. The "ttf" options are "size",
+ * "glyphs" ("dynamic", "nehe", "ascii" or the characters), "outline", "distanceField" and "text", a string
+ * whose characters are added to the atlas.
+ *
+ @code
+ auto loader = ResourceLoader::create();
+ loader->addManifest("level1.plist");
+ loader->setProgressCallback([=](int finished, int total) { bar->setPercent(100 * finished / total); });
+ loader->replaceSceneWhenLoaded([]() { return Level1::create(); });
+ loader->start();
+ @endcode
+ *
+ * The font atlases loaded by a loader are kept until it is destroyed, the other assets stay in their caches.
+ * A loader is used from the cocos thread only. It can also be driven without a Director by calling update()
+ * instead of start(), e.g. in tests.
+ */
+class CC_DLL ResourceLoader : public Ref
+{
+public:
+    /** An asset of the bundle, handed to its AssetHandler */
+    struct Asset
+    {
+        std::string type;
+        // the file name as it was added, and its full path
+        std::string file;
+        std::string fullPath;
+        ValueMap options;
+        // set by AssetHandler::load(): the assets to finish before this one, as (type, file) pairs
+        std::vector<std::pair<std::string, std::string>> dependencies;
+        // the decoded content, kept by load() for finish()
+        Data data;
+        ValueMap values;
+        // released once the asset is finished
+        Ref* object;
+        // set by finish() to release what the loader holds, called when the loader is destroyed
+        std::function<void()> unload;
+    };
+
+    /** Loads the assets of one type */
+    class CC_DLL AssetHandler
+    {
+    public:
+        virtual ~AssetHandler() {}
+
+        /** Returns true if the asset is already in its cache, called on the cocos thread */
+        virtual bool isLoaded(const Asset& asset) { return false; }
+
+        /** Reads and decodes the asset, called on a loading thread: it must not use the search paths nor the caches */
+        virtual bool load(Asset& asset) = 0;
+
+        /** Adds the decoded asset to its cache, called on the cocos thread once the dependencies are finished.
+         * done must be called, possibly later, with false if the asset couldn't be added.
+         */
+        virtual void finish(Asset& asset, const std::function<void(bool)>& done) = 0;
+
+        /** Returns true if finish() creates GL objects, these finish() calls are limited per frame */
+        virtual bool isUpload(const Asset& asset) const { return false; }
+    };
+
+    static ResourceLoader* create();
+
+    /** Sets the handler of a type, the loaders own their handlers */
+    static void registerHandler(const std::string& type, AssetHandler* handler);
+
+    /** Adds an asset of a given type */
+    void addAsset(const std::string& file, const std::string& type, const ValueMap& options = ValueMap());
+    /** Adds an asset whose type is given by its extension, returns false if the extension is unknown */
+    bool addAsset(const std::string& file);
+    /** Adds the assets listed in a manifest, returns false if it can't be read */
+    bool addManifest(const std::string& file);
+
+    /** Called on the cocos thread each time an asset is finished, failed ones included.
+     * The total grows while the dependencies are found.
+     */
+    void setProgressCallback(const std::function<void(int finished, int total)>& callback) { _progressCallback = callback; }
+    /** Called once all the assets are finished, with false if some of them failed */
+    void setCompletionCallback(const std::function<void(bool succeeded)>& callback) { _completionCallback = callback; }
+    /** Replaces the running scene with the one returned by createScene when the loading completes */
+    void replaceSceneWhenLoaded(const std::function<Scene*()>& createScene);
+
+    /** The number of assets finished per frame when they create GL objects, 0 for no limit. Defaults to 2. */
+    void setMaxUploadsPerFrame(int count) { _maxUploadsPerFrame = count; }
+    int getMaxUploadsPerFrame() const { return _maxUploadsPerFrame; }
+
+    /** Starts the loading, updated by scheduler, by the one of the Director if nullptr.
+     * The loader is retained until the completion.
+     */
+    void start(Scheduler* scheduler = nullptr);
+
+    /** Adds the decoded assets to their caches and starts the next loads.
+     * The loader is retained by each load in flight until the update() that follows it.
+     */
+    void update(float dt);
+
+    int getFinishedCount() const { return _finishedCount; }
+    int getFailedCount() const { return _failedCount; }
+    int getTotalCount() const { return static_cast<int>(_entries.size()); }
+    /** Between 0 and 1 */
+    float getProgress() const;
+    bool isDone() const { return _finishedCount == getTotalCount(); }
+
+    /** Returns the content of a finished "data" asset */
+    const Data& getData(const std::string& file) const;
+
+CC_CONSTRUCTOR_ACCESS:
+    ResourceLoader();
+    virtual ~ResourceLoader();
+
+private:
+    struct Entry;
+
+    Entry* addEntry(const std::string& file, const std::string& type, const ValueMap& options);
+    void startLoads();
+    void onAssetLoaded(Entry* entry);
+    void finishAsset(Entry* entry);
+    void onAssetFinished(Entry* entry, bool succeeded);
+    void complete();
+
+    std::vector<Entry*> _entries;
+    std::unordered_map<std::string, Entry*> _entriesByKey;
+    // the entries waiting for a loading thread, and the ones to finish
+    std::deque<Entry*> _queued;
+    std::deque<Entry*> _ready;
+    // the entries loaded by the loading threads
+    std::vector<Entry*> _decoded;
+    std::mutex _decodedMutex;
+    // the entries loaded or being loaded whose decoded content isn't finished yet
+    int _inFlight;
+    int _maxInFlight;
+    int _finishedCount;
+    int _failedCount;
+    int _maxUploadsPerFrame;
+    Scheduler* _scheduler;
+    bool _completed;
+    std::function<void(int, int)> _progressCallback;
+    std::function<void(bool)> _completionCallback;
+    std::function<Scene*()> _createScene;
+
+    CC_DISALLOW_COPY_AND_ASSIGN(ResourceLoader);
+};
+
+NS_CC_END
+
+#endif // __CCRESOURCELOADER_H__
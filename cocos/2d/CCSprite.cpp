@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "2d/CCAnimationCache.h"
 #include "2d/CCSpriteFrame.h"
 #include "2d/CCSpriteFrameCache.h"
+#include "2d/CCDynamicAtlas.h"
 #include "2d/CCTextureCache.h"
 #include "2d/CCDrawingPrimitives.h"
 #include "2d/CCTexture2D.h"
@@ -168,6 +169,12 @@ bool Sprite::initWithFile(const std::string& filename)
 {
     CCASSERT(filename.size()>0, "Invalid filename for sprite");
 
+    DynamicAtlasFrame *atlasFrame = DynamicAtlas::getInstance()->getFrameForFile(filename);
+    if (atlasFrame)
+    {
+        return initWithSpriteFrame(atlasFrame);
+    }
+
     Texture2D *texture = Director::getInstance()->getTextureCache()->addImage(filename);
     if (texture)
     {
@@ -186,6 +193,12 @@ bool Sprite::initWithFile(const std::string &filename, const Rect& rect)
 {
     CCASSERT(filename.size()>0, "Invalid filename");
 
+    DynamicAtlasFrame *atlasFrame = DynamicAtlas::getInstance()->getFrameForFile(filename);
+    if (atlasFrame)
+    {
+        return initWithAtlasFrame(atlasFrame, rect);
+    }
+
     Texture2D *texture = Director::getInstance()->getTextureCache()->addImage(filename);
     if (texture)
     {
@@ -198,6 +211,19 @@ bool Sprite::initWithFile(const std::string &filename, const Rect& rect)
     return false;
 }
 
+bool Sprite::initWithAtlasFrame(DynamicAtlasFrame* frame, const Rect& rect)
+{
+    const Rect& imageRect = frame->getRect();
+    Rect pageRect(imageRect.origin.x + rect.origin.x, imageRect.origin.y + rect.origin.y, rect.size.width, rect.size.height);
+    bool ret = initWithTexture(frame->getTexture(), pageRect);
+
+    // keeps the image in the atlas
+    CC_SAFE_RETAIN(frame);
+    CC_SAFE_RELEASE(_atlasFrame);
+    _atlasFrame = frame;
+    return ret;
+}
+
 bool Sprite::initWithSpriteFrameName(const std::string& spriteFrameName)
 {
     CCASSERT(spriteFrameName.size() > 0, "Invalid spriteFrameName");
@@ -273,11 +299,13 @@ Sprite::Sprite(void)
 : _shouldBeHidden(false)
 , _texture(nullptr)
 , _insideBounds(true)
+, _atlasFrame(nullptr)
 {
 }
 
 Sprite::~Sprite(void)
 {
+    CC_SAFE_RELEASE(_atlasFrame);
     CC_SAFE_RELEASE(_texture);
 }
 
@@ -340,6 +368,12 @@ void Sprite::setTexture(Texture2D *texture)
         }
     }
 
+    // the atlas image isn't displayed anymore
+    if (_atlasFrame && texture != _atlasFrame->getTexture())
+    {
+        CC_SAFE_RELEASE_NULL(_atlasFrame);
+    }
+
     if (!_batchNode && _texture != texture)
     {
         CC_SAFE_RETAIN(texture);
@@ -592,9 +626,12 @@ void Sprite::draw(Renderer *renderer, const Mat4 &transform, bool transformUpdat
     {
         _quadCommand.init(_globalZOrder, _texture->getName(), getGLProgramState(), _blendFunc, &_quad, 1, transform);
         renderer->addCommand(&_quadCommand);
+        if (_atlasFrame)
+        {
+            _atlasFrame->markDrawn(Director::getInstance()->getTotalFrames());
+        }
 #if CC_SPRITE_DEBUG_DRAW
-        _customDebugDrawCommand.init(_globalZOrder);
-        _customDebugDrawCommand.func = CC_CALLBACK_0(Sprite::drawDebugData, this);
+        _customDebugDrawCommand.init(_globalZOrder, renderer->getFrameArena(), CC_CALLBACK_0(Sprite::drawDebugData, this));
         renderer->addCommand(&_customDebugDrawCommand);
 #endif //CC_SPRITE_DEBUG_DRAW
     }
@@ -929,6 +966,15 @@ void Sprite::setSpriteFrame(const std::string &spriteFrameName)
 
 void Sprite::setSpriteFrame(SpriteFrame *spriteFrame)
 {
+    // frames of the DynamicAtlas are retained, so that their image stays in the atlas
+    DynamicAtlasFrame *atlasFrame = dynamic_cast<DynamicAtlasFrame*>(spriteFrame);
+    if (atlasFrame != _atlasFrame)
+    {
+        CC_SAFE_RETAIN(atlasFrame);
+        CC_SAFE_RELEASE(_atlasFrame);
+        _atlasFrame = atlasFrame;
+    }
+
     _unflippedOffsetPositionFromCenter = spriteFrame->getOffset();
 
     Texture2D *texture = spriteFrame->getTexture();
@@ -969,6 +1015,11 @@ bool Sprite::isFrameDisplayed(SpriteFrame *frame) const
 
 SpriteFrame* Sprite::getSpriteFrame() const
 {
+    // shares the frame, so that the sprites using it keep the image in the atlas
+    if (_atlasFrame && isFrameDisplayed(_atlasFrame))
+    {
+        return _atlasFrame;
+    }
     return SpriteFrame::createWithTexture(_texture,
                                            CC_RECT_POINTS_TO_PIXELS(_rect),
                                            _rectRotated,
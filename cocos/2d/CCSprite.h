@@ -44,6 +44,7 @@ NS_CC_BEGIN
 
 class SpriteBatchNode;
 class SpriteFrame;
+class DynamicAtlasFrame;
 class Animation;
 class Rect;
 class Size;
@@ -518,6 +519,8 @@ CC_CONSTRUCTOR_ACCESS:
     virtual bool initWithFile(const std::string& filename, const Rect& rect);
 
 protected:
+    /** Initializes the sprite with a rect of an image packed by the DynamicAtlas, in points relative to the image */
+    bool initWithAtlasFrame(DynamicAtlasFrame* frame, const Rect& rect);
 
     void updateColor(void);
     virtual void setTextureCoords(Rect rect);
@@ -570,6 +573,8 @@ protected:
     bool _flippedY;                         /// Whether the sprite is flipped vertically or not
 
     bool _insideBounds;                     /// whether or not the sprite was inside bounds the previous frame
+
+    DynamicAtlasFrame* _atlasFrame;         /// frame of the DynamicAtlas the sprite was created from, retained
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Sprite);
 };
@@ -35,9 +35,12 @@ THE SOFTWARE.
 #include "2d/CCSprite.h"
 #include "math/TransformUtils.h"
 #include "2d/platform/CCFileUtils.h"
+#include "2d/platform/CCMappedFile.h"
 #include "deprecated/CCString.h"
 #include "base/CCDirector.h"
 #include <vector>
+#include <algorithm>
+#include <stdint.h>
 
 using namespace std;
 
@@ -45,6 +48,267 @@ NS_CC_BEGIN
 
 static SpriteFrameCache *_sharedSpriteFrameCache = nullptr;
 
+/*
+ Binary sprite sheets (.sfb) are written by writeBinarySpriteFramesFile() and tools/spritesheet/plist2sfb.py.
+ All the values are little endian, every section starts on a 4 bytes boundary:
+
+   header | frames | aliases | name index | names
+
+ The name index is an open addressing table (linear probing from the FNV-1a hash of the name) of
+ entry + 1, 0 being an empty slot. The entries past frameCount are aliases.
+ */
+static const char BinarySheetMagic[4] = { 'C', 'S', 'F', 'B' };
+static const uint32_t BinarySheetVersion = 1;
+
+struct BinarySheetHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t frameCount;
+    uint32_t aliasCount;
+    uint32_t indexSize;             // power of two
+    uint32_t textureNameOffset;     // relative to namesOffset
+    uint32_t textureNameLength;     // 0 when the texture name is derived from the sheet name
+    uint32_t framesOffset;
+    uint32_t aliasesOffset;
+    uint32_t indexOffset;
+    uint32_t namesOffset;
+};
+
+struct BinarySheetFrame
+{
+    uint32_t nameOffset;
+    uint32_t nameLength;
+    uint32_t nameHash;
+    float x, y, width, height;
+    float offsetX, offsetY;
+    float sourceWidth, sourceHeight;
+    uint32_t rotated;
+};
+
+struct BinarySheetAlias
+{
+    uint32_t nameOffset;
+    uint32_t nameLength;
+    uint32_t nameHash;
+    uint32_t frameIndex;
+};
+
+// the layout is shared with tools/spritesheet/plist2sfb.py
+static_assert(sizeof(BinarySheetHeader) == 44 && sizeof(BinarySheetFrame) == 48 && sizeof(BinarySheetAlias) == 16,
+              "unexpected binary sprite sheet layout");
+
+static uint32_t hashFrameName(const char* name, size_t length)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; ++i)
+    {
+        hash ^= static_cast<unsigned char>(name[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static bool isBinarySpriteFramesFile(const std::string& filename)
+{
+    size_t pos = filename.find_last_of('.');
+    if (pos == std::string::npos)
+    {
+        return false;
+    }
+    std::string extension = filename.substr(pos);
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    return extension == ".sfb";
+}
+
+struct SpriteFrameCache::BinarySheet
+{
+    std::string fullPath;
+    Texture2D* texture;
+
+    MappedFile file;
+
+    const BinarySheetHeader* header;
+    const BinarySheetFrame* frames;
+    const BinarySheetAlias* aliases;
+    const uint32_t* index;
+    const char* names;
+    size_t namesSize;
+
+    BinarySheet()
+    : texture(nullptr)
+    , header(nullptr)
+    , frames(nullptr)
+    , aliases(nullptr)
+    , index(nullptr)
+    , names(nullptr)
+    , namesSize(0)
+    {
+    }
+
+    ~BinarySheet()
+    {
+        CC_SAFE_RELEASE(texture);
+    }
+
+    bool open(const std::string& path)
+    {
+        fullPath = path;
+
+        // memory mapped when possible
+        file.open(path);
+        const unsigned char* bytes = file.getBytes();
+        size_t size = file.getSize();
+
+        if (bytes == nullptr || size < sizeof(BinarySheetHeader))
+        {
+            return false;
+        }
+
+        header = reinterpret_cast<const BinarySheetHeader*>(bytes);
+        if (memcmp(header->magic, BinarySheetMagic, sizeof(BinarySheetMagic)) != 0 || header->version != BinarySheetVersion)
+        {
+            CCLOG("cocos2d: SpriteFrameCache: %s is not a binary sprite sheet of version %u", path.c_str(), BinarySheetVersion);
+            return false;
+        }
+
+        if (header->indexSize == 0 || (header->indexSize & (header->indexSize - 1)) != 0
+            || header->framesOffset + (size_t)header->frameCount * sizeof(BinarySheetFrame) > size
+            || header->aliasesOffset + (size_t)header->aliasCount * sizeof(BinarySheetAlias) > size
+            || header->indexOffset + (size_t)header->indexSize * sizeof(uint32_t) > size
+            || header->namesOffset > size)
+        {
+            CCLOG("cocos2d: SpriteFrameCache: %s is corrupted", path.c_str());
+            return false;
+        }
+
+        frames = reinterpret_cast<const BinarySheetFrame*>(bytes + header->framesOffset);
+        aliases = reinterpret_cast<const BinarySheetAlias*>(bytes + header->aliasesOffset);
+        index = reinterpret_cast<const uint32_t*>(bytes + header->indexOffset);
+        names = reinterpret_cast<const char*>(bytes + header->namesOffset);
+        namesSize = size - header->namesOffset;
+        return true;
+    }
+
+    bool getName(uint32_t offset, uint32_t length, std::string& name) const
+    {
+        if ((size_t)offset + length > namesSize)
+        {
+            return false;
+        }
+        name.assign(names + offset, length);
+        return true;
+    }
+
+    std::string getTextureName() const
+    {
+        std::string name;
+        if (header->textureNameLength > 0)
+        {
+            getName(header->textureNameOffset, header->textureNameLength, name);
+        }
+        return name;
+    }
+
+    /** Returns the index of the frame named name, or -1 */
+    int findFrame(const std::string& name) const
+    {
+        uint32_t hash = hashFrameName(name.c_str(), name.length());
+        uint32_t mask = header->indexSize - 1;
+        for (uint32_t probe = 0; probe < header->indexSize; ++probe)
+        {
+            uint32_t entry = index[(hash + probe) & mask];
+            if (entry == 0)
+            {
+                return -1;
+            }
+            --entry;
+
+            uint32_t nameOffset, nameLength, nameHash, frameIndex;
+            if (entry < header->frameCount)
+            {
+                const auto& frame = frames[entry];
+                nameOffset = frame.nameOffset;
+                nameLength = frame.nameLength;
+                nameHash = frame.nameHash;
+                frameIndex = entry;
+            }
+            else if (entry - header->frameCount < header->aliasCount)
+            {
+                const auto& alias = aliases[entry - header->frameCount];
+                nameOffset = alias.nameOffset;
+                nameLength = alias.nameLength;
+                nameHash = alias.nameHash;
+                frameIndex = alias.frameIndex;
+            }
+            else
+            {
+                return -1;
+            }
+
+            if (nameHash == hash && nameLength == name.length() && (size_t)nameOffset + nameLength <= namesSize
+                && memcmp(names + nameOffset, name.c_str(), nameLength) == 0)
+            {
+                return frameIndex < header->frameCount ? static_cast<int>(frameIndex) : -1;
+            }
+        }
+        return -1;
+    }
+};
+
+// Reads the geometry of one frame of a plist, in any of the supported Zwoptex formats
+static void readFrameDictionary(ValueMap& frameDict, int format, Rect& rect, bool& rotated, Vec2& offset, Size& sourceSize)
+{
+    rotated = false;
+
+    if(format == 0) 
+    {
+        float x = frameDict["x"].asFloat();
+        float y = frameDict["y"].asFloat();
+        float w = frameDict["width"].asFloat();
+        float h = frameDict["height"].asFloat();
+        float ox = frameDict["offsetX"].asFloat();
+        float oy = frameDict["offsetY"].asFloat();
+        int ow = frameDict["originalWidth"].asInt();
+        int oh = frameDict["originalHeight"].asInt();
+        // check ow/oh
+        if(!ow || !oh)
+        {
+            CCLOGWARN("cocos2d: WARNING: originalWidth/Height not found on the SpriteFrame. AnchorPoint won't work as expected. Regenrate the .plist");
+        }
+        // abs ow/oh
+        ow = abs(ow);
+        oh = abs(oh);
+
+        rect = Rect(x, y, w, h);
+        offset = Vec2(ox, oy);
+        sourceSize = Size((float)ow, (float)oh);
+    } 
+    else if(format == 1 || format == 2) 
+    {
+        rect = RectFromString(frameDict["frame"].asString());
+
+        // rotation
+        if (format == 2)
+        {
+            rotated = frameDict["rotated"].asBool();
+        }
+
+        offset = PointFromString(frameDict["offset"].asString());
+        sourceSize = SizeFromString(frameDict["sourceSize"].asString());
+    } 
+    else if (format == 3)
+    {
+        Size spriteSize = SizeFromString(frameDict["spriteSize"].asString());
+        Rect textureRect = RectFromString(frameDict["textureRect"].asString());
+
+        rect = Rect(textureRect.origin.x, textureRect.origin.y, spriteSize.width, spriteSize.height);
+        rotated = frameDict["textureRotated"].asBool();
+        offset = PointFromString(frameDict["spriteOffset"].asString());
+        sourceSize = SizeFromString(frameDict["spriteSourceSize"].asString());
+    }
+}
+
 SpriteFrameCache* SpriteFrameCache::getInstance()
 {
     if (! _sharedSpriteFrameCache)
@@ -71,6 +335,10 @@ bool SpriteFrameCache::init(void)
 
 SpriteFrameCache::~SpriteFrameCache(void)
 {
+    for (auto sheet : _binarySheets)
+    {
+        delete sheet;
+    }
     CC_SAFE_DELETE(_loadedFileNames);
 }
 
@@ -109,65 +377,14 @@ void SpriteFrameCache::addSpriteFramesWithDictionary(ValueMap& dictionary, Textu
             continue;
         }
         
-        if(format == 0) 
-        {
-            float x = frameDict["x"].asFloat();
-            float y = frameDict["y"].asFloat();
-            float w = frameDict["width"].asFloat();
-            float h = frameDict["height"].asFloat();
-            float ox = frameDict["offsetX"].asFloat();
-            float oy = frameDict["offsetY"].asFloat();
-            int ow = frameDict["originalWidth"].asInt();
-            int oh = frameDict["originalHeight"].asInt();
-            // check ow/oh
-            if(!ow || !oh)
-            {
-                CCLOGWARN("cocos2d: WARNING: originalWidth/Height not found on the SpriteFrame. AnchorPoint won't work as expected. Regenrate the .plist");
-            }
-            // abs ow/oh
-            ow = abs(ow);
-            oh = abs(oh);
-            // create frame
-            spriteFrame = new SpriteFrame();
-            spriteFrame->initWithTexture(texture,
-                                        Rect(x, y, w, h), 
-                                        false,
-                                        Vec2(ox, oy),
-                                        Size((float)ow, (float)oh)
-                                        );
-        } 
-        else if(format == 1 || format == 2) 
-        {
-            Rect frame = RectFromString(frameDict["frame"].asString());
-            bool rotated = false;
-
-            // rotation
-            if (format == 2)
-            {
-                rotated = frameDict["rotated"].asBool();
-            }
-
-            Vec2 offset = PointFromString(frameDict["offset"].asString());
-            Size sourceSize = SizeFromString(frameDict["sourceSize"].asString());
-
-            // create frame
-            spriteFrame = new SpriteFrame();
-            spriteFrame->initWithTexture(texture,
-                frame,
-                rotated,
-                offset,
-                sourceSize
-                );
-        } 
-        else if (format == 3)
-        {
-            // get values
-            Size spriteSize = SizeFromString(frameDict["spriteSize"].asString());
-            Vec2 spriteOffset = PointFromString(frameDict["spriteOffset"].asString());
-            Size spriteSourceSize = SizeFromString(frameDict["spriteSourceSize"].asString());
-            Rect textureRect = RectFromString(frameDict["textureRect"].asString());
-            bool textureRotated = frameDict["textureRotated"].asBool();
+        Rect rect;
+        bool rotated;
+        Vec2 offset;
+        Size sourceSize;
+        readFrameDictionary(frameDict, format, rect, rotated, offset, sourceSize);
 
+        if (format == 3)
+        {
             // get aliases
             ValueVector& aliases = frameDict["aliases"].asValueVector();
 
@@ -180,16 +397,12 @@ void SpriteFrameCache::addSpriteFramesWithDictionary(ValueMap& dictionary, Textu
 
                 _spriteFramesAliases[oneAlias] = Value(spriteFrameName);
             }
-            
-            // create frame
-            spriteFrame = new SpriteFrame();
-            spriteFrame->initWithTexture(texture,
-                            Rect(textureRect.origin.x, textureRect.origin.y, spriteSize.width, spriteSize.height),
-                            textureRotated,
-                            spriteOffset,
-                            spriteSourceSize);
         }
 
+        // create frame
+        spriteFrame = new SpriteFrame();
+        spriteFrame->initWithTexture(texture, rect, rotated, offset, sourceSize);
+
         // add sprite frame
         _spriteFrames.insert(spriteFrameName, spriteFrame);
         spriteFrame->release();
@@ -199,6 +412,20 @@ void SpriteFrameCache::addSpriteFramesWithDictionary(ValueMap& dictionary, Textu
 void SpriteFrameCache::addSpriteFramesWithFile(const std::string& pszPlist, Texture2D *pobTexture)
 {
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(pszPlist);
+    if (isBinarySpriteFramesFile(pszPlist))
+    {
+        auto sheet = new BinarySheet();
+        if (sheet->open(fullPath))
+        {
+            addBinarySheet(sheet, pobTexture);
+        }
+        else
+        {
+            delete sheet;
+        }
+        return;
+    }
+
     ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
 
     addSpriteFramesWithDictionary(dict, pobTexture);
@@ -223,52 +450,106 @@ void SpriteFrameCache::addSpriteFramesWithFile(const std::string& pszPlist)
 {
     CCASSERT(pszPlist.size()>0, "plist filename should not be nullptr");
 
-    if (_loadedFileNames->find(pszPlist) == _loadedFileNames->end())
+    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(pszPlist);
+    if (_loadedFileNames->find(fullPath) == _loadedFileNames->end())
     {
-        std::string fullPath = FileUtils::getInstance()->fullPathForFilename(pszPlist);
-        ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
+        ValueMap dict;
+        std::string texturePath = readSpriteFramesFile(fullPath, dict);
+        if (texturePath.empty())
+        {
+            CCLOG("cocos2d: SpriteFrameCache: Couldn't load sprite sheet %s", pszPlist.c_str());
+            return;
+        }
 
-        string texturePath("");
+        Texture2D *texture = Director::getInstance()->getTextureCache()->addImage(texturePath.c_str());
 
-        if (dict.find("metadata") != dict.end())
+        if (texture)
         {
-            ValueMap& metadataDict = dict["metadata"].asValueMap();
-            // try to read  texture file name from meta data
-            texturePath = metadataDict["textureFileName"].asString();
+            addSpriteFramesWithFile(fullPath, dict, texture);
+        }
+        else
+        {
+            CCLOG("cocos2d: SpriteFrameCache: Couldn't load texture");
         }
+    }
+}
+
+std::string SpriteFrameCache::readSpriteFramesFile(const std::string& plist, ValueMap& dictionary)
+{
+    string texturePath("");
 
-        if (!texturePath.empty())
+    if (isBinarySpriteFramesFile(plist))
+    {
+        BinarySheet sheet;
+        if (!sheet.open(plist))
         {
-            // build texture path relative to plist file
-            texturePath = FileUtils::getInstance()->fullPathFromRelativeFile(texturePath.c_str(), pszPlist);
+            return "";
         }
-        else
+        texturePath = sheet.getTextureName();
+    }
+    else
+    {
+        dictionary = FileUtils::getInstance()->getValueMapFromFile(plist);
+        if (dictionary.empty())
         {
-            // build texture path by replacing file extension
-            texturePath = pszPlist;
+            return "";
+        }
+    }
+
+    if (dictionary.find("metadata") != dictionary.end())
+    {
+        ValueMap& metadataDict = dictionary["metadata"].asValueMap();
+        // try to read  texture file name from meta data
+        texturePath = metadataDict["textureFileName"].asString();
+    }
 
-            // remove .xxx
-            size_t startPos = texturePath.find_last_of("."); 
-            texturePath = texturePath.erase(startPos);
+    if (!texturePath.empty())
+    {
+        // build texture path relative to plist file
+        texturePath = FileUtils::getInstance()->fullPathFromRelativeFile(texturePath.c_str(), plist);
+    }
+    else
+    {
+        // build texture path by replacing file extension
+        texturePath = plist;
 
-            // append .png
-            texturePath = texturePath.append(".png");
+        // remove .xxx
+        size_t startPos = texturePath.find_last_of("."); 
+        texturePath = texturePath.erase(startPos);
 
-            CCLOG("cocos2d: SpriteFrameCache: Trying to use file %s as texture", texturePath.c_str());
-        }
+        // append .png
+        texturePath = texturePath.append(".png");
 
-        Texture2D *texture = Director::getInstance()->getTextureCache()->addImage(texturePath.c_str());
+        CCLOG("cocos2d: SpriteFrameCache: Trying to use file %s as texture", texturePath.c_str());
+    }
 
-        if (texture)
-        {
-            addSpriteFramesWithDictionary(dict, texture);
-            _loadedFileNames->insert(pszPlist);
-        }
-        else
+    return texturePath;
+}
+
+void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist, ValueMap& dictionary, Texture2D *texture)
+{
+    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
+    if (isBinarySpriteFramesFile(plist))
+    {
+        auto sheet = new BinarySheet();
+        if (!sheet->open(fullPath))
         {
-            CCLOG("cocos2d: SpriteFrameCache: Couldn't load texture");
+            CCLOG("cocos2d: SpriteFrameCache: Couldn't load binary sprite sheet %s", plist.c_str());
+            delete sheet;
+            return;
         }
+        addBinarySheet(sheet, texture);
+    }
+    else
+    {
+        addSpriteFramesWithDictionary(dictionary, texture);
     }
+    _loadedFileNames->insert(fullPath);
+}
+
+bool SpriteFrameCache::isSpriteFramesFileLoaded(const std::string& plist) const
+{
+    return _loadedFileNames->find(FileUtils::getInstance()->fullPathForFilename(plist)) != _loadedFileNames->end();
 }
 
 void SpriteFrameCache::addSpriteFrame(SpriteFrame* frame, const std::string& frameName)
@@ -281,6 +562,12 @@ void SpriteFrameCache::removeSpriteFrames()
     _spriteFrames.clear();
     _spriteFramesAliases.clear();
     _loadedFileNames->clear();
+
+    for (auto sheet : _binarySheets)
+    {
+        delete sheet;
+    }
+    _binarySheets.clear();
 }
 
 void SpriteFrameCache::removeUnusedSpriteFrames()
@@ -335,6 +622,17 @@ void SpriteFrameCache::removeSpriteFrameByName(const std::string& name)
 void SpriteFrameCache::removeSpriteFramesFromFile(const std::string& plist)
 {
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
+    if (isBinarySpriteFramesFile(plist))
+    {
+        auto sheet = getBinarySheet(fullPath);
+        if (sheet)
+        {
+            removeBinarySheet(sheet);
+        }
+        _loadedFileNames->erase(fullPath);
+        return;
+    }
+
     ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
     if (dict.empty())
     {
@@ -344,7 +642,7 @@ void SpriteFrameCache::removeSpriteFramesFromFile(const std::string& plist)
     removeSpriteFramesFromDictionary(dict);
 
     // remove it from the cache
-    set<string>::iterator ret = _loadedFileNames->find(plist);
+    set<string>::iterator ret = _loadedFileNames->find(fullPath);
     if (ret != _loadedFileNames->end())
     {
         _loadedFileNames->erase(ret);
@@ -382,6 +680,19 @@ void SpriteFrameCache::removeSpriteFramesFromTexture(Texture2D* texture)
     }
 
     _spriteFrames.erase(keysToRemove);
+
+    for (auto iter = _binarySheets.begin(); iter != _binarySheets.end();)
+    {
+        if ((*iter)->texture == texture)
+        {
+            delete *iter;
+            iter = _binarySheets.erase(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
 }
 
 SpriteFrame* SpriteFrameCache::getSpriteFrameByName(const std::string& name)
@@ -394,13 +705,233 @@ SpriteFrame* SpriteFrameCache::getSpriteFrameByName(const std::string& name)
         if (!key.empty())
         {
             frame = _spriteFrames.at(key);
-            if (!frame)
+        }
+
+        // the frames of the binary sprite sheets are created on first use
+        if (!frame && !_binarySheets.empty())
+        {
+            frame = createSpriteFrameFromBinarySheets(key.empty() ? name : key);
+        }
+
+        if (!frame && !key.empty())
+        {
+            CCLOG("cocos2d: SpriteFrameCache: Frame '%s' not found", name.c_str());
+        }
+    }
+    return frame;
+}
+
+void SpriteFrameCache::addBinarySheet(BinarySheet* sheet, Texture2D* texture)
+{
+    if (getBinarySheet(sheet->fullPath))
+    {
+        delete sheet;
+        return;
+    }
+
+    sheet->texture = texture;
+    CC_SAFE_RETAIN(texture);
+    _binarySheets.push_back(sheet);
+}
+
+SpriteFrameCache::BinarySheet* SpriteFrameCache::getBinarySheet(const std::string& fullPath) const
+{
+    for (auto sheet : _binarySheets)
+    {
+        if (sheet->fullPath == fullPath)
+        {
+            return sheet;
+        }
+    }
+    return nullptr;
+}
+
+void SpriteFrameCache::removeBinarySheet(BinarySheet* sheet)
+{
+    // removes the frames already created from the sheet
+    std::vector<std::string> keysToRemove;
+    std::string name;
+    for (uint32_t i = 0; i < sheet->header->frameCount; ++i)
+    {
+        if (sheet->getName(sheet->frames[i].nameOffset, sheet->frames[i].nameLength, name) && _spriteFrames.at(name))
+        {
+            keysToRemove.push_back(name);
+        }
+    }
+    _spriteFrames.erase(keysToRemove);
+
+    _binarySheets.erase(std::find(_binarySheets.begin(), _binarySheets.end(), sheet));
+    delete sheet;
+}
+
+SpriteFrame* SpriteFrameCache::createSpriteFrameFromBinarySheets(const std::string& name)
+{
+    for (auto sheet : _binarySheets)
+    {
+        int frameIndex = sheet->findFrame(name);
+        if (frameIndex < 0)
+        {
+            continue;
+        }
+
+        // name may be an alias of the frame
+        const auto& record = sheet->frames[frameIndex];
+        std::string frameName;
+        if (!sheet->getName(record.nameOffset, record.nameLength, frameName))
+        {
+            continue;
+        }
+        SpriteFrame* frame = _spriteFrames.at(frameName);
+        if (frame)
+        {
+            return frame;
+        }
+
+        frame = SpriteFrame::createWithTexture(sheet->texture,
+                                               Rect(record.x, record.y, record.width, record.height),
+                                               record.rotated != 0,
+                                               Vec2(record.offsetX, record.offsetY),
+                                               Size(record.sourceWidth, record.sourceHeight));
+        _spriteFrames.insert(frameName, frame);
+        return frame;
+    }
+    return nullptr;
+}
+
+bool SpriteFrameCache::writeBinarySpriteFramesFile(const std::string& plist, const std::string& binaryFile)
+{
+    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
+    ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
+    if (dict.find("frames") == dict.end())
+    {
+        CCLOG("cocos2d: SpriteFrameCache: %s has no frames", plist.c_str());
+        return false;
+    }
+
+    int format = 0;
+    std::string textureName;
+    if (dict.find("metadata") != dict.end())
+    {
+        ValueMap& metadataDict = dict["metadata"].asValueMap();
+        format = metadataDict["format"].asInt();
+        textureName = metadataDict["textureFileName"].asString();
+    }
+    if (format < 0 || format > 3)
+    {
+        CCLOG("cocos2d: SpriteFrameCache: format %d of %s is not supported", format, plist.c_str());
+        return false;
+    }
+
+    // sorted, so that the same plist always gives the same file
+    ValueMap& framesDict = dict["frames"].asValueMap();
+    std::vector<std::string> frameNames;
+    frameNames.reserve(framesDict.size());
+    for (const auto& item : framesDict)
+    {
+        frameNames.push_back(item.first);
+    }
+    std::sort(frameNames.begin(), frameNames.end());
+
+    std::string names;
+    std::vector<BinarySheetFrame> frames(frameNames.size());
+    std::vector<BinarySheetAlias> aliases;
+    for (size_t i = 0; i < frameNames.size(); ++i)
+    {
+        ValueMap& frameDict = framesDict[frameNames[i]].asValueMap();
+        Rect rect;
+        bool rotated;
+        Vec2 offset;
+        Size sourceSize;
+        readFrameDictionary(frameDict, format, rect, rotated, offset, sourceSize);
+
+        auto& frame = frames[i];
+        frame.nameOffset = static_cast<uint32_t>(names.size());
+        frame.nameLength = static_cast<uint32_t>(frameNames[i].length());
+        frame.nameHash = hashFrameName(frameNames[i].c_str(), frameNames[i].length());
+        frame.x = rect.origin.x;
+        frame.y = rect.origin.y;
+        frame.width = rect.size.width;
+        frame.height = rect.size.height;
+        frame.offsetX = offset.x;
+        frame.offsetY = offset.y;
+        frame.sourceWidth = sourceSize.width;
+        frame.sourceHeight = sourceSize.height;
+        frame.rotated = rotated ? 1 : 0;
+        names.append(frameNames[i]).push_back('\0');
+
+        if (format == 3)
+        {
+            for (const auto& value : frameDict["aliases"].asValueVector())
             {
-                CCLOG("cocos2d: SpriteFrameCache: Frame '%s' not found", name.c_str());
+                std::string aliasName = value.asString();
+                BinarySheetAlias alias;
+                alias.nameOffset = static_cast<uint32_t>(names.size());
+                alias.nameLength = static_cast<uint32_t>(aliasName.length());
+                alias.nameHash = hashFrameName(aliasName.c_str(), aliasName.length());
+                alias.frameIndex = static_cast<uint32_t>(i);
+                aliases.push_back(alias);
+                names.append(aliasName).push_back('\0');
             }
         }
     }
-    return frame;
+
+    BinarySheetHeader header;
+    memcpy(header.magic, BinarySheetMagic, sizeof(BinarySheetMagic));
+    header.version = BinarySheetVersion;
+    header.frameCount = static_cast<uint32_t>(frames.size());
+    header.aliasCount = static_cast<uint32_t>(aliases.size());
+    header.textureNameOffset = static_cast<uint32_t>(names.size());
+    header.textureNameLength = static_cast<uint32_t>(textureName.length());
+    names.append(textureName).push_back('\0');
+
+    // at most half full, so that the probe sequences stay short
+    uint32_t indexSize = 16;
+    while (indexSize < 2 * (frames.size() + aliases.size()))
+    {
+        indexSize *= 2;
+    }
+    header.indexSize = indexSize;
+    std::vector<uint32_t> index(indexSize, 0);
+    auto insertEntry = [&](uint32_t hash, uint32_t entry) {
+        uint32_t slot = hash & (indexSize - 1);
+        while (index[slot] != 0)
+        {
+            slot = (slot + 1) & (indexSize - 1);
+        }
+        index[slot] = entry + 1;
+    };
+    for (size_t i = 0; i < frames.size(); ++i)
+    {
+        insertEntry(frames[i].nameHash, static_cast<uint32_t>(i));
+    }
+    for (size_t i = 0; i < aliases.size(); ++i)
+    {
+        insertEntry(aliases[i].nameHash, static_cast<uint32_t>(frames.size() + i));
+    }
+
+    header.framesOffset = sizeof(BinarySheetHeader);
+    header.aliasesOffset = header.framesOffset + header.frameCount * sizeof(BinarySheetFrame);
+    header.indexOffset = header.aliasesOffset + header.aliasCount * sizeof(BinarySheetAlias);
+    header.namesOffset = header.indexOffset + indexSize * sizeof(uint32_t);
+
+    FILE* fp = fopen(binaryFile.c_str(), "wb");
+    if (!fp)
+    {
+        CCLOG("cocos2d: SpriteFrameCache: can't open %s for writing", binaryFile.c_str());
+        return false;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+    if (ok && !frames.empty())
+        ok = fwrite(frames.data(), sizeof(BinarySheetFrame), frames.size(), fp) == frames.size();
+    if (ok && !aliases.empty())
+        ok = fwrite(aliases.data(), sizeof(BinarySheetAlias), aliases.size(), fp) == aliases.size();
+    if (ok)
+        ok = fwrite(index.data(), sizeof(uint32_t), index.size(), fp) == index.size();
+    if (ok)
+        ok = fwrite(names.data(), 1, names.size(), fp) == names.size();
+    fclose(fp);
+
+    return ok;
 }
 
 NS_CC_END
@@ -33,6 +33,10 @@ THE SOFTWARE.
 /*
  * To create sprite frames and texture atlas, use this tool:
  * http://zwoptex.zwopple.com/
+ *
+ * The plist files can be compiled into binary sprite sheets (.sfb) with tools/spritesheet/plist2sfb.py
+ * or SpriteFrameCache::writeBinarySpriteFramesFile(). They are memory mapped and their frames are created
+ * on first use, through a name index hashed by the converter.
  */
 
 #include "2d/CCSpriteFrame.h"
@@ -42,6 +46,7 @@ THE SOFTWARE.
 #include "base/CCMap.h"
 
 #include <set>
+#include <vector>
 #include <string>
 
 NS_CC_BEGIN
@@ -85,7 +90,7 @@ public:
     bool init(void);
 
 public:
-    /** Adds multiple Sprite Frames from a plist file.
+    /** Adds multiple Sprite Frames from a plist file, or from a binary sprite sheet (.sfb).
      * A texture will be loaded automatically. The texture name will composed by replacing the .plist suffix with .png
      * If you want to use another texture, you should use the addSpriteFramesWithFile(const std::string& plist, const std::string& textureFileName) method.
      * @js addSpriteFrames
@@ -106,6 +111,25 @@ public:
      */
     void addSpriteFramesWithFile(const std::string&plist, Texture2D *texture);
 
+    /** Reads a plist file or a binary sprite sheet without adding its frames. It uses neither the search paths
+     * nor the cache, so it can be called from any thread, e.g. by ResourceLoader: plist must be a full path.
+     * The content of a plist file is returned in dictionary, it is left empty for a binary sprite sheet.
+     * @return the full path of the texture of the sheet, or an empty string if the file can't be read.
+     * @since v3.1
+     */
+    static std::string readSpriteFramesFile(const std::string& plist, ValueMap& dictionary);
+
+    /** Adds the frames of a file read by readSpriteFramesFile(), binary sprite sheets are opened again.
+     * The file is then known as loaded, like with addSpriteFramesWithFile(const std::string& plist).
+     * @since v3.1
+     */
+    void addSpriteFramesWithFile(const std::string& plist, ValueMap& dictionary, Texture2D *texture);
+
+    /** Returns true if the frames of the file were added by addSpriteFramesWithFile(const std::string& plist).
+     * @since v3.1
+     */
+    bool isSpriteFramesFileLoaded(const std::string& plist) const;
+
     /** Adds an sprite frame with a given name.
      If the name already exists, then the contents of the old name will be replaced with the new one.
      */
@@ -149,6 +173,12 @@ public:
      */
     SpriteFrame* getSpriteFrameByName(const std::string& name);
 
+    /** Compiles a plist file into a binary sprite sheet (.sfb), which loads much faster than the plist.
+     The same conversion is done offline by tools/spritesheet/plist2sfb.py.
+     @return true if the binary file was written.
+     */
+    static bool writeBinarySpriteFramesFile(const std::string& plist, const std::string& binaryFile);
+
     /** @deprecated use getSpriteFrameByName() instead */
     CC_DEPRECATED_ATTRIBUTE SpriteFrame* spriteFrameByName(const std::string&name) { return getSpriteFrameByName(name); }
 
@@ -162,10 +192,20 @@ private:
     */
     void removeSpriteFramesFromDictionary(ValueMap& dictionary);
 
+    struct BinarySheet;
+
+    /** Adds a binary sprite sheet. Its frames are created by getSpriteFrameByName() */
+    void addBinarySheet(BinarySheet* sheet, Texture2D *texture);
+    void removeBinarySheet(BinarySheet* sheet);
+    BinarySheet* getBinarySheet(const std::string& fullPath) const;
+    SpriteFrame* createSpriteFrameFromBinarySheets(const std::string& name);
+
 protected:
     Map<std::string, SpriteFrame*> _spriteFrames;
     ValueMap _spriteFramesAliases;
+    // the full paths of the loaded files
     std::set<std::string>*  _loadedFileNames;
+    std::vector<BinarySheet*> _binarySheets;
 };
 
 // end of sprite_nodes group
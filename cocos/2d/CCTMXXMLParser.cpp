@@ -35,11 +35,185 @@ THE SOFTWARE.
 #include "base/ZipUtils.h"
 #include "base/base64.h"
 #include "base/CCDirector.h"
+#include "base/CCThreadPool.h"
+#include "base/CCValueView.h"
 
 using namespace std;
 
 NS_CC_BEGIN
 
+/*
+ Map snapshots, written in the writable path when TMXMapInfo::setSnapshotCacheEnabled(true) was called.
+ They are named after the hash of the name of the tmx file, and store in the native byte order:
+
+    header      "CTMS", uint32 version, uint32 meta size, uint32 tiles size
+    meta        a map Value in the binary format of CCValueView.cpp: the hashes of the tmx file and of its
+                external tilesets, the map attributes, the tilesets, the layers and the object groups
+    tiles       the gids of the layers which have tiles, one layer after the other
+
+ A snapshot is ignored when one of the hashes doesn't match the files anymore, the next load rewrites it.
+ */
+static const char SNAPSHOT_MAGIC[4] = { 'C', 'T', 'M', 'S' };
+static const uint32_t SNAPSHOT_VERSION = 1;
+static const size_t SNAPSHOT_HEADER_SIZE = 16;
+
+bool TMXMapInfo::s_snapshotCacheEnabled = false;
+
+// 64 bits FNV-1a, as a string so that it fits in a Value
+static std::string hashBytes(const unsigned char* bytes, ssize_t size)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (ssize_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    char text[17];
+    snprintf(text, sizeof(text), "%08x%08x", (unsigned int)(hash >> 32), (unsigned int)hash);
+    return text;
+}
+
+static std::string hashFile(const std::string& fullPath)
+{
+    Data data = FileUtils::getInstance()->getDataFromFile(fullPath);
+    return data.isNull() ? "" : hashBytes(data.getBytes(), data.getSize());
+}
+
+// Reads the attributes passed by the SAX parser in place, instead of copying them into a ValueMap.
+// The conversions are the ones of Value.
+class TMXAttributes
+{
+public:
+    explicit TMXAttributes(const char **atts) : _atts(atts) {}
+
+    const char* find(const char* name) const
+    {
+        for (int i = 0; _atts && _atts[i]; i += 2)
+        {
+            if (strcmp(_atts[i], name) == 0)
+                return _atts[i + 1];
+        }
+        return nullptr;
+    }
+
+    std::string getString(const char* name) const
+    {
+        const char* value = find(name);
+        return value ? value : "";
+    }
+
+    int getInt(const char* name) const
+    {
+        const char* value = find(name);
+        return value ? atoi(value) : 0;
+    }
+
+    float getFloat(const char* name) const
+    {
+        const char* value = find(name);
+        return value ? (float)atof(value) : 0.0f;
+    }
+
+    bool getBool(const char* name, bool defaultValue) const
+    {
+        const char* value = find(name);
+        if (!value)
+            return defaultValue;
+        return strcmp(value, "0") != 0 && strcmp(value, "false") != 0;
+    }
+
+    // a null Value when the attribute is missing, like ValueMap::operator[]
+    Value getValue(const char* name) const
+    {
+        const char* value = find(name);
+        return value ? Value(value) : Value();
+    }
+
+private:
+    const char **_atts;
+};
+
+// Parses the "x,y x,y ..." points of polygons and polylines, the coordinates are truncated like atoi does
+static ValueVector parsePoints(const char* points, const Vec2& offset)
+{
+    ValueVector pointsArray;
+    pointsArray.reserve(10);
+
+    const char* p = points;
+    while (*p)
+    {
+        while (*p == ' ')
+            ++p;
+        if (!*p)
+            break;
+
+        ValueMap pointDict;
+        char* end = nullptr;
+        double x = strtod(p, &end);
+        if (end == p)
+            break;
+        pointDict["x"] = Value((int)x + (int)offset.x);
+        p = end;
+
+        if (*p == ',')
+        {
+            ++p;
+            double y = strtod(p, &end);
+            if (end != p)
+            {
+                pointDict["y"] = Value((int)y + (int)offset.y);
+                p = end;
+            }
+        }
+        // skip what can't be read up to the next point
+        while (*p && *p != ' ')
+            ++p;
+
+        pointsArray.push_back(Value(std::move(pointDict)));
+    }
+    return pointsArray;
+}
+
+// Decodes the base64 text of a layer in place, then inflates it or copies it into the tiles of the layer
+static void decodeLayerTiles(TMXLayerInfo* layer, int layerAttribs, std::string& encodedTiles)
+{
+    ssize_t tilesSize = (ssize_t)layer->_layerSize.width * (ssize_t)layer->_layerSize.height * sizeof(uint32_t);
+    unsigned char* encoded = encodedTiles.empty() ? nullptr : reinterpret_cast<unsigned char*>(&encodedTiles[0]);
+
+    int len = base64DecodeInto(encoded, (unsigned int)encodedTiles.size(), encoded, (unsigned int)encodedTiles.size());
+    if (len < 0)
+    {
+        CCLOG("cocos2d: TiledMap: decode data error");
+        return;
+    }
+
+    unsigned char* tiles = (unsigned char*)malloc(tilesSize);
+    ssize_t tilesLength = 0;
+    if (layerAttribs & (TMXLayerAttribGzip | TMXLayerAttribZlib))
+    {
+        tilesLength = ZipUtils::inflateMemoryToBuffer(encoded, len, tiles, tilesSize);
+        if (tilesLength < 0)
+        {
+            CCLOG("cocos2d: TiledMap: inflate data error");
+            free(tiles);
+            return;
+        }
+    }
+    else
+    {
+        tilesLength = std::min((ssize_t)len, tilesSize);
+        memcpy(tiles, encoded, tilesLength);
+    }
+
+    if (tilesLength != tilesSize)
+    {
+        CCLOG("cocos2d: TiledMap: layer %s has %d bytes of tiles instead of %d", layer->_name.c_str(), (int)tilesLength, (int)tilesSize);
+        memset(tiles + tilesLength, 0, tilesSize - tilesLength);
+    }
+
+    layer->_tiles = reinterpret_cast<uint32_t*>(tiles);
+}
+
 // implementation TMXLayerInfo
 TMXLayerInfo::TMXLayerInfo()
 : _name("")
@@ -142,6 +316,8 @@ void TMXMapInfo::internalInit(const std::string& tmxFileName, const std::string&
     _layerAttribs = TMXLayerAttribNone;
     _parentElement = TMXPropertyNone;
     _currentFirstGID = -1;
+    _pendingLayers.clear();
+    _externalTilesets.clear();
 }
 bool TMXMapInfo::initWithXML(const std::string& tmxString, const std::string& resourcePath)
 {
@@ -152,7 +328,30 @@ bool TMXMapInfo::initWithXML(const std::string& tmxString, const std::string& re
 bool TMXMapInfo::initWithTMXFile(const std::string& tmxFile)
 {
     internalInit(tmxFile, "");
-    return parseXMLFile(_TMXFileName.c_str());
+
+    if (!s_snapshotCacheEnabled)
+    {
+        return parseXMLFile(_TMXFileName.c_str());
+    }
+
+    Data tmxData = FileUtils::getInstance()->getDataFromFile(_TMXFileName);
+    if (tmxData.isNull())
+    {
+        return false;
+    }
+
+    std::string snapshotPath = getSnapshotPath(tmxFile);
+    if (loadSnapshot(snapshotPath, tmxData))
+    {
+        return true;
+    }
+
+    if (!parseXMLData((const char*)tmxData.getBytes(), tmxData.getSize()))
+    {
+        return false;
+    }
+    saveSnapshot(snapshotPath, tmxData);
+    return true;
 }
 
 TMXMapInfo::TMXMapInfo()
@@ -171,12 +370,27 @@ TMXMapInfo::~TMXMapInfo()
     CCLOGINFO("deallocing TMXMapInfo: %p", this);
 }
 
+void TMXMapInfo::setSnapshotCacheEnabled(bool enabled)
+{
+    s_snapshotCacheEnabled = enabled;
+}
+
+bool TMXMapInfo::isSnapshotCacheEnabled()
+{
+    return s_snapshotCacheEnabled;
+}
+
 bool TMXMapInfo::parseXMLString(const std::string& xmlString)
 {
     size_t len = xmlString.size();
     if (len <= 0)
         return false;
 
+    return parseXMLData(xmlString.c_str(), len);
+}
+
+bool TMXMapInfo::parseXMLData(const char* xmlData, size_t dataLength)
+{
     SAXParser parser;
 
     if (false == parser.init("UTF-8") )
@@ -186,7 +400,9 @@ bool TMXMapInfo::parseXMLString(const std::string& xmlString)
 
     parser.setDelegator(this);
 
-    return parser.parse(xmlString.c_str(), len);
+    bool ret = parser.parse(xmlData, dataLength);
+    decodePendingLayers();
+    return ret;
 }
 
 bool TMXMapInfo::parseXMLFile(const std::string& xmlFilename)
@@ -200,34 +416,78 @@ bool TMXMapInfo::parseXMLFile(const std::string& xmlFilename)
     
     parser.setDelegator(this);
 
-    return parser.parse(FileUtils::getInstance()->fullPathForFilename(xmlFilename).c_str());
+    bool ret = parser.parse(FileUtils::getInstance()->fullPathForFilename(xmlFilename).c_str());
+    decodePendingLayers();
+    return ret;
 }
 
+std::string TMXMapInfo::getReferencedFilePath(const std::string& fileName) const
+{
+    // the files are relative to the map file
+    if (_TMXFileName.find_last_of("/") != string::npos)
+    {
+        return _TMXFileName.substr(0, _TMXFileName.find_last_of("/") + 1) + fileName;
+    }
+    return _resources + (_resources.size() ? "/" : "") + fileName;
+}
+
+void TMXMapInfo::decodePendingLayers()
+{
+    if (_pendingLayers.empty())
+    {
+        return;
+    }
+
+    // the layers are independent, each one is decoded by a single thread
+    ThreadPool::getInstance()->parallelFor(_pendingLayers.size(), 1, [this](ssize_t begin, ssize_t end){
+        for (ssize_t i = begin; i < end; ++i)
+        {
+            PendingLayer& pending = _pendingLayers[i];
+            decodeLayerTiles(pending.layer, pending.layerAttribs, pending.encodedTiles);
+        }
+    });
+    _pendingLayers.clear();
+}
 
 // the XML parser calls here with all the elements
 void TMXMapInfo::startElement(void *ctx, const char *name, const char **atts)
 {    
     CC_UNUSED_PARAM(ctx);
     TMXMapInfo *tmxMapInfo = this;
-    std::string elementName = (char*)name;
-    ValueMap attributeDict;
-    if (atts && atts[0])
+    const char* elementName = name;
+    TMXAttributes attributes(atts);
+
+    // the most frequent element first, there is one per tile in the xml layers
+    if (strcmp(elementName, "tile") == 0)
     {
-        for(int i = 0; atts[i]; i += 2) 
+        if (tmxMapInfo->getParentElement() == TMXPropertyLayer)
+        {
+            TMXLayerInfo* layer = tmxMapInfo->getLayers().back();
+            Size layerSize = layer->_layerSize;
+            uint32_t gid = static_cast<uint32_t>(attributes.getInt("gid"));
+            int tilesAmount = layerSize.width*layerSize.height;
+            
+            if (_xmlTileIndex < tilesAmount)
+            {
+                layer->_tiles[_xmlTileIndex++] = gid;
+            }
+        }
+        else
         {
-            std::string key = (char*)atts[i];
-            std::string value = (char*)atts[i+1];
-            attributeDict.insert(std::make_pair(key, Value(value)));
+            TMXTilesetInfo* info = tmxMapInfo->getTilesets().back();
+            tmxMapInfo->setParentGID(info->_firstGid + attributes.getInt("id"));
+            tmxMapInfo->getTileProperties()[tmxMapInfo->getParentGID()] = Value(ValueMap());
+            tmxMapInfo->setParentElement(TMXPropertyTile);
         }
     }
-    if (elementName == "map")
+    else if (strcmp(elementName, "map") == 0)
     {
-        std::string version = attributeDict["version"].asString();
+        std::string version = attributes.getString("version");
         if ( version != "1.0")
         {
             CCLOG("cocos2d: TMXFormat: Unsupported TMX version: %s", version.c_str());
         }
-        std::string orientationStr = attributeDict["orientation"].asString();
+        std::string orientationStr = attributes.getString("orientation");
         if (orientationStr == "orthogonal")
             tmxMapInfo->setOrientation(TMXOrientationOrtho);
         else if (orientationStr  == "isometric")
@@ -238,36 +498,29 @@ void TMXMapInfo::startElement(void *ctx, const char *name, const char **atts)
             CCLOG("cocos2d: TMXFomat: Unsupported orientation: %d", tmxMapInfo->getOrientation());
 
         Size s;
-        s.width = attributeDict["width"].asFloat();
-        s.height = attributeDict["height"].asFloat();
+        s.width = attributes.getFloat("width");
+        s.height = attributes.getFloat("height");
         tmxMapInfo->setMapSize(s);
 
-        s.width = attributeDict["tilewidth"].asFloat();
-        s.height = attributeDict["tileheight"].asFloat();
+        s.width = attributes.getFloat("tilewidth");
+        s.height = attributes.getFloat("tileheight");
         tmxMapInfo->setTileSize(s);
 
         // The parent element is now "map"
         tmxMapInfo->setParentElement(TMXPropertyMap);
     } 
-    else if (elementName == "tileset") 
+    else if (strcmp(elementName, "tileset") == 0)
     {
         // If this is an external tileset then start parsing that
-        std::string externalTilesetFilename = attributeDict["source"].asString();
-        if (externalTilesetFilename != "")
+        std::string externalTilesetSource = attributes.getString("source");
+        if (externalTilesetSource != "")
         {
+            _externalTilesets.push_back(externalTilesetSource);
+
             // Tileset file will be relative to the map file. So we need to convert it to an absolute path
-            if (_TMXFileName.find_last_of("/") != string::npos)
-            {
-                string dir = _TMXFileName.substr(0, _TMXFileName.find_last_of("/") + 1);
-                externalTilesetFilename = dir + externalTilesetFilename;
-            }
-            else 
-            {
-                externalTilesetFilename = _resources + "/" + externalTilesetFilename;
-            }
-            externalTilesetFilename = FileUtils::getInstance()->fullPathForFilename(externalTilesetFilename.c_str());
+            std::string externalTilesetFilename = FileUtils::getInstance()->fullPathForFilename(getReferencedFilePath(externalTilesetSource));
             
-            _currentFirstGID = attributeDict["firstgid"].asInt();
+            _currentFirstGID = attributes.getInt("firstgid");
             if (_currentFirstGID < 0)
             {
                 _currentFirstGID = 0;
@@ -279,12 +532,12 @@ void TMXMapInfo::startElement(void *ctx, const char *name, const char **atts)
         else
         {
             TMXTilesetInfo *tileset = new TMXTilesetInfo();
-            tileset->_name = attributeDict["name"].asString();
+            tileset->_name = attributes.getString("name");
             
             if (_recordFirstGID)
             {
                 // unset before, so this is tmx file.
-                tileset->_firstGid = attributeDict["firstgid"].asInt();
+                tileset->_firstGid = attributes.getInt("firstgid");
                 
                 if (tileset->_firstGid < 0)
                 {
@@ -297,57 +550,34 @@ void TMXMapInfo::startElement(void *ctx, const char *name, const char **atts)
                 _currentFirstGID = 0;
             }
             
-            tileset->_spacing = attributeDict["spacing"].asInt();
-            tileset->_margin = attributeDict["margin"].asInt();
+            tileset->_spacing = attributes.getInt("spacing");
+            tileset->_margin = attributes.getInt("margin");
             Size s;
-            s.width = attributeDict["tilewidth"].asFloat();
-            s.height = attributeDict["tileheight"].asFloat();
+            s.width = attributes.getFloat("tilewidth");
+            s.height = attributes.getFloat("tileheight");
             tileset->_tileSize = s;
 
             tmxMapInfo->getTilesets().pushBack(tileset);
             tileset->release();
         }
     }
-    else if (elementName == "tile")
-    {
-        if (tmxMapInfo->getParentElement() == TMXPropertyLayer)
-        {
-            TMXLayerInfo* layer = tmxMapInfo->getLayers().back();
-            Size layerSize = layer->_layerSize;
-            uint32_t gid = static_cast<uint32_t>(attributeDict["gid"].asInt());
-            int tilesAmount = layerSize.width*layerSize.height;
-            
-            if (_xmlTileIndex < tilesAmount)
-            {
-                layer->_tiles[_xmlTileIndex++] = gid;
-            }
-        }
-        else
-        {
-            TMXTilesetInfo* info = tmxMapInfo->getTilesets().back();
-            tmxMapInfo->setParentGID(info->_firstGid + attributeDict["id"].asInt());
-            tmxMapInfo->getTileProperties()[tmxMapInfo->getParentGID()] = Value(ValueMap());
-            tmxMapInfo->setParentElement(TMXPropertyTile);
-        }
-    }
-    else if (elementName == "layer")
+    else if (strcmp(elementName, "layer") == 0)
     {
         TMXLayerInfo *layer = new TMXLayerInfo();
-        layer->_name = attributeDict["name"].asString();
+        layer->_name = attributes.getString("name");
 
         Size s;
-        s.width = attributeDict["width"].asFloat();
-        s.height = attributeDict["height"].asFloat();
+        s.width = attributes.getFloat("width");
+        s.height = attributes.getFloat("height");
         layer->_layerSize = s;
 
-        Value& visibleValue = attributeDict["visible"];
-        layer->_visible = visibleValue.isNull() ? true : visibleValue.asBool();
+        layer->_visible = attributes.getBool("visible", true);
 
-        Value& opacityValue = attributeDict["opacity"];
-        layer->_opacity = opacityValue.isNull() ? 255 : (unsigned char)(255.0f * opacityValue.asFloat());
+        const char* opacity = attributes.find("opacity");
+        layer->_opacity = opacity ? (unsigned char)(255.0f * (float)atof(opacity)) : 255;
 
-        float x = attributeDict["x"].asFloat();
-        float y = attributeDict["y"].asFloat();
+        float x = attributes.getFloat("x");
+        float y = attributes.getFloat("y");
         layer->_offset = Vec2(x,y);
 
         tmxMapInfo->getLayers().pushBack(layer);
@@ -357,13 +587,13 @@ void TMXMapInfo::startElement(void *ctx, const char *name, const char **atts)
         tmxMapInfo->setParentElement(TMXPropertyLayer);
 
     } 
-    else if (elementName == "objectgroup")
+    else if (strcmp(elementName, "objectgroup") == 0)
     {
         TMXObjectGroup *objectGroup = new TMXObjectGroup();
-        objectGroup->setGroupName(attributeDict["name"].asString());
+        objectGroup->setGroupName(attributes.getString("name"));
         Vec2 positionOffset;
-        positionOffset.x = attributeDict["x"].asFloat() * tmxMapInfo->getTileSize().width;
-        positionOffset.y = attributeDict["y"].asFloat() * tmxMapInfo->getTileSize().height;
+        positionOffset.x = attributes.getFloat("x") * tmxMapInfo->getTileSize().width;
+        positionOffset.y = attributes.getFloat("y") * tmxMapInfo->getTileSize().height;
         objectGroup->setPositionOffset(positionOffset);
 
         tmxMapInfo->getObjectGroups().pushBack(objectGroup);
@@ -373,27 +603,17 @@ void TMXMapInfo::startElement(void *ctx, const char *name, const char **atts)
         tmxMapInfo->setParentElement(TMXPropertyObjectGroup);
 
     }
-    else if (elementName == "image")
+    else if (strcmp(elementName, "image") == 0)
     {
         TMXTilesetInfo* tileset = tmxMapInfo->getTilesets().back();
 
         // build full path
-        std::string imagename = attributeDict["source"].asString();
-
-        if (_TMXFileName.find_last_of("/") != string::npos)
-        {
-            string dir = _TMXFileName.substr(0, _TMXFileName.find_last_of("/") + 1);
-            tileset->_sourceImage = dir + imagename;
-        }
-        else 
-        {
-            tileset->_sourceImage = _resources + (_resources.size() ? "/" : "") + imagename;
-        }
+        tileset->_sourceImage = getReferencedFilePath(attributes.getString("source"));
     } 
-    else if (elementName == "data")
+    else if (strcmp(elementName, "data") == 0)
     {
-        std::string encoding = attributeDict["encoding"].asString();
-        std::string compression = attributeDict["compression"].asString();
+        std::string encoding = attributes.getString("encoding");
+        std::string compression = attributes.getString("compression");
 
         if (encoding == "")
         {
@@ -429,7 +649,7 @@ void TMXMapInfo::startElement(void *ctx, const char *name, const char **atts)
         }
 
     } 
-    else if (elementName == "object")
+    else if (strcmp(elementName, "object") == 0)
     {
         TMXObjectGroup* objectGroup = tmxMapInfo->getObjectGroups().back();
 
@@ -442,55 +662,55 @@ void TMXMapInfo::startElement(void *ctx, const char *name, const char **atts)
         for(size_t i = 0; i < sizeof(array)/sizeof(array[0]); ++i )
         {
             const char* key = array[i];
-            Value value = attributeDict[key];
-            dict[key] = value;
+            dict[key] = attributes.getValue(key);
         }
 
         // But X and Y since they need special treatment
         // X
-        int x = attributeDict["x"].asInt();
+        int x = attributes.getInt("x");
         // Y
-        int y = attributeDict["y"].asInt();
+        int y = attributes.getInt("y");
         
-        Vec2 p(x + objectGroup->getPositionOffset().x, _mapSize.height * _tileSize.height - y  - objectGroup->getPositionOffset().x - attributeDict["height"].asInt());
+        int width = attributes.getInt("width");
+        int height = attributes.getInt("height");
+
+        Vec2 p(x + objectGroup->getPositionOffset().x, _mapSize.height * _tileSize.height - y  - objectGroup->getPositionOffset().x - height);
         p = CC_POINT_PIXELS_TO_POINTS(p);
         dict["x"] = Value(p.x);
         dict["y"] = Value(p.y);
-        
-        int width = attributeDict["width"].asInt();
-        int height = attributeDict["height"].asInt();
+
         Size s(width, height);
         s = CC_SIZE_PIXELS_TO_POINTS(s);
         dict["width"] = Value(s.width);
         dict["height"] = Value(s.height);
 
         // Add the object to the objectGroup
-        objectGroup->getObjects().push_back(Value(dict));
+        objectGroup->getObjects().push_back(Value(std::move(dict)));
 
          // The parent element is now "object"
          tmxMapInfo->setParentElement(TMXPropertyObject);
 
     } 
-    else if (elementName == "property")
+    else if (strcmp(elementName, "property") == 0)
     {
         if ( tmxMapInfo->getParentElement() == TMXPropertyNone ) 
         {
             CCLOG( "TMX tile map: Parent element is unsupported. Cannot add property named '%s' with value '%s'",
-                  attributeDict["name"].asString().c_str(), attributeDict["value"].asString().c_str() );
+                  attributes.getString("name").c_str(), attributes.getString("value").c_str() );
         } 
         else if ( tmxMapInfo->getParentElement() == TMXPropertyMap )
         {
             // The parent element is the map
-            Value value = attributeDict["value"];
-            std::string key = attributeDict["name"].asString();
+            Value value = attributes.getValue("value");
+            std::string key = attributes.getString("name");
             tmxMapInfo->getProperties().insert(std::make_pair(key, value));
         }
         else if ( tmxMapInfo->getParentElement() == TMXPropertyLayer )
         {
             // The parent element is the last layer
             TMXLayerInfo* layer = tmxMapInfo->getLayers().back();
-            Value value = attributeDict["value"];
-            std::string key = attributeDict["name"].asString();
+            Value value = attributes.getValue("value");
+            std::string key = attributes.getString("name");
             // Add the property to the layer
             layer->getProperties().insert(std::make_pair(key, value));
         }
@@ -498,8 +718,8 @@ void TMXMapInfo::startElement(void *ctx, const char *name, const char **atts)
         {
             // The parent element is the last object group
             TMXObjectGroup* objectGroup = tmxMapInfo->getObjectGroups().back();
-            Value value = attributeDict["value"];
-            std::string key = attributeDict["name"].asString();
+            Value value = attributes.getValue("value");
+            std::string key = attributes.getString("name");
             objectGroup->getProperties().insert(std::make_pair(key, value));
         }
         else if ( tmxMapInfo->getParentElement() == TMXPropertyObject )
@@ -508,105 +728,29 @@ void TMXMapInfo::startElement(void *ctx, const char *name, const char **atts)
             TMXObjectGroup* objectGroup = tmxMapInfo->getObjectGroups().back();
             ValueMap& dict = objectGroup->getObjects().rbegin()->asValueMap();
 
-            std::string propertyName = attributeDict["name"].asString();
-            dict[propertyName] = attributeDict["value"];
+            std::string propertyName = attributes.getString("name");
+            dict[propertyName] = attributes.getValue("value");
         }
         else if ( tmxMapInfo->getParentElement() == TMXPropertyTile ) 
         {
             ValueMap& dict = tmxMapInfo->getTileProperties().at(tmxMapInfo->getParentGID()).asValueMap();
 
-            std::string propertyName = attributeDict["name"].asString();
-            dict[propertyName] = attributeDict["value"];
+            std::string propertyName = attributes.getString("name");
+            dict[propertyName] = attributes.getValue("value");
         }
     }
-    else if (elementName == "polygon") 
+    else if (strcmp(elementName, "polygon") == 0 || strcmp(elementName, "polyline") == 0)
     {
-        // find parent object's dict and add polygon-points to it
+        // find parent object's dict and add polygon-points or polyline-points to it
         TMXObjectGroup* objectGroup = _objectGroups.back();
         ValueMap& dict = objectGroup->getObjects().rbegin()->asValueMap();
 
-        // get points value string
-        std::string value = attributeDict["points"].asString();
-        if (!value.empty())
+        // the points are a space-separated set of comma-separated x,y points
+        const char* points = attributes.find("points");
+        if (points && *points)
         {
-            ValueVector pointsArray;
-            pointsArray.reserve(10);
-
-            // parse points string into a space-separated set of points
-            stringstream pointsStream(value);
-            string pointPair;
-            while(std::getline(pointsStream, pointPair, ' '))
-            {
-                // parse each point combo into a comma-separated x,y point
-                stringstream pointStream(pointPair);
-                string xStr,yStr;
-                
-                ValueMap pointDict;
-
-                // set x
-                if(std::getline(pointStream, xStr, ','))
-                {
-                    int x = atoi(xStr.c_str()) + (int)objectGroup->getPositionOffset().x;
-                    pointDict["x"] = Value(x);
-                }
-
-                // set y
-                if(std::getline(pointStream, yStr, ','))
-                {
-                    int y = atoi(yStr.c_str()) + (int)objectGroup->getPositionOffset().y;
-                    pointDict["y"] = Value(y);
-                }
-                
-                // add to points array
-                pointsArray.push_back(Value(pointDict));
-            }
-            
-            dict["points"] = Value(pointsArray);
-        }
-    } 
-    else if (elementName == "polyline")
-    {
-        // find parent object's dict and add polyline-points to it
-        TMXObjectGroup* objectGroup = _objectGroups.back();
-        ValueMap& dict = objectGroup->getObjects().rbegin()->asValueMap();
-        
-        // get points value string
-        std::string value = attributeDict["points"].asString();
-        if (!value.empty())
-        {
-            ValueVector pointsArray;
-            pointsArray.reserve(10);
-            
-            // parse points string into a space-separated set of points
-            stringstream pointsStream(value);
-            string pointPair;
-            while(std::getline(pointsStream, pointPair, ' '))
-            {
-                // parse each point combo into a comma-separated x,y point
-                stringstream pointStream(pointPair);
-                string xStr,yStr;
-                
-                ValueMap pointDict;
-                
-                // set x
-                if(std::getline(pointStream, xStr, ','))
-                {
-                    int x = atoi(xStr.c_str()) + (int)objectGroup->getPositionOffset().x;
-                    pointDict["x"] = Value(x);
-                }
-                
-                // set y
-                if(std::getline(pointStream, yStr, ','))
-                {
-                    int y = atoi(yStr.c_str()) + (int)objectGroup->getPositionOffset().y;
-                    pointDict["y"] = Value(y);
-                }
-                
-                // add to points array
-                pointsArray.push_back(Value(pointDict));
-            }
-            
-            dict["polylinePoints"] = Value(pointsArray);
+            const char* key = strcmp(elementName, "polygon") == 0 ? "points" : "polylinePoints";
+            dict[key] = Value(parsePoints(points, objectGroup->getPositionOffset()));
         }
     }
 }
@@ -615,54 +759,22 @@ void TMXMapInfo::endElement(void *ctx, const char *name)
 {
     CC_UNUSED_PARAM(ctx);
     TMXMapInfo *tmxMapInfo = this;
-    std::string elementName = (char*)name;
-
-    int len = 0;
+    const char* elementName = name;
 
-    if(elementName == "data")
+    if(strcmp(elementName, "data") == 0)
     {
         if (tmxMapInfo->getLayerAttribs() & TMXLayerAttribBase64)
         {
             tmxMapInfo->setStoringCharacters(false);
-            
-            TMXLayerInfo* layer = tmxMapInfo->getLayers().back();
-            
-            std::string currentString = tmxMapInfo->getCurrentString();
-            unsigned char *buffer;
-            len = base64Decode((unsigned char*)currentString.c_str(), (unsigned int)currentString.length(), &buffer);
-            if( ! buffer )
-            {
-                CCLOG("cocos2d: TiledMap: decode data error");
-                return;
-            }
-            
-            if( tmxMapInfo->getLayerAttribs() & (TMXLayerAttribGzip | TMXLayerAttribZlib) )
-            {
-                unsigned char *deflated = nullptr;
-                Size s = layer->_layerSize;
-                // int sizeHint = s.width * s.height * sizeof(uint32_t);
-                ssize_t sizeHint = s.width * s.height * sizeof(unsigned int);
-                
-                ssize_t CC_UNUSED inflatedLen = ZipUtils::inflateMemoryWithHint(buffer, len, &deflated, sizeHint);
-                CCASSERT(inflatedLen == sizeHint, "");
-                
-                free(buffer);
-                buffer = nullptr;
-                
-                if( ! deflated )
-                {
-                    CCLOG("cocos2d: TiledMap: inflate data error");
-                    return;
-                }
-                
-                layer->_tiles = reinterpret_cast<uint32_t*>(deflated);
-            }
-            else
-            {
-                layer->_tiles = reinterpret_cast<uint32_t*>(buffer);
-            }
-            
-            tmxMapInfo->setCurrentString("");
+
+            // decoded once the whole map is read, the text is moved and never copied
+            PendingLayer pending;
+            pending.layer = tmxMapInfo->getLayers().back();
+            pending.layerAttribs = tmxMapInfo->getLayerAttribs();
+            pending.encodedTiles = std::move(_currentString);
+            _pendingLayers.push_back(std::move(pending));
+
+            _currentString.clear();
         }
         else if (tmxMapInfo->getLayerAttribs() & TMXLayerAttribNone)
         {
@@ -670,27 +782,27 @@ void TMXMapInfo::endElement(void *ctx, const char *name)
         }
 
     }
-    else if (elementName == "map")
+    else if (strcmp(elementName, "map") == 0)
     {
         // The map element has ended
         tmxMapInfo->setParentElement(TMXPropertyNone);
     }    
-    else if (elementName == "layer")
+    else if (strcmp(elementName, "layer") == 0)
     {
         // The layer element has ended
         tmxMapInfo->setParentElement(TMXPropertyNone);
     }
-    else if (elementName == "objectgroup")
+    else if (strcmp(elementName, "objectgroup") == 0)
     {
         // The objectgroup element has ended
         tmxMapInfo->setParentElement(TMXPropertyNone);
     } 
-    else if (elementName == "object") 
+    else if (strcmp(elementName, "object") == 0)
     {
         // The object element has ended
         tmxMapInfo->setParentElement(TMXPropertyNone);
     }
-    else if (elementName == "tileset")
+    else if (strcmp(elementName, "tileset") == 0)
     {
         _recordFirstGID = true;
     }
@@ -699,15 +811,244 @@ void TMXMapInfo::endElement(void *ctx, const char *name)
 void TMXMapInfo::textHandler(void *ctx, const char *ch, int len)
 {
     CC_UNUSED_PARAM(ctx);
-    TMXMapInfo *tmxMapInfo = this;
-    std::string text((char*)ch,0,len);
 
-    if (tmxMapInfo->isStoringCharacters())
+    if (isStoringCharacters())
+    {
+        _currentString.append(ch, len);
+    }
+}
+
+std::string TMXMapInfo::getSnapshotPath(const std::string& tmxFile) const
+{
+    return FileUtils::getInstance()->getWritablePath() + "tmx-snapshot-"
+        + hashBytes(reinterpret_cast<const unsigned char*>(tmxFile.c_str()), tmxFile.size()) + ".bin";
+}
+
+void TMXMapInfo::saveSnapshot(const std::string& snapshotPath, const Data& tmxData) const
+{
+    // the image paths are stored relative to the map, the absolute paths change between launches on some platforms
+    std::string mapDirectory = getReferencedFilePath("");
+
+    ValueVector externalTilesets;
+    for (const auto& source : _externalTilesets)
+    {
+        ValueMap externalTileset;
+        externalTileset["source"] = Value(source);
+        externalTileset["hash"] = Value(hashFile(FileUtils::getInstance()->fullPathForFilename(getReferencedFilePath(source))));
+        externalTilesets.push_back(Value(std::move(externalTileset)));
+    }
+
+    ValueVector tilesets;
+    for (const auto& tileset : _tilesets)
     {
-        std::string currentString = tmxMapInfo->getCurrentString();
-        currentString += text;
-        tmxMapInfo->setCurrentString(currentString.c_str());
+        bool relative = tileset->_sourceImage.compare(0, mapDirectory.size(), mapDirectory) == 0;
+        ValueMap dict;
+        dict["name"] = Value(tileset->_name);
+        dict["firstGid"] = Value(tileset->_firstGid);
+        dict["tileWidth"] = Value(tileset->_tileSize.width);
+        dict["tileHeight"] = Value(tileset->_tileSize.height);
+        dict["spacing"] = Value(tileset->_spacing);
+        dict["margin"] = Value(tileset->_margin);
+        dict["image"] = Value(relative ? tileset->_sourceImage.substr(mapDirectory.size()) : tileset->_sourceImage);
+        dict["imageRelative"] = Value(relative);
+        dict["imageWidth"] = Value(tileset->_imageSize.width);
+        dict["imageHeight"] = Value(tileset->_imageSize.height);
+        tilesets.push_back(Value(std::move(dict)));
+    }
+
+    ValueVector layers;
+    uint32_t tilesSize = 0;
+    for (const auto& layer : _layers)
+    {
+        uint32_t layerTilesSize = layer->_tiles ? (uint32_t)(layer->_layerSize.width * layer->_layerSize.height) * sizeof(uint32_t) : 0;
+        ValueMap dict;
+        dict["name"] = Value(layer->_name);
+        dict["width"] = Value(layer->_layerSize.width);
+        dict["height"] = Value(layer->_layerSize.height);
+        dict["visible"] = Value(layer->_visible);
+        dict["opacity"] = Value((int)layer->_opacity);
+        dict["offsetX"] = Value(layer->_offset.x);
+        dict["offsetY"] = Value(layer->_offset.y);
+        dict["properties"] = Value(layer->_properties);
+        dict["hasTiles"] = Value(layerTilesSize > 0);
+        layers.push_back(Value(std::move(dict)));
+        tilesSize += layerTilesSize;
+    }
+
+    ValueVector objectGroups;
+    for (const auto& objectGroup : _objectGroups)
+    {
+        ValueMap dict;
+        dict["name"] = Value(objectGroup->getGroupName());
+        dict["offsetX"] = Value(objectGroup->getPositionOffset().x);
+        dict["offsetY"] = Value(objectGroup->getPositionOffset().y);
+        dict["properties"] = Value(objectGroup->getProperties());
+        dict["objects"] = Value(objectGroup->getObjects());
+        objectGroups.push_back(Value(std::move(dict)));
+    }
+
+    ValueMap meta;
+    meta["hash"] = Value(hashBytes(tmxData.getBytes(), tmxData.getSize()));
+    meta["externalTilesets"] = Value(std::move(externalTilesets));
+    meta["orientation"] = Value(_orientation);
+    meta["mapWidth"] = Value(_mapSize.width);
+    meta["mapHeight"] = Value(_mapSize.height);
+    meta["tileWidth"] = Value(_tileSize.width);
+    meta["tileHeight"] = Value(_tileSize.height);
+    meta["layerAttribs"] = Value(_layerAttribs);
+    meta["properties"] = Value(_properties);
+    meta["tileProperties"] = Value(_tileProperties);
+    meta["tilesets"] = Value(std::move(tilesets));
+    meta["layers"] = Value(std::move(layers));
+    meta["objectGroups"] = Value(std::move(objectGroups));
+
+    Data metaData = ValueView::serialize(Value(std::move(meta)));
+    if (metaData.isNull())
+    {
+        return;
+    }
+
+    FILE* fp = fopen(snapshotPath.c_str(), "wb");
+    if (!fp)
+    {
+        CCLOG("cocos2d: TMXMapInfo: can't write the snapshot %s", snapshotPath.c_str());
+        return;
+    }
+
+    uint32_t header[3] = { SNAPSHOT_VERSION, (uint32_t)metaData.getSize(), tilesSize };
+    bool written = fwrite(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC), 1, fp) == 1
+        && fwrite(header, sizeof(header), 1, fp) == 1
+        && fwrite(metaData.getBytes(), metaData.getSize(), 1, fp) == 1;
+    for (const auto& layer : _layers)
+    {
+        if (written && layer->_tiles)
+        {
+            written = fwrite(layer->_tiles, (size_t)(layer->_layerSize.width * layer->_layerSize.height) * sizeof(uint32_t), 1, fp) == 1;
+        }
+    }
+    fclose(fp);
+
+    if (!written)
+    {
+        CCLOG("cocos2d: TMXMapInfo: can't write the snapshot %s", snapshotPath.c_str());
+        remove(snapshotPath.c_str());
+    }
+}
+
+bool TMXMapInfo::loadSnapshot(const std::string& snapshotPath, const Data& tmxData)
+{
+    auto fileUtils = FileUtils::getInstance();
+    if (!fileUtils->isFileExist(snapshotPath))
+    {
+        return false;
+    }
+
+    Data snapshot = fileUtils->getDataFromFile(snapshotPath);
+    const unsigned char* bytes = snapshot.getBytes();
+    uint32_t header[3];
+    if ((size_t)snapshot.getSize() < SNAPSHOT_HEADER_SIZE || memcmp(bytes, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0)
+    {
+        return false;
+    }
+    memcpy(header, bytes + sizeof(SNAPSHOT_MAGIC), sizeof(header));
+    if (header[0] != SNAPSHOT_VERSION || (size_t)snapshot.getSize() != SNAPSHOT_HEADER_SIZE + header[1] + header[2])
+    {
+        return false;
+    }
+
+    Data metaData;
+    metaData.copy(const_cast<unsigned char*>(bytes) + SNAPSHOT_HEADER_SIZE, header[1]);
+    ValueMap meta = ValueView::createWithData(std::move(metaData)).toValueMap();
+
+    // the snapshot is out of date once the map or one of its tilesets changed
+    if (meta["hash"].asString() != hashBytes(tmxData.getBytes(), tmxData.getSize()))
+    {
+        return false;
+    }
+    const ValueVector& externalTilesets = meta["externalTilesets"].asValueVector();
+    for (const auto& value : externalTilesets)
+    {
+        const ValueMap& externalTileset = value.asValueMap();
+        std::string fullPath = fileUtils->fullPathForFilename(getReferencedFilePath(externalTileset.at("source").asString()));
+        if (externalTileset.at("hash").asString() != hashFile(fullPath))
+        {
+            return false;
+        }
+    }
+
+    const ValueVector& layers = meta["layers"].asValueVector();
+    size_t tilesSize = 0;
+    for (const auto& value : layers)
+    {
+        const ValueMap& dict = value.asValueMap();
+        if (dict.at("hasTiles").asBool())
+        {
+            tilesSize += (size_t)(dict.at("width").asFloat() * dict.at("height").asFloat()) * sizeof(uint32_t);
+        }
+    }
+    if (tilesSize != header[2])
+    {
+        return false;
     }
+
+    _orientation = meta["orientation"].asInt();
+    _mapSize = Size(meta["mapWidth"].asFloat(), meta["mapHeight"].asFloat());
+    _tileSize = Size(meta["tileWidth"].asFloat(), meta["tileHeight"].asFloat());
+    _layerAttribs = meta["layerAttribs"].asInt();
+    _properties = meta["properties"].asValueMap();
+    _tileProperties = meta["tileProperties"].asIntKeyMap();
+
+    std::string mapDirectory = getReferencedFilePath("");
+    for (const auto& value : meta["tilesets"].asValueVector())
+    {
+        const ValueMap& dict = value.asValueMap();
+        TMXTilesetInfo *tileset = new TMXTilesetInfo();
+        tileset->_name = dict.at("name").asString();
+        tileset->_firstGid = dict.at("firstGid").asInt();
+        tileset->_tileSize = Size(dict.at("tileWidth").asFloat(), dict.at("tileHeight").asFloat());
+        tileset->_spacing = dict.at("spacing").asInt();
+        tileset->_margin = dict.at("margin").asInt();
+        tileset->_sourceImage = (dict.at("imageRelative").asBool() ? mapDirectory : "") + dict.at("image").asString();
+        tileset->_imageSize = Size(dict.at("imageWidth").asFloat(), dict.at("imageHeight").asFloat());
+        _tilesets.pushBack(tileset);
+        tileset->release();
+    }
+
+    const unsigned char* tiles = bytes + SNAPSHOT_HEADER_SIZE + header[1];
+    for (const auto& value : layers)
+    {
+        const ValueMap& dict = value.asValueMap();
+        TMXLayerInfo *layer = new TMXLayerInfo();
+        layer->_name = dict.at("name").asString();
+        layer->_layerSize = Size(dict.at("width").asFloat(), dict.at("height").asFloat());
+        layer->_visible = dict.at("visible").asBool();
+        layer->_opacity = (unsigned char)dict.at("opacity").asInt();
+        layer->_offset = Vec2(dict.at("offsetX").asFloat(), dict.at("offsetY").asFloat());
+        layer->_properties = dict.at("properties").asValueMap();
+        if (dict.at("hasTiles").asBool())
+        {
+            size_t layerTilesSize = (size_t)(layer->_layerSize.width * layer->_layerSize.height) * sizeof(uint32_t);
+            layer->_tiles = (uint32_t*)malloc(layerTilesSize);
+            memcpy(layer->_tiles, tiles, layerTilesSize);
+            tiles += layerTilesSize;
+        }
+        _layers.pushBack(layer);
+        layer->release();
+    }
+
+    for (const auto& value : meta["objectGroups"].asValueVector())
+    {
+        const ValueMap& dict = value.asValueMap();
+        TMXObjectGroup *objectGroup = new TMXObjectGroup();
+        objectGroup->setGroupName(dict.at("name").asString());
+        objectGroup->setPositionOffset(Vec2(dict.at("offsetX").asFloat(), dict.at("offsetY").asFloat()));
+        objectGroup->setProperties(dict.at("properties").asValueMap());
+        objectGroup->setObjects(dict.at("objects").asValueVector());
+        _objectGroups.pushBack(objectGroup);
+        objectGroup->release();
+    }
+
+    return true;
 }
 
 NS_CC_END
@@ -33,8 +33,10 @@ THE SOFTWARE.
 #include "2d/platform/CCSAXParser.h"
 #include "base/CCVector.h"
 #include "base/CCValue.h"
+#include "base/CCData.h"
 
 #include <string>
+#include <vector>
 
 NS_CC_BEGIN
 
@@ -194,6 +196,15 @@ public:
     /* initializes parsing of an XML string, either a tmx (Map) string or tsx (Tileset) string */
     bool parseXMLString(const std::string& xmlString);
 
+    /** Enables the snapshots of the maps loaded from files, disabled by default.
+     When enabled, the map read from a tmx file is written in the writable path in a binary form,
+     which the next loads of the file (including the ones of later launches) read instead of parsing
+     the XML and decoding the layers. A snapshot is only used while the tmx file and its external
+     tilesets are unchanged.
+     */
+    static void setSnapshotCacheEnabled(bool enabled);
+    static bool isSnapshotCacheEnabled();
+
     ValueMapIntKey& getTileProperties() { return _tileProperties; };
     void setTileProperties(const ValueMapIntKey& tileProperties) {
         _tileProperties = tileProperties;
@@ -280,6 +291,24 @@ public:
 
 protected:
     void internalInit(const std::string& tmxFileName, const std::string& resourcePath);
+    bool parseXMLData(const char* xmlData, size_t dataLength);
+    // full path of a file referenced by the map
+    std::string getReferencedFilePath(const std::string& fileName) const;
+
+    // decodes the base64 layers read by the parser, in parallel when there are several
+    void decodePendingLayers();
+
+    std::string getSnapshotPath(const std::string& tmxFile) const;
+    bool loadSnapshot(const std::string& snapshotPath, const Data& tmxData);
+    void saveSnapshot(const std::string& snapshotPath, const Data& tmxData) const;
+
+    // base64 layer data waiting for its decoding
+    struct PendingLayer
+    {
+        TMXLayerInfo* layer;
+        int layerAttribs;
+        std::string encodedTiles;
+    };
 
     /// map orientation
     int    _orientation;
@@ -316,6 +345,11 @@ protected:
     ValueMapIntKey _tileProperties;
     int _currentFirstGID;
     bool _recordFirstGID;
+    std::vector<PendingLayer> _pendingLayers;
+    //! source attributes of the external tilesets, for the snapshots
+    std::vector<std::string> _externalTilesets;
+
+    static bool s_snapshotCacheEnabled;
 };
 
 // end of tilemap_parallax_nodes group
@@ -44,6 +44,7 @@ THE SOFTWARE.
 #include "renderer/CCGLProgram.h"
 #include "renderer/ccGLStateCache.h"
 #include "renderer/CCGLProgramCache.h"
+#include "base/CCThreadPool.h"
 
 #include "deprecated/CCString.h"
 
@@ -52,8 +53,26 @@ THE SOFTWARE.
     #include "2d/CCTextureCache.h"
 #endif
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define CC_TEXTURE2D_USE_SSE2 1
+    #include <emmintrin.h>
+#elif defined(USE_NEON)
+    #define CC_TEXTURE2D_USE_NEON 1
+    #include <arm_neon.h>
+#endif
+
 NS_CC_BEGIN
 
+#if CC_TEXTURE2D_USE_SSE2
+// spreads the 4 RGB888 pixels of the 12 first bytes to 32 bits lanes, their high byte is the R of the next pixel
+static inline __m128i spreadRGB888(__m128i x)
+{
+    __m128i p01 = _mm_unpacklo_epi32(x, _mm_srli_si128(x, 3));
+    __m128i p23 = _mm_unpacklo_epi32(_mm_srli_si128(x, 6), _mm_srli_si128(x, 9));
+    return _mm_unpacklo_epi64(p01, p23);
+}
+#endif
+
 
 
 namespace {
@@ -122,6 +141,105 @@ static Texture2D::PixelFormat g_defaultAlphaPixelFormat = Texture2D::PixelFormat
 
 static bool _PVRHaveAlphaPremultiplied = false;
 
+static bool g_ditherEnabled = false;
+
+// frame in which each texture was last used, indexed by GL name.
+// Drivers hand out small names, larger ones aren't tracked and are treated as always in use
+static std::vector<unsigned int> s_lastUsedFrames;
+static const GLuint MAX_TRACKED_TEXTURE_NAME = 1 << 16;
+
+namespace {
+    // images with less pixels than this are converted on the calling thread
+    static const ssize_t PARALLEL_CONVERT_GRAIN = 64 * 1024;
+
+    typedef void (*ConvertFunction)(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
+
+    // The converter functions only work pixel by pixel, so the image is cut in pixel aligned
+    // ranges which are converted on the worker threads.
+    void parallelConvert(ConvertFunction convert, const unsigned char* data, ssize_t dataLen, int inBytesPerPixel, unsigned char* outData, int outBytesPerPixel)
+    {
+        ThreadPool::getInstance()->parallelFor(dataLen / inBytesPerPixel, PARALLEL_CONVERT_GRAIN, [=](ssize_t begin, ssize_t end){
+            convert(data + begin * inBytesPerPixel, (end - begin) * inBytesPerPixel, outData + begin * outBytesPerPixel);
+        });
+    }
+
+    // 4x4 Bayer matrix used by the ordered dithering
+    static const unsigned char BAYER_MATRIX[4][4] =
+    {
+        { 0,  8,  2, 10},
+        {12,  4, 14,  6},
+        { 3, 11,  1,  9},
+        {15,  7, 13,  5},
+    };
+
+    // adds the dither threshold to an 8 bit channel which is going to be truncated to `bits` bits
+    inline unsigned int ditherChannel(unsigned int value, int bits, unsigned int threshold)
+    {
+        value += (threshold << (8 - bits)) >> 4;
+        return value > 0xFF ? 0xFF : value;
+    }
+
+    // Converts RGB888/RGBA8888 data to a 16 bits format with ordered dithering.
+    // Returns false if the conversion is not supported, in that case nothing was written.
+    bool ditherDataToFormat(const unsigned char* data, ssize_t dataLen, Texture2D::PixelFormat originFormat, Texture2D::PixelFormat format, int pixelsWide, unsigned char** outData, ssize_t* outDataLen)
+    {
+        int inBytesPerPixel = 0;
+        if (originFormat == Texture2D::PixelFormat::RGBA8888)
+            inBytesPerPixel = 4;
+        else if (originFormat == Texture2D::PixelFormat::RGB888)
+            inBytesPerPixel = 3;
+
+        if (inBytesPerPixel == 0 || pixelsWide <= 0 ||
+            (format != Texture2D::PixelFormat::RGBA4444 && format != Texture2D::PixelFormat::RGB5A1 && format != Texture2D::PixelFormat::RGB565))
+        {
+            return false;
+        }
+
+        ssize_t pixels = dataLen / inBytesPerPixel;
+        ssize_t rows = pixels / pixelsWide;
+        *outDataLen = pixels * 2;
+        *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+
+        ThreadPool::getInstance()->parallelFor(rows, PARALLEL_CONVERT_GRAIN / pixelsWide + 1, [=](ssize_t beginRow, ssize_t endRow){
+            for (ssize_t y = beginRow; y < endRow; ++y)
+            {
+                const unsigned char* in = data + y * pixelsWide * inBytesPerPixel;
+                unsigned short* out16 = (unsigned short*)(*outData) + y * pixelsWide;
+                const unsigned char* bayerRow = BAYER_MATRIX[y & 3];
+
+                for (int x = 0; x < pixelsWide; ++x, in += inBytesPerPixel)
+                {
+                    unsigned int threshold = bayerRow[x & 3];
+                    unsigned int a = inBytesPerPixel == 4 ? in[3] : 0xFF;
+
+                    switch (format)
+                    {
+                    case Texture2D::PixelFormat::RGBA4444:
+                        *out16++ = (ditherChannel(in[0], 4, threshold) & 0xF0) << 8
+                            | (ditherChannel(in[1], 4, threshold) & 0xF0) << 4
+                            | (ditherChannel(in[2], 4, threshold) & 0xF0)
+                            | (ditherChannel(a, 4, threshold) & 0xF0) >> 4;
+                        break;
+                    case Texture2D::PixelFormat::RGB5A1:
+                        *out16++ = (ditherChannel(in[0], 5, threshold) & 0xF8) << 8
+                            | (ditherChannel(in[1], 5, threshold) & 0xF8) << 3
+                            | (ditherChannel(in[2], 5, threshold) & 0xF8) >> 2
+                            | (a & 0x80) >> 7;
+                        break;
+                    default:
+                        *out16++ = (ditherChannel(in[0], 5, threshold) & 0xF8) << 8
+                            | (ditherChannel(in[1], 6, threshold) & 0xFC) << 3
+                            | (ditherChannel(in[2], 5, threshold) & 0xF8) >> 3;
+                        break;
+                    }
+                }
+            }
+        });
+
+        return true;
+    }
+}
+
 //////////////////////////////////////////////////////////////////////////
 //conventer function
 
@@ -150,7 +268,32 @@ void Texture2D::convertAI88ToRGB888(const unsigned char* data, ssize_t dataLen,
 // IIIIIIII -> RRRRRRRRGGGGGGGGGBBBBBBBBAAAAAAAA
 void Texture2D::convertI8ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0; i < dataLen; ++i)
+    ssize_t i = 0;
+#if CC_TEXTURE2D_USE_SSE2
+    const __m128i alpha = _mm_set1_epi8((char)0xFF);
+    for (; i + 16 <= dataLen; i += 16, outData += 64)
+    {
+        __m128i x = _mm_loadu_si128((const __m128i*)(data + i));
+        // II and IA 16 bits pairs, interleaved to IIIA
+        __m128i ii = _mm_unpacklo_epi8(x, x);
+        __m128i ia = _mm_unpacklo_epi8(x, alpha);
+        _mm_storeu_si128((__m128i*)outData, _mm_unpacklo_epi16(ii, ia));
+        _mm_storeu_si128((__m128i*)(outData + 16), _mm_unpackhi_epi16(ii, ia));
+        ii = _mm_unpackhi_epi8(x, x);
+        ia = _mm_unpackhi_epi8(x, alpha);
+        _mm_storeu_si128((__m128i*)(outData + 32), _mm_unpacklo_epi16(ii, ia));
+        _mm_storeu_si128((__m128i*)(outData + 48), _mm_unpackhi_epi16(ii, ia));
+    }
+#elif CC_TEXTURE2D_USE_NEON
+    for (; i + 16 <= dataLen; i += 16, outData += 64)
+    {
+        uint8x16x4_t rgba;
+        rgba.val[0] = rgba.val[1] = rgba.val[2] = vld1q_u8(data + i);
+        rgba.val[3] = vdupq_n_u8(0xFF);
+        vst4q_u8(outData, rgba);
+    }
+#endif
+    for (; i < dataLen; ++i)
     {
         *outData++ = data[i];     //R
         *outData++ = data[i];     //G
@@ -162,7 +305,28 @@ void Texture2D::convertI8ToRGBA8888(const unsigned char* data, ssize_t dataLen,
 // IIIIIIIIAAAAAAAA -> RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA
 void Texture2D::convertAI88ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen - 1; i < l; i += 2)
+    ssize_t i = 0;
+#if CC_TEXTURE2D_USE_SSE2
+    const __m128i maskI = _mm_set1_epi16(0x00FF);
+    for (; i + 16 <= dataLen; i += 16, outData += 32)
+    {
+        __m128i x = _mm_loadu_si128((const __m128i*)(data + i));
+        // II 16 bits pairs, interleaved with the IA ones to IIIA
+        __m128i ii = _mm_or_si128(_mm_and_si128(x, maskI), _mm_slli_epi16(x, 8));
+        _mm_storeu_si128((__m128i*)outData, _mm_unpacklo_epi16(ii, x));
+        _mm_storeu_si128((__m128i*)(outData + 16), _mm_unpackhi_epi16(ii, x));
+    }
+#elif CC_TEXTURE2D_USE_NEON
+    for (; i + 32 <= dataLen; i += 32, outData += 64)
+    {
+        uint8x16x2_t ia = vld2q_u8(data + i);
+        uint8x16x4_t rgba;
+        rgba.val[0] = rgba.val[1] = rgba.val[2] = ia.val[0];
+        rgba.val[3] = ia.val[1];
+        vst4q_u8(outData, rgba);
+    }
+#endif
+    for (ssize_t l = dataLen - 1; i < l; i += 2)
     {
         *outData++ = data[i];     //R
         *outData++ = data[i];     //G
@@ -279,7 +443,30 @@ void Texture2D::convertAI88ToI8(const unsigned char* data, ssize_t dataLen, unsi
 // RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA
 void Texture2D::convertRGB888ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
+    ssize_t i = 0;
+#if CC_TEXTURE2D_USE_SSE2
+    const __m128i alpha = _mm_set1_epi32((int)0xFF000000);
+    // the second load reads 4 bytes past the 8 pixels
+    for (; i + 28 <= dataLen; i += 24, outData += 32)
+    {
+        __m128i x = spreadRGB888(_mm_loadu_si128((const __m128i*)(data + i)));
+        __m128i y = spreadRGB888(_mm_loadu_si128((const __m128i*)(data + i + 12)));
+        _mm_storeu_si128((__m128i*)outData, _mm_or_si128(x, alpha));
+        _mm_storeu_si128((__m128i*)(outData + 16), _mm_or_si128(y, alpha));
+    }
+#elif CC_TEXTURE2D_USE_NEON
+    for (; i + 48 <= dataLen; i += 48, outData += 64)
+    {
+        uint8x16x3_t rgb = vld3q_u8(data + i);
+        uint8x16x4_t rgba;
+        rgba.val[0] = rgb.val[0];
+        rgba.val[1] = rgb.val[1];
+        rgba.val[2] = rgb.val[2];
+        rgba.val[3] = vdupq_n_u8(0xFF);
+        vst4q_u8(outData, rgba);
+    }
+#endif
+    for (ssize_t l = dataLen - 2; i < l; i += 3)
     {
         *outData++ = data[i];         //R
         *outData++ = data[i + 1];     //G
@@ -303,7 +490,38 @@ void Texture2D::convertRGBA8888ToRGB888(const unsigned char* data, ssize_t dataL
 void Texture2D::convertRGB888ToRGB565(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
     unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
+    ssize_t i = 0;
+#if CC_TEXTURE2D_USE_SSE2
+    const __m128i maskR = _mm_set1_epi32(0xF8);
+    const __m128i maskG = _mm_set1_epi32(0xFC00);
+    const __m128i maskB = _mm_set1_epi32(0x1F);
+    // the second load reads 4 bytes past the 8 pixels
+    for (; i + 28 <= dataLen; i += 24, out16 += 8)
+    {
+        __m128i p[2];
+        for (int j = 0; j < 2; ++j)
+        {
+            __m128i x = spreadRGB888(_mm_loadu_si128((const __m128i*)(data + i + j * 12)));
+            __m128i v = _mm_slli_epi32(_mm_and_si128(x, maskR), 8);                  //R
+            v = _mm_or_si128(v, _mm_srli_epi32(_mm_and_si128(x, maskG), 5));         //G
+            v = _mm_or_si128(v, _mm_and_si128(_mm_srli_epi32(x, 19), maskB));        //B
+            // sign extend so that the saturating pack keeps the 16 bits untouched
+            p[j] = _mm_srai_epi32(_mm_slli_epi32(v, 16), 16);
+        }
+        _mm_storeu_si128((__m128i*)out16, _mm_packs_epi32(p[0], p[1]));
+    }
+#elif CC_TEXTURE2D_USE_NEON
+    for (; i + 24 <= dataLen; i += 24, out16 += 8)
+    {
+        uint8x8x3_t rgb = vld3_u8(data + i);
+        uint16x8_t r = vmovl_u8(vand_u8(rgb.val[0], vdup_n_u8(0xF8)));
+        uint16x8_t g = vmovl_u8(vand_u8(rgb.val[1], vdup_n_u8(0xFC)));
+        uint16x8_t b = vmovl_u8(rgb.val[2]);
+        uint16x8_t v = vorrq_u16(vshlq_n_u16(r, 8), vshlq_n_u16(g, 3));
+        vst1q_u16(out16, vorrq_u16(v, vshrq_n_u16(b, 3)));
+    }
+#endif
+    for (ssize_t l = dataLen - 2; i < l; i += 3)
     {
         *out16++ = (data[i] & 0x00F8) << 8    //R
             | (data[i + 1] & 0x00FC) << 3     //G
@@ -315,7 +533,37 @@ void Texture2D::convertRGB888ToRGB565(const unsigned char* data, ssize_t dataLen
 void Texture2D::convertRGBA8888ToRGB565(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
     unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
+    ssize_t i = 0;
+#if CC_TEXTURE2D_USE_SSE2
+    const __m128i maskR = _mm_set1_epi32(0xF8);
+    const __m128i maskG = _mm_set1_epi32(0xFC00);
+    const __m128i maskB = _mm_set1_epi32(0x1F);
+    for (; i + 32 <= dataLen; i += 32, out16 += 8)
+    {
+        __m128i p[2];
+        for (int j = 0; j < 2; ++j)
+        {
+            __m128i x = _mm_loadu_si128((const __m128i*)(data + i + j * 16));
+            __m128i v = _mm_slli_epi32(_mm_and_si128(x, maskR), 8);                  //R
+            v = _mm_or_si128(v, _mm_srli_epi32(_mm_and_si128(x, maskG), 5));         //G
+            v = _mm_or_si128(v, _mm_and_si128(_mm_srli_epi32(x, 19), maskB));        //B
+            // sign extend so that the saturating pack keeps the 16 bits untouched
+            p[j] = _mm_srai_epi32(_mm_slli_epi32(v, 16), 16);
+        }
+        _mm_storeu_si128((__m128i*)out16, _mm_packs_epi32(p[0], p[1]));
+    }
+#elif CC_TEXTURE2D_USE_NEON
+    for (; i + 32 <= dataLen; i += 32, out16 += 8)
+    {
+        uint8x8x4_t rgba = vld4_u8(data + i);
+        uint16x8_t r = vmovl_u8(vand_u8(rgba.val[0], vdup_n_u8(0xF8)));
+        uint16x8_t g = vmovl_u8(vand_u8(rgba.val[1], vdup_n_u8(0xFC)));
+        uint16x8_t b = vmovl_u8(rgba.val[2]);
+        uint16x8_t v = vorrq_u16(vshlq_n_u16(r, 8), vshlq_n_u16(g, 3));
+        vst1q_u16(out16, vorrq_u16(v, vshrq_n_u16(b, 3)));
+    }
+#endif
+    for (ssize_t l = dataLen - 3; i < l; i += 4)
     {
         *out16++ = (data[i] & 0x00F8) << 8    //R
             | (data[i + 1] & 0x00FC) << 3     //G
@@ -344,7 +592,28 @@ void Texture2D::convertRGBA8888ToI8(const unsigned char* data, ssize_t dataLen,
 // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> AAAAAAAA
 void Texture2D::convertRGBA8888ToA8(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen -3; i < l; i += 4)
+    ssize_t i = 0;
+#if CC_TEXTURE2D_USE_SSE2
+    for (; i + 64 <= dataLen; i += 64, outData += 16)
+    {
+        __m128i a[4];
+        for (int j = 0; j < 4; ++j)
+        {
+            a[j] = _mm_srli_epi32(_mm_loadu_si128((const __m128i*)(data + i + j * 16)), 24);
+        }
+        // values are in [0, 255] so the saturating packs are exact
+        __m128i a16 = _mm_packs_epi32(a[0], a[1]);
+        __m128i b16 = _mm_packs_epi32(a[2], a[3]);
+        _mm_storeu_si128((__m128i*)outData, _mm_packus_epi16(a16, b16));
+    }
+#elif CC_TEXTURE2D_USE_NEON
+    for (; i + 64 <= dataLen; i += 64, outData += 16)
+    {
+        uint8x16x4_t rgba = vld4q_u8(data + i);
+        vst1q_u8(outData, rgba.val[3]);
+    }
+#endif
+    for (ssize_t l = dataLen -3; i < l; i += 4)
     {
         *outData++ = data[i + 3]; //A
     }
@@ -375,7 +644,41 @@ void Texture2D::convertRGBA8888ToAI88(const unsigned char* data, ssize_t dataLen
 void Texture2D::convertRGB888ToRGBA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
     unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
+    ssize_t i = 0;
+#if CC_TEXTURE2D_USE_SSE2
+    const __m128i maskR = _mm_set1_epi32(0xF0);
+    const __m128i maskG = _mm_set1_epi32(0xF000);
+    const __m128i maskB = _mm_set1_epi32(0xF0);
+    const __m128i alpha = _mm_set1_epi32(0x0F);
+    // the second load reads 4 bytes past the 8 pixels
+    for (; i + 28 <= dataLen; i += 24, out16 += 8)
+    {
+        __m128i p[2];
+        for (int j = 0; j < 2; ++j)
+        {
+            __m128i x = spreadRGB888(_mm_loadu_si128((const __m128i*)(data + i + j * 12)));
+            __m128i v = _mm_slli_epi32(_mm_and_si128(x, maskR), 8);                  //R
+            v = _mm_or_si128(v, _mm_srli_epi32(_mm_and_si128(x, maskG), 4));         //G
+            v = _mm_or_si128(v, _mm_and_si128(_mm_srli_epi32(x, 16), maskB));        //B
+            v = _mm_or_si128(v, alpha);                                              //A
+            // sign extend so that the saturating pack keeps the 16 bits untouched
+            p[j] = _mm_srai_epi32(_mm_slli_epi32(v, 16), 16);
+        }
+        _mm_storeu_si128((__m128i*)out16, _mm_packs_epi32(p[0], p[1]));
+    }
+#elif CC_TEXTURE2D_USE_NEON
+    for (; i + 24 <= dataLen; i += 24, out16 += 8)
+    {
+        uint8x8x3_t rgb = vld3_u8(data + i);
+        uint8x8_t mask = vdup_n_u8(0xF0);
+        uint16x8_t r = vmovl_u8(vand_u8(rgb.val[0], mask));
+        uint16x8_t g = vmovl_u8(vand_u8(rgb.val[1], mask));
+        uint16x8_t b = vmovl_u8(vand_u8(rgb.val[2], mask));
+        uint16x8_t v = vorrq_u16(vshlq_n_u16(r, 8), vshlq_n_u16(g, 4));
+        vst1q_u16(out16, vorrq_u16(vorrq_u16(v, b), vdupq_n_u16(0x000F)));
+    }
+#endif
+    for (ssize_t l = dataLen - 2; i < l; i += 3)
     {
         *out16++ = ((data[i] & 0x00F0) << 8           //R
                     | (data[i + 1] & 0x00F0) << 4     //G
@@ -388,7 +691,40 @@ void Texture2D::convertRGB888ToRGBA4444(const unsigned char* data, ssize_t dataL
 void Texture2D::convertRGBA8888ToRGBA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
     unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
+    ssize_t i = 0;
+#if CC_TEXTURE2D_USE_SSE2
+    const __m128i maskR = _mm_set1_epi32(0xF0);
+    const __m128i maskG = _mm_set1_epi32(0xF000);
+    const __m128i maskB = _mm_set1_epi32(0xF0);
+    for (; i + 32 <= dataLen; i += 32, out16 += 8)
+    {
+        __m128i p[2];
+        for (int j = 0; j < 2; ++j)
+        {
+            __m128i x = _mm_loadu_si128((const __m128i*)(data + i + j * 16));
+            __m128i v = _mm_slli_epi32(_mm_and_si128(x, maskR), 8);                  //R
+            v = _mm_or_si128(v, _mm_srli_epi32(_mm_and_si128(x, maskG), 4));         //G
+            v = _mm_or_si128(v, _mm_and_si128(_mm_srli_epi32(x, 16), maskB));        //B
+            v = _mm_or_si128(v, _mm_srli_epi32(x, 28));                              //A
+            // sign extend so that the saturating pack keeps the 16 bits untouched
+            p[j] = _mm_srai_epi32(_mm_slli_epi32(v, 16), 16);
+        }
+        _mm_storeu_si128((__m128i*)out16, _mm_packs_epi32(p[0], p[1]));
+    }
+#elif CC_TEXTURE2D_USE_NEON
+    for (; i + 32 <= dataLen; i += 32, out16 += 8)
+    {
+        uint8x8x4_t rgba = vld4_u8(data + i);
+        uint8x8_t mask = vdup_n_u8(0xF0);
+        uint16x8_t r = vmovl_u8(vand_u8(rgba.val[0], mask));
+        uint16x8_t g = vmovl_u8(vand_u8(rgba.val[1], mask));
+        uint16x8_t b = vmovl_u8(vand_u8(rgba.val[2], mask));
+        uint16x8_t a = vmovl_u8(vshr_n_u8(rgba.val[3], 4));
+        uint16x8_t v = vorrq_u16(vshlq_n_u16(r, 8), vshlq_n_u16(g, 4));
+        vst1q_u16(out16, vorrq_u16(vorrq_u16(v, b), a));
+    }
+#endif
+    for (ssize_t l = dataLen - 3; i < l; i += 4)
     {
         *out16++ = (data[i] & 0x00F0) << 8    //R
         | (data[i + 1] & 0x00F0) << 4         //G
@@ -414,7 +750,40 @@ void Texture2D::convertRGB888ToRGB5A1(const unsigned char* data, ssize_t dataLen
 void Texture2D::convertRGBA8888ToRGB5A1(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
     unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 4)
+    ssize_t i = 0;
+#if CC_TEXTURE2D_USE_SSE2
+    const __m128i maskR = _mm_set1_epi32(0xF8);
+    const __m128i maskG = _mm_set1_epi32(0xF800);
+    const __m128i maskB = _mm_set1_epi32(0x3E);
+    for (; i + 32 <= dataLen; i += 32, out16 += 8)
+    {
+        __m128i p[2];
+        for (int j = 0; j < 2; ++j)
+        {
+            __m128i x = _mm_loadu_si128((const __m128i*)(data + i + j * 16));
+            __m128i v = _mm_slli_epi32(_mm_and_si128(x, maskR), 8);                  //R
+            v = _mm_or_si128(v, _mm_srli_epi32(_mm_and_si128(x, maskG), 5));         //G
+            v = _mm_or_si128(v, _mm_and_si128(_mm_srli_epi32(x, 18), maskB));        //B
+            v = _mm_or_si128(v, _mm_srli_epi32(x, 31));                              //A
+            // sign extend so that the saturating pack keeps the 16 bits untouched
+            p[j] = _mm_srai_epi32(_mm_slli_epi32(v, 16), 16);
+        }
+        _mm_storeu_si128((__m128i*)out16, _mm_packs_epi32(p[0], p[1]));
+    }
+#elif CC_TEXTURE2D_USE_NEON
+    for (; i + 32 <= dataLen; i += 32, out16 += 8)
+    {
+        uint8x8x4_t rgba = vld4_u8(data + i);
+        uint8x8_t mask = vdup_n_u8(0xF8);
+        uint16x8_t r = vmovl_u8(vand_u8(rgba.val[0], mask));
+        uint16x8_t g = vmovl_u8(vand_u8(rgba.val[1], mask));
+        uint16x8_t b = vmovl_u8(vand_u8(rgba.val[2], mask));
+        uint16x8_t a = vmovl_u8(vshr_n_u8(rgba.val[3], 7));
+        uint16x8_t v = vorrq_u16(vshlq_n_u16(r, 8), vshlq_n_u16(g, 3));
+        vst1q_u16(out16, vorrq_u16(vorrq_u16(v, vshrq_n_u16(b, 2)), a));
+    }
+#endif
+    for (ssize_t l = dataLen - 2; i < l; i += 4)
     {
         *out16++ = (data[i] & 0x00F8) << 8    //R
             | (data[i + 1] & 0x00F8) << 3     //G
@@ -474,6 +843,28 @@ GLuint Texture2D::getName() const
     return _name;
 }
 
+unsigned int Texture2D::getLastUsedFrame() const
+{
+    if (_name < s_lastUsedFrames.size())
+    {
+        return s_lastUsedFrames[_name];
+    }
+    return Director::getInstance()->getTotalFrames();
+}
+
+void Texture2D::markUsed(GLuint name)
+{
+    if (name >= MAX_TRACKED_TEXTURE_NAME)
+    {
+        return;
+    }
+    if (name >= s_lastUsedFrames.size())
+    {
+        s_lastUsedFrames.resize(name + 1, 0);
+    }
+    s_lastUsedFrames[name] = Director::getInstance()->getTotalFrames();
+}
+
 Size Texture2D::getContentSize() const
 {
     Size ret;
@@ -610,6 +1001,7 @@ bool Texture2D::initWithMipmaps(MipmapInfo* mipmaps, int mipmapsNum, PixelFormat
 
     glGenTextures(1, &_name);
     GL::bindTexture2D(_name);
+    markUsed(_name);
 
     if (mipmapsNum == 1)
     {
@@ -773,7 +1165,10 @@ bool Texture2D::initWithImage(Image *image, PixelFormat format)
         unsigned char* outTempData = nullptr;
         ssize_t outTempDataLen = 0;
 
-        pixelFormat = convertDataToFormat(tempData, tempDataLen, renderFormat, pixelFormat, &outTempData, &outTempDataLen);
+        if (!g_ditherEnabled || !ditherDataToFormat(tempData, tempDataLen, renderFormat, pixelFormat, imageWidth, &outTempData, &outTempDataLen))
+        {
+            pixelFormat = convertDataToFormat(tempData, tempDataLen, renderFormat, pixelFormat, &outTempData, &outTempDataLen);
+        }
 
         initWithData(outTempData, outTempDataLen, pixelFormat, imageWidth, imageHeight, imageSize);
 
@@ -810,32 +1205,32 @@ Texture2D::PixelFormat Texture2D::convertI8ToFormat(const unsigned char* data, s
     case PixelFormat::RGBA8888:
         *outDataLen = dataLen*4;
         *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
-        convertI8ToRGBA8888(data, dataLen, *outData);
+        parallelConvert(convertI8ToRGBA8888, data, dataLen, 1, *outData, 4);
         break;
     case PixelFormat::RGB888:
         *outDataLen = dataLen*3;
         *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
-        convertI8ToRGB888(data, dataLen, *outData);
+        parallelConvert(convertI8ToRGB888, data, dataLen, 1, *outData, 3);
         break;
     case PixelFormat::RGB565:
         *outDataLen = dataLen*2;
         *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
-        convertI8ToRGB565(data, dataLen, *outData);
+        parallelConvert(convertI8ToRGB565, data, dataLen, 1, *outData, 2);
         break;
     case PixelFormat::AI88:
         *outDataLen = dataLen*2;
         *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
-        convertI8ToAI88(data, dataLen, *outData);
+        parallelConvert(convertI8ToAI88, data, dataLen, 1, *outData, 2);
         break;
     case PixelFormat::RGBA4444:
         *outDataLen = dataLen*2;
         *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
-        convertI8ToRGBA4444(data, dataLen, *outData);
+        parallelConvert(convertI8ToRGBA4444, data, dataLen, 1, *outData, 2);
         break;
     case PixelFormat::RGB5A1:
         *outDataLen = dataLen*2;
         *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
-        convertI8ToRGB5A1(data, dataLen, *outData);
+        parallelConvert(convertI8ToRGB5A1, data, dataLen, 1, *outData, 2);
         break;
     default:
         // unsupport convertion or don't need to convert
@@ -859,37 +1254,37 @@ Texture2D::PixelFormat Texture2D::convertAI88ToFormat(const unsigned char* data,
     case PixelFormat::RGBA8888:
         *outDataLen = dataLen*2;
         *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
-        convertAI88ToRGBA8888(data, dataLen, *outData);
+        parallelConvert(convertAI88ToRGBA8888, data, dataLen, 2, *outData, 4);
         break;
     case PixelFormat::RGB888:
         *outDataLen = dataLen/2*3;
         *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
-        convertAI88ToRGB888(data, dataLen, *outData);
+        parallelConvert(convertAI88ToRGB888, data, dataLen, 2, *outData, 3);
         break;
     case PixelFormat::RGB565:
         *outDataLen = dataLen;
         *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
-        convertAI88ToRGB565(data, dataLen, *outData);
+        parallelConvert(convertAI88ToRGB565, data, dataLen, 2, *outData, 2);
         break;
     case PixelFormat::A8:
         *outDataLen = dataLen/2;
         *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
-        convertAI88ToA8(data, dataLen, *outData);
+        parallelConvert(convertAI88ToA8, data, dataLen, 2, *outData, 1);
         break;
     case PixelFormat::I8:
         *outDataLen = dataLen/2;
         *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
-        convertAI88ToI8(data, dataLen, *outData);
+        parallelConvert(convertAI88ToI8, data, dataLen, 2, *outData, 1);
         break;
     case PixelFormat::RGBA4444:
         *outDataLen = dataLen;
         *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
-        convertAI88ToRGBA4444(data, dataLen, *outData);
+        parallelConvert(convertAI88ToRGBA4444, data, dataLen, 2, *outData, 2);
         break;
     case PixelFormat::RGB5A1:
         *outDataLen = dataLen;
         *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
-        convertAI88ToRGB5A1(data, dataLen, *outData);
+        parallelConvert(convertAI88ToRGB5A1, data, dataLen, 2, *outData, 2);
         break;
     default:
         // unsupport convertion or don't need to convert
@@ -914,32 +1309,32 @@ Texture2D::PixelFormat Texture2D::convertRGB888ToFormat(const unsigned char* dat
     case PixelFormat::RGBA8888:
         *outDataLen = dataLen/3*4;
         *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
-        convertRGB888ToRGBA8888(data, dataLen, *outData);
+        parallelConvert(convertRGB888ToRGBA8888, data, dataLen, 3, *outData, 4);
         break;
     case PixelFormat::RGB565:
         *outDataLen = dataLen/3*2;
         *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
-        convertRGB888ToRGB565(data, dataLen, *outData);
+        parallelConvert(convertRGB888ToRGB565, data, dataLen, 3, *outData, 2);
         break;
     case PixelFormat::I8:
         *outDataLen = dataLen/3;
         *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
-        convertRGB888ToI8(data, dataLen, *outData);
+        parallelConvert(convertRGB888ToI8, data, dataLen, 3, *outData, 1);
         break;
     case PixelFormat::AI88:
         *outDataLen = dataLen/3*2;
         *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
-        convertRGB888ToAI88(data, dataLen, *outData);
+        parallelConvert(convertRGB888ToAI88, data, dataLen, 3, *outData, 2);
         break;
     case PixelFormat::RGBA4444:
         *outDataLen = dataLen/3*2;
         *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
-        convertRGB888ToRGBA4444(data, dataLen, *outData);
+        parallelConvert(convertRGB888ToRGBA4444, data, dataLen, 3, *outData, 2);
         break;
     case PixelFormat::RGB5A1:
         *outDataLen = dataLen;
         *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
-        convertRGB888ToRGB5A1(data, dataLen, *outData);
+        parallelConvert(convertRGB888ToRGB5A1, data, dataLen, 3, *outData, 2);
         break;
     default:
         // unsupport convertion or don't need to convert
@@ -963,37 +1358,37 @@ Texture2D::PixelFormat Texture2D::convertRGBA8888ToFormat(const unsigned char* d
     case PixelFormat::RGB888:
         *outDataLen = dataLen/4*3;
         *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
-        convertRGBA8888ToRGB888(data, dataLen, *outData);
+        parallelConvert(convertRGBA8888ToRGB888, data, dataLen, 4, *outData, 3);
         break;
     case PixelFormat::RGB565:
         *outDataLen = dataLen/2;
         *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
-        convertRGBA8888ToRGB565(data, dataLen, *outData);
+        parallelConvert(convertRGBA8888ToRGB565, data, dataLen, 4, *outData, 2);
         break;
     case PixelFormat::A8:
         *outDataLen = dataLen/4;
         *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
-        convertRGBA8888ToA8(data, dataLen, *outData);
+        parallelConvert(convertRGBA8888ToA8, data, dataLen, 4, *outData, 1);
         break;
     case PixelFormat::I8:
         *outDataLen = dataLen/4;
         *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
-        convertRGBA8888ToI8(data, dataLen, *outData);
+        parallelConvert(convertRGBA8888ToI8, data, dataLen, 4, *outData, 1);
         break;
     case PixelFormat::AI88:
         *outDataLen = dataLen/2;
         *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
-        convertRGBA8888ToAI88(data, dataLen, *outData);
+        parallelConvert(convertRGBA8888ToAI88, data, dataLen, 4, *outData, 2);
         break;
     case PixelFormat::RGBA4444:
         *outDataLen = dataLen/2;
         *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
-        convertRGBA8888ToRGBA4444(data, dataLen, *outData);
+        parallelConvert(convertRGBA8888ToRGBA4444, data, dataLen, 4, *outData, 2);
         break;
     case PixelFormat::RGB5A1:
         *outDataLen = dataLen/2;
         *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
-        convertRGBA8888ToRGB5A1(data, dataLen, *outData);
+        parallelConvert(convertRGBA8888ToRGB5A1, data, dataLen, 4, *outData, 2);
         break;
     default:
         // unsupport convertion or don't need to convert
@@ -1047,6 +1442,51 @@ Texture2D::PixelFormat Texture2D::convertDataToFormat(const unsigned char* data,
     }
 }
 
+bool Texture2D::convertDataToFormat(const unsigned char* data, ssize_t dataLen, PixelFormat originFormat, PixelFormat format, unsigned char* outData)
+{
+    ConvertFunction convert = nullptr;
+    int inBytesPerPixel = 0;
+
+    if (originFormat == PixelFormat::RGBA8888)
+    {
+        inBytesPerPixel = 4;
+        switch (format)
+        {
+        case PixelFormat::RGB888: convert = convertRGBA8888ToRGB888; break;
+        case PixelFormat::RGB565: convert = convertRGBA8888ToRGB565; break;
+        case PixelFormat::A8: convert = convertRGBA8888ToA8; break;
+        case PixelFormat::I8: convert = convertRGBA8888ToI8; break;
+        case PixelFormat::AI88: convert = convertRGBA8888ToAI88; break;
+        case PixelFormat::RGBA4444: convert = convertRGBA8888ToRGBA4444; break;
+        case PixelFormat::RGB5A1: convert = convertRGBA8888ToRGB5A1; break;
+        default: break;
+        }
+    }
+    else if (originFormat == PixelFormat::RGB888)
+    {
+        inBytesPerPixel = 3;
+        switch (format)
+        {
+        case PixelFormat::RGBA8888: convert = convertRGB888ToRGBA8888; break;
+        case PixelFormat::RGB565: convert = convertRGB888ToRGB565; break;
+        case PixelFormat::I8: convert = convertRGB888ToI8; break;
+        case PixelFormat::AI88: convert = convertRGB888ToAI88; break;
+        case PixelFormat::RGBA4444: convert = convertRGB888ToRGBA4444; break;
+        case PixelFormat::RGB5A1: convert = convertRGB888ToRGB5A1; break;
+        default: break;
+        }
+    }
+
+    if (convert == nullptr)
+    {
+        CCLOG("unsupport convert for format %d to format %d", originFormat, format);
+        return false;
+    }
+
+    parallelConvert(convert, data, dataLen, inBytesPerPixel, outData, _pixelFormatInfoTables.at(format).bpp / 8);
+    return true;
+}
+
 // implementation Texture2D (Text)
 bool Texture2D::initWithString(const char *text, const std::string& fontName, float fontSize, const Size& dimensions/* = Size(0, 0)*/, TextHAlignment hAlignment/* =  TextHAlignment::CENTER */, TextVAlignment vAlignment/* =  TextVAlignment::TOP */)
 {
@@ -1378,6 +1818,16 @@ Texture2D::PixelFormat Texture2D::getDefaultAlphaPixelFormat()
     return g_defaultAlphaPixelFormat;
 }
 
+void Texture2D::setDitherEnabled(bool enabled)
+{
+    g_ditherEnabled = enabled;
+}
+
+bool Texture2D::isDitherEnabled()
+{
+    return g_ditherEnabled;
+}
+
 unsigned int Texture2D::getBitsPerPixelForFormat(Texture2D::PixelFormat format) const
 {
     if (format == PixelFormat::NONE)
@@ -177,6 +177,16 @@ public:
     static Texture2D::PixelFormat getDefaultAlphaPixelFormat();
     CC_DEPRECATED_ATTRIBUTE static Texture2D::PixelFormat defaultAlphaPixelFormat() { return Texture2D::getDefaultAlphaPixelFormat(); };
 
+    /** enables (or not) an ordered dithering when RGB888 / RGBA8888 images are converted to
+     RGBA4444, RGB5A1 or RGB565 textures. It reduces the banding of gradients at the cost of some noise.
+
+     By default it is disabled.
+     */
+    static void setDitherEnabled(bool enabled);
+
+    /** returns whether the ordered dithering is used for 16-bit textures */
+    static bool isDitherEnabled();
+
     /** treats (or not) PVR files as if they have alpha premultiplied.
      Since it is impossible to know at runtime if the PVR images have the alpha channel premultiplied, it is
      possible load them as if they have (or not) the alpha channel premultiplied.
@@ -326,6 +336,14 @@ public:
     
     /** Gets the texture name */
     GLuint getName() const;
+
+    /** Gets the frame in which the texture was last bound by a QuadCommand or looked up in the TextureCache */
+    unsigned int getLastUsedFrame() const;
+
+    /** Records that the texture with the given name is used in the current frame.
+     It lets the TextureCache evict the least recently used textures first.
+     */
+    static void markUsed(GLuint name);
     
     /** Gets max S */
     GLfloat getMaxS() const;
@@ -344,17 +362,24 @@ public:
     
 public:
     static const PixelFormatInfoMap& getPixelFormatInfoMap();
-    
-private:
-
-    /**convert functions*/
 
     /**
     Convert the format to the format param you specified, if the format is PixelFormat::Automatic, it will detect it automatically and convert to the closest format for you.
-    It will return the converted format to you. if the outData != data, you must delete it manually.
+    It will return the converted format to you. if the outData != data, you must free it manually.
+    Large images are converted on the worker threads of ThreadPool.
     */
     static PixelFormat convertDataToFormat(const unsigned char* data, ssize_t dataLen, PixelFormat originFormat, PixelFormat format, unsigned char** outData, ssize_t* outDataLen);
 
+    /**
+    Convert RGB888 or RGBA8888 data to the format param you specified, writing it in outData which must be big enough.
+    It returns false, and doesn't touch outData, if the conversion isn't supported.
+    */
+    static bool convertDataToFormat(const unsigned char* data, ssize_t dataLen, PixelFormat originFormat, PixelFormat format, unsigned char* outData);
+    
+private:
+
+    /**convert functions*/
+
     static PixelFormat convertI8ToFormat(const unsigned char* data, ssize_t dataLen, PixelFormat format, unsigned char** outData, ssize_t* outDataLen);
     static PixelFormat convertAI88ToFormat(const unsigned char* data, ssize_t dataLen, PixelFormat format, unsigned char** outData, ssize_t* outDataLen);
     static PixelFormat convertRGB888ToFormat(const unsigned char* data, ssize_t dataLen, PixelFormat format, unsigned char** outData, ssize_t* outDataLen);
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include <stack>
 #include <cctype>
 #include <list>
+#include <algorithm>
 
 #include "2d/CCTextureCache.h"
 #include "2d/CCTexture2D.h"
@@ -62,7 +63,9 @@ TextureCache::TextureCache()
 , _imageInfoQueue(nullptr)
 , _needQuit(false)
 , _asyncRefCount(0)
+, _memoryBudget(0)
 {
+    memset(&_evictionStats, 0, sizeof(_evictionStats));
 }
 
 TextureCache::~TextureCache()
@@ -105,6 +108,7 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
 
     if (texture != nullptr)
     {
+        Texture2D::markUsed(texture->getName());
         callback(texture);
         return;
     }
@@ -258,6 +262,7 @@ void TextureCache::addImageAsyncCallBack(float dt)
             texture->retain();
 
             texture->autorelease();
+            onTextureAdded(filename);
         }
         else
         {
@@ -284,8 +289,6 @@ void TextureCache::addImageAsyncCallBack(float dt)
 
 Texture2D * TextureCache::addImage(const std::string &path)
 {
-    Texture2D * texture = nullptr;
-    Image* image = nullptr;
     // Split up directory and filename
     // MUTEX:
     // Needed since addImageAsync calls this method from a different thread
@@ -297,38 +300,53 @@ Texture2D * TextureCache::addImage(const std::string &path)
     }
     auto it = _textures.find(fullpath);
     if( it != _textures.end() )
-        texture = it->second;
+    {
+        Texture2D::markUsed(it->second->getName());
+        return it->second;
+    }
 
+    Texture2D * texture = nullptr;
+    // all images are handled by UIImage except PVR extension that is handled by our own handler
+    Image* image = new Image();
+    if (image->initWithImageFile(fullpath))
+    {
+        texture = addDecodedImage(fullpath, image);
+    }
     if (! texture)
     {
-        // all images are handled by UIImage except PVR extension that is handled by our own handler
-        do 
-        {
-            image = new Image();
-            CC_BREAK_IF(nullptr == image);
+        CCLOG("cocos2d: Couldn't create texture for file:%s in TextureCache", path.c_str());
+    }
 
-            bool bRet = image->initWithImageFile(fullpath);
-            CC_BREAK_IF(!bRet);
+    CC_SAFE_RELEASE(image);
 
-            texture = new Texture2D();
+    return texture;
+}
 
-            if( texture && texture->initWithImage(image) )
-            {
-#if CC_ENABLE_CACHE_TEXTURE_DATA
-                // cache the texture file name
-                VolatileTextureMgr::addImageTexture(texture, fullpath);
-#endif
-                // texture already retained, no need to re-retain it
-                _textures.insert( std::make_pair(fullpath, texture) );
-            }
-            else
-            {
-                CCLOG("cocos2d: Couldn't create texture for file:%s in TextureCache", path.c_str());
-            }
-        } while (0);
+Texture2D* TextureCache::addDecodedImage(const std::string& fullPath, Image *image)
+{
+    CCASSERT(image != nullptr, "TextureCache: image MUST not be nil");
+
+    auto it = _textures.find(fullPath);
+    if( it != _textures.end() )
+    {
+        Texture2D::markUsed(it->second->getName());
+        return it->second;
     }
 
-    CC_SAFE_RELEASE(image);
+    Texture2D* texture = new Texture2D();
+    if (! texture->initWithImage(image))
+    {
+        texture->release();
+        return nullptr;
+    }
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    // cache the texture file name
+    VolatileTextureMgr::addImageTexture(texture, fullPath);
+#endif
+    // texture already retained, no need to re-retain it
+    _textures.insert( std::make_pair(fullPath, texture) );
+    onTextureAdded(fullPath);
 
     return texture;
 }
@@ -344,6 +362,7 @@ Texture2D* TextureCache::addImage(Image *image, const std::string &key)
         auto it = _textures.find(key);
         if( it != _textures.end() ) {
             texture = it->second;
+            Texture2D::markUsed(texture->getName());
             break;
         }
 
@@ -357,6 +376,7 @@ Texture2D* TextureCache::addImage(Image *image, const std::string &key)
             texture->retain();
 
             texture->autorelease();
+            onTextureAdded(key);
         }
         else
         {
@@ -535,6 +555,133 @@ std::string TextureCache::getCachedTextureInfo() const
     return buffer;
 }
 
+static size_t textureMemorySize(Texture2D* tex)
+{
+    return (size_t)tex->getPixelsWide() * tex->getPixelsHigh() * tex->getBitsPerPixelForFormat() / 8;
+}
+
+size_t TextureCache::getTextureMemorySize() const
+{
+    size_t totalBytes = 0;
+    for (const auto& texture : _textures)
+    {
+        totalBytes += textureMemorySize(texture.second);
+    }
+    return totalBytes;
+}
+
+// TextureCache - Memory budget
+
+// how many evicted textures are remembered for the statistics and reloadEvictedTextures()
+static const size_t MAX_EVICTED_TEXTURES = 64;
+
+void TextureCache::setMemoryBudget(size_t bytes)
+{
+    _memoryBudget = bytes;
+    if (_memoryBudget > 0)
+    {
+        evictUnusedTextures(_memoryBudget);
+    }
+}
+
+size_t TextureCache::evictUnusedTextures(size_t bytes)
+{
+    size_t totalBytes = getTextureMemorySize();
+    if (totalBytes <= bytes)
+    {
+        return 0;
+    }
+
+    // a texture with a retain count of 1 is only referenced by the cache
+    unsigned int currentFrame = Director::getInstance()->getTotalFrames();
+    std::vector<decltype(_textures)::iterator> candidates;
+    for (auto it = _textures.begin(); it != _textures.end(); ++it)
+    {
+        Texture2D* tex = it->second;
+        if (tex->getReferenceCount() == 1 && tex->getLastUsedFrame() < currentFrame)
+        {
+            candidates.push_back(it);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const decltype(_textures)::iterator& a, const decltype(_textures)::iterator& b) {
+        return a->second->getLastUsedFrame() < b->second->getLastUsedFrame();
+    });
+
+    size_t freedBytes = 0;
+    for (const auto& it : candidates)
+    {
+        if (totalBytes - freedBytes <= bytes)
+        {
+            break;
+        }
+
+        Texture2D* tex = it->second;
+        size_t texBytes = textureMemorySize(tex);
+        CCLOG("cocos2d: TextureCache: evicting texture: %s", it->first.c_str());
+
+        if (_evictedTextures.size() >= MAX_EVICTED_TEXTURES)
+        {
+            _evictedTextures.erase(_evictedTextures.begin());
+        }
+        EvictedTexture evicted = { it->first, tex->getLastUsedFrame(), texBytes };
+        _evictedTextures.push_back(evicted);
+
+        tex->release();
+        _textures.erase(it);
+
+        freedBytes += texBytes;
+        _evictionStats.evictedTextures++;
+        _evictionStats.evictedBytes += texBytes;
+    }
+    return freedBytes;
+}
+
+void TextureCache::reloadEvictedTextures()
+{
+    // _evictedTextures keeps the eviction order, sort a copy
+    std::vector<EvictedTexture> evictedTextures(_evictedTextures);
+    std::sort(evictedTextures.begin(), evictedTextures.end(), [](const EvictedTexture& a, const EvictedTexture& b) {
+        return a.lastUsedFrame > b.lastUsedFrame;
+    });
+
+    size_t totalBytes = getTextureMemorySize();
+    std::vector<std::string> keys;
+    for (const auto& evicted : evictedTextures)
+    {
+        // textures added from an Image have no file to be reloaded from
+        if ((_memoryBudget > 0 && totalBytes + evicted.bytes > _memoryBudget) || !FileUtils::getInstance()->isFileExist(evicted.key))
+        {
+            continue;
+        }
+        totalBytes += evicted.bytes;
+        keys.push_back(evicted.key);
+    }
+
+    // onTextureAdded() removes them from _evictedTextures once they are loaded
+    for (const auto& key : keys)
+    {
+        addImageAsync(key, [](Texture2D*){});
+    }
+}
+
+void TextureCache::onTextureAdded(const std::string& key)
+{
+    for (auto it = _evictedTextures.begin(); it != _evictedTextures.end(); ++it)
+    {
+        if (it->key == key)
+        {
+            _evictedTextures.erase(it);
+            _evictionStats.reloadedTextures++;
+            break;
+        }
+    }
+
+    if (_memoryBudget > 0)
+    {
+        evictUnusedTextures(_memoryBudget);
+    }
+}
+
 #if CC_ENABLE_CACHE_TEXTURE_DATA
 
 std::list<VolatileTexture*> VolatileTextureMgr::_textures;
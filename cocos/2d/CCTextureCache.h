@@ -128,6 +128,13 @@ public:
     Texture2D* addImage(Image *image, const std::string &key);
     CC_DEPRECATED_ATTRIBUTE Texture2D* addUIImage(Image *image, const std::string& key) { return addImage(image,key); }
 
+    /** Returns the texture of an image file that was decoded elsewhere, for instance on a worker thread.
+    * Unlike addImage(Image*, key), the texture is reloaded from the file when the GL context is lost.
+    * "fullPath" must be the full path of the file, which is the key of the texture.
+    * Returns the cached texture if the file was already loaded.
+    */
+    Texture2D* addDecodedImage(const std::string& fullPath, Image *image);
+
     /** Returns an already created texture. Returns nil if the texture doesn't exist.
     @since v0.99.5
     */
@@ -173,6 +180,35 @@ public:
     */
     std::string getCachedTextureInfo() const;
 
+    /** Returns the memory used by the cached textures in bytes, computed like getCachedTextureInfo() */
+    size_t getTextureMemorySize() const;
+
+    /** Sets the texture memory budget of the cache in bytes, 0 (the default) means no budget.
+    * Whenever a texture is added and the cache goes over budget, the unused textures (retain count of 1)
+    * are removed, the least recently used first. Textures used in the current frame are never removed.
+    */
+    void setMemoryBudget(size_t bytes);
+    size_t getMemoryBudget() const { return _memoryBudget; }
+
+    /** Removes unused textures, the least recently used first, until the cache uses at most 'bytes'.
+    * Returns how many bytes were freed.
+    */
+    size_t evictUnusedTextures(size_t bytes);
+
+    /** Loads again in the background the textures evicted by the budget, the most recently used first,
+    * as long as they fit in the budget. Call it when memory is available again, e.g. after a scene change.
+    */
+    void reloadEvictedTextures();
+
+    struct EvictionStats
+    {
+        unsigned int evictedTextures;
+        size_t evictedBytes;
+        /** evicted textures that were loaded again */
+        unsigned int reloadedTextures;
+    };
+    const EvictionStats& getEvictionStats() const { return _evictionStats; }
+
     //wait for texture cahe to quit befor destroy instance
     //called by director, please do not called outside
     void waitForQuit();
@@ -180,6 +216,8 @@ public:
 private:
     void addImageAsyncCallBack(float dt);
     void loadImage();
+    // updates the statistics and enforces the budget after a texture is added
+    void onTextureAdded(const std::string& key);
 
 public:
     struct AsyncStruct
@@ -214,6 +252,17 @@ protected:
     int _asyncRefCount;
 
     std::unordered_map<std::string, Texture2D*> _textures;
+
+    struct EvictedTexture
+    {
+        std::string key;
+        unsigned int lastUsedFrame;
+        size_t bytes;
+    };
+    size_t _memoryBudget;
+    EvictionStats _evictionStats;
+    // the last evicted textures, oldest first
+    std::vector<EvictedTexture> _evictedTextures;
 };
 
 #if CC_ENABLE_CACHE_TEXTURE_DATA
@@ -98,24 +98,20 @@ void TransitionPageTurn::draw(Renderer *renderer, const Mat4 &transform, bool tr
     
     if( _isInSceneOnTop ) {
         _outSceneProxy->visit(renderer, transform, transformUpdated);
-        _enableOffsetCmd.init(_globalZOrder);
-        _enableOffsetCmd.func = CC_CALLBACK_0(TransitionPageTurn::onEnablePolygonOffset, this);
+        _enableOffsetCmd.init(_globalZOrder, renderer->getFrameArena(), CC_CALLBACK_0(TransitionPageTurn::onEnablePolygonOffset, this));
         renderer->addCommand(&_enableOffsetCmd);
         _inSceneProxy->visit(renderer, transform, transformUpdated);
-        _disableOffsetCmd.init(_globalZOrder);
-        _disableOffsetCmd.func = CC_CALLBACK_0(TransitionPageTurn::onDisablePolygonOffset, this);
+        _disableOffsetCmd.init(_globalZOrder, renderer->getFrameArena(), CC_CALLBACK_0(TransitionPageTurn::onDisablePolygonOffset, this));
         renderer->addCommand(&_disableOffsetCmd);
     } else {
         _inSceneProxy->visit(renderer, transform, transformUpdated);
         
-        _enableOffsetCmd.init(_globalZOrder);
-        _enableOffsetCmd.func = CC_CALLBACK_0(TransitionPageTurn::onEnablePolygonOffset, this);
+        _enableOffsetCmd.init(_globalZOrder, renderer->getFrameArena(), CC_CALLBACK_0(TransitionPageTurn::onEnablePolygonOffset, this));
         renderer->addCommand(&_enableOffsetCmd);
         
         _outSceneProxy->visit(renderer, transform, transformUpdated);
         
-        _disableOffsetCmd.init(_globalZOrder);
-        _disableOffsetCmd.func = CC_CALLBACK_0(TransitionPageTurn::onDisablePolygonOffset, this);
+        _disableOffsetCmd.init(_globalZOrder, renderer->getFrameArena(), CC_CALLBACK_0(TransitionPageTurn::onDisablePolygonOffset, this));
         renderer->addCommand(&_disableOffsetCmd);
     }
 }
@@ -64,6 +64,10 @@ public:
      */
     static void setAccelerometerInterval(float interval);
 
+    /**
+     *  Rasterizes a text with a system font into RGBA8888 data.
+     *  On Linux the faces and the rendered glyphs are cached between calls, and it may be called from any thread.
+     */
     static Data getTextureDataForText(const char * text, const FontDefinition& textDefinition, TextAlign align, int &width, int &height, bool& hasPremultipliedAlpha);
 
 private:
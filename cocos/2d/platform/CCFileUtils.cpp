@@ -25,6 +25,7 @@ THE SOFTWARE.
 
 #include "CCFileUtils.h"
 #include "base/CCData.h"
+#include "base/CCValueView.h"
 #include "base/ccMacros.h"
 #include "base/CCDirector.h"
 #include "CCSAXParser.h"
@@ -84,7 +85,7 @@ public:
     {
     }
 
-    ValueMap dictionaryWithContentsOfFile(const std::string& fileName)
+    ValueMap dictionaryWithData(const Data& data)
     {
         _resultType = SAX_RESULT_DICT;
         SAXParser parser;
@@ -92,11 +93,14 @@ public:
         CCASSERT(parser.init("UTF-8"), "The file format isn't UTF-8");
         parser.setDelegator(this);
 
-        parser.parse(fileName);
-		return _rootDict;
+        if (!data.isNull())
+        {
+            parser.parse((const char*)data.getBytes(), data.getSize());
+        }
+		return std::move(_rootDict);
     }
 
-    ValueVector arrayWithContentsOfFile(const std::string& fileName)
+    ValueVector arrayWithData(const Data& data)
     {
         _resultType = SAX_RESULT_ARRAY;
         SAXParser parser;
@@ -104,8 +108,11 @@ public:
         CCASSERT(parser.init("UTF-8"), "The file format isn't UTF-8");
         parser.setDelegator(this);
 
-        parser.parse(fileName);
-		return _rootArray;
+        if (!data.isNull())
+        {
+            parser.parse((const char*)data.getBytes(), data.getSize());
+        }
+		return std::move(_rootArray);
     }
 
     void startElement(void *ctx, const char *name, const char **atts)
@@ -249,7 +256,7 @@ public:
             if (SAX_ARRAY == curState)
             {
                 if (sName == "string")
-                    _curArray->push_back(Value(_curValue));
+                    _curArray->push_back(Value(std::move(_curValue)));
                 else if (sName == "integer")
                     _curArray->push_back(Value(atoi(_curValue.c_str())));
                 else
@@ -258,7 +265,7 @@ public:
             else if (SAX_DICT == curState)
             {
                 if (sName == "string")
-                    (*_curDict)[_curKey] = Value(_curValue);
+                    (*_curDict)[_curKey] = Value(std::move(_curValue));
                 else if (sName == "integer")
                     (*_curDict)[_curKey] = Value(atoi(_curValue.c_str()));
                 else
@@ -308,15 +315,27 @@ public:
 ValueMap FileUtils::getValueMapFromFile(const std::string& filename)
 {
     const std::string fullPath = fullPathForFilename(filename.c_str());
+    Data data = getDataFromFile(fullPath);
+    if (ValueView::isBinaryData(data.getBytes(), data.getSize()))
+    {
+        return ValueView::createWithData(std::move(data)).toValueMap();
+    }
+
     DictMaker tMaker;
-    return tMaker.dictionaryWithContentsOfFile(fullPath.c_str());
+    return tMaker.dictionaryWithData(data);
 }
 
 ValueVector FileUtils::getValueVectorFromFile(const std::string& filename)
 {
     const std::string fullPath = fullPathForFilename(filename.c_str());
+    Data data = getDataFromFile(fullPath);
+    if (ValueView::isBinaryData(data.getBytes(), data.getSize()))
+    {
+        return ValueView::createWithData(std::move(data)).toValueVector();
+    }
+
     DictMaker tMaker;
-    return tMaker.arrayWithContentsOfFile(fullPath.c_str());
+    return tMaker.arrayWithData(data);
 }
 
 
@@ -468,6 +487,16 @@ bool FileUtils::writeToFile(ValueMap& dict, const std::string &fullPath) {return
 
 #endif /* (CC_TARGET_PLATFORM != CC_PLATFORM_IOS) && (CC_TARGET_PLATFORM != CC_PLATFORM_MAC) */
 
+ValueView FileUtils::getValueViewFromFile(const std::string& filename)
+{
+    return ValueView::createWithFile(fullPathForFilename(filename));
+}
+
+bool FileUtils::writeValueToBinaryFile(const Value& value, const std::string& fullPath)
+{
+    return ValueView::writeToFile(value, fullPath);
+}
+
 
 FileUtils* FileUtils::s_sharedFileUtils = nullptr;
 
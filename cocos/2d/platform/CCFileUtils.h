@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "base/ccTypes.h"
 #include "base/CCValue.h"
 #include "base/CCData.h"
+#include "base/CCValueView.h"
 
 #include <string>
 #include <vector>
@@ -328,6 +329,18 @@ public:
      */
     virtual ValueVector getValueVectorFromFile(const std::string& filename);
 
+    /**
+     *  Opens a file written by writeValueToBinaryFile() without parsing it.
+     *  The values are read in place when they are looked up, a null view is returned if the file isn't binary.
+     */
+    virtual ValueView getValueViewFromFile(const std::string& filename);
+
+    /**
+     *  Writes a Value tree to a binary file, which getValueMapFromFile(), getValueVectorFromFile()
+     *  and getValueViewFromFile() load much faster than a plist.
+     */
+    virtual bool writeValueToBinaryFile(const Value& value, const std::string& fullPath);
+
     /** Returns the full path cache */
     const std::unordered_map<std::string, std::string>& getFullPathCache() const { return _fullPathCache; }
 
@@ -28,6 +28,8 @@ THE SOFTWARE.
 #include "base/CCData.h"
 
 #include <string>
+#include <algorithm>
+#include <functional>
 #include <ctype.h>
 
 #ifdef EMSCRIPTEN
@@ -57,6 +59,7 @@ extern "C"
 #include "base/CCConfiguration.h"
 #include "2d/ccUtils.h"
 #include "base/ZipUtils.h"
+#include "base/CCThreadPool.h"
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
 #include "android/CCFileUtilsAndroid.h"
 #endif
@@ -65,6 +68,14 @@ extern "C"
 #define CC_GL_ATC_RGBA_EXPLICIT_ALPHA_AMD                          0x8C93
 #define CC_GL_ATC_RGBA_INTERPOLATED_ALPHA_AMD                      0x87EE
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define CC_IMAGE_USE_SSE2 1
+    #include <emmintrin.h>
+#elif defined(USE_NEON)
+    #define CC_IMAGE_USE_NEON 1
+    #include <arm_neon.h>
+#endif
+
 NS_CC_BEGIN
 
 //////////////////////////////////////////////////////////////////////////
@@ -396,6 +407,156 @@ Image::~Image()
     CC_SAFE_FREE(_data);
 }
 
+namespace {
+    // premultiplies `pixels` RGBA8888 pixels in place, with the same rounding as CC_RGB_PREMULTIPLY_ALPHA
+    void premultiplyPixels(unsigned char* data, ssize_t pixels)
+    {
+        ssize_t i = 0;
+#if CC_IMAGE_USE_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i one = _mm_set1_epi16(1);
+        const __m128i alphaMask = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+        for (; i + 4 <= pixels; i += 4)
+        {
+            __m128i* p = (__m128i*)(data + i * 4);
+            __m128i x = _mm_loadu_si128(p);
+            __m128i lo = _mm_unpacklo_epi8(x, zero);
+            __m128i hi = _mm_unpackhi_epi8(x, zero);
+            // broadcast the alpha of each pixel to its 4 channels
+            __m128i alo = _mm_add_epi16(_mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, 0xFF), 0xFF), one);
+            __m128i ahi = _mm_add_epi16(_mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, 0xFF), 0xFF), one);
+            __m128i mlo = _mm_srli_epi16(_mm_mullo_epi16(lo, alo), 8);
+            __m128i mhi = _mm_srli_epi16(_mm_mullo_epi16(hi, ahi), 8);
+            // keep the original alpha
+            mlo = _mm_or_si128(_mm_andnot_si128(alphaMask, mlo), _mm_and_si128(alphaMask, lo));
+            mhi = _mm_or_si128(_mm_andnot_si128(alphaMask, mhi), _mm_and_si128(alphaMask, hi));
+            _mm_storeu_si128(p, _mm_packus_epi16(mlo, mhi));
+        }
+#elif CC_IMAGE_USE_NEON
+        for (; i + 8 <= pixels; i += 8)
+        {
+            uint8x8x4_t rgba = vld4_u8(data + i * 4);
+            for (int c = 0; c < 3; ++c)
+            {
+                // c * (a + 1) >> 8
+                uint16x8_t m = vaddw_u8(vmull_u8(rgba.val[c], rgba.val[3]), rgba.val[c]);
+                rgba.val[c] = vshrn_n_u16(m, 8);
+            }
+            vst4_u8(data + i * 4, rgba);
+        }
+#endif
+        unsigned int* tmp = (unsigned int*)data;
+        for (; i < pixels; ++i)
+        {
+            unsigned char* p = data + i * 4;
+            tmp[i] = CC_RGB_PREMULTIPLY_ALPHA(p[0], p[1], p[2], p[3]);
+        }
+    }
+}
+
+static Texture2D::PixelFormat g_softwareDecodePixelFormat = Texture2D::PixelFormat::AUTO;
+static bool g_softwareDecodeForced = false;
+
+namespace {
+    // block compressed images with less block rows than this are decoded on the calling thread
+    static const ssize_t PARALLEL_DECODE_GRAIN = 16;
+
+    inline int bytesPerPixelForFormat(Texture2D::PixelFormat format)
+    {
+        return Texture2D::getPixelFormatInfoMap().at(format).bpp / 8;
+    }
+
+    // Decodes a block compressed image band by band on the worker threads.
+    // decodeRows(encodeData, decodeData, width, rows) decodes `rows` pixel rows of `width` pixels, starting on a block row,
+    // to `decodedFormat`. The block rows are decoded in place when the image is made of whole blocks and isn't converted.
+    // Otherwise every block row is decoded in a small scratch buffer, as whole blocks, and its visible pixels are copied
+    // or converted to `outFormat`, so the image is never held twice in memory.
+    void decodeBlockRows(const std::function<void(const unsigned char*, unsigned char*, int, int)>& decodeRows,
+                         const unsigned char* encodeData, ssize_t encodedBlockRowLen,
+                         int width, int height,
+                         Texture2D::PixelFormat decodedFormat, Texture2D::PixelFormat outFormat,
+                         unsigned char* outData)
+    {
+        const int decodedBytesPerPixel = bytesPerPixelForFormat(decodedFormat);
+        const int outBytesPerPixel = bytesPerPixelForFormat(outFormat);
+        // the mipmaps smaller than a block are still encoded as whole blocks
+        const int paddedWidth = (width + 3) / 4 * 4;
+        const ssize_t blockRows = (height + 3) / 4;
+        const ssize_t wholeBlockRows = (decodedFormat == outFormat && paddedWidth == width) ? height / 4 : 0;
+
+        ThreadPool::getInstance()->parallelFor(blockRows, PARALLEL_DECODE_GRAIN, [&](ssize_t begin, ssize_t end){
+            ssize_t directEnd = std::max(begin, std::min(end, wholeBlockRows));
+            if (directEnd > begin)
+            {
+                decodeRows(encodeData + begin * encodedBlockRowLen, outData + begin * 4 * width * outBytesPerPixel, width, (int)(directEnd - begin) * 4);
+            }
+            if (directEnd == end)
+                return;
+
+            std::vector<unsigned char> scratch(paddedWidth * 4 * decodedBytesPerPixel);
+            for (ssize_t blockRow = directEnd; blockRow < end; ++blockRow)
+            {
+                int rows = std::min(4, height - (int)blockRow * 4);
+                decodeRows(encodeData + blockRow * encodedBlockRowLen, scratch.data(), paddedWidth, 4);
+                for (int row = 0; row < rows; ++row)
+                {
+                    const unsigned char* src = scratch.data() + row * paddedWidth * decodedBytesPerPixel;
+                    unsigned char* dst = outData + (blockRow * 4 + row) * width * outBytesPerPixel;
+                    if (decodedFormat == outFormat)
+                    {
+                        memcpy(dst, src, width * decodedBytesPerPixel);
+                    }
+                    else
+                    {
+                        Texture2D::convertDataToFormat(src, width * decodedBytesPerPixel, decodedFormat, outFormat, dst);
+                    }
+                }
+            }
+        });
+    }
+
+    // the format compressed RGBA textures are decoded to when the GPU can't use them
+    Texture2D::PixelFormat getSoftwareDecodeFormatWithAlpha()
+    {
+        switch (g_softwareDecodePixelFormat)
+        {
+        case Texture2D::PixelFormat::RGBA4444:
+        case Texture2D::PixelFormat::RGB5A1:
+        case Texture2D::PixelFormat::RGB565:
+            return g_softwareDecodePixelFormat;
+        default:
+            return Texture2D::PixelFormat::RGBA8888;
+        }
+    }
+}
+
+void Image::setSoftwareDecodePixelFormat(Texture2D::PixelFormat format)
+{
+    g_softwareDecodePixelFormat = format;
+}
+
+Texture2D::PixelFormat Image::getSoftwareDecodePixelFormat()
+{
+    return g_softwareDecodePixelFormat;
+}
+
+void Image::setSoftwareDecodeForced(bool forced)
+{
+    g_softwareDecodeForced = forced;
+}
+
+void Image::premultiplyAlpha()
+{
+    CCASSERT(_renderFormat == Texture2D::PixelFormat::RGBA8888, "The pixel format should be RGBA8888!");
+
+    unsigned char* data = _data;
+    ThreadPool::getInstance()->parallelFor(_dataLen / 4, 64 * 1024, [=](ssize_t begin, ssize_t end){
+        premultiplyPixels(data + begin * 4, end - begin);
+    });
+
+    _preMulti = true;
+}
+
 bool Image::initWithImageFile(const std::string& path)
 {
     bool ret = false;
@@ -411,13 +572,7 @@ bool Image::initWithImageFile(const std::string& path)
     int size = 4 * (iSurf->w * iSurf->h);
     ret = initWithRawData((const unsigned char*)iSurf->pixels, size, iSurf->w, iSurf->h, 8, true);
 
-    unsigned int *tmp = (unsigned int *)_data;
-    int nrPixels = iSurf->w * iSurf->h;
-    for(int i = 0; i < nrPixels; i++)
-    {
-        unsigned char *p = _data + i * 4;
-        tmp[i] = CC_RGB_PREMULTIPLY_ALPHA( p[0], p[1], p[2], p[3] );
-    }
+    premultiplyAlpha();
 
     SDL_FreeSurface(iSurf);
 #else
@@ -1451,7 +1606,7 @@ bool Image::initWithETCData(const unsigned char * data, ssize_t dataLen)
         return false;
     }
 
-    if(Configuration::getInstance()->supportsETC())
+    if(!g_softwareDecodeForced && Configuration::getInstance()->supportsETC())
     {
         //old opengl version has no define for GL_ETC1_RGB8_OES, add macro to make compiler happy. 
 #ifdef GL_ETC1_RGB8_OES
@@ -1467,22 +1622,18 @@ bool Image::initWithETCData(const unsigned char * data, ssize_t dataLen)
         CCLOG("cocos2d: Hardware ETC1 decoder not present. Using software decoder");
 
          //if it is not gles or device do not support ETC, decode texture by software
-        int bytePerPixel = 3;
-        unsigned int stride = _width * bytePerPixel;
-        _renderFormat = Texture2D::PixelFormat::RGB888;
+        //ETC1 has no alpha, so every 16 bits format is decoded as RGB565 which the decoder writes directly
+        _renderFormat = getSoftwareDecodeFormatWithAlpha() != Texture2D::PixelFormat::RGBA8888
+                        ? Texture2D::PixelFormat::RGB565 : Texture2D::PixelFormat::RGB888;
+        int bytePerPixel = bytesPerPixelForFormat(_renderFormat);
         
         _dataLen =  _width * _height * bytePerPixel;
         _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
-        
-        if (etc1_decode_image(static_cast<const unsigned char*>(data) + ETC_PKM_HEADER_SIZE, static_cast<etc1_byte*>(_data), _width, _height, bytePerPixel, stride) != 0)
-        {
-            _dataLen = 0;
-            if (_data != nullptr)
-            {
-                free(_data);
-            }
-            return false;
-        }
+
+        decodeBlockRows([=](const unsigned char* encodeData, unsigned char* decodeData, int width, int rows){
+            etc1_decode_image(encodeData, decodeData, width, rows, bytePerPixel, width * bytePerPixel);
+        }, static_cast<const unsigned char*>(data) + ETC_PKM_HEADER_SIZE, ((_width + 3) / 4) * ETC1_ENCODED_BLOCK_SIZE,
+        _width, _height, _renderFormat, _renderFormat, _data);
         
         return true;
     }
@@ -1601,8 +1752,11 @@ bool Image::initWithS3TCData(const unsigned char * data, ssize_t dataLen)
     
     int width = _width;
     int height = _height;
+    bool hardwareDecode = !g_softwareDecodeForced && Configuration::getInstance()->supportsS3TC();
+    Texture2D::PixelFormat softwareFormat = getSoftwareDecodeFormatWithAlpha();
+    int softwareBytesPerPixel = bytesPerPixelForFormat(softwareFormat);
     
-    if (Configuration::getInstance()->supportsS3TC())  //compressed data length
+    if (hardwareDecode)  //compressed data length
     {
         _dataLen = dataLen - sizeof(S3TCTexHeader);
         _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
@@ -1615,7 +1769,7 @@ bool Image::initWithS3TCData(const unsigned char * data, ssize_t dataLen)
             if (width == 0) width = 1;
             if (height == 0) height = 1;
             
-            _dataLen += (height * width *4);
+            _dataLen += (height * width * softwareBytesPerPixel);
 
             width >>= 1;
             height >>= 1;
@@ -1624,7 +1778,7 @@ bool Image::initWithS3TCData(const unsigned char * data, ssize_t dataLen)
     }
     
     /* if hardware supports s3tc, set pixelformat before loading mipmaps, to support non-mipmapped textures  */
-    if (Configuration::getInstance()->supportsS3TC())
+    if (hardwareDecode)
     {   //decode texture throught hardware
         
         if (FOURCC_DXT1 == header->ddsd.DUMMYUNIONNAMEN4.ddpfPixelFormat.fourCC)
@@ -1640,7 +1794,7 @@ bool Image::initWithS3TCData(const unsigned char * data, ssize_t dataLen)
             _renderFormat = Texture2D::PixelFormat::S3TC_DXT5;
         }
     } else { //will software decode
-        _renderFormat = Texture2D::PixelFormat::RGBA8888;
+        _renderFormat = softwareFormat;
     }
     
     /* load the mipmaps */
@@ -1656,7 +1810,7 @@ bool Image::initWithS3TCData(const unsigned char * data, ssize_t dataLen)
         
         int size = ((width+3)/4)*((height+3)/4)*blockSize;
                 
-        if (Configuration::getInstance()->supportsS3TC())
+        if (hardwareDecode)
         {   //decode texture throught hardware
             _mipmaps[i].address = (unsigned char *)_data + encodeOffset;
             _mipmaps[i].len = size;
@@ -1666,27 +1820,25 @@ bool Image::initWithS3TCData(const unsigned char * data, ssize_t dataLen)
             
             CCLOG("cocos2d: Hardware S3TC decoder not present. Using software decoder");
 
-            int bytePerPixel = 4;
-            unsigned int stride = width * bytePerPixel;
-
-            std::vector<unsigned char> decodeImageData(stride * height);
-            if (FOURCC_DXT1 == header->ddsd.DUMMYUNIONNAMEN4.ddpfPixelFormat.fourCC)
-            {
-                s3tc_decode(pixelData + encodeOffset, &decodeImageData[0], width, height, S3TCDecodeFlag::DXT1);
-            }
-            else if (FOURCC_DXT3 == header->ddsd.DUMMYUNIONNAMEN4.ddpfPixelFormat.fourCC)
+            S3TCDecodeFlag decodeFlag = S3TCDecodeFlag::DXT1;
+            if (FOURCC_DXT3 == header->ddsd.DUMMYUNIONNAMEN4.ddpfPixelFormat.fourCC)
             {
-                s3tc_decode(pixelData + encodeOffset, &decodeImageData[0], width, height, S3TCDecodeFlag::DXT3);
+                decodeFlag = S3TCDecodeFlag::DXT3;
             }
             else if (FOURCC_DXT5 == header->ddsd.DUMMYUNIONNAMEN4.ddpfPixelFormat.fourCC)
             {
-                s3tc_decode(pixelData + encodeOffset, &decodeImageData[0], width, height, S3TCDecodeFlag::DXT5);
+                decodeFlag = S3TCDecodeFlag::DXT5;
             }
-            
+
             _mipmaps[i].address = (unsigned char *)_data + decodeOffset;
-            _mipmaps[i].len = (stride * height);
-            memcpy((void *)_mipmaps[i].address, (void *)&decodeImageData[0], _mipmaps[i].len);
-            decodeOffset += stride * height;
+            _mipmaps[i].len = width * height * softwareBytesPerPixel;
+
+            decodeBlockRows([=](const unsigned char* encodeData, unsigned char* decodeData, int decodeWidth, int rows){
+                s3tc_decode(const_cast<unsigned char*>(encodeData), decodeData, decodeWidth, rows, decodeFlag);
+            }, pixelData + encodeOffset, ((width + 3) / 4) * blockSize, width, height,
+            Texture2D::PixelFormat::RGBA8888, softwareFormat, _mipmaps[i].address);
+
+            decodeOffset += _mipmaps[i].len;
         }
         
         encodeOffset += size;
@@ -1735,8 +1887,11 @@ bool Image::initWithATITCData(const unsigned char *data, ssize_t dataLen)
     /* caculate the dataLen */
     int width = _width;
     int height = _height;
+    bool hardwareDecode = !g_softwareDecodeForced && Configuration::getInstance()->supportsATITC();
+    Texture2D::PixelFormat softwareFormat = getSoftwareDecodeFormatWithAlpha();
+    int softwareBytesPerPixel = bytesPerPixelForFormat(softwareFormat);
     
-    if (Configuration::getInstance()->supportsATITC())  //compressed data length
+    if (hardwareDecode)  //compressed data length
     {
         _dataLen = dataLen - sizeof(ATITCTexHeader) - header->bytesOfKeyValueData - 4;
         _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
@@ -1749,7 +1904,7 @@ bool Image::initWithATITCData(const unsigned char *data, ssize_t dataLen)
             if (width == 0) width = 1;
             if (height == 0) height = 1;
             
-            _dataLen += (height * width *4);
+            _dataLen += (height * width * softwareBytesPerPixel);
             
             width >>= 1;
             height >>= 1;
@@ -1769,7 +1924,7 @@ bool Image::initWithATITCData(const unsigned char *data, ssize_t dataLen)
         
         int size = ((width+3)/4)*((height+3)/4)*blockSize;
         
-        if (Configuration::getInstance()->supportsATITC())
+        if (hardwareDecode)
         {
             /* decode texture throught hardware */
             
@@ -1799,30 +1954,31 @@ bool Image::initWithATITCData(const unsigned char *data, ssize_t dataLen)
             
             CCLOG("cocos2d: Hardware ATITC decoder not present. Using software decoder");
             
-            int bytePerPixel = 4;
-            unsigned int stride = width * bytePerPixel;
-            _renderFormat = Texture2D::PixelFormat::RGBA8888;
-            
-            std::vector<unsigned char> decodeImageData(stride * height);
+            _renderFormat = softwareFormat;
+
+            ATITCDecodeFlag decodeFlag;
             switch (header->glInternalFormat)
             {
-                case CC_GL_ATC_RGB_AMD:
-                    atitc_decode(pixelData + encodeOffset, &decodeImageData[0], width, height, ATITCDecodeFlag::ATC_RGB);
-                    break;
                 case CC_GL_ATC_RGBA_EXPLICIT_ALPHA_AMD:
-                    atitc_decode(pixelData + encodeOffset, &decodeImageData[0], width, height, ATITCDecodeFlag::ATC_EXPLICIT_ALPHA);
+                    decodeFlag = ATITCDecodeFlag::ATC_EXPLICIT_ALPHA;
                     break;
                 case CC_GL_ATC_RGBA_INTERPOLATED_ALPHA_AMD:
-                    atitc_decode(pixelData + encodeOffset, &decodeImageData[0], width, height, ATITCDecodeFlag::ATC_INTERPOLATED_ALPHA);
+                    decodeFlag = ATITCDecodeFlag::ATC_INTERPOLATED_ALPHA;
                     break;
                 default:
+                    decodeFlag = ATITCDecodeFlag::ATC_RGB;
                     break;
             }
 
             _mipmaps[i].address = (unsigned char *)_data + decodeOffset;
-            _mipmaps[i].len = (stride * height);
-            memcpy((void *)_mipmaps[i].address, (void *)&decodeImageData[0], _mipmaps[i].len);
-            decodeOffset += stride * height;
+            _mipmaps[i].len = width * height * softwareBytesPerPixel;
+
+            decodeBlockRows([=](const unsigned char* encodeData, unsigned char* decodeData, int decodeWidth, int rows){
+                atitc_decode(const_cast<unsigned char*>(encodeData), decodeData, decodeWidth, rows, decodeFlag);
+            }, pixelData + encodeOffset, ((width + 3) / 4) * blockSize, width, height,
+            Texture2D::PixelFormat::RGBA8888, softwareFormat, _mipmaps[i].address);
+
+            decodeOffset += _mipmaps[i].len;
         }
 
         encodeOffset += (size + 4);
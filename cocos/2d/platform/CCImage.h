@@ -138,6 +138,26 @@ public:
      */
     bool saveToFile(const std::string &filename, bool isToRGB = true);
 
+    /**
+     @brief    Multiplies the color channels by the alpha channel, in place.
+     Only RGBA8888 images are supported. Large images are processed on the worker threads.
+     */
+    void premultiplyAlpha();
+
+    /**
+     @brief    Sets the pixel format ETC1, S3TC and ATITC images are decoded to when the GPU can't use them.
+     Texture2D::PixelFormat::AUTO (the default) keeps the decoder output: RGB888 for ETC1, RGBA8888 for the others.
+     RGBA4444, RGB5A1 and RGB565 halve the memory used by the decoded images; ETC1 has no alpha and is decoded to RGB565 for any of them.
+     */
+    static void setSoftwareDecodePixelFormat(Texture2D::PixelFormat format);
+    static Texture2D::PixelFormat getSoftwareDecodePixelFormat();
+
+    /**
+     @brief    Decodes ETC1, S3TC and ATITC images in software even if the GPU supports them.
+     Useful to test or benchmark the software decoders. By default it is disabled.
+     */
+    static void setSoftwareDecodeForced(bool forced);
+
 protected:
     bool initWithJpgData(const unsigned char *  data, ssize_t dataLen);
     bool initWithPngData(const unsigned char * data, ssize_t dataLen);
@@ -0,0 +1,104 @@
+/****************************************************************************
+Copyright (c) 2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#include "2d/platform/CCMappedFile.h"
+#include "2d/platform/CCFileUtils.h"
+
+#if (CC_TARGET_PLATFORM != CC_PLATFORM_WIN32) && (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT) && (CC_TARGET_PLATFORM != CC_PLATFORM_WP8)
+#define CC_MAPPEDFILE_USE_MMAP 1
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+NS_CC_BEGIN
+
+MappedFile::MappedFile()
+: _mappedBytes(nullptr)
+, _mappedSize(0)
+, _bytes(nullptr)
+, _size(0)
+{
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+bool MappedFile::open(const std::string& fullPath)
+{
+    close();
+
+#ifdef CC_MAPPEDFILE_USE_MMAP
+    // files inside the android apk have relative paths and can't be mapped
+    if (!fullPath.empty() && fullPath[0] == '/')
+    {
+        int fd = ::open(fullPath.c_str(), O_RDONLY);
+        if (fd >= 0)
+        {
+            struct stat st;
+            if (fstat(fd, &st) == 0 && st.st_size > 0)
+            {
+                void* mapped = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapped != MAP_FAILED)
+                {
+                    _mappedBytes = mapped;
+                    _mappedSize = st.st_size;
+                    _bytes = static_cast<const unsigned char*>(mapped);
+                    _size = st.st_size;
+                }
+            }
+            ::close(fd);
+        }
+    }
+#endif
+    if (_bytes == nullptr)
+    {
+        _data = FileUtils::getInstance()->getDataFromFile(fullPath);
+        _bytes = _data.getBytes();
+        _size = _data.getSize();
+    }
+
+    return _bytes != nullptr && _size > 0;
+}
+
+void MappedFile::close()
+{
+#ifdef CC_MAPPEDFILE_USE_MMAP
+    if (_mappedBytes)
+    {
+        munmap(_mappedBytes, _mappedSize);
+    }
+#endif
+    _mappedBytes = nullptr;
+    _mappedSize = 0;
+    _data.clear();
+    _bytes = nullptr;
+    _size = 0;
+}
+
+NS_CC_END
@@ -0,0 +1,72 @@
+/****************************************************************************
+Copyright (c) 2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#ifndef __CC_PLATFORM_MAPPEDFILE_H__
+#define __CC_PLATFORM_MAPPEDFILE_H__
+
+#include <string>
+#include "base/CCPlatformMacros.h"
+#include "base/CCData.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup platform
+ * @{
+ */
+
+/** The read-only content of a file, memory mapped when possible, otherwise read by FileUtils.
+ * The files inside the android apk and the ones of win32 are read.
+ */
+class CC_DLL MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+
+    /** Maps or reads a file given by its full path, returns false if it can't be read or is empty */
+    bool open(const std::string& fullPath);
+    void close();
+
+    const unsigned char* getBytes() const { return _bytes; }
+    ssize_t getSize() const { return _size; }
+    bool isMapped() const { return _mappedBytes != nullptr; }
+
+private:
+    Data _data;
+    void* _mappedBytes;
+    size_t _mappedSize;
+    const unsigned char* _bytes;
+    ssize_t _size;
+
+    CC_DISALLOW_COPY_AND_ASSIGN(MappedFile);
+};
+
+// end of platform group
+/// @}
+
+NS_CC_END
+
+#endif // __CC_PLATFORM_MAPPEDFILE_H__
@@ -399,6 +399,11 @@ std::string FileUtilsApple::getFullPathForDirectoryAndFilename(const std::string
 ValueMap FileUtilsApple::getValueMapFromFile(const std::string& filename)
 {
     std::string fullPath = fullPathForFilename(filename);
+    if (ValueView::isBinaryFile(fullPath))
+    {
+        return ValueView::createWithFile(fullPath).toValueMap();
+    }
+
     NSString* path = [NSString stringWithUTF8String:fullPath.c_str()];
     NSDictionary* dict = [NSDictionary dictionaryWithContentsOfFile:path];
     
@@ -440,6 +445,11 @@ ValueVector FileUtilsApple::getValueVectorFromFile(const std::string& filename)
     //    pPath = [[NSBundle mainBundle] pathForResource:pPath ofType:pathExtension];
     //    fixing cannot read data using Array::createWithContentsOfFile
     std::string fullPath = fullPathForFilename(filename);
+    if (ValueView::isBinaryFile(fullPath))
+    {
+        return ValueView::createWithFile(fullPath).toValueVector();
+    }
+
     NSString* path = [NSString stringWithUTF8String:fullPath.c_str()];
     NSArray* array = [NSArray arrayWithContentsOfFile:path];
     
@@ -33,8 +33,10 @@ THE SOFTWARE.
 #include <algorithm>
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <string>
 #include <sstream>
+#include <mutex>
 #include <fontconfig/fontconfig.h>
 #include "2d/platform/CCFileUtils.h"
 
@@ -46,7 +48,28 @@ using namespace std;
 // as FcFontMatch is quite an expensive call, cache the results of getFontFile
 static std::map<std::string, std::string> fontCache;
 
+// metrics and rendered bitmap of a glyph, they are loaded once per face and size
+struct CachedGlyph {
+    FT_UInt glyphIndex;
+    int glyphWidth;
+    int bearingX;
+    int bearingY;
+    int horizAdvance;
+
+    int bitmapWidth;
+    int bitmapRows;
+    std::vector<unsigned char> bitmap;
+};
+
+struct CachedFace {
+    FT_Face face;
+    bool hasKerning;
+    unsigned int lastUsed;
+    std::unordered_map<FT_UInt, CachedGlyph> glyphs;
+};
+
 struct LineBreakGlyph {
+    const CachedGlyph* cachedGlyph;
     FT_UInt glyphIndex;
     int paintPosition;
     int glyphWidth;
@@ -112,21 +135,185 @@ void Device::setAccelerometerInterval(float interval)
 
 }
 
-class BitmapDC
+/**
+ * Keeps the faces opened by the system font path, with the glyphs they already rendered.
+ * FreeType objects aren't thread safe: everything using the cache must hold its mutex.
+ */
+class FaceCache
 {
 public:
-	BitmapDC() {
+	static const size_t MaxCachedFaces = 8;
+	static const size_t MaxCachedGlyphsPerFace = 2048;
+
+	FaceCache() : _useStamp(0) {
 		libError = FT_Init_FreeType( &library );
 		FcInit();
-		_data = NULL;
-		reset();
 	}
 
-	~BitmapDC() {
+	~FaceCache() {
+		for (auto& item : _faces) {
+			FT_Done_Face(item.second.face);
+		}
+		_faces.clear();
 		FT_Done_FreeType(library);
 		FcFini();
-		
-        reset();
+	}
+
+	CachedFace* getFace(const char* fontName, float fontSize) {
+		if (libError) {
+			return nullptr;
+		}
+
+		auto key = std::make_pair(std::string(fontName), (int)fontSize);
+		auto it = _faces.find(key);
+		if (it != _faces.end()) {
+			// the glyphs of the previous texts are dropped between two texts, never during one
+			if (it->second.glyphs.size() > MaxCachedGlyphsPerFace) {
+				it->second.glyphs.clear();
+			}
+			it->second.lastUsed = ++_useStamp;
+			return &it->second;
+		}
+
+		FT_Face face;
+		std::string fontfile = getFontFile(fontName);
+		if ( FT_New_Face(library, fontfile.c_str(), 0, &face) ) {
+			//no valid font found use default
+			if ( FT_New_Face(library, "/usr/share/fonts/truetype/freefont/FreeSerif.ttf", 0, &face) ) {
+				return nullptr;
+			}
+		}
+
+		//select utf8 charmap
+		if ( FT_Select_Charmap(face, FT_ENCODING_UNICODE) ) {
+			FT_Done_Face(face);
+			return nullptr;
+		}
+
+		if ( FT_Set_Pixel_Sizes(face, fontSize, fontSize) ) {
+			FT_Done_Face(face);
+			return nullptr;
+		}
+
+		if (_faces.size() >= MaxCachedFaces) {
+			auto oldest = _faces.begin();
+			for (auto iter = _faces.begin(); iter != _faces.end(); ++iter) {
+				if (iter->second.lastUsed < oldest->second.lastUsed) {
+					oldest = iter;
+				}
+			}
+			FT_Done_Face(oldest->second.face);
+			_faces.erase(oldest);
+		}
+
+		CachedFace& cachedFace = _faces[key];
+		cachedFace.face = face;
+		cachedFace.hasKerning = FT_HAS_KERNING( face );
+		cachedFace.lastUsed = ++_useStamp;
+		return &cachedFace;
+	}
+
+	const CachedGlyph* getGlyph(CachedFace* cachedFace, FT_UInt unicode) {
+		auto it = cachedFace->glyphs.find(unicode);
+		if (it != cachedFace->glyphs.end()) {
+			return &it->second;
+		}
+
+		FT_Face face = cachedFace->face;
+		FT_UInt glyphIndex = FT_Get_Char_Index(face, unicode);
+		if (FT_Load_Glyph(face, glyphIndex, FT_LOAD_RENDER)) {
+			return nullptr;
+		}
+
+		CachedGlyph& glyph = cachedFace->glyphs[unicode];
+		glyph.glyphIndex = glyphIndex;
+		glyph.glyphWidth = face->glyph->metrics.width >> 6;
+		glyph.bearingX = face->glyph->metrics.horiBearingX >> 6;
+		glyph.bearingY = face->glyph->metrics.horiBearingY >> 6;
+		glyph.horizAdvance = face->glyph->metrics.horiAdvance >> 6;
+
+		FT_Bitmap& bitmap = face->glyph->bitmap;
+		glyph.bitmapWidth = bitmap.width;
+		glyph.bitmapRows = bitmap.rows;
+		glyph.bitmap.resize(bitmap.width * bitmap.rows);
+		for (int y = 0; y < (int)bitmap.rows; ++y) {
+			memcpy(&glyph.bitmap[y * bitmap.width], bitmap.buffer + y * bitmap.pitch, bitmap.width);
+		}
+		return &glyph;
+	}
+
+    std::string getFontFile(const char* family_name) {
+    	std::string fontPath = family_name;
+
+    	std::map<std::string, std::string>::iterator it = fontCache.find(family_name);
+    	if ( it != fontCache.end() ) {
+    		return it->second;
+    	}
+
+    	// check if the parameter is a font file shipped with the application
+    	std::string lowerCasePath = fontPath;
+    	std::transform(lowerCasePath.begin(), lowerCasePath.end(), lowerCasePath.begin(), ::tolower);
+    	if ( lowerCasePath.find(".ttf") != std::string::npos ) {
+    		fontPath = cocos2d::FileUtils::getInstance()->fullPathForFilename(fontPath.c_str());
+
+    		FILE *f = fopen(fontPath.c_str(), "r");
+    		if ( f ) {
+    			fclose(f);
+    			fontCache.insert(std::pair<std::string, std::string>(family_name, fontPath));
+    			return fontPath;
+    		}
+    	}
+
+    	// use fontconfig to match the parameter against the fonts installed on the system
+    	FcPattern *pattern = FcPatternBuild (0, FC_FAMILY, FcTypeString, family_name, (char *) 0);
+    	FcConfigSubstitute(0, pattern, FcMatchPattern);
+    	FcDefaultSubstitute(pattern);
+
+    	FcResult result;
+    	FcPattern *font = FcFontMatch(0, pattern, &result);
+    	if ( font ) {
+    		FcChar8 *s = NULL;
+    		if ( FcPatternGetString(font, FC_FILE, 0, &s) == FcResultMatch ) {
+    			fontPath = (const char*)s;
+
+    			FcPatternDestroy(font);
+    			FcPatternDestroy(pattern);
+
+    			fontCache.insert(std::pair<std::string, std::string>(family_name, fontPath));
+    			return fontPath;
+    		}
+    		FcPatternDestroy(font);
+    	}
+    	FcPatternDestroy(pattern);
+
+    	return family_name;
+    }
+
+public:
+	FT_Library library;
+	int libError;
+	std::mutex mutex;
+
+private:
+	std::map<std::pair<std::string, int>, CachedFace> _faces;
+	unsigned int _useStamp;
+};
+
+static FaceCache& sharedFaceCache()
+{
+	static FaceCache s_faceCache;
+	return s_faceCache;
+}
+
+/**
+ * Lays out and rasterizes one text. The caller must hold the mutex of the face cache.
+ */
+class BitmapDC
+{
+public:
+	BitmapDC() {
+		_data = NULL;
+		reset();
 	}
 
 	void reset() {
@@ -178,7 +365,7 @@ public:
     	return false;
     }
 
-	bool divideString(FT_Face face, const char* sText, int iMaxWidth, int iMaxHeight) {
+	bool divideString(FaceCache& cache, CachedFace* cachedFace, const char* sText, int iMaxWidth, int iMaxHeight) {
 		const char* pText = sText;
 		textLines.clear();
 		iMaxLineWidth = 0;
@@ -192,7 +379,8 @@ public:
 
 		int currentPaintPosition = 0;
 		int lastBreakIndex = -1;
-		bool hasKerning = FT_HAS_KERNING( face );
+		FT_Face face = cachedFace->face;
+		bool hasKerning = cachedFace->hasKerning;
         while ((unicode=utf8((char**)&pText))) {
             if (unicode == '\n') {
 				currentLine.calculateWidth();
@@ -210,13 +398,14 @@ public:
             	lastBreakIndex = currentLine.glyphs.size() - 1;
             }
 
-			glyphIndex = FT_Get_Char_Index(face, unicode);
-			if (FT_Load_Glyph(face, glyphIndex, FT_LOAD_DEFAULT)) {
+			const CachedGlyph* cachedGlyph = cache.getGlyph(cachedFace, unicode);
+			if (cachedGlyph == nullptr) {
 				return false;
 			}
+			glyphIndex = cachedGlyph->glyphIndex;
 
 			if (isspace(unicode)) {
-				currentPaintPosition += face->glyph->metrics.horiAdvance >> 6;
+				currentPaintPosition += cachedGlyph->horizAdvance;
 				prevGlyphIndex = glyphIndex;
 				prevCharacter = unicode;
 				lastBreakIndex = currentLine.glyphs.size();
@@ -224,10 +413,11 @@ public:
 			}
 
 			LineBreakGlyph glyph;
+			glyph.cachedGlyph = cachedGlyph;
 			glyph.glyphIndex = glyphIndex;
-			glyph.glyphWidth = face->glyph->metrics.width >> 6;
-			glyph.bearingX = face->glyph->metrics.horiBearingX >> 6;
-			glyph.horizAdvance = face->glyph->metrics.horiAdvance >> 6;
+			glyph.glyphWidth = cachedGlyph->glyphWidth;
+			glyph.bearingX = cachedGlyph->bearingX;
+			glyph.horizAdvance = cachedGlyph->horizAdvance;
 			glyph.kerning = 0;
 
 			if (prevGlyphIndex != 0 && hasKerning) {
@@ -322,80 +512,15 @@ public:
 		return baseLinePos;
 	}
 
-    std::string getFontFile(const char* family_name) {
-    	std::string fontPath = family_name;
-
-    	std::map<std::string, std::string>::iterator it = fontCache.find(family_name);
-    	if ( it != fontCache.end() ) {
-    		return it->second;
-    	}
-
-    	// check if the parameter is a font file shipped with the application
-    	std::string lowerCasePath = fontPath;
-    	std::transform(lowerCasePath.begin(), lowerCasePath.end(), lowerCasePath.begin(), ::tolower);
-    	if ( lowerCasePath.find(".ttf") != std::string::npos ) {
-    		fontPath = cocos2d::FileUtils::getInstance()->fullPathForFilename(fontPath.c_str());
-
-    		FILE *f = fopen(fontPath.c_str(), "r");
-    		if ( f ) {
-    			fclose(f);
-    			fontCache.insert(std::pair<std::string, std::string>(family_name, fontPath));
-    			return fontPath;
-    		}
-    	}
-
-    	// use fontconfig to match the parameter against the fonts installed on the system
-    	FcPattern *pattern = FcPatternBuild (0, FC_FAMILY, FcTypeString, family_name, (char *) 0);
-    	FcConfigSubstitute(0, pattern, FcMatchPattern);
-    	FcDefaultSubstitute(pattern);
-
-    	FcResult result;
-    	FcPattern *font = FcFontMatch(0, pattern, &result);
-    	if ( font ) {
-    		FcChar8 *s = NULL;
-    		if ( FcPatternGetString(font, FC_FILE, 0, &s) == FcResultMatch ) {
-    			fontPath = (const char*)s;
-
-    			FcPatternDestroy(font);
-    			FcPatternDestroy(pattern);
-
-    			fontCache.insert(std::pair<std::string, std::string>(family_name, fontPath));
-    			return fontPath;
-    		}
-    		FcPatternDestroy(font);
-    	}
-    	FcPatternDestroy(pattern);
-
-    	return family_name;
-    }
-
 	bool getBitmap(const char *text, int nWidth, int nHeight, Device::TextAlign eAlignMask, const char * pFontName, float fontSize) {
-		if (libError) {
+		FaceCache& cache = sharedFaceCache();
+		CachedFace* cachedFace = cache.getFace(pFontName, fontSize);
+		if (cachedFace == nullptr) {
 			return false;
 		}
+		FT_Face face = cachedFace->face;
 
-		FT_Face face;
-		std::string fontfile = getFontFile(pFontName);
-		if ( FT_New_Face(library, fontfile.c_str(), 0, &face) ) {
-			//no valid font found use default
-			if ( FT_New_Face(library, "/usr/share/fonts/truetype/freefont/FreeSerif.ttf", 0, &face) ) {
-				return false;
-			}
-		}
-
-		//select utf8 charmap
-		if ( FT_Select_Charmap(face, FT_ENCODING_UNICODE) ) {
-			FT_Done_Face(face);
-			return false;
-		}
-
-		if ( FT_Set_Pixel_Sizes(face, fontSize, fontSize) ) {
-			FT_Done_Face(face);
-			return false;
-		}
-
-		if ( divideString(face, text, nWidth, nHeight) == false ) {
-			FT_Done_Face(face);
+		if ( divideString(cache, cachedFace, text, nWidth, nHeight) == false ) {
 			return false;
 		}
 
@@ -422,17 +547,13 @@ public:
 
 			int glyphCount = textLines.at(line).glyphs.size();
 			for (int i = 0; i < glyphCount; i++) {
-				LineBreakGlyph glyph = textLines.at(line).glyphs.at(i);
+				const LineBreakGlyph& glyph = textLines.at(line).glyphs.at(i);
+				const CachedGlyph& cachedGlyph = *glyph.cachedGlyph;
 
-				if (FT_Load_Glyph(face, glyph.glyphIndex, FT_LOAD_RENDER)) {
-					continue;
-				}
-
-				FT_Bitmap& bitmap = face->glyph->bitmap;
-				int yoffset = iCurYCursor - (face->glyph->metrics.horiBearingY >> 6);
+				int yoffset = iCurYCursor - cachedGlyph.bearingY;
 				int xoffset = iCurXCursor + glyph.paintPosition;
 
-				for (int y = 0; y < bitmap.rows; ++y) {
+				for (int y = 0; y < cachedGlyph.bitmapRows; ++y) {
                     int iY = yoffset + y;
                     if (iY>=iMaxLineHeight) {
                         //exceed the height truncate
@@ -440,10 +561,10 @@ public:
                     }
                     iY *= iMaxLineWidth;
 
-                    int bitmap_y = y * bitmap.width;
+                    int bitmap_y = y * cachedGlyph.bitmapWidth;
 
-					for (int x = 0; x < bitmap.width; ++x) {
-						unsigned char cTemp = bitmap.buffer[bitmap_y + x];
+					for (int x = 0; x < cachedGlyph.bitmapWidth; ++x) {
+						unsigned char cTemp = cachedGlyph.bitmap[bitmap_y + x];
 						if (cTemp == 0) {
 							continue;
 						}
@@ -459,33 +580,24 @@ public:
 			iCurYCursor += lineHeight;
 		}
 
-		//  free face
-		FT_Done_Face(face);
 		return true;
 	}
 
 public:
-	FT_Library library;
-
 	unsigned char *_data;
-	int libError;
 	std::vector<LineBreakLine> textLines;
 	int iMaxLineWidth;
 	int iMaxLineHeight;
 };
 
-static BitmapDC& sharedBitmapDC()
-{
-	static BitmapDC s_BmpDC;
-	return s_BmpDC;
-}
-
 Data Device::getTextureDataForText(const char * text, const FontDefinition& textDefinition, TextAlign align, int &width, int &height, bool& hasPremultipliedAlpha)
 {
     Data ret;
     do 
     {
-        BitmapDC &dc = sharedBitmapDC();
+        // the faces and glyphs are shared, so texts can be rasterized from any thread but one at a time
+        std::lock_guard<std::mutex> lock(sharedFaceCache().mutex);
+        BitmapDC dc;
 
         CC_BREAK_IF(! dc.getBitmap(text, textDefinition._dimensions.width, textDefinition._dimensions.height, align, textDefinition._fontName.c_str(), textDefinition._fontSize));
         CC_BREAK_IF(! dc._data);
@@ -50,6 +50,7 @@ cocos2d.cpp \
 2d/CCMenuItem.cpp \
 2d/CCMotionStreak.cpp \
 2d/CCNode.cpp \
+2d/CCNodePool.cpp \
 2d/CCNodeGrid.cpp \
 2d/CCParallaxNode.cpp \
 2d/CCParticleBatchNode.cpp \
@@ -63,11 +64,13 @@ cocos2d.cpp \
 2d/CCSpriteBatchNode.cpp \
 2d/CCSprite.cpp \
 2d/CCSpriteFrameCache.cpp \
+2d/CCDynamicAtlas.cpp \
 2d/CCSpriteFrame.cpp \
 2d/CCTextFieldTTF.cpp \
 2d/CCTexture2D.cpp \
 2d/CCTextureAtlas.cpp \
 2d/CCTextureCache.cpp \
+2d/CCResourceLoader.cpp \
 2d/CCTileMapAtlas.cpp \
 2d/CCTMXLayer.cpp \
 2d/CCTMXObjectGroup.cpp \
@@ -86,6 +89,7 @@ cocos2d.cpp \
 2d/ccFPSImages.c \
 2d/platform/CCGLViewProtocol.cpp \
 2d/platform/CCFileUtils.cpp \
+2d/platform/CCMappedFile.cpp \
 2d/platform/CCSAXParser.cpp \
 2d/platform/CCThread.cpp \
 2d/platform/CCImage.cpp \
@@ -123,8 +127,11 @@ base/CCNS.cpp \
 base/CCProfiling.cpp \
 base/CCRef.cpp \
 base/CCScheduler.cpp \
+base/CCThreadPool.cpp \
+base/CCSlabAllocator.cpp \
 base/CCTouch.cpp \
 base/CCValue.cpp \
+base/CCValueView.cpp \
 base/ZipUtils.cpp \
 base/atitc.cpp \
 base/base64.cpp \
@@ -139,6 +146,7 @@ renderer/CCGLProgramStateCache.cpp \
 renderer/ccGLStateCache.cpp \
 renderer/CCGroupCommand.cpp \
 renderer/CCQuadCommand.cpp \
+renderer/CCTrianglesCommand.cpp \
 renderer/CCRenderCommand.cpp \
 renderer/CCRenderer.cpp \
 renderer/CCGLProgramCache.cpp \
@@ -93,6 +93,11 @@ public:
      */
     bool contains(Ref* object) const;
 
+    /**
+     * Returns the number of objects waiting to be released by the next `clear`.
+     */
+    ssize_t getObjectCount() const { return static_cast<ssize_t>(_managedObjectArray.size()); }
+
     /**
      * Dump the objects that are put into autorelease pool. It is used for debugging.
      *
@@ -58,9 +58,12 @@
 #include "base/CCScheduler.h"
 #include "base/CCPlatformConfig.h"
 #include "base/CCConfiguration.h"
+#include "base/CCProfiling.h"
+#include "base/CCRef.h"
 #include "2d/CCScene.h"
 #include "2d/platform/CCFileUtils.h"
 #include "2d/CCTextureCache.h"
+#include "2d/CCDynamicAtlas.h"
 #include "CCGLView.h"
 #include "base/base64.h"
 NS_CC_BEGIN
@@ -267,6 +270,7 @@ Console::Console()
 {
     // VS2012 doesn't support initializer list, so we create a new array and assign its elements to '_command'.
 	Command commands[] = {     
+        { "atlas", "Turn on / off the DynamicAtlas, remove its unused images or print its info. Args: [on | off | flush | ]", std::bind(&Console::commandAtlas, this, std::placeholders::_1, std::placeholders::_2) },
         { "config", "Print the Configuration object", std::bind(&Console::commandConfig, this, std::placeholders::_1, std::placeholders::_2) },
         { "debugmsg", "Whether or not to forward the debug messages on the console. Args: [on | off]", [&](int fd, const std::string& args) {
             if( args.compare("on")==0 || args.compare("off")==0) {
@@ -288,10 +292,12 @@ Console::Console()
             }
         } },
         { "help", "Print this message", std::bind(&Console::commandHelp, this, std::placeholders::_1, std::placeholders::_2) },
+        { "perf", "Stream per frame statistics. Args: [start [records_per_second] | stop | header | ]", std::bind(&Console::commandPerf, this, std::placeholders::_1, std::placeholders::_2) },
+        { "profiler", "Capture the profiler scopes. Args: [start | stop | frame | trace [filename] | ]", std::bind(&Console::commandProfiler, this, std::placeholders::_1, std::placeholders::_2) },
         { "projection", "Change or print the current projection. Args: [2d | 3d]", std::bind(&Console::commandProjection, this, std::placeholders::_1, std::placeholders::_2) },
         { "resolution", "Change or print the window resolution. Args: [width height resolution_policy | ]", std::bind(&Console::commandResolution, this, std::placeholders::_1, std::placeholders::_2) },
         { "scenegraph", "Print the scene graph", std::bind(&Console::commandSceneGraph, this, std::placeholders::_1, std::placeholders::_2) },
-        { "texture", "Flush or print the TextureCache info. Args: [flush | ] ", std::bind(&Console::commandTextures, this, std::placeholders::_1, std::placeholders::_2) },
+        { "texture", "Flush or print the TextureCache info, or manage its memory budget. Args: [flush | budget [MB] | stats | evict | reload | ] ", std::bind(&Console::commandTextures, this, std::placeholders::_1, std::placeholders::_2) },
         { "director", "director commands, type -h or [director help] to list supported directives", std::bind(&Console::commandDirector, this, std::placeholders::_1, std::placeholders::_2) },
         { "touch", "simulate touch event via console, type -h or [touch help] to list supported directives", std::bind(&Console::commandTouch, this, std::placeholders::_1, std::placeholders::_2) },
         { "upload", "upload file. Args: [filename base64_encoded_data]", std::bind(&Console::commandUpload, this, std::placeholders::_1) },
@@ -437,6 +443,7 @@ void Console::commandExit(int fd, const std::string &args)
 {
     FD_CLR(fd, &_read_set);
     _fds.erase(std::remove(_fds.begin(), _fds.end(), fd), _fds.end());
+    removePerfClient(fd);
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_WP8)
         closesocket(fd);
 #else
@@ -478,6 +485,134 @@ void Console::commandConfig(int fd, const std::string& args)
                                         );
 }
 
+// Columns of the records streamed by the "perf" command, one record per line.
+// Times are in microseconds and describe the last drawn frame; tools/perf-client parses this header.
+static const char PERF_HEADER[] = "#perf frame dt update visit render swap batches vertices allocs culled texture_kb refs autoreleased\n";
+static const char PERF_SCHEDULE_KEY[] = "console_perf";
+
+static long toMicroseconds(float seconds)
+{
+    return static_cast<long>(seconds * 1000000.0f);
+}
+
+void Console::commandPerf(int fd, const std::string& args)
+{
+    Scheduler *sched = Director::getInstance()->getScheduler();
+
+    if (args.compare(0, 5, "start") == 0)
+    {
+        // 0 samples every frame
+        float rate = args.length() > 6 ? std::atof(args.substr(6).c_str()) : 0;
+        float interval = rate > 0 ? 1.0f / rate : 0;
+
+        if (std::find(_perfFds.begin(), _perfFds.end(), fd) == _perfFds.end())
+        {
+            _perfFds.push_back(fd);
+        }
+        mydprintf(fd, "%s", PERF_HEADER);
+
+        // scheduling an existing key only updates its interval
+        sched->performFunctionInCocosThread( [=](){
+            sched->schedule([this](float){ samplePerfRecord(); }, this, interval, false, PERF_SCHEDULE_KEY);
+        }
+                                            );
+    }
+    else if (args.compare("stop") == 0)
+    {
+        removePerfClient(fd);
+    }
+    else if (args.compare("header") == 0)
+    {
+        mydprintf(fd, "%s", PERF_HEADER);
+    }
+    else if (args.length() == 0)
+    {
+        mydprintf(fd, "Perf stream is: %s (%d clients)\n", _perfFds.empty() ? "off" : "on", (int)_perfFds.size());
+    }
+    else
+    {
+        mydprintf(fd, "Unsupported argument: '%s'. Supported arguments: 'start [records_per_second]', 'stop', 'header' or nothing\n", args.c_str());
+    }
+}
+
+void Console::samplePerfRecord()
+{
+    Director *director = Director::getInstance();
+    const Director::FrameStats& stats = director->getLastFrameStats();
+
+    char buf[256];
+    snprintf(buf, sizeof(buf), "perf %u %ld %ld %ld %ld %ld %ld %ld %ld %ld %lu %u %ld\n",
+             director->getTotalFrames(),
+             toMicroseconds(director->getDeltaTime()),
+             toMicroseconds(stats.updateTime),
+             toMicroseconds(stats.visitTime),
+             toMicroseconds(stats.renderTime),
+             toMicroseconds(stats.swapTime),
+             (long)stats.drawnBatches,
+             (long)stats.drawnVertices,
+             (long)stats.frameAllocations,
+             (long)stats.culledNodes,
+             (unsigned long)(director->getTextureCache()->getTextureMemorySize() / 1024),
+             Ref::getLiveObjectCount(),
+             (long)stats.autoreleasedObjects);
+
+    _perfRecordsMutex.lock();
+    _perfRecords.push_back(buf);
+    _perfRecordsMutex.unlock();
+}
+
+void Console::removePerfClient(int fd)
+{
+    auto it = std::find(_perfFds.begin(), _perfFds.end(), fd);
+    if (it == _perfFds.end())
+        return;
+
+    _perfFds.erase(it);
+    if (_perfFds.empty())
+    {
+        Scheduler *sched = Director::getInstance()->getScheduler();
+        sched->performFunctionInCocosThread( [=](){
+            sched->unschedule(PERF_SCHEDULE_KEY, this);
+        }
+                                            );
+    }
+}
+
+void Console::commandAtlas(int fd, const std::string& args)
+{
+    Scheduler *sched = Director::getInstance()->getScheduler();
+
+    if (args.compare("on") == 0 || args.compare("off") == 0)
+    {
+        bool enabled = (args.compare("on") == 0);
+        sched->performFunctionInCocosThread( [=](){
+            DynamicAtlas::getInstance()->setEnabled(enabled);
+        }
+                                            );
+    }
+    else if (args.compare("flush") == 0)
+    {
+        sched->performFunctionInCocosThread( [=](){
+            int removed = DynamicAtlas::getInstance()->removeUnusedFrames();
+            mydprintf(fd, "Removed %d images\n", removed);
+            sendPrompt(fd);
+        }
+                                            );
+    }
+    else if (args.length() == 0)
+    {
+        sched->performFunctionInCocosThread( [=](){
+            mydprintf(fd, "%s", DynamicAtlas::getInstance()->getInfo().c_str());
+            sendPrompt(fd);
+        }
+                                            );
+    }
+    else
+    {
+        mydprintf(fd, "Unsupported argument: '%s'. Supported arguments: 'on', 'off', 'flush' or nothing\n", args.c_str());
+    }
+}
+
 void Console::commandResolution(int fd, const std::string& args)
 {
     if(args.length()==0) {
@@ -581,12 +716,110 @@ void Console::commandTextures(int fd, const std::string& args)
         }
                                             );
     }
+    else if(args.compare(0, 6, "budget")==0)
+    {
+        if(args.length() > 7)
+        {
+            size_t bytes = static_cast<size_t>(std::atof(args.substr(7).c_str()) * 1024 * 1024);
+            sched->performFunctionInCocosThread( [=](){
+                Director::getInstance()->getTextureCache()->setMemoryBudget(bytes);
+            }
+                                                );
+        }
+        else
+        {
+            size_t budget = Director::getInstance()->getTextureCache()->getMemoryBudget();
+            if(budget > 0)
+                mydprintf(fd, "Texture memory budget is: %.2f MB\n", budget / (1024.0f*1024.0f));
+            else
+                mydprintf(fd, "Texture memory budget is: off\n");
+        }
+    }
+    else if(args.compare("stats")==0)
+    {
+        sched->performFunctionInCocosThread( [=](){
+            TextureCache *cache = Director::getInstance()->getTextureCache();
+            const TextureCache::EvictionStats& stats = cache->getEvictionStats();
+            mydprintf(fd, "Texture memory: %.2f MB, budget: %.2f MB\nEvicted: %u textures, %.2f MB\nReloaded after eviction: %u textures\n",
+                      cache->getTextureMemorySize() / (1024.0f*1024.0f),
+                      cache->getMemoryBudget() / (1024.0f*1024.0f),
+                      stats.evictedTextures,
+                      stats.evictedBytes / (1024.0f*1024.0f),
+                      stats.reloadedTextures);
+            sendPrompt(fd);
+        }
+                                            );
+    }
+    else if(args.compare("evict")==0)
+    {
+        sched->performFunctionInCocosThread( [=](){
+            size_t freed = Director::getInstance()->getTextureCache()->evictUnusedTextures(0);
+            mydprintf(fd, "Evicted %.2f MB\n", freed / (1024.0f*1024.0f));
+            sendPrompt(fd);
+        }
+                                            );
+    }
+    else if(args.compare("reload")==0)
+    {
+        sched->performFunctionInCocosThread( [](){
+            Director::getInstance()->getTextureCache()->reloadEvictedTextures();
+        }
+                                            );
+    }
     else
     {
-        mydprintf(fd, "Unsupported argument: '%s'. Supported arguments: 'flush' or nothing", args.c_str());
+        mydprintf(fd, "Unsupported argument: '%s'. Supported arguments: 'flush', 'budget [MB]', 'stats', 'evict', 'reload' or nothing", args.c_str());
     }
 }
 
+void Console::commandProfiler(int fd, const std::string& args)
+{
+    Scheduler *sched = Director::getInstance()->getScheduler();
+    auto trace = ProfilerTrace::getInstance();
+
+    if (args.compare("start") == 0)
+    {
+#if !CC_ENABLE_PROFILERS
+        mydprintf(fd, "Warning: the engine is built with CC_ENABLE_PROFILERS=0, only the custom scopes are recorded\n");
+#endif
+        sched->performFunctionInCocosThread( [](){
+            ProfilerTrace::getInstance()->startCapture();
+        }
+                                            );
+    }
+    else if (args.compare("stop") == 0)
+    {
+        sched->performFunctionInCocosThread( [](){
+            ProfilerTrace::getInstance()->stopCapture();
+        }
+                                            );
+    }
+    else if (args.compare("frame") == 0)
+    {
+        mydprintf(fd, "%s", trace->getLastFrameSummary().c_str());
+    }
+    else if (args.compare(0, 5, "trace") == 0)
+    {
+        std::string filename = args.length() > 6 ? args.substr(6) : "profiler_trace.json";
+        std::string fullPath = _writablePath + filename;
+        if (trace->writeChromeTrace(fullPath))
+        {
+            mydprintf(fd, "Trace written to %s, open it in chrome://tracing\n", fullPath.c_str());
+        }
+        else
+        {
+            mydprintf(fd, "Can't write %s\n", fullPath.c_str());
+        }
+    }
+    else if (args.length() == 0)
+    {
+        mydprintf(fd, "Profiler capture is: %s\n", trace->isCapturing() ? "on" : "off");
+    }
+    else
+    {
+        mydprintf(fd, "Unsupported argument: '%s'. Supported arguments: 'start', 'stop', 'frame', 'trace [filename]' or nothing\n", args.c_str());
+    }
+}
 
 void Console::commandDirector(int fd, const std::string& args)
 {
@@ -1096,6 +1329,7 @@ void Console::loop()
             for(int fd: to_remove) {
                 FD_CLR(fd, &_read_set);
                 _fds.erase(std::remove(_fds.begin(), _fds.end(), fd), _fds.end());
+                removePerfClient(fd);
             }
         }
 
@@ -1110,6 +1344,20 @@ void Console::loop()
             _DebugStrings.clear();
             _DebugStringsMutex.unlock();
         }
+
+        /* Stream the perf records to the clients that asked for them */
+        if( !_perfRecords.empty() ) {
+            std::vector<std::string> records;
+            _perfRecordsMutex.lock();
+            records.swap(_perfRecords);
+            _perfRecordsMutex.unlock();
+
+            std::string buffer;
+            for(const auto &record : records)
+                buffer += record;
+            for(const auto &fd : _perfFds)
+                send(fd, buffer.c_str(), buffer.length(), 0);
+        }
     }
 
     // clean up: ignore stdin, stdout and stderr
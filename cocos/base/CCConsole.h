@@ -111,16 +111,23 @@ protected:
 
     // Add commands here
     void commandHelp(int fd, const std::string &args);
+    void commandAtlas(int fd, const std::string &args);
     void commandExit(int fd, const std::string &args);
     void commandSceneGraph(int fd, const std::string &args);
     void commandFileUtils(int fd, const std::string &args);
     void commandConfig(int fd, const std::string &args);
     void commandTextures(int fd, const std::string &args);
+    void commandProfiler(int fd, const std::string &args);
+    void commandPerf(int fd, const std::string &args);
     void commandResolution(int fd, const std::string &args);
     void commandProjection(int fd, const std::string &args);
     void commandDirector(int fd, const std::string &args);
     void commandTouch(int fd, const std::string &args);
     void commandUpload(int fd);
+
+    // "perf" stream: records are sampled in the cocos thread and sent by the console thread
+    void samplePerfRecord();
+    void removePerfClient(int fd);
     // file descriptor: socket, console, etc.
     int _listenfd;
     int _maxfd;
@@ -141,6 +148,11 @@ protected:
     std::mutex _DebugStringsMutex;
     std::vector<std::string> _DebugStrings;
 
+    // clients receiving the "perf" records, only accessed by the console thread
+    std::vector<int> _perfFds;
+    std::mutex _perfRecordsMutex;
+    std::vector<std::string> _perfRecords;
+
     intptr_t _touchId;
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Console);
@@ -30,11 +30,13 @@ THE SOFTWARE.
 
 // standard includes
 #include <string>
+#include <chrono>
 
 #include "2d/ccFPSImages.h"
 #include "2d/CCDrawingPrimitives.h"
 #include "2d/CCScene.h"
 #include "2d/CCSpriteFrameCache.h"
+#include "2d/CCDynamicAtlas.h"
 #include "2d/platform/CCFileUtils.h"
 #include "renderer/ccGLStateCache.h"
 #include "2d/platform/CCImage.h"
@@ -57,6 +59,7 @@ THE SOFTWARE.
 #include "base/CCAutoreleasePool.h"
 #include "base/CCProfiling.h"
 #include "base/CCConfiguration.h"
+#include "base/CCThreadPool.h"
 #include "renderer/CCRenderer.h"
 #include "base/CCNS.h"
 #include "math/CCMath.h"
@@ -121,6 +124,7 @@ bool Director::init(void)
     _FPSLabel = _drawnBatchesLabel = _drawnVerticesLabel = nullptr;
     _totalFrames = _frames = 0;
     _lastUpdate = new struct timeval;
+    memset(&_lastFrameStats, 0, sizeof(_lastFrameStats));
 
     // paused ?
     _paused = false;
@@ -250,9 +254,20 @@ void Director::setGLDefaultValues()
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 }
 
+// returns the seconds elapsed since 'start' and moves 'start' to now
+static float lapTime(std::chrono::steady_clock::time_point& start)
+{
+    auto now = std::chrono::steady_clock::now();
+    float seconds = std::chrono::duration<float>(now - start).count();
+    start = now;
+    return seconds;
+}
+
 // Draw the Scene
 void Director::drawScene()
 {
+    CC_PROFILER_SCOPE("Director - drawScene");
+
     // calculate "global" dt
     calculateDeltaTime();
     
@@ -267,12 +282,15 @@ void Director::drawScene()
         _openGLView->pollInputEvents();
     }
 
+    auto phaseStart = std::chrono::steady_clock::now();
+
     //tick before glClear: issue #533
     if (! _paused)
     {
         _scheduler->update(_deltaTime);
         _eventDispatcher->dispatchEvent(_eventAfterUpdate);
     }
+    _lastFrameStats.updateTime = lapTime(phaseStart);
 
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -302,9 +320,15 @@ void Director::drawScene()
     {
         showStats();
     }
+    _lastFrameStats.visitTime = lapTime(phaseStart);
 
     _renderer->render();
     _eventDispatcher->dispatchEvent(_eventAfterDraw);
+    _lastFrameStats.renderTime = lapTime(phaseStart);
+    _lastFrameStats.drawnBatches = _renderer->getDrawnBatches();
+    _lastFrameStats.drawnVertices = _renderer->getDrawnVertices();
+    _lastFrameStats.frameAllocations = _renderer->getFrameAllocations();
+    _lastFrameStats.culledNodes = _renderer->getCulledNodes();
 
     popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
 
@@ -315,6 +339,7 @@ void Director::drawScene()
     {
         _openGLView->swapBuffers();
     }
+    _lastFrameStats.swapTime = lapTime(phaseStart);
 
     if (_displayStats)
     {
@@ -668,6 +693,7 @@ void Director::purgeCachedData(void)
     if (s_SharedDirector->getOpenGLView())
     {
         SpriteFrameCache::getInstance()->removeUnusedSpriteFrames();
+        DynamicAtlas::getInstance()->removeUnusedFrames();
         _textureCache->removeUnusedTextures();
 
         // Note: some tests such as ActionsTest are leaking refcounted textures
@@ -938,6 +964,9 @@ void Director::purgeDirector()
 
     stopAnimation();
 
+    // the queued tasks may still use the caches and FileUtils, they are done before these are purged
+    ThreadPool::destroyInstance();
+
     CC_SAFE_RELEASE_NULL(_FPSLabel);
     CC_SAFE_RELEASE_NULL(_drawnBatchesLabel);
     CC_SAFE_RELEASE_NULL(_drawnVerticesLabel);
@@ -951,6 +980,7 @@ void Director::purgeDirector()
     DrawPrimitives::free();
     AnimationCache::destroyInstance();
     SpriteFrameCache::destroyInstance();
+    DynamicAtlas::destroyInstance();
     GLProgramCache::destroyInstance();
     GLProgramStateCache::destroyInstance();
     FileUtils::destroyInstance();
@@ -1250,7 +1280,9 @@ void DisplayLinkDirector::mainLoop()
         drawScene();
      
         // release the objects
-        PoolManager::getInstance()->getCurrentPool()->clear();
+        auto pool = PoolManager::getInstance()->getCurrentPool();
+        _lastFrameStats.autoreleasedObjects = pool->getObjectCount();
+        pool->clear();
     }
 }
 
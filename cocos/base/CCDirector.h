@@ -183,6 +183,23 @@ public:
 
     /** How many frames were called since the director started */
     inline unsigned int getTotalFrames() { return _totalFrames; }
+
+    /** Timings and counters of the last drawn frame, as streamed by the "perf" console command */
+    struct FrameStats
+    {
+        float updateTime;   // seconds spent in Scheduler::update()
+        float visitTime;    // seconds spent visiting the scene graph
+        float renderTime;   // seconds spent in Renderer::render()
+        float swapTime;     // seconds spent swapping the buffers
+        ssize_t drawnBatches;
+        ssize_t drawnVertices;
+        ssize_t frameAllocations;       // allocations made in the frame arena of the renderer
+        ssize_t culledNodes;            // nodes skipped by the containers culling their subtrees
+        ssize_t autoreleasedObjects;    // objects released by the autorelease pool after the frame
+    };
+
+    /** Returns the statistics of the last drawn frame */
+    inline const FrameStats& getLastFrameStats() const { return _lastFrameStats; }
     
     /** Sets an OpenGL projection
      @since v0.8.2
@@ -468,6 +485,9 @@ protected:
     unsigned int _totalFrames;
     unsigned int _frames;
     float _secondsPerFrame;
+
+    /* statistics of the last drawn frame */
+    FrameStats _lastFrameStats;
     
     /* The running scene */
     Scene *_runningScene;
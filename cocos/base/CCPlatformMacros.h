@@ -296,6 +296,15 @@ public: virtual void set##funName(varType var)   \
 #define CC_UNUSED
 #endif
 
+/** @def CC_NOEXCEPT
+ * Lets the standard containers move the objects instead of copying them, Visual Studio 2013 doesn't know noexcept.
+ */
+#if defined(_MSC_VER) && (_MSC_VER < 1900)
+#define CC_NOEXCEPT throw()
+#else
+#define CC_NOEXCEPT noexcept
+#endif
+
 //
 // CC_REQUIRES_NULL_TERMINATION
 //
@@ -26,6 +26,12 @@ THE SOFTWARE.
 #include "base/CCProfiling.h"
 
 #include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <sstream>
+#include <stdio.h>
 
 using namespace std;
 
@@ -93,6 +99,12 @@ void Profiler::displayTimers()
         ProfilingTimer* timer = iter->second;
         log("%s", timer->getDescription().c_str());
     }
+
+    auto trace = ProfilerTrace::getInstance();
+    if (trace->isCapturing())
+    {
+        log("%s", trace->getLastFrameSummary().c_str());
+    }
 }
 
 // implementation of ProfilingTimer
@@ -137,6 +149,309 @@ void ProfilingTimer::reset()
     _startTime = chrono::high_resolution_clock::now();
 }
 
+// implementation of ProfilerTrace
+
+namespace
+{
+    struct TraceEvent
+    {
+        long long time;             // nanoseconds since the start of the capture
+        unsigned int scopeId;
+        unsigned int begin;
+    };
+
+    // one ring buffer per thread, written by its thread only
+    struct TraceBuffer
+    {
+        std::atomic<bool> claimed;
+        std::atomic<bool> ready;
+        std::thread::id owner;
+        TraceEvent* events;
+        std::atomic<unsigned int> count;  // number of events ever written since the capture started
+    };
+
+    const int TRACE_MAX_THREADS = 32;
+    const unsigned int TRACE_BUFFER_SIZE = 1 << 16;  // events per thread, a power of 2
+
+    TraceBuffer s_traceBuffers[TRACE_MAX_THREADS];
+    std::chrono::high_resolution_clock::time_point s_traceStart;
+    std::thread::id s_traceMainThread;
+
+    std::mutex s_scopeMutex;
+    std::vector<std::string> s_scopeNames;
+
+    TraceBuffer* getThreadBuffer()
+    {
+        auto threadId = std::this_thread::get_id();
+        for (int i = 0; i < TRACE_MAX_THREADS; ++i)
+        {
+            TraceBuffer& buffer = s_traceBuffers[i];
+            if (!buffer.ready.load(std::memory_order_acquire))
+            {
+                if (!buffer.claimed.load(std::memory_order_relaxed))
+                    break;
+                continue;
+            }
+            if (buffer.owner == threadId)
+                return &buffer;
+        }
+
+        // first event of this thread
+        for (int i = 0; i < TRACE_MAX_THREADS; ++i)
+        {
+            TraceBuffer& buffer = s_traceBuffers[i];
+            bool expected = false;
+            if (buffer.claimed.compare_exchange_strong(expected, true))
+            {
+                buffer.owner = threadId;
+                buffer.events = new TraceEvent[TRACE_BUFFER_SIZE];
+                buffer.count.store(0, std::memory_order_relaxed);
+                buffer.ready.store(true, std::memory_order_release);
+                return &buffer;
+            }
+        }
+        return nullptr;
+    }
+
+    // copies the events still in the ring buffer, oldest first
+    void copyEvents(const TraceBuffer& buffer, std::vector<TraceEvent>& events)
+    {
+        unsigned int count = buffer.count.load(std::memory_order_acquire);
+        unsigned int first = count > TRACE_BUFFER_SIZE ? count - TRACE_BUFFER_SIZE : 0;
+        events.clear();
+        events.reserve(count - first);
+        for (unsigned int i = first; i < count; ++i)
+        {
+            events.push_back(buffer.events[i & (TRACE_BUFFER_SIZE - 1)]);
+        }
+    }
+
+    void escapeJSON(std::ostringstream& stream, const std::string& str)
+    {
+        for (char c : str)
+        {
+            if (c == '"' || c == '\\')
+                stream << '\\' << c;
+            else if ((unsigned char)c >= 0x20)
+                stream << c;
+        }
+    }
+
+    struct SummaryNode
+    {
+        unsigned int scopeId;
+        int calls;
+        long long time;
+        std::vector<SummaryNode> children;
+    };
+
+    SummaryNode* findChild(SummaryNode* parent, unsigned int scopeId)
+    {
+        for (auto& child : parent->children)
+        {
+            if (child.scopeId == scopeId)
+                return &child;
+        }
+        SummaryNode node = { scopeId, 0, 0 };
+        parent->children.push_back(node);
+        return &parent->children.back();
+    }
+
+    void printSummary(std::ostringstream& stream, const SummaryNode& node, int depth)
+    {
+        char line[256];
+        snprintf(line, sizeof(line), "%*s%s :: %.3f ms, %d calls\n", depth * 2, "",
+                 ProfilerTrace::getScopeName(node.scopeId).c_str(), node.time / 1000000.0, node.calls);
+        stream << line;
+        for (const auto& child : node.children)
+        {
+            printSummary(stream, child, depth + 1);
+        }
+    }
+}
+
+std::atomic<bool> ProfilerTrace::s_capturing(false);
+
+ProfilerTrace* ProfilerTrace::getInstance()
+{
+    static ProfilerTrace s_instance;
+    return &s_instance;
+}
+
+ProfilerTrace::ProfilerTrace()
+{
+}
+
+unsigned int ProfilerTrace::registerScope(const char* scopeName)
+{
+    std::lock_guard<std::mutex> lock(s_scopeMutex);
+    auto iter = std::find(s_scopeNames.begin(), s_scopeNames.end(), scopeName);
+    if (iter != s_scopeNames.end())
+    {
+        return static_cast<unsigned int>(iter - s_scopeNames.begin());
+    }
+    s_scopeNames.push_back(scopeName);
+    return static_cast<unsigned int>(s_scopeNames.size() - 1);
+}
+
+std::string ProfilerTrace::getScopeName(unsigned int scopeId)
+{
+    std::lock_guard<std::mutex> lock(s_scopeMutex);
+    return scopeId < s_scopeNames.size() ? s_scopeNames[scopeId] : "";
+}
+
+void ProfilerTrace::recordEvent(unsigned int scopeId, bool begin)
+{
+    // should be the 1st instruction of an end event and the last of a begin event to be more reliable
+    auto now = chrono::high_resolution_clock::now();
+
+    TraceBuffer* buffer = getThreadBuffer();
+    if (!buffer)
+        return;
+
+    unsigned int index = buffer->count.load(std::memory_order_relaxed);
+    TraceEvent& event = buffer->events[index & (TRACE_BUFFER_SIZE - 1)];
+    event.scopeId = scopeId;
+    event.begin = begin;
+    if (begin)
+        now = chrono::high_resolution_clock::now();
+    event.time = chrono::duration_cast<chrono::nanoseconds>(now - s_traceStart).count();
+    buffer->count.store(index + 1, std::memory_order_release);
+}
+
+void ProfilerTrace::startCapture()
+{
+    s_capturing = false;
+    for (auto& buffer : s_traceBuffers)
+    {
+        buffer.count.store(0, std::memory_order_relaxed);
+    }
+    s_traceMainThread = std::this_thread::get_id();
+    s_traceStart = chrono::high_resolution_clock::now();
+    s_capturing = true;
+}
+
+void ProfilerTrace::stopCapture()
+{
+    s_capturing = false;
+}
+
+std::string ProfilerTrace::getChromeTrace() const
+{
+    std::ostringstream stream;
+    stream << "{\"traceEvents\":[";
+
+    bool first = true;
+    std::vector<TraceEvent> events;
+    for (int i = 0; i < TRACE_MAX_THREADS; ++i)
+    {
+        const TraceBuffer& buffer = s_traceBuffers[i];
+        if (!buffer.ready.load(std::memory_order_acquire))
+            continue;
+
+        copyEvents(buffer, events);
+        for (const auto& event : events)
+        {
+            stream << (first ? "\n" : ",\n") << "{\"name\":\"";
+            escapeJSON(stream, getScopeName(event.scopeId));
+            char fields[128];
+            snprintf(fields, sizeof(fields), "\",\"cat\":\"cocos2d\",\"ph\":\"%s\",\"ts\":%.3f,\"pid\":1,\"tid\":%d}",
+                     event.begin ? "B" : "E", event.time / 1000.0, i + 1);
+            stream << fields;
+            first = false;
+        }
+
+        stream << (first ? "\n" : ",\n");
+        stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << i + 1
+               << ",\"args\":{\"name\":\"" << (buffer.owner == s_traceMainThread ? "cocos" : "worker") << "\"}}";
+        first = false;
+    }
+
+    stream << "\n]}\n";
+    return stream.str();
+}
+
+bool ProfilerTrace::writeChromeTrace(const std::string& fullPath) const
+{
+    FILE* fp = fopen(fullPath.c_str(), "wb");
+    if (!fp)
+    {
+        log("ProfilerTrace: can't open %s", fullPath.c_str());
+        return false;
+    }
+    std::string trace = getChromeTrace();
+    bool ok = fwrite(trace.data(), 1, trace.size(), fp) == trace.size();
+    fclose(fp);
+    return ok;
+}
+
+std::string ProfilerTrace::getLastFrameSummary() const
+{
+    const TraceBuffer* mainBuffer = nullptr;
+    for (const auto& buffer : s_traceBuffers)
+    {
+        if (buffer.ready.load(std::memory_order_acquire) && buffer.owner == s_traceMainThread)
+        {
+            mainBuffer = &buffer;
+            break;
+        }
+    }
+    if (!mainBuffer)
+        return "No frame captured\n";
+
+    std::vector<TraceEvent> events;
+    copyEvents(*mainBuffer, events);
+
+    // the last root scope whose end was recorded is the last complete frame
+    int depth = 0;
+    int rootBegin = -1;
+    int frameBegin = -1;
+    int frameEnd = -1;
+    for (int i = 0; i < (int)events.size(); ++i)
+    {
+        if (events[i].begin)
+        {
+            if (depth++ == 0)
+                rootBegin = i;
+        }
+        else if (depth > 0)
+        {
+            if (--depth == 0)
+            {
+                frameBegin = rootBegin;
+                frameEnd = i;
+            }
+        }
+        // else: the begin event was overwritten in the ring buffer
+    }
+
+    if (frameBegin >= 0)
+    {
+        // replay the frame, summing the calls of the same scope under the same parent
+        SummaryNode root = { events[frameBegin].scopeId, 0, 0 };
+        std::vector<std::pair<SummaryNode*, long long>> stack;
+        for (int i = frameBegin; i <= frameEnd; ++i)
+        {
+            if (events[i].begin)
+            {
+                SummaryNode* node = stack.empty() ? &root : findChild(stack.back().first, events[i].scopeId);
+                node->calls++;
+                stack.push_back(std::make_pair(node, events[i].time));
+            }
+            else if (!stack.empty())
+            {
+                stack.back().first->time += events[i].time - stack.back().second;
+                stack.pop_back();
+            }
+        }
+
+        std::ostringstream stream;
+        printSummary(stream, root, 0);
+        return stream.str();
+    }
+    return "No complete frame captured\n";
+}
+
 void ProfilingBeginTimingBlock(const char *timerName)
 {
     Profiler* p = Profiler::getInstance();
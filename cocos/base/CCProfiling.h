@@ -28,6 +28,7 @@ THE SOFTWARE.
 
 #include <string>
 #include <chrono>
+#include <atomic>
 #include "base/ccConfig.h"
 #include "base/CCRef.h"
 #include "base/CCMap.h"
@@ -143,6 +144,97 @@ public:
     long numberOfCalls;
 };
 
+/** @brief Low overhead scope profiler used by the CC_PROFILER_* macros.
+
+ A scope name is registered once and identified by its index afterwards: the macros keep the id in a function
+ local static, so recording a begin or an end event is a clock read and a store in the ring buffer of the calling
+ thread, without lookup nor lock. Nothing is recorded until startCapture() is called.
+
+ The scopes of a thread nest, the root scopes of the cocos thread being the frames ("Director - drawScene").
+ The captured events can be exported in the Chrome trace event format (chrome://tracing) or summarized as the
+ scope tree of the last frame. The "profiler" console command drives the capture remotely.
+ */
+class CC_DLL ProfilerTrace
+{
+public:
+    /** returns the singleton
+     * @js NA
+     * @lua NA
+     */
+    static ProfilerTrace* getInstance();
+
+    /** Returns the id of a scope, registering its name on first use.
+     * @js NA
+     * @lua NA
+     */
+    static unsigned int registerScope(const char* scopeName);
+    /**
+     * @js NA
+     * @lua NA
+     */
+    static std::string getScopeName(unsigned int scopeId);
+
+    /**
+     * @js NA
+     * @lua NA
+     */
+    static inline void beginScope(unsigned int scopeId) { if (s_capturing.load(std::memory_order_relaxed)) recordEvent(scopeId, true); }
+    /**
+     * @js NA
+     * @lua NA
+     */
+    static inline void endScope(unsigned int scopeId) { if (s_capturing.load(std::memory_order_relaxed)) recordEvent(scopeId, false); }
+
+    /** Clears the recorded events and starts recording, call it from the cocos thread.
+     * @js NA
+     * @lua NA
+     */
+    void startCapture();
+    /**
+     * @js NA
+     * @lua NA
+     */
+    void stopCapture();
+    /**
+     * @js NA
+     * @lua NA
+     */
+    bool isCapturing() const { return s_capturing.load(std::memory_order_relaxed); }
+
+    /** Returns the recorded events in the Chrome trace event JSON format
+     * @js NA
+     * @lua NA
+     */
+    std::string getChromeTrace() const;
+    /**
+     * @js NA
+     * @lua NA
+     */
+    bool writeChromeTrace(const std::string& fullPath) const;
+    /** Returns the scope tree of the last complete frame of the cocos thread, with the time spent in each scope
+     * @js NA
+     * @lua NA
+     */
+    std::string getLastFrameSummary() const;
+
+private:
+    ProfilerTrace();
+    static void recordEvent(unsigned int scopeId, bool begin);
+
+    static std::atomic<bool> s_capturing;
+};
+
+/** Records a scope until the end of the C++ block, see CC_PROFILER_SCOPE */
+class ProfilerScope
+{
+public:
+    explicit ProfilerScope(unsigned int scopeId) : _scopeId(scopeId) { ProfilerTrace::beginScope(scopeId); }
+    ~ProfilerScope() { ProfilerTrace::endScope(_scopeId); }
+
+private:
+    unsigned int _scopeId;
+};
+
 extern void ProfilingBeginTimingBlock(const char *timerName);
 extern void ProfilingEndTimingBlock(const char *timerName);
 extern void ProfilingResetTimingBlock(const char *timerName);
@@ -32,6 +32,8 @@ THE SOFTWARE.
 #include <algorithm>    // std::find
 #endif
 
+#include <atomic>
+
 NS_CC_BEGIN
 
 #if CC_USE_MEM_LEAK_DETECTION
@@ -39,9 +41,14 @@ static void trackRef(Ref* ref);
 static void untrackRef(Ref* ref);
 #endif
 
+// Refs may be created by loader threads, relaxed ordering is enough for a statistic
+static std::atomic<unsigned int> s_liveObjectCount(0);
+
 Ref::Ref()
 : _referenceCount(1) // when the Ref is created, the reference count of it is 1
 {
+    s_liveObjectCount.fetch_add(1, std::memory_order_relaxed);
+
 #if CC_ENABLE_SCRIPT_BINDING
     static unsigned int uObjectCount = 0;
     _luaID = 0;
@@ -55,6 +62,8 @@ Ref::Ref()
 
 Ref::~Ref()
 {
+    s_liveObjectCount.fetch_sub(1, std::memory_order_relaxed);
+
 #if CC_ENABLE_SCRIPT_BINDING
     // if the object is referenced by Lua engine, remove it
     if (_luaID)
@@ -144,6 +153,11 @@ unsigned int Ref::getReferenceCount() const
     return _referenceCount;
 }
 
+unsigned int Ref::getLiveObjectCount()
+{
+    return s_liveObjectCount.load(std::memory_order_relaxed);
+}
+
 #if CC_USE_MEM_LEAK_DETECTION
 
 static std::list<Ref*> __refAllocationList;
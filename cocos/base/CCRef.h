@@ -114,6 +114,12 @@ public:
      */
     unsigned int getReferenceCount() const;
 
+    /**
+     * Returns how many Refs are alive, i.e. constructed and not yet destructed.
+     * @js NA
+     */
+    static unsigned int getLiveObjectCount();
+
 protected:
     /**
      * Constructor
@@ -27,6 +27,7 @@ THE SOFTWARE.
 
 #include "base/CCScheduler.h"
 #include "base/ccMacros.h"
+#include "base/CCProfiling.h"
 #include "base/CCDirector.h"
 #include "2d/utlist.h"
 #include "2d/ccCArray.h"
@@ -814,6 +815,8 @@ void Scheduler::performFunctionInCocosThread(const std::function<void ()> &funct
 // main loop
 void Scheduler::update(float dt)
 {
+    CC_PROFILER_SCOPE("Scheduler - update");
+
     _updateHashLocked = true;
 
     if (_timeScale != 1.0f)
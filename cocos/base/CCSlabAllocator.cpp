@@ -0,0 +1,140 @@
+/****************************************************************************
+Copyright (c) 2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "base/CCSlabAllocator.h"
+
+#include <cstdlib>
+#include <algorithm>
+
+NS_CC_BEGIN
+
+static const size_t GRANULARITY = 16;
+
+static inline size_t sizeClassOf(size_t size)
+{
+    return size == 0 ? 0 : (size - 1) / GRANULARITY;
+}
+
+SlabAllocator::SlabAllocator(size_t maxObjectSize, size_t slabSize)
+: _maxObjectSize((maxObjectSize + GRANULARITY - 1) / GRANULARITY * GRANULARITY)
+, _slabSize(std::max(slabSize, _maxObjectSize))
+{
+    _freeLists.resize(_maxObjectSize / GRANULARITY, nullptr);
+    _stats.allocations = 0;
+    _stats.deallocations = 0;
+    _stats.liveObjects = 0;
+    _stats.heapAllocations = 0;
+    _stats.slabs = 0;
+    _stats.reservedBytes = 0;
+}
+
+SlabAllocator::~SlabAllocator()
+{
+    if (_stats.liveObjects != 0)
+    {
+        CCLOG("SlabAllocator: %ld objects are still allocated", (long)_stats.liveObjects);
+    }
+
+    for (auto slab : _slabs)
+    {
+        free(slab);
+    }
+}
+
+void* SlabAllocator::allocate(size_t size)
+{
+    ++_stats.allocations;
+    ++_stats.liveObjects;
+
+    if (size > _maxObjectSize)
+    {
+        ++_stats.heapAllocations;
+        return malloc(size);
+    }
+
+    size_t sizeClass = sizeClassOf(size);
+    if (_freeLists[sizeClass] == nullptr)
+    {
+        allocateSlab(sizeClass);
+        if (_freeLists[sizeClass] == nullptr)
+        {
+            --_stats.liveObjects;
+            return nullptr;
+        }
+    }
+
+    FreeObject* object = _freeLists[sizeClass];
+    _freeLists[sizeClass] = object->next;
+    return object;
+}
+
+void SlabAllocator::deallocate(void* ptr, size_t size)
+{
+    if (ptr == nullptr)
+    {
+        return;
+    }
+
+    ++_stats.deallocations;
+    --_stats.liveObjects;
+
+    if (size > _maxObjectSize)
+    {
+        free(ptr);
+        return;
+    }
+
+    size_t sizeClass = sizeClassOf(size);
+    FreeObject* object = static_cast<FreeObject*>(ptr);
+    object->next = _freeLists[sizeClass];
+    _freeLists[sizeClass] = object;
+}
+
+void SlabAllocator::allocateSlab(size_t sizeClass)
+{
+    size_t objectSize = (sizeClass + 1) * GRANULARITY;
+    size_t count = _slabSize / objectSize;
+
+    // the objects are multiples of 16 bytes, so they keep the alignment of malloc()
+    unsigned char* slab = static_cast<unsigned char*>(malloc(count * objectSize));
+    if (slab == nullptr)
+    {
+        return;
+    }
+    _slabs.push_back(slab);
+    ++_stats.slabs;
+    _stats.reservedBytes += count * objectSize;
+
+    // the objects are chained in address order, so that consecutive allocations are adjacent
+    FreeObject* next = _freeLists[sizeClass];
+    for (size_t i = count; i > 0; --i)
+    {
+        FreeObject* object = reinterpret_cast<FreeObject*>(slab + (i - 1) * objectSize);
+        object->next = next;
+        next = object;
+    }
+    _freeLists[sizeClass] = next;
+}
+
+NS_CC_END
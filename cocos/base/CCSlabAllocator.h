@@ -0,0 +1,86 @@
+/****************************************************************************
+Copyright (c) 2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CCSLABALLOCATOR_H__
+#define __CCSLABALLOCATOR_H__
+
+#include <cstddef>
+#include <vector>
+#include "base/ccMacros.h"
+
+NS_CC_BEGIN
+
+/** Allocator for many small objects of a few sizes, like the nodes.
+ The sizes are rounded up to a multiple of 16 bytes, and each size class carves its objects out of slabs,
+ big blocks allocated from the heap. The freed objects are kept in a free list of their class, so that creating
+ and destroying objects of the same size again and again never reaches the heap, and objects of the same kind
+ stay close to each other in memory. The slabs are only given back to the heap by the destructor.
+ Objects bigger than the largest class are allocated with malloc().
+ It is not thread safe.
+ */
+class CC_DLL SlabAllocator
+{
+public:
+    struct Stats
+    {
+        ssize_t allocations;        // allocate() calls since the creation of the allocator
+        ssize_t deallocations;      // deallocate() calls since the creation of the allocator
+        ssize_t liveObjects;        // objects allocated and not deallocated yet
+        ssize_t heapAllocations;    // objects too big for the size classes, allocated with malloc()
+        ssize_t slabs;              // slabs allocated from the heap
+        size_t reservedBytes;       // bytes of all the slabs
+    };
+
+    /** maxObjectSize is the size of the largest class, slabSize the size of the blocks the objects are carved out of */
+    explicit SlabAllocator(size_t maxObjectSize = 2048, size_t slabSize = 32 * 1024);
+    /** Frees the slabs. The objects allocated from them must have been deallocated */
+    ~SlabAllocator();
+
+    /** Returns memory for an object of 'size' bytes, aligned like the memory returned by malloc() */
+    void* allocate(size_t size);
+    /** Gives back the memory of an object. 'size' must be the size given to allocate() */
+    void deallocate(void* ptr, size_t size);
+
+    const Stats& getStats() const { return _stats; }
+
+private:
+    struct FreeObject
+    {
+        FreeObject* next;
+    };
+
+    void allocateSlab(size_t sizeClass);
+
+    std::vector<FreeObject*> _freeLists;    // one list per size class
+    std::vector<void*> _slabs;
+    size_t _maxObjectSize;
+    size_t _slabSize;
+    Stats _stats;
+
+    CC_DISALLOW_COPY_AND_ASSIGN(SlabAllocator);
+};
+
+NS_CC_END
+
+#endif // __CCSLABALLOCATOR_H__
@@ -0,0 +1,182 @@
+/****************************************************************************
+Copyright (c) 2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "base/CCThreadPool.h"
+
+#include <algorithm>
+#include <memory>
+
+NS_CC_BEGIN
+
+std::atomic<ThreadPool*> ThreadPool::s_sharedThreadPool(nullptr);
+std::mutex ThreadPool::s_sharedThreadPoolMutex;
+
+ThreadPool* ThreadPool::getInstance()
+{
+    // the first call may come from a loading thread
+    ThreadPool* pool = s_sharedThreadPool.load(std::memory_order_acquire);
+    if (pool == nullptr)
+    {
+        std::lock_guard<std::mutex> lock(s_sharedThreadPoolMutex);
+        pool = s_sharedThreadPool.load(std::memory_order_relaxed);
+        if (pool == nullptr)
+        {
+            int count = static_cast<int>(std::thread::hardware_concurrency()) - 1;
+            pool = new ThreadPool(std::max(count, 1));
+            s_sharedThreadPool.store(pool, std::memory_order_release);
+        }
+    }
+    return pool;
+}
+
+void ThreadPool::destroyInstance()
+{
+    std::lock_guard<std::mutex> lock(s_sharedThreadPoolMutex);
+    ThreadPool* pool = s_sharedThreadPool.load(std::memory_order_relaxed);
+    // still the shared pool while it finishes its tasks, which may enqueue others
+    delete pool;
+    s_sharedThreadPool.store(nullptr, std::memory_order_release);
+}
+
+ThreadPool::ThreadPool(int threadCount)
+: _stop(false)
+{
+    for (int i = 0; i < threadCount; ++i)
+    {
+        _threads.push_back(std::thread(&ThreadPool::threadLoop, this));
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_tasksMutex);
+        _stop = true;
+    }
+    _tasksCondition.notify_all();
+
+    for (auto& thread : _threads)
+    {
+        thread.join();
+    }
+}
+
+void ThreadPool::threadLoop()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(_tasksMutex);
+            _tasksCondition.wait(lock, [this]{ return _stop || !_tasks.empty(); });
+
+            if (_tasks.empty())
+                return;
+
+            task = std::move(_tasks.front());
+            _tasks.pop_front();
+        }
+        task();
+    }
+}
+
+void ThreadPool::enqueue(const std::function<void()>& task)
+{
+    {
+        std::lock_guard<std::mutex> lock(_tasksMutex);
+        _tasks.push_back(task);
+    }
+    _tasksCondition.notify_one();
+}
+
+void ThreadPool::parallelFor(ssize_t count, ssize_t grain, const std::function<void(ssize_t, ssize_t)>& func)
+{
+    if (count <= 0)
+        return;
+
+    grain = std::max(grain, (ssize_t)1);
+    ssize_t chunks = std::min((count + grain - 1) / grain, (ssize_t)(_threads.size() + 1));
+    if (chunks <= 1)
+    {
+        func(0, count);
+        return;
+    }
+
+    // shared with the queued tasks, which may start after this call returned: they find no chunk left then
+    struct State
+    {
+        const std::function<void(ssize_t, ssize_t)>* func;
+        ssize_t count;
+        ssize_t chunks;
+        ssize_t chunkSize;
+        std::atomic<ssize_t> nextChunk;
+        ssize_t finishedChunks;
+        std::mutex mutex;
+        std::condition_variable condition;
+    };
+    auto state = std::make_shared<State>();
+    state->func = &func;
+    state->count = count;
+    state->chunks = chunks;
+    state->chunkSize = (count + chunks - 1) / chunks;
+    state->nextChunk = 0;
+    state->finishedChunks = 0;
+
+    // runs the chunks not taken yet, returns false if there was none
+    auto runChunks = [](State& state) {
+        bool ran = false;
+        ssize_t chunk;
+        while ((chunk = state.nextChunk++) < state.chunks)
+        {
+            ssize_t begin = chunk * state.chunkSize;
+            ssize_t end = std::min(begin + state.chunkSize, state.count);
+            if (begin < end)
+                (*state.func)(begin, end);
+
+            std::lock_guard<std::mutex> lock(state.mutex);
+            if (++state.finishedChunks == state.chunks)
+            {
+                state.condition.notify_one();
+            }
+            ran = true;
+        }
+        return ran;
+    };
+
+    for (ssize_t i = 1; i < chunks; ++i)
+    {
+        enqueue([state, runChunks](){
+            runChunks(*state);
+        });
+    }
+
+    // the calling thread only helps with the chunks of this call, so that it doesn't run unrelated tasks,
+    // and nested calls made from a worker can't dead lock since the chunks nobody took are run here
+    runChunks(*state);
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->condition.wait(lock, [&]{ return state->finishedChunks == state->chunks; });
+}
+
+NS_CC_END
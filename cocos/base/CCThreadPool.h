@@ -0,0 +1,100 @@
+/****************************************************************************
+Copyright (c) 2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CCTHREADPOOL_H__
+#define __CCTHREADPOOL_H__
+
+#include <functional>
+#include <vector>
+#include <deque>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "base/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup base_nodes
+ * @{
+ */
+
+/**
+ * A small pool of worker threads shared by the engine for CPU bound jobs
+ * (pixel format conversion, software texture decoding, data parsing...).
+ *
+ * Jobs executed by the pool must not touch OpenGL, autorelease objects nor
+ * retain/release objects used by the cocos thread, since they are not run on it.
+ * Objects created by a job can be handed over to the cocos thread once it is done.
+ * @js NA
+ * @lua NA
+ */
+class CC_DLL ThreadPool
+{
+public:
+    /** Returns the shared pool, creating it on first use. It can be called from any thread. */
+    static ThreadPool* getInstance();
+
+    /** Waits for the queued tasks to be done, then stops the worker threads and deletes the shared pool. */
+    static void destroyInstance();
+
+    /**
+     * Splits [0, count) into ranges of at least `grain` items and calls
+     * `func(begin, end)` for every range, on the workers and on the calling thread,
+     * which doesn't run the other queued tasks meanwhile.
+     * Returns when all the ranges have been processed.
+     * If `count` is not bigger than `grain`, `func` is called directly.
+     */
+    void parallelFor(ssize_t count, ssize_t grain, const std::function<void(ssize_t, ssize_t)>& func);
+
+    /** Runs `task` on a worker thread. It returns immediately. */
+    void enqueue(const std::function<void()>& task);
+
+    /** Returns the number of worker threads. */
+    int getThreadCount() const { return static_cast<int>(_threads.size()); }
+
+protected:
+    ThreadPool(int threadCount);
+    ~ThreadPool();
+
+    void threadLoop();
+
+    static std::atomic<ThreadPool*> s_sharedThreadPool;
+    static std::mutex s_sharedThreadPoolMutex;
+
+    std::vector<std::thread> _threads;
+    std::deque<std::function<void()>> _tasks;
+    std::mutex _tasksMutex;
+    std::condition_variable _tasksCondition;
+    bool _stop;
+};
+
+// end of base_nodes group
+/// @}
+
+NS_CC_END
+
+#endif // __CCTHREADPOOL_H__
@@ -87,6 +87,12 @@ Value::Value(const std::string& v)
     *_field.strVal = v;
 }
 
+Value::Value(std::string&& v)
+: _type(Type::STRING)
+{
+    _field.strVal = new std::string(std::move(v));
+}
+
 Value::Value(const ValueVector& v)
 : _type(Type::VECTOR)
 {
@@ -135,7 +141,7 @@ Value::Value(const Value& other)
     *this = other;
 }
 
-Value::Value(Value&& other)
+Value::Value(Value&& other) CC_NOEXCEPT
 : _type(Type::NONE)
 {
     *this = std::move(other);
@@ -202,7 +208,7 @@ Value& Value::operator= (const Value& other)
     return *this;
 }
 
-Value& Value::operator= (Value&& other)
+Value& Value::operator= (Value&& other) CC_NOEXCEPT
 {
     if (this != &other)
     {
@@ -297,6 +303,13 @@ Value& Value::operator= (const std::string& v)
     return *this;
 }
 
+Value& Value::operator= (std::string&& v)
+{
+    reset(Type::STRING);
+    *_field.strVal = std::move(v);
+    return *this;
+}
+
 Value& Value::operator= (const ValueVector& v)
 {
     reset(Type::VECTOR);
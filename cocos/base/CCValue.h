@@ -56,6 +56,7 @@ public:
     explicit Value(bool v);
     explicit Value(const char* v);
     explicit Value(const std::string& v);
+    explicit Value(std::string&& v);
 
     explicit Value(const ValueVector& v);
     explicit Value(ValueVector&& v);
@@ -67,12 +68,12 @@ public:
     explicit Value(ValueMapIntKey&& v);
 
     Value(const Value& other);
-    Value(Value&& other);
+    Value(Value&& other) CC_NOEXCEPT;
     ~Value();
 
     // assignment operator
     Value& operator= (const Value& other);
-    Value& operator= (Value&& other);
+    Value& operator= (Value&& other) CC_NOEXCEPT;
 
     Value& operator= (unsigned char v);
     Value& operator= (int v);
@@ -81,6 +82,7 @@ public:
     Value& operator= (bool v);
     Value& operator= (const char* v);
     Value& operator= (const std::string& v);
+    Value& operator= (std::string&& v);
 
     Value& operator= (const ValueVector& v);
     Value& operator= (ValueVector&& v);
@@ -0,0 +1,717 @@
+/****************************************************************************
+Copyright (c) 2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "base/CCValueView.h"
+#include "2d/platform/CCFileUtils.h"
+#include "2d/platform/CCMappedFile.h"
+
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+
+NS_CC_BEGIN
+
+/*
+ Binary value files. All the values are little endian 32 bits words, every node starts on a 4 bytes boundary.
+
+   header:        'C' 'C' 'V' 'B', version, string count, string table offset, root node offset
+   node:          type (Value::Type), then
+                    BYTE, INTEGER, BOOLEAN: int32 value
+                    FLOAT:                  float value
+                    DOUBLE:                 8 bytes double value
+                    STRING:                 string index
+                    VECTOR:                 count, count x node offset
+                    MAP:                    count, count x (key hash, key string index, node offset), sorted by hash then key
+                    INT_KEY_MAP:            count, count x (key, node offset), sorted by key
+   string table:  count x (offset, length), the strings are stored once and null terminated
+
+ The nodes are written before their children, so a child offset is always greater than its parent's one.
+ */
+static const char ValueMagic[4] = { 'C', 'C', 'V', 'B' };
+static const uint32_t ValueVersion = 1;
+static const uint32_t HeaderSize = 20;
+
+static uint32_t hashKey(const char* key, size_t length)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; ++i)
+    {
+        hash ^= static_cast<unsigned char>(key[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+//
+// Writer
+//
+class ValueWriter
+{
+public:
+    Data write(const Value& value)
+    {
+        _bytes.resize(HeaderSize, 0);
+        uint32_t root = writeNode(value);
+
+        uint32_t stringsOffset = static_cast<uint32_t>(_bytes.size());
+        uint32_t stringCount = static_cast<uint32_t>(_strings.size());
+        _bytes.resize(_bytes.size() + stringCount * 8);
+        for (uint32_t i = 0; i < stringCount; ++i)
+        {
+            const std::string& str = *_strings[i];
+            set32(stringsOffset + i * 8, static_cast<uint32_t>(_bytes.size()));
+            set32(stringsOffset + i * 8 + 4, static_cast<uint32_t>(str.length()));
+            _bytes.insert(_bytes.end(), str.begin(), str.end());
+            _bytes.push_back(0);
+        }
+
+        memcpy(&_bytes[0], ValueMagic, sizeof(ValueMagic));
+        set32(4, ValueVersion);
+        set32(8, stringCount);
+        set32(12, stringsOffset);
+        set32(16, root);
+
+        Data data;
+        data.copy(_bytes.data(), _bytes.size());
+        return data;
+    }
+
+private:
+    struct MapEntry
+    {
+        uint32_t hash;
+        const std::string* key;
+        const Value* value;
+
+        bool operator<(const MapEntry& other) const
+        {
+            return hash != other.hash ? hash < other.hash : *key < *other.key;
+        }
+    };
+
+    void set32(size_t offset, uint32_t value)
+    {
+        memcpy(&_bytes[offset], &value, 4);
+    }
+
+    uint32_t reserve(size_t words)
+    {
+        uint32_t offset = static_cast<uint32_t>(_bytes.size());
+        _bytes.resize(_bytes.size() + words * 4, 0);
+        return offset;
+    }
+
+    uint32_t intern(const std::string& str)
+    {
+        auto result = _stringIndices.emplace(str, static_cast<uint32_t>(_strings.size()));
+        if (result.second)
+        {
+            _strings.push_back(&result.first->first);
+        }
+        return result.first->second;
+    }
+
+    uint32_t writeNode(const Value& value)
+    {
+        auto type = value.getType();
+        switch (type)
+        {
+            case Value::Type::BYTE:
+            case Value::Type::INTEGER:
+            case Value::Type::BOOLEAN:
+            {
+                uint32_t offset = reserve(2);
+                int32_t v = (type == Value::Type::BYTE) ? value.asByte() : (type == Value::Type::BOOLEAN ? value.asBool() : value.asInt());
+                set32(offset, static_cast<uint32_t>(type));
+                memcpy(&_bytes[offset + 4], &v, 4);
+                return offset;
+            }
+            case Value::Type::FLOAT:
+            {
+                uint32_t offset = reserve(2);
+                float v = value.asFloat();
+                set32(offset, static_cast<uint32_t>(type));
+                memcpy(&_bytes[offset + 4], &v, 4);
+                return offset;
+            }
+            case Value::Type::DOUBLE:
+            {
+                uint32_t offset = reserve(3);
+                double v = value.asDouble();
+                set32(offset, static_cast<uint32_t>(type));
+                memcpy(&_bytes[offset + 4], &v, 8);
+                return offset;
+            }
+            case Value::Type::STRING:
+            {
+                uint32_t offset = reserve(2);
+                set32(offset, static_cast<uint32_t>(type));
+                set32(offset + 4, intern(value.asString()));
+                return offset;
+            }
+            case Value::Type::VECTOR:
+            {
+                const auto& vector = value.asValueVector();
+                uint32_t offset = reserve(2 + vector.size());
+                set32(offset, static_cast<uint32_t>(type));
+                set32(offset + 4, static_cast<uint32_t>(vector.size()));
+                for (size_t i = 0; i < vector.size(); ++i)
+                {
+                    uint32_t child = writeNode(vector[i]);
+                    set32(offset + 8 + i * 4, child);
+                }
+                return offset;
+            }
+            case Value::Type::MAP:
+            {
+                const auto& map = value.asValueMap();
+                std::vector<MapEntry> entries;
+                entries.reserve(map.size());
+                for (const auto& item : map)
+                {
+                    MapEntry entry = { hashKey(item.first.c_str(), item.first.length()), &item.first, &item.second };
+                    entries.push_back(entry);
+                }
+                std::sort(entries.begin(), entries.end());
+
+                uint32_t offset = reserve(2 + entries.size() * 3);
+                set32(offset, static_cast<uint32_t>(type));
+                set32(offset + 4, static_cast<uint32_t>(entries.size()));
+                for (size_t i = 0; i < entries.size(); ++i)
+                {
+                    size_t slot = offset + 8 + i * 12;
+                    set32(slot, entries[i].hash);
+                    set32(slot + 4, intern(*entries[i].key));
+                    uint32_t child = writeNode(*entries[i].value);
+                    set32(slot + 8, child);
+                }
+                return offset;
+            }
+            case Value::Type::INT_KEY_MAP:
+            {
+                const auto& map = value.asIntKeyMap();
+                std::vector<std::pair<int, const Value*>> entries;
+                entries.reserve(map.size());
+                for (const auto& item : map)
+                {
+                    entries.push_back(std::make_pair(item.first, &item.second));
+                }
+                std::sort(entries.begin(), entries.end(), [](const std::pair<int, const Value*>& a, const std::pair<int, const Value*>& b){
+                    return a.first < b.first;
+                });
+
+                uint32_t offset = reserve(2 + entries.size() * 2);
+                set32(offset, static_cast<uint32_t>(type));
+                set32(offset + 4, static_cast<uint32_t>(entries.size()));
+                for (size_t i = 0; i < entries.size(); ++i)
+                {
+                    size_t slot = offset + 8 + i * 8;
+                    int32_t key = entries[i].first;
+                    memcpy(&_bytes[slot], &key, 4);
+                    uint32_t child = writeNode(*entries[i].second);
+                    set32(slot + 4, child);
+                }
+                return offset;
+            }
+            default:
+            {
+                uint32_t offset = reserve(1);
+                set32(offset, static_cast<uint32_t>(Value::Type::NONE));
+                return offset;
+            }
+        }
+    }
+
+    std::vector<unsigned char> _bytes;
+    std::unordered_map<std::string, uint32_t> _stringIndices;
+    std::vector<const std::string*> _strings;
+};
+
+//
+// Buffer
+//
+struct ValueView::Buffer
+{
+    // the content of createWithFile(), or the one of createWithData()
+    MappedFile file;
+    Data data;
+
+    const unsigned char* bytes;
+    size_t size;
+    uint32_t stringCount;
+    uint32_t stringsOffset;
+
+    Buffer()
+    : bytes(nullptr)
+    , size(0)
+    , stringCount(0)
+    , stringsOffset(0)
+    {
+    }
+
+    bool read32(size_t offset, uint32_t& value) const
+    {
+        if (offset + 4 > size)
+        {
+            return false;
+        }
+        memcpy(&value, bytes + offset, 4);
+        return true;
+    }
+
+    const char* getString(uint32_t index, uint32_t* length) const
+    {
+        uint32_t offset, len;
+        if (index >= stringCount
+            || !read32(stringsOffset + (size_t)index * 8, offset)
+            || !read32(stringsOffset + (size_t)index * 8 + 4, len)
+            || (size_t)offset + len >= size)
+        {
+            return nullptr;
+        }
+        if (length)
+        {
+            *length = len;
+        }
+        return reinterpret_cast<const char*>(bytes + offset);
+    }
+
+    // returns the offset of a child node, 0 when it's invalid
+    uint32_t child(size_t slotOffset, uint32_t parentOffset) const
+    {
+        uint32_t offset;
+        if (!read32(slotOffset, offset) || offset <= parentOffset || offset >= size)
+        {
+            return 0;
+        }
+        return offset;
+    }
+
+    bool validate()
+    {
+        uint32_t version, root;
+        if (!ValueView::isBinaryData(bytes, size)
+            || !read32(4, version) || !read32(8, stringCount) || !read32(12, stringsOffset) || !read32(16, root)
+            || (size_t)stringsOffset + (size_t)stringCount * 8 > size
+            || root < HeaderSize || root >= size)
+        {
+            return false;
+        }
+        return true;
+    }
+};
+
+//
+// ValueView
+//
+ValueView::ValueView()
+: _offset(0)
+{
+}
+
+ValueView::ValueView(const std::shared_ptr<Buffer>& buffer, uint32_t offset)
+: _buffer(offset ? buffer : nullptr)
+, _offset(offset)
+{
+}
+
+ValueView ValueView::createWithFile(const std::string& fullPath)
+{
+    std::shared_ptr<Buffer> buffer = std::make_shared<Buffer>();
+    if (!buffer->file.open(fullPath))
+    {
+        return ValueView();
+    }
+    buffer->bytes = buffer->file.getBytes();
+    buffer->size = buffer->file.getSize();
+
+    if (!buffer->validate())
+    {
+        CCLOG("ValueView: %s is not a binary value file", fullPath.c_str());
+        return ValueView();
+    }
+    uint32_t root;
+    buffer->read32(16, root);
+    return ValueView(buffer, root);
+}
+
+ValueView ValueView::createWithData(Data&& data)
+{
+    std::shared_ptr<Buffer> buffer = std::make_shared<Buffer>();
+    buffer->data = std::move(data);
+    buffer->bytes = buffer->data.getBytes();
+    buffer->size = buffer->data.getSize();
+    if (!buffer->validate())
+    {
+        return ValueView();
+    }
+    uint32_t root;
+    buffer->read32(16, root);
+    return ValueView(buffer, root);
+}
+
+Data ValueView::serialize(const Value& value)
+{
+    ValueWriter writer;
+    return writer.write(value);
+}
+
+bool ValueView::writeToFile(const Value& value, const std::string& fullPath)
+{
+    Data data = serialize(value);
+
+    FILE* fp = fopen(fullPath.c_str(), "wb");
+    if (!fp)
+    {
+        CCLOG("ValueView: can't open %s for writing", fullPath.c_str());
+        return false;
+    }
+    bool ok = fwrite(data.getBytes(), 1, data.getSize(), fp) == (size_t)data.getSize();
+    fclose(fp);
+    return ok;
+}
+
+bool ValueView::isBinaryData(const unsigned char* bytes, ssize_t size)
+{
+    uint32_t version;
+    if (bytes == nullptr || size < (ssize_t)HeaderSize || memcmp(bytes, ValueMagic, sizeof(ValueMagic)) != 0)
+    {
+        return false;
+    }
+    memcpy(&version, bytes + 4, 4);
+    return version == ValueVersion;
+}
+
+bool ValueView::isBinaryFile(const std::string& fullPath)
+{
+    unsigned char header[HeaderSize];
+    FILE* fp = fopen(fullPath.c_str(), "rb");
+    if (fp)
+    {
+        size_t read = fread(header, 1, sizeof(header), fp);
+        fclose(fp);
+        return isBinaryData(header, read);
+    }
+
+    // not a plain file, for instance inside the android apk
+    Data data = FileUtils::getInstance()->getDataFromFile(fullPath);
+    return isBinaryData(data.getBytes(), data.getSize());
+}
+
+Value::Type ValueView::getType() const
+{
+    uint32_t type;
+    if (!_buffer || !_buffer->read32(_offset, type) || type > static_cast<uint32_t>(Value::Type::INT_KEY_MAP))
+    {
+        return Value::Type::NONE;
+    }
+    return static_cast<Value::Type>(type);
+}
+
+ssize_t ValueView::size() const
+{
+    auto type = getType();
+    uint32_t count;
+    if ((type != Value::Type::VECTOR && type != Value::Type::MAP && type != Value::Type::INT_KEY_MAP)
+        || !_buffer->read32(_offset + 4, count))
+    {
+        return 0;
+    }
+
+    // a corrupted or truncated file can't ask for more entries than its bytes hold
+    size_t entrySize = type == Value::Type::VECTOR ? 4 : (type == Value::Type::MAP ? 12 : 8);
+    if (count > (_buffer->size - (_offset + 8)) / entrySize)
+    {
+        return 0;
+    }
+    return count;
+}
+
+ValueView ValueView::at(ssize_t index) const
+{
+    if (getType() != Value::Type::VECTOR || index < 0 || index >= size())
+    {
+        return ValueView();
+    }
+    return ValueView(_buffer, _buffer->child(_offset + 8 + index * 4, _offset));
+}
+
+ValueView ValueView::find(const std::string& key) const
+{
+    if (getType() != Value::Type::MAP)
+    {
+        return ValueView();
+    }
+
+    uint32_t hash = hashKey(key.c_str(), key.length());
+    ssize_t count = size();
+
+    // first entry with this hash
+    ssize_t low = 0;
+    ssize_t high = count;
+    while (low < high)
+    {
+        ssize_t middle = (low + high) / 2;
+        uint32_t middleHash = 0;
+        _buffer->read32(_offset + 8 + middle * 12, middleHash);
+        if (middleHash < hash)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    for (ssize_t i = low; i < count; ++i)
+    {
+        size_t slot = _offset + 8 + i * 12;
+        uint32_t entryHash, keyIndex, length;
+        if (!_buffer->read32(slot, entryHash) || entryHash != hash || !_buffer->read32(slot + 4, keyIndex))
+        {
+            break;
+        }
+        const char* entryKey = _buffer->getString(keyIndex, &length);
+        if (entryKey && length == key.length() && memcmp(entryKey, key.c_str(), length) == 0)
+        {
+            return ValueView(_buffer, _buffer->child(slot + 8, _offset));
+        }
+    }
+    return ValueView();
+}
+
+ValueView ValueView::find(int key) const
+{
+    if (getType() != Value::Type::INT_KEY_MAP)
+    {
+        return ValueView();
+    }
+
+    ssize_t low = 0;
+    ssize_t high = size();
+    while (low < high)
+    {
+        ssize_t middle = (low + high) / 2;
+        uint32_t word = 0;
+        _buffer->read32(_offset + 8 + middle * 8, word);
+        int32_t middleKey = static_cast<int32_t>(word);
+        if (middleKey == key)
+        {
+            return ValueView(_buffer, _buffer->child(_offset + 8 + middle * 8 + 4, _offset));
+        }
+        if (middleKey < key)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return ValueView();
+}
+
+std::string ValueView::getKeyAt(ssize_t index) const
+{
+    uint32_t keyIndex, length;
+    if (getType() != Value::Type::MAP || index < 0 || index >= size() || !_buffer->read32(_offset + 8 + index * 12 + 4, keyIndex))
+    {
+        return "";
+    }
+    const char* key = _buffer->getString(keyIndex, &length);
+    return key ? std::string(key, length) : "";
+}
+
+int ValueView::getIntKeyAt(ssize_t index) const
+{
+    uint32_t word;
+    if (getType() != Value::Type::INT_KEY_MAP || index < 0 || index >= size() || !_buffer->read32(_offset + 8 + index * 8, word))
+    {
+        return 0;
+    }
+    return static_cast<int32_t>(word);
+}
+
+ValueView ValueView::getValueAt(ssize_t index) const
+{
+    auto type = getType();
+    if (index < 0 || index >= size())
+    {
+        return ValueView();
+    }
+    if (type == Value::Type::MAP)
+    {
+        return ValueView(_buffer, _buffer->child(_offset + 8 + index * 12 + 8, _offset));
+    }
+    if (type == Value::Type::INT_KEY_MAP)
+    {
+        return ValueView(_buffer, _buffer->child(_offset + 8 + index * 8 + 4, _offset));
+    }
+    return at(index);
+}
+
+Value ValueView::scalarValue() const
+{
+    uint32_t word = 0;
+    switch (getType())
+    {
+        case Value::Type::BYTE:
+            _buffer->read32(_offset + 4, word);
+            return Value(static_cast<unsigned char>(word));
+        case Value::Type::INTEGER:
+            _buffer->read32(_offset + 4, word);
+            return Value(static_cast<int>(static_cast<int32_t>(word)));
+        case Value::Type::BOOLEAN:
+            _buffer->read32(_offset + 4, word);
+            return Value(word != 0);
+        case Value::Type::FLOAT:
+        {
+            float v = 0;
+            if (_buffer->read32(_offset + 4, word))
+                memcpy(&v, &word, 4);
+            return Value(v);
+        }
+        case Value::Type::DOUBLE:
+        {
+            double v = 0;
+            if (_offset + 12 <= _buffer->size)
+                memcpy(&v, _buffer->bytes + _offset + 4, 8);
+            return Value(v);
+        }
+        case Value::Type::STRING:
+        {
+            uint32_t length = 0;
+            const char* str = getCString();
+            if (str)
+            {
+                _buffer->read32(_offset + 4, word);
+                _buffer->getString(word, &length);
+                return Value(std::string(str, length));
+            }
+            return Value("");
+        }
+        default:
+            return Value::Null;
+    }
+}
+
+unsigned char ValueView::asByte() const
+{
+    return scalarValue().asByte();
+}
+
+int ValueView::asInt() const
+{
+    return scalarValue().asInt();
+}
+
+float ValueView::asFloat() const
+{
+    return scalarValue().asFloat();
+}
+
+double ValueView::asDouble() const
+{
+    return scalarValue().asDouble();
+}
+
+bool ValueView::asBool() const
+{
+    return scalarValue().asBool();
+}
+
+std::string ValueView::asString() const
+{
+    return scalarValue().asString();
+}
+
+const char* ValueView::getCString() const
+{
+    uint32_t index;
+    if (getType() != Value::Type::STRING || !_buffer->read32(_offset + 4, index))
+    {
+        return nullptr;
+    }
+    return _buffer->getString(index, nullptr);
+}
+
+Value ValueView::toValue() const
+{
+    switch (getType())
+    {
+        case Value::Type::VECTOR:
+            return Value(toValueVector());
+        case Value::Type::MAP:
+            return Value(toValueMap());
+        case Value::Type::INT_KEY_MAP:
+        {
+            ValueMapIntKey map;
+            ssize_t count = size();
+            map.reserve(count);
+            for (ssize_t i = 0; i < count; ++i)
+            {
+                map.emplace(getIntKeyAt(i), getValueAt(i).toValue());
+            }
+            return Value(std::move(map));
+        }
+        default:
+            return scalarValue();
+    }
+}
+
+ValueMap ValueView::toValueMap() const
+{
+    ValueMap map;
+    if (getType() != Value::Type::MAP)
+    {
+        return map;
+    }
+
+    ssize_t count = size();
+    map.reserve(count);
+    for (ssize_t i = 0; i < count; ++i)
+    {
+        size_t slot = _offset + 8 + i * 12;
+        uint32_t keyIndex, length;
+        const char* key = _buffer->read32(slot + 4, keyIndex) ? _buffer->getString(keyIndex, &length) : nullptr;
+        if (key)
+        {
+            map.emplace(std::string(key, length), ValueView(_buffer, _buffer->child(slot + 8, _offset)).toValue());
+        }
+    }
+    return map;
+}
+
+ValueVector ValueView::toValueVector() const
+{
+    ValueVector vector;
+    if (getType() != Value::Type::VECTOR)
+    {
+        return vector;
+    }
+
+    ssize_t count = size();
+    vector.reserve(count);
+    for (ssize_t i = 0; i < count; ++i)
+    {
+        vector.push_back(at(i).toValue());
+    }
+    return vector;
+}
+
+NS_CC_END
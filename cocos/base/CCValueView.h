@@ -0,0 +1,123 @@
+/****************************************************************************
+Copyright (c) 2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CCVALUEVIEW_H__
+#define __CCVALUEVIEW_H__
+
+#include <memory>
+#include <stdint.h>
+
+#include "base/CCValue.h"
+#include "base/CCData.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup data_structures
+ * @{
+ */
+
+/** @brief Read-only view over a Value tree serialized in the binary format.
+
+ The binary format stores each container as a table of offsets, the map entries sorted by key and
+ every string once (keys and values are interned). A view reads the values in place: looking up a key
+ is a binary search in the mapped file, nothing is copied or hashed until toValue() materializes the
+ part of the tree that is really needed as Value.
+
+ The views share the buffer they come from, which stays valid as long as one view of it exists.
+ FileUtils::getValueMapFromFile() and getValueVectorFromFile() also read binary files transparently.
+ */
+class CC_DLL ValueView
+{
+public:
+    /** Creates a null view */
+    ValueView();
+
+    /** Creates a view of a binary file, which is memory mapped when possible.
+     Returns a null view if the file isn't in the binary format.
+     */
+    static ValueView createWithFile(const std::string& fullPath);
+    /** Creates a view of binary data, the view takes the ownership of the data */
+    static ValueView createWithData(Data&& data);
+
+    /** Serializes a Value tree in the binary format */
+    static Data serialize(const Value& value);
+    /** Serializes a Value tree in the binary format into a file */
+    static bool writeToFile(const Value& value, const std::string& fullPath);
+
+    /** Returns true if the data starts like a binary value file */
+    static bool isBinaryData(const unsigned char* bytes, ssize_t size);
+    /** Returns true if the file at fullPath is a binary value file, only its header is read */
+    static bool isBinaryFile(const std::string& fullPath);
+
+    Value::Type getType() const;
+    inline bool isNull() const { return getType() == Value::Type::NONE; }
+
+    /** Number of elements of a vector or a map, 0 for the other types */
+    ssize_t size() const;
+
+    /** Element of a vector, a null view when out of range */
+    ValueView at(ssize_t index) const;
+    /** Value of a map key, a null view when the key doesn't exist */
+    ValueView find(const std::string& key) const;
+    /** Value of an int key map key, a null view when the key doesn't exist */
+    ValueView find(int key) const;
+    inline ValueView operator[](const std::string& key) const { return find(key); }
+
+    /** Iterates the maps: the entries are sorted by key hash */
+    std::string getKeyAt(ssize_t index) const;
+    int getIntKeyAt(ssize_t index) const;
+    ValueView getValueAt(ssize_t index) const;
+
+    /** The scalars convert like Value does */
+    unsigned char asByte() const;
+    int asInt() const;
+    float asFloat() const;
+    double asDouble() const;
+    bool asBool() const;
+    std::string asString() const;
+    /** Returns the string stored in the buffer without copying it, nullptr if the value isn't a string */
+    const char* getCString() const;
+
+    /** Materializes the viewed subtree */
+    Value toValue() const;
+    ValueMap toValueMap() const;
+    ValueVector toValueVector() const;
+
+private:
+    struct Buffer;
+
+    ValueView(const std::shared_ptr<Buffer>& buffer, uint32_t offset);
+    Value scalarValue() const;
+
+    std::shared_ptr<Buffer> _buffer;
+    uint32_t _offset;
+};
+
+// end of data_structures group
+/// @}
+
+NS_CC_END
+
+#endif /* __CCVALUEVIEW_H__ */
@@ -30,8 +30,12 @@
 #include "base/CCData.h"
 #include "base/ccMacros.h"
 #include "2d/platform/CCFileUtils.h"
+#include "base/CCThreadPool.h"
 #include "unzip.h"
 #include <map>
+#include <vector>
+#include <atomic>
+#include <algorithm>
 
 NS_CC_BEGIN
 
@@ -129,13 +133,132 @@ inline unsigned int ZipUtils::checksumPvr(const unsigned int *data, ssize_t len)
 // Should buffer factor be 1.5 instead of 2 ?
 #define BUFFER_INC_FACTOR (2)
 
+// size of the compressed files read at once by the streaming functions
+#define FILE_CHUNK_SIZE (64 * 1024)
+
+// the gzip members of BGZF files hold at most 64k of compressed data
+#define BGZF_BLOCK_INPUT_SIZE 0xff00
+#define BGZF_BLOCK_MAX_SIZE 0x10000
+#define BGZF_HEADER_SIZE 18
+#define BGZF_FOOTER_SIZE 8
+
+static inline uint32_t readLittleEndian32(const unsigned char *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void writeLittleEndian32(unsigned char *p, uint32_t value)
+{
+    p[0] = (unsigned char)value;
+    p[1] = (unsigned char)(value >> 8);
+    p[2] = (unsigned char)(value >> 16);
+    p[3] = (unsigned char)(value >> 24);
+}
+
+static inline bool isGZipMemberStart(const unsigned char *p, ssize_t len)
+{
+    return len > 0 && p[0] == 0x1F && (len < 2 || p[1] == 0x8B);
+}
+
+// gzip stores the inflated size (modulo 2^32) of its last member in its last 4 bytes, 0 when it's unknown
+static ssize_t readGZipInflatedSize(const unsigned char *in, ssize_t inLength)
+{
+    if (inLength < BGZF_HEADER_SIZE || !ZipUtils::isGZipBuffer(in, inLength))
+    {
+        return 0;
+    }
+
+    // deflate doesn't compress more than 1032:1, a bigger size comes from a corrupted file
+    uint32_t size = readLittleEndian32(in + inLength - 4);
+    return (int64_t)size <= (int64_t)inLength * 1032 ? (ssize_t)size : 0;
+}
+
+// size of a gzip member which stores it in a "BC" extra subfield (BGZF), 0 for the other members.
+// Only the header is read: the size may be bigger than len
+static ssize_t readBGZFBlockSize(const unsigned char *p, ssize_t len)
+{
+    if (len < BGZF_HEADER_SIZE || p[0] != 0x1F || p[1] != 0x8B || p[2] != Z_DEFLATED || !(p[3] & 0x04))
+    {
+        return 0;
+    }
+
+    ssize_t extraEnd = 12 + (p[10] | (p[11] << 8));
+    if (extraEnd > len)
+    {
+        return 0;
+    }
+
+    for (ssize_t i = 12; i + 4 <= extraEnd; )
+    {
+        ssize_t subfieldLength = p[i + 2] | (p[i + 3] << 8);
+        if (p[i] == 'B' && p[i + 1] == 'C' && subfieldLength == 2 && i + 6 <= extraEnd)
+        {
+            ssize_t blockSize = (p[i + 4] | (p[i + 5] << 8)) + 1;
+            return blockSize >= extraEnd + BGZF_FOOTER_SIZE ? blockSize : 0;
+        }
+        i += 4 + subfieldLength;
+    }
+    return 0;
+}
+
+// writes one BGZF member, returns its size or -1
+static ssize_t writeBGZFBlock(const unsigned char *in, ssize_t inLength, unsigned char *out)
+{
+    ssize_t compressedLength = -1;
+    // incompressible data is stored, which always fits
+    const int levels[] = { Z_DEFAULT_COMPRESSION, Z_NO_COMPRESSION };
+    for (int i = 0; i < 2 && compressedLength < 0; ++i)
+    {
+        z_stream stream;
+        memset(&stream, 0, sizeof(stream));
+        if (deflateInit2(&stream, levels[i], Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        {
+            return -1;
+        }
+
+        stream.next_in = const_cast<unsigned char*>(in);
+        stream.avail_in = static_cast<unsigned int>(inLength);
+        stream.next_out = out + BGZF_HEADER_SIZE;
+        stream.avail_out = BGZF_BLOCK_MAX_SIZE - BGZF_HEADER_SIZE - BGZF_FOOTER_SIZE;
+        if (deflate(&stream, Z_FINISH) == Z_STREAM_END)
+        {
+            compressedLength = stream.total_out;
+        }
+        deflateEnd(&stream);
+    }
+
+    if (compressedLength < 0)
+    {
+        return -1;
+    }
+
+    ssize_t blockSize = BGZF_HEADER_SIZE + compressedLength + BGZF_FOOTER_SIZE;
+    const unsigned char header[BGZF_HEADER_SIZE] = {
+        0x1F, 0x8B, Z_DEFLATED, 0x04, 0, 0, 0, 0, 0, 0xFF, 6, 0, 'B', 'C', 2, 0,
+        (unsigned char)((blockSize - 1) & 0xFF), (unsigned char)((blockSize - 1) >> 8)
+    };
+    memcpy(out, header, BGZF_HEADER_SIZE);
+    writeLittleEndian32(out + BGZF_HEADER_SIZE + compressedLength, (uint32_t)crc32(0, in, static_cast<unsigned int>(inLength)));
+    writeLittleEndian32(out + BGZF_HEADER_SIZE + compressedLength + 4, (uint32_t)inLength);
+    return blockSize;
+}
+
 int ZipUtils::inflateMemoryWithHint(unsigned char *in, ssize_t inLength, unsigned char **out, ssize_t *outLength, ssize_t outLenghtHint)
 {
     /* ret value */
     int err = Z_OK;
     
-    ssize_t bufferSize = outLenghtHint;
+    // gzip knows the inflated size, the buffer is allocated once
+    ssize_t bufferSize = readGZipInflatedSize(in, inLength);
+    if (bufferSize <= 0)
+    {
+        bufferSize = outLenghtHint;
+    }
     *out = (unsigned char*)malloc(bufferSize);
+    if (! *out)
+    {
+        return Z_MEM_ERROR;
+    }
     
     z_stream d_stream; /* decompression stream */
     d_stream.zalloc = (alloc_func)0;
@@ -157,6 +280,11 @@ int ZipUtils::inflateMemoryWithHint(unsigned char *in, ssize_t inLength, unsigne
         
         if (err == Z_STREAM_END)
         {
+            // gzip files may be made of several members
+            if (isGZipMemberStart(d_stream.next_in, d_stream.avail_in) && inflateReset(&d_stream) == Z_OK)
+            {
+                continue;
+            }
             break;
         }
         
@@ -170,23 +298,28 @@ int ZipUtils::inflateMemoryWithHint(unsigned char *in, ssize_t inLength, unsigne
                 return err;
         }
         
+        // the input ended before the end of the stream
+        if (d_stream.avail_out != 0)
+        {
+            inflateEnd(&d_stream);
+            return Z_DATA_ERROR;
+        }
+        
         // not enough memory ?
-        if (err != Z_STREAM_END)
+        unsigned char *tmp = (unsigned char*)realloc(*out, bufferSize * BUFFER_INC_FACTOR);
+        
+        /* not enough memory, ouch */
+        if (! tmp )
         {
-            *out = (unsigned char*)realloc(*out, bufferSize * BUFFER_INC_FACTOR);
-            
-            /* not enough memory, ouch */
-            if (! *out )
-            {
-                CCLOG("cocos2d: ZipUtils: realloc failed");
-                inflateEnd(&d_stream);
-                return Z_MEM_ERROR;
-            }
-            
-            d_stream.next_out = *out + bufferSize;
-            d_stream.avail_out = static_cast<unsigned int>(bufferSize);
-            bufferSize *= BUFFER_INC_FACTOR;
+            CCLOG("cocos2d: ZipUtils: realloc failed");
+            inflateEnd(&d_stream);
+            return Z_MEM_ERROR;
         }
+        
+        *out = tmp;
+        d_stream.next_out = *out + bufferSize;
+        d_stream.avail_out = static_cast<unsigned int>(bufferSize * (BUFFER_INC_FACTOR - 1));
+        bufferSize *= BUFFER_INC_FACTOR;
     }
     
     *outLength = bufferSize - d_stream.avail_out;
@@ -194,9 +327,86 @@ int ZipUtils::inflateMemoryWithHint(unsigned char *in, ssize_t inLength, unsigne
     return err;
 }
 
+ssize_t ZipUtils::inflateBlockedGZip(const unsigned char *in, ssize_t inLength, unsigned char **out)
+{
+    struct Block
+    {
+        ssize_t in;
+        ssize_t inLength;
+        ssize_t out;
+        ssize_t outLength;
+    };
+
+    // the members give their compressed and inflated sizes: the offsets of all of them are known upfront
+    std::vector<Block> blocks;
+    ssize_t inOffset = 0;
+    ssize_t outOffset = 0;
+    while (inOffset < inLength)
+    {
+        ssize_t blockSize = readBGZFBlockSize(in + inOffset, inLength - inOffset);
+        if (blockSize <= 0 || blockSize > inLength - inOffset)
+        {
+            return -1;
+        }
+
+        // a member inflates to at most 64k, a bigger ISIZE comes from a corrupted file
+        Block block = { inOffset, blockSize, outOffset, (ssize_t)readLittleEndian32(in + inOffset + blockSize - 4) };
+        if (block.outLength > BGZF_BLOCK_MAX_SIZE)
+        {
+            return -1;
+        }
+        blocks.push_back(block);
+        inOffset += blockSize;
+        outOffset += block.outLength;
+    }
+
+    if (blocks.size() < 2)
+    {
+        return -1;
+    }
+
+    *out = (unsigned char*)malloc(std::max(outOffset, (ssize_t)1));
+    if (! *out)
+    {
+        CCLOG("cocos2d: ZipUtils: Out of memory while decompressing map data!");
+        return 0;
+    }
+
+    std::atomic<bool> failed(false);
+    unsigned char *output = *out;
+    ThreadPool::getInstance()->parallelFor(blocks.size(), 1, [&](ssize_t begin, ssize_t end){
+        for (ssize_t i = begin; i < end && !failed; ++i)
+        {
+            const Block &block = blocks[i];
+            // the empty end of file marker
+            if (block.outLength == 0)
+                continue;
+
+            if (inflateMemoryToBuffer(in + block.in, block.inLength, output + block.out, block.outLength) != block.outLength)
+            {
+                failed = true;
+            }
+        }
+    });
+
+    if (failed)
+    {
+        free(*out);
+        *out = nullptr;
+        return 0;
+    }
+    return outOffset;
+}
+
 ssize_t ZipUtils::inflateMemoryWithHint(unsigned char *in, ssize_t inLength, unsigned char **out, ssize_t outLengthHint)
 {
-    ssize_t outLength = 0;
+    ssize_t outLength = inflateBlockedGZip(in, inLength, out);
+    if (outLength >= 0)
+    {
+        return outLength;
+    }
+
+    outLength = 0;
     int err = inflateMemoryWithHint(in, inLength, out, &outLength, outLengthHint);
     
     if (err != Z_OK || *out == nullptr) {
@@ -227,80 +437,199 @@ ssize_t ZipUtils::inflateMemoryWithHint(unsigned char *in, ssize_t inLength, uns
     return outLength;
 }
 
+ssize_t ZipUtils::inflateMemoryToBuffer(const unsigned char *in, ssize_t inLength, unsigned char *out, ssize_t outLength)
+{
+    z_stream d_stream; /* decompression stream */
+    d_stream.zalloc = (alloc_func)0;
+    d_stream.zfree = (free_func)0;
+    d_stream.opaque = (voidpf)0;
+
+    d_stream.next_in  = const_cast<unsigned char*>(in);
+    d_stream.avail_in = static_cast<unsigned int>(inLength);
+    d_stream.next_out = out;
+    d_stream.avail_out = static_cast<unsigned int>(outLength);
+
+    if (inflateInit2(&d_stream, 15 + 32) != Z_OK)
+    {
+        CCLOG("cocos2d: ZipUtils: Incompatible zlib version!");
+        return -1;
+    }
+
+    // the whole output is available: zlib inflates in one call, using it as its window
+    int err = inflate(&d_stream, Z_FINISH);
+    ssize_t inflatedLength = outLength - d_stream.avail_out;
+    inflateEnd(&d_stream);
+
+    if (err != Z_STREAM_END)
+    {
+        if (err == Z_BUF_ERROR && d_stream.avail_out == 0)
+        {
+            CCLOG("cocos2d: ZipUtils: The inflated data is bigger than the buffer!");
+        }
+        else
+        {
+            CCLOG("cocos2d: ZipUtils: Incorrect zlib compressed data!");
+        }
+        return -1;
+    }
+
+    return inflatedLength;
+}
+
 ssize_t ZipUtils::inflateMemory(unsigned char *in, ssize_t inLength, unsigned char **out)
 {
     // 256k for hint
     return inflateMemoryWithHint(in, inLength, out, 256 * 1024);
 }
 
-int ZipUtils::inflateGZipFile(const char *path, unsigned char **out)
+// feeds the rest of the file to the stream
+static bool inflateFile(FILE *fp, InflateStream &stream)
 {
-    int len;
-    unsigned int offset = 0;
-    
-    CCASSERT(out, "");
-    CCASSERT(&*out, "");
-    
-    gzFile inFile = gzopen(path, "rb");
-    if( inFile == nullptr ) {
-        CCLOG("cocos2d: ZipUtils: error open gzip file: %s", path);
-        return -1;
+    unsigned char *chunk = (unsigned char*)malloc(FILE_CHUNK_SIZE);
+    if (! chunk)
+    {
+        CCLOG("cocos2d: ZipUtils: out of memory");
+        return false;
     }
-    
-    /* 512k initial decompress buffer */
-    unsigned int bufferSize = 512 * 1024;
-    unsigned int totalBufferSize = bufferSize;
-    
-    *out = (unsigned char*)malloc( bufferSize );
-    if( ! out )
+
+    bool ok = true;
+    size_t len;
+    while (ok && (len = fread(chunk, 1, FILE_CHUNK_SIZE, fp)) > 0)
+    {
+        ok = stream.write(chunk, len);
+    }
+    free(chunk);
+
+    if (ok && ferror(fp))
+    {
+        CCLOG("cocos2d: ZipUtils: error reading file");
+        return false;
+    }
+    return ok && stream.finish();
+}
+
+// inflates the rest of the file into a buffer allocated with capacity bytes, which is only grown when
+// capacity isn't the inflated size
+static ssize_t inflateFileToMemory(FILE *fp, unsigned char **out, ssize_t capacity)
+{
+    struct
+    {
+        unsigned char *data;
+        ssize_t size;
+        ssize_t capacity;
+    } output = { nullptr, 0, std::max(capacity, (ssize_t)1) };
+
+    output.data = (unsigned char*)malloc(output.capacity);
+    if (! output.data)
     {
         CCLOG("cocos2d: ZipUtils: out of memory");
         return -1;
     }
+
+    InflateStream stream([&output](const unsigned char *data, ssize_t size) {
+        if (output.size + size > output.capacity)
+        {
+            ssize_t newCapacity = std::max(output.capacity * BUFFER_INC_FACTOR, output.size + size);
+            unsigned char *tmp = (unsigned char*)realloc(output.data, newCapacity);
+            if (! tmp)
+            {
+                CCLOG("cocos2d: ZipUtils: out of memory");
+                return false;
+            }
+            output.data = tmp;
+            output.capacity = newCapacity;
+        }
+        memcpy(output.data + output.size, data, size);
+        output.size += size;
+        return true;
+    }, FILE_CHUNK_SIZE);
+
+    if (! inflateFile(fp, stream))
+    {
+        free(output.data);
+        *out = nullptr;
+        return -1;
+    }
+
+    *out = output.data;
+    return output.size;
+}
+
+int ZipUtils::inflateGZipFile(const char *path, unsigned char **out)
+{
+    CCASSERT(out, "");
+    CCASSERT(&*out, "");
     
-    for (;;) {
-        len = gzread(inFile, *out + offset, bufferSize);
-        if (len < 0)
+    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(path);
+    FILE *fp = fopen(fullPath.c_str(), "rb");
+    if (fp)
+    {
+        unsigned char header[BGZF_HEADER_SIZE];
+        unsigned char trailer[4];
+        bool blocked = false;
+        ssize_t inflatedSize = 0;
+        size_t headerLength = fread(header, 1, sizeof(header), fp);
+        if (! isGZipBuffer(header, headerLength))
         {
-            CCLOG("cocos2d: ZipUtils: error in gzread");
-            free( *out );
-            *out = nullptr;
-            return -1;
+            // the files which aren't gzip are read as they are, like gzread does, from memory
+            fclose(fp);
+            fp = nullptr;
         }
-        if (len == 0)
+        else if (headerLength == sizeof(header) && fseek(fp, -4, SEEK_END) == 0 && fread(trailer, 1, sizeof(trailer), fp) == sizeof(trailer))
         {
-            break;
+            blocked = readBGZFBlockSize(header, sizeof(header)) > 0;
+
+            // deflate doesn't compress more than 1032:1, a bigger size comes from a corrupted file
+            uint32_t size = readLittleEndian32(trailer);
+            if ((int64_t)size <= (int64_t)ftell(fp) * 1032)
+            {
+                inflatedSize = size;
+            }
         }
-        
-        offset += len;
-        
-        // finish reading the file
-        if( (unsigned int)len < bufferSize )
+
+        // the blocked files are inflated in parallel from memory
+        if (fp && ! blocked && fseek(fp, 0, SEEK_SET) == 0)
         {
-            break;
+            /* 512k initial decompress buffer, when the size is unknown */
+            ssize_t len = inflateFileToMemory(fp, out, inflatedSize > 0 ? inflatedSize : 512 * 1024);
+            fclose(fp);
+            if (len < 0)
+            {
+                CCLOG("cocos2d: ZipUtils: error inflating gzip file: %s", path);
+            }
+            return static_cast<int>(len);
         }
-        
-        bufferSize *= BUFFER_INC_FACTOR;
-        totalBufferSize += bufferSize;
-        unsigned char *tmp = (unsigned char*)realloc(*out, totalBufferSize );
-        
-        if( ! tmp )
+        if (fp)
         {
-            CCLOG("cocos2d: ZipUtils: out of memory");
-            free( *out );
-            *out = nullptr;
-            return -1;
+            fclose(fp);
         }
-        
-        *out = tmp;
     }
     
-    if (gzclose(inFile) != Z_OK)
+    // the files in the apk can't be opened with fopen on Android
+    Data compressedData = FileUtils::getInstance()->getDataFromFile(fullPath);
+    if (compressedData.isNull())
+    {
+        CCLOG("cocos2d: ZipUtils: error open gzip file: %s", path);
+        return -1;
+    }
+    
+    if (! isGZipBuffer(compressedData.getBytes(), compressedData.getSize()))
     {
-        CCLOG("cocos2d: ZipUtils: gzclose failed");
+        *out = (unsigned char*)malloc(std::max(compressedData.getSize(), (ssize_t)1));
+        if (! *out)
+        {
+            CCLOG("cocos2d: ZipUtils: out of memory");
+            return -1;
+        }
+        if (compressedData.getSize() > 0)
+        {
+            memcpy(*out, compressedData.getBytes(), compressedData.getSize());
+        }
+        return static_cast<int>(compressedData.getSize());
     }
     
-    return offset;
+    ssize_t len = inflateMemory(compressedData.getBytes(), compressedData.getSize(), out);
+    return *out ? static_cast<int>(len) : -1;
 }
 
 bool ZipUtils::isCCZFile(const char *path)
@@ -448,8 +777,37 @@ int ZipUtils::inflateCCZFile(const char *path, unsigned char **out)
 {
     CCASSERT(out, "Invalid pointer for buffer!");
     
-    // load file into memory
-    Data compressedData = FileUtils::getInstance()->getDataFromFile(path);
+    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(path);
+    FILE *fp = fopen(fullPath.c_str(), "rb");
+    if (fp)
+    {
+        struct CCZHeader header;
+        if (fread(&header, 1, sizeof(header), fp) == sizeof(header)
+            && header.sig[0] == 'C' && header.sig[1] == 'C' && header.sig[2] == 'Z' && header.sig[3] == '!'
+            && CC_SWAP_INT16_BIG_TO_HOST(header.version) <= 2
+            && CC_SWAP_INT16_BIG_TO_HOST(header.compression_type) == CCZ_COMPRESSION_ZLIB)
+        {
+            // the header gives the inflated size, the file is inflated into a buffer of that size without being loaded
+            unsigned int len = CC_SWAP_INT32_BIG_TO_HOST( header.len );
+            ssize_t inflatedLength = inflateFileToMemory(fp, out, len);
+            fclose(fp);
+            if (inflatedLength != len)
+            {
+                CCLOG("cocos2d: CCZ: Failed to uncompress data");
+                if (inflatedLength >= 0)
+                {
+                    free(*out);
+                    *out = nullptr;
+                }
+                return -1;
+            }
+            return static_cast<int>(inflatedLength);
+        }
+        fclose(fp);
+    }
+    
+    // load file into memory: encrypted files are decrypted at once, and the files in the apk can't be opened with fopen on Android
+    Data compressedData = FileUtils::getInstance()->getDataFromFile(fullPath);
     
     if (compressedData.isNull())
     {
@@ -460,6 +818,149 @@ int ZipUtils::inflateCCZFile(const char *path, unsigned char **out)
     return inflateCCZBuffer(compressedData.getBytes(), compressedData.getSize(), out);
 }
 
+bool ZipUtils::inflateFileInChunks(const std::string &path, const std::function<bool(const unsigned char *data, ssize_t size)> &callback, ssize_t chunkSize)
+{
+    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(path);
+    InflateStream stream(callback, chunkSize);
+    
+    FILE *fp = fopen(fullPath.c_str(), "rb");
+    if (fp)
+    {
+        struct CCZHeader header;
+        bool ccz = fread(&header, 1, sizeof(header), fp) == sizeof(header) && isCCZBuffer((const unsigned char*)&header, sizeof(header));
+        if (! ccz || header.sig[3] == '!')
+        {
+            // the zlib data of CCZ files follows their header
+            bool ok = fseek(fp, ccz ? sizeof(header) : 0, SEEK_SET) == 0 && inflateFile(fp, stream);
+            fclose(fp);
+            return ok;
+        }
+        fclose(fp);
+    }
+    
+    Data compressedData = FileUtils::getInstance()->getDataFromFile(fullPath);
+    if (compressedData.isNull())
+    {
+        CCLOG("cocos2d: ZipUtils: error open file: %s", path.c_str());
+        return false;
+    }
+    
+    const unsigned char *bytes = compressedData.getBytes();
+    ssize_t len = compressedData.getSize();
+    if (isCCZBuffer(bytes, len))
+    {
+        if (bytes[3] == 'p')
+        {
+            // encrypted CCZ files are decrypted at once, the inflated data is then split
+            unsigned char *inflated = nullptr;
+            int inflatedLength = inflateCCZBuffer(bytes, len, &inflated);
+            if (inflatedLength < 0)
+            {
+                return false;
+            }
+            
+            bool ok = true;
+            for (ssize_t offset = 0; ok && offset < inflatedLength; offset += chunkSize)
+            {
+                ok = callback(inflated + offset, std::min(chunkSize, inflatedLength - offset));
+            }
+            free(inflated);
+            return ok;
+        }
+        bytes += sizeof(struct CCZHeader);
+        len -= sizeof(struct CCZHeader);
+    }
+    
+    return stream.write(bytes, len) && stream.finish();
+}
+
+ssize_t ZipUtils::deflateMemory(const unsigned char *in, ssize_t inLength, unsigned char **out, bool independentBlocks)
+{
+    CCASSERT(out, "Invalid pointer for buffer!");
+    *out = nullptr;
+    
+    if (! independentBlocks)
+    {
+        z_stream stream;
+        memset(&stream, 0, sizeof(stream));
+        // a gzip header and trailer around the deflated data
+        if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        {
+            CCLOG("cocos2d: ZipUtils: deflateInit2 failed");
+            return -1;
+        }
+        
+        uLong bound = deflateBound(&stream, static_cast<uLong>(inLength));
+        *out = (unsigned char*)malloc(bound);
+        if (! *out)
+        {
+            CCLOG("cocos2d: ZipUtils: out of memory");
+            deflateEnd(&stream);
+            return -1;
+        }
+        
+        stream.next_in = const_cast<unsigned char*>(in);
+        stream.avail_in = static_cast<unsigned int>(inLength);
+        stream.next_out = *out;
+        stream.avail_out = static_cast<unsigned int>(bound);
+        int err = deflate(&stream, Z_FINISH);
+        ssize_t outLength = stream.total_out;
+        deflateEnd(&stream);
+        
+        if (err != Z_STREAM_END)
+        {
+            CCLOG("cocos2d: ZipUtils: deflate failed: %d", err);
+            free(*out);
+            *out = nullptr;
+            return -1;
+        }
+        return outLength;
+    }
+    
+    // every block is deflated in its own slot of the maximum size, then the blocks are packed
+    ssize_t blockCount = std::max((inLength + BGZF_BLOCK_INPUT_SIZE - 1) / BGZF_BLOCK_INPUT_SIZE, (ssize_t)1);
+    std::vector<unsigned char> blocks(blockCount * BGZF_BLOCK_MAX_SIZE);
+    std::vector<ssize_t> blockSizes(blockCount);
+    ThreadPool::getInstance()->parallelFor(blockCount, 1, [&](ssize_t begin, ssize_t end){
+        for (ssize_t i = begin; i < end; ++i)
+        {
+            ssize_t offset = i * BGZF_BLOCK_INPUT_SIZE;
+            blockSizes[i] = writeBGZFBlock(in + offset, std::min((ssize_t)BGZF_BLOCK_INPUT_SIZE, inLength - offset), &blocks[i * BGZF_BLOCK_MAX_SIZE]);
+        }
+    });
+    
+    // an empty block marks the end of BGZF files
+    static const unsigned char endOfFileBlock[] = {
+        0x1F, 0x8B, Z_DEFLATED, 0x04, 0, 0, 0, 0, 0, 0xFF, 6, 0, 'B', 'C', 2, 0, 0x1B, 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0
+    };
+    ssize_t outLength = sizeof(endOfFileBlock);
+    for (ssize_t blockSize : blockSizes)
+    {
+        if (blockSize < 0)
+        {
+            CCLOG("cocos2d: ZipUtils: deflate failed");
+            return -1;
+        }
+        outLength += blockSize;
+    }
+    
+    *out = (unsigned char*)malloc(outLength);
+    if (! *out)
+    {
+        CCLOG("cocos2d: ZipUtils: out of memory");
+        return -1;
+    }
+    
+    unsigned char *output = *out;
+    for (ssize_t i = 0; i < blockCount; ++i)
+    {
+        memcpy(output, &blocks[i * BGZF_BLOCK_MAX_SIZE], blockSizes[i]);
+        output += blockSizes[i];
+    }
+    memcpy(output, endOfFileBlock, sizeof(endOfFileBlock));
+    return outLength;
+}
+
 void ZipUtils::setPvrEncryptionKeyPart(int index, unsigned int value)
 {
     CCASSERT(index >= 0, "Cocos2d: key part index cannot be less than 0");
@@ -480,6 +981,115 @@ void ZipUtils::setPvrEncryptionKey(unsigned int keyPart1, unsigned int keyPart2,
     setPvrEncryptionKeyPart(3, keyPart4);
 }
 
+// --------------------- InflateStream ---------------------
+
+InflateStream::InflateStream(const ChunkCallback &callback, ssize_t chunkSize)
+: _stream(new z_stream)
+, _callback(callback)
+, _chunk((unsigned char*)malloc(chunkSize))
+, _chunkSize(chunkSize)
+, _totalOut(0)
+, _finished(false)
+, _failed(false)
+{
+    memset(_stream, 0, sizeof(z_stream));
+    if (! _chunk || inflateInit2(_stream, 15 + 32) != Z_OK)
+    {
+        CCLOG("cocos2d: ZipUtils: failed to initialize the inflate stream");
+        delete _stream;
+        _stream = nullptr;
+        _failed = true;
+        return;
+    }
+    
+    _stream->next_out = _chunk;
+    _stream->avail_out = static_cast<unsigned int>(_chunkSize);
+}
+
+InflateStream::~InflateStream()
+{
+    if (_stream)
+    {
+        inflateEnd(_stream);
+        delete _stream;
+    }
+    free(_chunk);
+}
+
+bool InflateStream::write(const unsigned char *in, ssize_t inLength)
+{
+    if (_failed)
+    {
+        return false;
+    }
+    
+    _stream->next_in = const_cast<unsigned char*>(in);
+    _stream->avail_in = static_cast<unsigned int>(inLength);
+    while (_stream->avail_in > 0)
+    {
+        if (_finished)
+        {
+            // another gzip member follows, anything else after the end of the stream is ignored
+            if (! isGZipMemberStart(_stream->next_in, _stream->avail_in) || inflateReset(_stream) != Z_OK)
+            {
+                break;
+            }
+            _finished = false;
+        }
+        
+        int err = inflate(_stream, Z_NO_FLUSH);
+        if (err == Z_STREAM_END)
+        {
+            _finished = true;
+        }
+        else if (err != Z_OK && err != Z_BUF_ERROR)
+        {
+            CCLOG("cocos2d: ZipUtils: Incorrect zlib compressed data: %d", err);
+            _failed = true;
+            return false;
+        }
+        
+        if (_stream->avail_out == 0 && ! flushChunk())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool InflateStream::finish()
+{
+    if (_failed || ! flushChunk())
+    {
+        return false;
+    }
+    
+    if (! _finished)
+    {
+        CCLOG("cocos2d: ZipUtils: the compressed data is incomplete");
+    }
+    return _finished;
+}
+
+bool InflateStream::flushChunk()
+{
+    ssize_t size = _chunkSize - _stream->avail_out;
+    if (size == 0)
+    {
+        return true;
+    }
+    
+    _totalOut += size;
+    _stream->next_out = _chunk;
+    _stream->avail_out = static_cast<unsigned int>(_chunkSize);
+    if (! _callback(_chunk, size))
+    {
+        _failed = true;
+        return false;
+    }
+    return true;
+}
+
 // --------------------- ZipFile ---------------------
 // from unzip.cpp
 #define UNZ_MAXFILENAMEINZIP 256
@@ -26,6 +26,7 @@ THE SOFTWARE.
 #define __SUPPORT_ZIPUTILS_H__
 
 #include <string>
+#include <functional>
 #include "base/CCPlatformConfig.h"
 #include "CCPlatformDefine.h"
 #include "base/CCPlatformMacros.h"
@@ -37,6 +38,8 @@ THE SOFTWARE.
 #include "CCStdC.h"
 #endif
 
+struct z_stream_s;
+
 namespace cocos2d
 {
     /* XXX: pragma pack ??? */
@@ -65,6 +68,8 @@ namespace cocos2d
         * expected to be freed by the caller.
         *
         * It will allocate 256k for the destination buffer. If it is not enough it will multiply the previous buffer size per 2, until there is enough memory.
+        * Gzip data stores its inflated size: the destination buffer is allocated once with that size.
+        * Gzip data made of independent blocks (BGZF, see deflateMemory()) is inflated in parallel.
         * @returns the length of the deflated buffer
         *
         @since v0.8.1
@@ -76,7 +81,8 @@ namespace cocos2d
         * Inflates either zlib or gzip deflated memory. The inflated memory is
         * expected to be freed by the caller.
         *
-        * outLenghtHint is assumed to be the needed room to allocate the inflated buffer.
+        * outLenghtHint is assumed to be the needed room to allocate the inflated buffer,
+        * unless the data is gzip, which stores the inflated size.
         *
         * @returns the length of the deflated buffer
         *
@@ -85,6 +91,41 @@ namespace cocos2d
         CC_DEPRECATED_ATTRIBUTE static ssize_t ccInflateMemoryWithHint(unsigned char *in, ssize_t inLength, unsigned char **out, ssize_t outLengthHint) { return inflateMemoryWithHint(in, inLength, out, outLengthHint); }
         static ssize_t inflateMemoryWithHint(unsigned char *in, ssize_t inLength, unsigned char **out, ssize_t outLengthHint);
 
+        /**
+        * Inflates either zlib or gzip deflated memory into a buffer of the caller, without any
+        * allocation, for the formats which know the inflated size (the tile layers of TMX maps...).
+        *
+        * @returns the length of the inflated data, or -1 if the data is invalid or doesn't fit in outLength bytes
+        *
+        @since v3.1
+        */
+        static ssize_t inflateMemoryToBuffer(const unsigned char *in, ssize_t inLength, unsigned char *out, ssize_t outLength);
+
+        /**
+        * Inflates a gzip, CCZ or zlib file chunk by chunk: the compressed file is read chunkSize bytes at a time,
+        * and the inflated data is passed to the callback in chunks of chunkSize bytes (the last one may be smaller),
+        * so neither the compressed nor the inflated file is ever in memory at once. The callback returns false to stop.
+        * Encrypted CCZ files and the files that can't be opened with fopen (in the apk on Android) are read at once.
+        *
+        * @returns true if the whole file was inflated
+        *
+        @since v3.1
+        */
+        static bool inflateFileInChunks(const std::string &path, const std::function<bool(const unsigned char *data, ssize_t size)> &callback, ssize_t chunkSize = 64 * 1024);
+
+        /**
+        * Deflates memory into gzip data. The deflated memory is expected to be freed by the caller.
+        *
+        * With independentBlocks, the data is split in blocks of 64k at most, deflated in parallel and
+        * written as gzip members storing their compressed size (the BGZF layout of bgzip): the result is a
+        * valid gzip file, slightly bigger, that inflateMemory() inflates in parallel.
+        *
+        * @returns the length of the deflated buffer, or -1 on error
+        *
+        @since v3.1
+        */
+        static ssize_t deflateMemory(const unsigned char *in, ssize_t inLength, unsigned char **out, bool independentBlocks = false);
+
         /** inflates a GZip file into memory
         *
         * @returns the length of the deflated buffer
@@ -204,6 +245,7 @@ namespace cocos2d
 
     private:
         static int inflateMemoryWithHint(unsigned char *in, ssize_t inLength, unsigned char **out, ssize_t *outLength, ssize_t outLenghtHint);
+        static ssize_t inflateBlockedGZip(const unsigned char *in, ssize_t inLength, unsigned char **out);
         static inline void decodeEncodedPvr (unsigned int *data, ssize_t len);
         static inline unsigned int checksumPvr(const unsigned int *data, ssize_t len);
 
@@ -212,6 +254,51 @@ namespace cocos2d
         static bool s_bEncryptionKeyIsValid;
     };
 
+    /**
+    * Inflates zlib or gzip data written to it piece by piece, and passes the inflated data to a callback
+    * in chunks of a fixed size, the last one may be smaller. Nothing else is allocated than the chunk:
+    * the data can be read from a file or the network and consumed (parsed, uploaded in a texture row
+    * by row...) as it comes. Gzip data made of several members is inflated completely.
+    *
+    * @since v3.1
+    */
+    class CC_DLL InflateStream
+    {
+    public:
+        /** Receives the inflated data, returns false to stop inflating */
+        typedef std::function<bool(const unsigned char *data, ssize_t size)> ChunkCallback;
+
+        InflateStream(const ChunkCallback &callback, ssize_t chunkSize = 64 * 1024);
+        ~InflateStream();
+
+        /**
+        * Inflates the next compressed bytes, the chunks filled are passed to the callback.
+        * @returns false if the data is invalid or if the callback stopped the stream
+        */
+        bool write(const unsigned char *in, ssize_t inLength);
+        /**
+        * Passes the last chunk to the callback.
+        * @returns false if the compressed data was invalid or incomplete
+        */
+        bool finish();
+
+        /** true once the end of the compressed data was reached */
+        bool isFinished() const { return _finished; }
+        /** size of the data passed to the callback so far */
+        ssize_t getTotalOut() const { return _totalOut; }
+
+    private:
+        bool flushChunk();
+
+        z_stream_s *_stream;
+        ChunkCallback _callback;
+        unsigned char *_chunk;
+        ssize_t _chunkSize;
+        ssize_t _totalOut;
+        bool _finished;
+        bool _failed;
+    };
+
     // forward declaration
     class ZipFilePrivate;
 
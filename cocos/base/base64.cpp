@@ -159,6 +159,79 @@ int base64Decode(const unsigned char *in, unsigned int inLength, unsigned char *
     return outLength;
 }
 
+// value of each character in the alphabet, 0xff for the other characters.
+// A constant table, so that several threads can decode at the same time
+static const unsigned char s_decodingTable[256] = {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,   62, 0xff, 0xff, 0xff,   63,
+      52,   53,   54,   55,   56,   57,   58,   59,   60,   61, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff,    0,    1,    2,    3,    4,    5,    6,    7,    8,    9,   10,   11,   12,   13,   14,
+      15,   16,   17,   18,   19,   20,   21,   22,   23,   24,   25, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff,   26,   27,   28,   29,   30,   31,   32,   33,   34,   35,   36,   37,   38,   39,   40,
+      41,   42,   43,   44,   45,   46,   47,   48,   49,   50,   51, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+};
+
+int base64DecodeInto(const unsigned char *in, unsigned int inLength, unsigned char *out, unsigned int outCapacity)
+{
+    unsigned int bits = 0;
+    unsigned int charCount = 0;
+    unsigned int outLength = 0;
+
+    // 3 bytes are written once 4 characters have been read, so decoding in place is safe
+    for (unsigned int i = 0; i < inLength; ++i)
+    {
+        unsigned char c = in[i];
+        if (c == '=')
+            break;
+
+        unsigned char value = s_decodingTable[c];
+        if (value == 0xff)
+            continue;
+
+        bits = (bits << 6) | value;
+        if (++charCount == 4)
+        {
+            if (outLength + 3 > outCapacity)
+                return -1;
+
+            out[outLength++] = (unsigned char)(bits >> 16);
+            out[outLength++] = (unsigned char)(bits >> 8);
+            out[outLength++] = (unsigned char)bits;
+            bits = 0;
+            charCount = 0;
+        }
+    }
+
+    switch (charCount)
+    {
+        case 1:
+            // at least 2 bits missing
+            return -1;
+        case 2:
+            if (outLength + 1 > outCapacity)
+                return -1;
+            out[outLength++] = (unsigned char)(bits >> 4);
+            break;
+        case 3:
+            if (outLength + 2 > outCapacity)
+                return -1;
+            out[outLength++] = (unsigned char)(bits >> 10);
+            out[outLength++] = (unsigned char)(bits >> 2);
+            break;
+    }
+
+    return (int)outLength;
+}
+
 int base64Encode(const unsigned char *in, unsigned int inLength, char **out) {
     unsigned int outLength = inLength * 4 / 3 + (inLength % 3 > 0 ? 4 : 0);
     
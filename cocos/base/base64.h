@@ -45,6 +45,18 @@ namespace cocos2d {
  @since v0.8.1
  */
 int base64Decode(const unsigned char *in, unsigned int inLength, unsigned char **out);
+
+/**
+ * Decodes a 64base encoded memory into a buffer of the caller. The characters
+ * which are not part of the alphabet (white spaces, line breaks) are skipped.
+ * `out` may be `in` itself: the data is decoded in place.
+ *
+ * @returns the length of the decoded data, or -1 if the encoding is incomplete
+ * or the decoded data doesn't fit in outCapacity bytes
+ *
+ @since v3.1
+ */
+int base64DecodeInto(const unsigned char *in, unsigned int inLength, unsigned char *out, unsigned int outCapacity);
     
 /**
  * Encodes bytes into a 64base encoded memory with terminating '\0' character. 
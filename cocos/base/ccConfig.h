@@ -252,8 +252,8 @@ To enable set it to a value different than 0. Disabled by default.
 #endif
 
 /** @def CC_ENABLE_PROFILERS
- If enabled, will activate various profilers within cocos2d. This statistical data will be output to the console
- once per second showing average time (in milliseconds) required to execute the specific routine(s).
+ If enabled, will activate various profilers within cocos2d. Their scopes are recorded by ProfilerTrace while a
+ capture runs (see the "profiler" console command) and can be exported to chrome://tracing.
  Useful for debugging purposes only. It is recommended to leave it disabled.
  
  To enable set it to a value different than 0. Disabled by default.
@@ -277,6 +277,18 @@ To enable set it to a value different than 0. Disabled by default.
 #define CC_ENABLE_SCRIPT_BINDING 1
 #endif
 
+/** @def CC_ENABLE_NODE_SLAB_ALLOCATOR
+ If enabled, the nodes and their subclasses are allocated by a SlabAllocator (see Node::getAllocator()) instead of
+ the heap. Creating and destroying many nodes of the same kind, like bullets, then reuses the memory of the
+ destroyed nodes without calling the system allocator, and its statistics count the nodes allocated.
+ The nodes must be created and destroyed on the cocos2d thread.
+ 
+ To enable set it to a value different than 0. Disabled by default.
+ */
+#ifndef CC_ENABLE_NODE_SLAB_ALLOCATOR
+#define CC_ENABLE_NODE_SLAB_ALLOCATOR 0
+#endif
+
 /** @def CC_CONSTRUCTOR_ACCESS
  Indicate the init functions access modifier. If value equals to protected, then these functions are protected. 
  If value equals to public, these functions are public
@@ -206,13 +206,19 @@ It should work same as apples CFSwapInt32LittleToHost(..)
 #define CC_PROFILER_DISPLAY_TIMERS() Profiler::getInstance()->displayTimers()
 #define CC_PROFILER_PURGE_ALL() Profiler::getInstance()->releaseAllTimers()
 
-#define CC_PROFILER_START(__name__) ProfilingBeginTimingBlock(__name__)
-#define CC_PROFILER_STOP(__name__) ProfilingEndTimingBlock(__name__)
-#define CC_PROFILER_RESET(__name__) ProfilingResetTimingBlock(__name__)
+/* The scope names must be constant strings: their id is registered once per call site */
+#define CC_PROFILER_SCOPE_ID(__name__) []() { static const unsigned int scopeId = ProfilerTrace::registerScope(__name__); return scopeId; }()
+#define CC_PROFILER_CONCAT_(__a__, __b__) __a__##__b__
+#define CC_PROFILER_CONCAT(__a__, __b__) CC_PROFILER_CONCAT_(__a__, __b__)
+#define CC_PROFILER_SCOPE(__name__) ProfilerScope CC_PROFILER_CONCAT(__profilerScope, __LINE__)(CC_PROFILER_SCOPE_ID(__name__))
+
+#define CC_PROFILER_START(__name__) ProfilerTrace::beginScope(CC_PROFILER_SCOPE_ID(__name__))
+#define CC_PROFILER_STOP(__name__) ProfilerTrace::endScope(CC_PROFILER_SCOPE_ID(__name__))
+#define CC_PROFILER_RESET(__name__) do {} while (0)
 
-#define CC_PROFILER_START_CATEGORY(__cat__, __name__) do{ if(__cat__) ProfilingBeginTimingBlock(__name__); } while(0)
-#define CC_PROFILER_STOP_CATEGORY(__cat__, __name__) do{ if(__cat__) ProfilingEndTimingBlock(__name__); } while(0)
-#define CC_PROFILER_RESET_CATEGORY(__cat__, __name__) do{ if(__cat__) ProfilingResetTimingBlock(__name__); } while(0)
+#define CC_PROFILER_START_CATEGORY(__cat__, __name__) do{ if(__cat__) ProfilerTrace::beginScope(CC_PROFILER_SCOPE_ID(__name__)); } while(0)
+#define CC_PROFILER_STOP_CATEGORY(__cat__, __name__) do{ if(__cat__) ProfilerTrace::endScope(CC_PROFILER_SCOPE_ID(__name__)); } while(0)
+#define CC_PROFILER_RESET_CATEGORY(__cat__, __name__) do {} while(0)
 
 #define CC_PROFILER_START_INSTANCE(__id__, __name__) do{ ProfilingBeginTimingBlock( String::createWithFormat("%08X - %s", __id__, __name__)->getCString() ); } while(0)
 #define CC_PROFILER_STOP_INSTANCE(__id__, __name__) do{ ProfilingEndTimingBlock(    String::createWithFormat("%08X - %s", __id__, __name__)->getCString() ); } while(0)
@@ -224,6 +230,8 @@ It should work same as apples CFSwapInt32LittleToHost(..)
 #define CC_PROFILER_DISPLAY_TIMERS() do {} while (0)
 #define CC_PROFILER_PURGE_ALL() do {} while (0)
 
+#define CC_PROFILER_SCOPE(__name__) do {} while (0)
+
 #define CC_PROFILER_START(__name__)  do {} while (0)
 #define CC_PROFILER_STOP(__name__) do {} while (0)
 #define CC_PROFILER_RESET(__name__) do {} while (0)
@@ -16,6 +16,14 @@
 
 #include <string.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ETC1_USE_SSE2 1
+#include <emmintrin.h>
+#elif defined(USE_NEON)
+#define ETC1_USE_NEON 1
+#include <arm_neon.h>
+#endif
+
 /* From http://www.khronos.org/registry/gles/extensions/OES/OES_compressed_ETC1_RGB8_texture.txt
 
  The number of bits that represent a 4x4 texel block is 64 bits if
@@ -163,8 +171,50 @@ inline int convertDiff(int base, int diff) {
     return convert5To8((0x1f & base) + kLookup[0x7 & diff]);
 }
 
+#if ETC1_USE_SSE2 || ETC1_USE_NEON
+// kModifierTable spread over the 16 bit lanes of four R, G, B, X colors.
+static const short kModifierLanes[8][16] = {
+#define ETC1_LANES(a, b) { a, a, a, 0, b, b, b, 0, -a, -a, -a, 0, -b, -b, -b, 0 }
+    ETC1_LANES(2, 8), ETC1_LANES(5, 17), ETC1_LANES(9, 29), ETC1_LANES(13, 42),
+    ETC1_LANES(18, 60), ETC1_LANES(24, 80), ETC1_LANES(33, 106), ETC1_LANES(47, 183)
+#undef ETC1_LANES
+};
+#endif
+
+// Computes the four colors a subblock can use, as R, G, B, X quadruplets.
+// The vector versions add the modifiers in 16 bit lanes and let the
+// saturating narrow do the clamping.
+
+static
+inline void decode_palette(etc1_byte* pPalette, int r, int g, int b, int tableIndex) {
+#if ETC1_USE_SSE2
+    const __m128i* lanes = (const __m128i*) kModifierLanes[tableIndex];
+    __m128i base = _mm_set_epi16(0, b, g, r, 0, b, g, r);
+    __m128i lo = _mm_add_epi16(base, _mm_loadu_si128(lanes));
+    __m128i hi = _mm_add_epi16(base, _mm_loadu_si128(lanes + 1));
+    _mm_storeu_si128((__m128i*) pPalette, _mm_packus_epi16(lo, hi));
+#elif ETC1_USE_NEON
+    const short* lanes = kModifierLanes[tableIndex];
+    int16x4_t color = vcreate_s16((etc1_uint32) r | ((etc1_uint32) g << 16)
+            | ((unsigned long long) b << 32));
+    int16x8_t base = vcombine_s16(color, color);
+    uint8x8_t lo = vqmovun_s16(vaddq_s16(base, vld1q_s16(lanes)));
+    uint8x8_t hi = vqmovun_s16(vaddq_s16(base, vld1q_s16(lanes + 8)));
+    vst1q_u8(pPalette, vcombine_u8(lo, hi));
+#else
+    const int* table = kModifierTable + tableIndex * 4;
+    for (int i = 0; i < 4; i++) {
+        int delta = table[i];
+        *pPalette++ = clamp(r + delta);
+        *pPalette++ = clamp(g + delta);
+        *pPalette++ = clamp(b + delta);
+        *pPalette++ = 0;
+    }
+#endif
+}
+
 static
-void decode_subblock(etc1_byte* pOut, int r, int g, int b, const int* table,
+void decode_subblock(etc1_byte* pOut, int r, int g, int b, int tableIndex,
         etc1_uint32 low, bool second, bool flipped) {
     int baseX = 0;
     int baseY = 0;
@@ -175,6 +225,8 @@ void decode_subblock(etc1_byte* pOut, int r, int g, int b, const int* table,
             baseX = 2;
         }
     }
+    etc1_byte palette[16];
+    decode_palette(palette, r, g, b, tableIndex);
     for (int i = 0; i < 8; i++) {
         int x, y;
         if (flipped) {
@@ -186,11 +238,11 @@ void decode_subblock(etc1_byte* pOut, int r, int g, int b, const int* table,
         }
         int k = y + (x * 4);
         int offset = ((low >> k) & 1) | ((low >> (k + 15)) & 2);
-        int delta = table[offset];
+        const etc1_byte* c = palette + 4 * offset;
         etc1_byte* q = pOut + 3 * (x + 4 * y);
-        *q++ = clamp(r + delta);
-        *q++ = clamp(g + delta);
-        *q++ = clamp(b + delta);
+        *q++ = c[0];
+        *q++ = c[1];
+        *q++ = c[2];
     }
 }
 
@@ -223,11 +275,9 @@ void etc1_decode_block(const etc1_byte* pIn, etc1_byte* pOut) {
     }
     int tableIndexA = 7 & (high >> 5);
     int tableIndexB = 7 & (high >> 2);
-    const int* tableA = kModifierTable + tableIndexA * 4;
-    const int* tableB = kModifierTable + tableIndexB * 4;
     bool flipped = (high & 1) != 0;
-    decode_subblock(pOut, r1, g1, b1, tableA, low, false, flipped);
-    decode_subblock(pOut, r2, g2, b2, tableB, low, true, flipped);
+    decode_subblock(pOut, r1, g1, b1, tableIndexA, low, false, flipped);
+    decode_subblock(pOut, r2, g2, b2, tableIndexB, low, true, flipped);
 }
 
 typedef struct {
@@ -24,6 +24,203 @@
 
 #include "s3tc.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define CC_S3TC_USE_SSE2 1
+    #include <emmintrin.h>
+#elif defined(USE_NEON)
+    #define CC_S3TC_USE_NEON 1
+    #include <arm_neon.h>
+#endif
+
+//Derive the eight alphas of a DXT5 block from its two end points
+static void s3tc_dxt5_alphas(uint64_t alpha, unsigned int alphaArray[8])
+{
+    // 8-Alpha block: derive the other six alphas.
+    // Bit code 000 = alpha0, 001 = alpha1, other are interpolated.
+    alphaArray[0] = (alpha ) & 0xff ;
+    alphaArray[1] = (alpha >> 8) & 0xff ;
+    
+    if (alphaArray[0] >= alphaArray[1])
+    {
+        alphaArray[2] = (alphaArray[0]*6 + alphaArray[1]*1) / 7;
+        alphaArray[3] = (alphaArray[0]*5 + alphaArray[1]*2) / 7;
+        alphaArray[4] = (alphaArray[0]*4 + alphaArray[1]*3) / 7;
+        alphaArray[5] = (alphaArray[0]*3 + alphaArray[1]*4) / 7;
+        alphaArray[6] = (alphaArray[0]*2 + alphaArray[1]*5) / 7;
+        alphaArray[7] = (alphaArray[0]*1 + alphaArray[1]*6) / 7;
+    }
+    else
+    {
+        alphaArray[2] = (alphaArray[0]*4 + alphaArray[1]*1) / 5;
+        alphaArray[3] = (alphaArray[0]*3 + alphaArray[1]*2) / 5;
+        alphaArray[4] = (alphaArray[0]*2 + alphaArray[1]*3) / 5;
+        alphaArray[5] = (alphaArray[0]*1 + alphaArray[1]*4) / 5;
+        alphaArray[6] = 0;
+        alphaArray[7] = 255;
+    }
+}
+
+#if CC_S3TC_USE_SSE2
+
+typedef __m128i s3tc_row;
+
+//Build the 4 colors of a block in one register: the two interpolated colors
+//are computed per channel in 16 bits lanes, with the same rounding as the
+//packed scalar code
+static inline s3tc_row s3tc_palette(uint32_t color0, uint32_t color1, bool fourColors, uint32_t initAlpha)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i ends = _mm_unpacklo_epi32(_mm_cvtsi32_si128(color0), _mm_cvtsi32_si128(color1));
+    __m128i c01  = _mm_unpacklo_epi8(ends, zero);
+    __m128i c10  = _mm_shuffle_epi32(c01, _MM_SHUFFLE(1, 0, 3, 2));
+    __m128i mid;
+    if (fourColors)
+    {
+        mid = _mm_add_epi16(_mm_add_epi16(c01, c01), c10);
+        mid = _mm_srli_epi16(_mm_mullo_epi16(mid, _mm_set1_epi16(21)), 6);
+    }
+    else
+    {
+        mid = _mm_srli_epi16(_mm_add_epi16(c01, c10), 1);
+    }
+    __m128i palette = _mm_unpacklo_epi64(ends, _mm_packus_epi16(mid, zero));
+    if (fourColors)
+    {
+        return _mm_or_si128(palette, _mm_set1_epi32(initAlpha));
+    }
+    return _mm_or_si128(_mm_and_si128(palette, _mm_set_epi32(0, -1, -1, -1)),
+                        _mm_set_epi32(0, initAlpha, initAlpha, initAlpha));
+}
+
+static inline void s3tc_broadcast(s3tc_row palette, s3tc_row entries[4])
+{
+    entries[0] = _mm_shuffle_epi32(palette, 0x00);
+    entries[1] = _mm_shuffle_epi32(palette, 0x55);
+    entries[2] = _mm_shuffle_epi32(palette, 0xaa);
+    entries[3] = _mm_shuffle_epi32(palette, 0xff);
+}
+
+//Pick the colors of a row of 4 pixels, indices holds 2 bits per pixel
+static inline s3tc_row s3tc_select(const s3tc_row entries[4], unsigned int indices)
+{
+    const __m128i laneMask = _mm_set_epi32(0xc0, 0x30, 0x0c, 0x03);
+    const __m128i one      = _mm_set_epi32(0x40, 0x10, 0x04, 0x01);
+    __m128i index = _mm_and_si128(_mm_set1_epi32(indices), laneMask);
+    __m128i row   = _mm_and_si128(entries[0], _mm_cmpeq_epi32(index, _mm_setzero_si128()));
+    row = _mm_or_si128(row, _mm_and_si128(entries[1], _mm_cmpeq_epi32(index, one)));
+    row = _mm_or_si128(row, _mm_and_si128(entries[2], _mm_cmpeq_epi32(index, _mm_add_epi32(one, one))));
+    return _mm_or_si128(row, _mm_and_si128(entries[3], _mm_cmpeq_epi32(index, laneMask)));
+}
+
+//Expand the 4 explicit alphas of a DXT3 row, 4 bits per pixel, to a << 28 | a << 24
+static inline s3tc_row s3tc_explicit_alpha(unsigned int alpha)
+{
+    __m128i a = _mm_and_si128(_mm_set1_epi32(alpha), _mm_set_epi32(0xf000, 0x0f00, 0x00f0, 0x000f));
+    a = _mm_slli_epi32(_mm_mullo_epi16(a, _mm_set_epi16(0, 1, 0, 16, 0, 256, 0, 4096)), 16);
+    return _mm_add_epi32(a, _mm_srli_epi32(a, 4));
+}
+
+//Pick the alphas of a DXT5 row, indices holds 3 bits per pixel of which only
+//the bits 0 and 2 are used, so entries are the alphas 0, 1, 4 and 5
+static inline s3tc_row s3tc_dxt5_alpha(const s3tc_row entries[4], unsigned int indices)
+{
+    const __m128i laneMask = _mm_set_epi32(5 << 9, 5 << 6, 5 << 3, 5);
+    const __m128i one      = _mm_set_epi32(1 << 9, 1 << 6, 1 << 3, 1);
+    __m128i index = _mm_and_si128(_mm_set1_epi32(indices), laneMask);
+    __m128i row   = _mm_and_si128(entries[0], _mm_cmpeq_epi32(index, _mm_setzero_si128()));
+    row = _mm_or_si128(row, _mm_and_si128(entries[1], _mm_cmpeq_epi32(index, one)));
+    row = _mm_or_si128(row, _mm_and_si128(entries[2], _mm_cmpeq_epi32(index, _mm_slli_epi32(one, 2))));
+    return _mm_or_si128(row, _mm_and_si128(entries[3], _mm_cmpeq_epi32(index, laneMask)));
+}
+
+static inline void s3tc_store_row(uint32_t *decodeBlockData, s3tc_row colors, s3tc_row alpha)
+{
+    _mm_storeu_si128((__m128i *)decodeBlockData, _mm_add_epi32(colors, alpha));
+}
+
+static inline s3tc_row s3tc_splat(uint32_t value)
+{
+    return _mm_set1_epi32(value);
+}
+
+#elif CC_S3TC_USE_NEON
+
+typedef uint32x4_t s3tc_row;
+
+//Build the 4 colors of a block in one register: the two interpolated colors
+//are computed per channel in 16 bits lanes, with the same rounding as the
+//packed scalar code
+static inline s3tc_row s3tc_palette(uint32_t color0, uint32_t color1, bool fourColors, uint32_t initAlpha)
+{
+    uint32x2_t ends = vset_lane_u32(color1, vdup_n_u32(color0), 1);
+    uint16x8_t c01  = vmovl_u8(vreinterpret_u8_u32(ends));
+    uint16x8_t c10  = vcombine_u16(vget_high_u16(c01), vget_low_u16(c01));
+    uint16x8_t mid;
+    if (fourColors)
+    {
+        mid = vshrq_n_u16(vmulq_n_u16(vaddq_u16(vaddq_u16(c01, c01), c10), 21), 6);
+    }
+    else
+    {
+        mid = vshrq_n_u16(vaddq_u16(c01, c10), 1);
+    }
+    s3tc_row palette = vcombine_u32(ends, vreinterpret_u32_u8(vmovn_u16(mid)));
+    if (fourColors)
+    {
+        return vorrq_u32(palette, vdupq_n_u32(initAlpha));
+    }
+    return vsetq_lane_u32(0, vorrq_u32(palette, vdupq_n_u32(initAlpha)), 3);
+}
+
+static inline void s3tc_broadcast(s3tc_row palette, s3tc_row entries[4])
+{
+    entries[0] = vdupq_n_u32(vgetq_lane_u32(palette, 0));
+    entries[1] = vdupq_n_u32(vgetq_lane_u32(palette, 1));
+    entries[2] = vdupq_n_u32(vgetq_lane_u32(palette, 2));
+    entries[3] = vdupq_n_u32(vgetq_lane_u32(palette, 3));
+}
+
+//Pick the colors of a row of 4 pixels, indices holds 2 bits per pixel
+static inline s3tc_row s3tc_select(const s3tc_row entries[4], unsigned int indices)
+{
+    static const int32_t shifts[4] = { 0, -2, -4, -6 };
+    uint32x4_t index = vandq_u32(vshlq_u32(vdupq_n_u32(indices), vld1q_s32(shifts)), vdupq_n_u32(3));
+    s3tc_row row = vbslq_u32(vceqq_u32(index, vdupq_n_u32(1)), entries[1], entries[0]);
+    row = vbslq_u32(vceqq_u32(index, vdupq_n_u32(2)), entries[2], row);
+    return vbslq_u32(vceqq_u32(index, vdupq_n_u32(3)), entries[3], row);
+}
+
+//Expand the 4 explicit alphas of a DXT3 row, 4 bits per pixel, to a << 28 | a << 24
+static inline s3tc_row s3tc_explicit_alpha(unsigned int alpha)
+{
+    static const int32_t shifts[4] = { 28, 24, 20, 16 };
+    uint32x4_t a = vandq_u32(vshlq_u32(vdupq_n_u32(alpha), vld1q_s32(shifts)), vdupq_n_u32(0xf0000000));
+    return vaddq_u32(a, vshrq_n_u32(a, 4));
+}
+
+//Pick the alphas of a DXT5 row, indices holds 3 bits per pixel of which only
+//the bits 0 and 2 are used, so entries are the alphas 0, 1, 4 and 5
+static inline s3tc_row s3tc_dxt5_alpha(const s3tc_row entries[4], unsigned int indices)
+{
+    static const int32_t shifts[4] = { 0, -3, -6, -9 };
+    uint32x4_t index = vandq_u32(vshlq_u32(vdupq_n_u32(indices), vld1q_s32(shifts)), vdupq_n_u32(5));
+    s3tc_row row = vbslq_u32(vceqq_u32(index, vdupq_n_u32(1)), entries[1], entries[0]);
+    row = vbslq_u32(vceqq_u32(index, vdupq_n_u32(4)), entries[2], row);
+    return vbslq_u32(vceqq_u32(index, vdupq_n_u32(5)), entries[3], row);
+}
+
+static inline void s3tc_store_row(uint32_t *decodeBlockData, s3tc_row colors, s3tc_row alpha)
+{
+    vst1q_u32(decodeBlockData, vaddq_u32(colors, alpha));
+}
+
+static inline s3tc_row s3tc_splat(uint32_t value)
+{
+    return vdupq_n_u32(value);
+}
+
+#endif // CC_S3TC_USE_NEON
+
 //Decode S3TC encode block to 4x4 RGB32 pixels
 static void s3tc_decode_block(uint8_t **blockData,
                        uint32_t *decodeBlockData,
@@ -33,9 +230,8 @@ static void s3tc_decode_block(uint8_t **blockData,
                        S3TCDecodeFlag decodeFlag)
 {
     unsigned int colorValue0 = 0 , colorValue1 = 0, initAlpha = (!oneBitAlphaFlag * 255u) << 24;
-    unsigned int rb0 = 0, rb1 = 0, rb2 = 0, rb3 = 0, g0 = 0, g1 = 0, g2 = 0, g3 = 0;
-    
-    uint32_t colors[4], pixelsIndex = 0;
+    unsigned int rb0 = 0, rb1 = 0, g0 = 0, g1 = 0;
+    uint32_t pixelsIndex = 0;
     
     /* load the two color values*/
     memcpy((void *)&colorValue0, *blockData, 2);
@@ -52,6 +248,61 @@ static void s3tc_decode_block(uint8_t **blockData,
     g0  += (g0 >> 6) & 0x000300;
     g1  += (g1 >> 6) & 0x000300;
     
+#if CC_S3TC_USE_SSE2 || CC_S3TC_USE_NEON
+    // interpolate the other two color values and decode a row of 4 pixels per step
+    s3tc_row entries[4];
+    s3tc_broadcast(s3tc_palette(rb0 + g0, rb1 + g1, colorValue0 > colorValue1 || oneBitAlphaFlag, initAlpha), entries);
+    
+    /*read the pixelsIndex , 2bits per pixel, 4 bytes */
+    memcpy((void*)&pixelsIndex, *blockData, 4);
+    (*blockData) += 4;
+    
+    if (S3TCDecodeFlag::DXT5 == decodeFlag)
+    {
+        //dxt5 use interpolate alpha
+        unsigned int alphaArray[8];
+        s3tc_dxt5_alphas(alpha, alphaArray);
+        
+        s3tc_row alphaEntries[4];
+        alphaEntries[0] = s3tc_splat(alphaArray[0] << 24);
+        alphaEntries[1] = s3tc_splat(alphaArray[1] << 24);
+        alphaEntries[2] = s3tc_splat(alphaArray[4] << 24);
+        alphaEntries[3] = s3tc_splat(alphaArray[5] << 24);
+        
+        // read the flowing 48bit indices (16*3)
+        alpha >>= 16;
+        
+        for (int y = 0; y < 4; ++y)
+        {
+            s3tc_store_row(decodeBlockData, s3tc_select(entries, pixelsIndex & 0xff), s3tc_dxt5_alpha(alphaEntries, alpha & 0xfff));
+            pixelsIndex >>= 8;
+            alpha       >>= 12;
+            decodeBlockData += stride;
+        }
+    }
+    else if (S3TCDecodeFlag::DXT3 == decodeFlag)
+    {
+        for (int y = 0; y < 4; ++y)
+        {
+            s3tc_store_row(decodeBlockData, s3tc_select(entries, pixelsIndex & 0xff), s3tc_explicit_alpha(alpha & 0xffff));
+            pixelsIndex >>= 8;
+            alpha       >>= 16;
+            decodeBlockData += stride;
+        }
+    }
+    else
+    { //dxt1 alpha is already in the colors
+        for (int y = 0; y < 4; ++y)
+        {
+            s3tc_store_row(decodeBlockData, s3tc_select(entries, pixelsIndex & 0xff), s3tc_splat(0));
+            pixelsIndex >>= 8;
+            decodeBlockData += stride;
+        }
+    }
+#else
+    unsigned int rb2 = 0, rb3 = 0, g2 = 0, g3 = 0;
+    uint32_t colors[4];
+    
     colors[0] = rb0 + g0 + initAlpha;
     colors[1] = rb1 + g1 + initAlpha;
     
@@ -79,32 +330,8 @@ static void s3tc_decode_block(uint8_t **blockData,
     if (S3TCDecodeFlag::DXT5 == decodeFlag)
     {
         //dxt5 use interpolate alpha
-        // 8-Alpha block: derive the other six alphas.
-        // Bit code 000 = alpha0, 001 = alpha1, other are interpolated.
-        
         unsigned int alphaArray[8];
-        
-        alphaArray[0] = (alpha ) & 0xff ;
-        alphaArray[1] = (alpha >> 8) & 0xff ;
-        
-        if (alphaArray[0] >= alphaArray[1])
-        {
-            alphaArray[2] = (alphaArray[0]*6 + alphaArray[1]*1) / 7;
-            alphaArray[3] = (alphaArray[0]*5 + alphaArray[1]*2) / 7;
-            alphaArray[4] = (alphaArray[0]*4 + alphaArray[1]*3) / 7;
-            alphaArray[5] = (alphaArray[0]*3 + alphaArray[1]*4) / 7;
-            alphaArray[6] = (alphaArray[0]*2 + alphaArray[1]*5) / 7;
-            alphaArray[7] = (alphaArray[0]*1 + alphaArray[1]*6) / 7;
-        }
-        else if (alphaArray[0] < alphaArray[1])
-        {
-            alphaArray[2] = (alphaArray[0]*4 + alphaArray[1]*1) / 5;
-            alphaArray[3] = (alphaArray[0]*3 + alphaArray[1]*2) / 5;
-            alphaArray[4] = (alphaArray[0]*2 + alphaArray[1]*3) / 5;
-            alphaArray[5] = (alphaArray[0]*1 + alphaArray[1]*4) / 5;
-            alphaArray[6] = 0;
-            alphaArray[7] = 255;
-        }
+        s3tc_dxt5_alphas(alpha, alphaArray);
         
         // read the flowing 48bit indices (16*3)
         alpha >>= 16;
@@ -135,6 +362,7 @@ static void s3tc_decode_block(uint8_t **blockData,
             decodeBlockData += stride;
         }
     }
+#endif
 }
 
 //Decode S3TC encode data to RGB32
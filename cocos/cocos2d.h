@@ -46,6 +46,7 @@ THE SOFTWARE.
 #include "base/CCNS.h"
 #include "base/CCData.h"
 #include "base/CCValue.h"
+#include "base/CCValueView.h"
 #include "base/ccConfig.h"
 #include "base/ccMacros.h"
 #include "base/ccTypes.h"
@@ -56,6 +57,8 @@ THE SOFTWARE.
 #include "base/ZipUtils.h"
 #include "base/CCProfiling.h"
 #include "base/CCConsole.h"
+#include "base/CCThreadPool.h"
+#include "base/CCSlabAllocator.h"
 
 // EventDispatcher
 #include "base/CCEventDispatcher.h"
@@ -100,6 +103,7 @@ THE SOFTWARE.
 
 // 2d nodes
 #include "2d/CCNode.h"
+#include "2d/CCNodePool.h"
 #include "2d/CCAtlasNode.h"
 #include "2d/CCDrawingPrimitives.h"
 #include "2d/CCDrawNode.h"
@@ -137,6 +141,7 @@ THE SOFTWARE.
 #include "renderer/CCCustomCommand.h"
 #include "renderer/CCGroupCommand.h"
 #include "renderer/CCQuadCommand.h"
+#include "renderer/CCTrianglesCommand.h"
 #include "renderer/CCRenderCommand.h"
 #include "renderer/CCRenderCommandPool.h"
 #include "renderer/CCRenderer.h"
@@ -157,6 +162,7 @@ THE SOFTWARE.
 #include "2d/platform/CCDevice.h"
 #include "2d/platform/CCCommon.h"
 #include "2d/platform/CCFileUtils.h"
+#include "2d/platform/CCMappedFile.h"
 #include "2d/platform/CCImage.h"
 #include "2d/platform/CCSAXParser.h"
 #include "2d/platform/CCThread.h"
@@ -231,6 +237,7 @@ THE SOFTWARE.
 #include "2d/CCSpriteBatchNode.h"
 #include "2d/CCSpriteFrame.h"
 #include "2d/CCSpriteFrameCache.h"
+#include "2d/CCDynamicAtlas.h"
 
 // support
 #include "2d/ccUTF8.h"
@@ -246,6 +253,7 @@ THE SOFTWARE.
 #include "2d/CCTexture2D.h"
 #include "2d/CCTextureAtlas.h"
 #include "2d/CCTextureCache.h"
+#include "2d/CCResourceLoader.h"
 
 // tilemap_parallax_nodes
 #include "2d/CCParallaxNode.h"
@@ -34,6 +34,11 @@ THE SOFTWARE.
 #include "renderer/CCGLProgramState.h"
 #include "2d/CCDrawingPrimitives.h"
 #include "base/CCDirector.h"
+#include "base/CCEventDispatcher.h"
+#include "base/CCEventListenerCustom.h"
+#include "base/CCThreadPool.h"
+
+#include <typeinfo>
 
 #if ENABLE_PHYSICS_BOX2D_DETECT
 #include "Box2D/Box2D.h"
@@ -46,6 +51,16 @@ using namespace cocos2d;
 
 namespace cocostudio {
 
+struct QueuedArmature
+{
+    Armature *armature;
+    float dt;
+};
+
+static bool s_parallelUpdateEnabled = false;
+static std::vector<QueuedArmature> s_queuedArmatures;
+static EventListenerCustom *s_queueListener = nullptr;
+
 Armature *Armature::create()
 {
     Armature *armature = new Armature();
@@ -88,6 +103,8 @@ Armature::Armature()
     , _batchNode(nullptr)
     , _parentBone(nullptr)
     , _armatureTransformDirty(true)
+    , _boneListDirty(true)
+    , _hasBoneSubclasses(false)
     , _animation(nullptr)
 {
 }
@@ -97,6 +114,7 @@ Armature::~Armature(void)
 {
     _boneDic.clear();
     _topBoneList.clear();
+    _boneList.clear();
 
     CC_SAFE_DELETE(_animation);
 }
@@ -121,6 +139,7 @@ bool Armature::init(const std::string& name)
 
         _boneDic.clear();
         _topBoneList.clear();
+        _boneListDirty = true;
 
         _blendFunc = BlendFunc::ALPHA_NON_PREMULTIPLIED;
 
@@ -257,6 +276,8 @@ void Armature::addBone(Bone *bone, const std::string& parentName)
 
     _boneDic.insert(bone->getName(), bone);
     addChild(bone);
+
+    _boneListDirty = true;
 }
 
 
@@ -273,6 +294,8 @@ void Armature::removeBone(Bone *bone, bool recursion)
     }
     _boneDic.erase(bone->getName());
     removeChild(bone, true);
+
+    _boneListDirty = true;
 }
 
 
@@ -309,6 +332,8 @@ void Armature::changeBoneParent(Bone *bone, const std::string& parentName)
             _topBoneList.pushBack(bone);
         }
     }
+
+    _boneListDirty = true;
 }
 
 const cocos2d::Map<std::string, Bone*>& Armature::getBoneDic() const
@@ -344,6 +369,7 @@ void Armature::setAnchorPoint(const Vec2& point)
         _anchorPointInPoints = Vec2(_contentSize.width * _anchorPoint.x - _offsetPoint.x, _contentSize.height * _anchorPoint.y - _offsetPoint.y);
         _realAnchorPointInPoints = Vec2(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y);
         _transformDirty = _inverseDirty = true;
+        setSubtreeBoundingBoxDirty();
     }
 }
 
@@ -378,6 +404,141 @@ void Armature::update(float dt)
     _armatureTransformDirty = false;
 }
 
+void Armature::updateBoneList()
+{
+    if (!_boneListDirty)
+    {
+        return;
+    }
+
+    _boneList.clear();
+    for (const auto &bone : _topBoneList)
+    {
+        _boneList.push_back(bone);
+    }
+
+    // children are appended after their parent, so every bone comes after its ancestors
+    _hasBoneSubclasses = false;
+    for (size_t i = 0; i < _boneList.size(); ++i)
+    {
+        _hasBoneSubclasses = _hasBoneSubclasses || typeid(*_boneList[i]) != typeid(Bone);
+        for (const auto &child : _boneList[i]->getChildren())
+        {
+            _boneList.push_back(static_cast<Bone*>(child));
+        }
+    }
+
+    _boneListDirty = false;
+}
+
+void Armature::updateBoneTransforms(float dt)
+{
+    updateBoneList();
+
+    _deferredDisplayBones.clear();
+
+    for (const auto &bone : _boneList)
+    {
+        bone->updateWorldTransform();
+
+        if (bone->getDisplayRenderNodeType() == CS_DISPLAY_SPRITE)
+        {
+            DisplayFactory::updateDisplay(bone, dt, bone->isTransformDirty() || _armatureTransformDirty);
+        }
+        else if (bone->getDisplayRenderNode())
+        {
+            _deferredDisplayBones.push_back(bone);
+        }
+    }
+}
+
+void Armature::updateBoneDisplays(float dt)
+{
+    for (const auto &bone : _deferredDisplayBones)
+    {
+        DisplayFactory::updateDisplay(bone, dt, bone->isTransformDirty() || _armatureTransformDirty);
+    }
+    _deferredDisplayBones.clear();
+
+    // the callbacks of child armatures may have changed the bones
+    updateBoneList();
+    for (const auto &bone : _boneList)
+    {
+        bone->setTransformDirty(false);
+    }
+
+    _armatureTransformDirty = false;
+}
+
+void Armature::setParallelUpdateEnabled(bool enabled)
+{
+    s_parallelUpdateEnabled = enabled;
+}
+
+bool Armature::isParallelUpdateEnabled()
+{
+    return s_parallelUpdateEnabled;
+}
+
+void Armature::queueParallelUpdate(float dt)
+{
+    // the bones which may override Bone::update() keep it
+    updateBoneList();
+    if (_hasBoneSubclasses)
+    {
+        update(dt);
+        return;
+    }
+
+    if (s_queuedArmatures.empty())
+    {
+        s_queueListener = _eventDispatcher->addCustomEventListener(Director::EVENT_AFTER_UPDATE, [](EventCustom*){
+            Armature::updateQueuedArmatures();
+        });
+    }
+
+    retain();
+    QueuedArmature queued = { this, dt };
+    s_queuedArmatures.push_back(queued);
+}
+
+void Armature::updateQueuedArmatures()
+{
+    // the callbacks of the animations may queue armatures again, they go to the next frame
+    std::vector<QueuedArmature> armatures;
+    armatures.swap(s_queuedArmatures);
+
+    Director::getInstance()->getEventDispatcher()->removeEventListener(s_queueListener);
+    s_queueListener = nullptr;
+
+    for (const auto &queued : armatures)
+    {
+        queued.armature->_animation->update(queued.dt);
+    }
+
+#if ENABLE_PHYSICS_BOX2D_DETECT || ENABLE_PHYSICS_CHIPMUNK_DETECT || ENABLE_PHYSICS_SAVE_CALCULATED_VERTEX
+    // the collider detectors update the shapes of the physics bodies or their saved vertices
+    // from the display transforms, which are computed lazily
+    for (const auto &queued : armatures)
+    {
+        queued.armature->updateBoneTransforms(queued.dt);
+    }
+#else
+    ThreadPool::getInstance()->parallelFor(armatures.size(), 1, [&armatures](ssize_t begin, ssize_t end){
+        for (ssize_t i = begin; i < end; ++i)
+        {
+            armatures[i].armature->updateBoneTransforms(armatures[i].dt);
+        }
+    });
+#endif
+
+    for (const auto &queued : armatures)
+    {
+        queued.armature->updateBoneDisplays(queued.dt);
+        queued.armature->release();
+    }
+}
+
 void Armature::draw(cocos2d::Renderer *renderer, const Mat4 &transform, bool transformUpdated)
 {
     if (_parentBone == nullptr && _batchNode == nullptr)
@@ -401,13 +562,7 @@ void Armature::draw(cocos2d::Renderer *renderer, const Mat4 &transform, bool tra
             {
                 Skin *skin = static_cast<Skin *>(node);
                 skin->updateTransform();
-                
-                bool blendDirty = bone->isBlendDirty();
-                
-                if (blendDirty)
-                {
-                    skin->setBlendFunc(bone->getBlendFunc());
-                }
+                skin->applyBoneBlendFunc();
                 skin->draw(renderer, transform, transformUpdated);
             }
             break;
@@ -435,13 +590,22 @@ void Armature::draw(cocos2d::Renderer *renderer, const Mat4 &transform, bool tra
 void Armature::onEnter()
 {
     Node::onEnter();
-    scheduleUpdate();
+
+    if (s_parallelUpdateEnabled && _parentBone == nullptr)
+    {
+        schedule(schedule_selector(Armature::queueParallelUpdate));
+    }
+    else
+    {
+        scheduleUpdate();
+    }
 }
 
 void Armature::onExit()
 {
     Node::onExit();
     unscheduleUpdate();
+    unschedule(schedule_selector(Armature::queueParallelUpdate));
 }
 
 
@@ -476,6 +640,28 @@ void Armature::visit(cocos2d::Renderer *renderer, const Mat4 &parentTransform, b
     director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
 }
 
+bool Armature::visitBatched(const Mat4 &parentTransform, bool parentTransformUpdated, const std::function<bool()>& gather)
+{
+    bool dirty = parentTransformUpdated || _transformUpdated;
+    if(dirty)
+        _modelViewTransform = transform(parentTransform);
+    _transformUpdated = false;
+
+    Director* director = Director::getInstance();
+    director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+
+    sortAllChildren();
+    bool gathered = gather();
+
+    // reset for next frame
+    _orderOfArrival = 0;
+
+    director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+
+    return gathered;
+}
+
 Rect Armature::getBoundingBox() const
 {
     float minx, miny, maxx, maxy = 0;
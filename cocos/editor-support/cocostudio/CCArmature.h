@@ -159,6 +159,17 @@ public:
      */
     virtual void visit(cocos2d::Renderer *renderer, const cocos2d::Mat4 &parentTransform, bool parentTransformUpdated) override;
     virtual void draw(cocos2d::Renderer *renderer, const cocos2d::Mat4 &transform, bool transformUpdated) override;
+    /**
+     * Called by BatchNode instead of visit() when it draws the skins of the armature itself. It does what visit()
+     * does besides drawing, and calls gather with the armature's model view transform on the matrix stack.
+     * Returns the result of gather.
+     * @js NA
+     * @lua NA
+     */
+    bool visitBatched(const cocos2d::Mat4 &parentTransform, bool parentTransformUpdated, const std::function<bool()>& gather);
+    /**
+     * Updates the animation, then the bones through their update(), from the top bones down.
+     */
     virtual void update(float dt) override;
 
     virtual void onEnter() override;
@@ -189,6 +200,24 @@ public:
     
     virtual bool getArmatureTransformDirty() const;
 
+    /**
+     * Makes the bone list be rebuilt before the next update, it is called when the bone hierarchy changes.
+     */
+    void setBoneListDirty() { _boneListDirty = true; }
+
+    /**
+     * When enabled, the armatures entering the stage afterwards are updated together after the scheduler update:
+     * the animations and their events are updated on the cocos thread, then the bone transforms of all the armatures
+     * are computed in parallel on the ThreadPool, then the particle and child armature displays are updated on the
+     * cocos thread. The armatures used as displays of a bone are updated by their parent armature.
+     * The parallel update computes the bones itself instead of calling Bone::update(), so the armatures whose bones
+     * are subclasses of Bone are updated by update() as usual.
+     * Disabled by default. Always serial when the Box2D or Chipmunk detection or ENABLE_PHYSICS_SAVE_CALCULATED_VERTEX
+     * is enabled, since the collider detectors are updated with the display transforms.
+     */
+    static void setParallelUpdateEnabled(bool enabled);
+    static bool isParallelUpdateEnabled();
+
 
 #if ENABLE_PHYSICS_BOX2D_DETECT || ENABLE_PHYSICS_CHIPMUNK_DETECT
     virtual void setColliderFilter(ColliderFilter *filter);
@@ -252,6 +281,20 @@ protected:
      */
     Bone *createBone(const std::string& boneName );
 
+    //! Rebuilds _boneList from _topBoneList when it is dirty
+    void updateBoneList();
+    /*
+     * Computes the transforms of the bones and of their sprite displays, which only touches the armature,
+     * so that armatures can be updated on worker threads. The other displays are left to updateBoneDisplays().
+     */
+    void updateBoneTransforms(float dt);
+    //! Updates the displays left by updateBoneTransforms() and clears the dirty flags, on the cocos thread
+    void updateBoneDisplays(float dt);
+
+    //! Scheduled instead of update() when the parallel update is enabled
+    void queueParallelUpdate(float dt);
+    static void updateQueuedArmatures();
+
 protected:
     ArmatureData *_armatureData;
 
@@ -267,6 +310,11 @@ protected:
 
     cocos2d::Vector<Bone*> _topBoneList;
 
+    std::vector<Bone*> _boneList;                   //! All the bones reachable from _topBoneList, parents before their children
+    bool _boneListDirty;
+    bool _hasBoneSubclasses;                        //! Some bones of _boneList are subclasses of Bone, set by updateBoneList()
+    std::vector<Bone*> _deferredDisplayBones;       //! The bones whose display is updated by updateBoneDisplays()
+
     cocos2d::BlendFunc _blendFunc;                    //! It's required for CCTextureProtocol inheritance
 
     cocos2d::Vec2 _offsetPoint;
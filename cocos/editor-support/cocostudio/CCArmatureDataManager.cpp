@@ -23,6 +23,9 @@ THE SOFTWARE.
 ****************************************************************************/
 
 #include "2d/CCSpriteFrameCache.h"
+#include "2d/CCResourceLoader.h"
+#include "2d/platform/CCFileUtils.h"
+#include "json/document.h"
 
 #include "cocostudio/CCArmatureDataManager.h"
 #include "cocostudio/CCTransformHelp.h"
@@ -35,6 +38,74 @@ namespace cocostudio {
 
 static ArmatureDataManager *s_sharedArmatureDataManager = nullptr;
 
+// calls done when the armature file added by addArmatureFileInfoAsync() is loaded
+class ArmatureLoadedTarget : public Ref
+{
+public:
+    explicit ArmatureLoadedTarget(const std::function<void(bool)>& done) : _done(done) {}
+
+    void onLoaded(float percent)
+    {
+        _done(true);
+        release();
+    }
+
+private:
+    std::function<void(bool)> _done;
+};
+
+// the "armature" assets of ResourceLoader: the sprite sheets of the json files are loaded with the other assets,
+// then the file is decoded by DataReaderHelper on its own loading thread
+class ArmatureAssetHandler : public ResourceLoader::AssetHandler
+{
+public:
+    virtual bool load(ResourceLoader::Asset& asset) override
+    {
+        std::string content = FileUtils::getInstance()->getStringFromFile(asset.fullPath);
+        if (content.empty())
+        {
+            return false;
+        }
+        if (DataReaderHelper::isBinaryContent(content) || content[0] == '<')
+        {
+            // the xml and binary files are decoded with their sprite sheets
+            return true;
+        }
+
+        rapidjson::Document json;
+        json.Parse<0>(content.c_str());
+        if (json.HasParseError() || !json.IsObject())
+        {
+            return false;
+        }
+
+        // same paths as DataReaderHelper, relative to the file as it was added
+        size_t pos = asset.file.find_last_of("/");
+        std::string basePath = pos == std::string::npos ? "" : asset.file.substr(0, pos + 1);
+        if (json.HasMember("config_file_path") && json["config_file_path"].IsArray())
+        {
+            const rapidjson::Value& paths = json["config_file_path"];
+            for (rapidjson::SizeType i = 0; i < paths.Size(); ++i)
+            {
+                if (!paths[i].IsString())
+                {
+                    continue;
+                }
+                std::string path = paths[i].GetString();
+                path = path.substr(0, path.find_last_of("."));
+                asset.dependencies.push_back(std::make_pair(std::string("spriteframes"), basePath + path + ".plist"));
+            }
+        }
+        return true;
+    }
+
+    virtual void finish(ResourceLoader::Asset& asset, const std::function<void(bool)>& done) override
+    {
+        auto target = new ArmatureLoadedTarget(done);
+        ArmatureDataManager::getInstance()->addArmatureFileInfoAsync(asset.file, target, schedule_selector(ArmatureLoadedTarget::onLoaded));
+    }
+};
+
 ArmatureDataManager *ArmatureDataManager::getInstance()
 {
     if (s_sharedArmatureDataManager == nullptr)
@@ -83,6 +154,8 @@ bool ArmatureDataManager::init()
         _animationDatas.clear();
         _textureDatas.clear();
 
+        ResourceLoader::registerHandler("armature", new ArmatureAssetHandler());
+
         bRet = true;
     }
     while (0);
@@ -228,6 +301,11 @@ void ArmatureDataManager::addSpriteFrameFromFile(const std::string& plistPath, c
     {
         data->plistFiles.push_back(plistPath);
     }
+    // e.g. preloaded by ResourceLoader
+    if (SpriteFrameCache::getInstance()->isSpriteFramesFileLoaded(plistPath))
+    {
+        return;
+    }
     SpriteFrameCacheHelper::getInstance()->addSpriteFrameFromFile(plistPath, imagePath);
 }
 
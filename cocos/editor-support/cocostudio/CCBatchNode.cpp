@@ -28,10 +28,14 @@ THE SOFTWARE.
 #include "cocostudio/CCSkin.h"
 
 #include "renderer/CCRenderer.h"
-#include "renderer/CCGroupCommand.h"
+#include "renderer/CCQuadCommand.h"
+#include "renderer/CCRenderCommandPool.h"
 #include "renderer/CCGLProgramState.h"
+#include "2d/CCTexture2D.h"
 #include "base/CCDirector.h"
 
+#include <memory>
+
 using namespace cocos2d;
 
 namespace cocostudio {
@@ -49,13 +53,11 @@ BatchNode *BatchNode::create()
 }
 
 BatchNode::BatchNode()
-: _groupCommand(nullptr)
 {
 }
 
 BatchNode::~BatchNode()
 {
-    CC_SAFE_DELETE(_groupCommand);
 }
 
 bool BatchNode::init()
@@ -83,10 +85,6 @@ void BatchNode::addChild(Node *child, int zOrder, int tag)
     if (armature != nullptr)
     {
         armature->setBatchNode(this);
-        if (_groupCommand == nullptr)
-        {
-            _groupCommand = new GroupCommand();
-        }
     }
 }
 
@@ -138,39 +136,133 @@ void BatchNode::draw(Renderer *renderer, const Mat4 &transform, bool transformUp
         return;
     }
 
-//    CC_NODE_DRAW_SETUP();
+    _quads.clear();
+    _runs.clear();
 
-    bool pushed = false;
     for(auto object : _children)
     {
         Armature *armature = dynamic_cast<Armature *>(object);
-        if (armature)
+        if (armature && armature->isVisible())
         {
-            if (!pushed)
+            size_t quadCount = _quads.size();
+            size_t runCount = _runs.size();
+            ssize_t lastRunQuadCount = _runs.empty() ? 0 : _runs.back().quadCount;
+
+            bool gathered = armature->visitBatched(transform, transformUpdated, [this, armature]() {
+                return gatherArmatureQuads(armature, armature->getNodeToParentTransform());
+            });
+            if (gathered)
             {
-                generateGroupCommand();
-                pushed = true;
+                continue;
+            }
+
+            // drop what was gathered, the armature draws itself
+            _quads.resize(quadCount);
+            _runs.resize(runCount);
+            if (!_runs.empty())
+            {
+                _runs.back().quadCount = lastRunQuadCount;
             }
-        
-            armature->visit(renderer, transform, transformUpdated);
         }
-        else
+
+        QuadRun run = { 0, nullptr, BlendFunc::DISABLE, 0, 0, object };
+        _runs.push_back(run);
+    }
+
+    // the commands are rendered after this draw, the quads they point to are kept in the frame arena
+    RenderFrameArena &arena = renderer->getFrameArena();
+    V3F_C4B_T2F_Quad *quads = nullptr;
+    if (!_quads.empty())
+    {
+        quads = static_cast<V3F_C4B_T2F_Quad *>(arena.allocate(sizeof(V3F_C4B_T2F_Quad) * _quads.size(), alignof(V3F_C4B_T2F_Quad)));
+        std::uninitialized_copy(_quads.begin(), _quads.end(), quads);
+    }
+
+    for (const auto &run : _runs)
+    {
+        if (run.node)
         {
-            renderer->popGroup();
-            pushed = false;
-            
-            ((Node *)object)->visit(renderer, transform, transformUpdated);
+            run.node->visit(renderer, transform, transformUpdated);
+            continue;
         }
+
+        QuadCommand *command = arena.create<QuadCommand>();
+        command->init(_globalZOrder, run.textureID, run.glProgramState, run.blendFunc, quads + run.firstQuad, run.quadCount, transform);
+        renderer->addCommand(command);
     }
 }
 
-void BatchNode::generateGroupCommand()
+bool BatchNode::gatherArmatureQuads(Armature *armature, const Mat4 &toBatch)
 {
-    Renderer* renderer = Director::getInstance()->getRenderer();
-    _groupCommand->init(_globalZOrder);
-    renderer->addCommand(_groupCommand);
+    for (auto object : armature->getChildren())
+    {
+        Bone *bone = dynamic_cast<Bone *>(object);
+        if (!bone)
+        {
+            return false;
+        }
+
+        Node *node = bone->getDisplayRenderNode();
+        if (nullptr == node)
+        {
+            continue;
+        }
+
+        switch (bone->getDisplayRenderNodeType())
+        {
+        case CS_DISPLAY_SPRITE:
+        {
+            Skin *skin = static_cast<Skin *>(node);
+            if (!skin->isVisible() || !skin->getTexture())
+            {
+                break;
+            }
+
+            // the same steps as Armature::draw(), the quad is in the space of the armature
+            skin->updateTransform();
+            skin->applyBoneBlendFunc();
+
+            V3F_C4B_T2F_Quad quad = skin->getQuad();
+            toBatch.transformPoint(&quad.bl.vertices);
+            toBatch.transformPoint(&quad.br.vertices);
+            toBatch.transformPoint(&quad.tl.vertices);
+            toBatch.transformPoint(&quad.tr.vertices);
+
+            GLuint textureID = skin->getTexture()->getName();
+            GLProgramState *glProgramState = skin->getGLProgramState();
+            const BlendFunc &blendFunc = skin->getBlendFunc();
+
+            // a single command must fit in the vertex buffer of the renderer
+            QuadRun *last = _runs.empty() ? nullptr : &_runs.back();
+            if (last && !last->node && last->textureID == textureID && last->glProgramState == glProgramState
+                && last->blendFunc.src == blendFunc.src && last->blendFunc.dst == blendFunc.dst
+                && last->quadCount < Renderer::VBO_SIZE - 1)
+            {
+                last->quadCount++;
+            }
+            else
+            {
+                QuadRun run = { textureID, glProgramState, blendFunc, (ssize_t)_quads.size(), 1, nullptr };
+                _runs.push_back(run);
+            }
+            _quads.push_back(quad);
+        }
+        break;
+        case CS_DISPLAY_ARMATURE:
+        {
+            // the skins of the nested armatures are in the space of the root armature too
+            if (!gatherArmatureQuads(static_cast<Armature *>(node), toBatch))
+            {
+                return false;
+            }
+        }
+        break;
+        default:
+            return false;
+        }
+    }
 
-    renderer->pushGroup(_groupCommand->getRenderQueueID());
+    return true;
 }
 
 }
@@ -26,14 +26,20 @@ THE SOFTWARE.
 #define __CCBATCHNODE_H__
 
 #include "2d/CCNode.h"
+#include "renderer/CCGLProgramState.h"
 #include "cocostudio/CCArmatureDefine.h"
 
-namespace cocos2d {
-    class GroupCommand;
-}
-
 namespace cocostudio {
 
+class Armature;
+
+/**
+ * Draws the skins of all the armatures it contains as one stream of quads. Consecutive skins that share
+ * a texture, a program and a blend function are drawn by one QuadCommand, whatever armature they belong to,
+ * so a crowd of armatures using one sprite sheet costs a few draw calls. The drawing order is kept.
+ * Armatures showing other displays than sprites and armatures (particles...), and the other children,
+ * are visited as usual between the batched quads.
+ */
 class BatchNode : public cocos2d::Node
 {
 public:
@@ -60,9 +66,26 @@ public:
     virtual void draw(cocos2d::Renderer *renderer, const cocos2d::Mat4 &transform, bool transformUpdated) override;
     
 protected:
-    void generateGroupCommand();
+    struct QuadRun
+    {
+        GLuint textureID;
+        cocos2d::GLProgramState *glProgramState;
+        cocos2d::BlendFunc blendFunc;
+        ssize_t firstQuad;
+        ssize_t quadCount;
+        // the child visited at this place of the stream when not nullptr
+        cocos2d::Node *node;
+    };
+
+    /*
+     * Appends the quads of the skins of the armature, transformed by toBatch into the space of the batch node.
+     * Returns false when the armature has a display that can't be batched.
+     */
+    bool gatherArmatureQuads(Armature *armature, const cocos2d::Mat4 &toBatch);
 
-    cocos2d::GroupCommand* _groupCommand;
+    // the quads and the runs of the last draw, kept to reuse their storage
+    std::vector<cocos2d::V3F_C4B_T2F_Quad> _quads;
+    std::vector<QuadRun> _runs;
 };
 
 }
@@ -76,10 +76,15 @@ Bone::Bone()
     _boneTransformDirty = true;
     _blendFunc = BlendFunc::ALPHA_NON_PREMULTIPLIED;
     _blendDirty = false;
+    _defaultBlendFunc = true;
     _worldInfo = nullptr;
 
     _armatureParentBone = nullptr;
     _dataVersion = 0;
+
+    _cachedSkewX = _cachedSkewY = 0;
+    _sinSkewX = _sinSkewY = 0;
+    _cosSkewX = _cosSkewY = 1;
 }
 
 
@@ -177,6 +182,20 @@ Armature *Bone::getArmature() const
 }
 
 void Bone::update(float delta)
+{
+    updateWorldTransform();
+
+    DisplayFactory::updateDisplay(this, delta, _boneTransformDirty || _armature->getArmatureTransformDirty());
+
+    for(const auto &obj: _children) {
+        Bone *childBone = static_cast<Bone*>(obj);
+        childBone->update(delta);
+    }
+
+    _boneTransformDirty = false;
+}
+
+void Bone::updateWorldTransform()
 {
     if (_parentBone)
         _boneTransformDirty = _boneTransformDirty || _parentBone->isTransformDirty();
@@ -186,52 +205,62 @@ void Bone::update(float delta)
         _boneTransformDirty = _armatureParentBone->isTransformDirty();
     }
 
-    if (_boneTransformDirty)
+    if (!_boneTransformDirty)
     {
-        if (_dataVersion >= VERSION_COMBINED)
-        {
-            TransformHelp::nodeConcat(*_tweenData, *_boneData);
-            _tweenData->scaleX -= 1;
-            _tweenData->scaleY -= 1;
-        }
-
-        _worldInfo->copy(_tweenData);
+        return;
+    }
 
-        _worldInfo->x = _tweenData->x + _position.x;
-        _worldInfo->y = _tweenData->y + _position.y;
-        _worldInfo->scaleX = _tweenData->scaleX * _scaleX;
-        _worldInfo->scaleY = _tweenData->scaleY * _scaleY;
-        _worldInfo->skewX = _tweenData->skewX + _skewX + _rotationX;
-        _worldInfo->skewY = _tweenData->skewY + _skewY - _rotationY;
+    if (_dataVersion >= VERSION_COMBINED)
+    {
+        TransformHelp::nodeConcat(*_tweenData, *_boneData);
+        _tweenData->scaleX -= 1;
+        _tweenData->scaleY -= 1;
+    }
 
-        if(_parentBone)
-        {
-            applyParentTransform(_parentBone);
-        }
-        else
-        {
-            if (_armatureParentBone)
-            {
-                applyParentTransform(_armatureParentBone);
-            }
-        }
+    _worldInfo->copy(_tweenData);
 
-        TransformHelp::nodeToMatrix(*_worldInfo, _worldTransform);
+    _worldInfo->x = _tweenData->x + _position.x;
+    _worldInfo->y = _tweenData->y + _position.y;
+    _worldInfo->scaleX = _tweenData->scaleX * _scaleX;
+    _worldInfo->scaleY = _tweenData->scaleY * _scaleY;
+    _worldInfo->skewX = _tweenData->skewX + _skewX + _rotationX;
+    _worldInfo->skewY = _tweenData->skewY + _skewY - _rotationY;
 
+    if(_parentBone)
+    {
+        applyParentTransform(_parentBone);
+    }
+    else
+    {
         if (_armatureParentBone)
         {
-            _worldTransform = TransformConcat(_worldTransform, _armature->getNodeToParentTransform());
+            applyParentTransform(_armatureParentBone);
         }
     }
 
-    DisplayFactory::updateDisplay(this, delta, _boneTransformDirty || _armature->getArmatureTransformDirty());
-
-    for(const auto &obj: _children) {
-        Bone *childBone = static_cast<Bone*>(obj);
-        childBone->update(delta);
+    // same matrix as TransformHelp::nodeToMatrix(), most bones keep their skews between two frames
+    if (_worldInfo->skewX != _cachedSkewX || _worldInfo->skewY != _cachedSkewY)
+    {
+        _cachedSkewX = _worldInfo->skewX;
+        _cachedSkewY = _worldInfo->skewY;
+        _sinSkewX = sinf(_cachedSkewX);
+        _cosSkewX = cosf(_cachedSkewX);
+        _sinSkewY = sinf(_cachedSkewY);
+        _cosSkewY = cosf(_cachedSkewY);
     }
 
-    _boneTransformDirty = false;
+    _worldTransform = Mat4::IDENTITY;
+    _worldTransform.m[0] = _worldInfo->scaleX * _cosSkewY;
+    _worldTransform.m[1] = _worldInfo->scaleX * _sinSkewY;
+    _worldTransform.m[4] = _worldInfo->scaleY * _sinSkewX;
+    _worldTransform.m[5] = _worldInfo->scaleY * _cosSkewX;
+    _worldTransform.m[12] = _worldInfo->x;
+    _worldTransform.m[13] = _worldInfo->y;
+
+    if (_armatureParentBone)
+    {
+        _worldTransform = TransformConcat(_worldTransform, _armature->getNodeToParentTransform());
+    }
 }
 
 void Bone::applyParentTransform(Bone *parent) 
@@ -249,9 +278,20 @@ void Bone::applyParentTransform(Bone *parent)
 
 void Bone::setBlendFunc(const BlendFunc& blendFunc)
 {
-    if (_blendFunc.src != blendFunc.src || _blendFunc.dst != blendFunc.dst)
+    if (_blendFunc.src != blendFunc.src || _blendFunc.dst != blendFunc.dst || _defaultBlendFunc)
     {
         _blendFunc = blendFunc;
+        _defaultBlendFunc = false;
+        _blendDirty = true;
+    }
+}
+
+void Bone::resetBlendFunc()
+{
+    if (!_defaultBlendFunc)
+    {
+        _blendFunc = BlendFunc::ALPHA_NON_PREMULTIPLIED;
+        _defaultBlendFunc = true;
         _blendDirty = true;
     }
 }
@@ -305,6 +345,11 @@ void Bone::addChildBone(Bone *child)
     {
         _children.pushBack(child);
         child->setParentBone(this);
+
+        if (_armature)
+        {
+            _armature->setBoneListDirty();
+        }
     }
 }
 
@@ -328,6 +373,11 @@ void Bone::removeChildBone(Bone *bone, bool recursion)
         bone->getDisplayManager()->setCurrentDecorativeDisplay(nullptr);
 
         _children.eraseObject(bone);
+
+        if (_armature)
+        {
+            _armature->setBoneListDirty();
+        }
     }
 }
 
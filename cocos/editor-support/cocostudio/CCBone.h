@@ -135,6 +135,12 @@ public:
 
     void update(float delta) override;
 
+    /**
+     * Updates the transform of this bone only, its display and its child bones are not updated.
+     * The parent bone must be up to date, Armature calls it on its bones in topological order.
+     */
+    void updateWorldTransform();
+
     void updateDisplayedColor(const cocos2d::Color3B &parentColor) override;
     void updateDisplayedOpacity(GLubyte parentOpacity) override;
 
@@ -199,6 +205,14 @@ public:
     virtual void setBlendFunc(const cocos2d::BlendFunc& blendFunc);
     virtual cocos2d::BlendFunc getBlendFunc(void) { return _blendFunc; }
 
+    /*
+     * Go back to the normal blending of the animation data, ALPHA_NON_PREMULTIPLIED, which the skins
+     * draw with the blend function of their texture. It is the blending of a new bone.
+     */
+    virtual void resetBlendFunc();
+    //! Whether the blend function is the default one, not set with setBlendFunc() since the bone was created or reset
+    virtual bool isDefaultBlendFunc() const { return _defaultBlendFunc; }
+
     /*
      * Set if blend function is dirty 
      */
@@ -236,6 +250,7 @@ protected:
 
     cocos2d::BlendFunc _blendFunc;
     bool _blendDirty;
+    bool _defaultBlendFunc;
 
     Tween *_tween;				//! Calculate tween effect
 
@@ -257,6 +272,12 @@ protected:
     
     //! Data version
     float _dataVersion;
+
+    //! The world skews of the last transform and their sines and cosines, which are reused while the skews don't change
+    float _cachedSkewX;
+    float _cachedSkewY;
+    float _sinSkewX, _cosSkewX;
+    float _sinSkewY, _cosSkewY;
 };
 
 }
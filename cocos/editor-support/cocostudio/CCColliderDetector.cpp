@@ -332,8 +332,6 @@ ColliderFilter *ColliderDetector::getColliderFilter()
 #endif
 
 
-Vec2 helpPoint;
-
 void ColliderDetector::updateTransform(Mat4 &t)
 {
     if (!_active)
@@ -369,8 +367,7 @@ void ColliderDetector::updateTransform(Mat4 &t)
 
         for (unsigned long i = 0; i < num; i++)
         {
-            helpPoint.setPoint( vs.at(i).x,  vs.at(i).y);
-            helpPoint = PointApplyTransform(helpPoint, t);
+            Vec2 helpPoint = PointApplyTransform(vs.at(i), t);
 
 
 #if ENABLE_PHYSICS_SAVE_CALCULATED_VERTEX
@@ -25,6 +25,7 @@ THE SOFTWARE.
 #include "2d/platform/CCFileUtils.h"
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
+#include "base/CCThreadPool.h"
 
 #include "tinyxml2.h"
 
@@ -35,6 +36,9 @@ THE SOFTWARE.
 #include "cocostudio/CCArmatureDefine.h"
 #include "cocostudio/CCDatas.h"
 
+#include <algorithm>
+#include <chrono>
+
 using namespace cocos2d;
 
 
@@ -149,62 +153,84 @@ DataReaderHelper *DataReaderHelper::_dataReaderHelper = nullptr;
 
 
 //! Async load
-void DataReaderHelper::loadData()
+void DataReaderHelper::loadData(AsyncStruct *asyncStruct)
 {
-    AsyncStruct *pAsyncStruct = nullptr;
+    auto start = std::chrono::steady_clock::now();
+
+    // fullPath was resolved on the main thread, FileUtils doesn't search it again
+    std::string fileContent = FileUtils::getInstance()->getStringFromFile(asyncStruct->fullPath);
+
+    // generate data info
+    DataInfo *dataInfo = new DataInfo();
+    dataInfo->asyncStruct = asyncStruct;
+    dataInfo->filename = asyncStruct->filename;
+    dataInfo->baseFilePath = asyncStruct->baseFilePath;
 
-    while (true)
+    if (isBinaryContent(fileContent))
     {
-        std::queue<AsyncStruct *> *pQueue = _asyncStructQueue;
-        _asyncStructQueueMutex.lock(); // get async struct from queue
-        if (pQueue->empty())
-        {
-            _asyncStructQueueMutex.unlock();
-            if (need_quit)
-            {
-                break;
-            }
-            else
-            {
-				std::unique_lock<std::mutex> lk(_sleepMutex);
-				_sleepCondition.wait(lk);
-                continue;
-            }
-        }
-        else
-        {
-            pAsyncStruct = pQueue->front();
-            pQueue->pop();
-            _asyncStructQueueMutex.unlock();
-        }
+        asyncStruct->configType = CocoStudio_Binary;
+    }
+    addDataFromContent(fileContent, asyncStruct->configType, dataInfo);
 
-        // generate data info
-        DataInfo *pDataInfo = new DataInfo();
-        pDataInfo->asyncStruct = pAsyncStruct;
-        pDataInfo->filename = pAsyncStruct->filename;
-        pDataInfo->baseFilePath = pAsyncStruct->baseFilePath;
+    dataInfo->loadTime = std::chrono::duration_cast<std::chrono::duration<float>>(std::chrono::steady_clock::now() - start).count();
 
-        if (pAsyncStruct->configType == DragonBone_XML)
-        {
-            DataReaderHelper::addDataFromCache(pAsyncStruct->fileContent.c_str(), pDataInfo);
-        }
-        else if(pAsyncStruct->configType == CocoStudio_JSON)
-        {
-            DataReaderHelper::addDataFromJsonCache(pAsyncStruct->fileContent.c_str(), pDataInfo);
-        }
+    // put the data info into the queue
+    std::lock_guard<std::mutex> lock(_dataInfoMutex);
+    _dataQueue.push(dataInfo);
+    --_loadingTasks;
+    _loadingCondition.notify_all();
+}
 
-        // put the image info into the queue
-        _dataInfoMutex.lock();
-        _dataQueue->push(pDataInfo);
-        _dataInfoMutex.unlock();
+void DataReaderHelper::addDataFromContent(const std::string& fileContent, ConfigType configType, DataInfo *dataInfo)
+{
+    if (isBinaryContent(fileContent))
+    {
+        DataReaderHelper::addDataFromBinaryCache(fileContent, dataInfo);
+    }
+    else if (configType == DragonBone_XML)
+    {
+        DataReaderHelper::addDataFromCache(fileContent, dataInfo);
+    }
+    else if(configType == CocoStudio_JSON)
+    {
+        DataReaderHelper::addDataFromJsonCache(fileContent, dataInfo);
+    }
+}
+
+void DataReaderHelper::addDecodedData(DataInfo *dataInfo, const std::string& configFilePath)
+{
+    ArmatureDataManager *manager = ArmatureDataManager::getInstance();
+
+    // loading tasks look armatures up while decoding xml animations
+    std::lock_guard<std::mutex> lock(_dataReaderHelper->_addDataMutex);
+    for (auto& armatureData : dataInfo->armatureDatas)
+    {
+        manager->addArmatureData(armatureData->name, armatureData, configFilePath);
+    }
+    for (auto& animationData : dataInfo->animationDatas)
+    {
+        manager->addAnimationData(animationData->name, animationData, configFilePath);
+    }
+    for (auto& textureData : dataInfo->textureDatas)
+    {
+        manager->addTextureData(textureData->name, textureData, configFilePath);
     }
 
-    if( _asyncStructQueue != nullptr )
+    dataInfo->armatureDatas.clear();
+    dataInfo->animationDatas.clear();
+    dataInfo->textureDatas.clear();
+}
+
+void DataReaderHelper::fileLoaded(const std::string& filePath, float progress, float loadTime, bool async)
+{
+    if (_fileLoadedCallback)
     {
-        delete _asyncStructQueue;
-        _asyncStructQueue = nullptr;
-        delete _dataQueue;
-        _dataQueue = nullptr;
+        FileLoadInfo info;
+        info.filePath = filePath;
+        info.progress = progress;
+        info.loadTime = loadTime;
+        info.async = async;
+        _fileLoadedCallback(info);
     }
 }
 
@@ -238,24 +264,37 @@ void DataReaderHelper::purge()
 
 
 DataReaderHelper::DataReaderHelper()
-	: _loadingThread(nullptr)
+	: _loadingTasks(0)
 	, _asyncRefCount(0)
 	, _asyncRefTotalCount(0)
-	, need_quit(false)
-	, _asyncStructQueue(nullptr)
-	, _dataQueue(nullptr)
 {
 
 }
 
 DataReaderHelper::~DataReaderHelper()
 {
-    need_quit = true;
+    // the loading tasks still queued in the ThreadPool use this instance
+    std::unique_lock<std::mutex> lock(_dataInfoMutex);
+    _loadingCondition.wait(lock, [this]{ return _loadingTasks == 0; });
+
+    while (!_dataQueue.empty())
+    {
+        DataInfo *dataInfo = _dataQueue.front();
+        _dataQueue.pop();
+        CC_SAFE_RELEASE(dataInfo->asyncStruct->target);
+        delete dataInfo->asyncStruct;
+        delete dataInfo;
+    }
+    lock.unlock();
 
-	_sleepCondition.notify_one();
-	if (_loadingThread) _loadingThread->join();
+    for (auto dataInfo : _deferredDataInfos)
+    {
+        CC_SAFE_RELEASE(dataInfo->asyncStruct->target);
+        delete dataInfo->asyncStruct;
+        delete dataInfo;
+    }
+    _deferredDataInfos.clear();
 
-	CC_SAFE_DELETE(_loadingThread);
 	_dataReaderHelper = nullptr;
 }
 
@@ -292,6 +331,8 @@ void DataReaderHelper::addDataFromFile(const std::string& filePath)
     size_t startPos = filePathStr.find_last_of(".");
     std::string str = &filePathStr[startPos];
 
+    auto start = std::chrono::steady_clock::now();
+
     // Read content from file
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(filePath);
     std::string contentStr = FileUtils::getInstance()->getStringFromFile(fullPath);
@@ -302,12 +343,18 @@ void DataReaderHelper::addDataFromFile(const std::string& filePath)
     dataInfo.baseFilePath = basefilePath;
     if (str == ".xml")
     {
-        DataReaderHelper::addDataFromCache(contentStr, &dataInfo);
+        DataReaderHelper::addDataFromContent(contentStr, DragonBone_XML, &dataInfo);
     }
     else if(str == ".json" || str == ".ExportJson")
     {
-        DataReaderHelper::addDataFromJsonCache(contentStr, &dataInfo);
+        DataReaderHelper::addDataFromContent(contentStr, CocoStudio_JSON, &dataInfo);
     }
+    else
+    {
+        DataReaderHelper::addDataFromContent(contentStr, CocoStudio_Binary, &dataInfo);
+    }
+
+    fileLoaded(filePath, 1, std::chrono::duration_cast<std::chrono::duration<float>>(std::chrono::steady_clock::now() - start).count(), false);
 }
 
 void DataReaderHelper::addDataFromFileAsync(const std::string& imagePath, const std::string& plistPath, const std::string& filePath, Ref *target, SEL_SCHEDULE selector)
@@ -349,18 +396,6 @@ void DataReaderHelper::addDataFromFileAsync(const std::string& imagePath, const
     }
 
 
-    // lazy init
-    if (_asyncStructQueue == nullptr)
-    {
-        _asyncStructQueue = new std::queue<AsyncStruct *>();
-        _dataQueue = new std::queue<DataInfo *>();
-
-		// create a new thread to load images
-		_loadingThread = new std::thread(&DataReaderHelper::loadData, this);
-
-        need_quit = false;
-    }
-
     if (0 == _asyncRefCount)
     {
         Director::getInstance()->getScheduler()->schedule(schedule_selector(DataReaderHelper::addDataAsyncCallBack), this, 0, false);
@@ -389,10 +424,8 @@ void DataReaderHelper::addDataFromFileAsync(const std::string& imagePath, const
     size_t startPos = filePathStr.find_last_of(".");
     std::string str = &filePathStr[startPos];
 
-    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(filePath);
-
-    // XXX fileContent is being leaked
-    data->fileContent = FileUtils::getInstance()->getStringFromFile(fullPath);
+    // the search paths of FileUtils are not thread safe, the file is read by the loading task
+    data->fullPath = FileUtils::getInstance()->fullPathForFilename(filePath);
 
     if (str == ".xml")
     {
@@ -402,72 +435,148 @@ void DataReaderHelper::addDataFromFileAsync(const std::string& imagePath, const
     {
         data->configType = CocoStudio_JSON;
     }
+    else
+    {
+        data->configType = CocoStudio_Binary;
+    }
 
+    // every file is decoded by its own task, so several files are parsed in parallel
+    _dataInfoMutex.lock();
+    ++_loadingTasks;
+    _dataInfoMutex.unlock();
 
-    // add async struct into queue
-    _asyncStructQueueMutex.lock();
-    _asyncStructQueue->push(data);
-    _asyncStructQueueMutex.unlock();
-
-    _sleepCondition.notify_one();
+    ThreadPool::getInstance()->enqueue(std::bind(&DataReaderHelper::loadData, this, data));
 }
 
 void DataReaderHelper::addDataAsyncCallBack(float dt)
 {
-    // the data is generated in loading thread
-    std::queue<DataInfo *> *dataQueue = _dataQueue;
-
+    // the data is generated by the loading tasks, one file is added per frame
+    // so that loading the sprite frames of several files doesn't stall a single frame
+    DataInfo *pDataInfo = nullptr;
     _dataInfoMutex.lock();
-    if (dataQueue->empty())
+    if (!_dataQueue.empty())
     {
-        _dataInfoMutex.unlock();
+        pDataInfo = _dataQueue.front();
+        _dataQueue.pop();
     }
-    else
-    {
-        DataInfo *pDataInfo = dataQueue->front();
-        dataQueue->pop();
-        _dataInfoMutex.unlock();
-
-        AsyncStruct *pAsyncStruct = pDataInfo->asyncStruct;
+    bool loading = _loadingTasks > 0 || !_dataQueue.empty();
+    _dataInfoMutex.unlock();
 
+    if (pDataInfo)
+    {
+        // json files don't record their config file path, like when they are loaded synchronously
+        DataReaderHelper::addDecodedData(pDataInfo, pDataInfo->asyncStruct->configType == CocoStudio_JSON ? "" : pDataInfo->filename);
 
-        if (pAsyncStruct->imagePath != "" && pAsyncStruct->plistPath != "")
+        if (!pDataInfo->deferredAnimations.empty())
         {
-            _getFileMutex.lock();
-            ArmatureDataManager::getInstance()->addSpriteFrameFromFile(pAsyncStruct->plistPath.c_str(), pAsyncStruct->imagePath.c_str());
-            _getFileMutex.unlock();
+            _deferredDataInfos.push_back(pDataInfo);
+            pDataInfo = nullptr;
         }
+    }
 
-        while (!pDataInfo->configFileQueue.empty())
+    // the armatures just added may be the ones of the deferred animations. Once no file is left
+    // to add, the armatures still missing won't come.
+    bool lastChance = !pDataInfo && !loading;
+    for (size_t i = 0; i < _deferredDataInfos.size(); )
+    {
+        DataInfo *deferredInfo = _deferredDataInfos[i];
+        if (DataReaderHelper::addDeferredAnimations(deferredInfo, lastChance))
         {
-            std::string configPath = pDataInfo->configFileQueue.front();
-            _getFileMutex.lock();
-            ArmatureDataManager::getInstance()->addSpriteFrameFromFile((pAsyncStruct->baseFilePath + configPath + ".plist").c_str(), (pAsyncStruct->baseFilePath + configPath + ".png").c_str());
-            _getFileMutex.unlock();
-            pDataInfo->configFileQueue.pop();
+            _deferredDataInfos.erase(_deferredDataInfos.begin() + i);
+            finishAsyncData(deferredInfo);
         }
+        else
+        {
+            ++i;
+        }
+    }
 
+    if (pDataInfo)
+    {
+        finishAsyncData(pDataInfo);
+    }
+}
 
-        Ref* target = pAsyncStruct->target;
-        SEL_SCHEDULE selector = pAsyncStruct->selector;
-
-        --_asyncRefCount;
+bool DataReaderHelper::addDeferredAnimations(DataInfo *dataInfo, bool lastChance)
+{
+    tinyxml2::XMLDocument document;
+    document.Parse(dataInfo->deferredContent.c_str());
 
-        if (target && selector)
+    tinyxml2::XMLElement *animationsXML = document.RootElement()->FirstChildElement(ANIMATIONS);
+    tinyxml2::XMLElement *animationXML = animationsXML->FirstChildElement(ANIMATION);
+    while(animationXML)
+    {
+        auto it = std::find(dataInfo->deferredAnimations.begin(), dataInfo->deferredAnimations.end(), animationXML->Attribute(A_NAME));
+        if (it != dataInfo->deferredAnimations.end())
         {
-            (target->*selector)((_asyncRefTotalCount - _asyncRefCount) / (float)_asyncRefTotalCount);
-            target->release();
+            AnimationData *animationData = DataReaderHelper::decodeAnimation(animationXML, dataInfo);
+            if (animationData)
+            {
+                std::lock_guard<std::mutex> lock(_dataReaderHelper->_addDataMutex);
+                ArmatureDataManager::getInstance()->addAnimationData(animationData->name, animationData, dataInfo->filename);
+                animationData->release();
+                dataInfo->deferredAnimations.erase(it);
+            }
+            else if (lastChance)
+            {
+                CCLOG("DataReaderHelper: the armature of animation %s in %s isn't loaded", it->c_str(), dataInfo->filename.c_str());
+                dataInfo->deferredAnimations.erase(it);
+            }
         }
+        animationXML = animationXML->NextSiblingElement(ANIMATION);
+    }
 
+    if (dataInfo->deferredAnimations.empty())
+    {
+        dataInfo->deferredContent.clear();
+        return true;
+    }
+    return false;
+}
 
-        delete pAsyncStruct;
-        delete pDataInfo;
+void DataReaderHelper::finishAsyncData(DataInfo *pDataInfo)
+{
+    AsyncStruct *pAsyncStruct = pDataInfo->asyncStruct;
 
-        if (0 == _asyncRefCount)
-        {
-            _asyncRefTotalCount = 0;
-            Director::getInstance()->getScheduler()->unschedule(schedule_selector(DataReaderHelper::addDataAsyncCallBack), this);
-        }
+    if (pAsyncStruct->imagePath != "" && pAsyncStruct->plistPath != "")
+    {
+        _getFileMutex.lock();
+        ArmatureDataManager::getInstance()->addSpriteFrameFromFile(pAsyncStruct->plistPath.c_str(), pAsyncStruct->imagePath.c_str());
+        _getFileMutex.unlock();
+    }
+
+    while (!pDataInfo->configFileQueue.empty())
+    {
+        std::string configPath = pDataInfo->configFileQueue.front();
+        _getFileMutex.lock();
+        ArmatureDataManager::getInstance()->addSpriteFrameFromFile((pAsyncStruct->baseFilePath + configPath + ".plist").c_str(), (pAsyncStruct->baseFilePath + configPath + ".png").c_str());
+        _getFileMutex.unlock();
+        pDataInfo->configFileQueue.pop();
+    }
+
+
+    Ref* target = pAsyncStruct->target;
+    SEL_SCHEDULE selector = pAsyncStruct->selector;
+
+    --_asyncRefCount;
+
+    float progress = (_asyncRefTotalCount - _asyncRefCount) / (float)_asyncRefTotalCount;
+    if (target && selector)
+    {
+        (target->*selector)(progress);
+    }
+    CC_SAFE_RELEASE(target);
+
+    fileLoaded(pDataInfo->filename, progress, pDataInfo->loadTime, true);
+
+
+    delete pAsyncStruct;
+    delete pDataInfo;
+
+    if (0 == _asyncRefCount)
+    {
+        _asyncRefTotalCount = 0;
+        Director::getInstance()->getScheduler()->unschedule(schedule_selector(DataReaderHelper::addDataAsyncCallBack), this);
     }
 }
 
@@ -513,14 +622,14 @@ void DataReaderHelper::addDataFromCache(const std::string& pFileContent, DataInf
 
         if (dataInfo->asyncStruct)
         {
-            _dataReaderHelper->_addDataMutex.lock();
+            dataInfo->armatureDatas.pushBack(armatureData);
         }
-        ArmatureDataManager::getInstance()->addArmatureData(armatureData->name.c_str(), armatureData, dataInfo->filename.c_str());
-        armatureData->release();
-        if (dataInfo->asyncStruct)
+        else
         {
-            _dataReaderHelper->_addDataMutex.unlock();
+            std::lock_guard<std::mutex> lock(_dataReaderHelper->_addDataMutex);
+            ArmatureDataManager::getInstance()->addArmatureData(armatureData->name.c_str(), armatureData, dataInfo->filename.c_str());
         }
+        armatureData->release();
 
         armatureXML = armatureXML->NextSiblingElement(ARMATURE);
     }
@@ -534,16 +643,34 @@ void DataReaderHelper::addDataFromCache(const std::string& pFileContent, DataInf
     while(animationXML)
     {
         AnimationData *animationData = DataReaderHelper::decodeAnimation(animationXML, dataInfo);
-        if (dataInfo->asyncStruct)
+        if (!animationData)
         {
-            _dataReaderHelper->_addDataMutex.lock();
+            if (dataInfo->asyncStruct)
+            {
+                // its armature may be in a file still loading, it is decoded once the armature is added
+                dataInfo->deferredAnimations.push_back(animationXML->Attribute(A_NAME));
+                if (dataInfo->deferredContent.empty())
+                {
+                    dataInfo->deferredContent = pFileContent;
+                }
+            }
+            else
+            {
+                CCLOG("DataReaderHelper: the armature of animation %s in %s isn't loaded", animationXML->Attribute(A_NAME), dataInfo->filename.c_str());
+            }
+            animationXML = animationXML->NextSiblingElement(ANIMATION);
+            continue;
         }
-        ArmatureDataManager::getInstance()->addAnimationData(animationData->name.c_str(), animationData, dataInfo->filename.c_str());
-        animationData->release();
         if (dataInfo->asyncStruct)
         {
-            _dataReaderHelper->_addDataMutex.unlock();
+            dataInfo->animationDatas.pushBack(animationData);
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(_dataReaderHelper->_addDataMutex);
+            ArmatureDataManager::getInstance()->addAnimationData(animationData->name.c_str(), animationData, dataInfo->filename.c_str());
         }
+        animationData->release();
         animationXML = animationXML->NextSiblingElement(ANIMATION);
     }
 
@@ -559,14 +686,14 @@ void DataReaderHelper::addDataFromCache(const std::string& pFileContent, DataInf
 
         if (dataInfo->asyncStruct)
         {
-            _dataReaderHelper->_addDataMutex.lock();
+            dataInfo->textureDatas.pushBack(textureData);
         }
-        ArmatureDataManager::getInstance()->addTextureData(textureData->name.c_str(), textureData, dataInfo->filename.c_str());
-        textureData->release();
-        if (dataInfo->asyncStruct)
+        else
         {
-            _dataReaderHelper->_addDataMutex.unlock();
+            std::lock_guard<std::mutex> lock(_dataReaderHelper->_addDataMutex);
+            ArmatureDataManager::getInstance()->addTextureData(textureData->name.c_str(), textureData, dataInfo->filename.c_str());
         }
+        textureData->release();
         textureXML = textureXML->NextSiblingElement(SUB_TEXTURE);
     }
 }
@@ -685,12 +812,38 @@ DisplayData *DataReaderHelper::decodeBoneDisplay(tinyxml2::XMLElement *displayXM
 
 AnimationData *DataReaderHelper::decodeAnimation(tinyxml2::XMLElement *animationXML, DataInfo *dataInfo)
 {
-    AnimationData *aniData =  new AnimationData();
-
     const char	*name = animationXML->Attribute(A_NAME);
 
-    ArmatureData *armatureData = ArmatureDataManager::getInstance()->getArmatureData(name);
+    ArmatureData *armatureData = nullptr;
+    if (dataInfo->asyncStruct)
+    {
+        // the armatures of this file are added to ArmatureDataManager later, on the main thread
+        for (auto& data : dataInfo->armatureDatas)
+        {
+            if (data->name == name)
+            {
+                armatureData = data;
+                break;
+            }
+        }
+        if (!armatureData)
+        {
+            std::lock_guard<std::mutex> lock(_dataReaderHelper->_addDataMutex);
+            armatureData = ArmatureDataManager::getInstance()->getArmatureData(name);
+        }
+    }
+    else
+    {
+        armatureData = ArmatureDataManager::getInstance()->getArmatureData(name);
+    }
+
+    // the movements are decoded relative to the bones of the armature
+    if (!armatureData)
+    {
+        return nullptr;
+    }
 
+    AnimationData *aniData =  new AnimationData();
     aniData->name = name;
 
     tinyxml2::XMLElement *movementXML = animationXML->FirstChildElement(MOVEMENT);
@@ -1202,14 +1355,14 @@ void DataReaderHelper::addDataFromJsonCache(const std::string& fileContent, Data
 
         if (dataInfo->asyncStruct)
         {
-            _dataReaderHelper->_addDataMutex.lock();
+            dataInfo->armatureDatas.pushBack(armatureData);
         }
-        ArmatureDataManager::getInstance()->addArmatureData(armatureData->name.c_str(), armatureData);
-        armatureData->release();
-        if (dataInfo->asyncStruct)
+        else
         {
-            _dataReaderHelper->_addDataMutex.unlock();
+            std::lock_guard<std::mutex> lock(_dataReaderHelper->_addDataMutex);
+            ArmatureDataManager::getInstance()->addArmatureData(armatureData->name.c_str(), armatureData);
         }
+        armatureData->release();
     }
 
     // Decode animations
@@ -1221,14 +1374,14 @@ void DataReaderHelper::addDataFromJsonCache(const std::string& fileContent, Data
 
         if (dataInfo->asyncStruct)
         {
-            _dataReaderHelper->_addDataMutex.lock();
+            dataInfo->animationDatas.pushBack(animationData);
         }
-        ArmatureDataManager::getInstance()->addAnimationData(animationData->name.c_str(), animationData);
-        animationData->release();
-        if (dataInfo->asyncStruct)
+        else
         {
-            _dataReaderHelper->_addDataMutex.unlock();
+            std::lock_guard<std::mutex> lock(_dataReaderHelper->_addDataMutex);
+            ArmatureDataManager::getInstance()->addAnimationData(animationData->name.c_str(), animationData);
         }
+        animationData->release();
     }
 
     // Decode textures
@@ -1240,14 +1393,14 @@ void DataReaderHelper::addDataFromJsonCache(const std::string& fileContent, Data
 
         if (dataInfo->asyncStruct)
         {
-            _dataReaderHelper->_addDataMutex.lock();
+            dataInfo->textureDatas.pushBack(textureData);
         }
-        ArmatureDataManager::getInstance()->addTextureData(textureData->name.c_str(), textureData);
-        textureData->release();
-        if (dataInfo->asyncStruct)
+        else
         {
-            _dataReaderHelper->_addDataMutex.unlock();
+            std::lock_guard<std::mutex> lock(_dataReaderHelper->_addDataMutex);
+            ArmatureDataManager::getInstance()->addTextureData(textureData->name.c_str(), textureData);
         }
+        textureData->release();
     }
 
     // Auto load sprite file
@@ -1687,4 +1840,402 @@ void DataReaderHelper::decodeNode(BaseData *node, const rapidjson::Value& json,
 
 }
 
+
+
+/* Layout of a binary armature file (.csab), version 1, written by tools/armature/json2csab.py.
+ * Every number is little endian.
+ *
+ *   varint       unsigned LEB128, 7 bits per byte
+ *   svarint      zigzag encoded varint
+ *   float        IEEE 754 single precision, 4 bytes
+ *   string       varint length followed by the bytes
+ *   node         float x y skewX skewY scaleX scaleY, svarint zOrder, byte has color, then when set
+ *                byte a r g b
+ *
+ *   header       "CSAB", byte version
+ *   armatures    varint count, then per armature: string name, float data version, varint bone count,
+ *                then per bone: string name, string parent, node, varint display count, then per
+ *                display: byte display type, string name (the plist relative to the file for particles),
+ *                and for sprites a node for the skin
+ *   animations   varint count, then per animation: string name, varint movement count, then per
+ *                movement: string name, byte loop, svarint duration durationTo durationTween tweenEasing,
+ *                float scale, varint movement bone count, then per movement bone: string name, float delay
+ *                duration, varint frame count, then per frame: node, svarint frameID duration tweenEasing
+ *                displayIndex, varint blend src dst, byte isTween, string event, varint easing parameter
+ *                count followed by the floats
+ *   textures     varint count, then per texture: string name, float width height pivotX pivotY, varint
+ *                contour count, then per contour: varint vertex count followed by float x y per vertex
+ *   sprite files varint count, then per file: string path relative to the armature file, without extension
+ *
+ * The converter applies the fixes the json reader does for old CocoStudio versions, frames are stored with
+ * their final index and duration. Positions are stored multiplied by the content scale of the file, the
+ * position read scale is applied on loading. */
+
+static const char BINARY_MAGIC[] = "CSAB";
+static const int BINARY_VERSION = 1;
+
+namespace {
+
+class BinaryReader
+{
+public:
+    BinaryReader(const char *data, size_t size)
+        : _cursor(reinterpret_cast<const unsigned char *>(data))
+        , _end(_cursor + size)
+        , _overflow(false)
+    {
+    }
+
+    int readByte()
+    {
+        if (_cursor >= _end)
+        {
+            _overflow = true;
+            return 0;
+        }
+        return *_cursor++;
+    }
+
+    unsigned int readVarint()
+    {
+        unsigned int value = 0;
+        int shift = 0;
+        int b = 0;
+        do
+        {
+            b = readByte();
+            value |= (unsigned int)(b & 0x7f) << shift;
+            shift += 7;
+        } while ((b & 0x80) && shift < 35);
+        return value;
+    }
+
+    int readSignedVarint()
+    {
+        unsigned int value = readVarint();
+        return (int)(value >> 1) ^ -(int)(value & 1);
+    }
+
+    float readFloat()
+    {
+        unsigned char bytes[4];
+        for (int i = 0; i < 4; i++)
+        {
+            bytes[i] = (unsigned char)readByte();
+        }
+        uint32_t bits = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    std::string readString()
+    {
+        unsigned int length = readVarint();
+        if (length > (unsigned int)(_end - _cursor))
+        {
+            _overflow = true;
+            _cursor = _end;
+            return "";
+        }
+        std::string value(reinterpret_cast<const char *>(_cursor), length);
+        _cursor += length;
+        return value;
+    }
+
+    //! Counts are checked against the bytes left, so corrupted files can't allocate huge arrays
+    unsigned int readCount()
+    {
+        unsigned int count = readVarint();
+        if (count > (unsigned int)(_end - _cursor))
+        {
+            _overflow = true;
+            _cursor = _end;
+            return 0;
+        }
+        return count;
+    }
+
+    bool hasOverflow() const { return _overflow; }
+
+private:
+    const unsigned char *_cursor;
+    const unsigned char *_end;
+    bool _overflow;
+};
+
+void readBinaryNode(BinaryReader& reader, BaseData *node)
+{
+    node->x = reader.readFloat() * s_PositionReadScale;
+    node->y = reader.readFloat() * s_PositionReadScale;
+    node->skewX = reader.readFloat();
+    node->skewY = reader.readFloat();
+    node->scaleX = reader.readFloat();
+    node->scaleY = reader.readFloat();
+    node->zOrder = reader.readSignedVarint();
+
+    if (reader.readByte())
+    {
+        node->a = reader.readByte();
+        node->r = reader.readByte();
+        node->g = reader.readByte();
+        node->b = reader.readByte();
+        node->isUseColorInfo = true;
+    }
+}
+
+DisplayData *readBinaryDisplay(BinaryReader& reader, const std::string& baseFilePath)
+{
+    DisplayType displayType = (DisplayType)reader.readByte();
+    std::string name = reader.readString();
+
+    DisplayData *displayData = nullptr;
+    switch (displayType)
+    {
+    case CS_DISPLAY_SPRITE:
+        displayData = new SpriteDisplayData();
+        displayData->displayName = name;
+        readBinaryNode(reader, &static_cast<SpriteDisplayData *>(displayData)->skinData);
+        break;
+    case CS_DISPLAY_ARMATURE:
+        displayData = new ArmatureDisplayData();
+        displayData->displayName = name;
+        break;
+    case CS_DISPLAY_PARTICLE:
+        displayData = new ParticleDisplayData();
+        if (!name.empty())
+        {
+            displayData->displayName = baseFilePath + name;
+        }
+        break;
+    default:
+        displayData = new SpriteDisplayData();
+        break;
+    }
+    displayData->displayType = displayType;
+
+    return displayData;
+}
+
+ArmatureData *readBinaryArmature(BinaryReader& reader, const std::string& baseFilePath)
+{
+    ArmatureData *armatureData = new ArmatureData();
+    armatureData->init();
+    armatureData->name = reader.readString();
+    armatureData->dataVersion = reader.readFloat();
+
+    unsigned int boneCount = reader.readCount();
+    for (unsigned int i = 0; i < boneCount; i++)
+    {
+        BoneData *boneData = new BoneData();
+        boneData->init();
+        boneData->name = reader.readString();
+        boneData->parentName = reader.readString();
+        readBinaryNode(reader, boneData);
+
+        unsigned int displayCount = reader.readCount();
+        for (unsigned int j = 0; j < displayCount; j++)
+        {
+            DisplayData *displayData = readBinaryDisplay(reader, baseFilePath);
+            boneData->addDisplayData(displayData);
+            displayData->release();
+        }
+
+        armatureData->addBoneData(boneData);
+        boneData->release();
+    }
+
+    return armatureData;
+}
+
+FrameData *readBinaryFrame(BinaryReader& reader)
+{
+    FrameData *frameData = new FrameData();
+    readBinaryNode(reader, frameData);
+
+    frameData->frameID = reader.readSignedVarint();
+    frameData->duration = reader.readSignedVarint();
+    frameData->tweenEasing = (cocos2d::tweenfunc::TweenType)reader.readSignedVarint();
+    frameData->displayIndex = reader.readSignedVarint();
+    frameData->blendFunc.src = (GLenum)reader.readVarint();
+    frameData->blendFunc.dst = (GLenum)reader.readVarint();
+    frameData->isTween = reader.readByte() != 0;
+    frameData->strEvent = reader.readString();
+
+    unsigned int easingParamCount = reader.readCount();
+    if (easingParamCount != 0)
+    {
+        frameData->easingParamNumber = easingParamCount;
+        frameData->easingParams = new float[easingParamCount];
+        for (unsigned int i = 0; i < easingParamCount; i++)
+        {
+            frameData->easingParams[i] = reader.readFloat();
+        }
+    }
+
+    return frameData;
+}
+
+AnimationData *readBinaryAnimation(BinaryReader& reader)
+{
+    AnimationData *animationData = new AnimationData();
+    animationData->name = reader.readString();
+
+    unsigned int movementCount = reader.readCount();
+    for (unsigned int i = 0; i < movementCount; i++)
+    {
+        MovementData *movementData = new MovementData();
+        movementData->name = reader.readString();
+        movementData->loop = reader.readByte() != 0;
+        movementData->duration = reader.readSignedVarint();
+        movementData->durationTo = reader.readSignedVarint();
+        movementData->durationTween = reader.readSignedVarint();
+        movementData->tweenEasing = (cocos2d::tweenfunc::TweenType)reader.readSignedVarint();
+        movementData->scale = reader.readFloat();
+
+        unsigned int movementBoneCount = reader.readCount();
+        for (unsigned int j = 0; j < movementBoneCount; j++)
+        {
+            MovementBoneData *movementBoneData = new MovementBoneData();
+            movementBoneData->init();
+            movementBoneData->name = reader.readString();
+            movementBoneData->delay = reader.readFloat();
+            movementBoneData->duration = reader.readFloat();
+
+            unsigned int frameCount = reader.readCount();
+            for (unsigned int k = 0; k < frameCount; k++)
+            {
+                FrameData *frameData = readBinaryFrame(reader);
+                movementBoneData->addFrameData(frameData);
+                frameData->release();
+            }
+
+            movementData->addMovementBoneData(movementBoneData);
+            movementBoneData->release();
+        }
+
+        animationData->addMovement(movementData);
+        movementData->release();
+    }
+
+    return animationData;
+}
+
+TextureData *readBinaryTexture(BinaryReader& reader)
+{
+    TextureData *textureData = new TextureData();
+    textureData->init();
+    textureData->name = reader.readString();
+    textureData->width = reader.readFloat();
+    textureData->height = reader.readFloat();
+    textureData->pivotX = reader.readFloat();
+    textureData->pivotY = reader.readFloat();
+
+    unsigned int contourCount = reader.readCount();
+    for (unsigned int i = 0; i < contourCount; i++)
+    {
+        ContourData *contourData = new ContourData();
+        contourData->init();
+
+        unsigned int vertexCount = reader.readCount();
+        contourData->vertexList.reserve(vertexCount);
+        for (unsigned int j = 0; j < vertexCount; j++)
+        {
+            float x = reader.readFloat();
+            float y = reader.readFloat();
+            contourData->vertexList.push_back(Vec2(x, y));
+        }
+
+        textureData->contourDataList.pushBack(contourData);
+        contourData->release();
+    }
+
+    return textureData;
+}
+
+} // anonymous namespace
+
+bool DataReaderHelper::isBinaryContent(const std::string& fileContent)
+{
+    return fileContent.size() > 4 && fileContent.compare(0, 4, BINARY_MAGIC) == 0;
+}
+
+bool DataReaderHelper::addDataFromBinaryCache(const std::string& fileContent, DataInfo *dataInfo)
+{
+    if (!isBinaryContent(fileContent) || (unsigned char)fileContent[4] != BINARY_VERSION)
+    {
+        CCLOG("%s is not a binary armature file of version %d.", dataInfo->filename.c_str(), BINARY_VERSION);
+        return false;
+    }
+
+    BinaryReader reader(fileContent.data() + 5, fileContent.size() - 5);
+    const std::string& baseFilePath = dataInfo->asyncStruct ? dataInfo->asyncStruct->baseFilePath : dataInfo->baseFilePath;
+
+    // decoded into dataInfo first, so that nothing is added from a corrupted file
+    unsigned int count = reader.readCount();
+    for (unsigned int i = 0; i < count; i++)
+    {
+        ArmatureData *armatureData = readBinaryArmature(reader, baseFilePath);
+        dataInfo->cocoStudioVersion = armatureData->dataVersion;
+        dataInfo->armatureDatas.pushBack(armatureData);
+        armatureData->release();
+    }
+
+    count = reader.readCount();
+    for (unsigned int i = 0; i < count; i++)
+    {
+        AnimationData *animationData = readBinaryAnimation(reader);
+        dataInfo->animationDatas.pushBack(animationData);
+        animationData->release();
+    }
+
+    count = reader.readCount();
+    for (unsigned int i = 0; i < count; i++)
+    {
+        TextureData *textureData = readBinaryTexture(reader);
+        dataInfo->textureDatas.pushBack(textureData);
+        textureData->release();
+    }
+
+    std::vector<std::string> spriteFiles;
+    count = reader.readCount();
+    for (unsigned int i = 0; i < count; i++)
+    {
+        spriteFiles.push_back(reader.readString());
+    }
+
+    if (reader.hasOverflow())
+    {
+        CCLOG("binary armature file %s is corrupted.", dataInfo->filename.c_str());
+        dataInfo->armatureDatas.clear();
+        dataInfo->animationDatas.clear();
+        dataInfo->textureDatas.clear();
+        return false;
+    }
+
+    if (!dataInfo->asyncStruct)
+    {
+        addDecodedData(dataInfo, dataInfo->filename);
+    }
+
+    // Auto load sprite file
+    bool autoLoad = dataInfo->asyncStruct == nullptr ? ArmatureDataManager::getInstance()->isAutoLoadSpriteFile() : dataInfo->asyncStruct->autoLoadSpriteFile;
+    if (autoLoad)
+    {
+        for (const auto& filePath : spriteFiles)
+        {
+            if (dataInfo->asyncStruct)
+            {
+                dataInfo->configFileQueue.push(filePath);
+            }
+            else
+            {
+                ArmatureDataManager::getInstance()->addSpriteFrameFromFile(dataInfo->baseFilePath + filePath + ".plist", dataInfo->baseFilePath + filePath + ".png");
+            }
+        }
+    }
+
+    return true;
+}
+
 }
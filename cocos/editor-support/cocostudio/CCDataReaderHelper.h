@@ -34,8 +34,8 @@ THE SOFTWARE.
 #include <queue>
 #include <list>
 #include <mutex>
-#include <thread>
 #include <condition_variable>
+#include <functional>
 
 namespace tinyxml2
 {
@@ -55,13 +55,14 @@ protected:
 	enum ConfigType
 	{
 		DragonBone_XML,
-		CocoStudio_JSON
+		CocoStudio_JSON,
+		CocoStudio_Binary
 	};
 
 	typedef struct _AsyncStruct
 	{
 		std::string    filename;
-		std::string    fileContent;
+		std::string    fullPath;
 		ConfigType     configType;
 		std::string    baseFilePath;
 		cocos2d::Ref       *target;
@@ -81,8 +82,38 @@ protected:
         std::string    baseFilePath;
         float flashToolVersion;
         float cocoStudioVersion;
+
+        /**
+         * Datas decoded by an asynchronous load, they are added to ArmatureDataManager
+         * on the main thread by addDataAsyncCallBack()
+         */
+        cocos2d::Vector<ArmatureData *>   armatureDatas;
+        cocos2d::Vector<AnimationData *>  animationDatas;
+        cocos2d::Vector<TextureData *>    textureDatas;
+        float loadTime;             //! seconds spent reading and decoding the file
+
+        /**
+         * Xml animations whose armature wasn't loaded yet when the file was decoded asynchronously,
+         * they are decoded from deferredContent once their armature is added to ArmatureDataManager
+         */
+        std::vector<std::string> deferredAnimations;
+        std::string deferredContent;
 	} DataInfo;
 
+public:
+    /**
+     * Passed to the file loaded callback.
+     * progress is the progress of the pending asynchronous loads, 1 for a synchronous load.
+     */
+    struct FileLoadInfo
+    {
+        std::string filePath;
+        float progress;
+        float loadTime;             //! seconds spent reading and decoding the file
+        bool async;
+    };
+    typedef std::function<void(const FileLoadInfo&)> FileLoadedCallback;
+
 public:
 
 	/** @deprecated Use getInstance() instead */
@@ -115,6 +146,12 @@ public:
     void addDataAsyncCallBack(float dt);
 
     void removeConfigFile(const std::string& configFile);
+
+    /**
+     * Set a callback called on the main thread after each config file is added,
+     * with the time spent reading and decoding it.
+     */
+    void setFileLoadedCallback(const FileLoadedCallback& callback) { _fileLoadedCallback = callback; }
 public:
 
     /**
@@ -137,6 +174,7 @@ public:
 
     /**
      * Decode ArmatureAnimation Datas from xml export from Dragon Bone flash tool
+     * Returns nullptr if the armature of the animation isn't loaded.
      */
     static AnimationData *decodeAnimation(tinyxml2::XMLElement *animationXML, DataInfo *dataInfo);
     static MovementData *decodeMovement(tinyxml2::XMLElement *movementXML, ArmatureData *armatureData, DataInfo *dataInfo);
@@ -172,33 +210,48 @@ public:
 
     static void decodeNode(BaseData *node, const rapidjson::Value& json, DataInfo *dataInfo);
 
-protected:
-	void loadData();
-
-
+public:
+    /**
+     * Decode a binary armature file written by tools/armature/json2csab.py.
+     * Returns false if the data is corrupted, nothing is added then.
+     */
+    static bool addDataFromBinaryCache(const std::string& fileContent, DataInfo *dataInfo);
 
+    static bool isBinaryContent(const std::string& fileContent);
 
-	std::condition_variable		_sleepCondition;
+protected:
+    //! Read and decode one config file, runs as a task of the ThreadPool
+	void loadData(AsyncStruct *asyncStruct);
 
-	std::thread     *_loadingThread;
+    static void addDataFromContent(const std::string& fileContent, ConfigType configType, DataInfo *dataInfo);
+    //! Add the datas decoded by an asynchronous load to ArmatureDataManager
+    static void addDecodedData(DataInfo *dataInfo, const std::string& configFilePath);
+    /**
+     * Decode the deferred animations whose armature is now in ArmatureDataManager, returns true once none is left.
+     * If lastChance is true, the animations whose armature is still missing are dropped.
+     */
+    static bool addDeferredAnimations(DataInfo *dataInfo, bool lastChance);
+    //! Load the sprite frames of an asynchronously loaded file, report it and delete its DataInfo
+    void finishAsyncData(DataInfo *dataInfo);
 
-	std::mutex      _sleepMutex;
+    void fileLoaded(const std::string& filePath, float progress, float loadTime, bool async);
 
-	std::mutex      _asyncStructQueueMutex;
-	std::mutex      _dataInfoMutex;
+	std::mutex      _dataInfoMutex;             //! guards _dataQueue and _loadingTasks
+	std::condition_variable _loadingCondition;
+	int             _loadingTasks;
 
 	std::mutex      _addDataMutex;
 
     std::mutex      _getFileMutex;
 
-	  
 	unsigned long _asyncRefCount;
 	unsigned long _asyncRefTotalCount;
 
-	bool need_quit;
+	std::queue<DataInfo *>   _dataQueue;
+    //! the added files that wait for the armatures of their animations
+    std::vector<DataInfo *>  _deferredDataInfos;
 
-	std::queue<AsyncStruct *> *_asyncStructQueue;
-	std::queue<DataInfo *>   *_dataQueue;
+    FileLoadedCallback _fileLoadedCallback;
 
     static std::vector<std::string> _configFileList;
 
@@ -84,6 +84,7 @@ Skin *Skin::create(const std::string& pszFileName)
 Skin::Skin()
     : _bone(nullptr)
     , _armature(nullptr)
+    , _skinTransformAffine(true)
     , _displayName("")
 {
     _skinTransform = Mat4::IDENTITY;
@@ -131,6 +132,11 @@ void Skin::setSkinData(const BaseData &var)
     setPosition(Vec2(_skinData.x, _skinData.y));
 
     _skinTransform = getNodeToParentTransform();
+
+    const float *m = _skinTransform.m;
+    _skinTransformAffine = m[2] == 0 && m[3] == 0 && m[6] == 0 && m[7] == 0
+        && m[8] == 0 && m[9] == 0 && m[10] == 1 && m[11] == 0 && m[14] == 0 && m[15] == 1;
+
     updateArmatureTransform();
 }
 
@@ -141,7 +147,24 @@ const BaseData &Skin::getSkinData() const
 
 void Skin::updateArmatureTransform()
 {
-    _transform = TransformConcat(_bone->getNodeToArmatureTransform(), _skinTransform);
+    if (!_skinTransformAffine)
+    {
+        _transform = TransformConcat(_bone->getNodeToArmatureTransform(), _skinTransform);
+        return;
+    }
+
+    // bone * skin, with only the 2D affine terms of the skin transform
+    const Mat4 bone = _bone->getNodeToArmatureTransform();
+    const float *b = bone.m;
+    const float *s = _skinTransform.m;
+    float *t = _transform.m;
+    for (int row = 0; row < 4; ++row)
+    {
+        t[row]      = b[row] * s[0] + b[4 + row] * s[1];
+        t[4 + row]  = b[row] * s[4] + b[4 + row] * s[5];
+        t[8 + row]  = b[8 + row];
+        t[12 + row] = b[row] * s[12] + b[4 + row] * s[13] + b[12 + row];
+    }
 //    if(_armature && _armature->getBatchNode())
 //    {
 //        _transform = TransformConcat(_transform, _armature->getNodeToParentTransform());
@@ -201,6 +224,21 @@ void Skin::updateTransform()
     }
 }
 
+void Skin::applyBoneBlendFunc()
+{
+    if (!_bone->isBlendDirty())
+    {
+        return;
+    }
+
+    BlendFunc blendFunc = _bone->getBlendFunc();
+    if (_bone->isDefaultBlendFunc() && _texture && _texture->hasPremultipliedAlpha())
+    {
+        blendFunc = BlendFunc::ALPHA_PREMULTIPLIED;
+    }
+    setBlendFunc(blendFunc);
+}
+
 Mat4 Skin::getNodeToWorldTransform() const
 {
     return TransformConcat( _bone->getArmature()->getNodeToWorldTransform(), _transform);
@@ -51,6 +51,13 @@ public:
     void updateArmatureTransform();
     void updateTransform() override;
 
+    /**
+     * Uses the blend function of the bone once it changed. The default blending of the bones (see Bone::resetBlendFunc())
+     * keeps the blending of the texture, so that the skins of a sprite sheet share one material; a blend function
+     * set on the bone is used as is.
+     */
+    void applyBoneBlendFunc();
+
     cocos2d::Mat4 getNodeToWorldTransform() const override;
     cocos2d::Mat4 getNodeToWorldTransformAR() const;
     
@@ -76,6 +83,7 @@ protected:
     Bone *_bone;
     Armature *_armature;
     cocos2d::Mat4 _skinTransform;
+    bool _skinTransformAffine;             //! whether _skinTransform only has 2D affine terms
     std::string _displayName;
     cocos2d::QuadCommand _quadCommand;     // quad command
 };
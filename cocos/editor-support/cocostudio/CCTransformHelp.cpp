@@ -35,63 +35,64 @@ AffineTransform TransformHelp::helpMatrix2;
 Vec2 TransformHelp::helpPoint1;
 Vec2 TransformHelp::helpPoint2;
 
-BaseData helpParentNode;
-
 TransformHelp::TransformHelp()
 {
 }
 
 void TransformHelp::transformFromParent(BaseData &node, const BaseData &parentNode)
 {
-    nodeToMatrix(node, helpMatrix1);
-    nodeToMatrix(parentNode, helpMatrix2);
+    AffineTransform matrix, parentMatrix;
+    nodeToMatrix(node, matrix);
+    nodeToMatrix(parentNode, parentMatrix);
 
-    helpMatrix2 = AffineTransformInvert(helpMatrix2);
-    helpMatrix1 = AffineTransformConcat(helpMatrix1, helpMatrix2);
+    parentMatrix = AffineTransformInvert(parentMatrix);
+    matrix = AffineTransformConcat(matrix, parentMatrix);
 
-    matrixToNode(helpMatrix1, node);
+    matrixToNode(matrix, node);
 }
 
 void TransformHelp::transformToParent(BaseData &node, const BaseData &parentNode)
 {
+    AffineTransform matrix, parentMatrix;
+    nodeToMatrix(node, matrix);
+    nodeToMatrix(parentNode, parentMatrix);
 
-    nodeToMatrix(node, helpMatrix1);
-    nodeToMatrix(parentNode, helpMatrix2);
-
-    helpMatrix1 = AffineTransformConcat(helpMatrix1, helpMatrix2);
+    matrix = AffineTransformConcat(matrix, parentMatrix);
 
-    matrixToNode(helpMatrix1, node);
+    matrixToNode(matrix, node);
 }
 
 void TransformHelp::transformFromParentWithoutScale(BaseData &node, const BaseData &parentNode)
 {
+    BaseData parentNodeWithoutScale;
+    parentNodeWithoutScale.copy(&parentNode);
+    parentNodeWithoutScale.scaleX = 1;
+    parentNodeWithoutScale.scaleY = 1;
 
-    helpParentNode.copy(&parentNode);
-    helpParentNode.scaleX = 1;
-    helpParentNode.scaleY = 1;
+    AffineTransform matrix, parentMatrix;
+    nodeToMatrix(node, matrix);
+    nodeToMatrix(parentNodeWithoutScale, parentMatrix);
 
-    nodeToMatrix(node, helpMatrix1);
-    nodeToMatrix(helpParentNode, helpMatrix2);
+    parentMatrix = AffineTransformInvert(parentMatrix);
+    matrix = AffineTransformConcat(matrix, parentMatrix);
 
-    helpMatrix2 = AffineTransformInvert(helpMatrix2);
-    helpMatrix1 = AffineTransformConcat(helpMatrix1, helpMatrix2);
-
-    matrixToNode(helpMatrix1, node);
+    matrixToNode(matrix, node);
 }
 
 void TransformHelp::transformToParentWithoutScale(BaseData &node, const BaseData &parentNode)
 {
+    BaseData parentNodeWithoutScale;
+    parentNodeWithoutScale.copy(&parentNode);
+    parentNodeWithoutScale.scaleX = 1;
+    parentNodeWithoutScale.scaleY = 1;
 
-    helpParentNode.copy(&parentNode);
-    helpParentNode.scaleX = 1;
-    helpParentNode.scaleY = 1;
-
-    nodeToMatrix(node, helpMatrix1);
-    nodeToMatrix(helpParentNode, helpMatrix2);
+    AffineTransform matrix, parentMatrix;
+    nodeToMatrix(node, matrix);
+    nodeToMatrix(parentNodeWithoutScale, parentMatrix);
 
-    helpMatrix1 = AffineTransformConcat(helpMatrix1, helpMatrix2);
+    matrix = AffineTransformConcat(matrix, parentMatrix);
 
-    matrixToNode(helpMatrix1, node);
+    matrixToNode(matrix, node);
 }
 
 void TransformHelp::nodeToMatrix(const BaseData &node, AffineTransform &matrix)
@@ -151,20 +152,18 @@ void TransformHelp::matrixToNode(const AffineTransform &matrix, BaseData &node)
      *  In as3 language, there is a function called "deltaTransformPoint", it calculate a point used give Transform
      *  but not used the tx, ty value. we simulate the function here
      */
-    helpPoint1.x = 0;
-    helpPoint1.y = 1;
-    helpPoint1 = PointApplyAffineTransform(helpPoint1, matrix);
-    helpPoint1.x -= matrix.tx;
-    helpPoint1.y -= matrix.ty;
-
-    helpPoint2.x = 1;
-    helpPoint2.y = 0;
-    helpPoint2 = PointApplyAffineTransform(helpPoint2, matrix);
-    helpPoint2.x -= matrix.tx;
-    helpPoint2.y -= matrix.ty;
-
-    node.skewX = -(atan2f(helpPoint1.y, helpPoint1.x) - 1.5707964f);
-    node.skewY = atan2f(helpPoint2.y, helpPoint2.x);
+    Vec2 deltaY(0, 1);
+    deltaY = PointApplyAffineTransform(deltaY, matrix);
+    deltaY.x -= matrix.tx;
+    deltaY.y -= matrix.ty;
+
+    Vec2 deltaX(1, 0);
+    deltaX = PointApplyAffineTransform(deltaX, matrix);
+    deltaX.x -= matrix.tx;
+    deltaX.y -= matrix.ty;
+
+    node.skewX = -(atan2f(deltaY.y, deltaY.x) - 1.5707964f);
+    node.skewY = atan2f(deltaX.y, deltaX.x);
     node.scaleX = sqrt(matrix.a * matrix.a + matrix.b * matrix.b);
     node.scaleY = sqrt(matrix.c * matrix.c + matrix.d * matrix.d);
     node.x = matrix.tx;
@@ -177,20 +176,18 @@ void TransformHelp::matrixToNode(const Mat4 &matrix, BaseData &node)
      *  In as3 language, there is a function called "deltaTransformPoint", it calculate a point used give Transform
      *  but not used the tx, ty value. we simulate the function here
      */
-    helpPoint1.x = 0;
-    helpPoint1.y = 1;
-    helpPoint1 = PointApplyTransform(helpPoint1, matrix);
-    helpPoint1.x -= matrix.m[12];
-    helpPoint1.y -= matrix.m[13];
-
-    helpPoint2.x = 1;
-    helpPoint2.y = 0;
-    helpPoint2 = PointApplyTransform(helpPoint2, matrix);
-    helpPoint2.x -= matrix.m[12];
-    helpPoint2.y -= matrix.m[13];
-
-    node.skewX = -(atan2f(helpPoint1.y, helpPoint1.x) - 1.5707964f);
-    node.skewY = atan2f(helpPoint2.y, helpPoint2.x);
+    Vec2 deltaY(0, 1);
+    deltaY = PointApplyTransform(deltaY, matrix);
+    deltaY.x -= matrix.m[12];
+    deltaY.y -= matrix.m[13];
+
+    Vec2 deltaX(1, 0);
+    deltaX = PointApplyTransform(deltaX, matrix);
+    deltaX.x -= matrix.m[12];
+    deltaX.y -= matrix.m[13];
+
+    node.skewX = -(atan2f(deltaY.y, deltaY.x) - 1.5707964f);
+    node.skewY = atan2f(deltaX.y, deltaX.x);
     node.scaleX = sqrt(matrix.m[0] * matrix.m[0] + matrix.m[1] * matrix.m[1]);
     node.scaleY = sqrt(matrix.m[4] * matrix.m[4] + matrix.m[5] * matrix.m[5]);
     node.x = matrix.m[12];
@@ -32,6 +32,7 @@ namespace cocostudio {
 
 /*
  * use to calculate the matrix of node from parent node
+ * The functions only use their arguments and locals, they can be called from any thread.
  * @js NA
  * @lua NA
  */
@@ -54,6 +55,7 @@ public:
     static void nodeConcat(BaseData &target, BaseData &source);
     static void nodeSub(BaseData &target, BaseData &source);
 public:
+    //! Not used by the functions anymore, kept for compatibility
     static cocos2d::AffineTransform helpMatrix1;
     static cocos2d::AffineTransform helpMatrix2;
 
@@ -338,8 +338,16 @@ void Tween::arriveKeyFrame(FrameData *keyFrameData)
         _tweenData->zOrder = keyFrameData->zOrder;
         _bone->updateZOrder();
 
-        //! Update blend type
-        _bone->setBlendFunc(keyFrameData->blendFunc);
+        //! Update blend type, the normal blending of the data follows the texture of the skins
+        const cocos2d::BlendFunc& blendFunc = keyFrameData->blendFunc;
+        if (blendFunc.src == cocos2d::BlendFunc::ALPHA_NON_PREMULTIPLIED.src && blendFunc.dst == cocos2d::BlendFunc::ALPHA_NON_PREMULTIPLIED.dst)
+        {
+            _bone->resetBlendFunc();
+        }
+        else
+        {
+            _bone->setBlendFunc(blendFunc);
+        }
 
         //! Update child armature's movement
         Armature *childAramture = _bone->getChildArmature();
@@ -33,6 +33,7 @@
 
 #include <spine/CCSkeleton.h>
 #include <spine/spine-cocos2dx.h>
+#include <spine/CCSkeletonDataCache.h>
 
 USING_NS_CC;
 using std::min;
@@ -60,6 +61,8 @@ Skeleton* Skeleton::createWithFile (const char* skeletonDataFile, const char* at
 
 void Skeleton::initialize () {
 	atlas = 0;
+	ownsSkeletonData = false;
+	sharesSkeletonData = false;
 	debugSlots = false;
 	debugBones = false;
 	timeScale = 1;
@@ -91,11 +94,8 @@ Skeleton::Skeleton (spSkeletonData *skeletonData, bool isOwnsSkeletonData) {
 Skeleton::Skeleton (const char* skeletonDataFile, spAtlas* aAtlas, float scale) {
 	initialize();
 
-	spSkeletonJson* json = spSkeletonJson_create(aAtlas);
-	json->scale = scale == 0 ? (1 / Director::getInstance()->getContentScaleFactor()) : scale;
-	spSkeletonData* skeletonData = spSkeletonJson_readSkeletonDataFile(json, skeletonDataFile);
-	CCAssert(skeletonData, json->error ? json->error : "Error reading skeleton data.");
-	spSkeletonJson_dispose(json);
+	spSkeletonData* skeletonData = SkeletonDataCache::readSkeletonDataFile(skeletonDataFile, aAtlas, scale);
+	CCAssert(skeletonData, "Error reading skeleton data.");
 
 	setSkeletonData(skeletonData, true);
 }
@@ -103,20 +103,17 @@ Skeleton::Skeleton (const char* skeletonDataFile, spAtlas* aAtlas, float scale)
 Skeleton::Skeleton (const char* skeletonDataFile, const char* atlasFile, float scale) {
 	initialize();
 
-	atlas = spAtlas_readAtlasFile(atlasFile);
-	CCAssert(atlas, "Error reading atlas file.");
+	// the skeletons created from the same files share the data and the atlas
+	spSkeletonData* skeletonData = SkeletonDataCache::getInstance()->retainSkeletonData(skeletonDataFile, atlasFile, scale);
+	CCAssert(skeletonData, "Error reading skeleton data file or atlas file.");
 
-	spSkeletonJson* json = spSkeletonJson_create(atlas);
-	json->scale = scale == 0 ? (1 / Director::getInstance()->getContentScaleFactor()) : scale;
-	spSkeletonData* skeletonData = spSkeletonJson_readSkeletonDataFile(json, skeletonDataFile);
-	CCAssert(skeletonData, json->error ? json->error : "Error reading skeleton data file.");
-	spSkeletonJson_dispose(json);
-
-	setSkeletonData(skeletonData, true);
+	setSkeletonData(skeletonData, false);
+	sharesSkeletonData = true;
 }
 
 Skeleton::~Skeleton () {
 	if (ownsSkeletonData) spSkeletonData_dispose(skeleton->data);
+	if (sharesSkeletonData) SkeletonDataCache::getInstance()->releaseSkeletonData(skeleton->data);
 	if (atlas) spAtlas_dispose(atlas);
 	spSkeleton_dispose(skeleton);
 }
@@ -128,8 +125,7 @@ void Skeleton::update (float deltaTime) {
 void Skeleton::draw(cocos2d::Renderer *renderer, const Mat4 &transform, bool transformUpdated)
 {
 
-    _customCommand.init(_globalZOrder);
-    _customCommand.func = CC_CALLBACK_0(Skeleton::onDraw, this, transform, transformUpdated);
+    _customCommand.init(_globalZOrder, renderer->getFrameArena(), CC_CALLBACK_0(Skeleton::onDraw, this, transform, transformUpdated));
     renderer->addCommand(&_customCommand);
 }
     
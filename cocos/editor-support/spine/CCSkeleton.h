@@ -106,6 +106,7 @@ protected:
 
 private:
 	bool ownsSkeletonData;
+	bool sharesSkeletonData;
 	spAtlas* atlas;
 	void initialize ();
     // Util function that setting blend-function by nextRenderedTexture's premultiplied flag
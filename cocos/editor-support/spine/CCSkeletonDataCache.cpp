@@ -0,0 +1,180 @@
+/****************************************************************************
+Copyright (c) 2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include <spine/CCSkeletonDataCache.h>
+#include <spine/SkeletonBinary.h>
+#include <spine/extension.h>
+#include <spine/spine-cocos2dx.h>
+
+USING_NS_CC;
+
+namespace spine {
+
+static SkeletonDataCache* s_sharedSkeletonDataCache = nullptr;
+
+static float resolveScale (float scale) {
+	return scale == 0 ? (1 / Director::getInstance()->getContentScaleFactor()) : scale;
+}
+
+SkeletonDataCache* SkeletonDataCache::getInstance () {
+	if (!s_sharedSkeletonDataCache) s_sharedSkeletonDataCache = new SkeletonDataCache();
+	return s_sharedSkeletonDataCache;
+}
+
+void SkeletonDataCache::destroyInstance () {
+	delete s_sharedSkeletonDataCache;
+	s_sharedSkeletonDataCache = nullptr;
+}
+
+SkeletonDataCache::SkeletonDataCache ()
+: _loads(0)
+, _hits(0) {
+}
+
+SkeletonDataCache::~SkeletonDataCache () {
+	for (auto& entry : _skeletonData) {
+		if (entry.second.references > 0)
+			CCLOG("SkeletonDataCache: %s is still used by %d skeletons", entry.first.c_str(), entry.second.references);
+		spSkeletonData_dispose(entry.second.skeletonData);
+	}
+	for (auto& entry : _atlases)
+		spAtlas_dispose(entry.second.atlas);
+}
+
+spSkeletonData* SkeletonDataCache::readSkeletonDataFile (const char* skeletonDataFile, spAtlas* atlas, float scale) {
+	int length = 0;
+	char* data = _spUtil_readFile(skeletonDataFile, &length);
+	if (!data) {
+		CCLOG("SkeletonDataCache: unable to read skeleton file %s", skeletonDataFile);
+		return 0;
+	}
+
+	spSkeletonData* skeletonData;
+	if (spSkeletonBinary_isBinary((const unsigned char*)data, length)) {
+		spSkeletonBinary* binary = spSkeletonBinary_create(atlas);
+		binary->scale = resolveScale(scale);
+		skeletonData = spSkeletonBinary_readSkeletonData(binary, (const unsigned char*)data, length);
+		if (!skeletonData) CCLOG("SkeletonDataCache: %s: %s", skeletonDataFile, binary->error);
+		spSkeletonBinary_dispose(binary);
+	} else {
+		// _spUtil_readFile() terminates the data, so it can be parsed in place
+		spSkeletonJson* json = spSkeletonJson_create(atlas);
+		json->scale = resolveScale(scale);
+		skeletonData = spSkeletonJson_readSkeletonData(json, data);
+		if (!skeletonData) CCLOG("SkeletonDataCache: %s: %s", skeletonDataFile, json->error);
+		spSkeletonJson_dispose(json);
+	}
+	FREE(data);
+	return skeletonData;
+}
+
+spAtlas* SkeletonDataCache::retainAtlas (const std::string& atlasFile) {
+	auto iter = _atlases.find(atlasFile);
+	if (iter != _atlases.end()) {
+		++iter->second.references;
+		return iter->second.atlas;
+	}
+
+	spAtlas* atlas = spAtlas_readAtlasFile(atlasFile.c_str());
+	if (!atlas) {
+		CCLOG("SkeletonDataCache: unable to read atlas file %s", atlasFile.c_str());
+		return 0;
+	}
+	AtlasEntry entry = { atlas, 1 };
+	_atlases[atlasFile] = entry;
+	return atlas;
+}
+
+void SkeletonDataCache::releaseAtlas (const std::string& atlasFile) {
+	auto iter = _atlases.find(atlasFile);
+	if (iter == _atlases.end()) return;
+	if (--iter->second.references > 0) return;
+	spAtlas_dispose(iter->second.atlas);
+	_atlases.erase(iter);
+}
+
+spSkeletonData* SkeletonDataCache::retainSkeletonData (const char* skeletonDataFile, const char* atlasFile, float scale) {
+	scale = resolveScale(scale);
+	std::string key = StringUtils::format("%s|%s|%g", skeletonDataFile, atlasFile, scale);
+
+	auto iter = _skeletonData.find(key);
+	if (iter != _skeletonData.end()) {
+		++iter->second.references;
+		++_hits;
+		return iter->second.skeletonData;
+	}
+
+	// an atlas is referenced once per skeleton data using it, not once per skeleton
+	spAtlas* atlas = retainAtlas(atlasFile);
+	if (!atlas) return 0;
+
+	spSkeletonData* skeletonData = readSkeletonDataFile(skeletonDataFile, atlas, scale);
+	if (!skeletonData) {
+		releaseAtlas(atlasFile);
+		return 0;
+	}
+	++_loads;
+
+	DataEntry entry = { skeletonData, atlasFile, 1 };
+	_skeletonData[key] = entry;
+	_keys[skeletonData] = key;
+	return skeletonData;
+}
+
+void SkeletonDataCache::releaseSkeletonData (spSkeletonData* skeletonData) {
+	auto keyIter = _keys.find(skeletonData);
+	if (keyIter == _keys.end()) {
+		CCLOG("SkeletonDataCache: releasing skeleton data that is not cached");
+		return;
+	}
+
+	auto iter = _skeletonData.find(keyIter->second);
+	if (--iter->second.references > 0) return;
+
+	std::string atlasFile = iter->second.atlasFile;
+	spSkeletonData_dispose(skeletonData);
+	_skeletonData.erase(iter);
+	_keys.erase(keyIter);
+	releaseAtlas(atlasFile);
+}
+
+int SkeletonDataCache::getReferenceCount (spSkeletonData* skeletonData) const {
+	auto keyIter = _keys.find(skeletonData);
+	if (keyIter == _keys.end()) return 0;
+	return _skeletonData.at(keyIter->second).references;
+}
+
+SkeletonDataCache::Stats SkeletonDataCache::getStats () const {
+	Stats stats;
+	stats.skeletonDataCount = (int)_skeletonData.size();
+	stats.atlasCount = (int)_atlases.size();
+	stats.references = 0;
+	for (auto& entry : _skeletonData)
+		stats.references += entry.second.references;
+	stats.loads = _loads;
+	stats.hits = _hits;
+	return stats;
+}
+
+}
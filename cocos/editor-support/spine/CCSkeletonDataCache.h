@@ -0,0 +1,97 @@
+/****************************************************************************
+Copyright (c) 2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef SPINE_CCSKELETONDATACACHE_H_
+#define SPINE_CCSKELETONDATACACHE_H_
+
+#include <spine/spine.h>
+
+#include <string>
+#include <unordered_map>
+
+namespace spine {
+
+/**
+Shares the skeleton data and the atlases between the skeletons created from the same files.
+The data of a (skeleton file, atlas file, scale) triple is read once and disposed when the last skeleton
+using it is released, an atlas is shared by all the scales and skeleton files using it.
+Skeleton files can be json or binary (.skb, see tools/spine/json2skb.py), the format is detected from the content.
+*/
+class SkeletonDataCache {
+public:
+	struct Stats {
+		int skeletonDataCount;	// skeleton data in the cache
+		int atlasCount;			// atlases in the cache
+		int references;			// skeletons using the cached data
+		int loads;				// skeleton data read since the cache was created
+		int hits;				// requests served without reading any file
+	};
+
+	static SkeletonDataCache* getInstance ();
+	/* Disposes all the data, the skeletons using it must have been released. */
+	static void destroyInstance ();
+
+	/* Returns the skeleton data for the files, reading them if they are not cached, or 0 if they could not be read.
+	 * Every successful call must be balanced by a call to releaseSkeletonData().
+	 * @param scale 0 uses 1 / the content scale factor, like spine::Skeleton does. */
+	spSkeletonData* retainSkeletonData (const char* skeletonDataFile, const char* atlasFile, float scale = 0);
+	void releaseSkeletonData (spSkeletonData* skeletonData);
+
+	/* Returns the number of skeletons using the data, 0 if it is not cached. */
+	int getReferenceCount (spSkeletonData* skeletonData) const;
+
+	Stats getStats () const;
+
+	/* Reads a json or binary skeleton file, without caching it. Returns 0 and logs the error if it could not be read.
+	 * @param scale 0 uses 1 / the content scale factor. */
+	static spSkeletonData* readSkeletonDataFile (const char* skeletonDataFile, spAtlas* atlas, float scale = 0);
+
+protected:
+	SkeletonDataCache ();
+	~SkeletonDataCache ();
+
+private:
+	struct AtlasEntry {
+		spAtlas* atlas;
+		int references;
+	};
+	struct DataEntry {
+		spSkeletonData* skeletonData;
+		std::string atlasFile;
+		int references;
+	};
+
+	spAtlas* retainAtlas (const std::string& atlasFile);
+	void releaseAtlas (const std::string& atlasFile);
+
+	std::unordered_map<std::string, AtlasEntry> _atlases;
+	std::unordered_map<std::string, DataEntry> _skeletonData;
+	std::unordered_map<spSkeletonData*, std::string> _keys;
+	int _loads;
+	int _hits;
+};
+
+}
+
+#endif /* SPINE_CCSKELETONDATACACHE_H_ */
@@ -0,0 +1,562 @@
+/****************************************************************************
+Copyright (c) 2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include <spine/SkeletonBinary.h>
+#include <stdio.h>
+#include <spine/extension.h>
+#include <spine/RegionAttachment.h>
+#include <spine/AtlasAttachmentLoader.h>
+
+/* Layout of a binary skeleton, version 1. Every number is little endian.
+ *
+ *   varint       unsigned LEB128, 7 bits per byte
+ *   svarint      zigzag encoded varint
+ *   float        IEEE 754 single precision, 4 bytes
+ *   color        4 bytes, r g b a
+ *   string       varint length + 1 followed by the bytes and a NUL, or a single 0 for a null string
+ *   curve        byte 0 linear, 1 stepped, 2 bezier followed by 4 floats cx1 cy1 cx2 cy2
+ *
+ *   header       "CSKB", byte version
+ *   bones        varint count, then per bone: string name, varint parent index + 1 (0 for the root),
+ *                float length x y rotation scaleX scaleY, byte flags (1 inheritScale, 2 inheritRotation)
+ *   slots        varint count, then per slot: string name, varint bone index, byte flags (1 has color,
+ *                2 additive), color if flagged, string attachment
+ *   skins        varint count, then per skin: string name, varint slot count, then per slot: varint slot
+ *                index, varint attachment count, then per attachment: string skin name, string name
+ *                (null when it is the skin name), byte type (spAttachmentType), then for regions float
+ *                x y scaleX scaleY rotation width height, for bounding boxes varint count and the floats
+ *   events       varint count, then per event: string name, svarint int, float float, string string
+ *   animations   varint count, then per animation: string name, varint timeline count, then per timeline
+ *                a byte type and:
+ *                  0 rotate     varint bone index, varint frames, per frame float time angle, curve
+ *                  1 translate  varint bone index, varint frames, per frame float time x y, curve
+ *                  2 scale      varint bone index, varint frames, per frame float time x y, curve
+ *                  3 color      varint slot index, varint frames, per frame float time, color, curve
+ *                  4 attachment varint slot index, varint frames, per frame float time, string name
+ *                  5 event      varint frames, per frame float time, varint event index, svarint int,
+ *                               float float, string string
+ *                  6 draw order varint frames, per frame float time, byte has order, then when set
+ *                               one varint slot index per slot
+ *
+ * Lengths, positions and the bone length are stored unscaled, the scale of the reader is applied on
+ * loading like spSkeletonJson does. Names point into the loaded buffer, they are copied by the create
+ * functions of the runtime. */
+
+#define SKELETON_BINARY_VERSION 1
+
+enum {
+	BINARY_TIMELINE_ROTATE, BINARY_TIMELINE_TRANSLATE, BINARY_TIMELINE_SCALE, BINARY_TIMELINE_COLOR, BINARY_TIMELINE_ATTACHMENT, BINARY_TIMELINE_EVENT, BINARY_TIMELINE_DRAW_ORDER
+};
+
+typedef struct {
+	spSkeletonBinary super;
+	int ownsLoader;
+} _spSkeletonBinary;
+
+typedef struct {
+	const unsigned char* cursor;
+	const unsigned char* end;
+	int overflow;
+} _spDataInput;
+
+spSkeletonBinary* spSkeletonBinary_createWithLoader (spAttachmentLoader* attachmentLoader) {
+	spSkeletonBinary* self = SUPER(NEW(_spSkeletonBinary));
+	self->scale = 1;
+	self->attachmentLoader = attachmentLoader;
+	return self;
+}
+
+spSkeletonBinary* spSkeletonBinary_create (spAtlas* atlas) {
+	spAtlasAttachmentLoader* attachmentLoader = spAtlasAttachmentLoader_create(atlas);
+	spSkeletonBinary* self = spSkeletonBinary_createWithLoader(SUPER(attachmentLoader));
+	SUB_CAST(_spSkeletonBinary, self)->ownsLoader = 1;
+	return self;
+}
+
+void spSkeletonBinary_dispose (spSkeletonBinary* self) {
+	if (SUB_CAST(_spSkeletonBinary, self)->ownsLoader) spAttachmentLoader_dispose(self->attachmentLoader);
+	FREE(self->error);
+	FREE(self);
+}
+
+int spSkeletonBinary_isBinary (const unsigned char* data, int length) {
+	return length >= 5 && memcmp(data, "CSKB", 4) == 0;
+}
+
+static void _spSkeletonBinary_setError (spSkeletonBinary* self, const char* value1, const char* value2) {
+	char message[256];
+	size_t length = 0;
+	FREE(self->error);
+	strcpy(message, value1);
+	length = strlen(value1);
+	if (value2) strncat(message + length, value2, 256 - length - 1);
+	MALLOC_STR(self->error, message);
+}
+
+static int readByte (_spDataInput* input) {
+	if (input->cursor >= input->end) {
+		input->overflow = 1;
+		return 0;
+	}
+	return *input->cursor++;
+}
+
+static int readVarint (_spDataInput* input) {
+	unsigned int value = 0;
+	int shift = 0;
+	int b;
+	do {
+		b = readByte(input);
+		value |= (unsigned int)(b & 0x7f) << shift;
+		shift += 7;
+	} while ((b & 0x80) && shift < 35);
+	return (int)value;
+}
+
+static int readSignedVarint (_spDataInput* input) {
+	unsigned int value = (unsigned int)readVarint(input);
+	return (int)(value >> 1) ^ -(int)(value & 1);
+}
+
+/* Reads a count of items that are at least one byte each, so that a corrupted file can't request huge allocations. */
+static int readCount (_spDataInput* input) {
+	int count = readVarint(input);
+	if (count < 0 || count > input->end - input->cursor) {
+		input->overflow = 1;
+		return 0;
+	}
+	return count;
+}
+
+static int readIndex (_spDataInput* input, int count) {
+	int index = readVarint(input);
+	if (index < 0 || index >= count) {
+		input->overflow = 1;
+		return 0;
+	}
+	return index;
+}
+
+static float readFloat (_spDataInput* input) {
+	union {
+		unsigned int intValue;
+		float floatValue;
+	} value;
+	if (input->end - input->cursor < 4) {
+		input->overflow = 1;
+		input->cursor = input->end;
+		return 0;
+	}
+	value.intValue = input->cursor[0] | input->cursor[1] << 8 | input->cursor[2] << 16 | (unsigned int)input->cursor[3] << 24;
+	input->cursor += 4;
+	return value.floatValue;
+}
+
+static float readColor (_spDataInput* input) {
+	return readByte(input) / (float)255;
+}
+
+/* Returns a pointer into the buffer, or 0 for a null string. */
+static const char* readString (_spDataInput* input) {
+	const char* value;
+	int length = readVarint(input);
+	if (length == 0) return 0;
+	--length;
+	if (length >= input->end - input->cursor || input->cursor[length] != 0) {
+		input->overflow = 1;
+		input->cursor = input->end;
+		return 0;
+	}
+	value = (const char*)input->cursor;
+	input->cursor += length + 1;
+	return value;
+}
+
+/* Like readString(), but returns "" instead of 0 for the names that the runtime requires. */
+static const char* readName (_spDataInput* input) {
+	const char* value = readString(input);
+	return value ? value : "";
+}
+
+/* The last frame has no curve, one read for it is only skipped. */
+static void readCurve (_spDataInput* input, spCurveTimeline* timeline, int frameIndex, int frameCount) {
+	float cx1, cy1, cx2, cy2;
+	switch (readByte(input)) {
+	case 1:
+		if (frameIndex < frameCount - 1) spCurveTimeline_setStepped(timeline, frameIndex);
+		break;
+	case 2:
+		cx1 = readFloat(input);
+		cy1 = readFloat(input);
+		cx2 = readFloat(input);
+		cy2 = readFloat(input);
+		if (frameIndex < frameCount - 1) spCurveTimeline_setCurve(timeline, frameIndex, cx1, cy1, cx2, cy2);
+		break;
+	}
+}
+
+static spTimeline* _spSkeletonBinary_readTimeline (spSkeletonBinary* self, _spDataInput* input, spSkeletonData *skeletonData,
+		float* duration) {
+	int i, type = readByte(input);
+	switch (type) {
+	case BINARY_TIMELINE_ROTATE: {
+		int boneIndex = readIndex(input, skeletonData->boneCount);
+		int frameCount = readCount(input);
+		spRotateTimeline *timeline;
+		if (input->overflow || frameCount == 0) break;
+		timeline = spRotateTimeline_create(frameCount);
+		timeline->boneIndex = boneIndex;
+		for (i = 0; i < frameCount; ++i) {
+			float time = readFloat(input);
+			spRotateTimeline_setFrame(timeline, i, time, readFloat(input));
+			readCurve(input, SUPER(timeline), i, frameCount);
+		}
+		*duration = timeline->frames[frameCount * 2 - 2];
+		return (spTimeline*)timeline;
+	}
+	case BINARY_TIMELINE_TRANSLATE:
+	case BINARY_TIMELINE_SCALE: {
+		int isScale = type == BINARY_TIMELINE_SCALE;
+		float scale = isScale ? 1 : self->scale;
+		int boneIndex = readIndex(input, skeletonData->boneCount);
+		int frameCount = readCount(input);
+		spTranslateTimeline *timeline;
+		if (input->overflow || frameCount == 0) break;
+		timeline = isScale ? spScaleTimeline_create(frameCount) : spTranslateTimeline_create(frameCount);
+		timeline->boneIndex = boneIndex;
+		for (i = 0; i < frameCount; ++i) {
+			float time = readFloat(input);
+			float x = readFloat(input) * scale;
+			spTranslateTimeline_setFrame(timeline, i, time, x, readFloat(input) * scale);
+			readCurve(input, SUPER(timeline), i, frameCount);
+		}
+		*duration = timeline->frames[frameCount * 3 - 3];
+		return (spTimeline*)timeline;
+	}
+	case BINARY_TIMELINE_COLOR: {
+		int slotIndex = readIndex(input, skeletonData->slotCount);
+		int frameCount = readCount(input);
+		spColorTimeline *timeline;
+		if (input->overflow || frameCount == 0) break;
+		timeline = spColorTimeline_create(frameCount);
+		timeline->slotIndex = slotIndex;
+		for (i = 0; i < frameCount; ++i) {
+			float time = readFloat(input);
+			float r = readColor(input);
+			float g = readColor(input);
+			float b = readColor(input);
+			spColorTimeline_setFrame(timeline, i, time, r, g, b, readColor(input));
+			readCurve(input, SUPER(timeline), i, frameCount);
+		}
+		*duration = timeline->frames[frameCount * 5 - 5];
+		return (spTimeline*)timeline;
+	}
+	case BINARY_TIMELINE_ATTACHMENT: {
+		int slotIndex = readIndex(input, skeletonData->slotCount);
+		int frameCount = readCount(input);
+		spAttachmentTimeline *timeline;
+		if (input->overflow || frameCount == 0) break;
+		timeline = spAttachmentTimeline_create(frameCount);
+		timeline->slotIndex = slotIndex;
+		for (i = 0; i < frameCount; ++i) {
+			float time = readFloat(input);
+			spAttachmentTimeline_setFrame(timeline, i, time, readString(input));
+		}
+		*duration = timeline->frames[frameCount - 1];
+		return (spTimeline*)timeline;
+	}
+	case BINARY_TIMELINE_EVENT: {
+		int frameCount = readCount(input);
+		spEventTimeline* timeline;
+		if (input->overflow || frameCount == 0) break;
+		timeline = spEventTimeline_create(frameCount);
+		for (i = 0; i < frameCount; ++i) {
+			const char* stringValue;
+			spEvent* event;
+			float time = readFloat(input);
+			int eventIndex = readIndex(input, skeletonData->eventCount);
+			if (input->overflow) {
+				/* Only the frames read so far have an event to dispose. */
+				CONST_CAST(int, timeline->framesLength) = i;
+				spTimeline_dispose(SUPER(timeline));
+				return 0;
+			}
+			event = spEvent_create(skeletonData->events[eventIndex]);
+			event->intValue = readSignedVarint(input);
+			event->floatValue = readFloat(input);
+			stringValue = readString(input);
+			if (stringValue) MALLOC_STR(event->stringValue, stringValue);
+			spEventTimeline_setFrame(timeline, i, time, event);
+		}
+		*duration = timeline->frames[frameCount - 1];
+		return (spTimeline*)timeline;
+	}
+	case BINARY_TIMELINE_DRAW_ORDER: {
+		int frameCount = readCount(input);
+		int* drawOrder;
+		spDrawOrderTimeline* timeline;
+		if (input->overflow || frameCount == 0) break;
+		timeline = spDrawOrderTimeline_create(frameCount, skeletonData->slotCount);
+		drawOrder = MALLOC(int, skeletonData->slotCount);
+		for (i = 0; i < frameCount; ++i) {
+			int ii;
+			float time = readFloat(input);
+			int hasDrawOrder = readByte(input);
+			for (ii = 0; hasDrawOrder && ii < skeletonData->slotCount; ++ii)
+				drawOrder[ii] = readIndex(input, skeletonData->slotCount);
+			spDrawOrderTimeline_setFrame(timeline, i, time, hasDrawOrder ? drawOrder : 0);
+		}
+		FREE(drawOrder);
+		*duration = timeline->frames[frameCount - 1];
+		return (spTimeline*)timeline;
+	}
+	}
+	/* Unknown timeline type, missing frames or truncated data. */
+	input->overflow = 1;
+	return 0;
+}
+
+static spAnimation* _spSkeletonBinary_readAnimation (spSkeletonBinary* self, _spDataInput* input, spSkeletonData *skeletonData) {
+	const char* name = readName(input);
+	int timelineCount = readCount(input);
+	spAnimation* animation = spAnimation_create(name, timelineCount);
+	animation->timelineCount = 0;
+	skeletonData->animations[skeletonData->animationCount] = animation;
+	++skeletonData->animationCount;
+
+	while (animation->timelineCount < timelineCount) {
+		float duration = 0;
+		spTimeline* timeline = _spSkeletonBinary_readTimeline(self, input, skeletonData, &duration);
+		if (!timeline) return 0;
+		animation->timelines[animation->timelineCount++] = timeline;
+		if (duration > animation->duration) animation->duration = duration;
+	}
+	return animation;
+}
+
+static int _spSkeletonBinary_readAttachment (spSkeletonBinary* self, _spDataInput* input, spSkin* skin, int slotIndex) {
+	int i;
+	spAttachment* attachment;
+	const char* skinAttachmentName = readName(input);
+	const char* attachmentName = readString(input);
+	spAttachmentType type = (spAttachmentType)readByte(input);
+	float x = 0, y = 0, scaleX = 1, scaleY = 1, rotation = 0, width = 0, height = 0;
+	float* vertices = 0;
+	int verticesCount = 0;
+
+	if (!attachmentName) attachmentName = skinAttachmentName;
+
+	/* The attributes are read before creating the attachment, so that skipped attachments leave the input in sync. */
+	switch (type) {
+	case ATTACHMENT_REGION:
+	case ATTACHMENT_REGION_SEQUENCE:
+		x = readFloat(input) * self->scale;
+		y = readFloat(input) * self->scale;
+		scaleX = readFloat(input);
+		scaleY = readFloat(input);
+		rotation = readFloat(input);
+		width = readFloat(input) * self->scale;
+		height = readFloat(input) * self->scale;
+		break;
+	case ATTACHMENT_BOUNDING_BOX:
+		verticesCount = readCount(input);
+		if (input->overflow) return 0;
+		vertices = MALLOC(float, verticesCount);
+		for (i = 0; i < verticesCount; ++i)
+			vertices[i] = readFloat(input) * self->scale;
+		break;
+	default:
+		_spSkeletonBinary_setError(self, "Unknown attachment type: ", attachmentName);
+		return 0;
+	}
+	if (input->overflow) {
+		FREE(vertices);
+		return 0;
+	}
+
+	attachment = spAttachmentLoader_newAttachment(self->attachmentLoader, skin, type, attachmentName);
+	if (!attachment) {
+		FREE(vertices);
+		if (self->attachmentLoader->error1) {
+			_spSkeletonBinary_setError(self, self->attachmentLoader->error1, self->attachmentLoader->error2);
+			return 0;
+		}
+		return 1;
+	}
+
+	switch (attachment->type) {
+	case ATTACHMENT_REGION:
+	case ATTACHMENT_REGION_SEQUENCE: {
+		spRegionAttachment* regionAttachment = (spRegionAttachment*)attachment;
+		regionAttachment->x = x;
+		regionAttachment->y = y;
+		regionAttachment->scaleX = scaleX;
+		regionAttachment->scaleY = scaleY;
+		regionAttachment->rotation = rotation;
+		regionAttachment->width = width;
+		regionAttachment->height = height;
+		spRegionAttachment_updateOffset(regionAttachment);
+		break;
+	}
+	case ATTACHMENT_BOUNDING_BOX: {
+		spBoundingBoxAttachment* box = (spBoundingBoxAttachment*)attachment;
+		box->verticesCount = verticesCount;
+		box->vertices = vertices;
+		vertices = 0;
+		break;
+	}
+	}
+	FREE(vertices);
+
+	spSkin_addAttachment(skin, slotIndex, skinAttachmentName, attachment);
+	return 1;
+}
+
+spSkeletonData* spSkeletonBinary_readSkeletonDataFile (spSkeletonBinary* self, const char* path) {
+	int length;
+	spSkeletonData* skeletonData;
+	const char* binary = _spUtil_readFile(path, &length);
+	if (!binary) {
+		_spSkeletonBinary_setError(self, "Unable to read skeleton file: ", path);
+		return 0;
+	}
+	skeletonData = spSkeletonBinary_readSkeletonData(self, (const unsigned char*)binary, length);
+	FREE(binary);
+	return skeletonData;
+}
+
+spSkeletonData* spSkeletonBinary_readSkeletonData (spSkeletonBinary* self, const unsigned char* binary, int length) {
+	int i, ii, count;
+	spSkeletonData* skeletonData;
+	_spDataInput input;
+
+	FREE(self->error);
+	CONST_CAST(char*, self->error) = 0;
+
+	if (!spSkeletonBinary_isBinary(binary, length)) {
+		_spSkeletonBinary_setError(self, "Invalid binary skeleton: ", "bad magic");
+		return 0;
+	}
+	if (binary[4] != SKELETON_BINARY_VERSION) {
+		_spSkeletonBinary_setError(self, "Invalid binary skeleton: ", "unsupported version");
+		return 0;
+	}
+	input.cursor = binary + 5;
+	input.end = binary + length;
+	input.overflow = 0;
+
+	skeletonData = spSkeletonData_create();
+
+	count = readCount(&input);
+	skeletonData->bones = MALLOC(spBoneData*, count);
+	for (i = 0; i < count && !input.overflow; ++i) {
+		spBoneData* boneData;
+		int flags;
+		const char* name = readName(&input);
+		int parentIndex = readIndex(&input, i + 1) - 1;
+
+		boneData = spBoneData_create(name, parentIndex < 0 ? 0 : skeletonData->bones[parentIndex]);
+		boneData->length = readFloat(&input) * self->scale;
+		boneData->x = readFloat(&input) * self->scale;
+		boneData->y = readFloat(&input) * self->scale;
+		boneData->rotation = readFloat(&input);
+		boneData->scaleX = readFloat(&input);
+		boneData->scaleY = readFloat(&input);
+		flags = readByte(&input);
+		boneData->inheritScale = (flags & 1) != 0;
+		boneData->inheritRotation = (flags & 2) != 0;
+
+		skeletonData->bones[i] = boneData;
+		++skeletonData->boneCount;
+	}
+
+	count = readCount(&input);
+	skeletonData->slots = MALLOC(spSlotData*, count);
+	for (i = 0; i < count && !input.overflow; ++i) {
+		spSlotData* slotData;
+		const char* attachmentName;
+		int flags;
+		const char* name = readName(&input);
+		int boneIndex = readIndex(&input, skeletonData->boneCount);
+		if (input.overflow) break;
+
+		slotData = spSlotData_create(name, skeletonData->bones[boneIndex]);
+		flags = readByte(&input);
+		if (flags & 1) {
+			slotData->r = readColor(&input);
+			slotData->g = readColor(&input);
+			slotData->b = readColor(&input);
+			slotData->a = readColor(&input);
+		}
+		attachmentName = readString(&input);
+		if (attachmentName) spSlotData_setAttachmentName(slotData, attachmentName);
+		slotData->additiveBlending = (flags & 2) != 0;
+
+		skeletonData->slots[i] = slotData;
+		++skeletonData->slotCount;
+	}
+
+	count = readCount(&input);
+	skeletonData->skins = MALLOC(spSkin*, count);
+	for (i = 0; i < count && !input.overflow && !self->error; ++i) {
+		int slotCount;
+		spSkin *skin = spSkin_create(readName(&input));
+
+		skeletonData->skins[i] = skin;
+		++skeletonData->skinCount;
+		if (strcmp(skin->name, "default") == 0) skeletonData->defaultSkin = skin;
+
+		slotCount = readCount(&input);
+		for (ii = 0; ii < slotCount && !input.overflow && !self->error; ++ii) {
+			int slotIndex = readIndex(&input, skeletonData->slotCount);
+			int attachmentCount = readCount(&input);
+			while (attachmentCount-- > 0 && !input.overflow)
+				if (!_spSkeletonBinary_readAttachment(self, &input, skin, slotIndex)) break;
+		}
+	}
+
+	count = readCount(&input);
+	skeletonData->events = MALLOC(spEventData*, count);
+	for (i = 0; i < count && !input.overflow && !self->error; ++i) {
+		const char* stringValue;
+		spEventData* eventData = spEventData_create(readName(&input));
+		eventData->intValue = readSignedVarint(&input);
+		eventData->floatValue = readFloat(&input);
+		stringValue = readString(&input);
+		if (stringValue) MALLOC_STR(eventData->stringValue, stringValue);
+		skeletonData->events[skeletonData->eventCount++] = eventData;
+	}
+
+	count = readCount(&input);
+	skeletonData->animations = MALLOC(spAnimation*, count);
+	for (i = 0; i < count && !input.overflow && !self->error; ++i)
+		if (!_spSkeletonBinary_readAnimation(self, &input, skeletonData)) break;
+
+	if (input.overflow || self->error) {
+		if (!self->error) _spSkeletonBinary_setError(self, "Invalid binary skeleton: ", "truncated or corrupted data");
+		spSkeletonData_dispose(skeletonData);
+		return 0;
+	}
+	return skeletonData;
+}
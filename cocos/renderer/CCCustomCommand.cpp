@@ -28,6 +28,8 @@ NS_CC_BEGIN
 
 CustomCommand::CustomCommand()
 : func(nullptr)
+, _callback(nullptr)
+, _callbackData(nullptr)
 {
     _type = RenderCommand::Type::CUSTOM_COMMAND;
 }
@@ -35,6 +37,8 @@ CustomCommand::CustomCommand()
 void CustomCommand::init(float globalOrder)
 {
     _globalOrder = globalOrder;
+    _callback = nullptr;
+    _callbackData = nullptr;
 }
 
 CustomCommand::~CustomCommand()
@@ -44,7 +48,11 @@ CustomCommand::~CustomCommand()
 
 void CustomCommand::execute()
 {
-    if(func)
+    if(_callback)
+    {
+        _callback(_callbackData);
+    }
+    else if(func)
     {
         func();
     }
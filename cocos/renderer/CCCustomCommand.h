@@ -28,6 +28,7 @@
 
 #include "CCRenderCommand.h"
 #include "CCRenderCommandPool.h"
+#include <functional>
 
 NS_CC_BEGIN
 
@@ -41,12 +42,34 @@ public:
 
     void init(float depth);
 
+    /** Initializes the command to call 'callback' when executed.
+     The callback is copied into the frame arena of the renderer and destroyed at the end of the frame,
+     unlike a std::function assigned to 'func' which may allocate from the heap at every frame.
+     */
+    template <typename Callback>
+    void init(float depth, RenderFrameArena& arena, Callback&& callback)
+    {
+        typedef typename std::decay<Callback>::type Functor;
+        init(depth);
+        _callbackData = arena.create(std::forward<Callback>(callback));
+        _callback = &invoke<Functor>;
+    }
+
     void execute();
 
     inline bool isTranslucent() { return true; }
     std::function<void()> func;
 
 protected:
+    template <typename Functor>
+    static void invoke(void* data)
+    {
+        (*static_cast<Functor*>(data))();
+    }
+
+    // type erased callback stored in the frame arena, called instead of 'func' when set
+    void (*_callback)(void*);
+    void* _callbackData;
 };
 
 NS_CC_END
@@ -27,6 +27,7 @@
 #include "renderer/ccGLStateCache.h"
 #include "renderer/CCGLProgram.h"
 #include "renderer/CCGLProgramState.h"
+#include "2d/CCTexture2D.h"
 #include "xxhash.h"
 
 NS_CC_BEGIN
@@ -89,6 +90,7 @@ void QuadCommand::useMaterial() const
 {
     //Set texture
     GL::bindTexture2D(_textureID);
+    Texture2D::markUsed(_textureID);
 
     //set blend mode
     GL::blendFunc(_blendType.src, _blendType.dst);
@@ -28,6 +28,10 @@
 
 #include <set>
 #include <list>
+#include <new>
+#include <cstdlib>
+#include <type_traits>
+#include <utility>
 #include "base/CCPlatformMacros.h"
 NS_CC_BEGIN
 
@@ -95,6 +99,186 @@ private:
     //std::set<T*> _usedPool;
 };
 
+/** Linear allocator for the render commands and payloads that only live for one frame.
+ Renderer::clean() resets it once the frame is rendered: the destructors of the objects are called and
+ the memory is reused by the next frame, so nothing is allocated from the heap once the arena has grown
+ to the size of a frame.
+ */
+class RenderFrameArena
+{
+public:
+    explicit RenderFrameArena(size_t blockSize = 64 * 1024)
+    : _blocks(nullptr)
+    , _blockSize(blockSize)
+    , _destructors(nullptr)
+    , _allocations(0)
+    , _bytes(0)
+    , _heapAllocations(0)
+    , _lastAllocations(0)
+    , _lastBytes(0)
+    , _lastHeapAllocations(0)
+    {
+    }
+
+    ~RenderFrameArena()
+    {
+        reset();
+        freeBlocks();
+    }
+
+    /** Returns 'size' bytes aligned on 'alignment', a power of two, valid until the next reset() */
+    void* allocate(size_t size, size_t alignment)
+    {
+        ++_allocations;
+        _bytes += size;
+        return allocateRaw(size, alignment);
+    }
+
+    /** Copies or moves 'value' into the arena. Its destructor is called by reset() */
+    template <typename T>
+    typename std::decay<T>::type* create(T&& value)
+    {
+        typedef typename std::decay<T>::type Type;
+        void* memory = allocate(sizeof(Type), std::alignment_of<Type>::value);
+        Type* object = new (memory) Type(std::forward<T>(value));
+        addDestructor(object, &destroy<Type>);
+        return object;
+    }
+
+    /** Default constructs a T in the arena. Its destructor is called by reset() */
+    template <typename T>
+    T* create()
+    {
+        void* memory = allocate(sizeof(T), std::alignment_of<T>::value);
+        T* object = new (memory) T();
+        addDestructor(object, &destroy<T>);
+        return object;
+    }
+
+    /** Destroys the objects of the frame, in the reverse order of their creation, and rewinds the arena */
+    void reset()
+    {
+        for (Destructor* destructor = _destructors; destructor; destructor = destructor->next)
+        {
+            destructor->function(destructor->object);
+        }
+        _destructors = nullptr;
+
+        // the frame needed several blocks: replace them by one block big enough for the next frames
+        if (_blocks && _blocks->next)
+        {
+            size_t size = 0;
+            for (Block* block = _blocks; block; block = block->next)
+            {
+                size += block->size;
+            }
+            freeBlocks();
+            _blockSize = size;
+        }
+        if (_blocks)
+        {
+            _blocks->used = 0;
+        }
+
+        _lastAllocations = _allocations;
+        _lastBytes = _bytes;
+        _lastHeapAllocations = _heapAllocations;
+        _allocations = _bytes = _heapAllocations = 0;
+    }
+
+    /** Number of allocations, bytes and blocks allocated from the heap during the last frame */
+    size_t getLastFrameAllocations() const { return _lastAllocations; }
+    size_t getLastFrameBytes() const { return _lastBytes; }
+    size_t getLastFrameHeapAllocations() const { return _lastHeapAllocations; }
+
+private:
+    struct Block
+    {
+        Block* next;
+        size_t size;
+        size_t used;
+        unsigned char* data() { return reinterpret_cast<unsigned char*>(this + 1); }
+    };
+
+    struct Destructor
+    {
+        void (*function)(void*);
+        void* object;
+        Destructor* next;
+    };
+
+    template <typename T>
+    static void destroy(void* object)
+    {
+        static_cast<T*>(object)->~T();
+    }
+
+    static size_t alignUp(size_t value, size_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    void* allocateRaw(size_t size, size_t alignment)
+    {
+        Block* block = _blocks;
+        if (block)
+        {
+            size_t start = alignUp(reinterpret_cast<size_t>(block->data()) + block->used, alignment);
+            size_t end = start + size - reinterpret_cast<size_t>(block->data());
+            if (end <= block->size)
+            {
+                block->used = end;
+                return reinterpret_cast<void*>(start);
+            }
+        }
+
+        size_t blockSize = _blockSize > size + alignment ? _blockSize : size + alignment;
+        block = static_cast<Block*>(malloc(sizeof(Block) + blockSize));
+        block->next = _blocks;
+        block->size = blockSize;
+        _blocks = block;
+        ++_heapAllocations;
+
+        size_t start = alignUp(reinterpret_cast<size_t>(block->data()), alignment);
+        block->used = start + size - reinterpret_cast<size_t>(block->data());
+        return reinterpret_cast<void*>(start);
+    }
+
+    // the destructors are bookkeeping of the arena, not counted in the statistics
+    void addDestructor(void* object, void (*function)(void*))
+    {
+        Destructor* destructor = static_cast<Destructor*>(allocateRaw(sizeof(Destructor), std::alignment_of<Destructor>::value));
+        destructor->function = function;
+        destructor->object = object;
+        destructor->next = _destructors;
+        _destructors = destructor;
+    }
+
+    void freeBlocks()
+    {
+        while (_blocks)
+        {
+            Block* next = _blocks->next;
+            free(_blocks);
+            _blocks = next;
+        }
+    }
+
+    Block* _blocks;
+    size_t _blockSize;
+    Destructor* _destructors;
+
+    size_t _allocations;
+    size_t _bytes;
+    size_t _heapAllocations;
+    size_t _lastAllocations;
+    size_t _lastBytes;
+    size_t _lastHeapAllocations;
+
+    RenderFrameArena(const RenderFrameArena&);
+    RenderFrameArena& operator=(const RenderFrameArena&);
+};
+
 NS_CC_END
 
 #endif
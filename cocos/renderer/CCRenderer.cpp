@@ -27,6 +27,7 @@
 #include <algorithm>
 
 #include "renderer/CCQuadCommand.h"
+#include "renderer/CCTrianglesCommand.h"
 #include "renderer/CCBatchCommand.h"
 #include "renderer/CCCustomCommand.h"
 #include "renderer/CCGroupCommand.h"
@@ -37,6 +38,7 @@
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventType.h"
+#include "base/CCProfiling.h"
 
 NS_CC_BEGIN
 
@@ -108,7 +110,11 @@ static const int DEFAULT_RENDER_QUEUE = 0;
 Renderer::Renderer()
 :_lastMaterialID(0)
 ,_numQuads(0)
+,_numTriangleVertices(0)
+,_numTriangleIndices(0)
 ,_glViewAssigned(false)
+,_culledNodes(0)
+,_lastCulledNodes(0)
 ,_isRendering(false)
 #if CC_ENABLE_CACHE_TEXTURE_DATA
 ,_cacheTextureListener(nullptr)
@@ -121,6 +127,7 @@ Renderer::Renderer()
     RenderQueue defaultRenderQueue;
     _renderGroups.push_back(defaultRenderQueue);
     _batchedQuadCommands.reserve(BATCH_QUADCOMMAND_RESEVER_SIZE);
+    _batchedTrianglesCommands.reserve(BATCH_QUADCOMMAND_RESEVER_SIZE);
 }
 
 Renderer::~Renderer()
@@ -129,10 +136,12 @@ Renderer::~Renderer()
     _groupCommandManager->release();
     
     glDeleteBuffers(2, _buffersVBO);
+    glDeleteBuffers(2, _trianglesBuffersVBO);
     
     if (Configuration::getInstance()->supportsShareableVAO())
     {
         glDeleteVertexArrays(1, &_quadVAO);
+        glDeleteVertexArrays(1, &_trianglesVAO);
         GL::bindVAO(0);
     }
 #if CC_ENABLE_CACHE_TEXTURE_DATA
@@ -213,12 +222,38 @@ void Renderer::setupVBOAndVAO()
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 
+    // triangles
+    glGenVertexArrays(1, &_trianglesVAO);
+    GL::bindVAO(_trianglesVAO);
+
+    glGenBuffers(2, &_trianglesBuffersVBO[0]);
+
+    glBindBuffer(GL_ARRAY_BUFFER, _trianglesBuffersVBO[0]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(_triangleVertices[0]) * TRIANGLES_VBO_SIZE, nullptr, GL_DYNAMIC_DRAW);
+
+    glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_POSITION);
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, sizeof(V2F_C4B_T2F), (GLvoid*) offsetof(V2F_C4B_T2F, vertices));
+
+    glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_COLOR);
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V2F_C4B_T2F), (GLvoid*) offsetof(V2F_C4B_T2F, colors));
+
+    glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_TEX_COORD);
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V2F_C4B_T2F), (GLvoid*) offsetof(V2F_C4B_T2F, texCoords));
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _trianglesBuffersVBO[1]);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_triangleIndices[0]) * TRIANGLES_INDEX_VBO_SIZE, nullptr, GL_DYNAMIC_DRAW);
+
+    GL::bindVAO(0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
     CHECK_GL_ERROR_DEBUG();
 }
 
 void Renderer::setupVBO()
 {
     glGenBuffers(2, &_buffersVBO[0]);
+    glGenBuffers(2, &_trianglesBuffersVBO[0]);
 
     mapBuffers();
 }
@@ -236,6 +271,14 @@ void Renderer::mapBuffers()
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * VBO_SIZE * 6, _indices, GL_STATIC_DRAW);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
+    glBindBuffer(GL_ARRAY_BUFFER, _trianglesBuffersVBO[0]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(_triangleVertices[0]) * TRIANGLES_VBO_SIZE, nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _trianglesBuffersVBO[1]);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_triangleIndices[0]) * TRIANGLES_INDEX_VBO_SIZE, nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
     CHECK_GL_ERROR_DEBUG();
 }
 
@@ -282,6 +325,9 @@ void Renderer::visitRenderQueue(const RenderQueue& queue)
         auto commandType = command->getType();
         if(RenderCommand::Type::QUAD_COMMAND == commandType)
         {
+            // keep the drawing order with the batched triangles
+            drawBatchedTriangles();
+
             auto cmd = static_cast<QuadCommand*>(command);
             //Batch quads
             if(_numQuads + cmd->getQuadCount() > VBO_SIZE)
@@ -300,6 +346,47 @@ void Renderer::visitRenderQueue(const RenderQueue& queue)
             _numQuads += cmd->getQuadCount();
 
         }
+        else if(RenderCommand::Type::TRIANGLES_COMMAND == commandType)
+        {
+            // keep the drawing order with the batched quads
+            drawBatchedQuads();
+
+            auto cmd = static_cast<TrianglesCommand*>(command);
+            CCASSERT(cmd->getVertexCount() <= TRIANGLES_VBO_SIZE && cmd->getIndexCount() <= TRIANGLES_INDEX_VBO_SIZE,
+                     "VBO is not big enough for triangles data, please break the data down or use customized render command");
+
+            //Draw batched triangles if VBO is full
+            if(_numTriangleVertices + cmd->getVertexCount() > TRIANGLES_VBO_SIZE ||
+               _numTriangleIndices + cmd->getIndexCount() > TRIANGLES_INDEX_VBO_SIZE)
+            {
+                drawBatchedTriangles();
+            }
+
+            _batchedTrianglesCommands.push_back(cmd);
+
+            // convert the vertices to world coordinates, and the indices to the batch
+            const Mat4& mv = cmd->getModelView();
+            const V2F_C4B_T2F* vertices = cmd->getVertices();
+            V2F_C4B_T2F* dstVertices = _triangleVertices + _numTriangleVertices;
+            for(ssize_t i = 0; i < cmd->getVertexCount(); ++i)
+            {
+                const Vec2& v = vertices[i].vertices;
+                dstVertices[i].vertices.x = mv.m[0] * v.x + mv.m[4] * v.y + mv.m[12];
+                dstVertices[i].vertices.y = mv.m[1] * v.x + mv.m[5] * v.y + mv.m[13];
+                dstVertices[i].colors = vertices[i].colors;
+                dstVertices[i].texCoords = vertices[i].texCoords;
+            }
+
+            const GLushort* indices = cmd->getIndices();
+            GLushort* dstIndices = _triangleIndices + _numTriangleIndices;
+            for(ssize_t i = 0; i < cmd->getIndexCount(); ++i)
+            {
+                dstIndices[i] = (GLushort)(indices[i] + _numTriangleVertices);
+            }
+
+            _numTriangleVertices += cmd->getVertexCount();
+            _numTriangleIndices += cmd->getIndexCount();
+        }
         else if(RenderCommand::Type::GROUP_COMMAND == commandType)
         {
             flush();
@@ -327,6 +414,8 @@ void Renderer::visitRenderQueue(const RenderQueue& queue)
 
 void Renderer::render()
 {
+    CC_PROFILER_SCOPE("Renderer - render");
+
     //Uncomment this once everything is rendered by new renderer
     //glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -368,7 +457,18 @@ void Renderer::clean()
     _batchedQuadCommands.clear();
     _numQuads = 0;
 
+    _batchedTrianglesCommands.clear();
+    _numTriangleVertices = 0;
+    _numTriangleIndices = 0;
+
     _lastMaterialID = 0;
+
+    // the commands of the frame are executed, their arena can be reused
+    _frameArena.reset();
+
+    // the nodes are culled while visiting, before render()
+    _lastCulledNodes = _culledNodes;
+    _culledNodes = 0;
 }
 
 void Renderer::convertToWorldCoordinates(V3F_C4B_T2F_Quad* quads, ssize_t quantity, const Mat4& modelView)
@@ -395,6 +495,8 @@ void Renderer::convertToWorldCoordinates(V3F_C4B_T2F_Quad* quads, ssize_t quanti
 
 void Renderer::drawBatchedQuads()
 {
+    CC_PROFILER_SCOPE("Renderer - drawBatchedQuads");
+
     //TODO we can improve the draw performance by insert material switching command before hand.
 
     int quadsToDraw = 0;
@@ -497,26 +599,119 @@ void Renderer::drawBatchedQuads()
     _numQuads = 0;
 }
 
+void Renderer::drawBatchedTriangles()
+{
+    CC_PROFILER_SCOPE("Renderer - drawBatchedTriangles");
+
+    if(_numTriangleIndices <= 0 || _batchedTrianglesCommands.empty())
+    {
+        return;
+    }
+
+    int indicesToDraw = 0;
+    int startIndex = 0;
+
+    //Upload buffers, orphaning the previous ones
+    glBindBuffer(GL_ARRAY_BUFFER, _trianglesBuffersVBO[0]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(_triangleVertices[0]) * _numTriangleVertices, _triangleVertices, GL_DYNAMIC_DRAW);
+
+    if (Configuration::getInstance()->supportsShareableVAO())
+    {
+        //Bind VAO, it has the element buffer
+        GL::bindVAO(_trianglesVAO);
+    }
+    else
+    {
+#define kTriangleVertexSize sizeof(_triangleVertices[0])
+        GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
+
+        // vertices
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, kTriangleVertexSize, (GLvoid*) offsetof(V2F_C4B_T2F, vertices));
+
+        // colors
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, kTriangleVertexSize, (GLvoid*) offsetof(V2F_C4B_T2F, colors));
+
+        // tex coords
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, kTriangleVertexSize, (GLvoid*) offsetof(V2F_C4B_T2F, texCoords));
+    }
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _trianglesBuffersVBO[1]);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_triangleIndices[0]) * _numTriangleIndices, _triangleIndices, GL_DYNAMIC_DRAW);
+
+    //Start drawing vertices in batch
+    for(const auto& cmd : _batchedTrianglesCommands)
+    {
+        auto newMaterialID = cmd->getMaterialID();
+        if(_lastMaterialID != newMaterialID || newMaterialID == TrianglesCommand::MATERIAL_ID_DO_NOT_BATCH)
+        {
+            if(indicesToDraw > 0)
+            {
+                glDrawElements(GL_TRIANGLES, (GLsizei) indicesToDraw, GL_UNSIGNED_SHORT, (GLvoid*) (startIndex*sizeof(_triangleIndices[0])) );
+                _drawnBatches++;
+                _drawnVertices += indicesToDraw;
+
+                startIndex += indicesToDraw;
+                indicesToDraw = 0;
+            }
+
+            //Use new material
+            cmd->useMaterial();
+            _lastMaterialID = newMaterialID;
+        }
+
+        indicesToDraw += (int)cmd->getIndexCount();
+    }
+
+    //Draw any remaining triangle
+    if(indicesToDraw > 0)
+    {
+        glDrawElements(GL_TRIANGLES, (GLsizei) indicesToDraw, GL_UNSIGNED_SHORT, (GLvoid*) (startIndex*sizeof(_triangleIndices[0])) );
+        _drawnBatches++;
+        _drawnVertices += indicesToDraw;
+    }
+
+    if (Configuration::getInstance()->supportsShareableVAO())
+    {
+        //Unbind VAO
+        GL::bindVAO(0);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    _batchedTrianglesCommands.clear();
+    _numTriangleVertices = 0;
+    _numTriangleIndices = 0;
+
+    // the quads drawn next must set their material again
+    _lastMaterialID = 0;
+}
+
 void Renderer::flush()
 {
     drawBatchedQuads();
+    drawBatchedTriangles();
     _lastMaterialID = 0;
 }
 
 // helpers
 
 bool Renderer::checkVisibility(const Mat4 &transform, const Size &size)
+{
+    return checkVisibility(transform, Rect(0, 0, size.width, size.height));
+}
+
+bool Renderer::checkVisibility(const Mat4 &transform, const Rect &rect)
 {
     // half size of the screen
     Size screen_half = Director::getInstance()->getWinSize();
     screen_half.width /= 2;
     screen_half.height /= 2;
 
-    float hSizeX = size.width/2;
-    float hSizeY = size.height/2;
+    float hSizeX = rect.size.width/2;
+    float hSizeY = rect.size.height/2;
 
     Vec4 v4world, v4local;
-    v4local.set(hSizeX, hSizeY, 0, 1);
+    v4local.set(rect.origin.x + hSizeX, rect.origin.y + hSizeY, 0, 1);
     transform.transformVector(v4local, &v4world);
 
     // center of screen is (0,0)
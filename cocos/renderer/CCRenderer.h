@@ -28,6 +28,8 @@
 
 #include "base/CCPlatformMacros.h"
 #include "CCRenderCommand.h"
+#include "renderer/CCRenderCommandPool.h"
+#include "renderer/CCCustomCommand.h"
 #include "renderer/CCGLProgram.h"
 #include "CCGL.h"
 #include <vector>
@@ -37,6 +39,7 @@ NS_CC_BEGIN
 
 class EventListenerCustom;
 class QuadCommand;
+class TrianglesCommand;
 
 /**  一个知道如何对RenderCommand对象排序的类。
    因为具有 "z == 0"的命令会被加入到正确的顺序里，唯一需要被排序的RenderCommand对象是那些 'z < 0 '和'z > 0 '的对象。
@@ -72,6 +75,9 @@ class Renderer
 public:
     static const int VBO_SIZE = 65536 / 6;
     static const int BATCH_QUADCOMMAND_RESEVER_SIZE = 64;
+    /* Size of the buffers used to batch TrianglesCommand objects, in vertices */
+    static const int TRIANGLES_VBO_SIZE = 65536 / 4;
+    static const int TRIANGLES_INDEX_VBO_SIZE = TRIANGLES_VBO_SIZE * 3;
 
     Renderer();
     ~Renderer();
@@ -108,11 +114,37 @@ public:
     ssize_t getDrawnVertices() const { return _drawnVertices; }
     /* RenderCommand对象(除了QuadCommand对象)应该更新这个值 */
     void addDrawnVertices(ssize_t number) { _drawnVertices += number; };
+    /* 返回上一帧(frame)因为子树(subtree)在屏幕外而没有被访问(visit)的节点数目 */
+    ssize_t getCulledNodes() const { return _lastCulledNodes; }
+    /* 开启了子树裁剪(subtree culling)的节点在跳过一个子树时更新这个值 */
+    void addCulledNodes(ssize_t number) { _culledNodes += number; }
+
+    /** 返回每帧的线性分配器(arena)。渲染命令和它们的数据可以在里面分配，clean()会销毁它们并重用内存 */
+    RenderFrameArena& getFrameArena() { return _frameArena; }
+    /* 返回上一帧(frame)在arena里分配的次数 */
+    ssize_t getFrameAllocations() const { return _frameArena.getLastFrameAllocations(); }
+    /* 返回上一帧(frame)在arena里分配的字节数 */
+    ssize_t getFrameAllocatedBytes() const { return _frameArena.getLastFrameBytes(); }
+    /* 返回上一帧(frame)arena向堆(heap)申请内存的次数，稳定后应该是0 */
+    ssize_t getFrameHeapAllocations() const { return _frameArena.getLastFrameHeapAllocations(); }
+
+    /** 在这一帧的arena里创建一个CustomCommand并把它加入渲染器，命令和回调(callback)在帧结束时被销毁。
+     适合一帧里可能被访问(visit)多次的节点，它们不能重用自己的命令。
+     */
+    template <typename Callback>
+    void addCustomCommand(float globalOrder, Callback&& callback)
+    {
+        CustomCommand* command = _frameArena.create<CustomCommand>();
+        command->init(globalOrder, _frameArena, std::forward<Callback>(callback));
+        addCommand(command);
+    }
 
     inline GroupCommandManager* getGroupCommandManager() const { return _groupCommandManager; };
 
     /** 返回一个矩形是否可见 */
     bool checkVisibility(const Mat4& transform, const Size& size);
+    /** 返回一个矩形是否可见，矩形不需要从原点开始 */
+    bool checkVisibility(const Mat4& transform, const Rect& rect);
 
 protected:
 
@@ -124,6 +156,7 @@ protected:
     void mapBuffers();
 
     void drawBatchedQuads();
+    void drawBatchedTriangles();
 
     //去除（flush）之前的环境上下文(context),画预览被放进队列中得quads
     void flush();
@@ -146,12 +179,27 @@ protected:
     GLuint _buffersVBO[2]; //0: 顶点  1: 索引
 
     int _numQuads;
+
+    std::vector<TrianglesCommand*> _batchedTrianglesCommands;
+
+    V2F_C4B_T2F _triangleVertices[TRIANGLES_VBO_SIZE];
+    GLushort _triangleIndices[TRIANGLES_INDEX_VBO_SIZE];
+    GLuint _trianglesVAO;
+    GLuint _trianglesBuffersVBO[2]; //0: vertex  1: indices
+
+    int _numTriangleVertices;
+    int _numTriangleIndices;
     
     bool _glViewAssigned;
 
+    //每帧的渲染命令和数据
+    RenderFrameArena _frameArena;
+
     // stats
     ssize_t _drawnBatches;
     ssize_t _drawnVertices;
+    ssize_t _culledNodes;
+    ssize_t _lastCulledNodes;
     //检查渲染器是否正在渲染的标记
     bool _isRendering;
     
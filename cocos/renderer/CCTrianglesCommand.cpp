@@ -0,0 +1,98 @@
+/****************************************************************************
+Copyright (c) 2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#include "renderer/CCTrianglesCommand.h"
+#include "renderer/ccGLStateCache.h"
+#include "renderer/CCGLProgram.h"
+#include "renderer/CCGLProgramState.h"
+#include "xxhash.h"
+
+NS_CC_BEGIN
+
+TrianglesCommand::TrianglesCommand()
+:_materialID(0)
+,_glProgramState(nullptr)
+,_blendType(BlendFunc::DISABLE)
+,_vertices(nullptr)
+,_vertexCount(0)
+,_indices(nullptr)
+,_indexCount(0)
+{
+    _type = RenderCommand::Type::TRIANGLES_COMMAND;
+}
+
+void TrianglesCommand::init(float globalOrder, GLProgramState* glProgramState, BlendFunc blendType,
+                            const V2F_C4B_T2F* vertices, ssize_t vertexCount, const GLushort* indices, ssize_t indexCount, const Mat4& mv)
+{
+    CCASSERT(glProgramState, "Invalid GLProgramState");
+    CCASSERT(glProgramState->getVertexAttribsFlags() == 0, "No custom attributes are supported in TrianglesCommand");
+
+    _globalOrder = globalOrder;
+
+    _vertices = vertices;
+    _vertexCount = vertexCount;
+    _indices = indices;
+    _indexCount = indexCount;
+
+    _mv = mv;
+
+    if (_blendType.src != blendType.src || _blendType.dst != blendType.dst || _glProgramState != glProgramState)
+    {
+        _blendType = blendType;
+        _glProgramState = glProgramState;
+
+        generateMaterialID();
+    }
+}
+
+TrianglesCommand::~TrianglesCommand()
+{
+}
+
+void TrianglesCommand::generateMaterialID()
+{
+    if(_glProgramState->getUniformCount() > 0)
+    {
+        _materialID = TrianglesCommand::MATERIAL_ID_DO_NOT_BATCH;
+    }
+    else
+    {
+        int glProgram = (int)_glProgramState->getGLProgram()->getProgram();
+        int intArray[3] = { glProgram, (int)_blendType.src, (int)_blendType.dst};
+
+        _materialID = XXH32((const void*)intArray, sizeof(intArray), 0);
+    }
+}
+
+void TrianglesCommand::useMaterial() const
+{
+    //set blend mode
+    GL::blendFunc(_blendType.src, _blendType.dst);
+
+    // the vertices are already in world coordinates
+    _glProgramState->apply(Mat4::IDENTITY);
+}
+
+NS_CC_END
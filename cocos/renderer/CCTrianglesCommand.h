@@ -0,0 +1,78 @@
+/****************************************************************************
+Copyright (c) 2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef _CC_TRIANGLESCOMMAND_H_
+#define _CC_TRIANGLESCOMMAND_H_
+
+#include "renderer/CCRenderCommand.h"
+#include "renderer/CCGLProgramState.h"
+#include "CCGL.h"
+
+NS_CC_BEGIN
+
+/** Command used to render indexed, untextured triangles, like the ones of `DrawNode`.
+ Consecutive commands with the same program and blending function are transformed to
+ world coordinates and drawn by the `Renderer` with a single draw call.
+ The transform must be a 2D one since the vertices don't have a z coordinate.
+ */
+class TrianglesCommand : public RenderCommand
+{
+public:
+    static const int MATERIAL_ID_DO_NOT_BATCH = 0;
+
+    TrianglesCommand();
+    ~TrianglesCommand();
+
+    /** Initializes the command with a globalZOrder, a `GLProgramState`, a blending function, the vertices and the
+     * indices to draw, and the Model View transform to be used for the vertices */
+    void init(float globalOrder, GLProgramState* glProgramState, BlendFunc blendType,
+              const V2F_C4B_T2F* vertices, ssize_t vertexCount, const GLushort* indices, ssize_t indexCount, const Mat4& mv);
+
+    void useMaterial() const;
+
+    inline uint32_t getMaterialID() const { return _materialID; }
+    inline const V2F_C4B_T2F* getVertices() const { return _vertices; }
+    inline ssize_t getVertexCount() const { return _vertexCount; }
+    inline const GLushort* getIndices() const { return _indices; }
+    inline ssize_t getIndexCount() const { return _indexCount; }
+    inline GLProgramState* getGLProgramState() const { return _glProgramState; }
+    inline BlendFunc getBlendType() const { return _blendType; }
+    inline const Mat4& getModelView() const { return _mv; }
+
+protected:
+    void generateMaterialID();
+
+    uint32_t _materialID;
+    GLProgramState* _glProgramState;
+    BlendFunc _blendType;
+    const V2F_C4B_T2F* _vertices;
+    ssize_t _vertexCount;
+    const GLushort* _indices;
+    ssize_t _indexCount;
+    Mat4 _mv;
+};
+
+NS_CC_END
+
+#endif //_CC_TRIANGLESCOMMAND_H_
@@ -1701,7 +1701,7 @@ void vec2_array_to_luaval(lua_State* L,const cocos2d::Vec2* points, int count)
 {
     if (NULL  == L)
         return;
-    lua_newtable(L);
+    lua_createtable(L, count, 0);
     for (int i = 1; i <= count; ++i)
     {
         lua_pushnumber(L, i);
@@ -1714,7 +1714,7 @@ void vec2_to_luaval(lua_State* L,const cocos2d::Vec2& vec2)
 {
     if (NULL  == L)
         return;
-    lua_newtable(L);                                    /* L: table */
+    lua_createtable(L, 0, 2);                           /* L: table */
     lua_pushstring(L, "x");                             /* L: table key */
     lua_pushnumber(L, (lua_Number) vec2.x);               /* L: table key value*/
     lua_rawset(L, -3);                                  /* table[key] = value, L: table */
@@ -1729,7 +1729,7 @@ void vec3_to_luaval(lua_State* L,const cocos2d::Vec3& vec3)
     if (NULL  == L)
         return;
     
-    lua_newtable(L);                                    /* L: table */
+    lua_createtable(L, 0, 3);                           /* L: table */
     lua_pushstring(L, "x");                             /* L: table key */
     lua_pushnumber(L, (lua_Number) vec3.x);             /* L: table key value*/
     lua_rawset(L, -3);                                  /* table[key] = value, L: table */
@@ -1822,7 +1822,7 @@ void size_to_luaval(lua_State* L,const Size& sz)
 {
     if (NULL  == L)
         return;
-    lua_newtable(L);                                    /* L: table */
+    lua_createtable(L, 0, 2);                           /* L: table */
     lua_pushstring(L, "width");                         /* L: table key */
     lua_pushnumber(L, (lua_Number) sz.width);           /* L: table key value*/
     lua_rawset(L, -3);                                  /* table[key] = value, L: table */
@@ -1835,7 +1835,7 @@ void rect_to_luaval(lua_State* L,const Rect& rt)
 {
     if (NULL  == L)
         return;
-    lua_newtable(L);                                    /* L: table */
+    lua_createtable(L, 0, 4);                           /* L: table */
     lua_pushstring(L, "x");                             /* L: table key */
     lua_pushnumber(L, (lua_Number) rt.origin.x);               /* L: table key value*/
     lua_rawset(L, -3);                                  /* table[key] = value, L: table */
@@ -1854,7 +1854,7 @@ void color4b_to_luaval(lua_State* L,const Color4B& cc)
 {
     if (NULL  == L)
         return;
-    lua_newtable(L);                                    /* L: table */
+    lua_createtable(L, 0, 4);                           /* L: table */
     lua_pushstring(L, "r");                             /* L: table key */
     lua_pushnumber(L, (lua_Number) cc.r);               /* L: table key value*/
     lua_rawset(L, -3);                                  /* table[key] = value, L: table */
@@ -1873,7 +1873,7 @@ void color4f_to_luaval(lua_State* L,const Color4F& cc)
 {
     if (NULL  == L)
         return;
-    lua_newtable(L);                                    /* L: table */
+    lua_createtable(L, 0, 4);                           /* L: table */
     lua_pushstring(L, "r");                             /* L: table key */
     lua_pushnumber(L, (lua_Number) cc.r);               /* L: table key value*/
     lua_rawset(L, -3);                                  /* table[key] = value, L: table */
@@ -1892,7 +1892,7 @@ void color3b_to_luaval(lua_State* L,const Color3B& cc)
 {
     if (NULL  == L)
         return;
-    lua_newtable(L);                                    /* L: table */
+    lua_createtable(L, 0, 3);                           /* L: table */
     lua_pushstring(L, "r");                             /* L: table key */
     lua_pushnumber(L, (lua_Number) cc.r);               /* L: table key value*/
     lua_rawset(L, -3);                                  /* table[key] = value, L: table */
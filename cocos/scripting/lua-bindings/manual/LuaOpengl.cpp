@@ -40,8 +40,7 @@ using namespace cocos2d::extension;
     
 void GLNode::draw(Renderer *renderer, const cocos2d::Mat4& transform, bool transformUpdated)
 {
-    _renderCmd.init(_globalZOrder);
-    _renderCmd.func = CC_CALLBACK_0(GLNode::onDraw, this, transform, transformUpdated);
+    _renderCmd.init(_globalZOrder, renderer->getFrameArena(), CC_CALLBACK_0(GLNode::onDraw, this, transform, transformUpdated));
     renderer->addCommand(&_renderCmd);
 }
 
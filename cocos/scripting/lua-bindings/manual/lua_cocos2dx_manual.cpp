@@ -2214,6 +2214,227 @@ tolua_lerror:
 #endif
 }
 
+#if COCOS2D_DEBUG >= 1
+static char s_nodeTypeCacheKey = 0;
+
+/* tolua_isusertype() compares the type names of the class and of all the super classes of the userdata on each call.
+   The hot Node functions below cache the answer per metatable, which is a pointer lookup. */
+static bool isNodeUserType(lua_State* L, int lo)
+{
+    if (lo < 0)
+        lo = lua_gettop(L) + lo + 1;
+
+    if (!lua_isuserdata(L, lo) || !lua_getmetatable(L, lo))     /* L: mt */
+        return false;
+
+    lua_pushlightuserdata(L, &s_nodeTypeCacheKey);
+    lua_rawget(L, LUA_REGISTRYINDEX);                           /* L: mt cache */
+    if (!lua_istable(L, -1))
+    {
+        lua_pop(L, 1);
+        lua_newtable(L);
+        lua_pushlightuserdata(L, &s_nodeTypeCacheKey);
+        lua_pushvalue(L, -2);
+        lua_rawset(L, LUA_REGISTRYINDEX);                       /* L: mt cache */
+    }
+
+    lua_pushvalue(L, -2);
+    lua_rawget(L, -2);                                          /* L: mt cache isNode */
+    if (lua_isnil(L, -1))
+    {
+        lua_pop(L, 1);
+        tolua_Error tolua_err;
+        bool isNode = tolua_isusertype(L, lo, "cc.Node", 0, &tolua_err) != 0;
+        lua_pushvalue(L, -2);
+        lua_pushboolean(L, isNode);
+        lua_rawset(L, -3);                                      /* L: mt cache */
+        lua_pop(L, 2);
+        return isNode;
+    }
+
+    bool isNode = lua_toboolean(L, -1) != 0;
+    lua_pop(L, 3);
+    return isNode;
+}
+#endif
+
+static int tolua_cocos2d_Node_setPosition(lua_State* tolua_S)
+{
+    if (NULL == tolua_S)
+        return 0;
+    
+    int argc = 0;
+    Node* self = nullptr;
+    
+#if COCOS2D_DEBUG >= 1
+    if (!isNodeUserType(tolua_S, 1))
+    {
+        tolua_error(tolua_S,"invalid 'self' in function 'tolua_cocos2d_Node_setPosition'\n", NULL);
+        return 0;
+    }
+#endif
+    
+    self = static_cast<cocos2d::Node*>(tolua_tousertype(tolua_S,1,0));
+#if COCOS2D_DEBUG >= 1
+    if (nullptr == self) {
+        tolua_error(tolua_S,"invalid 'self' in function 'tolua_cocos2d_Node_setPosition'\n", NULL);
+        return 0;
+    }
+#endif
+    
+    argc = lua_gettop(tolua_S) - 1;
+    
+    // node:setPosition(x, y) doesn't go through a table
+    if (2 == argc && LUA_TNUMBER == lua_type(tolua_S, 2) && LUA_TNUMBER == lua_type(tolua_S, 3))
+    {
+        self->setPosition((float)lua_tonumber(tolua_S, 2), (float)lua_tonumber(tolua_S, 3));
+        return 0;
+    }
+    else if (1 == argc)
+    {
+        cocos2d::Vec2 pos;
+        if (luaval_to_vec2(tolua_S, 2, &pos))
+        {
+            self->setPosition(pos);
+        }
+        return 0;
+    }
+    
+    CCLOG("'setPosition' function in Node has wrong number of arguments: %d, was expecting %d\n", argc, 1);
+    return 0;
+}
+
+/* cc.Node:setPositions(nodes, positions)
+   Moves the nodes of an array to the positions of a flat array {x1, y1, x2, y2, ...} in one call,
+   returns the number of nodes moved. */
+static int tolua_cocos2d_Node_setPositions(lua_State* tolua_S)
+{
+    if (NULL == tolua_S)
+        return 0;
+    
+    int argc = 0;
+    
+#if COCOS2D_DEBUG >= 1
+    tolua_Error tolua_err;
+    if (!tolua_isusertable(tolua_S,1,"cc.Node",0,&tolua_err)) goto tolua_lerror;
+#endif
+    
+    argc = lua_gettop(tolua_S) - 1;
+    
+    if (2 == argc)
+    {
+#if COCOS2D_DEBUG >= 1
+        if (!tolua_istable(tolua_S, 2, 0, &tolua_err) || !tolua_istable(tolua_S, 3, 0, &tolua_err))
+            goto tolua_lerror;
+#endif
+        int count = (int)lua_objlen(tolua_S, 2);
+        int positionCount = (int)lua_objlen(tolua_S, 3) / 2;
+        if (positionCount < count)
+            count = positionCount;
+        
+        for (int i = 1; i <= count; ++i)
+        {
+            lua_rawgeti(tolua_S, 2, i);                     /* L: ... node */
+            lua_rawgeti(tolua_S, 3, 2 * i - 1);             /* L: ... node x */
+            lua_rawgeti(tolua_S, 3, 2 * i);                 /* L: ... node x y */
+#if COCOS2D_DEBUG >= 1
+            if (!isNodeUserType(tolua_S, -3))
+            {
+                lua_pop(tolua_S, 3);
+                continue;
+            }
+#endif
+            Node* node = static_cast<cocos2d::Node*>(tolua_tousertype(tolua_S, -3, 0));
+            if (node)
+            {
+                node->setPosition((float)lua_tonumber(tolua_S, -2), (float)lua_tonumber(tolua_S, -1));
+            }
+            lua_pop(tolua_S, 3);
+        }
+        
+        lua_pushnumber(tolua_S, (lua_Number)count);
+        return 1;
+    }
+    
+    CCLOG("'setPositions' function in Node has wrong number of arguments: %d, was expecting %d\n", argc, 2);
+    return 0;
+    
+#if COCOS2D_DEBUG >= 1
+tolua_lerror:
+    tolua_error(tolua_S,"#ferror in function 'setPositions'.",&tolua_err);
+    return 0;
+#endif
+}
+
+/* cc.Node:getPositions(nodes [, positions])
+   Writes the positions of the nodes of an array into the flat array {x1, y1, x2, y2, ...} and returns it.
+   Passing the array of the previous call reuses it instead of creating a table. */
+static int tolua_cocos2d_Node_getPositions(lua_State* tolua_S)
+{
+    if (NULL == tolua_S)
+        return 0;
+    
+    int argc = 0;
+    
+#if COCOS2D_DEBUG >= 1
+    tolua_Error tolua_err;
+    if (!tolua_isusertable(tolua_S,1,"cc.Node",0,&tolua_err)) goto tolua_lerror;
+#endif
+    
+    argc = lua_gettop(tolua_S) - 1;
+    
+    if (1 == argc || 2 == argc)
+    {
+#if COCOS2D_DEBUG >= 1
+        if (!tolua_istable(tolua_S, 2, 0, &tolua_err) || !tolua_istable(tolua_S, 3, 1, &tolua_err))
+            goto tolua_lerror;
+#endif
+        int count = (int)lua_objlen(tolua_S, 2);
+        if (2 == argc && lua_istable(tolua_S, 3))
+        {
+            lua_pushvalue(tolua_S, 3);
+        }
+        else
+        {
+            lua_createtable(tolua_S, count * 2, 0);
+        }
+        int positions = lua_gettop(tolua_S);                /* L: ... positions */
+        
+        for (int i = 1; i <= count; ++i)
+        {
+            float x = 0.0f;
+            float y = 0.0f;
+            lua_rawgeti(tolua_S, 2, i);                     /* L: ... positions node */
+#if COCOS2D_DEBUG >= 1
+            if (isNodeUserType(tolua_S, -1))
+#endif
+            {
+                Node* node = static_cast<cocos2d::Node*>(tolua_tousertype(tolua_S, -1, 0));
+                if (node)
+                {
+                    node->getPosition(&x, &y);
+                }
+            }
+            lua_pop(tolua_S, 1);
+            lua_pushnumber(tolua_S, (lua_Number)x);
+            lua_rawseti(tolua_S, positions, 2 * i - 1);
+            lua_pushnumber(tolua_S, (lua_Number)y);
+            lua_rawseti(tolua_S, positions, 2 * i);
+        }
+        
+        return 1;
+    }
+    
+    CCLOG("'getPositions' function in Node has wrong number of arguments: %d, was expecting %d\n", argc, 1);
+    return 0;
+    
+#if COCOS2D_DEBUG >= 1
+tolua_lerror:
+    tolua_error(tolua_S,"#ferror in function 'getPositions'.",&tolua_err);
+    return 0;
+#endif
+}
+
 static int tolua_cocos2d_Spawn_create(lua_State* tolua_S)
 {
     if (NULL == tolua_S)
@@ -3369,6 +3590,15 @@ static void extendNode(lua_State* tolua_S)
         lua_pushstring(tolua_S,"getPosition");
         lua_pushcfunction(tolua_S,tolua_cocos2d_Node_getPosition);
         lua_rawset(tolua_S, -3);
+        lua_pushstring(tolua_S,"setPosition");
+        lua_pushcfunction(tolua_S,tolua_cocos2d_Node_setPosition);
+        lua_rawset(tolua_S, -3);
+        lua_pushstring(tolua_S,"setPositions");
+        lua_pushcfunction(tolua_S,tolua_cocos2d_Node_setPositions);
+        lua_rawset(tolua_S, -3);
+        lua_pushstring(tolua_S,"getPositions");
+        lua_pushcfunction(tolua_S,tolua_cocos2d_Node_getPositions);
+        lua_rawset(tolua_S, -3);
         lua_pushstring(tolua_S, "setContentSize");
         lua_pushcfunction(tolua_S, tolua_cocos2d_Node_setContentSize);
         lua_rawset(tolua_S, -3);
@@ -760,14 +760,12 @@ void Layout::stencilClippingVisit(Renderer *renderer, const Mat4 &parentTransfor
     
     renderer->pushGroup(_groupCommand.getRenderQueueID());
     
-    _beforeVisitCmdStencil.init(_globalZOrder);
-    _beforeVisitCmdStencil.func = CC_CALLBACK_0(Layout::onBeforeVisitStencil, this);
+    _beforeVisitCmdStencil.init(_globalZOrder, renderer->getFrameArena(), CC_CALLBACK_0(Layout::onBeforeVisitStencil, this));
     renderer->addCommand(&_beforeVisitCmdStencil);
     
     _clippingStencil->visit(renderer, _modelViewTransform, dirty);
     
-    _afterDrawStencilCmd.init(_globalZOrder);
-    _afterDrawStencilCmd.func = CC_CALLBACK_0(Layout::onAfterDrawStencil, this);
+    _afterDrawStencilCmd.init(_globalZOrder, renderer->getFrameArena(), CC_CALLBACK_0(Layout::onAfterDrawStencil, this));
     renderer->addCommand(&_afterDrawStencilCmd);
     
     int i = 0;      // used by _children
@@ -814,8 +812,7 @@ void Layout::stencilClippingVisit(Renderer *renderer, const Mat4 &parentTransfor
         (*it)->visit(renderer, _modelViewTransform, dirty);
 
     
-    _afterVisitCmdStencil.init(_globalZOrder);
-    _afterVisitCmdStencil.func = CC_CALLBACK_0(Layout::onAfterVisitStencil, this);
+    _afterVisitCmdStencil.init(_globalZOrder, renderer->getFrameArena(), CC_CALLBACK_0(Layout::onAfterVisitStencil, this));
     renderer->addCommand(&_afterVisitCmdStencil);
     
     renderer->popGroup();
@@ -896,14 +893,12 @@ void Layout::onAfterVisitScissor()
     
 void Layout::scissorClippingVisit(Renderer *renderer, const Mat4& parentTransform, bool parentTransformUpdated)
 {
-    _beforeVisitCmdScissor.init(_globalZOrder);
-    _beforeVisitCmdScissor.func = CC_CALLBACK_0(Layout::onBeforeVisitScissor, this);
+    _beforeVisitCmdScissor.init(_globalZOrder, renderer->getFrameArena(), CC_CALLBACK_0(Layout::onBeforeVisitScissor, this));
     renderer->addCommand(&_beforeVisitCmdScissor);
 
     ProtectedNode::visit(renderer, parentTransform, parentTransformUpdated);
     
-    _afterVisitCmdScissor.init(_globalZOrder);
-    _afterVisitCmdScissor.func = CC_CALLBACK_0(Layout::onAfterVisitScissor, this);
+    _afterVisitCmdScissor.init(_globalZOrder, renderer->getFrameArena(), CC_CALLBACK_0(Layout::onAfterVisitScissor, this));
     renderer->addCommand(&_afterVisitCmdScissor);
 }
 
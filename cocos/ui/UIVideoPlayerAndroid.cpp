@@ -227,8 +227,7 @@ void VideoPlayer::draw(Renderer* renderer, const Mat4 &transform, bool transform
     }
 
 #if CC_VIDEOPLAYER_DEBUG_DRAW
-    _customDebugDrawCommand.init(_globalZOrder);
-    _customDebugDrawCommand.func = CC_CALLBACK_0(VideoPlayer::drawDebugData, this);
+    _customDebugDrawCommand.init(_globalZOrder, renderer->getFrameArena(), CC_CALLBACK_0(VideoPlayer::drawDebugData, this));
     renderer->addCommand(&_customDebugDrawCommand);
 #endif
 }
@@ -492,8 +492,7 @@ void ScrollView::addChild(Node * child, int zOrder, int tag)
 
 void ScrollView::beforeDraw()
 {
-    _beforeDrawCommand.init(_globalZOrder);
-    _beforeDrawCommand.func = CC_CALLBACK_0(ScrollView::onBeforeDraw, this);
+    _beforeDrawCommand.init(_globalZOrder, Director::getInstance()->getRenderer()->getFrameArena(), CC_CALLBACK_0(ScrollView::onBeforeDraw, this));
     Director::getInstance()->getRenderer()->addCommand(&_beforeDrawCommand);
 }
 
@@ -529,8 +528,7 @@ void ScrollView::onBeforeDraw()
 
 void ScrollView::afterDraw()
 {
-    _afterDrawCommand.init(_globalZOrder);
-    _afterDrawCommand.func = CC_CALLBACK_0(ScrollView::onAfterDraw, this);
+    _afterDrawCommand.init(_globalZOrder, Director::getInstance()->getRenderer()->getFrameArena(), CC_CALLBACK_0(ScrollView::onAfterDraw, this));
     Director::getInstance()->getRenderer()->addCommand(&_afterDrawCommand);
 }
 
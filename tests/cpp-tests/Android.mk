@@ -156,6 +156,14 @@ Classes/PerformanceTest/PerformanceContainerTest.cpp \
 Classes/PerformanceTest/PerformanceEventDispatcherTest.cpp \
 Classes/PerformanceTest/PerformanceScenarioTest.cpp \
 Classes/PerformanceTest/PerformanceCallbackTest.cpp \
+Classes/PerformanceTest/PerformanceValueMapTest.cpp \
+Classes/PerformanceTest/PerformanceSpineTest.cpp \
+Classes/PerformanceTest/PerformanceNodeMemoryTest.cpp \
+Classes/PerformanceTest/PerformanceNodePoolTest.cpp \
+Classes/PerformanceTest/PerformanceArmatureTest.cpp \
+Classes/PerformanceTest/PerformanceTMXTest.cpp \
+Classes/PerformanceTest/PerformanceZipTest.cpp \
+Classes/PerformanceTest/PerformanceResourceLoaderTest.cpp \
 Classes/PhysicsTest/PhysicsTest.cpp \
 Classes/ReleasePoolTest/ReleasePoolTest.cpp \
 Classes/RenderTextureTest/RenderTextureTest.cpp \
@@ -244,7 +244,11 @@ void TestAsynchronousLoading::onEnter()
     label->setString(pszPercent);
 
 
-    //! create a new thread to load data
+    //! every file is decoded by a task of the thread pool, log how long each one took
+    DataReaderHelper::getInstance()->setFileLoadedCallback([](const DataReaderHelper::FileLoadInfo& info){
+        CCLOG("%s loaded in %.2f ms, %.0f%%", info.filePath.c_str(), info.loadTime * 1000, info.progress * 100);
+    });
+
     ArmatureDataManager::getInstance()->addArmatureFileInfoAsync("armature/knight.png", "armature/knight.plist", "armature/knight.xml", this, schedule_selector(TestAsynchronousLoading::dataLoaded));
     ArmatureDataManager::getInstance()->addArmatureFileInfoAsync("armature/weapon.png", "armature/weapon.plist", "armature/weapon.xml", this, schedule_selector(TestAsynchronousLoading::dataLoaded));
     ArmatureDataManager::getInstance()->addArmatureFileInfoAsync("armature/robot.png", "armature/robot.plist", "armature/robot.xml", this, schedule_selector(TestAsynchronousLoading::dataLoaded));
@@ -258,6 +262,14 @@ void TestAsynchronousLoading::onEnter()
     ArmatureDataManager::getInstance()->addArmatureFileInfoAsync("armature/testEasing.ExportJson", this, schedule_selector(TestAsynchronousLoading::dataLoaded));
 }
 
+void TestAsynchronousLoading::onExit()
+{
+    // the callback would outlive the test
+    DataReaderHelper::getInstance()->setFileLoadedCallback(nullptr);
+
+    ArmatureTestLayer::onExit();
+}
+
 std::string TestAsynchronousLoading::title() const
 {
     return "Test Asynchronous Loading";
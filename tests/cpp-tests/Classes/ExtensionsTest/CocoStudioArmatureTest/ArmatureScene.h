@@ -74,6 +74,7 @@ class TestAsynchronousLoading : public ArmatureTestLayer
 {
 public:
 	virtual void onEnter() override;
+	virtual void onExit() override;
 	virtual std::string title() const override;
 	virtual std::string subtitle() const override;
     virtual void restartCallback(Ref* pSender);
@@ -39,6 +39,7 @@ static std::function<Layer*()> createFunctions[] =
     CL(NewClippingNodeTest),
     CL(NewDrawNodeTest),
     CL(NewCullingTest),
+    CL(SubtreeCullingTest),
     CL(VBOFullTest),
 };
 
@@ -530,6 +531,119 @@ std::string NewCullingTest::subtitle() const
     return "Drag the layer to test the result of culling";
 }
 
+// a grid of cells, each one a node with two colored layers
+static const int s_cullingColumns = 20;
+static const int s_cullingRows = 4;
+static const float s_cullingCellSize = 80;
+static const float s_cullingSpacing = 120;
+static const int s_cullingNodesPerCell = 3;
+
+SubtreeCullingTest::SubtreeCullingTest()
+: _scrollSpeed(-120)
+, _expectedCulled(-1)
+, _checkedFrames(0)
+, _failedFrames(0)
+{
+    Size s = Director::getInstance()->getWinSize();
+
+    // scrolled like the content of a ScrollView
+    _container = Node::create();
+    _container->setSubtreeCullingEnabled(true);
+    addChild(_container);
+
+    for (int row = 0; row < s_cullingRows; ++row)
+    {
+        for (int column = 0; column < s_cullingColumns; ++column)
+        {
+            auto cell = Node::create();
+            cell->setContentSize(Size(s_cullingCellSize, s_cullingCellSize));
+            cell->setPosition(Vec2(20 + column * s_cullingSpacing, 40 + row * s_cullingSpacing));
+            _container->addChild(cell);
+
+            auto background = LayerColor::create(Color4B(40, 40, 160, 255), s_cullingCellSize, s_cullingCellSize);
+            cell->addChild(background);
+            auto center = LayerColor::create(Color4B(200, 200, 40, 255), s_cullingCellSize / 2, s_cullingCellSize / 2);
+            center->setPosition(Vec2(s_cullingCellSize / 4, s_cullingCellSize / 4));
+            cell->addChild(center);
+        }
+    }
+
+    _resultLabel = Label::createWithTTF("", "fonts/arial.ttf", 16);
+    _resultLabel->setPosition(Vec2(s.width/2, s.height - 90));
+    addChild(_resultLabel, 1);
+
+    scheduleUpdate();
+}
+
+SubtreeCullingTest::~SubtreeCullingTest()
+{
+}
+
+int SubtreeCullingTest::countOffscreenNodes() const
+{
+    Size s = Director::getInstance()->getWinSize();
+    Vec2 origin = _container->convertToWorldSpace(Vec2::ZERO);
+
+    int count = 0;
+    for (int row = 0; row < s_cullingRows; ++row)
+    {
+        for (int column = 0; column < s_cullingColumns; ++column)
+        {
+            float left = origin.x + 20 + column * s_cullingSpacing;
+            float bottom = origin.y + 40 + row * s_cullingSpacing;
+            bool onScreen = left + s_cullingCellSize > 0 && left < s.width
+                && bottom + s_cullingCellSize > 0 && bottom < s.height;
+            if (!onScreen)
+            {
+                count += s_cullingNodesPerCell;
+            }
+        }
+    }
+    return count;
+}
+
+void SubtreeCullingTest::update(float dt)
+{
+    // the renderer reports the nodes culled by the previous frame, drawn with the previous position
+    if (_expectedCulled >= 0)
+    {
+        ssize_t culled = Director::getInstance()->getRenderer()->getCulledNodes();
+        ++_checkedFrames;
+        if (culled != _expectedCulled)
+        {
+            ++_failedFrames;
+            CCLOG("SubtreeCullingTest: %d nodes culled, %d expected", (int)culled, _expectedCulled);
+        }
+        _resultLabel->setString(StringUtils::format("culled %d, expected %d\n%s: %d of %d frames",
+                                                    (int)culled, _expectedCulled,
+                                                    _failedFrames == 0 ? "passed" : "FAILED", _checkedFrames - _failedFrames, _checkedFrames));
+    }
+
+    // back and forth over the whole grid
+    Size s = Director::getInstance()->getWinSize();
+    float minX = s.width - (40 + (s_cullingColumns - 1) * s_cullingSpacing + s_cullingCellSize);
+    Vec2 position = _container->getPosition();
+    position.x += _scrollSpeed * std::min(dt, 0.1f);
+    if (position.x < minX || position.x > 0)
+    {
+        position.x = std::max(minX, std::min(position.x, 0.0f));
+        _scrollSpeed = -_scrollSpeed;
+    }
+    _container->setPosition(position);
+
+    _expectedCulled = countOffscreenNodes();
+}
+
+std::string SubtreeCullingTest::title() const
+{
+    return "New Renderer";
+}
+
+std::string SubtreeCullingTest::subtitle() const
+{
+    return "Subtree culling of a scrolled grid, checks Renderer::getCulledNodes()";
+}
+
 VBOFullTest::VBOFullTest()
 {
     Size s = Director::getInstance()->getWinSize();
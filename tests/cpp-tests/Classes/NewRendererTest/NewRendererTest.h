@@ -134,6 +134,28 @@ protected:
     Vec2 _lastPos;
 };
 
+class SubtreeCullingTest : public MultiSceneTest
+{
+public:
+    CREATE_FUNC(SubtreeCullingTest);
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void update(float dt) override;
+
+protected:
+    SubtreeCullingTest();
+    virtual ~SubtreeCullingTest();
+    // the nodes of the cells outside of the screen, counted from the geometry of the grid
+    int countOffscreenNodes() const;
+
+    Node* _container;
+    Label* _resultLabel;
+    float _scrollSpeed;
+    int _expectedCulled;
+    int _checkedFrames;
+    int _failedFrames;
+};
+
 class VBOFullTest : public MultiSceneTest
 {
 public:
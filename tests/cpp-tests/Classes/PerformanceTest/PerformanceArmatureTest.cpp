@@ -0,0 +1,272 @@
+//
+//  PerformanceArmatureTest.cpp
+//
+
+#include "PerformanceArmatureTest.h"
+#include "base/CCThreadPool.h"
+
+using namespace cocostudio;
+
+static std::function<PerformanceArmatureScene*()> createFunctions[] =
+{
+    CL(ArmatureUpdateSerialPerfTest),
+    CL(ArmatureUpdateParallelPerfTest),
+    CL(ArmatureDrawNodePerfTest),
+    CL(ArmatureDrawBatchNodePerfTest),
+};
+
+#define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
+
+static const int kInstancesIncrease = 50;
+static const int kMaxInstances = 1000;
+
+static int g_curCase = 0;
+static int g_quantity = 200;
+
+////////////////////////////////////////////////////////
+//
+// ArmatureBasicLayer
+//
+////////////////////////////////////////////////////////
+
+ArmatureBasicLayer::ArmatureBasicLayer(bool bControlMenuVisible, int nMaxCases, int nCurCase)
+: PerformBasicLayer(bControlMenuVisible, nMaxCases, nCurCase)
+{
+}
+
+void ArmatureBasicLayer::showCurrentTest()
+{
+    auto scene = createFunctions[_curCase]();
+
+    g_curCase = _curCase;
+
+    if (scene)
+    {
+        Director::getInstance()->replaceScene(scene);
+    }
+}
+
+////////////////////////////////////////////////////////
+//
+// PerformanceArmatureScene
+//
+////////////////////////////////////////////////////////
+
+void PerformanceArmatureScene::onEnter()
+{
+    Scene::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+    _quantity = g_quantity;
+
+    ArmatureDataManager::getInstance()->addArmatureFileInfo("armature/Cowboy.ExportJson");
+
+    // the armatures read the mode when they enter the stage
+    Armature::setParallelUpdateEnabled(isParallel());
+
+    _instances = createInstancesParent();
+    addChild(_instances);
+
+    auto menuLayer = new ArmatureBasicLayer(true, MAX_LAYER, g_curCase);
+    addChild(menuLayer);
+    menuLayer->release();
+
+    // Title
+    auto label = Label::createWithTTF(title().c_str(), "fonts/arial.ttf", 32);
+    addChild(label, 1);
+    label->setPosition(Vec2(s.width/2, s.height-50));
+
+    // Subtitle
+    std::string strSubTitle = subtitle();
+    if(strSubTitle.length())
+    {
+        auto l = Label::createWithTTF(strSubTitle.c_str(), "fonts/Thonburi.ttf", 16);
+        addChild(l, 1);
+        l->setPosition(Vec2(s.width/2, s.height-80));
+    }
+
+    MenuItemFont::setFontSize(65);
+    auto decrease = MenuItemFont::create(" - ", CC_CALLBACK_1(PerformanceArmatureScene::onQuantityChanged, this, -kInstancesIncrease));
+    decrease->setColor(Color3B(0,200,20));
+    auto increase = MenuItemFont::create(" + ", CC_CALLBACK_1(PerformanceArmatureScene::onQuantityChanged, this, kInstancesIncrease));
+    increase->setColor(Color3B(0,200,20));
+
+    auto menu = Menu::create(decrease, increase, NULL);
+    menu->alignItemsHorizontally();
+    menu->setPosition(Vec2(s.width/2, s.height-130));
+    addChild(menu, 1);
+
+    _quantityLabel = Label::createWithTTF("", "fonts/Marker Felt.ttf", 30);
+    _quantityLabel->setColor(Color3B(0,200,20));
+    _quantityLabel->setPosition(Vec2(s.width/2, s.height-170));
+    addChild(_quantityLabel, 1);
+
+    _resultLabel = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    _resultLabel->setPosition(Vec2(s.width/2, s.height-215));
+    addChild(_resultLabel, 1);
+
+    updateQuantityLabel();
+    spawn();
+
+    scheduleUpdate();
+    schedule(schedule_selector(PerformanceArmatureScene::showResults), 1.0f);
+}
+
+void PerformanceArmatureScene::onExit()
+{
+    Scene::onExit();
+
+    // the armatures don't retain their data
+    _instances->removeAllChildren();
+
+    Armature::setParallelUpdateEnabled(false);
+    ArmatureDataManager::getInstance()->removeArmatureFileInfo("armature/Cowboy.ExportJson");
+}
+
+void PerformanceArmatureScene::onQuantityChanged(Ref* sender, int delta)
+{
+    _quantity = std::min(std::max(_quantity + delta, kInstancesIncrease), kMaxInstances);
+    g_quantity = _quantity;
+    updateQuantityLabel();
+    spawn();
+}
+
+void PerformanceArmatureScene::updateQuantityLabel()
+{
+    _quantityLabel->setString(StringUtils::format("%d armatures", _quantity));
+}
+
+void PerformanceArmatureScene::spawn()
+{
+    _instances->removeAllChildren();
+    _updateTime = 0;
+    _visitTime = 0;
+    _renderTime = 0;
+    _batches = 0;
+    _frames = 0;
+
+    auto s = Director::getInstance()->getWinSize();
+    int columns = std::max(1, (int)sqrtf(_quantity * 2.0f));
+
+    for (int i = 0; i < _quantity; ++i)
+    {
+        auto armature = Armature::create("Cowboy");
+        armature->getAnimation()->playWithIndex(0);
+        // out of phase, so that the key frames aren't all reached in the same frame
+        int duration = armature->getAnimation()->getRawDuration();
+        if (duration > 0)
+        {
+            armature->getAnimation()->gotoAndPlay(i % duration);
+        }
+        armature->setScale(0.2f);
+        armature->setPosition(Vec2((i % columns + 0.5f) * s.width / columns, 20 + (i / columns) * 30 % (int)(s.height / 2)));
+        _instances->addChild(armature);
+    }
+}
+
+void PerformanceArmatureScene::update(float dt)
+{
+    // the statistics are the ones of the previous frame
+    const auto& stats = Director::getInstance()->getLastFrameStats();
+    _updateTime += stats.updateTime * 1000;
+    _visitTime += stats.visitTime * 1000;
+    _renderTime += stats.renderTime * 1000;
+    _batches += stats.drawnBatches;
+    _frames++;
+}
+
+void PerformanceArmatureScene::showResults(float dt)
+{
+    if (_frames == 0)
+        return;
+
+    _resultLabel->setString(StringUtils::format("update: %.3f ms, visit: %.3f ms, render: %.3f ms per frame\n%d batches, %d worker threads",
+                                                _updateTime / _frames, _visitTime / _frames, _renderTime / _frames, _batches / _frames,
+                                                isParallel() ? ThreadPool::getInstance()->getThreadCount() : 0));
+    _updateTime = 0;
+    _visitTime = 0;
+    _renderTime = 0;
+    _batches = 0;
+    _frames = 0;
+}
+
+std::string PerformanceArmatureScene::title() const
+{
+    return "No title";
+}
+
+std::string PerformanceArmatureScene::subtitle() const
+{
+    return "";
+}
+
+////////////////////////////////////////////////////////
+//
+// ArmatureUpdateSerialPerfTest
+//
+////////////////////////////////////////////////////////
+
+std::string ArmatureUpdateSerialPerfTest::title() const
+{
+    return "Armature update, serial";
+}
+
+std::string ArmatureUpdateSerialPerfTest::subtitle() const
+{
+    return "Every armature is updated by its own scheduled update";
+}
+
+////////////////////////////////////////////////////////
+//
+// ArmatureUpdateParallelPerfTest
+//
+////////////////////////////////////////////////////////
+
+std::string ArmatureUpdateParallelPerfTest::title() const
+{
+    return "Armature update, parallel";
+}
+
+std::string ArmatureUpdateParallelPerfTest::subtitle() const
+{
+    return "The bone transforms of all the armatures are computed on the ThreadPool";
+}
+
+////////////////////////////////////////////////////////
+//
+// ArmatureDrawNodePerfTest
+//
+////////////////////////////////////////////////////////
+
+std::string ArmatureDrawNodePerfTest::title() const
+{
+    return "Armature draw, Node parent";
+}
+
+std::string ArmatureDrawNodePerfTest::subtitle() const
+{
+    return "Every skin adds its own QuadCommand, compare the batches with the next test";
+}
+
+////////////////////////////////////////////////////////
+//
+// ArmatureDrawBatchNodePerfTest
+//
+////////////////////////////////////////////////////////
+
+std::string ArmatureDrawBatchNodePerfTest::title() const
+{
+    return "Armature draw, BatchNode parent";
+}
+
+std::string ArmatureDrawBatchNodePerfTest::subtitle() const
+{
+    return "The skins of all the armatures are drawn as one stream of quads";
+}
+
+void runArmaturePerformanceTest()
+{
+    auto scene = createFunctions[g_curCase]();
+
+    Director::getInstance()->replaceScene(scene);
+}
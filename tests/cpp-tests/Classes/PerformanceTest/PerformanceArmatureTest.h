@@ -0,0 +1,94 @@
+//
+//  PerformanceArmatureTest.h
+
+#ifndef __PERFORMANCE_ARMATURE_TEST_H__
+#define __PERFORMANCE_ARMATURE_TEST_H__
+
+#include "PerformanceTest.h"
+#include "cocostudio/CocoStudio.h"
+
+class ArmatureBasicLayer : public PerformBasicLayer
+{
+public:
+    ArmatureBasicLayer(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0);
+
+    virtual void showCurrentTest();
+};
+
+// Plays N armatures and reports the time spent in the scheduler update, which includes the armature updates,
+// the times spent visiting and rendering the scene and the number of draw calls
+class PerformanceArmatureScene : public Scene
+{
+public:
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual void update(float dt) override;
+    virtual std::string title() const;
+    virtual std::string subtitle() const;
+
+    void showResults(float dt);
+protected:
+    virtual bool isParallel() const { return false; }
+    // the parent of the armatures
+    virtual Node* createInstancesParent() const { return Node::create(); }
+
+    void onQuantityChanged(Ref* sender, int delta);
+    void spawn();
+    void updateQuantityLabel();
+
+    Node* _instances;
+    Label* _resultLabel;
+    Label* _quantityLabel;
+    float _updateTime;
+    float _visitTime;
+    float _renderTime;
+    int _batches;
+    int _frames;
+    int _quantity;
+};
+
+class ArmatureUpdateSerialPerfTest : public PerformanceArmatureScene
+{
+public:
+    CREATE_FUNC(ArmatureUpdateSerialPerfTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+protected:
+    virtual bool isParallel() const override { return false; }
+};
+
+class ArmatureUpdateParallelPerfTest : public PerformanceArmatureScene
+{
+public:
+    CREATE_FUNC(ArmatureUpdateParallelPerfTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+protected:
+    virtual bool isParallel() const override { return true; }
+};
+
+class ArmatureDrawNodePerfTest : public PerformanceArmatureScene
+{
+public:
+    CREATE_FUNC(ArmatureDrawNodePerfTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
+class ArmatureDrawBatchNodePerfTest : public PerformanceArmatureScene
+{
+public:
+    CREATE_FUNC(ArmatureDrawBatchNodePerfTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+protected:
+    virtual Node* createInstancesParent() const override { return cocostudio::BatchNode::create(); }
+};
+
+void runArmaturePerformanceTest();
+
+#endif /* __PERFORMANCE_ARMATURE_TEST_H__ */
@@ -1,10 +1,12 @@
 #include "PerformanceLabelTest.h"
 
+#include <chrono>
+
 enum {
     kMaxNodes = 200,
     kNodesIncrease = 10,
 
-    TEST_COUNT = 5,
+    TEST_COUNT = 7,
 };
 
 enum {
@@ -19,7 +21,9 @@ enum {
     kCaseLabelBMFontUpdate,
     kCaseLabelUpdate,
     kCaseLabelBMFontBigLabels,
-    kCaseLabelBigLabels
+    kCaseLabelBigLabels,
+    kCaseLabelSetStringShort,
+    kCaseLabelSetStringLong
 };
 
 #define LongSentencesExample "Lorem ipsum dolor sit amet, consectetur adipisicing elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.\
@@ -87,6 +91,9 @@ void LabelMainScene::initWithSubTest(int nodes)
     _lastRenderedCount = 0;
     _quantityNodes = 0;
     _accumulativeTime = 0.0f;
+    _setStringFrames = 0;
+    _setStringTime = 0;
+    _setStringCount = 0;
 
     _labelContainer = Layer::create();
     addChild(_labelContainer);
@@ -158,6 +165,10 @@ std::string LabelMainScene::title() const
         return "Testing LabelBMFont Big Labels";
     case kCaseLabelBigLabels:
         return "Testing Label Big Labels";
+    case kCaseLabelSetStringShort:
+        return "Testing Label setString Short";
+    case kCaseLabelSetStringLong:
+        return "Testing Label setString Long";
     default:
         break;
     }
@@ -247,6 +258,21 @@ void LabelMainScene::onIncrease(Ref* sender)
             }
             break;
         }        
+    case kCaseLabelSetStringShort:
+    case kCaseLabelSetStringLong:
+        {
+            TTFConfig ttfConfig("fonts/arial.ttf", 30, GlyphCollection::DYNAMIC);
+            for( int i=0;i< kNodesIncrease;i++)
+            {
+                auto label = Label::createWithTTF(ttfConfig, "Score: 0", TextHAlignment::LEFT);
+                label->setAnchorPoint(Vec2::ANCHOR_MIDDLE_LEFT);
+                label->setPosition(Vec2((rand() % 50), ((int)size.height/2 + rand() % 100 - 50)));
+                _labelContainer->addChild(label, 1, _quantityNodes);
+
+                _quantityNodes++;
+            }
+            break;
+        }
     default:
         break;
     }
@@ -310,6 +336,12 @@ void LabelMainScene::updateAutoTest(float dt)
 
 void LabelMainScene::updateText(float dt)
 {
+    if(_s_labelCurCase == kCaseLabelSetStringShort || _s_labelCurCase == kCaseLabelSetStringLong)
+    {
+        updateSetString();
+        return;
+    }
+
     if(_s_labelCurCase > kCaseLabelUpdate)
         return;
 
@@ -344,6 +376,43 @@ void LabelMainScene::updateText(float dt)
     }
 }
 
+void LabelMainScene::updateSetString()
+{
+    // a counter and an appended word change the end of the strings, every 16 frames the whole text changes
+    _setStringFrames++;
+    std::string prefix = (_s_labelCurCase == kCaseLabelSetStringLong) ? LongSentencesExample : "Score";
+    if ((_setStringFrames / 16) % 2)
+    {
+        prefix = (_s_labelCurCase == kCaseLabelSetStringLong) ? "Sed ut perspiciatis unde omnis iste natus error sit voluptatem" : "Lives";
+    }
+    std::string text = StringUtils::format("%s: %d", prefix.c_str(), _setStringFrames * 7);
+    for (int i = 0; i < _setStringFrames % 8; ++i)
+    {
+        text += " x";
+    }
+
+    auto& children = _labelContainer->getChildren();
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for(const auto &child : children) {
+        Label* label = (Label*)child;
+        label->setString(text);
+        // forces the layout now instead of during the next visit
+        label->getContentSize();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    _setStringTime += std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    _setStringCount += children.size();
+    if (_setStringFrames % 60 == 0 && _setStringCount > 0)
+    {
+        log("Label setString (%s strings): %.2f us per call", (_s_labelCurCase == kCaseLabelSetStringLong) ? "long" : "short",
+            static_cast<double>(_setStringTime) / _setStringCount);
+        _setStringTime = 0;
+        _setStringCount = 0;
+    }
+}
+
 void LabelMainScene::onEnter()
 {
     Scene::onEnter();
@@ -377,6 +446,9 @@ void LabelMainScene::autoShowLabelTests(int curCase,int nodes)
     _lastRenderedCount = 0;
     _quantityNodes = 0;
     _accumulativeTime = 0.0f;
+    _setStringFrames = 0;
+    _setStringTime = 0;
+    _setStringCount = 0;
     while(_quantityNodes < nodes)
         onIncrease(this);
 }
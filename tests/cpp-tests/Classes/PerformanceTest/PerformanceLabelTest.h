@@ -36,6 +36,7 @@ public:
     
     void  updateAutoTest(float dt);
     void  updateText(float dt);
+    void  updateSetString();
     void  onAutoTest(Ref* sender);
 
     void  autoShowLabelTests(int curCase,int nodes);
@@ -48,7 +49,7 @@ public:
 
 private:
     static const  int MAX_AUTO_TEST_TIMES  = 35;
-    static const  int MAX_SUB_TEST_NUMS    = 5;
+    static const  int MAX_SUB_TEST_NUMS    = 7;
     
 
     void  dumpProfilerFPS();
@@ -67,6 +68,10 @@ private:
     int            _executeTimes;
 
     float          _accumulativeTime;
+
+    int            _setStringFrames;
+    long long      _setStringTime;
+    size_t         _setStringCount;
 };
 
 void runLabelTest();
@@ -0,0 +1,314 @@
+//
+//  PerformanceNodeMemoryTest.cpp
+//
+
+#include "PerformanceNodeMemoryTest.h"
+#include <chrono>
+
+// Enable profiles for this file
+#undef CC_PROFILER_DISPLAY_TIMERS
+#define CC_PROFILER_DISPLAY_TIMERS() Profiler::getInstance()->displayTimers()
+#undef CC_PROFILER_PURGE_ALL
+#define CC_PROFILER_PURGE_ALL() Profiler::getInstance()->releaseAllTimers()
+
+#undef CC_PROFILER_START
+#define CC_PROFILER_START(__name__) ProfilingBeginTimingBlock(__name__)
+#undef CC_PROFILER_STOP
+#define CC_PROFILER_STOP(__name__) ProfilingEndTimingBlock(__name__)
+
+static std::function<PerformanceNodeMemoryScene*()> createFunctions[] =
+{
+    CL(NodeMemoryPlainPerfTest),
+    CL(NodeMemoryUserDataPerfTest),
+    CL(NodeMemoryInverseTransformPerfTest),
+};
+
+#define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
+
+static const int kNodesIncrease = 20000;
+static const int kMaxNodes = 200000;
+static const int kNodesPerGroup = 1000;
+static const int kVisitPasses = 5;
+
+static int g_curCase = 0;
+static int g_quantity = 100000;
+
+// gives access to the size of the block holding the state that most nodes never use
+class NodeMemoryProbe : public Node
+{
+public:
+    static size_t getExtraDataSize() { return sizeof(ExtraData); }
+};
+
+////////////////////////////////////////////////////////
+//
+// NodeMemoryBasicLayer
+//
+////////////////////////////////////////////////////////
+
+NodeMemoryBasicLayer::NodeMemoryBasicLayer(bool bControlMenuVisible, int nMaxCases, int nCurCase)
+: PerformBasicLayer(bControlMenuVisible, nMaxCases, nCurCase)
+{
+}
+
+void NodeMemoryBasicLayer::showCurrentTest()
+{
+    auto scene = createFunctions[_curCase]();
+
+    g_curCase = _curCase;
+
+    if (scene)
+    {
+        Director::getInstance()->replaceScene(scene);
+    }
+}
+
+////////////////////////////////////////////////////////
+//
+// PerformanceNodeMemoryScene
+//
+////////////////////////////////////////////////////////
+
+void PerformanceNodeMemoryScene::onEnter()
+{
+    Scene::onEnter();
+
+    CC_PROFILER_PURGE_ALL();
+
+    auto s = Director::getInstance()->getWinSize();
+    _quantity = g_quantity;
+    _root = nullptr;
+    _extraDataCount = 0;
+
+    auto menuLayer = new NodeMemoryBasicLayer(true, MAX_LAYER, g_curCase);
+    addChild(menuLayer);
+    menuLayer->release();
+
+    // Title
+    auto label = Label::createWithTTF(title().c_str(), "fonts/arial.ttf", 32);
+    addChild(label, 1);
+    label->setPosition(Vec2(s.width/2, s.height-50));
+
+    // Subtitle
+    std::string strSubTitle = subtitle();
+    if(strSubTitle.length())
+    {
+        auto l = Label::createWithTTF(strSubTitle.c_str(), "fonts/Thonburi.ttf", 16);
+        addChild(l, 1);
+        l->setPosition(Vec2(s.width/2, s.height-80));
+    }
+
+    MenuItemFont::setFontSize(65);
+    auto decrease = MenuItemFont::create(" - ", CC_CALLBACK_1(PerformanceNodeMemoryScene::onQuantityChanged, this, -kNodesIncrease));
+    decrease->setColor(Color3B(0,200,20));
+    auto increase = MenuItemFont::create(" + ", CC_CALLBACK_1(PerformanceNodeMemoryScene::onQuantityChanged, this, kNodesIncrease));
+    increase->setColor(Color3B(0,200,20));
+
+    auto menu = Menu::create(decrease, increase, NULL);
+    menu->alignItemsHorizontally();
+    menu->setPosition(Vec2(s.width/2, s.height-130));
+    addChild(menu, 1);
+
+    _quantityLabel = Label::createWithTTF("", "fonts/Marker Felt.ttf", 30);
+    _quantityLabel->setColor(Color3B(0,200,20));
+    _quantityLabel->setPosition(Vec2(s.width/2, s.height-170));
+    addChild(_quantityLabel, 1);
+
+    _memoryLabel = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    _memoryLabel->setPosition(Vec2(s.width/2, s.height-200));
+    addChild(_memoryLabel, 1);
+
+    _resultLabel = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    _resultLabel->setPosition(Vec2(s.width/2, s.height-225));
+    addChild(_resultLabel, 1);
+
+    updateQuantityLabel();
+    createNodes();
+
+    schedule(schedule_selector(PerformanceNodeMemoryScene::measureVisit), 1.0f);
+    schedule(schedule_selector(PerformanceNodeMemoryScene::dumpProfilerInfo), 2.0f);
+}
+
+void PerformanceNodeMemoryScene::onExit()
+{
+    if (_root)
+    {
+        _root->removeFromParent();
+        _root = nullptr;
+    }
+
+    Scene::onExit();
+}
+
+void PerformanceNodeMemoryScene::onQuantityChanged(Ref* sender, int delta)
+{
+    _quantity = std::min(std::max(_quantity + delta, kNodesIncrease), kMaxNodes);
+    g_quantity = _quantity;
+    updateQuantityLabel();
+    createNodes();
+    CC_PROFILER_PURGE_ALL();
+}
+
+void PerformanceNodeMemoryScene::updateQuantityLabel()
+{
+    _quantityLabel->setString(StringUtils::format("%d nodes", _quantity));
+}
+
+void PerformanceNodeMemoryScene::createNodes()
+{
+    if (_root)
+    {
+        _root->removeFromParent();
+    }
+
+    // groups of kNodesPerGroup children, so that visit() goes through a real hierarchy
+    auto start = std::chrono::high_resolution_clock::now();
+    _root = Node::create();
+    _extraDataCount = 0;
+    Node* group = nullptr;
+    for (int i = 0; i < _quantity; ++i)
+    {
+        if (i % kNodesPerGroup == 0)
+        {
+            group = Node::create();
+            group->setPosition(Vec2((i / kNodesPerGroup) % 10 * 10.0f, (i / kNodesPerGroup) / 10 * 10.0f));
+            _root->addChild(group);
+        }
+
+        auto node = Node::create();
+        node->setPosition(Vec2(i % 100, i % 37));
+        node->setRotation(i % 360);
+        node->setContentSize(Size(10, 10));
+        if (prepareNode(node, i))
+        {
+            ++_extraDataCount;
+        }
+        group->addChild(node, i % 7);
+    }
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start);
+
+    // the nodes are only visited by measureVisit(), the frame rate is not affected by their quantity
+    _root->setVisible(false);
+    addChild(_root);
+
+    int groups = (_quantity + kNodesPerGroup - 1) / kNodesPerGroup;
+    size_t nodeBytes = (_quantity + groups + 1) * sizeof(Node);
+    size_t extraBytes = _extraDataCount * NodeMemoryProbe::getExtraDataSize();
+    _memoryLabel->setString(StringUtils::format("sizeof(Node): %d, extra data: %d x %d bytes, total: %d KB, create: %.2f ms",
+                                                (int)sizeof(Node), _extraDataCount, (int)NodeMemoryProbe::getExtraDataSize(),
+                                                (int)((nodeBytes + extraBytes) / 1024), duration.count() / 1000.0f));
+    _resultLabel->setString("");
+}
+
+void PerformanceNodeMemoryScene::measureVisit(float dt)
+{
+    auto renderer = Director::getInstance()->getRenderer();
+    _profileName = StringUtils::format("visit %d nodes", _quantity);
+
+    _root->setVisible(true);
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < kVisitPasses; ++i)
+    {
+        CC_PROFILER_START(_profileName.c_str());
+        // every transform is recomputed, like when the camera or a parent moves
+        _root->visit(renderer, Mat4::IDENTITY, true);
+        CC_PROFILER_STOP(_profileName.c_str());
+    }
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start);
+    _root->setVisible(false);
+
+    float ms = duration.count() / 1000.0f / kVisitPasses;
+    _resultLabel->setString(StringUtils::format("visit: %.2f ms, %.1f M nodes/s", ms, ms > 0 ? _quantity / ms / 1000.0f : 0.0f));
+}
+
+std::string PerformanceNodeMemoryScene::title() const
+{
+    return "No title";
+}
+
+std::string PerformanceNodeMemoryScene::subtitle() const
+{
+    return "";
+}
+
+void PerformanceNodeMemoryScene::dumpProfilerInfo(float dt)
+{
+	CC_PROFILER_DISPLAY_TIMERS();
+}
+
+////////////////////////////////////////////////////////
+//
+// NodeMemoryPlainPerfTest
+//
+////////////////////////////////////////////////////////
+
+bool NodeMemoryPlainPerfTest::prepareNode(Node* node, int i)
+{
+    return false;
+}
+
+std::string NodeMemoryPlainPerfTest::title() const
+{
+    return "Node memory, plain nodes";
+}
+
+std::string NodeMemoryPlainPerfTest::subtitle() const
+{
+    return "Only the hot fields are allocated, see console";
+}
+
+////////////////////////////////////////////////////////
+//
+// NodeMemoryUserDataPerfTest
+//
+////////////////////////////////////////////////////////
+
+bool NodeMemoryUserDataPerfTest::prepareNode(Node* node, int i)
+{
+    node->setUserData(node);
+    return true;
+}
+
+std::string NodeMemoryUserDataPerfTest::title() const
+{
+    return "Node memory, user data on every node";
+}
+
+std::string NodeMemoryUserDataPerfTest::subtitle() const
+{
+    return "Every node allocates its extra data block, see console";
+}
+
+////////////////////////////////////////////////////////
+//
+// NodeMemoryInverseTransformPerfTest
+//
+////////////////////////////////////////////////////////
+
+bool NodeMemoryInverseTransformPerfTest::prepareNode(Node* node, int i)
+{
+    // one node out of ten converts touches to its space, like the buttons of a big scene
+    if (i % 10 == 0)
+    {
+        node->convertToNodeSpace(Vec2::ZERO);
+        return true;
+    }
+    return false;
+}
+
+std::string NodeMemoryInverseTransformPerfTest::title() const
+{
+    return "Node memory, some inverse transforms";
+}
+
+std::string NodeMemoryInverseTransformPerfTest::subtitle() const
+{
+    return "One node out of ten keeps an inverse transform, see console";
+}
+
+void runNodeMemoryPerformanceTest()
+{
+    auto scene = createFunctions[g_curCase]();
+
+    Director::getInstance()->replaceScene(scene);
+}
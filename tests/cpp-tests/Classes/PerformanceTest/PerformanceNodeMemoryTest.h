@@ -0,0 +1,80 @@
+//
+//  PerformanceNodeMemoryTest.h
+
+#ifndef __PERFORMANCE_NODE_MEMORY_TEST_H__
+#define __PERFORMANCE_NODE_MEMORY_TEST_H__
+
+#include "PerformanceTest.h"
+
+class NodeMemoryBasicLayer : public PerformBasicLayer
+{
+public:
+    NodeMemoryBasicLayer(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0);
+
+    virtual void showCurrentTest();
+};
+
+// Creates N plain nodes and reports their memory and the time a visit() of all of them takes
+class PerformanceNodeMemoryScene : public Scene
+{
+public:
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const;
+    virtual std::string subtitle() const;
+
+    void dumpProfilerInfo(float dt);
+protected:
+    // sets up the node i of the tree, returns true when it needed state of the extra data block
+    virtual bool prepareNode(Node* node, int i) = 0;
+
+    void onQuantityChanged(Ref* sender, int delta);
+    void createNodes();
+    void measureVisit(float dt);
+    void updateQuantityLabel();
+
+    Node* _root;
+    Label* _memoryLabel;
+    Label* _resultLabel;
+    Label* _quantityLabel;
+    std::string _profileName;
+    int _quantity;
+    int _extraDataCount;
+};
+
+class NodeMemoryPlainPerfTest : public PerformanceNodeMemoryScene
+{
+public:
+    CREATE_FUNC(NodeMemoryPlainPerfTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+protected:
+    virtual bool prepareNode(Node* node, int i) override;
+};
+
+class NodeMemoryUserDataPerfTest : public PerformanceNodeMemoryScene
+{
+public:
+    CREATE_FUNC(NodeMemoryUserDataPerfTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+protected:
+    virtual bool prepareNode(Node* node, int i) override;
+};
+
+class NodeMemoryInverseTransformPerfTest : public PerformanceNodeMemoryScene
+{
+public:
+    CREATE_FUNC(NodeMemoryInverseTransformPerfTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+protected:
+    virtual bool prepareNode(Node* node, int i) override;
+};
+
+void runNodeMemoryPerformanceTest();
+
+#endif /* __PERFORMANCE_NODE_MEMORY_TEST_H__ */
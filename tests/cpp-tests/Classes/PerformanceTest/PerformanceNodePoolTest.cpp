@@ -0,0 +1,295 @@
+//
+//  PerformanceNodePoolTest.cpp
+//
+
+#include "PerformanceNodePoolTest.h"
+#include <chrono>
+
+// Enable profiles for this file
+#undef CC_PROFILER_DISPLAY_TIMERS
+#define CC_PROFILER_DISPLAY_TIMERS() Profiler::getInstance()->displayTimers()
+#undef CC_PROFILER_PURGE_ALL
+#define CC_PROFILER_PURGE_ALL() Profiler::getInstance()->releaseAllTimers()
+
+#undef CC_PROFILER_START
+#define CC_PROFILER_START(__name__) ProfilingBeginTimingBlock(__name__)
+#undef CC_PROFILER_STOP
+#define CC_PROFILER_STOP(__name__) ProfilingEndTimingBlock(__name__)
+
+static std::function<PerformanceNodePoolScene*()> createFunctions[] =
+{
+    CL(NodePoolCreatePerfTest),
+    CL(NodePoolRecyclePerfTest),
+};
+
+#define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
+
+static const int kBulletsIncrease = 50;
+static const int kMaxBullets = 1000;
+static const float kBulletLifetime = 1.0f;
+
+static int g_curCase = 0;
+static int g_quantity = 100;
+
+////////////////////////////////////////////////////////
+//
+// NodePoolBasicLayer
+//
+////////////////////////////////////////////////////////
+
+NodePoolBasicLayer::NodePoolBasicLayer(bool bControlMenuVisible, int nMaxCases, int nCurCase)
+: PerformBasicLayer(bControlMenuVisible, nMaxCases, nCurCase)
+{
+}
+
+void NodePoolBasicLayer::showCurrentTest()
+{
+    auto scene = createFunctions[_curCase]();
+
+    g_curCase = _curCase;
+
+    if (scene)
+    {
+        Director::getInstance()->replaceScene(scene);
+    }
+}
+
+////////////////////////////////////////////////////////
+//
+// PerformanceNodePoolScene
+//
+////////////////////////////////////////////////////////
+
+void PerformanceNodePoolScene::onEnter()
+{
+    Scene::onEnter();
+
+    CC_PROFILER_PURGE_ALL();
+
+    auto s = Director::getInstance()->getWinSize();
+    _quantity = g_quantity;
+    _elapsed = 0;
+    _spawnTime = 0;
+    _frames = 0;
+
+    _bulletLayer = Node::create();
+    addChild(_bulletLayer);
+
+    auto menuLayer = new NodePoolBasicLayer(true, MAX_LAYER, g_curCase);
+    addChild(menuLayer);
+    menuLayer->release();
+
+    // Title
+    auto label = Label::createWithTTF(title().c_str(), "fonts/arial.ttf", 32);
+    addChild(label, 1);
+    label->setPosition(Vec2(s.width/2, s.height-50));
+
+    // Subtitle
+    std::string strSubTitle = subtitle();
+    if(strSubTitle.length())
+    {
+        auto l = Label::createWithTTF(strSubTitle.c_str(), "fonts/Thonburi.ttf", 16);
+        addChild(l, 1);
+        l->setPosition(Vec2(s.width/2, s.height-80));
+    }
+
+    MenuItemFont::setFontSize(65);
+    auto decrease = MenuItemFont::create(" - ", CC_CALLBACK_1(PerformanceNodePoolScene::onQuantityChanged, this, -kBulletsIncrease));
+    decrease->setColor(Color3B(0,200,20));
+    auto increase = MenuItemFont::create(" + ", CC_CALLBACK_1(PerformanceNodePoolScene::onQuantityChanged, this, kBulletsIncrease));
+    increase->setColor(Color3B(0,200,20));
+
+    auto menu = Menu::create(decrease, increase, NULL);
+    menu->alignItemsHorizontally();
+    menu->setPosition(Vec2(s.width/2, s.height-130));
+    addChild(menu, 1);
+
+    _quantityLabel = Label::createWithTTF("", "fonts/Marker Felt.ttf", 30);
+    _quantityLabel->setColor(Color3B(0,200,20));
+    _quantityLabel->setPosition(Vec2(s.width/2, s.height-170));
+    addChild(_quantityLabel, 1);
+
+    _resultLabel = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    _resultLabel->setPosition(Vec2(s.width/2, s.height-200));
+    addChild(_resultLabel, 1);
+
+    _allocatorLabel = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    _allocatorLabel->setPosition(Vec2(s.width/2, s.height-225));
+    addChild(_allocatorLabel, 1);
+
+    updateQuantityLabel();
+
+    scheduleUpdate();
+    schedule(schedule_selector(PerformanceNodePoolScene::showResults), 1.0f);
+    schedule(schedule_selector(PerformanceNodePoolScene::dumpProfilerInfo), 2.0f);
+}
+
+void PerformanceNodePoolScene::onExit()
+{
+    removeAllBullets();
+
+    Scene::onExit();
+}
+
+void PerformanceNodePoolScene::onQuantityChanged(Ref* sender, int delta)
+{
+    _quantity = std::min(std::max(_quantity + delta, kBulletsIncrease), kMaxBullets);
+    g_quantity = _quantity;
+    updateQuantityLabel();
+    CC_PROFILER_PURGE_ALL();
+}
+
+void PerformanceNodePoolScene::updateQuantityLabel()
+{
+    _quantityLabel->setString(StringUtils::format("%d bullets per frame", _quantity));
+}
+
+void PerformanceNodePoolScene::removeAllBullets()
+{
+    for (auto& bullet : _bullets)
+    {
+        removeBullet(bullet.first);
+    }
+    _bullets.clear();
+}
+
+void PerformanceNodePoolScene::update(float dt)
+{
+    auto s = Director::getInstance()->getWinSize();
+    _elapsed += dt;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    CC_PROFILER_START(title().c_str());
+
+    // the bullets all live as long, the oldest ones are at the front
+    while (!_bullets.empty() && _elapsed - _bullets.front().second > kBulletLifetime)
+    {
+        removeBullet(_bullets.front().first);
+        _bullets.pop_front();
+    }
+
+    for (int i = 0; i < _quantity; ++i)
+    {
+        auto bullet = spawnBullet();
+        bullet->setPosition(Vec2(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * s.height * 0.6f));
+        bullet->setRotation(CCRANDOM_0_1() * 360);
+        bullet->setScale(0.3f);
+        _bulletLayer->addChild(bullet);
+        _bullets.push_back(std::make_pair(bullet, _elapsed));
+    }
+
+    CC_PROFILER_STOP(title().c_str());
+    _spawnTime += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start).count() / 1000.0f;
+    _frames++;
+}
+
+void PerformanceNodePoolScene::showResults(float dt)
+{
+    if (_frames == 0)
+        return;
+
+    _resultLabel->setString(StringUtils::format("spawn and remove: %.3f ms per frame, %d bullets alive, %u live objects",
+                                                _spawnTime / _frames, (int)_bullets.size(), Ref::getLiveObjectCount()));
+    _spawnTime = 0;
+    _frames = 0;
+
+    std::string info = poolInfo();
+#if CC_ENABLE_NODE_SLAB_ALLOCATOR
+    const SlabAllocator::Stats& stats = Node::getAllocator()->getStats();
+    info += StringUtils::format("%snode allocations: %ld, live: %ld, slabs: %ld",
+                                info.empty() ? "" : ", ", (long)stats.allocations, (long)stats.liveObjects, (long)stats.slabs);
+#endif
+    _allocatorLabel->setString(info);
+}
+
+std::string PerformanceNodePoolScene::title() const
+{
+    return "No title";
+}
+
+std::string PerformanceNodePoolScene::subtitle() const
+{
+    return "";
+}
+
+void PerformanceNodePoolScene::dumpProfilerInfo(float dt)
+{
+	CC_PROFILER_DISPLAY_TIMERS();
+}
+
+////////////////////////////////////////////////////////
+//
+// NodePoolCreatePerfTest
+//
+////////////////////////////////////////////////////////
+
+Sprite* NodePoolCreatePerfTest::spawnBullet()
+{
+    return Sprite::create("Images/r1.png");
+}
+
+void NodePoolCreatePerfTest::removeBullet(Sprite* bullet)
+{
+    bullet->removeFromParent();
+}
+
+std::string NodePoolCreatePerfTest::title() const
+{
+    return "Bullets, create and destroy";
+}
+
+std::string NodePoolCreatePerfTest::subtitle() const
+{
+    return "Every bullet is a new sprite, see console";
+}
+
+////////////////////////////////////////////////////////
+//
+// NodePoolRecyclePerfTest
+//
+////////////////////////////////////////////////////////
+
+NodePoolRecyclePerfTest::NodePoolRecyclePerfTest()
+: _pool([]() { return Sprite::create("Images/r1.png"); })
+{
+}
+
+void NodePoolRecyclePerfTest::onExit()
+{
+    PerformanceNodePoolScene::onExit();
+    _pool.clear();
+}
+
+Sprite* NodePoolRecyclePerfTest::spawnBullet()
+{
+    return _pool.obtain();
+}
+
+void NodePoolRecyclePerfTest::removeBullet(Sprite* bullet)
+{
+    _pool.recycle(bullet);
+}
+
+std::string NodePoolRecyclePerfTest::poolInfo() const
+{
+    auto stats = _pool.getStats();
+    return StringUtils::format("pool: %ld created, %ld reused, %ld available",
+                               (long)stats.created, (long)stats.reused, (long)stats.available);
+}
+
+std::string NodePoolRecyclePerfTest::title() const
+{
+    return "Bullets, NodePool";
+}
+
+std::string NodePoolRecyclePerfTest::subtitle() const
+{
+    return "The removed sprites are recycled, see console";
+}
+
+void runNodePoolPerformanceTest()
+{
+    auto scene = createFunctions[g_curCase]();
+
+    Director::getInstance()->replaceScene(scene);
+}
@@ -0,0 +1,81 @@
+//
+//  PerformanceNodePoolTest.h
+
+#ifndef __PERFORMANCE_NODE_POOL_TEST_H__
+#define __PERFORMANCE_NODE_POOL_TEST_H__
+
+#include "PerformanceTest.h"
+#include <deque>
+
+class NodePoolBasicLayer : public PerformBasicLayer
+{
+public:
+    NodePoolBasicLayer(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0);
+
+    virtual void showCurrentTest();
+};
+
+// Spawns N short lived sprites every frame, like the bullets of a shooter, and reports the time spent spawning and removing them
+class PerformanceNodePoolScene : public Scene
+{
+public:
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual void update(float dt) override;
+    virtual std::string title() const;
+    virtual std::string subtitle() const;
+
+    void dumpProfilerInfo(float dt);
+    void showResults(float dt);
+protected:
+    virtual Sprite* spawnBullet() = 0;
+    virtual void removeBullet(Sprite* bullet) = 0;
+    virtual std::string poolInfo() const { return ""; }
+
+    void onQuantityChanged(Ref* sender, int delta);
+    void updateQuantityLabel();
+    void removeAllBullets();
+
+    Node* _bulletLayer;
+    Label* _resultLabel;
+    Label* _allocatorLabel;
+    Label* _quantityLabel;
+    std::deque<std::pair<Sprite*, float>> _bullets;
+    float _elapsed;
+    float _spawnTime;
+    int _frames;
+    int _quantity;
+};
+
+class NodePoolCreatePerfTest : public PerformanceNodePoolScene
+{
+public:
+    CREATE_FUNC(NodePoolCreatePerfTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+protected:
+    virtual Sprite* spawnBullet() override;
+    virtual void removeBullet(Sprite* bullet) override;
+};
+
+class NodePoolRecyclePerfTest : public PerformanceNodePoolScene
+{
+public:
+    CREATE_FUNC(NodePoolRecyclePerfTest);
+
+    NodePoolRecyclePerfTest();
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+protected:
+    virtual Sprite* spawnBullet() override;
+    virtual void removeBullet(Sprite* bullet) override;
+    virtual std::string poolInfo() const override;
+
+    NodePool<Sprite> _pool;
+};
+
+void runNodePoolPerformanceTest();
+
+#endif /* __PERFORMANCE_NODE_POOL_TEST_H__ */
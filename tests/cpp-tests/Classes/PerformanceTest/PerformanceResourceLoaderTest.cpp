@@ -0,0 +1,407 @@
+//
+//  PerformanceResourceLoaderTest.cpp
+//
+
+#include "PerformanceResourceLoaderTest.h"
+#include "2d/CCFontAtlasCache.h"
+#include "2d/CCFontFNT.h"
+#include "base/CCThreadPool.h"
+#include <thread>
+
+static std::function<PerformanceResourceLoaderScene*()> createFunctions[] =
+{
+    CL(ResourceLoadSyncPerfTest),
+    CL(ResourceLoaderPerfTest),
+    CL(ResourceLoaderUnlimitedPerfTest),
+    CL(ResourceLoaderUpdateTest),
+};
+
+#define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
+
+// the assets of configs/resource-loader-manifest.plist
+static const char* s_manifest = "configs/resource-loader-manifest.plist";
+static const char* s_textures[] = { "Images/background1.png", "Images/background2.png", "Images/HelloWorld.png", "Images/atlastest.png", "Images/noise.png" };
+static const char* s_spriteSheets[] = { "animations/ghosts.plist" };
+static const char* s_animations = "animations/animations-2.plist";
+// the sprite sheets of animations-2.plist
+static const char* s_animationSheets[] = { "animations/grossini.plist", "animations/grossini_blue.plist", "animations/grossini_family.plist" };
+static const char* s_bitmapFonts[] = { "fonts/bitmapFontTest.fnt", "fonts/markerFelt.fnt" };
+static const char* s_ttfFont = "fonts/arial.ttf";
+static const int s_ttfSize = 40;
+static const char* s_ttfText = "0123456789 Loading... Level 1";
+
+static int g_curCase = 0;
+
+////////////////////////////////////////////////////////
+//
+// ResourceLoaderBasicLayer
+//
+////////////////////////////////////////////////////////
+
+ResourceLoaderBasicLayer::ResourceLoaderBasicLayer(bool bControlMenuVisible, int nMaxCases, int nCurCase)
+: PerformBasicLayer(bControlMenuVisible, nMaxCases, nCurCase)
+{
+}
+
+void ResourceLoaderBasicLayer::showCurrentTest()
+{
+    auto scene = createFunctions[_curCase]();
+
+    g_curCase = _curCase;
+
+    if (scene)
+    {
+        Director::getInstance()->replaceScene(scene);
+    }
+}
+
+////////////////////////////////////////////////////////
+//
+// PerformanceResourceLoaderScene
+//
+////////////////////////////////////////////////////////
+
+void PerformanceResourceLoaderScene::onEnter()
+{
+    Scene::onEnter();
+
+    _loading = false;
+    _framesToMeasure = 0;
+
+    auto s = Director::getInstance()->getWinSize();
+
+    auto menuLayer = new ResourceLoaderBasicLayer(true, MAX_LAYER, g_curCase);
+    addChild(menuLayer);
+    menuLayer->release();
+
+    // Title
+    auto label = Label::createWithTTF(title().c_str(), "fonts/arial.ttf", 32);
+    addChild(label, 1);
+    label->setPosition(Vec2(s.width/2, s.height-50));
+
+    // Subtitle
+    std::string strSubTitle = subtitle();
+    if(strSubTitle.length())
+    {
+        auto l = Label::createWithTTF(strSubTitle.c_str(), "fonts/Thonburi.ttf", 16);
+        addChild(l, 1);
+        l->setPosition(Vec2(s.width/2, s.height-80));
+    }
+
+    MenuItemFont::setFontSize(40);
+    auto load = MenuItemFont::create("Load", CC_CALLBACK_1(PerformanceResourceLoaderScene::onLoad, this));
+    load->setColor(Color3B(0,200,20));
+    auto menu = Menu::create(load, NULL);
+    menu->setPosition(Vec2(s.width/2, s.height-130));
+    addChild(menu, 1);
+
+    _resultLabel = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    _resultLabel->setPosition(Vec2(s.width/2, s.height/2));
+    addChild(_resultLabel, 1);
+
+    // shows the stalls of the loading
+    _spinner = Sprite::create("Images/grossini.png");
+    _spinner->setPosition(Vec2(s.width/2, s.height/4));
+    _spinner->runAction(RepeatForever::create(RotateBy::create(1, 360)));
+    addChild(_spinner);
+
+    scheduleUpdate();
+}
+
+void PerformanceResourceLoaderScene::onExit()
+{
+    Scene::onExit();
+
+    if (!_loading)
+    {
+        unloadAssets();
+    }
+}
+
+void PerformanceResourceLoaderScene::onLoad(Ref* sender)
+{
+    if (_loading || _framesToMeasure > 0)
+        return;
+
+    _resultLabel->setString("loading...");
+    _loading = true;
+    _frames = 0;
+    _worstFrame = 0;
+    _start = std::chrono::high_resolution_clock::now();
+    load();
+}
+
+void PerformanceResourceLoaderScene::finishLoading(int assetCount)
+{
+    _loadTime = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - _start).count();
+    _assetCount = assetCount;
+    _loading = false;
+    // the frame that follows a synchronous load shows its stall
+    _framesToMeasure = 2;
+}
+
+void PerformanceResourceLoaderScene::update(float dt)
+{
+    if (!_loading && _framesToMeasure == 0)
+        return;
+
+    _worstFrame = std::max(_worstFrame, dt);
+    _frames++;
+    if (!_loading && --_framesToMeasure == 0)
+    {
+        showResults();
+        unloadAssets();
+    }
+}
+
+void PerformanceResourceLoaderScene::showResults()
+{
+    _resultLabel->setString(StringUtils::format("%d assets loaded in %.1f ms\nlongest frame: %.1f ms over %d frames, %d worker threads",
+                                                _assetCount, _loadTime * 1000, _worstFrame * 1000, _frames,
+                                                ThreadPool::getInstance()->getThreadCount()));
+}
+
+void PerformanceResourceLoaderScene::unloadAssets()
+{
+    // so that the next load starts from empty caches
+    AnimationCache::destroyInstance();
+    auto spriteFrameCache = SpriteFrameCache::getInstance();
+    for (auto sheet : s_spriteSheets)
+    {
+        spriteFrameCache->removeSpriteFramesFromFile(sheet);
+    }
+    for (auto sheet : s_animationSheets)
+    {
+        spriteFrameCache->removeSpriteFramesFromFile(sheet);
+    }
+    FontFNT::purgeCachedData();
+    Director::getInstance()->getTextureCache()->removeUnusedTextures();
+}
+
+std::string PerformanceResourceLoaderScene::title() const
+{
+    return "No title";
+}
+
+std::string PerformanceResourceLoaderScene::subtitle() const
+{
+    return "";
+}
+
+////////////////////////////////////////////////////////
+//
+// ResourceLoadSyncPerfTest
+//
+////////////////////////////////////////////////////////
+
+void ResourceLoadSyncPerfTest::load()
+{
+    int count = 0;
+    auto textureCache = Director::getInstance()->getTextureCache();
+    for (auto texture : s_textures)
+    {
+        textureCache->addImage(texture);
+        count++;
+    }
+    for (auto sheet : s_spriteSheets)
+    {
+        SpriteFrameCache::getInstance()->addSpriteFramesWithFile(sheet);
+        // and its texture
+        count += 2;
+    }
+    AnimationCache::getInstance()->addAnimationsWithFile(s_animations);
+    // the animations, their sheets and the textures of the sheets
+    count += 1 + 2 * sizeof(s_animationSheets) / sizeof(s_animationSheets[0]);
+
+    // like the loader, the atlases are released once loaded
+    std::vector<FontAtlas*> atlases;
+    for (auto font : s_bitmapFonts)
+    {
+        atlases.push_back(FontAtlasCache::getFontAtlasFNT(font));
+        count += 2;
+    }
+    auto ttfAtlas = FontAtlasCache::getFontAtlasTTF(TTFConfig(s_ttfFont, s_ttfSize));
+    if (ttfAtlas)
+    {
+        std::u16string text;
+        StringUtils::UTF8ToUTF16(s_ttfText, text);
+        ttfAtlas->prepareLetterDefinitions(text);
+    }
+    atlases.push_back(ttfAtlas);
+    count++;
+
+    for (auto atlas : atlases)
+    {
+        if (atlas)
+        {
+            FontAtlasCache::releaseFontAtlas(atlas);
+        }
+    }
+
+    finishLoading(count);
+}
+
+std::string ResourceLoadSyncPerfTest::title() const
+{
+    return "Synchronous loading";
+}
+
+std::string ResourceLoadSyncPerfTest::subtitle() const
+{
+    return "The assets are loaded by the caches in one frame";
+}
+
+////////////////////////////////////////////////////////
+//
+// ResourceLoaderPerfTest
+//
+////////////////////////////////////////////////////////
+
+void ResourceLoaderPerfTest::load()
+{
+    auto loader = ResourceLoader::create();
+    loader->addManifest(s_manifest);
+    loader->setMaxUploadsPerFrame(getMaxUploadsPerFrame());
+    loader->setProgressCallback([this](int finished, int total) {
+        _resultLabel->setString(StringUtils::format("loading... %d / %d", finished, total));
+    });
+    // the scene may be replaced while loading
+    retain();
+    loader->setCompletionCallback([this, loader](bool succeeded) {
+        if (!succeeded)
+        {
+            CCLOG("ResourceLoaderPerfTest: %d assets failed", loader->getFailedCount());
+        }
+        finishLoading(loader->getTotalCount());
+        if (!isRunning())
+        {
+            unloadAssets();
+        }
+        release();
+    });
+    loader->start();
+}
+
+std::string ResourceLoaderPerfTest::title() const
+{
+    return "ResourceLoader";
+}
+
+std::string ResourceLoaderPerfTest::subtitle() const
+{
+    return "Decoded on the ThreadPool, 2 GL uploads per frame";
+}
+
+////////////////////////////////////////////////////////
+//
+// ResourceLoaderUnlimitedPerfTest
+//
+////////////////////////////////////////////////////////
+
+std::string ResourceLoaderUnlimitedPerfTest::title() const
+{
+    return "ResourceLoader, no upload limit";
+}
+
+std::string ResourceLoaderUnlimitedPerfTest::subtitle() const
+{
+    return "Decoded on the ThreadPool, uploaded as soon as they are decoded";
+}
+
+////////////////////////////////////////////////////////
+//
+// ResourceLoaderUpdateTest
+//
+////////////////////////////////////////////////////////
+
+void ResourceLoaderUpdateTest::load()
+{
+    static const char* files[] = { "configs/config-example.plist", "configs/config-test-ok.plist", "configs/resource-loader-manifest.plist" };
+    static const char* missingFile = "configs/missing-file.plist";
+
+    auto loader = ResourceLoader::create();
+    for (auto file : files)
+    {
+        loader->addAsset(file, "data");
+    }
+    loader->addAsset(missingFile, "data");
+
+    int progressCalls = 0;
+    int lastFinished = 0;
+    bool progressOrdered = true;
+    int completionCalls = 0;
+    bool completionSucceeded = true;
+    loader->setProgressCallback([&](int finished, int total) {
+        ++progressCalls;
+        progressOrdered = progressOrdered && finished == lastFinished + 1 && finished <= total;
+        lastFinished = finished;
+    });
+    loader->setCompletionCallback([&](bool succeeded) {
+        ++completionCalls;
+        completionSucceeded = succeeded;
+    });
+
+    // the loads run on the ThreadPool, update() picks them up
+    for (int i = 0; i < 5000 && !loader->isDone(); ++i)
+    {
+        loader->update(0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    // more updates don't call the callbacks again
+    loader->update(0);
+
+    int total = loader->getTotalCount();
+    bool dataLoaded = true;
+    for (auto file : files)
+    {
+        const Data& data = loader->getData(file);
+        dataLoaded = dataLoaded && !data.isNull() && data.getSize() == FileUtils::getInstance()->getDataFromFile(file).getSize();
+    }
+
+    std::vector<std::string> failures;
+    if (!loader->isDone())
+        failures.push_back("not done");
+    if (progressCalls != total || !progressOrdered || lastFinished != total)
+        failures.push_back(StringUtils::format("progress: %d calls, last %d / %d", progressCalls, lastFinished, total));
+    if (completionCalls != 1 || completionSucceeded)
+        failures.push_back(StringUtils::format("completion: %d calls, succeeded %d", completionCalls, completionSucceeded));
+    if (loader->getFailedCount() != 1 || !loader->getData(missingFile).isNull())
+        failures.push_back(StringUtils::format("%d failed assets", loader->getFailedCount()));
+    if (!dataLoaded)
+        failures.push_back("wrong data");
+    // the loads in flight release the loader once they are picked up
+    if (loader->getReferenceCount() != 1)
+        failures.push_back(StringUtils::format("reference count %u", loader->getReferenceCount()));
+
+    _checkResult = failures.empty() ? "passed" : "FAILED";
+    for (const auto& failure : failures)
+    {
+        CCLOG("ResourceLoaderUpdateTest: %s", failure.c_str());
+        _checkResult += "\n" + failure;
+    }
+
+    finishLoading(total);
+}
+
+void ResourceLoaderUpdateTest::showResults()
+{
+    _resultLabel->setString(StringUtils::format("%d assets loaded in %.1f ms by update()\n%s",
+                                                _assetCount, _loadTime * 1000, _checkResult.c_str()));
+}
+
+std::string ResourceLoaderUpdateTest::title() const
+{
+    return "ResourceLoader driven by update()";
+}
+
+std::string ResourceLoaderUpdateTest::subtitle() const
+{
+    return "Data assets and a missing file, checks the progress and completion callbacks";
+}
+
+void runResourceLoaderPerformanceTest()
+{
+    auto scene = createFunctions[g_curCase]();
+
+    Director::getInstance()->replaceScene(scene);
+}
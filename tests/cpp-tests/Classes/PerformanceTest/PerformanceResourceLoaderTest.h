@@ -0,0 +1,99 @@
+//
+//  PerformanceResourceLoaderTest.h
+
+#ifndef __PERFORMANCE_RESOURCE_LOADER_TEST_H__
+#define __PERFORMANCE_RESOURCE_LOADER_TEST_H__
+
+#include "PerformanceTest.h"
+#include <chrono>
+
+class ResourceLoaderBasicLayer : public PerformBasicLayer
+{
+public:
+    ResourceLoaderBasicLayer(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0);
+
+    virtual void showCurrentTest();
+};
+
+// Loads the assets of configs/resource-loader-manifest.plist each time "Load" is pressed, and reports the loading time
+// and the longest frame, which is the stall seen by the running scene. The caches are emptied after each load.
+class PerformanceResourceLoaderScene : public Scene
+{
+public:
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual void update(float dt) override;
+    virtual std::string title() const;
+    virtual std::string subtitle() const;
+
+protected:
+    virtual void load() = 0;
+    void finishLoading(int assetCount);
+    void unloadAssets();
+    virtual void showResults();
+    void onLoad(Ref* sender);
+
+    Label* _resultLabel;
+    Sprite* _spinner;
+    bool _loading;
+    int _framesToMeasure;
+    int _frames;
+    int _assetCount;
+    float _worstFrame;
+    double _loadTime;
+    std::chrono::high_resolution_clock::time_point _start;
+};
+
+class ResourceLoadSyncPerfTest : public PerformanceResourceLoaderScene
+{
+public:
+    CREATE_FUNC(ResourceLoadSyncPerfTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+protected:
+    virtual void load() override;
+};
+
+class ResourceLoaderPerfTest : public PerformanceResourceLoaderScene
+{
+public:
+    CREATE_FUNC(ResourceLoaderPerfTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+protected:
+    virtual void load() override;
+    // 0 for no limit
+    virtual int getMaxUploadsPerFrame() const { return 2; }
+};
+
+class ResourceLoaderUnlimitedPerfTest : public ResourceLoaderPerfTest
+{
+public:
+    CREATE_FUNC(ResourceLoaderUnlimitedPerfTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+protected:
+    virtual int getMaxUploadsPerFrame() const override { return 0; }
+};
+
+// Drives a loader of "data" assets with update() only, without a scheduler nor GL uploads, and checks its callbacks
+class ResourceLoaderUpdateTest : public PerformanceResourceLoaderScene
+{
+public:
+    CREATE_FUNC(ResourceLoaderUpdateTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+protected:
+    virtual void load() override;
+    virtual void showResults() override;
+
+    std::string _checkResult;
+};
+
+void runResourceLoaderPerformanceTest();
+
+#endif /* __PERFORMANCE_RESOURCE_LOADER_TEST_H__ */
@@ -0,0 +1,286 @@
+//
+//  PerformanceSpineTest.cpp
+//
+
+#include "PerformanceSpineTest.h"
+#include <spine/extension.h>
+#include <chrono>
+
+// Enable profiles for this file
+#undef CC_PROFILER_DISPLAY_TIMERS
+#define CC_PROFILER_DISPLAY_TIMERS() Profiler::getInstance()->displayTimers()
+#undef CC_PROFILER_PURGE_ALL
+#define CC_PROFILER_PURGE_ALL() Profiler::getInstance()->releaseAllTimers()
+
+#undef CC_PROFILER_START
+#define CC_PROFILER_START(__name__) ProfilingBeginTimingBlock(__name__)
+#undef CC_PROFILER_STOP
+#define CC_PROFILER_STOP(__name__) ProfilingEndTimingBlock(__name__)
+
+static std::function<PerformanceSpineScene*()> createFunctions[] =
+{
+    CL(SpineSpawnJsonPerfTest),
+    CL(SpineSpawnBinaryPerfTest),
+    CL(SpineSpawnSharedJsonPerfTest),
+    CL(SpineSpawnSharedBinaryPerfTest),
+};
+
+#define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
+
+static const int kInstancesIncrease = 10;
+static const int kMaxInstances = 200;
+
+static int g_curCase = 0;
+static int g_quantity = 50;
+
+// spine allocates everything but its strings through _malloc(), the bytes are counted while spawning
+static size_t s_spineAllocatedBytes = 0;
+
+static void* countingMalloc(size_t size)
+{
+    s_spineAllocatedBytes += size;
+    return malloc(size);
+}
+
+////////////////////////////////////////////////////////
+//
+// SpineBasicLayer
+//
+////////////////////////////////////////////////////////
+
+SpineBasicLayer::SpineBasicLayer(bool bControlMenuVisible, int nMaxCases, int nCurCase)
+: PerformBasicLayer(bControlMenuVisible, nMaxCases, nCurCase)
+{
+}
+
+void SpineBasicLayer::showCurrentTest()
+{
+    auto scene = createFunctions[_curCase]();
+
+    g_curCase = _curCase;
+
+    if (scene)
+    {
+        Director::getInstance()->replaceScene(scene);
+    }
+}
+
+////////////////////////////////////////////////////////
+//
+// PerformanceSpineScene
+//
+////////////////////////////////////////////////////////
+
+void PerformanceSpineScene::onEnter()
+{
+    Scene::onEnter();
+
+    CC_PROFILER_PURGE_ALL();
+    _setMalloc(countingMalloc);
+
+    auto s = Director::getInstance()->getWinSize();
+    _quantity = g_quantity;
+    _profileName = StringUtils::format("spawn %s%s", isShared() ? "shared " : "", skeletonFile());
+
+    _instances = Node::create();
+    addChild(_instances);
+
+    auto menuLayer = new SpineBasicLayer(true, MAX_LAYER, g_curCase);
+    addChild(menuLayer);
+    menuLayer->release();
+
+    // Title
+    auto label = Label::createWithTTF(title().c_str(), "fonts/arial.ttf", 32);
+    addChild(label, 1);
+    label->setPosition(Vec2(s.width/2, s.height-50));
+
+    // Subtitle
+    std::string strSubTitle = subtitle();
+    if(strSubTitle.length())
+    {
+        auto l = Label::createWithTTF(strSubTitle.c_str(), "fonts/Thonburi.ttf", 16);
+        addChild(l, 1);
+        l->setPosition(Vec2(s.width/2, s.height-80));
+    }
+
+    MenuItemFont::setFontSize(65);
+    auto decrease = MenuItemFont::create(" - ", CC_CALLBACK_1(PerformanceSpineScene::onQuantityChanged, this, -kInstancesIncrease));
+    decrease->setColor(Color3B(0,200,20));
+    auto increase = MenuItemFont::create(" + ", CC_CALLBACK_1(PerformanceSpineScene::onQuantityChanged, this, kInstancesIncrease));
+    increase->setColor(Color3B(0,200,20));
+
+    auto menu = Menu::create(decrease, increase, NULL);
+    menu->alignItemsHorizontally();
+    menu->setPosition(Vec2(s.width/2, s.height-130));
+    addChild(menu, 1);
+
+    _quantityLabel = Label::createWithTTF("", "fonts/Marker Felt.ttf", 30);
+    _quantityLabel->setColor(Color3B(0,200,20));
+    _quantityLabel->setPosition(Vec2(s.width/2, s.height-170));
+    addChild(_quantityLabel, 1);
+
+    _resultLabel = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    _resultLabel->setPosition(Vec2(s.width/2, s.height-200));
+    addChild(_resultLabel, 1);
+
+    updateQuantityLabel();
+    spawn(0);
+
+    schedule(schedule_selector(PerformanceSpineScene::spawn), 2.0f);
+    schedule(schedule_selector(PerformanceSpineScene::dumpProfilerInfo), 2.0f);
+}
+
+void PerformanceSpineScene::onExit()
+{
+    removeInstances();
+    _setMalloc(malloc);
+
+    Scene::onExit();
+}
+
+void PerformanceSpineScene::onQuantityChanged(Ref* sender, int delta)
+{
+    _quantity = std::min(std::max(_quantity + delta, kInstancesIncrease), kMaxInstances);
+    g_quantity = _quantity;
+    updateQuantityLabel();
+    CC_PROFILER_PURGE_ALL();
+}
+
+void PerformanceSpineScene::updateQuantityLabel()
+{
+    _quantityLabel->setString(StringUtils::format("%d instances", _quantity));
+}
+
+void PerformanceSpineScene::removeInstances()
+{
+    // the instances that don't share their data are removed before their atlases
+    _instances->removeAllChildren();
+    for (auto atlas : _atlases)
+    {
+        spAtlas_dispose(atlas);
+    }
+    _atlases.clear();
+}
+
+void PerformanceSpineScene::spawn(float dt)
+{
+    removeInstances();
+
+    auto s = Director::getInstance()->getWinSize();
+    int columns = std::max(1, (int)sqrtf(_quantity * 2.0f));
+
+    s_spineAllocatedBytes = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    CC_PROFILER_START(_profileName.c_str());
+    for (int i = 0; i < _quantity; ++i)
+    {
+        spine::SkeletonAnimation* skeleton;
+        if (isShared())
+        {
+            skeleton = spine::SkeletonAnimation::createWithFile(skeletonFile(), "spine/spineboy.atlas", 0.3f);
+        }
+        else
+        {
+            // what the constructor taking an atlas file used to do for every instance
+            spAtlas* atlas = spAtlas_readAtlasFile("spine/spineboy.atlas");
+            _atlases.push_back(atlas);
+            skeleton = spine::SkeletonAnimation::createWithFile(skeletonFile(), atlas, 0.3f);
+        }
+        skeleton->setAnimation(0, "walk", true);
+        skeleton->setPosition(Vec2((i % columns + 0.5f) * s.width / columns, 20 + (i / columns) * 30 % (int)(s.height / 2)));
+        _instances->addChild(skeleton);
+    }
+    CC_PROFILER_STOP(_profileName.c_str());
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start);
+
+    auto stats = spine::SkeletonDataCache::getInstance()->getStats();
+    _resultLabel->setString(StringUtils::format("spawn: %.2f ms, spine allocations: %d KB, cached data: %d, loads: %d",
+                                                duration.count() / 1000.0f, (int)(s_spineAllocatedBytes / 1024),
+                                                stats.skeletonDataCount, stats.loads));
+}
+
+std::string PerformanceSpineScene::title() const
+{
+    return "No title";
+}
+
+std::string PerformanceSpineScene::subtitle() const
+{
+    return "";
+}
+
+void PerformanceSpineScene::dumpProfilerInfo(float dt)
+{
+	CC_PROFILER_DISPLAY_TIMERS();
+}
+
+////////////////////////////////////////////////////////
+//
+// SpineSpawnJsonPerfTest
+//
+////////////////////////////////////////////////////////
+
+std::string SpineSpawnJsonPerfTest::title() const
+{
+    return "Spine spawn, json per instance";
+}
+
+std::string SpineSpawnJsonPerfTest::subtitle() const
+{
+    return "Every instance reads the atlas and parses the json, see console";
+}
+
+////////////////////////////////////////////////////////
+//
+// SpineSpawnBinaryPerfTest
+//
+////////////////////////////////////////////////////////
+
+std::string SpineSpawnBinaryPerfTest::title() const
+{
+    return "Spine spawn, binary per instance";
+}
+
+std::string SpineSpawnBinaryPerfTest::subtitle() const
+{
+    return "Every instance reads the atlas and the .skb file, see console";
+}
+
+////////////////////////////////////////////////////////
+//
+// SpineSpawnSharedJsonPerfTest
+//
+////////////////////////////////////////////////////////
+
+std::string SpineSpawnSharedJsonPerfTest::title() const
+{
+    return "Spine spawn, shared json data";
+}
+
+std::string SpineSpawnSharedJsonPerfTest::subtitle() const
+{
+    return "The instances share the data of the SkeletonDataCache, see console";
+}
+
+////////////////////////////////////////////////////////
+//
+// SpineSpawnSharedBinaryPerfTest
+//
+////////////////////////////////////////////////////////
+
+std::string SpineSpawnSharedBinaryPerfTest::title() const
+{
+    return "Spine spawn, shared binary data";
+}
+
+std::string SpineSpawnSharedBinaryPerfTest::subtitle() const
+{
+    return "The instances share the data read from the .skb file, see console";
+}
+
+void runSpinePerformanceTest()
+{
+    auto scene = createFunctions[g_curCase]();
+
+    Director::getInstance()->replaceScene(scene);
+}
@@ -0,0 +1,95 @@
+//
+//  PerformanceSpineTest.h
+
+#ifndef __PERFORMANCE_SPINE_TEST_H__
+#define __PERFORMANCE_SPINE_TEST_H__
+
+#include "PerformanceTest.h"
+#include <spine/spine-cocos2dx.h>
+
+class SpineBasicLayer : public PerformBasicLayer
+{
+public:
+    SpineBasicLayer(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0);
+
+    virtual void showCurrentTest();
+};
+
+// Spawns the same character N times every 2 seconds and reports the time and the spine allocations of the spawn
+class PerformanceSpineScene : public Scene
+{
+public:
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const;
+    virtual std::string subtitle() const;
+
+    void dumpProfilerInfo(float dt);
+protected:
+    virtual bool isShared() const = 0;
+    virtual const char* skeletonFile() const = 0;
+
+    void onQuantityChanged(Ref* sender, int delta);
+    void spawn(float dt);
+    void removeInstances();
+    void updateQuantityLabel();
+
+    Node* _instances;
+    Label* _resultLabel;
+    Label* _quantityLabel;
+    std::vector<spAtlas*> _atlases; // atlases of the instances that don't share their data
+    std::string _profileName;
+    int _quantity;
+};
+
+class SpineSpawnJsonPerfTest : public PerformanceSpineScene
+{
+public:
+    CREATE_FUNC(SpineSpawnJsonPerfTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+protected:
+    virtual bool isShared() const override { return false; }
+    virtual const char* skeletonFile() const override { return "spine/spineboy.json"; }
+};
+
+class SpineSpawnBinaryPerfTest : public PerformanceSpineScene
+{
+public:
+    CREATE_FUNC(SpineSpawnBinaryPerfTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+protected:
+    virtual bool isShared() const override { return false; }
+    virtual const char* skeletonFile() const override { return "spine/spineboy.skb"; }
+};
+
+class SpineSpawnSharedJsonPerfTest : public PerformanceSpineScene
+{
+public:
+    CREATE_FUNC(SpineSpawnSharedJsonPerfTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+protected:
+    virtual bool isShared() const override { return true; }
+    virtual const char* skeletonFile() const override { return "spine/spineboy.json"; }
+};
+
+class SpineSpawnSharedBinaryPerfTest : public PerformanceSpineScene
+{
+public:
+    CREATE_FUNC(SpineSpawnSharedBinaryPerfTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+protected:
+    virtual bool isShared() const override { return true; }
+    virtual const char* skeletonFile() const override { return "spine/spineboy.skb"; }
+};
+
+void runSpinePerformanceTest();
+
+#endif /* __PERFORMANCE_SPINE_TEST_H__ */
@@ -0,0 +1,240 @@
+//
+//  PerformanceTMXTest.cpp
+//
+
+#include "PerformanceTMXTest.h"
+#include "base/base64.h"
+
+// Enable profiles for this file
+#undef CC_PROFILER_DISPLAY_TIMERS
+#define CC_PROFILER_DISPLAY_TIMERS() Profiler::getInstance()->displayTimers()
+#undef CC_PROFILER_PURGE_ALL
+#define CC_PROFILER_PURGE_ALL() Profiler::getInstance()->releaseAllTimers()
+
+#undef CC_PROFILER_START
+#define CC_PROFILER_START(__name__) ProfilingBeginTimingBlock(__name__)
+#undef CC_PROFILER_STOP
+#define CC_PROFILER_STOP(__name__) ProfilingEndTimingBlock(__name__)
+
+static std::function<PerformanceTMXScene*()> createFunctions[] =
+{
+    CL(TMXParsePerfTest),
+    CL(TMXSnapshotPerfTest),
+};
+
+#define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
+
+
+static int g_curCase = 0;
+
+////////////////////////////////////////////////////////
+//
+// TMXBasicLayer
+//
+////////////////////////////////////////////////////////
+
+TMXBasicLayer::TMXBasicLayer(bool bControlMenuVisible, int nMaxCases, int nCurCase)
+: PerformBasicLayer(bControlMenuVisible, nMaxCases, nCurCase)
+{
+}
+
+void TMXBasicLayer::showCurrentTest()
+{
+    auto scene = createFunctions[_curCase]();
+
+    g_curCase = _curCase;
+
+    if (scene)
+    {
+        Director::getInstance()->replaceScene(scene);
+    }
+}
+
+////////////////////////////////////////////////////////
+//
+// PerformanceTMXScene
+//
+////////////////////////////////////////////////////////
+
+void PerformanceTMXScene::onEnter()
+{
+    Scene::onEnter();
+
+    CC_PROFILER_PURGE_ALL();
+
+    auto s = Director::getInstance()->getWinSize();
+
+    auto menuLayer = new TMXBasicLayer(true, MAX_LAYER, g_curCase);
+    addChild(menuLayer);
+    menuLayer->release();
+
+    // Title
+    auto label = Label::createWithTTF(title().c_str(), "fonts/arial.ttf", 32);
+    addChild(label, 1);
+    label->setPosition(Vec2(s.width/2, s.height-50));
+
+    // Subtitle
+    std::string strSubTitle = subtitle();
+    if(strSubTitle.length())
+    {
+        auto l = Label::createWithTTF(strSubTitle.c_str(), "fonts/Thonburi.ttf", 16);
+        addChild(l, 1);
+        l->setPosition(Vec2(s.width/2, s.height-80));
+    }
+
+    generateMap();
+
+    getScheduler()->schedule(schedule_selector(PerformanceTMXScene::onUpdate), this, 0.0f, false);
+    getScheduler()->schedule(schedule_selector(PerformanceTMXScene::dumpProfilerInfo), this, 2, false);
+}
+
+void PerformanceTMXScene::generateMap()
+{
+    auto fileUtils = FileUtils::getInstance();
+    _mapPath = fileUtils->getWritablePath() + "PerformanceTMXTest.tmx";
+
+    if (fileUtils->isFileExist(_mapPath))
+    {
+        return;
+    }
+
+    std::string xml;
+    xml += StringUtils::format("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                               "<map version=\"1.0\" orientation=\"orthogonal\" width=\"%d\" height=\"%d\" tilewidth=\"32\" tileheight=\"32\">\n",
+                               MAP_SIZE, MAP_SIZE);
+    xml += " <properties>\n  <property name=\"level\" value=\"1\"/>\n </properties>\n";
+
+    xml += " <tileset firstgid=\"1\" name=\"desert\" tilewidth=\"32\" tileheight=\"32\" spacing=\"1\" margin=\"1\">\n"
+           "  <image source=\"tmw_desert_spacing.png\" width=\"265\" height=\"199\"/>\n";
+    for (int i = 0; i < 48; ++i)
+    {
+        xml += StringUtils::format("  <tile id=\"%d\">\n   <properties>\n    <property name=\"walkable\" value=\"%s\"/>\n   </properties>\n  </tile>\n",
+                                   i, i % 4 ? "true" : "false");
+    }
+    xml += " </tileset>\n";
+
+    // the base64 layers, as written by Tiled without compression
+    std::vector<uint32_t> tiles(MAP_SIZE * MAP_SIZE);
+    for (int layer = 0; layer < LAYER_COUNT; ++layer)
+    {
+        for (size_t i = 0; i < tiles.size(); ++i)
+        {
+            tiles[i] = (uint32_t)((i * 7 + layer) % 48 + 1);
+        }
+        char* encoded = nullptr;
+        base64Encode(reinterpret_cast<const unsigned char*>(tiles.data()), (unsigned int)(tiles.size() * sizeof(uint32_t)), &encoded);
+        xml += StringUtils::format(" <layer name=\"layer%d\" width=\"%d\" height=\"%d\">\n  <data encoding=\"base64\">\n   ", layer, MAP_SIZE, MAP_SIZE);
+        xml += encoded;
+        xml += "\n  </data>\n </layer>\n";
+        free(encoded);
+    }
+
+    xml += StringUtils::format(" <layer name=\"xml\" width=\"%d\" height=\"%d\">\n  <data>\n", XML_LAYER_SIZE, XML_LAYER_SIZE);
+    for (int i = 0; i < XML_LAYER_SIZE * XML_LAYER_SIZE; ++i)
+    {
+        xml += StringUtils::format("   <tile gid=\"%d\"/>\n", i % 48 + 1);
+    }
+    xml += "  </data>\n </layer>\n";
+
+    for (int group = 0; group < OBJECT_GROUP_COUNT; ++group)
+    {
+        xml += StringUtils::format(" <objectgroup name=\"group%d\" width=\"%d\" height=\"%d\">\n", group, MAP_SIZE, MAP_SIZE);
+        for (int i = 0; i < OBJECT_COUNT; ++i)
+        {
+            xml += StringUtils::format("  <object name=\"object%d\" type=\"enemy\" x=\"%d\" y=\"%d\" width=\"32\" height=\"32\">\n"
+                                       "   <properties>\n    <property name=\"hp\" value=\"%d\"/>\n   </properties>\n"
+                                       "   <polygon points=\"0,0 32,0 32,32 16,48 0,32\"/>\n  </object>\n",
+                                       i, (i * 37) % (MAP_SIZE * 32), (i * 91) % (MAP_SIZE * 32), 10 + i % 5);
+        }
+        xml += " </objectgroup>\n";
+    }
+    xml += "</map>\n";
+
+    FILE* fp = fopen(_mapPath.c_str(), "wb");
+    if (fp)
+    {
+        fwrite(xml.c_str(), xml.size(), 1, fp);
+        fclose(fp);
+    }
+}
+
+void PerformanceTMXScene::onUpdate(float dt)
+{
+    CC_PROFILER_START(_profileName.c_str());
+    auto mapInfo = TMXMapInfo::create(_mapPath);
+    CC_PROFILER_STOP(_profileName.c_str());
+    _placeHolder = mapInfo ? (int)mapInfo->getLayers().size() : 0;
+}
+
+std::string PerformanceTMXScene::title() const
+{
+    return "No title";
+}
+
+std::string PerformanceTMXScene::subtitle() const
+{
+    return "";
+}
+
+void PerformanceTMXScene::dumpProfilerInfo(float dt)
+{
+	CC_PROFILER_DISPLAY_TIMERS();
+}
+
+////////////////////////////////////////////////////////
+//
+// TMXParsePerfTest
+//
+////////////////////////////////////////////////////////
+
+void TMXParsePerfTest::onEnter()
+{
+    PerformanceTMXScene::onEnter();
+    _profileName = "TMXMapInfo::create(tmx)";
+}
+
+std::string TMXParsePerfTest::title() const
+{
+    return "TMX parse Perf test";
+}
+
+std::string TMXParsePerfTest::subtitle() const
+{
+    return "Parses a map with 8 base64 layers and 2000 objects every frame, see console";
+}
+
+////////////////////////////////////////////////////////
+//
+// TMXSnapshotPerfTest
+//
+////////////////////////////////////////////////////////
+
+void TMXSnapshotPerfTest::onEnter()
+{
+    TMXMapInfo::setSnapshotCacheEnabled(true);
+    PerformanceTMXScene::onEnter();
+    _profileName = "TMXMapInfo::create(snapshot)";
+}
+
+void TMXSnapshotPerfTest::onExit()
+{
+    TMXMapInfo::setSnapshotCacheEnabled(false);
+    PerformanceTMXScene::onExit();
+}
+
+std::string TMXSnapshotPerfTest::title() const
+{
+    return "TMX snapshot Perf test";
+}
+
+std::string TMXSnapshotPerfTest::subtitle() const
+{
+    return "Loads the same map from its snapshot every frame, see console";
+}
+
+void runTMXPerformanceTest()
+{
+    auto scene = createFunctions[g_curCase]();
+
+    Director::getInstance()->replaceScene(scene);
+}
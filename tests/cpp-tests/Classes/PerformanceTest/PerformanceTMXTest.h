@@ -0,0 +1,64 @@
+//
+//  PerformanceTMXTest.h
+
+#ifndef __PERFORMANCE_TMX_TEST_H__
+#define __PERFORMANCE_TMX_TEST_H__
+
+#include "PerformanceTest.h"
+
+class TMXBasicLayer : public PerformBasicLayer
+{
+public:
+    TMXBasicLayer(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0);
+
+    virtual void showCurrentTest();
+};
+
+// Loads the map info of a large generated map every frame, see the console for the timers
+class PerformanceTMXScene : public Scene
+{
+public:
+    virtual void onEnter() override;
+    virtual std::string title() const;
+    virtual std::string subtitle() const;
+    virtual void onUpdate(float dt);
+
+    void dumpProfilerInfo(float dt);
+protected:
+    // writes the map once: base64 layers, a xml layer, tile properties and object groups
+    void generateMap();
+
+    std::string _profileName;
+    std::string _mapPath;
+    int _placeHolder; // To avoid compiler optimization
+    static const int LAYER_COUNT = 8;
+    static const int MAP_SIZE = 128;
+    static const int XML_LAYER_SIZE = 48;
+    static const int OBJECT_GROUP_COUNT = 4;
+    static const int OBJECT_COUNT = 500;
+};
+
+class TMXParsePerfTest : public PerformanceTMXScene
+{
+public:
+    CREATE_FUNC(TMXParsePerfTest);
+
+    virtual void onEnter() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
+class TMXSnapshotPerfTest : public PerformanceTMXScene
+{
+public:
+    CREATE_FUNC(TMXSnapshotPerfTest);
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
+void runTMXPerformanceTest();
+
+#endif /* __PERFORMANCE_TMX_TEST_H__ */
@@ -12,6 +12,14 @@
 #include "PerformanceEventDispatcherTest.h"
 #include "PerformanceScenarioTest.h"
 #include "PerformanceCallbackTest.h"
+#include "PerformanceValueMapTest.h"
+#include "PerformanceSpineTest.h"
+#include "PerformanceNodeMemoryTest.h"
+#include "PerformanceNodePoolTest.h"
+#include "PerformanceArmatureTest.h"
+#include "PerformanceTMXTest.h"
+#include "PerformanceZipTest.h"
+#include "PerformanceResourceLoaderTest.h"
 
 enum
 {
@@ -36,6 +44,14 @@ struct {
     { "EventDispatcher Perf Test", [](Ref* sender ) { runEventDispatcherPerformanceTest(); } },
     { "Scenario Perf Test", [](Ref* sender ) { runScenarioTest(); } },
     { "Callback Perf Test", [](Ref* sender ) { runCallbackPerformanceTest(); } },
+    { "ValueMap Perf Test", [](Ref* sender ) { runValueMapPerformanceTest(); } },
+    { "Spine Perf Test", [](Ref* sender ) { runSpinePerformanceTest(); } },
+    { "Node Memory Perf Test", [](Ref* sender ) { runNodeMemoryPerformanceTest(); } },
+    { "Node Pool Perf Test", [](Ref* sender ) { runNodePoolPerformanceTest(); } },
+    { "Armature Perf Test", [](Ref* sender ) { runArmaturePerformanceTest(); } },
+    { "TMX Perf Test", [](Ref* sender ) { runTMXPerformanceTest(); } },
+    { "Zip Perf Test", [](Ref* sender ) { runZipPerformanceTest(); } },
+    { "ResourceLoader Perf Test", [](Ref* sender ) { runResourceLoaderPerformanceTest(); } },
 };
 
 static const int g_testMax = sizeof(g_testsName)/sizeof(g_testsName[0]);
@@ -1,8 +1,12 @@
 #include "PerformanceTextureTest.h"
+#include "base/etc1.h"
+#include "base/s3tc.h"
+#include "base/atitc.h"
+#include <cfloat>
 
 enum
 {
-    TEST_COUNT = 1,
+    TEST_COUNT = 4,
 };
 
 static int s_nTexCurCase = 0;
@@ -32,6 +36,15 @@ void TextureMenuLayer::showCurrentTest()
     case 0:
         scene = TextureTest::scene();
         break;
+    case 1:
+        scene = TextureConvertTest::scene();
+        break;
+    case 2:
+        scene = TextureDecodeTest::scene();
+        break;
+    case 3:
+        scene = SpriteSheetLoadTest::scene();
+        break;
     }
     s_nTexCurCase = _curCase;
 
@@ -348,7 +361,512 @@ std::string TextureTest::subtitle() const
 Scene* TextureTest::scene()
 {
     auto scene = Scene::create();
-    TextureTest *layer = new TextureTest(false, TEST_COUNT, s_nTexCurCase);
+    TextureTest *layer = new TextureTest(true, TEST_COUNT, s_nTexCurCase);
+    scene->addChild(layer);
+    layer->release();
+
+    return scene;
+}
+
+////////////////////////////////////////////////////////
+//
+// TextureConvertTest
+//
+////////////////////////////////////////////////////////
+
+// the scalar loops used by Texture2D before the conversions were vectorized and multi-threaded
+
+static void scalarRGBA8888ToRGBA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    unsigned short* out16 = (unsigned short*)outData;
+    for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
+    {
+        *out16++ = (data[i] & 0x00F0) << 8    //R
+        | (data[i + 1] & 0x00F0) << 4         //G
+        | (data[i + 2] & 0xF0)                //B
+        |  (data[i + 3] & 0xF0) >> 4;         //A
+    }
+}
+
+static void scalarRGBA8888ToRGB565(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    unsigned short* out16 = (unsigned short*)outData;
+    for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
+    {
+        *out16++ = (data[i] & 0x00F8) << 8    //R
+            | (data[i + 1] & 0x00FC) << 3     //G
+            | (data[i + 2] & 0x00F8) >> 3;    //B
+    }
+}
+
+static void scalarRGBA8888ToRGB5A1(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    unsigned short* out16 = (unsigned short*)outData;
+    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 4)
+    {
+        *out16++ = (data[i] & 0x00F8) << 8    //R
+            | (data[i + 1] & 0x00F8) << 3     //G
+            | (data[i + 2] & 0x00F8) >> 2     //B
+            |  (data[i + 3] & 0x0080) >> 7;   //A
+    }
+}
+
+static void scalarRGB888ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
+    {
+        *outData++ = data[i];         //R
+        *outData++ = data[i + 1];     //G
+        *outData++ = data[i + 2];     //B
+        *outData++ = 0xFF;            //A
+    }
+}
+
+static void scalarRGB888ToRGB565(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    unsigned short* out16 = (unsigned short*)outData;
+    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
+    {
+        *out16++ = (data[i] & 0x00F8) << 8    //R
+            | (data[i + 1] & 0x00FC) << 3     //G
+            | (data[i + 2] & 0x00F8) >> 3;    //B
+    }
+}
+
+static void scalarRGB888ToRGBA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    unsigned short* out16 = (unsigned short*)outData;
+    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
+    {
+        *out16++ = ((data[i] & 0x00F0) << 8           //R
+                    | (data[i + 1] & 0x00F0) << 4     //G
+                    | (data[i + 2] & 0xF0)            //B
+                    |  0x0F);                         //A
+    }
+}
+
+static void scalarI8ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    for (ssize_t i = 0; i < dataLen; ++i)
+    {
+        *outData++ = data[i];     //R
+        *outData++ = data[i];     //G
+        *outData++ = data[i];     //B
+        *outData++ = 0xFF;        //A
+    }
+}
+
+static void scalarAI88ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    for (ssize_t i = 0, l = dataLen - 1; i < l; i += 2)
+    {
+        *outData++ = data[i];     //R
+        *outData++ = data[i];     //G
+        *outData++ = data[i];     //B
+        *outData++ = data[i + 1]; //A
+    }
+}
+
+static void scalarPremultiply(unsigned char* data, ssize_t dataLen)
+{
+    unsigned int* tmp = (unsigned int*)data;
+    for (ssize_t i = 0, l = dataLen / 4; i < l; ++i)
+    {
+        unsigned char* p = data + i * 4;
+        tmp[i] = CC_RGB_PREMULTIPLY_ALPHA(p[0], p[1], p[2], p[3]);
+    }
+}
+
+static float elapsedMilliseconds(struct timeval *lastUpdate)
+{
+    return calculateDeltaTime(lastUpdate) * 1000.0f;
+}
+
+void TextureConvertTest::performTests()
+{
+    const int width = 2048;
+    const int height = 2048;
+    const ssize_t dataLen = width * height * 4;
+
+    unsigned char* pixels = (unsigned char*)malloc(dataLen);
+    for (ssize_t i = 0; i < dataLen; ++i)
+    {
+        pixels[i] = (unsigned char)(rand() & 0xFF);
+    }
+    // the largest output is RGBA8888
+    unsigned char* scalarOut = (unsigned char*)malloc(dataLen);
+
+    struct {
+        const char* name;
+        Texture2D::PixelFormat from;
+        int fromBytes;
+        Texture2D::PixelFormat format;
+        int formatBytes;
+        void (*scalar)(const unsigned char*, ssize_t, unsigned char*);
+    } cases[] = {
+        { "RGBA8888 > RGBA4444", Texture2D::PixelFormat::RGBA8888, 4, Texture2D::PixelFormat::RGBA4444, 2, scalarRGBA8888ToRGBA4444 },
+        { "RGBA8888 > RGB565", Texture2D::PixelFormat::RGBA8888, 4, Texture2D::PixelFormat::RGB565, 2, scalarRGBA8888ToRGB565 },
+        { "RGBA8888 > RGB5A1", Texture2D::PixelFormat::RGBA8888, 4, Texture2D::PixelFormat::RGB5A1, 2, scalarRGBA8888ToRGB5A1 },
+        { "RGB888 > RGBA8888", Texture2D::PixelFormat::RGB888, 3, Texture2D::PixelFormat::RGBA8888, 4, scalarRGB888ToRGBA8888 },
+        { "RGB888 > RGB565", Texture2D::PixelFormat::RGB888, 3, Texture2D::PixelFormat::RGB565, 2, scalarRGB888ToRGB565 },
+        { "RGB888 > RGBA4444", Texture2D::PixelFormat::RGB888, 3, Texture2D::PixelFormat::RGBA4444, 2, scalarRGB888ToRGBA4444 },
+        { "I8 > RGBA8888", Texture2D::PixelFormat::I8, 1, Texture2D::PixelFormat::RGBA8888, 4, scalarI8ToRGBA8888 },
+        { "AI88 > RGBA8888", Texture2D::PixelFormat::AI88, 2, Texture2D::PixelFormat::RGBA8888, 4, scalarAI88ToRGBA8888 },
+    };
+
+    std::string result;
+    char line[128];
+    struct timeval now;
+
+    log("--- 2048x2048 conversions ---");
+    for (auto& c : cases)
+    {
+        ssize_t inLen = (ssize_t)width * height * c.fromBytes;
+        ssize_t expectedLen = (ssize_t)width * height * c.formatBytes;
+
+        gettimeofday(&now, nullptr);
+        c.scalar(pixels, inLen, scalarOut);
+        float scalarTime = elapsedMilliseconds(&now);
+
+        unsigned char* outData = nullptr;
+        ssize_t outDataLen = 0;
+        gettimeofday(&now, nullptr);
+        Texture2D::convertDataToFormat(pixels, inLen, c.from, c.format, &outData, &outDataLen);
+        float fastTime = elapsedMilliseconds(&now);
+
+        bool same = outDataLen == expectedLen && memcmp(outData, scalarOut, outDataLen) == 0;
+        free(outData);
+
+        snprintf(line, sizeof(line), "%s: scalar %.2f ms, fast %.2f ms%s\n", c.name, scalarTime, fastTime, same ? "" : " (MISMATCH)");
+        log("%s", line);
+        result += line;
+    }
+
+    unsigned char* copy = (unsigned char*)malloc(dataLen);
+    memcpy(copy, pixels, dataLen);
+    gettimeofday(&now, nullptr);
+    scalarPremultiply(copy, dataLen);
+    float scalarTime = elapsedMilliseconds(&now);
+
+    auto image = new Image();
+    image->initWithRawData(pixels, dataLen, width, height, 8);
+    gettimeofday(&now, nullptr);
+    image->premultiplyAlpha();
+    float fastTime = elapsedMilliseconds(&now);
+
+    bool same = memcmp(image->getData(), copy, dataLen) == 0;
+    image->release();
+    free(copy);
+
+    snprintf(line, sizeof(line), "premultiply: scalar %.2f ms, fast %.2f ms%s\n", scalarTime, fastTime, same ? "" : " (MISMATCH)");
+    log("%s", line);
+    result += line;
+
+    free(scalarOut);
+    free(pixels);
+
+    auto s = Director::getInstance()->getWinSize();
+    auto label = Label::createWithTTF(result, "fonts/arial.ttf", 16);
+    label->setPosition(Vec2(s.width/2, s.height/2));
+    addChild(label);
+}
+
+std::string TextureConvertTest::title() const
+{
+    return "Pixel Format Conversion Test";
+}
+
+std::string TextureConvertTest::subtitle() const
+{
+    return "2048x2048 RGBA8888, scalar loops vs Texture2D";
+}
+
+Scene* TextureConvertTest::scene()
+{
+    auto scene = Scene::create();
+    TextureConvertTest *layer = new TextureConvertTest(true, TEST_COUNT, s_nTexCurCase);
+    scene->addChild(layer);
+    layer->release();
+
+    return scene;
+}
+
+////////////////////////////////////////////////////////
+//
+// TextureDecodeTest
+//
+////////////////////////////////////////////////////////
+
+// Builds a large compressed image from the header of a small test file, filled with random blocks.
+// The header offsets are the ones of the PKM, DDS and KTX file formats.
+static std::vector<unsigned char> makeCompressedImage(const char* filename, int size, int blockSize)
+{
+    Data data = FileUtils::getInstance()->getDataFromFile(filename);
+    const unsigned char* bytes = data.getBytes();
+    std::vector<unsigned char> result;
+
+    auto write32 = [&](size_t offset, uint32_t value) { memcpy(&result[offset], &value, 4); };
+
+    size_t headerLen = 0;
+    if (memcmp(bytes, "PKM ", 4) == 0)
+    {
+        headerLen = ETC_PKM_HEADER_SIZE;
+        result.assign(bytes, bytes + headerLen);
+        // extended and real sizes, big endian 16 bits
+        for (size_t offset = 8; offset < 16; offset += 2)
+        {
+            result[offset] = (size >> 8) & 0xFF;
+            result[offset + 1] = size & 0xFF;
+        }
+    }
+    else if (memcmp(bytes, "DDS", 3) == 0)
+    {
+        headerLen = 128;
+        result.assign(bytes, bytes + headerLen);
+        write32(12, size);      // height
+        write32(16, size);      // width
+        write32(28, 1);         // mipmap count
+    }
+    else
+    {
+        uint32_t keyValueLen = 0;
+        memcpy(&keyValueLen, bytes + 60, 4);
+        headerLen = 64 + keyValueLen;
+        result.assign(bytes, bytes + headerLen);
+        write32(36, size);      // width
+        write32(40, size);      // height
+        write32(56, 1);         // mipmap count
+        result.resize(headerLen + 4);
+        write32(headerLen, (size / 4) * (size / 4) * blockSize);
+        headerLen += 4;
+    }
+
+    size_t blocksLen = (size / 4) * (size / 4) * blockSize;
+    result.resize(headerLen + blocksLen);
+    for (size_t i = headerLen; i < result.size(); ++i)
+    {
+        result[i] = (unsigned char)(rand() & 0xFF);
+    }
+    return result;
+}
+
+// Times the software decoders on size x size images of random blocks, best of
+// repeat runs. Only FileUtils, Image and the decoders are used, never the
+// Director nor a GL context, so it also runs headless from the console.
+std::string benchmarkTextureDecoders(int size, int repeat)
+{
+    struct {
+        const char* name;
+        const char* file;
+        int blockSize;
+        bool throughImage;
+        std::function<void(const unsigned char*, unsigned char*)> decode;
+    } cases[] = {
+        { "ETC1", "Images/ETC1.pkm", 8, true, [=](const unsigned char* in, unsigned char* out){
+            etc1_decode_image(in + ETC_PKM_HEADER_SIZE, out, size, size, 3, size * 3);
+        } },
+        { "ETC1 to 565", "Images/ETC1.pkm", 8, false, [=](const unsigned char* in, unsigned char* out){
+            etc1_decode_image(in + ETC_PKM_HEADER_SIZE, out, size, size, 2, size * 2);
+        } },
+        { "DXT1", "Images/test_256x256_s3tc_dxt1_mipmaps.dds", 8, true, [=](const unsigned char* in, unsigned char* out){
+            s3tc_decode(const_cast<unsigned char*>(in) + 128, out, size, size, S3TCDecodeFlag::DXT1);
+        } },
+        { "DXT3", "Images/test_256x256_s3tc_dxt3_mipmaps.dds", 16, true, [=](const unsigned char* in, unsigned char* out){
+            s3tc_decode(const_cast<unsigned char*>(in) + 128, out, size, size, S3TCDecodeFlag::DXT3);
+        } },
+        { "DXT5", "Images/test_256x256_s3tc_dxt5_mipmaps.dds", 16, true, [=](const unsigned char* in, unsigned char* out){
+            s3tc_decode(const_cast<unsigned char*>(in) + 128, out, size, size, S3TCDecodeFlag::DXT5);
+        } },
+        { "ATC", "Images/test_256x256_ATC_RGBA_Interpolated_mipmaps.ktx", 16, true, [=](const unsigned char* in, unsigned char* out){
+            uint32_t keyValueLen = 0;
+            memcpy(&keyValueLen, in + 60, 4);
+            atitc_decode(const_cast<unsigned char*>(in) + 64 + keyValueLen + 4, out, size, size, ATITCDecodeFlag::ATC_INTERPOLATED_ALPHA);
+        } },
+    };
+
+    auto best = [=](const std::function<void()>& run) {
+        float result = FLT_MAX;
+        struct timeval now;
+        for (int i = 0; i < repeat; ++i)
+        {
+            gettimeofday(&now, nullptr);
+            run();
+            result = std::min(result, elapsedMilliseconds(&now));
+        }
+        return result;
+    };
+
+    std::string result;
+    char line[128];
+    std::vector<unsigned char> decoded(size * size * 4);
+
+    Image::setSoftwareDecodeForced(true);
+    auto defaultFormat = Image::getSoftwareDecodePixelFormat();
+
+    log("--- software decoders %dx%d, best of %d ---", size, size, repeat);
+    for (auto& c : cases)
+    {
+        auto encoded = makeCompressedImage(c.file, size, c.blockSize);
+
+        float singleTime = best([&](){ c.decode(encoded.data(), decoded.data()); });
+        if (!c.throughImage)
+        {
+            snprintf(line, sizeof(line), "%s: 1 thread %.2f ms\n", c.name, singleTime);
+            log("%s", line);
+            result += line;
+            continue;
+        }
+
+        auto decodeImage = [&](){
+            auto image = new Image();
+            image->initWithImageData(encoded.data(), encoded.size());
+            image->release();
+        };
+
+        Image::setSoftwareDecodePixelFormat(Texture2D::PixelFormat::AUTO);
+        float parallelTime = best(decodeImage);
+
+        Image::setSoftwareDecodePixelFormat(Texture2D::PixelFormat::RGBA4444);
+        float shortTime = best(decodeImage);
+
+        snprintf(line, sizeof(line), "%s: 1 thread %.2f ms, pool %.2f ms, pool to 16 bits %.2f ms\n", c.name, singleTime, parallelTime, shortTime);
+        log("%s", line);
+        result += line;
+    }
+
+    Image::setSoftwareDecodePixelFormat(defaultFormat);
+    Image::setSoftwareDecodeForced(false);
+
+    return result;
+}
+
+void TextureDecodeTest::performTests()
+{
+    auto result = benchmarkTextureDecoders(2048, 3);
+
+    auto s = Director::getInstance()->getWinSize();
+    auto label = Label::createWithTTF(result, "fonts/arial.ttf", 16);
+    label->setPosition(Vec2(s.width/2, s.height/2));
+    addChild(label);
+}
+
+std::string TextureDecodeTest::title() const
+{
+    return "Compressed Texture Decode Test";
+}
+
+std::string TextureDecodeTest::subtitle() const
+{
+    return "Times the software ETC1/S3TC/ATITC decoders, also \"decodebench\" in the console";
+}
+
+Scene* TextureDecodeTest::scene()
+{
+    auto scene = Scene::create();
+    TextureDecodeTest *layer = new TextureDecodeTest(true, TEST_COUNT, s_nTexCurCase);
+    scene->addChild(layer);
+    layer->release();
+
+    return scene;
+}
+
+////////////////////////////////////////////////////////
+//
+// SpriteSheetLoadTest
+//
+////////////////////////////////////////////////////////
+void SpriteSheetLoadTest::performTests()
+{
+    const int frameCount = 4096;
+    const int repeatCount = 5;
+    const char* textureFile = "animations/grossini.png";
+
+    // a format 2 sheet with many frames, and its compiled version
+    auto fileUtils = FileUtils::getInstance();
+    std::string plistPath = fileUtils->getWritablePath() + "perf_spritesheet.plist";
+    std::string sfbPath = fileUtils->getWritablePath() + "perf_spritesheet.sfb";
+
+    ValueMap frames;
+    char name[32];
+    char rect[64];
+    for (int i = 0; i < frameCount; ++i)
+    {
+        ValueMap frame;
+        snprintf(rect, sizeof(rect), "{{%d,%d},{32,32}}", (i % 16) * 32, ((i / 16) % 16) * 32);
+        frame["frame"] = Value(rect);
+        frame["offset"] = Value("{0,0}");
+        frame["rotated"] = Value(i % 3 == 0);
+        frame["sourceSize"] = Value("{32,32}");
+        snprintf(name, sizeof(name), "frame_%04d.png", i);
+        frames[name] = Value(frame);
+    }
+    ValueMap metadata;
+    metadata["format"] = Value(2);
+    ValueMap dict;
+    dict["frames"] = Value(frames);
+    dict["metadata"] = Value(metadata);
+    fileUtils->writeToFile(dict, plistPath);
+
+    if (!SpriteFrameCache::writeBinarySpriteFramesFile(plistPath, sfbPath))
+    {
+        log("Couldn't write %s", sfbPath.c_str());
+        return;
+    }
+
+    auto cache = SpriteFrameCache::getInstance();
+    Director::getInstance()->getTextureCache()->addImage(textureFile);
+
+    struct timeval now;
+    float plistTime = 0;
+    float sfbTime = 0;
+    float sfbLookupTime = 0;
+    for (int repeat = 0; repeat < repeatCount; ++repeat)
+    {
+        gettimeofday(&now, nullptr);
+        cache->addSpriteFramesWithFile(plistPath, textureFile);
+        plistTime += elapsedMilliseconds(&now);
+        cache->removeSpriteFramesFromFile(plistPath);
+
+        gettimeofday(&now, nullptr);
+        cache->addSpriteFramesWithFile(sfbPath, textureFile);
+        sfbTime += elapsedMilliseconds(&now);
+
+        // the binary frames are created on first use, look all of them up to compare the same work
+        gettimeofday(&now, nullptr);
+        for (int i = 0; i < frameCount; ++i)
+        {
+            snprintf(name, sizeof(name), "frame_%04d.png", i);
+            cache->getSpriteFrameByName(name);
+        }
+        sfbLookupTime += elapsedMilliseconds(&now);
+        cache->removeSpriteFramesFromFile(sfbPath);
+    }
+
+    char result[256];
+    snprintf(result, sizeof(result), "%d frames, average of %d loads\nplist: %.2f ms\nsfb: %.2f ms\nsfb + every frame used: %.2f ms",
+             frameCount, repeatCount, plistTime / repeatCount, sfbTime / repeatCount, (sfbTime + sfbLookupTime) / repeatCount);
+    log("%s", result);
+
+    auto s = Director::getInstance()->getWinSize();
+    auto label = Label::createWithTTF(result, "fonts/arial.ttf", 20);
+    label->setPosition(Vec2(s.width/2, s.height/2));
+    addChild(label);
+}
+
+std::string SpriteSheetLoadTest::title() const
+{
+    return "Sprite Sheet Load Test";
+}
+
+std::string SpriteSheetLoadTest::subtitle() const
+{
+    return "plist vs binary sprite sheet (.sfb), see console";
+}
+
+Scene* SpriteSheetLoadTest::scene()
+{
+    auto scene = Scene::create();
+    SpriteSheetLoadTest *layer = new SpriteSheetLoadTest(true, TEST_COUNT, s_nTexCurCase);
     scene->addChild(layer);
     layer->release();
 
@@ -3,6 +3,10 @@
 
 #include "PerformanceTest.h"
 
+// Times the software compressed texture decoders, without Director nor GL.
+// Returns one line of results per format.
+std::string benchmarkTextureDecoders(int size, int repeat);
+
 class TextureMenuLayer : public PerformBasicLayer
 {
 public:
@@ -35,6 +39,51 @@ public:
     static Scene* scene();
 };
 
+class TextureConvertTest : public TextureMenuLayer
+{
+public:
+    TextureConvertTest(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0)
+        :TextureMenuLayer(bControlMenuVisible, nMaxCases, nCurCase)
+    {
+    }
+
+    virtual void performTests();
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    static Scene* scene();
+};
+
+class TextureDecodeTest : public TextureMenuLayer
+{
+public:
+    TextureDecodeTest(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0)
+        :TextureMenuLayer(bControlMenuVisible, nMaxCases, nCurCase)
+    {
+    }
+
+    virtual void performTests();
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    static Scene* scene();
+};
+
+class SpriteSheetLoadTest : public TextureMenuLayer
+{
+public:
+    SpriteSheetLoadTest(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0)
+        :TextureMenuLayer(bControlMenuVisible, nMaxCases, nCurCase)
+    {
+    }
+
+    virtual void performTests();
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    static Scene* scene();
+};
+
 void runTextureTest();
 
 #endif
@@ -0,0 +1,288 @@
+//
+//  PerformanceValueMapTest.cpp
+//
+
+#include "PerformanceValueMapTest.h"
+
+// Enable profiles for this file
+#undef CC_PROFILER_DISPLAY_TIMERS
+#define CC_PROFILER_DISPLAY_TIMERS() Profiler::getInstance()->displayTimers()
+#undef CC_PROFILER_PURGE_ALL
+#define CC_PROFILER_PURGE_ALL() Profiler::getInstance()->releaseAllTimers()
+
+#undef CC_PROFILER_START
+#define CC_PROFILER_START(__name__) ProfilingBeginTimingBlock(__name__)
+#undef CC_PROFILER_STOP
+#define CC_PROFILER_STOP(__name__) ProfilingEndTimingBlock(__name__)
+
+static std::function<PerformanceValueMapScene*()> createFunctions[] =
+{
+    CL(PlistLoadPerfTest),
+    CL(BinaryLoadPerfTest),
+    CL(ValueMapLookupPerfTest),
+    CL(ValueViewLookupPerfTest),
+};
+
+#define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
+
+
+static int g_curCase = 0;
+
+////////////////////////////////////////////////////////
+//
+// ValueMapBasicLayer
+//
+////////////////////////////////////////////////////////
+
+ValueMapBasicLayer::ValueMapBasicLayer(bool bControlMenuVisible, int nMaxCases, int nCurCase)
+: PerformBasicLayer(bControlMenuVisible, nMaxCases, nCurCase)
+{
+}
+
+void ValueMapBasicLayer::showCurrentTest()
+{
+    auto scene = createFunctions[_curCase]();
+
+    g_curCase = _curCase;
+
+    if (scene)
+    {
+        Director::getInstance()->replaceScene(scene);
+    }
+}
+
+////////////////////////////////////////////////////////
+//
+// PerformanceValueMapScene
+//
+////////////////////////////////////////////////////////
+
+void PerformanceValueMapScene::onEnter()
+{
+    Scene::onEnter();
+
+    CC_PROFILER_PURGE_ALL();
+
+    auto s = Director::getInstance()->getWinSize();
+
+    auto menuLayer = new ValueMapBasicLayer(true, MAX_LAYER, g_curCase);
+    addChild(menuLayer);
+    menuLayer->release();
+
+    // Title
+    auto label = Label::createWithTTF(title().c_str(), "fonts/arial.ttf", 32);
+    addChild(label, 1);
+    label->setPosition(Vec2(s.width/2, s.height-50));
+
+    // Subtitle
+    std::string strSubTitle = subtitle();
+    if(strSubTitle.length())
+    {
+        auto l = Label::createWithTTF(strSubTitle.c_str(), "fonts/Thonburi.ttf", 16);
+        addChild(l, 1);
+        l->setPosition(Vec2(s.width/2, s.height-80));
+    }
+
+    generateFiles();
+
+    getScheduler()->schedule(schedule_selector(PerformanceValueMapScene::onUpdate), this, 0.0f, false);
+    getScheduler()->schedule(schedule_selector(PerformanceValueMapScene::dumpProfilerInfo), this, 2, false);
+}
+
+void PerformanceValueMapScene::generateFiles()
+{
+    auto fileUtils = FileUtils::getInstance();
+    _plistPath = fileUtils->getWritablePath() + "PerformanceValueMapTest.plist";
+    _binaryPath = fileUtils->getWritablePath() + "PerformanceValueMapTest.bin";
+
+    _keys.clear();
+    for (int i = 0; i < ENTRY_COUNT; ++i)
+    {
+        _keys.push_back(StringUtils::format("entity_%d", i));
+    }
+
+    if (fileUtils->isFileExist(_plistPath) && fileUtils->isFileExist(_binaryPath))
+    {
+        return;
+    }
+
+    // looks like the level and animation data the games load
+    ValueMap root;
+    for (int i = 0; i < ENTRY_COUNT; ++i)
+    {
+        ValueMap entity;
+        entity["name"] = Value(StringUtils::format("grossini_dance_%02d.png", i % 14 + 1));
+        entity["x"] = Value(i * 3.5f);
+        entity["y"] = Value(i * 1.25f);
+        entity["visible"] = Value(i % 3 != 0);
+        entity["tag"] = Value(i);
+
+        ValueVector frames;
+        for (int j = 0; j < 8; ++j)
+        {
+            frames.push_back(Value(StringUtils::format("frame_%02d.png", j)));
+        }
+        entity["frames"] = Value(std::move(frames));
+
+        root[_keys[i]] = Value(std::move(entity));
+    }
+
+    fileUtils->writeToFile(root, _plistPath);
+    fileUtils->writeValueToBinaryFile(Value(std::move(root)), _binaryPath);
+}
+
+std::string PerformanceValueMapScene::title() const
+{
+    return "No title";
+}
+
+std::string PerformanceValueMapScene::subtitle() const
+{
+    return "";
+}
+
+void PerformanceValueMapScene::dumpProfilerInfo(float dt)
+{
+	CC_PROFILER_DISPLAY_TIMERS();
+}
+
+////////////////////////////////////////////////////////
+//
+// PlistLoadPerfTest
+//
+////////////////////////////////////////////////////////
+
+void PlistLoadPerfTest::onEnter()
+{
+    PerformanceValueMapScene::onEnter();
+    _profileName = "getValueMapFromFile(plist)";
+}
+
+void PlistLoadPerfTest::onUpdate(float dt)
+{
+    CC_PROFILER_START(_profileName.c_str());
+    ValueMap map = FileUtils::getInstance()->getValueMapFromFile(_plistPath);
+    CC_PROFILER_STOP(_profileName.c_str());
+    _placeHolder = (int)map.size();
+}
+
+std::string PlistLoadPerfTest::title() const
+{
+    return "Load plist Perf test";
+}
+
+std::string PlistLoadPerfTest::subtitle() const
+{
+    return "Loads a 2000 entries plist every frame, see console";
+}
+
+////////////////////////////////////////////////////////
+//
+// BinaryLoadPerfTest
+//
+////////////////////////////////////////////////////////
+
+void BinaryLoadPerfTest::onEnter()
+{
+    PerformanceValueMapScene::onEnter();
+    _profileName = "getValueMapFromFile(binary)";
+}
+
+void BinaryLoadPerfTest::onUpdate(float dt)
+{
+    CC_PROFILER_START(_profileName.c_str());
+    ValueMap map = FileUtils::getInstance()->getValueMapFromFile(_binaryPath);
+    CC_PROFILER_STOP(_profileName.c_str());
+    _placeHolder = (int)map.size();
+}
+
+std::string BinaryLoadPerfTest::title() const
+{
+    return "Load binary Perf test";
+}
+
+std::string BinaryLoadPerfTest::subtitle() const
+{
+    return "Loads the same entries from a binary file every frame, see console";
+}
+
+////////////////////////////////////////////////////////
+//
+// ValueMapLookupPerfTest
+//
+////////////////////////////////////////////////////////
+
+void ValueMapLookupPerfTest::onEnter()
+{
+    PerformanceValueMapScene::onEnter();
+    _profileName = "ValueMap open + lookups";
+}
+
+void ValueMapLookupPerfTest::onUpdate(float dt)
+{
+    CC_PROFILER_START(_profileName.c_str());
+    _map = FileUtils::getInstance()->getValueMapFromFile(_plistPath);
+    float x = 0;
+    for (int i = 0; i < LOOKUP_COUNT; ++i)
+    {
+        auto iter = _map.find(_keys[(i * 7) % ENTRY_COUNT]);
+        if (iter != _map.end())
+        {
+            x += iter->second.asValueMap().at("x").asFloat();
+        }
+    }
+    CC_PROFILER_STOP(_profileName.c_str());
+    _placeHolder = (int)x;
+}
+
+std::string ValueMapLookupPerfTest::title() const
+{
+    return "ValueMap lookup Perf test";
+}
+
+std::string ValueMapLookupPerfTest::subtitle() const
+{
+    return "Loads the plist and reads 1000 entries, see console";
+}
+
+////////////////////////////////////////////////////////
+//
+// ValueViewLookupPerfTest
+//
+////////////////////////////////////////////////////////
+
+void ValueViewLookupPerfTest::onEnter()
+{
+    PerformanceValueMapScene::onEnter();
+    _profileName = "ValueView open + lookups";
+}
+
+void ValueViewLookupPerfTest::onUpdate(float dt)
+{
+    CC_PROFILER_START(_profileName.c_str());
+    _view = FileUtils::getInstance()->getValueViewFromFile(_binaryPath);
+    float x = 0;
+    for (int i = 0; i < LOOKUP_COUNT; ++i)
+    {
+        x += _view[_keys[(i * 7) % ENTRY_COUNT]]["x"].asFloat();
+    }
+    CC_PROFILER_STOP(_profileName.c_str());
+    _placeHolder = (int)x;
+}
+
+std::string ValueViewLookupPerfTest::title() const
+{
+    return "ValueView lookup Perf test";
+}
+
+std::string ValueViewLookupPerfTest::subtitle() const
+{
+    return "Maps the binary file and reads 1000 entries in place, see console";
+}
+
+void runValueMapPerformanceTest()
+{
+    auto scene = createFunctions[g_curCase]();
+
+    Director::getInstance()->replaceScene(scene);
+}
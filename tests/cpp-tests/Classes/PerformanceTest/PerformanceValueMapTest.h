@@ -0,0 +1,91 @@
+//
+//  PerformanceValueMapTest.h
+
+#ifndef __PERFORMANCE_VALUEMAP_TEST_H__
+#define __PERFORMANCE_VALUEMAP_TEST_H__
+
+#include "PerformanceTest.h"
+
+class ValueMapBasicLayer : public PerformBasicLayer
+{
+public:
+    ValueMapBasicLayer(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0);
+
+    virtual void showCurrentTest();
+};
+
+class PerformanceValueMapScene : public Scene
+{
+public:
+    virtual void onEnter() override;
+    virtual std::string title() const;
+    virtual std::string subtitle() const;
+    virtual void onUpdate(float dt) {};
+
+    void dumpProfilerInfo(float dt);
+protected:
+    // writes the same data as plist and as binary file once
+    void generateFiles();
+
+    std::string _profileName;
+    std::string _plistPath;
+    std::string _binaryPath;
+    std::vector<std::string> _keys;
+    int _placeHolder; // To avoid compiler optimization
+    static const int ENTRY_COUNT = 2000;
+    static const int LOOKUP_COUNT = 1000;
+};
+
+class PlistLoadPerfTest : public PerformanceValueMapScene
+{
+public:
+    CREATE_FUNC(PlistLoadPerfTest);
+
+    virtual void onEnter() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onUpdate(float dt) override;
+};
+
+class BinaryLoadPerfTest : public PerformanceValueMapScene
+{
+public:
+    CREATE_FUNC(BinaryLoadPerfTest);
+
+    virtual void onEnter() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onUpdate(float dt) override;
+};
+
+class ValueMapLookupPerfTest : public PerformanceValueMapScene
+{
+public:
+    CREATE_FUNC(ValueMapLookupPerfTest);
+
+    virtual void onEnter() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onUpdate(float dt) override;
+
+private:
+    ValueMap _map;
+};
+
+class ValueViewLookupPerfTest : public PerformanceValueMapScene
+{
+public:
+    CREATE_FUNC(ValueViewLookupPerfTest);
+
+    virtual void onEnter() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onUpdate(float dt) override;
+
+private:
+    ValueView _view;
+};
+
+void runValueMapPerformanceTest();
+
+#endif /* __PERFORMANCE_VALUEMAP_TEST_H__ */
@@ -0,0 +1,233 @@
+//
+//  PerformanceZipTest.cpp
+//
+
+#include "PerformanceZipTest.h"
+#include "base/ZipUtils.h"
+#include "base/CCThreadPool.h"
+#include <chrono>
+
+static std::function<PerformanceZipScene*()> createFunctions[] =
+{
+    CL(ZipInflateMemoryPerfTest),
+    CL(ZipInflateBlocksPerfTest),
+    CL(ZipInflateStreamPerfTest),
+};
+
+#define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
+
+
+static int g_curCase = 0;
+
+////////////////////////////////////////////////////////
+//
+// ZipBasicLayer
+//
+////////////////////////////////////////////////////////
+
+ZipBasicLayer::ZipBasicLayer(bool bControlMenuVisible, int nMaxCases, int nCurCase)
+: PerformBasicLayer(bControlMenuVisible, nMaxCases, nCurCase)
+{
+}
+
+void ZipBasicLayer::showCurrentTest()
+{
+    auto scene = createFunctions[_curCase]();
+
+    g_curCase = _curCase;
+
+    if (scene)
+    {
+        Director::getInstance()->replaceScene(scene);
+    }
+}
+
+////////////////////////////////////////////////////////
+//
+// PerformanceZipScene
+//
+////////////////////////////////////////////////////////
+
+void PerformanceZipScene::onEnter()
+{
+    Scene::onEnter();
+
+    _compressed = nullptr;
+    _compressedLength = 0;
+    _inflateTime = 0;
+    _inflatedBytes = 0;
+
+    auto s = Director::getInstance()->getWinSize();
+
+    auto menuLayer = new ZipBasicLayer(true, MAX_LAYER, g_curCase);
+    addChild(menuLayer);
+    menuLayer->release();
+
+    // Title
+    auto label = Label::createWithTTF(title().c_str(), "fonts/arial.ttf", 32);
+    addChild(label, 1);
+    label->setPosition(Vec2(s.width/2, s.height-50));
+
+    // Subtitle
+    std::string strSubTitle = subtitle();
+    if(strSubTitle.length())
+    {
+        auto l = Label::createWithTTF(strSubTitle.c_str(), "fonts/Thonburi.ttf", 16);
+        addChild(l, 1);
+        l->setPosition(Vec2(s.width/2, s.height-80));
+    }
+
+    _resultLabel = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    _resultLabel->setPosition(Vec2(s.width/2, s.height/2));
+    addChild(_resultLabel, 1);
+
+    generateData();
+
+    getScheduler()->schedule(schedule_selector(PerformanceZipScene::onUpdate), this, 0.0f, false);
+    getScheduler()->schedule(schedule_selector(PerformanceZipScene::showResults), this, 1.0f, false);
+}
+
+void PerformanceZipScene::onExit()
+{
+    free(_compressed);
+    _compressed = nullptr;
+
+    Scene::onExit();
+}
+
+void PerformanceZipScene::generateData()
+{
+    static const char* words[] = { "tile", "sprite", "layer", "frame", "armature", "bone", "texture", "<node x=\"", "\"/>\n", "0", "1", "32" };
+
+    std::string data;
+    data.reserve(DATA_SIZE);
+    unsigned int seed = 1;
+    while (data.size() < (size_t)DATA_SIZE)
+    {
+        seed = seed * 1103515245 + 12345;
+        data += words[(seed >> 16) % (sizeof(words) / sizeof(words[0]))];
+        data += (char)('a' + (seed >> 8) % 26);
+    }
+    _dataLength = data.size();
+
+    _compressedLength = ZipUtils::deflateMemory(reinterpret_cast<const unsigned char*>(data.c_str()), _dataLength, &_compressed, isBlocked());
+}
+
+ssize_t PerformanceZipScene::inflate()
+{
+    unsigned char* inflated = nullptr;
+    ssize_t len = ZipUtils::inflateMemory(_compressed, _compressedLength, &inflated);
+    free(inflated);
+    return len;
+}
+
+void PerformanceZipScene::onUpdate(float dt)
+{
+    if (_compressedLength <= 0)
+        return;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    ssize_t len = inflate();
+    _inflateTime += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    _inflatedBytes += len;
+}
+
+void PerformanceZipScene::showResults(float dt)
+{
+    if (_inflateTime <= 0)
+        return;
+
+    _resultLabel->setString(StringUtils::format("%.1f MB deflated to %.1f MB\ninflated at %.1f MB/s, %d worker threads",
+                                                _dataLength / (1024.0 * 1024.0), _compressedLength / (1024.0 * 1024.0),
+                                                _inflatedBytes / (1024.0 * 1024.0) / _inflateTime, ThreadPool::getInstance()->getThreadCount()));
+    _inflateTime = 0;
+    _inflatedBytes = 0;
+}
+
+std::string PerformanceZipScene::title() const
+{
+    return "No title";
+}
+
+std::string PerformanceZipScene::subtitle() const
+{
+    return "";
+}
+
+////////////////////////////////////////////////////////
+//
+// ZipInflateMemoryPerfTest
+//
+////////////////////////////////////////////////////////
+
+std::string ZipInflateMemoryPerfTest::title() const
+{
+    return "Inflate gzip memory";
+}
+
+std::string ZipInflateMemoryPerfTest::subtitle() const
+{
+    return "One gzip member, inflated into a buffer of the size stored by gzip";
+}
+
+////////////////////////////////////////////////////////
+//
+// ZipInflateBlocksPerfTest
+//
+////////////////////////////////////////////////////////
+
+std::string ZipInflateBlocksPerfTest::title() const
+{
+    return "Inflate blocked gzip memory";
+}
+
+std::string ZipInflateBlocksPerfTest::subtitle() const
+{
+    return "64k independent gzip members (BGZF), inflated in parallel";
+}
+
+////////////////////////////////////////////////////////
+//
+// ZipInflateStreamPerfTest
+//
+////////////////////////////////////////////////////////
+
+void ZipInflateStreamPerfTest::onEnter()
+{
+    PerformanceZipScene::onEnter();
+
+    _filePath = FileUtils::getInstance()->getWritablePath() + "PerformanceZipTest.gz";
+    FILE* fp = fopen(_filePath.c_str(), "wb");
+    if (fp)
+    {
+        fwrite(_compressed, _compressedLength, 1, fp);
+        fclose(fp);
+    }
+}
+
+ssize_t ZipInflateStreamPerfTest::inflate()
+{
+    ssize_t len = 0;
+    ZipUtils::inflateFileInChunks(_filePath, [&len](const unsigned char* data, ssize_t size) {
+        len += size;
+        return true;
+    });
+    return len;
+}
+
+std::string ZipInflateStreamPerfTest::title() const
+{
+    return "Inflate gzip file in chunks";
+}
+
+std::string ZipInflateStreamPerfTest::subtitle() const
+{
+    return "The file is read and inflated 64k at a time, nothing else is allocated";
+}
+
+void runZipPerformanceTest()
+{
+    auto scene = createFunctions[g_curCase]();
+
+    Director::getInstance()->replaceScene(scene);
+}
@@ -0,0 +1,82 @@
+//
+//  PerformanceZipTest.h
+
+#ifndef __PERFORMANCE_ZIP_TEST_H__
+#define __PERFORMANCE_ZIP_TEST_H__
+
+#include "PerformanceTest.h"
+
+class ZipBasicLayer : public PerformBasicLayer
+{
+public:
+    ZipBasicLayer(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0);
+
+    virtual void showCurrentTest();
+};
+
+// Inflates the same generated data every frame and reports the inflate throughput
+class PerformanceZipScene : public Scene
+{
+public:
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const;
+    virtual std::string subtitle() const;
+
+    void onUpdate(float dt);
+    void showResults(float dt);
+protected:
+    // true to deflate the data in independent blocks
+    virtual bool isBlocked() const { return false; }
+    // returns the inflated size
+    virtual ssize_t inflate();
+
+    // text like data, which deflates about 3:1
+    void generateData();
+
+    unsigned char* _compressed;
+    ssize_t _compressedLength;
+    ssize_t _dataLength;
+    Label* _resultLabel;
+    double _inflateTime;
+    double _inflatedBytes;
+    static const int DATA_SIZE = 8 * 1024 * 1024;
+};
+
+class ZipInflateMemoryPerfTest : public PerformanceZipScene
+{
+public:
+    CREATE_FUNC(ZipInflateMemoryPerfTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
+class ZipInflateBlocksPerfTest : public PerformanceZipScene
+{
+public:
+    CREATE_FUNC(ZipInflateBlocksPerfTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+protected:
+    virtual bool isBlocked() const override { return true; }
+};
+
+class ZipInflateStreamPerfTest : public PerformanceZipScene
+{
+public:
+    CREATE_FUNC(ZipInflateStreamPerfTest);
+
+    virtual void onEnter() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+protected:
+    virtual ssize_t inflate() override;
+
+    std::string _filePath;
+};
+
+void runZipPerformanceTest();
+
+#endif /* __PERFORMANCE_ZIP_TEST_H__ */
@@ -13,6 +13,7 @@ static std::function<Layer*()> createFunctions[] = {
     CL(RenderTextureTargetNode),
     CL(SpriteRenderTextureBug),
     CL(RenderTexturePartTest),
+    CL(RenderTextureReadbackTest),
 };
 
 #define MAX_LAYER   (sizeof(createFunctions)/sizeof(createFunctions[0]))
@@ -139,19 +140,30 @@ void RenderTextureSave::saveImage(cocos2d::Ref *sender)
     sprintf(jpg, "image-%d.jpg", counter);
 
     _target->saveToFile(png, Image::Format::PNG);
-    _target->saveToFile(jpg, Image::Format::JPG);
-    
-    std::string fileName = FileUtils::getInstance()->getWritablePath() + jpg;
-    auto action1 = DelayTime::create(1);
-    auto func = [&,fileName]()
+
+    // the file is read back and encoded in the background, the callback runs once it is written
+    int rotation = counter * 3;
+    this->retain();
+    bool saving = _target->saveToFile(jpg, Image::Format::JPG, [this, rotation](RenderTexture* renderTexture, const std::string& fullPath, bool succeeded)
+    {
+        if (succeeded)
+        {
+            auto sprite = Sprite::create(fullPath);
+            addChild(sprite);
+            sprite->setScale(0.3f);
+            sprite->setPosition(Vec2(40, 40));
+            sprite->setRotation(rotation);
+        }
+        else
+        {
+            CCLOG("RenderTextureSave: failed to save %s", fullPath.c_str());
+        }
+        this->release();
+    });
+    if (!saving)
     {
-        auto sprite = Sprite::create(fileName);
-        addChild(sprite);
-        sprite->setScale(0.3f);
-        sprite->setPosition(Vec2(40, 40));
-        sprite->setRotation(counter * 3);
-    };
-    runAction(Sequence::create(action1, CallFunc::create(func), NULL));
+        this->release();
+    }
 
     CCLOG("Image saved %s and %s", png, jpg);
 
@@ -763,3 +775,106 @@ std::string SpriteRenderTextureBug::subtitle() const
 {
     return "Touch the screen. Sprite should appear on under the touch";
 }
+
+//
+// RenderTextureReadbackTest
+//
+
+// the color the render texture is cleared with, and how it is read back
+static const Color4B s_readbackColor(255, 128, 0, 255);
+
+RenderTextureReadbackTest::RenderTextureReadbackTest()
+{
+    auto s = Director::getInstance()->getWinSize();
+
+    _resultLabel = Label::createWithTTF("", "fonts/arial.ttf", 16);
+    _resultLabel->setPosition(Vec2(s.width/2, s.height/2 - 60));
+    addChild(_resultLabel);
+
+    _target = RenderTexture::create(64, 64, Texture2D::PixelFormat::RGBA8888);
+    _target->setPosition(Vec2(s.width/2, s.height/2 + 20));
+    addChild(_target);
+
+    _target->beginWithClear(s_readbackColor.r / 255.0f, s_readbackColor.g / 255.0f, s_readbackColor.b / 255.0f, s_readbackColor.a / 255.0f);
+    _target->end();
+
+    _results = RenderTexture::isPixelBufferReadbackEnabled() ? "pixel buffer: " : "pixel buffer disabled: ";
+    _target->newImageAsync([this](Image* image) {
+        _results += checkImage(image) ? "passed" : "FAILED";
+        // the glReadPixels fallback, the one used by GL contexts without pixel buffers
+        RenderTexture::setPixelBufferReadbackEnabled(false);
+        _target->newImageAsync([this](Image* image) {
+            RenderTexture::setPixelBufferReadbackEnabled(true);
+            _results += std::string("\nglReadPixels: ") + (checkImage(image) ? "passed" : "FAILED");
+            saveImage();
+        });
+        _resultLabel->setString(_results);
+    });
+    // released by the last callback
+    retain();
+}
+
+RenderTextureReadbackTest::~RenderTextureReadbackTest()
+{
+    RenderTexture::setPixelBufferReadbackEnabled(true);
+}
+
+void RenderTextureReadbackTest::saveImage()
+{
+    bool saving = _target->saveToFile("readback-test.png", Image::Format::PNG, [this](RenderTexture* renderTexture, const std::string& fullPath, bool succeeded)
+    {
+        bool passed = false;
+        if (succeeded)
+        {
+            auto image = new Image();
+            passed = image->initWithImageFile(fullPath) && checkImage(image);
+            image->release();
+        }
+        _results += std::string("\nsaveToFile: ") + (passed ? "passed" : "FAILED");
+        _resultLabel->setString(_results);
+        release();
+    });
+    if (!saving)
+    {
+        _results += "\nsaveToFile: FAILED";
+        _resultLabel->setString(_results);
+        release();
+    }
+}
+
+bool RenderTextureReadbackTest::checkImage(Image* image) const
+{
+    if (image == nullptr || image->getWidth() != 64 || image->getHeight() != 64)
+    {
+        return false;
+    }
+
+    // saveToFile() drops the alpha channel
+    const int bytesPerPixel = image->getBitPerPixel() / 8;
+    if (bytesPerPixel != 3 && bytesPerPixel != 4)
+    {
+        return false;
+    }
+
+    const unsigned char* data = image->getData();
+    for (int i = 0; i < 64 * 64; ++i)
+    {
+        const unsigned char* pixel = data + i * bytesPerPixel;
+        if (pixel[0] != s_readbackColor.r || pixel[1] != s_readbackColor.g || pixel[2] != s_readbackColor.b
+            || (bytesPerPixel == 4 && pixel[3] != s_readbackColor.a))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string RenderTextureReadbackTest::title() const
+{
+    return "Render Texture Readback Test";
+}
+
+std::string RenderTextureReadbackTest::subtitle() const
+{
+    return "Reads back an orange texture with and without pixel buffers";
+}
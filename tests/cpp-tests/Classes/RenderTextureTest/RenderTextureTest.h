@@ -129,6 +129,26 @@ private:
     Sprite* _spriteDraw;
 };
 
+// Reads the texture back through newImageAsync() and saveToFile(), with the pixel buffer objects and with the
+// glReadPixels fallback of the GL contexts without them, and checks the pixels
+class RenderTextureReadbackTest : public RenderTextureTest
+{
+public:
+    CREATE_FUNC(RenderTextureReadbackTest);
+    RenderTextureReadbackTest();
+    virtual ~RenderTextureReadbackTest();
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+private:
+    void saveImage();
+    bool checkImage(Image* image) const;
+
+    RenderTexture* _target;
+    Label* _resultLabel;
+    std::string _results;
+};
+
 class SpriteRenderTextureBug : public RenderTextureTest
 {
 public:
@@ -11,6 +11,7 @@
 #include "controller.h"
 #include "testResource.h"
 #include "tests.h"
+#include "PerformanceTest/PerformanceTextureTest.h"
 
 #if (CC_TARGET_PLATFORM != CC_PLATFORM_WIN32) && (CC_TARGET_PLATFORM != CC_PLATFORM_WP8) && (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT)
 #include <unistd.h>
@@ -447,6 +448,24 @@ void TestController::addConsoleAutoTest()
         
     };
     console->addCommand(autotest);
+
+    static struct Console::Command decodebench = {
+        "decodebench",
+        "times the software texture decoders, no GL needed. Args: [size] [repeat]",
+        [](int fd, const std::string& args)
+        {
+            int size = 2048;
+            int repeat = 5;
+            sscanf(args.c_str(), "%d %d", &size, &repeat);
+            size = std::max(4, size & ~3);
+            repeat = std::max(1, repeat);
+
+            // runs on the console thread, the decoders don't touch the Director or GL
+            std::string result = benchmarkTextureDecoders(size, repeat);
+            send(fd, result.c_str(), result.size(), 0);
+        }
+    };
+    console->addCommand(decodebench);
 }
 
 void TestController::startAutoRun()
@@ -1754,10 +1754,16 @@ local function runFuncRelateWithTable()
     local getPositionItem = cc.MenuItemFont:create("getPosition")
     local getAnchorPointItem = cc.MenuItemFont:create("getAnchorPoint")
     local pointItem       = cc.MenuItemFont:create("object")
+    local setPositionXYItem = cc.MenuItemFont:create("setPosition(x, y)")
+    local setPositionsItem  = cc.MenuItemFont:create("setPositions (bulk)")
+    local getPositionsItem  = cc.MenuItemFont:create("getPositions (bulk)")
     local funcToggleItem  = cc.MenuItemToggle:create(setPositionItem)
     funcToggleItem:addSubItem(getPositionItem)
     funcToggleItem:addSubItem(getAnchorPointItem)
     funcToggleItem:addSubItem(pointItem)
+    funcToggleItem:addSubItem(setPositionXYItem)
+    funcToggleItem:addSubItem(setPositionsItem)
+    funcToggleItem:addSubItem(getPositionsItem)
     funcToggleItem:setAnchorPoint(cc.p(0.0, 0.5))
     funcToggleItem:setPosition(cc.p(VisibleRect:left()))
     local funcMenu = cc.Menu:create(funcToggleItem)
@@ -1767,6 +1773,22 @@ local function runFuncRelateWithTable()
     local testNode = cc.Node:create()
     layer:addChild(testNode)
 
+    --the bulk functions take arrays of quantityOfNodes nodes and of their flat {x1, y1, x2, y2, ...} positions
+    local bulkNodes = {}
+    local bulkPositions = {}
+    local function prepareBulkArrays()
+        if #bulkNodes == quantityOfNodes then
+            return
+        end
+        bulkNodes = {}
+        bulkPositions = {}
+        for i=1,quantityOfNodes do
+            bulkNodes[i] = testNode
+            bulkPositions[2 * i - 1] = 1
+            bulkPositions[2 * i] = 2
+        end
+    end
+
     local function step(dt)
         print(string.format("push num: %d, avg1:%f, avg2:%f,min:%f, max:%f, total: %f, calls: %d",quantityOfNodes, averageTime1, averageTime2, minTime, maxTime, totalTime, numberOfCalls))
     end
@@ -1822,6 +1844,31 @@ local function runFuncRelateWithTable()
         profileEnd(startTime)
     end
 
+    local function callSetPositionXY()
+        numberOfCalls = numberOfCalls + 1
+        local startTime = socket.gettime()
+        for i=1,quantityOfNodes do
+            testNode:setPosition(1, 2)
+        end
+        profileEnd(startTime)
+    end
+
+    local function callSetPositions()
+        prepareBulkArrays()
+        numberOfCalls = numberOfCalls + 1
+        local startTime = socket.gettime()
+        cc.Node:setPositions(bulkNodes, bulkPositions)
+        profileEnd(startTime)
+    end
+
+    local function callGetPositions()
+        prepareBulkArrays()
+        numberOfCalls = numberOfCalls + 1
+        local startTime = socket.gettime()
+        cc.Node:getPositions(bulkNodes, bulkPositions)
+        profileEnd(startTime)
+    end
+
     local function update(dt)
 
         local funcSelected = funcToggleItem:getSelectedIndex()
@@ -1833,6 +1880,12 @@ local function runFuncRelateWithTable()
             callGetAnchorPoint()
         elseif 3 == funcSelected then
             callTableObject()
+        elseif 4 == funcSelected then
+            callSetPositionXY()
+        elseif 5 == funcSelected then
+            callSetPositions()
+        elseif 6 == funcSelected then
+            callGetPositions()
         end
     end
 
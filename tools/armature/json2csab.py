@@ -0,0 +1,273 @@
+#!/usr/bin/python
+# json2csab.py
+# Compiles CocoStudio armature files (.ExportJson, .json) into binary armatures (.csab), which
+# DataReaderHelper decodes without parsing any JSON. ArmatureDataManager::addArmatureFileInfo() and
+# addArmatureFileInfoAsync() recognize them by their content.
+# The layout must stay in sync with the one documented in cocos/editor-support/cocostudio/CCDataReaderHelper.cpp.
+
+import argparse
+import json
+import math
+import os.path
+import struct
+import sys
+
+MAGIC = b'CSAB'
+VERSION = 1
+
+#rounds to single precision, so that the version fixes compute what the json reader computes on floats
+def f32(value):
+    return struct.unpack('<f', struct.pack('<f', float(value)))[0]
+
+#same as CCArmatureDefine.h
+VERSION_COMBINED = f32(0.30)
+VERSION_CHANGE_ROTATION_RANGE = f32(1.0)
+VERSION_COLOR_READING = f32(1.1)
+
+DISPLAY_SPRITE, DISPLAY_ARMATURE, DISPLAY_PARTICLE = range(3)
+GL_SRC_ALPHA = 0x0302
+GL_ONE_MINUS_SRC_ALPHA = 0x0303
+
+class Writer(object):
+    def __init__(self):
+        self.data = bytearray()
+
+    def byte(self, value):
+        self.data.append(value & 0xff)
+
+    def varint(self, value):
+        if value < 0:
+            raise ValueError('negative varint %d' % value)
+        while True:
+            b = value & 0x7f
+            value >>= 7
+            if value:
+                self.data.append(b | 0x80)
+            else:
+                self.data.append(b)
+                return
+
+    def svarint(self, value):
+        self.varint((value << 1) ^ (value >> 31) if value < 0 else value << 1)
+
+    def float(self, value):
+        self.data += struct.pack('<f', float(value))
+
+    def string(self, value):
+        encoded = (value or '').encode('utf-8')
+        self.varint(len(encoded))
+        self.data += encoded
+
+    def node(self, node):
+        for key in ('x', 'y', 'skewX', 'skewY', 'scaleX', 'scaleY'):
+            self.float(node[key])
+        self.svarint(node['z'])
+        color = node.get('color')
+        self.byte(1 if color else 0)
+        if color:
+            for value in color:
+                self.byte(value)
+
+def number(json, key, default=0):
+    value = json.get(key)
+    return default if value is None else value
+
+#same values as DataReaderHelper::decodeNode()
+def readNode(json, version, contentScale):
+    node = {
+        'x': f32(number(json, 'x')) * contentScale,
+        'y': f32(number(json, 'y')) * contentScale,
+        'z': int(number(json, 'z')),
+        'skewX': f32(number(json, 'kX')),
+        'skewY': f32(number(json, 'kY')),
+        'scaleX': f32(number(json, 'cX', 1.0)),
+        'scaleY': f32(number(json, 'cY', 1.0)),
+    }
+    #the json reader looks the color up by index before 1.1, which never matches an object
+    color = json.get('color') if version >= VERSION_COLOR_READING else None
+    if isinstance(color, dict):
+        node['color'] = [int(number(color, key, 255)) for key in ('a', 'r', 'g', 'b')]
+    return node
+
+def writeArmature(out, armature, state):
+    version = f32(number(armature, 'version', 0.1))
+    state['version'] = version
+    out.string(armature.get('name'))
+    out.float(version)
+    bones = armature.get('bone_data') or []
+    out.varint(len(bones))
+    for bone in bones:
+        out.string(bone.get('name'))
+        out.string(bone.get('parent'))
+        out.node(readNode(bone, version, state['contentScale']))
+        displays = bone.get('display_data') or []
+        out.varint(len(displays))
+        for display in displays:
+            displayType = int(number(display, 'displayType', DISPLAY_SPRITE))
+            out.byte(displayType)
+            if displayType == DISPLAY_PARTICLE:
+                out.string(display.get('plist'))
+            elif displayType in (DISPLAY_SPRITE, DISPLAY_ARMATURE):
+                out.string(display.get('name'))
+            else:
+                out.string(None)
+            if displayType == DISPLAY_SPRITE:
+                skins = display.get('skin_data') or []
+                if skins and skins[0] is not None:
+                    skin = skins[0]
+                    #the json reader defaults the skin skews to 1
+                    out.node({
+                        'x': f32(number(skin, 'x')) * state['contentScale'],
+                        'y': f32(number(skin, 'y')) * state['contentScale'],
+                        'z': 0,
+                        'skewX': f32(number(skin, 'kX', 1.0)),
+                        'skewY': f32(number(skin, 'kY', 1.0)),
+                        'scaleX': f32(number(skin, 'cX', 1.0)),
+                        'scaleY': f32(number(skin, 'cY', 1.0)),
+                    })
+                else:
+                    out.node({'x': 0, 'y': 0, 'z': 0, 'skewX': 0, 'skewY': 0, 'scaleX': 1, 'scaleY': 1})
+
+#same values as DataReaderHelper::decodeMovementBone() and decodeFrame(), version fixes included
+def readMovementBone(movementBone, state):
+    version = state['version']
+    frames = []
+    duration = 0
+    for frame in movementBone.get('frame_data') or []:
+        data = readNode(frame, version, state['contentScale'])
+        data['tweenEasing'] = int(number(frame, 'twE', 0))
+        data['displayIndex'] = int(number(frame, 'dI', 0))
+        data['blendSrc'] = int(number(frame, 'bd_src', GL_SRC_ALPHA))
+        data['blendDst'] = int(number(frame, 'bd_dst', GL_ONE_MINUS_SRC_ALPHA))
+        data['isTween'] = bool(number(frame, 'tweenFrame', True))
+        data['event'] = frame.get('evt')
+        data['easingParams'] = [f32(v) for v in frame.get('twEP') or []]
+        if version < VERSION_COMBINED:
+            data['duration'] = int(number(frame, 'dr', 1))
+            data['frameID'] = duration
+            duration += data['duration']
+        else:
+            data['duration'] = 1
+            data['frameID'] = int(number(frame, 'fi', 0))
+        frames.append(data)
+
+    if version < VERSION_CHANGE_ROTATION_RANGE:
+        for i in range(len(frames) - 1, 0, -1):
+            for key in ('skewX', 'skewY'):
+                dif = f32(frames[i][key] - frames[i - 1][key])
+                if dif < -math.pi or dif > math.pi:
+                    frames[i - 1][key] = f32(frames[i - 1][key] - 2 * math.pi if dif < 0 else frames[i - 1][key] + 2 * math.pi)
+
+    if version < VERSION_COMBINED and frames:
+        last = dict(frames[-1])
+        last['frameID'] = duration
+        #FrameData::copy() keeps the defaults of the event and of the tween flag
+        last['event'] = None
+        last['isTween'] = True
+        frames.append(last)
+
+    return duration, frames
+
+def writeAnimation(out, animation, state):
+    out.string(animation.get('name'))
+    movements = animation.get('mov_data') or []
+    out.varint(len(movements))
+    for movement in movements:
+        out.string(movement.get('name'))
+        out.byte(1 if number(movement, 'lp', True) else 0)
+        out.svarint(int(number(movement, 'dr', 0)))
+        out.svarint(int(number(movement, 'to', 0)))
+        out.svarint(int(number(movement, 'drTW', 0)))
+        out.svarint(int(number(movement, 'twE', 0)))
+        out.float(number(movement, 'sc', 1.0) if 'dr' in movement else 1.0)
+        movementBones = movement.get('mov_bone_data') or []
+        out.varint(len(movementBones))
+        for movementBone in movementBones:
+            duration, frames = readMovementBone(movementBone, state)
+            out.string(movementBone.get('name'))
+            out.float(number(movementBone, 'dl', 0))
+            out.float(duration)
+            out.varint(len(frames))
+            for frame in frames:
+                out.node(frame)
+                out.svarint(frame['frameID'])
+                out.svarint(frame['duration'])
+                out.svarint(frame['tweenEasing'])
+                out.svarint(frame['displayIndex'])
+                out.varint(frame['blendSrc'])
+                out.varint(frame['blendDst'])
+                out.byte(1 if frame['isTween'] else 0)
+                out.string(frame['event'])
+                out.varint(len(frame['easingParams']))
+                for value in frame['easingParams']:
+                    out.float(value)
+
+def writeTexture(out, texture):
+    out.string(texture.get('name'))
+    for key in ('width', 'height', 'pX', 'pY'):
+        out.float(number(texture, key))
+    contours = texture.get('contour_data') or []
+    out.varint(len(contours))
+    for contour in contours:
+        #the json reader adds the vertices in reverse order
+        vertices = list(reversed(contour.get('vertex') or []))
+        out.varint(len(vertices))
+        for vertex in vertices:
+            out.float(number(vertex, 'x'))
+            out.float(number(vertex, 'y'))
+
+def convert(jsonPath, csabPath):
+    with open(jsonPath, 'rb') as f:
+        root = json.loads(f.read().decode('utf-8-sig'))
+
+    state = {'contentScale': f32(number(root, 'content_scale', 1.0)), 'version': 0.1}
+    out = Writer()
+    out.data += MAGIC
+    out.byte(VERSION)
+
+    armatures = root.get('armature_data') or []
+    out.varint(len(armatures))
+    for armature in armatures:
+        writeArmature(out, armature, state)
+
+    animations = root.get('animation_data') or []
+    out.varint(len(animations))
+    for animation in animations:
+        writeAnimation(out, animation, state)
+
+    textures = root.get('texture_data') or []
+    out.varint(len(textures))
+    for texture in textures:
+        writeTexture(out, texture)
+
+    spriteFiles = [os.path.splitext(path)[0] for path in root.get('config_file_path') or [] if path]
+    out.varint(len(spriteFiles))
+    for path in spriteFiles:
+        out.string(path)
+
+    with open(csabPath, 'wb') as f:
+        f.write(bytes(out.data))
+    return len(armatures), len(animations), len(out.data)
+
+def main():
+    parser = argparse.ArgumentParser(description='Compiles CocoStudio armature files into binary armatures (.csab)')
+    parser.add_argument('armatures', nargs='+', help='.ExportJson or .json files to convert')
+    parser.add_argument('-o', '--output', help='output directory, defaults to the directory of each file')
+    args = parser.parse_args()
+
+    failed = False
+    for jsonPath in args.armatures:
+        csabName = os.path.splitext(os.path.basename(jsonPath))[0] + '.csab'
+        csabPath = os.path.join(args.output or os.path.dirname(jsonPath), csabName)
+        try:
+            armatureCount, animationCount, size = convert(jsonPath, csabPath)
+            print('%s: %d armatures, %d animations, %d bytes (json %d bytes) -> %s' %
+                  (jsonPath, armatureCount, animationCount, size, os.path.getsize(jsonPath), csabPath))
+        except Exception as e:
+            print('error: %s: %s' % (jsonPath, e))
+            failed = True
+
+    return 1 if failed else 0
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,172 @@
+#!/usr/bin/python
+# perf_client.py
+# Records the per frame statistics streamed by the "perf" command of the cocos2d-x console
+# (cocos/base/CCConsole.cpp) into a csv file, and plots recorded files.
+#
+#   perf_client.py record -o soak.csv --rate 10 --duration 3600 192.168.1.20
+#   perf_client.py plot soak.csv
+#
+# The record layout is given by the "#perf" header line sent when the stream starts.
+
+import argparse
+import csv
+import socket
+import sys
+import time
+
+DEFAULT_PORT = 5678
+TIME_COLUMNS = ('dt', 'update', 'visit', 'render', 'swap')
+
+class PerfStream(object):
+    def __init__(self, host, port, rate):
+        self.sock = socket.create_connection((host, port))
+        self.buffer = b''
+        self.columns = None
+        self.sock.sendall(('perf start %g\n' % rate).encode('ascii'))
+
+    def close(self):
+        try:
+            self.sock.sendall(b'perf stop\nexit\n')
+        except socket.error:
+            pass
+        self.sock.close()
+
+    def lines(self):
+        while True:
+            data = self.sock.recv(65536)
+            if not data:
+                return
+            # the console prompt is "> " followed by a NUL byte, and may precede a record on the same line
+            self.buffer += data.replace(b'\0', b'')
+            lines = self.buffer.split(b'\n')
+            self.buffer = lines.pop()
+            for line in lines:
+                line = line.decode('ascii', 'replace').strip()
+                while line.startswith('>'):
+                    line = line[1:].lstrip()
+                if line:
+                    yield line
+
+    #yields one dictionary per record, keyed by the header columns
+    def records(self):
+        for line in self.lines():
+            fields = line.split()
+            if fields[0] == '#perf':
+                self.columns = fields[1:]
+            elif fields[0] == 'perf' and self.columns and len(fields) == len(self.columns) + 1:
+                yield dict(zip(self.columns, [int(v) for v in fields[1:]]))
+
+def record(args):
+    stream = PerfStream(args.host, args.port, args.rate)
+    out = open(args.output, 'w') if args.output else sys.stdout
+    writer = None
+    count = 0
+    start = time.time()
+    try:
+        for rec in stream.records():
+            if writer is None:
+                writer = csv.DictWriter(out, fieldnames=stream.columns)
+                writer.writeheader()
+            writer.writerow(rec)
+            count += 1
+            if args.output and count % 100 == 0:
+                out.flush()
+                sys.stderr.write('\r%d records, frame %d, %.1f ms' % (count, rec['frame'], rec['dt'] / 1000.0))
+            if args.duration and time.time() - start >= args.duration:
+                break
+    except KeyboardInterrupt:
+        pass
+    finally:
+        stream.close()
+        if args.output:
+            out.close()
+            sys.stderr.write('\n%d records written to %s\n' % (count, args.output))
+    return 0
+
+def readCsv(path):
+    with open(path) as f:
+        rows = list(csv.DictReader(f))
+    columns = {}
+    for row in rows:
+        for key, value in row.items():
+            columns.setdefault(key, []).append(int(value))
+    return columns
+
+def plot(args):
+    try:
+        import matplotlib
+        if args.output:
+            matplotlib.use('Agg')
+        import matplotlib.pyplot as plt
+    except ImportError:
+        print('error: plotting requires matplotlib')
+        return 1
+
+    columns = readCsv(args.csv)
+    if not columns:
+        print('error: %s has no records' % args.csv)
+        return 1
+    frames = columns['frame']
+
+    fig, axes = plt.subplots(4, 1, sharex=True, figsize=(12, 10))
+    ms = lambda values: [v / 1000.0 for v in values]
+
+    #the phases are stacked so that their top matches the cpu side of the frame
+    phases = [c for c in TIME_COLUMNS[1:] if c in columns]
+    axes[0].stackplot(frames, *[ms(columns[c]) for c in phases], labels=phases)
+    axes[0].plot(frames, ms(columns['dt']), color='black', linewidth=0.5, label='dt')
+    axes[0].set_ylabel('ms')
+    axes[0].legend(loc='upper left', fontsize='small')
+
+    axes[1].plot(frames, columns['batches'], label='batches')
+    axes[1].set_ylabel('draw calls')
+    vertices = axes[1].twinx()
+    vertices.plot(frames, columns['vertices'], color='gray', linewidth=0.5)
+    vertices.set_ylabel('vertices')
+
+    axes[2].plot(frames, [v / 1024.0 for v in columns['texture_kb']])
+    axes[2].set_ylabel('textures (MB)')
+
+    axes[3].plot(frames, columns['refs'], label='live refs')
+    axes[3].plot(frames, columns['autoreleased'], label='autoreleased')
+    if 'allocs' in columns:
+        axes[3].plot(frames, columns['allocs'], label='frame allocations')
+    if 'culled' in columns:
+        axes[3].plot(frames, columns['culled'], label='culled nodes')
+    axes[3].set_ylabel('objects')
+    axes[3].set_xlabel('frame')
+    axes[3].legend(loc='upper left', fontsize='small')
+
+    fig.suptitle(args.csv)
+    fig.tight_layout()
+    if args.output:
+        fig.savefig(args.output)
+    else:
+        plt.show()
+    return 0
+
+def main():
+    parser = argparse.ArgumentParser(description='Records and plots the "perf" stream of the cocos2d-x console')
+    commands = parser.add_subparsers(dest='command')
+
+    recordParser = commands.add_parser('record', help='record the stream of a running game into a csv file')
+    recordParser.add_argument('host', help='address of the device running the game')
+    recordParser.add_argument('-p', '--port', type=int, default=DEFAULT_PORT, help='console port, defaults to %d' % DEFAULT_PORT)
+    recordParser.add_argument('-r', '--rate', type=float, default=0, help='records per second, defaults to 0 (every frame)')
+    recordParser.add_argument('-d', '--duration', type=float, default=0, help='seconds to record, defaults to until interrupted')
+    recordParser.add_argument('-o', '--output', help='csv file, defaults to stdout')
+
+    plotParser = commands.add_parser('plot', help='plot a recorded csv file')
+    plotParser.add_argument('csv', help='csv file written by the record command')
+    plotParser.add_argument('-o', '--output', help='image file, shows a window when omitted')
+
+    args = parser.parse_args()
+    if args.command == 'record':
+        return record(args)
+    if args.command == 'plot':
+        return plot(args)
+    parser.print_help()
+    return 1
+
+if __name__ == '__main__':
+    sys.exit(main())
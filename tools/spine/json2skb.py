@@ -0,0 +1,271 @@
+#!/usr/bin/python
+# json2skb.py
+# Compiles Spine skeleton json files into binary skeletons (.skb), which spSkeletonBinary reads without
+# parsing any JSON. spine::Skeleton and spine::SkeletonDataCache pick the reader by the content of the file.
+# The layout must stay in sync with the one documented in cocos/editor-support/spine/SkeletonBinary.cpp.
+
+import argparse
+import json
+import os.path
+import struct
+import sys
+from collections import OrderedDict
+
+MAGIC = b'CSKB'
+VERSION = 1
+
+ATTACHMENT_TYPES = {'region': 0, 'regionsequence': 1, 'boundingbox': 2}
+TIMELINE_ROTATE, TIMELINE_TRANSLATE, TIMELINE_SCALE, TIMELINE_COLOR, TIMELINE_ATTACHMENT, TIMELINE_EVENT, TIMELINE_DRAW_ORDER = range(7)
+
+class Writer(object):
+    def __init__(self):
+        self.data = bytearray()
+
+    def byte(self, value):
+        self.data.append(value & 0xff)
+
+    def varint(self, value):
+        if value < 0:
+            raise ValueError('negative varint %d' % value)
+        while True:
+            b = value & 0x7f
+            value >>= 7
+            if value:
+                self.data.append(b | 0x80)
+            else:
+                self.data.append(b)
+                return
+
+    def svarint(self, value):
+        self.varint((value << 1) ^ (value >> 31) if value < 0 else value << 1)
+
+    def float(self, value):
+        self.data += struct.pack('<f', float(value))
+
+    def string(self, value):
+        if value is None:
+            self.varint(0)
+            return
+        encoded = value.encode('utf-8')
+        self.varint(len(encoded) + 1)
+        self.data += encoded + b'\0'
+
+    def color(self, value):
+        if len(value) != 8:
+            raise ValueError('invalid color "%s"' % value)
+        self.data += bytearray(int(value[i:i + 2], 16) for i in range(0, 8, 2))
+
+    def curve(self, frame):
+        curve = frame.get('curve')
+        if curve == 'stepped':
+            self.byte(1)
+        elif isinstance(curve, list) and len(curve) == 4:
+            self.byte(2)
+            for value in curve:
+                self.float(value)
+        else:
+            self.byte(0)
+
+def indexOf(names, name, kind):
+    if name not in names:
+        raise ValueError('%s not found: %s' % (kind, name))
+    return names[name]
+
+#same computation as the draworder reader of SkeletonJson.cpp
+def drawOrder(offsets, slots, slotCount):
+    order = [-1] * slotCount
+    unchanged = []
+    originalIndex = 0
+    for offset in offsets:
+        slotIndex = indexOf(slots, offset.get('slot'), 'slot')
+        while originalIndex != slotIndex:
+            unchanged.append(originalIndex)
+            originalIndex += 1
+        order[originalIndex + int(offset.get('offset', 0))] = originalIndex
+        originalIndex += 1
+    while originalIndex < slotCount:
+        unchanged.append(originalIndex)
+        originalIndex += 1
+    for i in range(slotCount - 1, -1, -1):
+        if order[i] == -1:
+            order[i] = unchanged.pop()
+    return order
+
+def writeAnimation(out, name, animation, bones, slots, events, eventData, slotCount):
+    timelines = []
+    for boneName, boneMap in animation.get('bones', {}).items():
+        boneIndex = indexOf(bones, boneName, 'bone')
+        for timelineName, frames in boneMap.items():
+            if timelineName not in ('rotate', 'translate', 'scale'):
+                raise ValueError('invalid timeline type for a bone: %s' % timelineName)
+            if frames:
+                timelines.append((timelineName, boneIndex, frames))
+    for slotName, slotMap in animation.get('slots', {}).items():
+        slotIndex = indexOf(slots, slotName, 'slot')
+        for timelineName, frames in slotMap.items():
+            if timelineName not in ('color', 'attachment'):
+                raise ValueError('invalid timeline type for a slot: %s' % timelineName)
+            if frames:
+                timelines.append((timelineName, slotIndex, frames))
+    if animation.get('events'):
+        timelines.append(('events', 0, animation['events']))
+    if animation.get('draworder'):
+        timelines.append(('draworder', 0, animation['draworder']))
+
+    out.string(name)
+    out.varint(len(timelines))
+    for timelineName, index, frames in timelines:
+        if timelineName == 'rotate':
+            out.byte(TIMELINE_ROTATE)
+            out.varint(index)
+            out.varint(len(frames))
+            for frame in frames:
+                out.float(frame.get('time', 0))
+                out.float(frame.get('angle', 0))
+                out.curve(frame)
+        elif timelineName in ('translate', 'scale'):
+            out.byte(TIMELINE_TRANSLATE if timelineName == 'translate' else TIMELINE_SCALE)
+            out.varint(index)
+            out.varint(len(frames))
+            for frame in frames:
+                out.float(frame.get('time', 0))
+                out.float(frame.get('x', 0))
+                out.float(frame.get('y', 0))
+                out.curve(frame)
+        elif timelineName == 'color':
+            out.byte(TIMELINE_COLOR)
+            out.varint(index)
+            out.varint(len(frames))
+            for frame in frames:
+                out.float(frame.get('time', 0))
+                out.color(frame.get('color', ''))
+                out.curve(frame)
+        elif timelineName == 'attachment':
+            out.byte(TIMELINE_ATTACHMENT)
+            out.varint(index)
+            out.varint(len(frames))
+            for frame in frames:
+                out.float(frame.get('time', 0))
+                out.string(frame.get('name'))
+        elif timelineName == 'events':
+            out.byte(TIMELINE_EVENT)
+            out.varint(len(frames))
+            for frame in frames:
+                eventIndex = indexOf(events, frame.get('name'), 'event')
+                default = eventData[eventIndex]
+                out.float(frame.get('time', 0))
+                out.varint(eventIndex)
+                out.svarint(int(frame.get('int', default.get('int', 0))))
+                out.float(frame.get('float', default.get('float', 0)))
+                out.string(frame.get('string', default.get('string')))
+        else:
+            out.byte(TIMELINE_DRAW_ORDER)
+            out.varint(len(frames))
+            for frame in frames:
+                out.float(frame.get('time', 0))
+                if 'offsets' in frame:
+                    out.byte(1)
+                    for slotIndex in drawOrder(frame['offsets'], slots, slotCount):
+                        out.varint(slotIndex)
+                else:
+                    out.byte(0)
+
+def convert(jsonPath, skbPath):
+    with open(jsonPath) as f:
+        root = json.load(f, object_pairs_hook=OrderedDict)
+
+    out = Writer()
+    out.data += MAGIC
+    out.byte(VERSION)
+
+    bones = {}
+    out.varint(len(root['bones']))
+    for i, bone in enumerate(root['bones']):
+        parent = bone.get('parent')
+        out.string(bone.get('name'))
+        out.varint(indexOf(bones, parent, 'parent bone') + 1 if parent else 0)
+        for key, default in (('length', 0), ('x', 0), ('y', 0), ('rotation', 0), ('scaleX', 1), ('scaleY', 1)):
+            out.float(bone.get(key, default))
+        out.byte((1 if bone.get('inheritScale', True) else 0) | (2 if bone.get('inheritRotation', True) else 0))
+        bones[bone.get('name')] = i
+
+    slots = {}
+    slotList = root.get('slots', [])
+    out.varint(len(slotList))
+    for i, slot in enumerate(slotList):
+        out.string(slot.get('name'))
+        out.varint(indexOf(bones, slot.get('bone'), 'slot bone'))
+        color = slot.get('color')
+        out.byte((1 if color else 0) | (2 if slot.get('additive', False) else 0))
+        if color:
+            out.color(color)
+        out.string(slot.get('attachment'))
+        slots[slot.get('name')] = i
+
+    skins = root.get('skins', {})
+    out.varint(len(skins))
+    for skinName, skin in skins.items():
+        out.string(skinName)
+        out.varint(len(skin))
+        for slotName, attachments in skin.items():
+            out.varint(indexOf(slots, slotName, 'slot'))
+            out.varint(len(attachments))
+            for attachmentName, attachment in attachments.items():
+                typeName = attachment.get('type', 'region')
+                if typeName not in ATTACHMENT_TYPES:
+                    raise ValueError('unknown attachment type: %s' % typeName)
+                name = attachment.get('name')
+                out.string(attachmentName)
+                out.string(None if name == attachmentName else name)
+                out.byte(ATTACHMENT_TYPES[typeName])
+                if typeName == 'boundingbox':
+                    vertices = attachment.get('vertices', [])
+                    out.varint(len(vertices))
+                    for value in vertices:
+                        out.float(value)
+                else:
+                    for key, default in (('x', 0), ('y', 0), ('scaleX', 1), ('scaleY', 1), ('rotation', 0), ('width', 32), ('height', 32)):
+                        out.float(attachment.get(key, default))
+
+    events = {}
+    eventData = []
+    eventMap = root.get('events', {})
+    out.varint(len(eventMap))
+    for i, (eventName, event) in enumerate(eventMap.items()):
+        out.string(eventName)
+        out.svarint(int(event.get('int', 0)))
+        out.float(event.get('float', 0))
+        out.string(event.get('string'))
+        events[eventName] = i
+        eventData.append(event)
+
+    animations = root.get('animations', {})
+    out.varint(len(animations))
+    for animationName, animation in animations.items():
+        writeAnimation(out, animationName, animation, bones, slots, events, eventData, len(slotList))
+
+    with open(skbPath, 'wb') as f:
+        f.write(bytes(out.data))
+    return len(out.data)
+
+def main():
+    parser = argparse.ArgumentParser(description='Compiles Spine skeleton json files into binary skeletons (.skb)')
+    parser.add_argument('skeletons', nargs='+', help='json files to convert')
+    parser.add_argument('-o', '--output', help='output directory, defaults to the directory of each json file')
+    args = parser.parse_args()
+
+    failed = False
+    for jsonPath in args.skeletons:
+        skbName = os.path.splitext(os.path.basename(jsonPath))[0] + '.skb'
+        skbPath = os.path.join(args.output or os.path.dirname(jsonPath), skbName)
+        try:
+            size = convert(jsonPath, skbPath)
+            print('%s: %d bytes (json %d bytes) -> %s' % (jsonPath, size, os.path.getsize(jsonPath), skbPath))
+        except Exception as e:
+            print('error: %s: %s' % (jsonPath, e))
+            failed = True
+
+    return 1 if failed else 0
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,155 @@
+#!/usr/bin/python
+# plist2sfb.py
+# Compiles sprite sheet plist files (Zwoptex formats 0 to 3) into binary sprite sheets (.sfb),
+# which SpriteFrameCache::addSpriteFramesWithFile() maps and reads without parsing any XML.
+# The layout must stay in sync with the one documented in cocos/2d/CCSpriteFrameCache.cpp.
+
+import argparse
+import os.path
+import plistlib
+import re
+import struct
+import sys
+
+MAGIC = b'CSFB'
+VERSION = 1
+HEADER_FORMAT = '<4s10I'
+FRAME_FORMAT = '<3I8fI'
+ALIAS_FORMAT = '<4I'
+
+numberPattern = re.compile(r'-?[0-9.]+(?:[eE][-+]?[0-9]+)?')
+
+def readPlist(path):
+    if hasattr(plistlib, 'load'):
+        with open(path, 'rb') as f:
+            return plistlib.load(f)
+    return plistlib.readPlist(path)
+
+#parses the "{x,y}" and "{{x,y},{w,h}}" strings like PointFromString() and RectFromString()
+def numbers(value, count):
+    values = [float(v) for v in numberPattern.findall(value or '')]
+    values += [0.0] * (count - len(values))
+    return values[:count]
+
+def asBool(value):
+    if isinstance(value, str):
+        return value.lower() in ('true', 'yes', '1')
+    return bool(value)
+
+#same hash as hashFrameName() in CCSpriteFrameCache.cpp: 32 bits FNV-1a
+def hashName(name):
+    h = 2166136261
+    for c in bytearray(name):
+        h ^= c
+        h = (h * 16777619) & 0xffffffff
+    return h
+
+def encode(name):
+    if isinstance(name, bytes):
+        return name
+    return name.encode('utf-8')
+
+#returns (rect, rotated, offset, sourceSize, aliases) like readFrameDictionary()
+def readFrame(frame, format):
+    if format == 0:
+        ow = abs(int(frame.get('originalWidth', 0)))
+        oh = abs(int(frame.get('originalHeight', 0)))
+        if not ow or not oh:
+            print('warning: originalWidth/Height not found, the anchor point won\'t work as expected')
+        rect = [float(frame.get(k, 0)) for k in ('x', 'y', 'width', 'height')]
+        offset = [float(frame.get('offsetX', 0)), float(frame.get('offsetY', 0))]
+        return rect, False, offset, [float(ow), float(oh)], []
+    if format in (1, 2):
+        rotated = format == 2 and asBool(frame.get('rotated', False))
+        return numbers(frame.get('frame'), 4), rotated, numbers(frame.get('offset'), 2), numbers(frame.get('sourceSize'), 2), []
+    textureRect = numbers(frame.get('textureRect'), 4)
+    spriteSize = numbers(frame.get('spriteSize'), 2)
+    rect = [textureRect[0], textureRect[1], spriteSize[0], spriteSize[1]]
+    return (rect, asBool(frame.get('textureRotated', False)), numbers(frame.get('spriteOffset'), 2),
+            numbers(frame.get('spriteSourceSize'), 2), frame.get('aliases', []))
+
+def convert(plistPath, sfbPath):
+    plist = readPlist(plistPath)
+    frames = plist.get('frames')
+    if frames is None:
+        raise ValueError('%s has no frames' % plistPath)
+
+    metadata = plist.get('metadata', {})
+    format = int(metadata.get('format', 0))
+    if format < 0 or format > 3:
+        raise ValueError('format %d of %s is not supported' % (format, plistPath))
+    textureName = encode(metadata.get('textureFileName', ''))
+
+    names = bytearray()
+    frameRecords = []
+    aliasRecords = []
+    entries = []
+    frameNames = sorted(encode(name) for name in frames.keys())
+    for index, name in enumerate(frameNames):
+        rect, rotated, offset, sourceSize, aliases = readFrame(frames[name.decode('utf-8')], format)
+        frameRecords.append(struct.pack(FRAME_FORMAT, len(names), len(name), hashName(name),
+                                        rect[0], rect[1], rect[2], rect[3], offset[0], offset[1],
+                                        sourceSize[0], sourceSize[1], 1 if rotated else 0))
+        entries.append(hashName(name))
+        names += name + b'\0'
+
+        for alias in aliases:
+            alias = encode(alias)
+            aliasRecords.append((len(names), len(alias), hashName(alias), index))
+            names += alias + b'\0'
+
+    for alias in aliasRecords:
+        entries.append(alias[2])
+
+    textureNameOffset = len(names)
+    names += textureName + b'\0'
+
+    #at most half full, so that the probe sequences stay short
+    indexSize = 16
+    while indexSize < 2 * len(entries):
+        indexSize *= 2
+    index = [0] * indexSize
+    for entry, h in enumerate(entries):
+        slot = h & (indexSize - 1)
+        while index[slot] != 0:
+            slot = (slot + 1) & (indexSize - 1)
+        index[slot] = entry + 1
+
+    framesOffset = struct.calcsize(HEADER_FORMAT)
+    aliasesOffset = framesOffset + len(frameRecords) * struct.calcsize(FRAME_FORMAT)
+    indexOffset = aliasesOffset + len(aliasRecords) * struct.calcsize(ALIAS_FORMAT)
+    namesOffset = indexOffset + indexSize * 4
+
+    with open(sfbPath, 'wb') as f:
+        f.write(struct.pack(HEADER_FORMAT, MAGIC, VERSION, len(frameRecords), len(aliasRecords), indexSize,
+                            textureNameOffset, len(textureName), framesOffset, aliasesOffset, indexOffset, namesOffset))
+        for record in frameRecords:
+            f.write(record)
+        for alias in aliasRecords:
+            f.write(struct.pack(ALIAS_FORMAT, *alias))
+        f.write(struct.pack('<%dI' % indexSize, *index))
+        f.write(bytes(names))
+
+    return len(frameRecords), len(aliasRecords)
+
+def main():
+    parser = argparse.ArgumentParser(description='Compiles sprite sheet plist files into binary sprite sheets (.sfb)')
+    parser.add_argument('plists', nargs='+', help='plist files to convert')
+    parser.add_argument('-o', '--output', help='output directory, defaults to the directory of each plist')
+    args = parser.parse_args()
+
+    failed = False
+    for plistPath in args.plists:
+        sfbName = os.path.splitext(os.path.basename(plistPath))[0] + '.sfb'
+        sfbPath = os.path.join(args.output or os.path.dirname(plistPath), sfbName)
+        try:
+            frameCount, aliasCount = convert(plistPath, sfbPath)
+            print('%s: %d frames, %d aliases -> %s' % (plistPath, frameCount, aliasCount, sfbPath))
+        except Exception as e:
+            print('error: %s: %s' % (plistPath, e))
+            failed = True
+
+    return 1 if failed else 0
+
+if __name__ == '__main__':
+    sys.exit(main())